@@ -18,17 +18,10 @@
 //Includes
 #include "handlers.hpp"
 
-#include "QAD_GPIO.hpp"
-
-
-	//------------------------------------------
-	//------------------------------------------
-	//------------------------------------------
-
-extern QAD_GPIO_Output* GPIO_UserLED_Red;
-extern QAD_GPIO_Output* GPIO_UserLED_Orange;
-extern QAD_GPIO_Output* GPIO_UserLED_Green;
-extern QAD_GPIO_Output* GPIO_UserLED_Blue;
+#include "QAD_DMAMgr.hpp"
+#include "QAD_TimerMgr.hpp"
+#include "QAS_Clock.hpp"
+#include "QAS_LED.hpp"
 
 
 	//------------------------------------------
@@ -49,10 +42,7 @@ void NMI_Handler(void) {
 //HardFault_Handler
 //Exception Handler Function
 void HardFault_Handler(void) {
-  GPIO_UserLED_Red->on();
-  GPIO_UserLED_Orange->on();
-  GPIO_UserLED_Green->off();
-  GPIO_UserLED_Blue->off();
+  QAS_LED::fault();
   while(1) {}
 }
 
@@ -60,10 +50,7 @@ void HardFault_Handler(void) {
 //MemManage_Handler
 //Exception Handler Function
 void MemManage_Handler(void) {
-  GPIO_UserLED_Red->on();
-  GPIO_UserLED_Orange->on();
-  GPIO_UserLED_Green->off();
-  GPIO_UserLED_Blue->off();
+  QAS_LED::fault();
   while(1) {}
 }
 
@@ -71,10 +58,7 @@ void MemManage_Handler(void) {
 //BusFault_Handler
 //Exception Handler Function
 void BusFault_Handler(void) {
-  GPIO_UserLED_Red->on();
-  GPIO_UserLED_Orange->on();
-  GPIO_UserLED_Green->off();
-  GPIO_UserLED_Blue->off();
+  QAS_LED::fault();
   while(1) {}
 }
 
@@ -82,10 +66,7 @@ void BusFault_Handler(void) {
 //UsageFault_Handler
 //Exception Handler Function
 void UsageFault_Handler(void) {
-  GPIO_UserLED_Red->on();
-  GPIO_UserLED_Orange->on();
-  GPIO_UserLED_Green->off();
-  GPIO_UserLED_Blue->off();
+  QAS_LED::fault();
   while(1) {}
 }
 
@@ -127,8 +108,134 @@ void SysTick_Handler(void) {
   //---------------------------
   //Interrupt Handler Functions
 
+//DMA1_Stream0_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream0_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream0);
+}
+
+
+//DMA1_Stream1_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream1_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream1);
+}
+
+
+//DMA1_Stream2_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream2_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream2);
+}
+
+
+//DMA1_Stream3_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream3_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream3);
+}
+
+
+//DMA1_Stream4_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream4_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream4);
+}
+
+
+//DMA1_Stream5_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream5_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream5);
+}
+
+
+//DMA1_Stream6_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream6_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream6);
+}
+
+
+//DMA1_Stream7_IRQHandler
+//Interrupt Handler Function
+void DMA1_Stream7_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA1_Stream7);
+}
+
+
+//DMA2_Stream0_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream0_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream0);
+}
+
+
+//DMA2_Stream1_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream1_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream1);
+}
+
+
+//DMA2_Stream2_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream2_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream2);
+}
+
+
+//DMA2_Stream3_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream3_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream3);
+}
+
+
+//DMA2_Stream4_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream4_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream4);
+}
+
+
+//DMA2_Stream5_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream5_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream5);
+}
+
+
+//DMA2_Stream6_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream6_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream6);
+}
 
 
+//DMA2_Stream7_IRQHandler
+//Interrupt Handler Function
+void DMA2_Stream7_IRQHandler(void) {
+  QAD_DMAMgr::irqHandler(QAD_DMA2_Stream7);
+}
+
 
+//TIM6_DAC_IRQHandler
+//Interrupt Handler Function
+void TIM6_DAC_IRQHandler(void) {
+  QAD_TimerMgr::irqHandler(QAD_Timer6);
+}
 
 
+//TIM7_IRQHandler
+//Interrupt Handler Function
+void TIM7_IRQHandler(void) {
+  QAD_TimerMgr::irqHandler(QAD_Timer7);
+}
+
+
+//TIM5_IRQHandler
+//Interrupt Handler Function
+void TIM5_IRQHandler(void) {
+  QAS_Clock::irqHandler();
+}
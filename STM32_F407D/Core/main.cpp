@@ -19,27 +19,39 @@
 #include "main.hpp"
 #include "boot.hpp"
 
-#include "QAD_GPIO.hpp"
+#include "QAS_Clock.hpp"
+#include "QAS_LED.hpp"
+
+#if QA_BENCH_ENABLE
+#include "QAS_Bench.hpp"
+#endif
 
 	//------------------------------------------
 	//------------------------------------------
 	//------------------------------------------
 
-//User LED driver classes (driver defined in QAD_GPIO.hpp)
-QAD_GPIO_Output* GPIO_UserLED_Green;
-QAD_GPIO_Output* GPIO_UserLED_Orange;
-QAD_GPIO_Output* GPIO_UserLED_Red;
-QAD_GPIO_Output* GPIO_UserLED_Blue;
-
-
-
 //Task Timing
 //
-//These constants are used to determine the update rate (in milliseconds) of each of the
+//These constants are used to determine the update rate (in microseconds) of each of the
 //tasks that are run in the processing loop within the main() function.
 //
-const uint32_t QA_FT_HeartbeatTickThreshold = 500;   //Time in milliseconds in between heartbeat LED updates
-                                                     //The rate of flashing of the heartbeat LED will be double the value defined here
+const uint32_t QA_FT_HeartbeatTickThreshold = 1000000;  //Time in microseconds in between heartbeat LED pulses
+
+
+//Heartbeat Pulse
+//
+//Animation started on the green LED by the heartbeat task. The LED fades up quickly and then back down, finishing well before the
+//next pulse is due, so the LED stays dark if the processing loop stops running
+const QAS_LED_Keyframe QA_HeartbeatPulse[2] = {{255, 100, 0}, {0, 400, 0}};
+
+
+#if QA_BENCH_ENABLE
+//Benchmark Results
+//
+//Filled by the QAS_Bench benchmarks run at startup when QA_BENCH_ENABLE is set in setup.hpp, to be read with the debugger
+QAS_Bench_PinResults QA_BenchPinResults;
+QAS_Bench_PWMResults QA_BenchPWMResults;
+#endif
 
 	//------------------------------------------
 	//------------------------------------------
@@ -66,18 +78,42 @@ int main(void) {
 
 
 	//----------------------------------
-  //Initialize the User LEDs using the QAD_GPIO_Output driver class
-  //QAD_USERLED_**** definitions are defined in setup.hpp
-  GPIO_UserLED_Green  = new QAD_GPIO_Output(QAD_USERLED_GREEN_GPIO_PORT, QAD_USERLED_GREEN_GPIO_PIN);
-	GPIO_UserLED_Orange = new QAD_GPIO_Output(QAD_USERLED_ORANGE_GPIO_PORT, QAD_USERLED_ORANGE_GPIO_PIN);
-	GPIO_UserLED_Red    = new QAD_GPIO_Output(QAD_USERLED_RED_GPIO_PORT, QAD_USERLED_RED_GPIO_PIN);
-	GPIO_UserLED_Blue   = new QAD_GPIO_Output(QAD_USERLED_BLUE_GPIO_PORT, QAD_USERLED_BLUE_GPIO_PIN);
+	//Initialize the QAS_Clock system, which provides the 64bit microsecond time used for task timing
+	//Timer 5 is used as its 32bit counter, with TIM5_IRQHandler in handlers.cpp passing its interrupt to the clock
+	QAS_Clock_InitStruct sClockInit;
+	sClockInit.eTimer       = QAD_Timer5;
+	sClockInit.uIRQPriority = 0;
+	if (QAS_Clock::init(sClockInit)) {
+		while (1) {}
+	}
+
+
+	//----------------------------------
+	//Initialize the QAS_LED system, which drives the User LEDs from Timer 4 using PWM
+	//Animations are advanced by the system's DMA interrupt, so they take no time from the processing loop below
+	QAS_LED_InitStruct sLEDInit;
+	sLEDInit.eDMAStream   = QAD_DMA_StreamNone;
+	sLEDInit.uIRQPriority = 14;
+	if (QAS_LED::init(sLEDInit)) {
+		while (1) {}
+	}
 
+#if QA_BENCH_ENABLE
+	//----------------------------------
+	//Run the QAS_Bench on-target benchmarks, which are only built when QA_BENCH_ENABLE is set in setup.hpp
+	//The results are left in QA_BenchPinResults and QA_BenchPWMResults, and are only meaningful in an optimized (Release) build
+	if (QAS_Bench::runPin(QA_BenchPinResults)) {
+		while (1) {}
+	}
+	if (QAS_Bench::runPWM(QA_BenchPWMResults)) {
+		while (1) {}
+	}
+#endif
 
 	//Test Orange, Red and Blue LEDs
-	GPIO_UserLED_Orange->on();
-	GPIO_UserLED_Red->on();
-	GPIO_UserLED_Blue->on();
+	QAS_LED::set(QAS_LED_Orange, true);
+	QAS_LED::set(QAS_LED_Red, true);
+	QAS_LED::set(QAS_LED_Blue, true);
 
 
 	//----------------------------------
@@ -86,9 +122,8 @@ int main(void) {
 
 	//Create processing loop timing variables
 	uint32_t uTicks;
-	uint32_t uCurTick;
-	uint32_t uNewTick = HAL_GetTick();
-	uint32_t uOldTick = uNewTick;
+	uint64_t uNewTime = QAS_Clock::nowUS();
+	uint64_t uOldTime;
 
 	//Create task timing variables
 	uint32_t uHeartbeatTicks = 0;
@@ -100,31 +135,23 @@ int main(void) {
 
 		//----------------------------------
 		//Frame Timing
-		//Calculates how many ticks (in milliseconds) have passed since the previous loop, this value is placed into the uTicks variable
+		//Calculates how many ticks (in microseconds) have passed since the previous loop, this value is placed into the uTicks variable
 		//uTicks is then used to calculate task timing below
-    uCurTick = HAL_GetTick();
-    if (uCurTick != uNewTick) { //Handle loop faster than 1ms issue
-    	uOldTick = uNewTick;
-    	uNewTick = uCurTick;
-    	if (uNewTick < uOldTick) { //Handle 32bit overflow issue
-    		uTicks = (uNewTick + (0xFFFFFFFF - uOldTick));
-    	} else {
-    		uTicks = (uNewTick - uOldTick);
-    	}
-
-    } else {
-    	uTicks = 0;
-    }
-
-  	//----------------------------------
-    //Update Heartbeat LED
-    //The heartbeat LED uses the User LED to flash at a regular rate to visually show whether the microcontroller has locked up or
-    //become stuck in an exception or interrupt handler
-    uHeartbeatTicks += uTicks;
-    if (uHeartbeatTicks >= QA_FT_HeartbeatTickThreshold) { //If heartbeat ticks has exceeded threshold then update heartbeat LED
-    	GPIO_UserLED_Green->toggle();
-    	uHeartbeatTicks -= QA_FT_HeartbeatTickThreshold;     //Reset hearbeat ticks
-    }
+		//As QAS_Clock is 64bit it will not overflow, so no overflow handling is required
+		uOldTime = uNewTime;
+		uNewTime = QAS_Clock::nowUS();
+		uTicks   = (uint32_t)(uNewTime - uOldTime);
+
+		//----------------------------------
+		//Update Heartbeat LED
+		//The heartbeat task starts a single pulse of the green LED at a regular rate. As the pulse is started by the processing loop and
+		//animated by the LED system's interrupt, the LED stops pulsing if either the processing loop or the interrupt stops running,
+		//showing whether the microcontroller has locked up or become stuck in an exception or interrupt handler
+		uHeartbeatTicks += uTicks;
+		if (uHeartbeatTicks >= QA_FT_HeartbeatTickThreshold) { //If heartbeat ticks has exceeded threshold then start a heartbeat pulse
+			QAS_LED::setAnimation(QAS_LED_Green, QA_HeartbeatPulse, 2, false);
+			uHeartbeatTicks -= QA_FT_HeartbeatTickThreshold;     //Reset heartbeat ticks
+		}
 
 	}
 
@@ -104,5 +104,17 @@ public:
 #define QAD_IRQPRIORITY_EXTI     ((uint8_t) 0x0A) //Priority to be used by external interrupt handlers. Shared by all external interrupts
 
 
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------
+//Build Options
+
+#ifndef QA_BENCH_ENABLE
+#define QA_BENCH_ENABLE          0                //Set to 1 to run the QAS_Bench on-target benchmarks from main() at startup (see QAS_Bench.hpp)
+#endif
+
+
 //Prevent Recursive Inclusion
 #endif /* __SETUP_HPP */
@@ -0,0 +1,411 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: DMA Driver                                                      */
+/*   Filename: QAD_DMA.cpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_DMA.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+  //------------------------------
+  //------------------------------
+  //QAD_DMA Initialization Methods
+
+//QAD_DMA::init
+//QAD_DMA Initialization Method
+//
+//Used to initialize the DMA driver
+//If the stream was set to QAD_DMA_StreamNone in the initialization structure, a suitable stream will be found by QAD_DMAMgr
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_DMA::init(void) {
+
+	//Find a suitable stream if one has not been selected
+	if (m_eStream == QAD_DMA_StreamNone) {
+		m_eStream = QAD_DMAMgr::findStream(m_eRequest);
+		if (m_eStream == QAD_DMA_StreamNone)
+			return QA_Error_PeriphBusy;
+	}
+
+	//Check that the selected stream is able to service the peripheral request
+	if (QAD_DMAMgr::getChannel(m_eRequest, m_eStream) == QAD_DMA_ChannelInvalid)
+		return QA_Error_PeriphNotSupported;
+
+	//Check that the selected options are supported for memory to memory transfers
+	if ((m_eDirection == QAD_DMA_MemToMem) && ((m_eRequest != QAD_DMA_Req_MemToMem) || (m_eMode != QAD_DMA_Normal) || (m_eFIFO == QAD_DMA_FIFODirect)))
+		return QA_Error_PeriphNotSupported;
+
+	//Check if selected stream is currently available
+	if (QAD_DMAMgr::getState(m_eStream))
+		return QA_Error_PeriphBusy;
+
+	//Claim DMA stream and stream IRQ (details of any conflict can be retrieved from QAD_ResourceMgr)
+	if (claimResources())
+		return QA_Error_PeriphBusy;
+
+	//Register DMA stream as now being in use, with stream interrupts routed to this driver
+	QAD_DMAMgr::registerStream(m_eStream, this);
+
+	//Initialize DMA stream
+	QA_Result eRes = periphInit();
+
+	//If initialization failed then deregister DMA stream and release resources
+	if (eRes) {
+		QAD_DMAMgr::deregisterStream(m_eStream);
+		releaseResources();
+	}
+
+	//Return initialization result
+	return eRes;
+}
+
+
+//QAD_DMA::deinit
+//QAD_DMA Initialization Method
+//
+//Used to deinitialize the DMA driver
+void QAD_DMA::deinit(void) {
+
+	//Return if DMA driver is not currently initialized
+	if (!m_eInitState)
+		return;
+
+	//Deinitialize DMA driver
+	periphDeinit(DeinitFull);
+
+	//Deregister DMA stream and release resources
+	QAD_DMAMgr::deregisterStream(m_eStream);
+	releaseResources();
+}
+
+
+//QAD_DMA::getStream
+//QAD_DMA Initialization Method
+//
+//Returns the DMA stream being used by the driver. Member of QAD_DMA_Stream as defined in QAD_DMAMgr.hpp
+//Will return QAD_DMA_StreamNone if automatic stream selection was requested and the driver has not yet been initialized
+QAD_DMA_Stream QAD_DMA::getStream(void) {
+	return m_eStream;
+}
+
+
+  //---------------------------
+  //---------------------------
+  //QAD_DMA IRQ Handler Methods
+
+//QAD_DMA::handler
+//QAD_DMA IRQ Handler Method
+//
+//This method is only to be called by QAD_DMAMgr, which will have already read and cleared the stream's event flags
+//pData - Pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values)
+void QAD_DMA::handler(void* pData) {
+	uint8_t uFlags = *(uint8_t*)pData;
+
+	//Stream is disabled by hardware once a normal mode transfer completes, or when a transfer error occurs
+	if (((m_eMode == QAD_DMA_Normal) && (uFlags & QAD_DMA_Event_TransferComplete)) || (uFlags & QAD_DMA_Event_TransferError))
+		m_eState = QA_Inactive;
+
+	//If a handler callback function has been assigned then call it
+	if (m_pHandlerFunction)
+		m_pHandlerFunction(pData);
+
+	//If a handler callback class has been assigned then call it's handler() method
+	if (m_pHandlerClass)
+		m_pHandlerClass->handler(pData);
+}
+
+
+  //-----------------------
+  //-----------------------
+  //QAD_DMA Control Methods
+
+//QAD_DMA::setHandlerFunction
+//QAD_DMA Control Method
+//
+//Used to set the interrupt handler callback function to be called when a stream interrupt is triggered
+//pHandler - Pointer to callback function based on QAD_IRQHandler_CallbackFunction prototype defined in setup.hpp
+void QAD_DMA::setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler) {
+	m_pHandlerFunction = pHandler;
+}
+
+
+//QAD_DMA::setHandlerClass
+//QAD_DMA Control Method
+//
+//Used to set the interrupt handler callback class to be called when a stream interrupt is triggered
+//pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp
+void QAD_DMA::setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler) {
+	m_pHandlerClass = pHandler;
+}
+
+
+//QAD_DMA::start
+//QAD_DMA Control Method
+//
+//Used to start a transfer using a single memory buffer (normal or circular mode)
+//uMemAddr - Address of memory buffer (destination address for memory to memory transfers)
+//uLength  - Number of data items to be transferred (in units of the peripheral data width)
+//Returns QA_OK if the transfer is started
+//        QA_Fail if the driver is not initialized or is already active
+//        QA_Error_PeriphNotSupported if the driver is in double buffer mode
+QA_Result QAD_DMA::start(uint32_t uMemAddr, uint16_t uLength) {
+	if ((!m_eInitState) || (m_eState))
+		return QA_Fail;
+
+	if (m_eMode == QAD_DMA_DoubleBuffer)
+		return QA_Error_PeriphNotSupported;
+
+	disableStream();
+
+	m_pInstance->CR   &= ~(DMA_SxCR_DBM | DMA_SxCR_CT);
+	m_pInstance->NDTR  = uLength;
+	m_pInstance->PAR   = m_uPeriphAddr;
+	m_pInstance->M0AR  = uMemAddr;
+
+	enableStream();
+	return QA_OK;
+}
+
+
+//QAD_DMA::startDoubleBuffer
+//QAD_DMA Control Method
+//
+//Used to start a transfer using two memory buffers (double buffer mode)
+//The stream starts with buffer 0, and switches buffers each time a transfer completes. getCurrentBuffer() can be used to determine which
+//buffer is in use, and setBufferAddr() can be used to change the address of the buffer not currently in use
+//uMemAddr0 - Address of memory buffer 0
+//uMemAddr1 - Address of memory buffer 1
+//uLength   - Number of data items in each buffer (in units of the peripheral data width)
+//Returns QA_OK if the transfer is started
+//        QA_Fail if the driver is not initialized or is already active
+//        QA_Error_PeriphNotSupported if the driver is not in double buffer mode
+QA_Result QAD_DMA::startDoubleBuffer(uint32_t uMemAddr0, uint32_t uMemAddr1, uint16_t uLength) {
+	if ((!m_eInitState) || (m_eState))
+		return QA_Fail;
+
+	if (m_eMode != QAD_DMA_DoubleBuffer)
+		return QA_Error_PeriphNotSupported;
+
+	disableStream();
+
+	m_pInstance->CR    = (m_pInstance->CR & ~DMA_SxCR_CT) | DMA_SxCR_DBM;
+	m_pInstance->NDTR  = uLength;
+	m_pInstance->PAR   = m_uPeriphAddr;
+	m_pInstance->M0AR  = uMemAddr0;
+	m_pInstance->M1AR  = uMemAddr1;
+
+	enableStream();
+	return QA_OK;
+}
+
+
+//QAD_DMA::stop
+//QAD_DMA Control Method
+//
+//Used to stop the current transfer
+//Any data remaining in the stream's FIFO is flushed before the stream is disabled
+void QAD_DMA::stop(void) {
+	if (!m_eInitState)
+		return;
+
+	disableStream();
+}
+
+
+//QAD_DMA::getState
+//QAD_DMA Control Method
+//
+//Returns whether a transfer is currently active. Member of QA_ActiveState as defined in setup.hpp
+QA_ActiveState QAD_DMA::getState(void) {
+	return m_eState;
+}
+
+
+//QAD_DMA::setBufferAddr
+//QAD_DMA Control Method
+//
+//Used to change the address of one of the memory buffers
+//When a double buffer transfer is active, only the buffer not currently in use (see getCurrentBuffer()) may be changed
+//uBuffer  - The buffer to be changed (0 or 1)
+//uMemAddr - The new address of the buffer
+void QAD_DMA::setBufferAddr(uint8_t uBuffer, uint32_t uMemAddr) {
+	if (uBuffer)
+		m_pInstance->M1AR = uMemAddr;
+	else
+		m_pInstance->M0AR = uMemAddr;
+}
+
+
+  //--------------------------------------
+  //--------------------------------------
+  //QAD_DMA Private Initialization Methods
+
+//QAD_DMA::periphInit
+//QAD_DMA Private Initialization Method
+//
+//Used to configure the DMA stream, as well as setting interrupt priority and enabling the stream interrupt if any events have been selected
+//The DMA controller clocks are enabled in SystemInitialize() (boot.cpp), and as they are shared by all streams they are left enabled here
+//In the case of a failed initialization, a partial deinitialization will be performed
+//Returns QA_OK if successful, or QA_Fail if initialization fails
+QA_Result QAD_DMA::periphInit(void) {
+	const uint32_t uDirections[]    = {DMA_PERIPH_TO_MEMORY, DMA_MEMORY_TO_PERIPH, DMA_MEMORY_TO_MEMORY};
+	const uint32_t uPeriphWidths[]  = {DMA_PDATAALIGN_BYTE, DMA_PDATAALIGN_HALFWORD, DMA_PDATAALIGN_WORD};
+	const uint32_t uMemWidths[]     = {DMA_MDATAALIGN_BYTE, DMA_MDATAALIGN_HALFWORD, DMA_MDATAALIGN_WORD};
+	const uint32_t uPriorities[]    = {DMA_PRIORITY_LOW, DMA_PRIORITY_MEDIUM, DMA_PRIORITY_HIGH, DMA_PRIORITY_VERY_HIGH};
+	const uint32_t uThresholds[]    = {DMA_FIFO_THRESHOLD_FULL, DMA_FIFO_THRESHOLD_1QUARTERFULL, DMA_FIFO_THRESHOLD_HALFFULL,
+	                                   DMA_FIFO_THRESHOLD_3QUARTERSFULL, DMA_FIFO_THRESHOLD_FULL};
+	const uint32_t uPeriphBursts[]  = {DMA_PBURST_SINGLE, DMA_PBURST_INC4, DMA_PBURST_INC8, DMA_PBURST_INC16};
+	const uint32_t uMemBursts[]     = {DMA_MBURST_SINGLE, DMA_MBURST_INC4, DMA_MBURST_INC8, DMA_MBURST_INC16};
+
+	//Initialize DMA Stream
+	m_pInstance = QAD_DMAMgr::getInstance(m_eStream);
+
+	m_sHandle.Instance                 = m_pInstance;                                              //Set instance for required DMA stream
+	m_sHandle.Init.Channel             = QAD_DMAMgr::getChannel(m_eRequest, m_eStream);            //Set channel to service the peripheral request
+	m_sHandle.Init.Direction           = uDirections[m_eDirection];                                //Set transfer direction
+	m_sHandle.Init.PeriphInc           = m_bPeriphInc ? DMA_PINC_ENABLE : DMA_PINC_DISABLE;        //Set peripheral address increment
+	m_sHandle.Init.MemInc              = m_bMemInc ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;           //Set memory address increment
+	m_sHandle.Init.PeriphDataAlignment = uPeriphWidths[m_ePeriphWidth];                            //Set peripheral data width
+	m_sHandle.Init.MemDataAlignment    = uMemWidths[m_eMemWidth];                                  //Set memory data width
+	m_sHandle.Init.Mode                = (m_eMode == QAD_DMA_Normal) ? DMA_NORMAL : DMA_CIRCULAR;  //Set normal or circular mode (double buffer mode is enabled when started)
+	m_sHandle.Init.Priority            = uPriorities[m_ePriority];                                 //Set stream priority
+	m_sHandle.Init.FIFOMode            = m_eFIFO ? DMA_FIFOMODE_ENABLE : DMA_FIFOMODE_DISABLE;     //Set FIFO or direct mode
+	m_sHandle.Init.FIFOThreshold       = uThresholds[m_eFIFO];                                     //Set FIFO threshold
+	m_sHandle.Init.MemBurst            = uMemBursts[m_eMemBurst];                                  //Set memory burst size
+	m_sHandle.Init.PeriphBurst         = uPeriphBursts[m_ePeriphBurst];                            //Set peripheral burst size
+
+	//Initialize DMA stream, performing a partial deinitialization if the initialization fails
+	//HAL_DMA_Init() will fail if the selected FIFO threshold and burst sizes are not compatible
+	if (HAL_DMA_Init(&m_sHandle) != HAL_OK) {
+		periphDeinit(DeinitPartial);
+		return QA_Fail;
+	}
+
+	//Clear any stale event flags
+	QAD_DMAMgr::clearFlags(m_eStream, QAD_DMA_Event_All);
+
+	//Set DMA stream IRQ priority and enable IRQ
+	if (m_uEvents) {
+		HAL_NVIC_SetPriority(QAD_DMAMgr::getIRQ(m_eStream), m_uIRQPriority, 0);
+		HAL_NVIC_EnableIRQ(QAD_DMAMgr::getIRQ(m_eStream));
+	}
+
+	//Set driver states
+	m_eState     = QA_Inactive;    //Set driver as currently inactive
+	m_eInitState = QA_Initialized; //Set driver state as initialized
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_DMA::periphDeinit
+//QAD_DMA Private Initialization Method
+//
+//Used to deinitialize the DMA stream, as well as disabling the stream interrupt
+//eDeinitMode - Set to DeinitPartial to perform a partial deinitialization (only to be used by periphInit() method
+//              in a case where peripheral initialization has failed
+//            - Set to DeinitFull to perform a full deinitialization in a case where the driver is fully initialized
+void QAD_DMA::periphDeinit(QAD_DMA::DeinitMode eDeinitMode) {
+
+	//Check if full deinitialization is required
+	if (eDeinitMode) {
+
+		//Disable DMA stream IRQ
+		if (m_uEvents)
+			HAL_NVIC_DisableIRQ(QAD_DMAMgr::getIRQ(m_eStream));
+
+		//Deinitialize DMA stream
+		HAL_DMA_DeInit(&m_sHandle);
+	}
+
+	//Set States
+	m_eState     = QA_Inactive;       //Set driver as currently inactive
+	m_eInitState = QA_NotInitialized; //Set driver state as not initialized
+}
+
+
+//QAD_DMA::claimResources
+//QAD_DMA Private Initialization Method
+//
+//Used to claim the DMA stream, and the stream IRQ if any events have been selected, from QAD_ResourceMgr
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_DMA::claimResources(void) {
+	if (QAD_ResourceMgr::claim({QAD_Resource_DMAStream, m_eStream, false, "DMA"}))
+		return QA_Error_PeriphBusy;
+
+	if ((m_uEvents) && (QAD_ResourceMgr::claimIRQ(QAD_DMAMgr::getIRQ(m_eStream), false, "DMA"))) {
+		QAD_ResourceMgr::release(QAD_Resource_DMAStream, m_eStream, "DMA");
+		return QA_Error_PeriphBusy;
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_DMA::releaseResources
+//QAD_DMA Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_DMA::releaseResources(void) {
+	if (m_uEvents)
+		QAD_ResourceMgr::release(QAD_Resource_IRQ, QAD_DMAMgr::getIRQ(m_eStream), "DMA");
+	QAD_ResourceMgr::release(QAD_Resource_DMAStream, m_eStream, "DMA");
+}
+
+
+  //-------------------------------
+  //-------------------------------
+  //QAD_DMA Private Control Methods
+
+//QAD_DMA::disableStream
+//QAD_DMA Private Control Method
+//
+//Used to disable the DMA stream and its interrupt sources, waiting for any ongoing transfer to finish as required by RM0090
+void QAD_DMA::disableStream(void) {
+	m_pInstance->CR  &= ~(DMA_SxCR_EN | DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE);
+	m_pInstance->FCR &= ~DMA_SxFCR_FEIE;
+	while (m_pInstance->CR & DMA_SxCR_EN) {}
+
+	m_eState = QA_Inactive;
+}
+
+
+//QAD_DMA::enableStream
+//QAD_DMA Private Control Method
+//
+//Used to clear any pending event flags, enable the selected interrupt sources, and then enable the DMA stream
+void QAD_DMA::enableStream(void) {
+	uint32_t uCR = 0;
+	if (m_uEvents & QAD_DMA_Event_TransferComplete)
+		uCR |= DMA_SxCR_TCIE;
+	if (m_uEvents & QAD_DMA_Event_HalfTransfer)
+		uCR |= DMA_SxCR_HTIE;
+	if (m_uEvents & QAD_DMA_Event_TransferError)
+		uCR |= DMA_SxCR_TEIE;
+	if (m_uEvents & QAD_DMA_Event_DirectModeError)
+		uCR |= DMA_SxCR_DMEIE;
+	if (m_uEvents & QAD_DMA_Event_FIFOError)
+		m_pInstance->FCR |= DMA_SxFCR_FEIE;
+
+	QAD_DMAMgr::clearFlags(m_eStream, QAD_DMA_Event_All);
+
+	m_eState = QA_Active;
+	m_pInstance->CR |= uCR | DMA_SxCR_EN;
+}
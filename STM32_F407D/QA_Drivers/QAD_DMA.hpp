@@ -0,0 +1,293 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: DMA Driver                                                      */
+/*   Filename: QAD_DMA.hpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_DMA_HPP_
+#define __QAD_DMA_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAD_DMAMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------
+//QAD_DMA_Direction
+//
+//Used to select the direction of DMA transfers
+enum QAD_DMA_Direction : uint8_t {
+	QAD_DMA_PeriphToMem = 0,  //Peripheral to memory
+	QAD_DMA_MemToPeriph,      //Memory to peripheral
+	QAD_DMA_MemToMem          //Memory to memory. Requires a DMA2 stream and QAD_DMA_Req_MemToMem request
+};
+
+
+//------------
+//QAD_DMA_Mode
+//
+//Used to select the DMA transfer mode
+enum QAD_DMA_Mode : uint8_t {
+	QAD_DMA_Normal = 0,       //Stream stops once the transfer is complete
+	QAD_DMA_Circular,         //Stream restarts from the beginning of the buffer once the transfer is complete
+	QAD_DMA_DoubleBuffer      //Stream alternates between two buffers, allowing one buffer to be processed while the other is in use
+	                          //Double buffer mode is always circular, and is not supported for memory to memory transfers
+};
+
+
+//-------------
+//QAD_DMA_Width
+//
+//Used to select the data width for peripheral and memory accesses
+enum QAD_DMA_Width : uint8_t {
+	QAD_DMA_Width8 = 0,       //Byte
+	QAD_DMA_Width16,          //Half-word
+	QAD_DMA_Width32           //Word
+};
+
+
+//----------------
+//QAD_DMA_Priority
+//
+//Used to select the priority of a DMA stream relative to other streams on the same DMA controller
+enum QAD_DMA_Priority : uint8_t {
+	QAD_DMA_PriorityLow = 0,
+	QAD_DMA_PriorityMedium,
+	QAD_DMA_PriorityHigh,
+	QAD_DMA_PriorityVeryHigh
+};
+
+
+//------------
+//QAD_DMA_FIFO
+//
+//Used to select whether the stream's FIFO is used, and the FIFO threshold at which transfers to memory/peripheral take place
+enum QAD_DMA_FIFO : uint8_t {
+	QAD_DMA_FIFODirect = 0,   //FIFO disabled (direct mode). Not available for memory to memory transfers
+	QAD_DMA_FIFOQuarter,      //FIFO enabled with 1/4 threshold
+	QAD_DMA_FIFOHalf,         //FIFO enabled with 1/2 threshold
+	QAD_DMA_FIFOThreeQuarter, //FIFO enabled with 3/4 threshold
+	QAD_DMA_FIFOFull          //FIFO enabled with full threshold
+};
+
+
+//-------------
+//QAD_DMA_Burst
+//
+//Used to select burst size for peripheral and memory accesses. Bursts are only available when the FIFO is enabled
+enum QAD_DMA_Burst : uint8_t {
+	QAD_DMA_BurstSingle = 0,
+	QAD_DMA_BurstInc4,
+	QAD_DMA_BurstInc8,
+	QAD_DMA_BurstInc16
+};
+
+
+//------------------
+//QAD_DMA_InitStruct
+//
+//This structure is used to be able to create the QAD_DMA driver class
+typedef struct {
+
+	QAD_DMA_Request   eRequest;        //Peripheral request to be serviced. Member of QAD_DMA_Request as defined in QAD_DMAMgr.hpp
+	QAD_DMA_Stream    eStream;         //DMA stream to be used. Set to QAD_DMA_StreamNone to have a suitable stream found by QAD_DMAMgr
+
+	QAD_DMA_Direction eDirection;      //Transfer direction. Member of QAD_DMA_Direction
+	QAD_DMA_Mode      eMode;           //Transfer mode. Member of QAD_DMA_Mode
+	QAD_DMA_Priority  ePriority;       //Stream priority. Member of QAD_DMA_Priority
+
+	uint32_t          uPeriphAddr;     //Address of peripheral data register (or source address for memory to memory transfers)
+	QAD_DMA_Width     ePeriphWidth;    //Peripheral data width. Member of QAD_DMA_Width
+	bool              bPeriphInc;      //Set to true to increment the peripheral address after each transfer
+
+	QAD_DMA_Width     eMemWidth;       //Memory data width. Member of QAD_DMA_Width
+	bool              bMemInc;         //Set to true to increment the memory address after each transfer
+
+	QAD_DMA_FIFO      eFIFO;           //FIFO mode and threshold. Member of QAD_DMA_FIFO
+	QAD_DMA_Burst     ePeriphBurst;    //Peripheral burst size. Member of QAD_DMA_Burst
+	QAD_DMA_Burst     eMemBurst;       //Memory burst size. Member of QAD_DMA_Burst
+
+	uint8_t           uEvents;         //Events that are to trigger the stream interrupt. Made up of QAD_DMA_Event values as defined in QAD_DMAMgr.hpp
+	                                   //Set to 0 to leave the stream interrupt disabled
+	uint8_t           uIRQPriority;    //IRQ Priority for stream interrupt (a value between 0 and 15)
+
+} QAD_DMA_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------
+//QAD_DMA
+//
+//Driver class used to perform DMA transfers using a single DMA stream
+//Stream interrupts are routed to the driver by QAD_DMAMgr, and are passed on to the driver's callback function/class with
+//pData pointing to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values)
+class QAD_DMA : public QAD_IRQHandler_CallbackClass {
+private:
+
+	//Deinitialization mode to be used by periphDeinit() method
+	enum DeinitMode : uint8_t {
+		DeinitPartial = 0,        //Only to be used for partial deinitialization upon initialization failure in periphInit() method
+		DeinitFull                //Used for full driver deinitialization when driver is in a fully initialized state
+	};
+
+	QAD_DMA_Request     m_eRequest;      //Peripheral request being serviced
+	QAD_DMA_Stream      m_eStream;       //DMA stream being used
+
+	DMA_HandleTypeDef   m_sHandle;       //Handle used by HAL functions to access DMA stream (defined in stm32f4xx_hal_dma.h)
+	DMA_Stream_TypeDef* m_pInstance;     //DMA stream registers, cached for use by control methods
+
+	QAD_DMA_Direction   m_eDirection;    //Transfer direction
+	QAD_DMA_Mode        m_eMode;         //Transfer mode
+	QAD_DMA_Priority    m_ePriority;     //Stream priority
+
+	uint32_t            m_uPeriphAddr;   //Address of peripheral data register (or source address for memory to memory transfers)
+	QAD_DMA_Width       m_ePeriphWidth;  //Peripheral data width
+	bool                m_bPeriphInc;    //Peripheral address increment
+	QAD_DMA_Width       m_eMemWidth;     //Memory data width
+	bool                m_bMemInc;       //Memory address increment
+
+	QAD_DMA_FIFO        m_eFIFO;         //FIFO mode and threshold
+	QAD_DMA_Burst       m_ePeriphBurst;  //Peripheral burst size
+	QAD_DMA_Burst       m_eMemBurst;     //Memory burst size
+
+	uint8_t             m_uEvents;       //Events that are to trigger the stream interrupt
+	uint8_t             m_uIRQPriority;  //IRQ Priority for stream interrupt (a value between 0 and 15)
+
+	QA_InitState        m_eInitState;    //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState      m_eState;        //Stores whether the driver is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAD_IRQHandler_CallbackFunction m_pHandlerFunction;  //A pointer to the callback function to be called when a stream interrupt is triggered
+	                                                     //QAD_IRQHandler_CallbackFunction defined in setup.hpp
+
+	QAD_IRQHandler_CallbackClass*   m_pHandlerClass;     //A pointer to the callback class to be called when a stream interrupt is triggered
+	                                                     //QAD_IRQHandler_CallbackClass defined in setup.hpp
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_DMA() = delete;                     //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_DMA(QAD_DMA_InitStruct& sInit) :    //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eRequest(sInit.eRequest),
+		m_eStream(sInit.eStream),
+		m_sHandle({0}),
+		m_pInstance(NULL),
+		m_eDirection(sInit.eDirection),
+		m_eMode(sInit.eMode),
+		m_ePriority(sInit.ePriority),
+		m_uPeriphAddr(sInit.uPeriphAddr),
+		m_ePeriphWidth(sInit.ePeriphWidth),
+		m_bPeriphInc(sInit.bPeriphInc),
+		m_eMemWidth(sInit.eMemWidth),
+		m_bMemInc(sInit.bMemInc),
+		m_eFIFO(sInit.eFIFO),
+		m_ePeriphBurst(sInit.ePeriphBurst),
+		m_eMemBurst(sInit.eMemBurst),
+		m_uEvents(sInit.uEvents),
+		m_uIRQPriority(sInit.uIRQPriority),
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_pHandlerFunction(NULL),
+		m_pHandlerClass(NULL) {}
+
+	~QAD_DMA() {           //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
+
+		//Stop DMA driver if currently active
+		if (m_eState)
+			stop();
+
+		//Deinitialize DMA driver if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_DMA.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+	QAD_DMA_Stream getStream(void);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+	//---------------
+	//Control Methods
+
+	void setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler);
+	void setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler);
+
+	QA_Result start(uint32_t uMemAddr, uint16_t uLength);
+	QA_Result startDoubleBuffer(uint32_t uMemAddr0, uint32_t uMemAddr1, uint16_t uLength);
+	void stop(void);
+
+	QA_ActiveState getState(void);
+
+	//Used to retrieve the number of data items remaining in the current transfer
+	uint16_t getRemaining(void) {
+		return (uint16_t)m_pInstance->NDTR;
+	}
+
+	//Used to retrieve which buffer is currently being used by the stream when in double buffer mode
+	//Returns 0 if memory buffer 0 is in use, or 1 if memory buffer 1 is in use
+	uint8_t getCurrentBuffer(void) {
+		return (m_pInstance->CR & DMA_SxCR_CT) ? 1 : 0;
+	}
+
+	void setBufferAddr(uint8_t uBuffer, uint32_t uMemAddr);
+
+private:
+
+	//------------------------------
+	//Private Initialization Methods
+
+	QA_Result periphInit(void);
+	void periphDeinit(DeinitMode eDeinitMode);
+
+	QA_Result claimResources(void);
+	void releaseResources(void);
+
+
+	//-----------------------
+	//Private Control Methods
+
+	void disableStream(void);
+	void enableStream(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_DMA_HPP_ */
@@ -39,7 +39,8 @@ QAD_EXTI::QAD_EXTI(GPIO_TypeDef* pGPIO, uint16_t uPin) :
 	m_eEXTIState(QA_Inactive),              //Initialize the EXTI mode in disabled state
 	m_eEdgeType(QAD_EXTI_EdgeType_Rising),  //Initialize the edge type in rising mode
 	m_pHandlerFunction(NULL),               //Initialize handler function pointer as NULL
-	m_pHandlerClass(NULL) {                 //Initialize handler class pointer as NULL
+	m_pHandlerClass(NULL),                  //Initialize handler class pointer as NULL
+	m_pCapture(NULL) {                      //Initialize in callback mode
 
 }
 
@@ -57,7 +58,8 @@ QAD_EXTI::QAD_EXTI(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_PullMode ePull,
 		m_eEXTIState(QA_Inactive),          //Initialize the EXTI mode in disabled state
 		m_eEdgeType(eEdgeType),             //Initialize the edge type as specified by eEdgeType
 		m_pHandlerFunction(NULL),           //Initialize handler function pointer as NULL
-		m_pHandlerClass(NULL) {             //Initialize handler class pointer as NULL
+		m_pHandlerClass(NULL),              //Initialize handler class pointer as NULL
+		m_pCapture(NULL) {                  //Initialize in callback mode
 
 }
 
@@ -84,8 +86,27 @@ QAD_EXTI::~QAD_EXTI() {
 //QAD_EXTI Handler Method
 //
 //This method is to be called by the interrupt handler function from handlers.cpp
+//In capture mode the cycle counter is read as soon as the interrupt is confirmed, and the interrupt is cleared before the event is stored,
+//so that an edge arriving while the event is being stored triggers the interrupt again rather than being lost. When triggering on both
+//edges, the edge is found from the level of the pin when the handler runs, so a pulse shorter than the interrupt latency is recorded as a
+//single event with the same edge as the event before it. A task can use this to detect pulses that were too short to be timed
 void QAD_EXTI::handler(void) {
 
+	//Capture mode
+	if (m_pCapture) {
+		if (__HAL_GPIO_EXTI_GET_IT(m_uPin) == RESET)
+			return;
+
+		uint32_t uCycles = DWT->CYCCNT;
+		QAD_EXTI_EdgeType eEdge = m_eEdgeType;
+		if (eEdge == QAD_EXTI_EdgeType_Both)
+			eEdge = (m_pGPIO->IDR & m_uPin) ? QAD_EXTI_EdgeType_Rising : QAD_EXTI_EdgeType_Falling;
+
+		__HAL_GPIO_EXTI_CLEAR_IT(m_uPin);
+		m_pCapture->push(uCycles, m_uPin, eEdge);
+		return;
+	}
+
 	//Check if required pin interrupt has been triggered
   if (__HAL_GPIO_EXTI_GET_IT(m_uPin) != RESET) {
 
@@ -127,31 +148,46 @@ void QAD_EXTI::setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler) {
 }
 
 
-//QAD_EXTI::enable
+//QAD_EXTI::setCaptureBuffer
 //QAD_EXTI Control Method
 //
-//Used to enable external interrupt for the required GPIO pin
-void QAD_EXTI::enable(void) {
+//Used to place the driver into or out of capture mode. In capture mode the handler callbacks are not called, and each edge is instead
+//recorded into the event buffer with a timestamp from the DWT cycle counter, which is enabled by this method
+//Interrupts are disabled while the mode is changed, so the mode can be changed while the external interrupt is enabled
+//pBuffer - A pointer to the event buffer to be used, or NULL to return to calling the handler callbacks. The buffer can be shared between
+//          several QAD_EXTI drivers (see QAD_EXTI_EventBuffer)
+void QAD_EXTI::setCaptureBuffer(QAD_EXTI_EventBuffer* pBuffer) {
+
+	//Enable DWT cycle counter for timestamps
+	if (pBuffer) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+	m_pCapture = pBuffer;
+	__set_PRIMASK(uPrimask);
+}
 
-  //Setup GPIO
-  GPIO_InitTypeDef GPIO_Init = {0};
-  GPIO_Init.Pin     = m_uPin;
-  GPIO_Init.Pull    = m_ePullMode;
-  GPIO_Init.Speed   = GPIO_SPEED_FREQ_LOW;
-  switch (m_eEdgeType) {
-    case (QAD_EXTI_EdgeType_Rising):
-    	GPIO_Init.Mode = GPIO_MODE_IT_RISING;
-      break;
-    case (QAD_EXTI_EdgeType_Falling):
-    	GPIO_Init.Mode = GPIO_MODE_IT_FALLING;
-      break;
-    case (QAD_EXTI_EdgeType_Both):
-    	GPIO_Init.Mode = GPIO_MODE_IT_RISING_FALLING;
-      break;
-  }
-  HAL_GPIO_Init(m_pGPIO, &GPIO_Init);
 
-  //Setup Interrupt
+//QAD_EXTI::enable
+//QAD_EXTI Control Method
+//
+//Used to enable external interrupt for the required GPIO pin
+//The EXTI line and interrupt line are claimed from QAD_ResourceMgr. EXTI lines 5 to 9 and 10 to 15 each share an interrupt line, so these
+//are claimed as shared interrupt lines, while the EXTI line itself can only be used by one port
+//Returns QA_OK if the external interrupt is enabled (or was already enabled)
+//        QA_Fail if the GPIO pin was not claimed by the constructor
+//        QA_Error_PeriphBusy if the EXTI line or interrupt line is held by another driver (details of the conflict can be retrieved from
+//                            QAD_ResourceMgr)
+QA_Result QAD_EXTI::enable(void) {
+	if (!m_eInitState)
+		return QA_Fail;
+	if (m_eEXTIState)
+		return QA_OK;
+
+  //Find Interrupt
   switch (m_uPin) {
     case (GPIO_PIN_0):
     	m_eIRQ = EXTI0_IRQn;
@@ -175,6 +211,35 @@ void QAD_EXTI::enable(void) {
     		m_eIRQ = EXTI15_10_IRQn;
     	}
   }
+  bool bShared = ((m_eIRQ == EXTI9_5_IRQn) || (m_eIRQ == EXTI15_10_IRQn));
+
+  //Claim EXTI line and interrupt line
+  uint8_t uLine = (uint8_t)POSITION_VAL(m_uPin);
+  if (QAD_ResourceMgr::claim({QAD_Resource_EXTILine, uLine, false, "EXTI"}))
+  	return QA_Error_PeriphBusy;
+
+  if (QAD_ResourceMgr::claimIRQ(m_eIRQ, bShared, "EXTI")) {
+  	QAD_ResourceMgr::release(QAD_Resource_EXTILine, uLine, "EXTI");
+  	return QA_Error_PeriphBusy;
+  }
+
+  //Setup GPIO
+  GPIO_InitTypeDef GPIO_Init = {0};
+  GPIO_Init.Pin     = m_uPin;
+  GPIO_Init.Pull    = m_ePullMode;
+  GPIO_Init.Speed   = GPIO_SPEED_FREQ_LOW;
+  switch (m_eEdgeType) {
+    case (QAD_EXTI_EdgeType_Rising):
+    	GPIO_Init.Mode = GPIO_MODE_IT_RISING;
+      break;
+    case (QAD_EXTI_EdgeType_Falling):
+    	GPIO_Init.Mode = GPIO_MODE_IT_FALLING;
+      break;
+    case (QAD_EXTI_EdgeType_Both):
+    	GPIO_Init.Mode = GPIO_MODE_IT_RISING_FALLING;
+      break;
+  }
+  HAL_GPIO_Init(m_pGPIO, &GPIO_Init);
 
   //Set external interrupt priority. QAD_IRQPRIORITY_EXTI is defined in setup.hpp
   HAL_NVIC_SetPriority(m_eIRQ, QAD_IRQPRIORITY_EXTI, 0);
@@ -182,6 +247,7 @@ void QAD_EXTI::enable(void) {
 
   //Set State
   m_eEXTIState = QA_Active;
+  return QA_OK;
 }
 
 
@@ -189,12 +255,22 @@ void QAD_EXTI::enable(void) {
 //QAD_EXTI Control Method
 //
 //Disable external interrupt mode for the required pin, which places the pin back into standard GPIO input mode
+//The EXTI line and interrupt line are released. A shared interrupt line is only disabled once no other driver holds it
 void QAD_EXTI::disable(void) {
   if (!m_eEXTIState)
   	return;
 
-  //Disable IRQ
-  HAL_NVIC_DisableIRQ(m_eIRQ);
+  //Mask EXTI line, as HAL_GPIO_Init() does not change the EXTI registers for a pin in input mode
+  EXTI->IMR  &= ~((uint32_t)m_uPin);
+  EXTI->RTSR &= ~((uint32_t)m_uPin);
+  EXTI->FTSR &= ~((uint32_t)m_uPin);
+  __HAL_GPIO_EXTI_CLEAR_IT(m_uPin);
+
+  //Release EXTI line and interrupt line, and disable IRQ if no other driver is using it
+  QAD_ResourceMgr::release(QAD_Resource_EXTILine, (uint8_t)POSITION_VAL(m_uPin), "EXTI");
+  QAD_ResourceMgr::release(QAD_Resource_IRQ, m_eIRQ, "EXTI");
+  if (!QAD_ResourceMgr::getHolder(QAD_Resource_IRQ, m_eIRQ))
+  	HAL_NVIC_DisableIRQ(m_eIRQ);
 
   //Set GPIO back to normal input
   GPIO_InitTypeDef GPIO_Init = {0};
@@ -233,3 +309,75 @@ void QAD_EXTI::setPullMode(QAD_GPIO_PullMode eMode) {
 	if (bCurMode)
 		enable();
 }
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAD_EXTI_EventBuffer Data Methods
+
+//QAD_EXTI_EventBuffer::clear
+//QAD_EXTI_EventBuffer Data Method
+//
+//Used to discard all events in the buffer and clear the overflow count. Interrupts are disabled while the buffer is cleared, so this
+//method can be used while drivers are writing to the buffer
+void QAD_EXTI_EventBuffer::clear(void) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_uTail      = m_uHead;
+	m_uOverflows = 0;
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAD_EXTI_EventBuffer::pop
+//QAD_EXTI_EventBuffer Data Method
+//
+//Used to read the oldest event from the buffer. Only one task may read events from a buffer
+//The memory barriers make sure that the event is not read before its head count is seen, and that the entry is not released to the
+//writer until the event has been copied
+//sEvent - Structure to receive the event
+//Returns QA_OK if an event was read, or QA_Fail if the buffer is empty
+QA_Result QAD_EXTI_EventBuffer::pop(QAD_EXTI_Event& sEvent) {
+	uint32_t uTail = m_uTail;
+	if (m_uHead == uTail)
+		return QA_Fail;
+
+	__DMB();
+	sEvent = m_pEvents[uTail & (m_uSize - 1)];
+	__DMB();
+
+	m_uTail = uTail + 1;
+	return QA_OK;
+}
+
+
+//QAD_EXTI_EventBuffer::push
+//QAD_EXTI_EventBuffer Data Method
+//
+//Used by QAD_EXTI::handler() to add an event to the buffer. Must only be called from interrupts at priority QAD_IRQPRIORITY_EXTI
+//uCycles - Value of the DWT cycle counter at the edge
+//uPin    - Pin that the edge occurred on
+//eEdge   - QAD_EXTI_EdgeType_Rising or QAD_EXTI_EdgeType_Falling
+void QAD_EXTI_EventBuffer::push(uint32_t uCycles, uint16_t uPin, QAD_EXTI_EdgeType eEdge) {
+	uint32_t uHead = m_uHead;
+	if ((uHead - m_uTail) >= m_uSize) {
+		m_uOverflows++;
+		return;
+	}
+
+	QAD_EXTI_Event& sEvent = m_pEvents[uHead & (m_uSize - 1)];
+	sEvent.uCycles = uCycles;
+	sEvent.uPin    = uPin;
+	sEvent.eEdge   = eEdge;
+
+	//Publish event
+	__DMB();
+	m_uHead = uHead + 1;
+}
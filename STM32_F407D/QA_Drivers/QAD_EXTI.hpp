@@ -22,6 +22,8 @@
 //Includes
 #include "setup.hpp"
 
+#include <memory>
+
 #include "QAD_GPIO.hpp"
 
 
@@ -41,12 +43,103 @@ enum QAD_EXTI_EdgeType : uint8_t {
 };
 
 
+//--------------
+//QAD_EXTI_Event
+//
+//Holds a single edge recorded by a QAD_EXTI driver in capture mode
+typedef struct {
+
+	uint32_t          uCycles;  //Value of the DWT cycle counter when the interrupt handler was entered. Wraps every 2^32 CPU cycles
+	uint16_t          uPin;     //Pin that the edge occurred on. A member of GPIO_pins_define as defined in stm32f4xx_hal_gpio.h
+	QAD_EXTI_EdgeType eEdge;    //QAD_EXTI_EdgeType_Rising or QAD_EXTI_EdgeType_Falling
+
+} QAD_EXTI_Event;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//--------------------
+//QAD_EXTI_EventBuffer
+//
+//Lock-free circular buffer of QAD_EXTI_Event entries, filled by QAD_EXTI drivers in capture mode and read by a task
+//
+//The buffer has a single writer and a single reader. The writer only changes the head count and the reader only changes the tail count,
+//so neither side needs to disable interrupts. As all external interrupts share the priority QAD_IRQPRIORITY_EXTI (defined in setup.hpp)
+//they cannot preempt each other, so several QAD_EXTI drivers may share one buffer and are treated as a single writer. If the buffer is
+//full then new events are discarded and counted (see getOverflows())
+class QAD_EXTI_EventBuffer {
+private:
+
+	uint16_t                          m_uSize;       //Number of entries in the buffer (a power of 2)
+	std::unique_ptr<QAD_EXTI_Event[]> m_pEvents;     //Pointer to dynamically allocated buffer. Buffer is allocated upon class creation
+
+	volatile uint32_t                 m_uHead;       //Number of events written to the buffer
+	volatile uint32_t                 m_uTail;       //Number of events read from the buffer
+	volatile uint32_t                 m_uOverflows;  //Number of events discarded due to the buffer being full
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_EXTI_EventBuffer() = delete;         //Delete default class constructor, as the buffer size needs to be supplied upon class creation
+
+	QAD_EXTI_EventBuffer(uint16_t uSize) :   //Constructor to be used, which has the buffer size (in events) passed to it. Sizes that are not a
+		m_uSize(roundSize(uSize)),             //power of 2 are rounded up to the next power of 2
+		m_pEvents(std::make_unique<QAD_EXTI_Event[]>(m_uSize)),
+		m_uHead(0),
+		m_uTail(0),
+		m_uOverflows(0) {}
+
+
+	//NOTE: See QAD_EXTI.cpp for details of the following methods
+
+	//------------
+	//Data Methods
+
+	void clear(void);
+	QA_Result pop(QAD_EXTI_Event& sEvent);
+	void push(uint32_t uCycles, uint16_t uPin, QAD_EXTI_EdgeType eEdge);
+
+	//Returns the number of events waiting in the buffer
+	uint16_t pending(void) {
+		return (uint16_t)(m_uHead - m_uTail);
+	}
+
+	//Returns the number of events discarded due to the buffer being full since the buffer was created or last cleared
+	uint32_t getOverflows(void) {
+		return m_uOverflows;
+	}
+
+private:
+
+	//-------------
+	//Tool Methods
+
+	//Returns uSize rounded up to a power of 2, between 2 and 32768
+	static uint16_t roundSize(uint16_t uSize) {
+		uint16_t uRes = 2;
+		while ((uRes < uSize) && (uRes < 0x8000))
+			uRes <<= 1;
+		return uRes;
+	}
+
+};
+
+
 //--------
 //QAD_EXTI
 //
 //Driver to allow use of a GPIO pin to trigger external interrupts.
 //Inherits from QAD_GPIO_Input driver class to allow driver to dynamically switch between being used as a standard GPIO input pin,
 //or to be used to trigger external interrupt.
+//
+//In capture mode (see setCaptureBuffer()) the handler does not call the callbacks. Instead it records the pin, the edge and the DWT cycle
+//counter into a QAD_EXTI_EventBuffer and clears the interrupt, so the time spent in the interrupt is short and fixed, and the events are
+//processed later by a task. This allows edges to be timestamped to the CPU cycle (apart from interrupt latency) at rates of hundreds of kHz.
 class QAD_EXTI : public QAD_GPIO_Input {
 private:
 
@@ -64,6 +157,8 @@ private:
   QAD_IRQHandler_CallbackClass*   m_pHandlerClass;     //Pointer to the interrupt handler class to be called when interrupt is triggered
                                                        //Callback class as defined in setup.hpp
 
+  QAD_EXTI_EventBuffer*           m_pCapture;          //Pointer to the event buffer used in capture mode, or NULL if not in capture mode
+
 public:
 
   //--------------------------
@@ -90,8 +185,9 @@ public:
 
   void setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler);
   void setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler);
+  void setCaptureBuffer(QAD_EXTI_EventBuffer* pBuffer);
 
-  void enable(void);
+  QA_Result enable(void);
   void disable(void);
 
   void setPullMode(QAD_GPIO_PullMode ePull) override;
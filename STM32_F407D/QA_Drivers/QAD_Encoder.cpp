@@ -24,6 +24,11 @@
   //------------------------------------------
 
 
+//Default acceleration curve for exponential mode. Speeds are in counts per second (four counts per click). Built by the compiler and
+//stored in flash
+constexpr QAT_AccelCurve QAD_Encoder_DefaultCurve(32, 40, 800, 2);
+
+
   //----------------------------------
   //----------------------------------
   //QAD_Encoder Initialization Methods
@@ -40,19 +45,55 @@ QA_Result QAD_Encoder::init(void) {
   	return QA_Error_PeriphNotSupported;
   }
 
-  //Check if selected Timer peripheral is currently available
+  //Check that the index pulse is only used in extended mode
+  if ((m_eIndex != QAD_EncoderIndex_Disabled) && ((!m_bExtended) || (!m_pIdx_GPIO)))
+  	return QA_Error_PeriphNotSupported;
+
+  //Check that the velocity timer can capture the encoder timer's trigger output, and that the sample period fits its counter
+  if (m_eVelTimer != QAD_TimerNone) {
+  	if (QAD_TimerMgr::getITR(m_eVelTimer, m_eTimer) == QAD_Timer_ITRNone)
+  		return QA_Error_PeriphNotSupported;
+
+  	if ((m_uVelPeriod < 2) || ((QAD_TimerMgr::getType(m_eVelTimer) == QAD_Timer_16bit) && (m_uVelPeriod > 65536)))
+  		return QA_Error_PeriphNotSupported;
+  }
+
+  //Check if selected Timer peripherals are currently available
   if (QAD_TimerMgr::getState(m_eTimer))
   	return QA_Error_PeriphBusy;
 
-  //Register Timer peripheral as now being in use
+  if ((m_eVelTimer != QAD_TimerNone) && (QAD_TimerMgr::getState(m_eVelTimer)))
+  	return QA_Error_PeriphBusy;
+
+  //Claim Timer peripherals and GPIO pins (details of any conflict can be retrieved from QAD_ResourceMgr)
+  if (claimResources())
+  	return QA_Error_PeriphBusy;
+
+  //Register Timer peripherals as now being in use, along with the link between them
   QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_Encoder);
+  if (m_eVelTimer != QAD_TimerNone) {
+  	QAD_TimerMgr::registerTimer(m_eVelTimer, QAD_Timer_InUse_Encoder);
+
+  	if (QAD_TimerMgr::registerLink(m_eTimer, m_eVelTimer, QAD_TimerLink_TriggerComparePulse)) {
+  		QAD_TimerMgr::deregisterTimer(m_eVelTimer);
+  		QAD_TimerMgr::deregisterTimer(m_eTimer);
+  		releaseResources();
+  		return QA_Error_PeriphBusy;
+  	}
+  }
 
   //Initialize the Timer peripheral
   QA_Result eRes = periphInit();
 
-  //If initialization failed then deregister the timer peripheral
-  if (eRes)
+  //If initialization failed then deregister the timer peripherals
+  if (eRes) {
+  	if (m_eVelTimer != QAD_TimerNone) {
+  		QAD_TimerMgr::deregisterLink(m_eTimer, m_eVelTimer);
+  		QAD_TimerMgr::deregisterTimer(m_eVelTimer);
+  	}
   	QAD_TimerMgr::deregisterTimer(m_eTimer);
+  	releaseResources();
+  }
 
   //Return initialization result
   return eRes;
@@ -72,8 +113,13 @@ void QAD_Encoder::deinit(void) {
   //Deinitialize encoder driver
   periphDeinit(DeinitFull);
 
-  //Deregister the Timer peripheral
+  //Deregister the Timer peripherals
+  if (m_eVelTimer != QAD_TimerNone) {
+  	QAD_TimerMgr::deregisterLink(m_eTimer, m_eVelTimer);
+  	QAD_TimerMgr::deregisterTimer(m_eVelTimer);
+  }
   QAD_TimerMgr::deregisterTimer(m_eTimer);
+  releaseResources();
 }
 
 
@@ -93,9 +139,29 @@ void QAD_Encoder::start(void) {
   	//Clear encoder/counter data
   	clearData();
 
+  	//Enable update interrupt used to extend the position, and capture interrupt used for the index pulse
+  	if (m_bExtended) {
+  		m_pInstance->SR    = ~(TIM_SR_UIF | TIM_SR_CC3IF);
+  		m_pInstance->DIER |= TIM_DIER_UIE;
+  		if (m_eIndex != QAD_EncoderIndex_Disabled)
+  			m_pInstance->DIER |= TIM_DIER_CC3IE;
+  	}
+
   	//Start Timer peripheral in encoder mode
   	HAL_TIM_Encoder_Start(&m_sHandle, TIM_CHANNEL_ALL);
 
+  	//Start velocity timer from the start of a sample period
+  	if (m_pVelInstance) {
+  		m_uVelWindow = 0;
+  		m_bEdgeValid = false;
+  		m_iVelocity  = 0;
+
+  		m_pVelInstance->CNT   = 0;
+  		m_pVelInstance->SR    = 0;
+  		m_pVelInstance->DIER |= TIM_DIER_UIE;
+  		m_pVelInstance->CR1  |= TIM_CR1_CEN;
+  	}
+
   	//Set driver state to active
   	m_eState = QA_Active;
   }
@@ -111,8 +177,16 @@ void QAD_Encoder::stop(void) {
 	//Check encoder driver is initialized and is currently active
   if ((m_eInitState) && (m_eState)) {
 
+  	//Stop velocity timer
+  	if (m_pVelInstance) {
+  		m_pVelInstance->CR1  &= ~TIM_CR1_CEN;
+  		m_pVelInstance->DIER &= ~TIM_DIER_UIE;
+  		m_iVelocity           = 0;
+  	}
+
   	//Stop Timer peripheral
   	HAL_TIM_Encoder_Stop(&m_sHandle, TIM_CHANNEL_ALL);
+  	m_pInstance->DIER &= ~(TIM_DIER_UIE | TIM_DIER_CC3IE);
 
   	//Set driver state to inactive
   	m_eState = QA_Inactive;
@@ -127,10 +201,30 @@ void QAD_Encoder::stop(void) {
 //This method needs to be called prior to calling the getValue() method in order for getValue() to return
 //the most recent encoder value.
 //
+//In extended mode the change is taken from the position, so is correct however long it has been since the previous call
+//
 //uTicks - The time (in milliseconds) that has passed since this method was last called
-//         This is used to be able to calculate the encoder acceleration value
+//         This is used to be able to calculate the encoder acceleration value. If 0, the acceleration value is left unchanged
 void QAD_Encoder::update(uint32_t uTicks) {
 
+	//Check that encoder driver is active in extended mode
+	if ((m_eState) && (m_bExtended)) {
+		int64_t iPos  = getPosition();
+		int64_t iDiff = iPos - m_iPosOld;
+		m_iPosOld     = iPos;
+
+		//Limit the change so that the stored value cannot overflow
+		int32_t iValue = m_iValue + ((iDiff > 16384) ? 16384 : ((iDiff < -16384) ? -16384 : (int32_t)iDiff));
+		m_iValue       = (iValue > 32767) ? 32767 : ((iValue < -32768) ? -32768 : iValue);
+
+		uint64_t uDiff = (iDiff < 0) ? -iDiff : iDiff;
+		if (uTicks) {
+			uint64_t uAccel = (uDiff * 1000) / uTicks;
+			m_uAccel = (uAccel > 0xFFFF) ? 0xFFFF : uAccel;
+		}
+		return;
+	}
+
 	//Check that encoder driver is active
 	if (m_eState) {
 
@@ -153,7 +247,10 @@ void QAD_Encoder::update(uint32_t uTicks) {
 		m_iValue += (bValComp ? 0-uDiff : uDiff);
 
 		//Calculate encoder acceleration value
-		m_uAccel = uDiff * 1000 / uTicks;
+		if (uTicks) {
+			uint32_t uAccel = ((uint32_t)uDiff * 1000) / uTicks;
+			m_uAccel = (uAccel > 0xFFFF) ? 0xFFFF : uAccel;
+		}
 	}
 }
 
@@ -174,6 +271,11 @@ QA_ActiveState QAD_Encoder::getState(void) {
 //Takes into account if the encoder mode is set to linear (QAD_EncoderMode_Linear) or exponential (QAD_EncoderMode_Exp)
 //NOTE: the update() method needs to be called prior to getValue() in order to obtain the most recent value
 //
+//In exponential mode the change in counts is multiplied by the gain of the acceleration curve at the speed measured by update(). The
+//gain is 8.8 fixed point and there are four counts per click, so the scaled change is in 1/1024ths of a click. The part of a click
+//left over is carried into the next call so that slow turning at a fractional gain is not lost, unless the direction has changed.
+//The scaled change is at most 32768 * 65535 + 1023, so it cannot overflow, and the result is limited to the range of int16_t
+//
 //Returns a positive number if encoder is turned clockwise, or a negative number if encoder is turned anti-clockwise
 //If you get opposite results than this then try swapping the two quadrature signal wires
 int16_t QAD_Encoder::getValue(void) {
@@ -181,13 +283,34 @@ int16_t QAD_Encoder::getValue(void) {
 	//Check that driver is currently active
   if (m_eInitState) {
 
+  	//Apply acceleration curve in exponential mode
+  	if (m_eMode) {
+  		int32_t iScaled = (int32_t)m_iValue * m_pAccelCurve->getGain(m_uAccel);
+  		m_iValue = 0;
+
+  		if ((!iScaled) || ((iScaled ^ m_iAccelRem) >= 0))
+  			iScaled += m_iAccelRem;
+
+  		int32_t iOutVal = iScaled / 1024;
+  		m_iAccelRem     = iScaled % 1024;
+
+  		if (iOutVal > 32767) {
+  			m_iAccelRem = 0;
+  			return 32767;
+  		}
+  		if (iOutVal < -32768) {
+  			m_iAccelRem = 0;
+  			return -32768;
+  		}
+  		return iOutVal;
+  	}
+
   	//As each click of the encoder generates four quadrature signal 'edges', a single click of the encoder will change the timer
   	//counter register value by a value of +/- 4. The following code is used to take this into account.
   	int16_t iOutVal = m_iValue / 4;
   	m_iValue = m_iValue % 4;
 
-  	//Return the current value based on the currently selected encoder mode
-  	return (m_eMode) ? (iOutVal * iOutVal * iOutVal) : iOutVal;
+  	return iOutVal;
   }
 
   //Return a value of 0 if the driver is currently inactive
@@ -225,6 +348,194 @@ QAD_EncoderMode QAD_Encoder::getMode(void) {
 }
 
 
+//QAD_Encoder::setAccelCurve
+//QAD_Encoder Control Method
+//
+//Sets the acceleration curve used in exponential mode (QAD_EncoderMode_Exp)
+//pCurve - Pointer to the curve, or NULL to use the default curve (QAD_Encoder_DefaultCurve). The curve must remain valid while in use,
+//         so is normally declared as a constexpr object. See QAT_AccelCurve.hpp for details
+void QAD_Encoder::setAccelCurve(const QAT_AccelCurve* pCurve) {
+  m_pAccelCurve = (pCurve) ? pCurve : &QAD_Encoder_DefaultCurve;
+  m_iAccelRem   = 0;
+}
+
+
+  //-------------------------------------
+  //-------------------------------------
+  //QAD_Encoder Position/Velocity Methods
+
+//QAD_Encoder::setPosition
+//QAD_Encoder Position/Velocity Method
+//
+//Used to set the current position when in extended mode, such as when a reference position has been found
+//Interrupts are disabled while the base position is replaced, so that the encoder interrupt cannot apply a wrap part way through
+//iPosition - The new position in counts
+void QAD_Encoder::setPosition(int64_t iPosition) {
+	if ((!m_bExtended) || (!m_pInstance))
+		return;
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	//If a wrap is pending, the base position is set so that it is correct once the interrupt has applied the wrap
+	uint32_t uCount = m_pInstance->CNT;
+	int64_t  iBase  = iPosition - uCount;
+	if (m_pInstance->SR & TIM_SR_UIF)
+		iBase -= getWrap(uCount);
+
+	//The index position is moved by the same amount, so that it stays at the same physical position
+	uint32_t uSeq = m_uSeq;
+	publish(iBase, m_iIndex[uSeq & 1] + (iBase - m_iBase[uSeq & 1]));
+	m_iPosOld = iPosition;
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAD_Encoder::armIndex
+//QAD_Encoder Position/Velocity Method
+//
+//Used in QAD_EncoderIndex_Home mode to have the position reset at the next index pulse, such as to repeat a homing sequence
+//start() also arms the index pulse
+void QAD_Encoder::armIndex(void) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_bIndexArmed = (m_eIndex == QAD_EncoderIndex_Home);
+	m_bHomed      = false;
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAD_Encoder IRQ Handler Methods
+
+//QAD_Encoder::handler
+//QAD_Encoder IRQ Handler Method
+//
+//Applies a counter wrap to the base position when in extended mode, and processes index pulse captures
+//The flag is cleared, the counter read and the new base position published with interrupts disabled, so that a higher priority
+//interrupt reading the position sees either the old base position with the flag set, or the new base position with the flag clear
+//The position is only lost if the counter crosses its wrap point twice within the interrupt latency, which the counter's starting point
+//in the middle of its range makes unlikely
+//The index position is the current position less the counts made since the capture, taking the shorter way around the counter range
+//This method is only to be called by the interrupt request handler function from handlers.cpp
+void QAD_Encoder::handler(void) {
+	if (!m_pInstance)
+		return;
+
+	uint32_t uSR = m_pInstance->SR & (TIM_SR_UIF | TIM_SR_CC3IF);
+	if (!uSR)
+		return;
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	if (uSR & TIM_SR_UIF)
+		m_pInstance->SR = ~TIM_SR_UIF;
+
+	uint32_t uSeq   = m_uSeq;
+	int64_t  iBase  = m_iBase[uSeq & 1];
+	int64_t  iIndex = m_iIndex[uSeq & 1];
+	uint32_t uCount = m_pInstance->CNT;
+
+	if (uSR & TIM_SR_UIF)
+		iBase += getWrap(uCount);
+
+	if (uSR & TIM_SR_CC3IF) {
+		int64_t iSince = (int64_t)uCount - (int64_t)m_pInstance->CCR3;  //Reading CCR3 clears the capture flag
+		if (iSince > (int64_t)(m_uRange / 2))
+			iSince -= m_uRange;
+		if (iSince < -(int64_t)(m_uRange / 2))
+			iSince += m_uRange;
+
+		iIndex = iBase + uCount - iSince;
+		m_uIndexCount = m_uIndexCount + 1;
+
+		//Reset position so that the index pulse is at position 0
+		if ((m_eIndex == QAD_EncoderIndex_Reset) || ((m_eIndex == QAD_EncoderIndex_Home) && (m_bIndexArmed))) {
+			iBase        -= iIndex;
+			iIndex        = 0;
+			m_bIndexArmed = false;
+			m_bHomed      = true;
+		}
+	}
+
+	publish(iBase, iIndex);
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAD_Encoder::velocityHandler
+//QAD_Encoder IRQ Handler Method
+//
+//Calculates the velocity at the end of each sample period of the velocity timer (see the QAD_Encoder class description)
+//Edge times are kept as a 32bit tick count, made up of the start time of the sample period and the captured counter value. A capture
+//value larger than the current counter value was made before the update event that triggered this interrupt
+//This method is only to be called by the interrupt request handler function from handlers.cpp
+void QAD_Encoder::velocityHandler(void) {
+	if ((!m_pVelInstance) || (!(m_pVelInstance->SR & TIM_SR_UIF)))
+		return;
+
+	m_pVelInstance->SR = ~TIM_SR_UIF;
+
+	uint32_t uWindowOld = m_uVelWindow;
+	m_uVelWindow       += m_uVelPeriod;
+	uint32_t uCount     = m_pVelInstance->CNT;
+	int64_t  iVelocity  = m_iVelocity;
+
+	if (m_pVelInstance->SR & TIM_SR_CC1IF) {
+
+		//Read edge time and edge count, repeating if another edge is captured between the two reads (reading CCR1 clears the flag)
+		uint32_t uCapture;
+		uint32_t uEdgeCount;
+		do {
+			uCapture   = m_pVelInstance->CCR1;
+			uEdgeCount = m_pInstance->CCR1;
+		} while (m_pVelInstance->SR & TIM_SR_CC1IF);
+
+		uint32_t uEdgeTime = ((uCapture > uCount) ? uWindowOld : m_uVelWindow) + uCapture;
+
+		if (m_bEdgeValid) {
+			//Take the shorter way around the counter range, as the counter may have wrapped between the edges
+			int64_t iCounts = (int64_t)uEdgeCount - (int64_t)m_uEdgeCount;
+			if (iCounts > (int64_t)(m_uRange / 2))
+				iCounts -= m_uRange;
+			if (iCounts < -(int64_t)(m_uRange / 2))
+				iCounts += m_uRange;
+
+			uint32_t uTime  = uEdgeTime - m_uEdgeTime;
+			if (uTime)
+				iVelocity = (iCounts * m_uVelFreq) / uTime;
+		}
+
+		m_uEdgeTime  = uEdgeTime;
+		m_uEdgeCount = uEdgeCount;
+		m_bEdgeValid = true;
+
+	} else if (m_bEdgeValid) {
+
+		//No edge in this period, so the encoder has moved less than one quadrature cycle (four counts) since the last edge
+		uint32_t uTime = (m_uVelWindow + uCount) - m_uEdgeTime;
+		if (uTime & 0x80000000) {
+			iVelocity    = 0;
+			m_bEdgeValid = false;
+		} else {
+			int64_t iMax = ((int64_t)4 * m_uVelFreq) / uTime;
+			if (iVelocity > iMax)
+				iVelocity = iMax;
+			if (iVelocity < -iMax)
+				iVelocity = -iMax;
+		}
+	}
+
+	m_iVelocity = (iVelocity > INT32_MAX) ? INT32_MAX : ((iVelocity < INT32_MIN) ? INT32_MIN : (int32_t)iVelocity);
+}
+
+
   //------------------------------------------
   //------------------------------------------
   //QAD_Encoder Private Initialization Methods
@@ -252,6 +563,13 @@ QA_Result QAD_Encoder::periphInit(void) {
   GPIO_Init.Alternate = m_uCh2_AF;             //Set alternate function to suit required timer peripheral
   HAL_GPIO_Init(m_pCh2_GPIO, &GPIO_Init);
 
+  //Encoder Index GPIO Initialization
+  if (m_eIndex != QAD_EncoderIndex_Disabled) {
+  	GPIO_Init.Pin       = m_uIdx_Pin;            //Set pin number
+  	GPIO_Init.Alternate = m_uIdx_AF;             //Set alternate function to suit required timer peripheral
+  	HAL_GPIO_Init(m_pIdx_GPIO, &GPIO_Init);
+  }
+
   //Enable Timer Clock
   QAD_TimerMgr::enableClock(m_eTimer);
 
@@ -259,7 +577,9 @@ QA_Result QAD_Encoder::periphInit(void) {
   m_sHandle.Instance               = QAD_TimerMgr::getInstance(m_eTimer);  //Set instance for required timer peripheral
   m_sHandle.Init.Prescaler         = 0;                                    //Prescaler is unused as timer counter is clocked by the encoder's quadrature signal
   m_sHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;                   //Counter mode is unused as timer counter is updated based on quadrature signal
-  m_sHandle.Init.Period            = m_uMaxVal;                            //Set timer period
+  m_sHandle.Init.Period            = m_uMaxVal;                            //Set timer period (full counter range in extended mode)
+  if (m_bExtended)
+  	m_sHandle.Init.Period = (QAD_TimerMgr::getType(m_eTimer) == QAD_Timer_32bit) ? 0xFFFFFFFF : 0xFFFF;
   m_sHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;               //Unused
   m_sHandle.Init.RepetitionCounter = 0x0;                                  //
   m_sHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;        //Enable preload of the timer's auto-reload register
@@ -269,17 +589,51 @@ QA_Result QAD_Encoder::periphInit(void) {
   ENC_Init.IC1Polarity   = TIM_ICPOLARITY_RISING;                          //Set IC1 polarity to rising edge
   ENC_Init.IC1Selection  = TIM_ICSELECTION_DIRECTTI;                       //Set IC1 to direct connection mode
   ENC_Init.IC1Prescaler  = TIM_ICPSC_DIV1;                                 //IC1 capture performed on each edge
-  ENC_Init.IC1Filter     = 0x0;                                            //Disable IC1 input capture filter
+  ENC_Init.IC1Filter     = m_uFilter;                                      //Set IC1 input capture filter
   ENC_Init.IC2Polarity   = TIM_ICPOLARITY_RISING;                          //Set IC2 polarity to rising edge
   ENC_Init.IC2Selection  = TIM_ICSELECTION_DIRECTTI;                       //Set IC2 to direct connection mode
   ENC_Init.IC2Prescaler  = TIM_ICPSC_DIV1;                                 //IC2 capture performed on each edge
-  ENC_Init.IC2Filter     = 0x0;                                            //Disable IC2 input capture filter
+  ENC_Init.IC2Filter     = m_uFilter;                                      //Set IC2 input capture filter
 
   //Initialize Timer in encoder mode, performing a partial deinitialization if the initialization fails
   if (HAL_TIM_Encoder_Init(&m_sHandle, &ENC_Init) != HAL_OK) {
   	periphDeinit(DeinitPartial);
   	return QA_Fail;
   }
+  m_pInstance = m_sHandle.Instance;
+  m_uRange    = (uint64_t)m_sHandle.Init.Period + 1;
+
+  //Set channel 3 to capture the counter on the rising edge of the index signal, using the same filter as the quadrature inputs
+  if (m_eIndex != QAD_EncoderIndex_Disabled) {
+  	m_pInstance->CCMR2 = (m_pInstance->CCMR2 & ~(TIM_CCMR2_CC3S | TIM_CCMR2_IC3F | TIM_CCMR2_IC3PSC)) |
+  	                     TIM_CCMR2_CC3S_0 | ((uint32_t)m_uFilter << TIM_CCMR2_IC3F_Pos);
+  	m_pInstance->CCER  = (m_pInstance->CCER & ~(TIM_CCER_CC3P | TIM_CCER_CC3NP)) | TIM_CCER_CC3E;
+  }
+
+  //Set Timer IRQ priority and enable IRQ for extended mode
+  if (m_bExtended) {
+  	HAL_NVIC_SetPriority(QAD_TimerMgr::getUpdateIRQ(m_eTimer), m_uIRQPriority, 0);
+  	HAL_NVIC_EnableIRQ(QAD_TimerMgr::getUpdateIRQ(m_eTimer));
+
+  	if ((m_eIndex != QAD_EncoderIndex_Disabled) && (getCaptureIRQ() != QAD_TimerMgr::getUpdateIRQ(m_eTimer))) {
+  		HAL_NVIC_SetPriority(getCaptureIRQ(), m_uIRQPriority, 0);
+  		HAL_NVIC_EnableIRQ(getCaptureIRQ());
+  	}
+  }
+
+  //Initialize velocity timer
+  if (m_eVelTimer != QAD_TimerNone) {
+  	if (velocityInit()) {
+  		if (m_bExtended) {
+  			HAL_NVIC_DisableIRQ(QAD_TimerMgr::getUpdateIRQ(m_eTimer));
+  			if (m_eIndex != QAD_EncoderIndex_Disabled)
+  				HAL_NVIC_DisableIRQ(getCaptureIRQ());
+  		}
+  		HAL_TIM_Encoder_DeInit(&m_sHandle);
+  		periphDeinit(DeinitPartial);
+  		return QA_Fail;
+  	}
+  }
 
   //Set Driver States
   m_eInitState = QA_Initialized; //Set driver state as initialized
@@ -302,9 +656,21 @@ void QAD_Encoder::periphDeinit(QAD_Encoder::DeinitMode eDeinitMode) {
 	//Check if full deinitialization is required
 	if (eDeinitMode) {
 
+		//Deinitialize velocity timer
+		if (m_pVelInstance)
+			velocityDeinit();
+
+		//Disable Timer IRQs
+		if (m_bExtended) {
+			HAL_NVIC_DisableIRQ(QAD_TimerMgr::getUpdateIRQ(m_eTimer));
+			if (m_eIndex != QAD_EncoderIndex_Disabled)
+				HAL_NVIC_DisableIRQ(getCaptureIRQ());
+		}
+
 		//Deinitialize Timer Peripheral
 		HAL_TIM_Encoder_DeInit(&m_sHandle);
 	}
+	m_pInstance = NULL;
 
 	//Disable Timer Clock
 	QAD_TimerMgr::disableClock(m_eTimer);
@@ -312,6 +678,8 @@ void QAD_Encoder::periphDeinit(QAD_Encoder::DeinitMode eDeinitMode) {
 	//Deinit GPIOs
 	HAL_GPIO_DeInit(m_pCh1_GPIO, m_uCh1_Pin);
 	HAL_GPIO_DeInit(m_pCh2_GPIO, m_uCh2_Pin);
+	if (m_eIndex != QAD_EncoderIndex_Disabled)
+		HAL_GPIO_DeInit(m_pIdx_GPIO, m_uIdx_Pin);
 
 	//Set States
 	m_eState     = QA_Inactive;        //Set driver as currently inactive
@@ -319,6 +687,125 @@ void QAD_Encoder::periphDeinit(QAD_Encoder::DeinitMode eDeinitMode) {
 }
 
 
+
+//QAD_Encoder::claimResources
+//QAD_Encoder Private Initialization Method
+//
+//Used to claim the Timer peripherals and the GPIO pins for both encoder channels from QAD_ResourceMgr
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_Encoder::claimResources(void) {
+	if (QAD_ResourceMgr::claimTimer(m_eTimer, "Encoder"))
+		return QA_Error_PeriphBusy;
+
+	if ((m_eVelTimer != QAD_TimerNone) && (QAD_ResourceMgr::claimTimer(m_eVelTimer, "Encoder"))) {
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Encoder");
+		return QA_Error_PeriphBusy;
+	}
+
+	if (QAD_ResourceMgr::claimPins(m_pCh1_GPIO, m_uCh1_Pin, "Encoder")) {
+		if (m_eVelTimer != QAD_TimerNone)
+			QAD_ResourceMgr::release(QAD_Resource_Timer, m_eVelTimer, "Encoder");
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Encoder");
+		return QA_Error_PeriphBusy;
+	}
+
+	if (QAD_ResourceMgr::claimPins(m_pCh2_GPIO, m_uCh2_Pin, "Encoder")) {
+		QAD_ResourceMgr::releasePins(m_pCh1_GPIO, m_uCh1_Pin, "Encoder");
+		if (m_eVelTimer != QAD_TimerNone)
+			QAD_ResourceMgr::release(QAD_Resource_Timer, m_eVelTimer, "Encoder");
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Encoder");
+		return QA_Error_PeriphBusy;
+	}
+
+	if ((m_eIndex != QAD_EncoderIndex_Disabled) && (QAD_ResourceMgr::claimPins(m_pIdx_GPIO, m_uIdx_Pin, "Encoder"))) {
+		QAD_ResourceMgr::releasePins(m_pCh2_GPIO, m_uCh2_Pin, "Encoder");
+		QAD_ResourceMgr::releasePins(m_pCh1_GPIO, m_uCh1_Pin, "Encoder");
+		if (m_eVelTimer != QAD_TimerNone)
+			QAD_ResourceMgr::release(QAD_Resource_Timer, m_eVelTimer, "Encoder");
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Encoder");
+		return QA_Error_PeriphBusy;
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_Encoder::releaseResources
+//QAD_Encoder Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_Encoder::releaseResources(void) {
+	if (m_eIndex != QAD_EncoderIndex_Disabled)
+		QAD_ResourceMgr::releasePins(m_pIdx_GPIO, m_uIdx_Pin, "Encoder");
+	QAD_ResourceMgr::releasePins(m_pCh2_GPIO, m_uCh2_Pin, "Encoder");
+	QAD_ResourceMgr::releasePins(m_pCh1_GPIO, m_uCh1_Pin, "Encoder");
+	if (m_eVelTimer != QAD_TimerNone)
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eVelTimer, "Encoder");
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Encoder");
+}
+
+
+//QAD_Encoder::velocityInit
+//QAD_Encoder Private Initialization Method
+//
+//Used to initialize the velocity timer, with channel 1 capturing the encoder timer's trigger output
+//The encoder timer's trigger output is set to pulse on each channel 1 capture, which occurs on each rising edge of quadrature channel 1
+//Returns QA_OK if successful, or QA_Fail if initialization fails
+QA_Result QAD_Encoder::velocityInit(void) {
+
+	//Set encoder timer's trigger output to pulse on each channel 1 capture
+	m_pInstance->CR2 = (m_pInstance->CR2 & ~TIM_CR2_MMS) | TIM_TRGO_OC1;
+
+	//Enable Timer Clock
+	QAD_TimerMgr::enableClock(m_eVelTimer);
+
+	//Initialize Timer
+	m_sVelHandle.Instance               = QAD_TimerMgr::getInstance(m_eVelTimer); //Set instance for required timer peripheral
+	m_sVelHandle.Init.Prescaler         = m_uVelPrescaler;                        //Set timer prescaler
+	m_sVelHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;                     //Set timer counter mode to count up
+	m_sVelHandle.Init.Period            = m_uVelPeriod - 1;                       //Set timer period to the sample period
+	m_sVelHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;                 //Unused
+	m_sVelHandle.Init.RepetitionCounter = 0x0;                                    //
+	m_sVelHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;          //Enable preload of the timer's auto-reload register
+
+	if (HAL_TIM_Base_Init(&m_sVelHandle) != HAL_OK) {
+		QAD_TimerMgr::disableClock(m_eVelTimer);
+		return QA_Fail;
+	}
+	m_pVelInstance = m_sVelHandle.Instance;
+	m_uVelFreq     = QAD_TimerMgr::getClockSpeed(m_eVelTimer) / (m_uVelPrescaler + 1);
+
+	//Select the encoder timer as the trigger input, and map channel 1 to the trigger input (TRC) in capture mode
+	//The slave mode controller is left disabled, so the trigger only causes captures
+	uint8_t uITR = QAD_TimerMgr::getITR(m_eVelTimer, m_eTimer);
+	m_pVelInstance->SMCR  = (m_pVelInstance->SMCR & ~(TIM_SMCR_TS | TIM_SMCR_SMS)) | ((uint32_t)uITR << TIM_SMCR_TS_Pos);
+	m_pVelInstance->CCMR1 = (m_pVelInstance->CCMR1 & ~(TIM_CCMR1_CC1S | TIM_CCMR1_IC1F | TIM_CCMR1_IC1PSC)) | TIM_CCMR1_CC1S;
+	m_pVelInstance->CCER |= TIM_CCER_CC1E;
+
+	//Set Timer IRQ priority and enable IRQ
+	HAL_NVIC_SetPriority(QAD_TimerMgr::getUpdateIRQ(m_eVelTimer), m_uIRQPriority, 0);
+	HAL_NVIC_EnableIRQ(QAD_TimerMgr::getUpdateIRQ(m_eVelTimer));
+
+	return QA_OK;
+}
+
+
+//QAD_Encoder::velocityDeinit
+//QAD_Encoder Private Initialization Method
+//
+//Used to deinitialize the velocity timer, and reset the encoder timer's trigger output
+void QAD_Encoder::velocityDeinit(void) {
+	HAL_NVIC_DisableIRQ(QAD_TimerMgr::getUpdateIRQ(m_eVelTimer));
+
+	m_pVelInstance->CCER &= ~TIM_CCER_CC1E;
+	HAL_TIM_Base_DeInit(&m_sVelHandle);
+	QAD_TimerMgr::disableClock(m_eVelTimer);
+	m_pVelInstance = NULL;
+
+	m_pInstance->CR2 &= ~TIM_CR2_MMS;
+}
+
+
   //--------------------------------
   //--------------------------------
   //QAD_Encoder Private Tool Methods
@@ -327,10 +814,40 @@ void QAD_Encoder::periphDeinit(QAD_Encoder::DeinitMode eDeinitMode) {
 //QAD_Encoder Private Tool Method
 //
 //Used to clear the encoder/counter data, as well as clearing the Timer's counter register to 0
+//In extended mode the counter is instead set to the middle of its range, with the base position set so that the position is 0
 void QAD_Encoder::clearData(void) {
   m_uValueOld = 0;
   m_uValueNew = 0;
   m_iValue    = 0;
   m_uAccel    = 0;
-  __HAL_TIM_SET_COUNTER(&m_sHandle, 0);
+  m_iAccelRem = 0;
+  m_iPosOld   = 0;
+
+  m_iIndex[0]   = 0;
+  m_iIndex[1]   = 0;
+  m_uIndexCount = 0;
+  m_bIndexArmed = (m_eIndex == QAD_EncoderIndex_Home);
+  m_bHomed      = false;
+
+  if (m_bExtended) {
+  	m_iBase[0] = -(int64_t)(m_uRange / 2);
+  	m_iBase[1] = -(int64_t)(m_uRange / 2);
+  	__HAL_TIM_SET_COUNTER(&m_sHandle, (uint32_t)(m_uRange / 2));
+  } else {
+  	__HAL_TIM_SET_COUNTER(&m_sHandle, 0);
+  }
+}
+
+
+//QAD_Encoder::getCaptureIRQ
+//QAD_Encoder Private Tool Method
+//
+//Returns the IRQ used for capture interrupts of the encoder timer. Timers 1 and 8 have a separate capture/compare IRQ, while the other
+//encoder capable timers use a single IRQ for all events
+IRQn_Type QAD_Encoder::getCaptureIRQ(void) {
+	if (m_eTimer == QAD_Timer1)
+		return TIM1_CC_IRQn;
+	if (m_eTimer == QAD_Timer8)
+		return TIM8_CC_IRQn;
+	return QAD_TimerMgr::getUpdateIRQ(m_eTimer);
 }
@@ -23,6 +23,9 @@
 #include "setup.hpp"
 
 #include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_TimerLink.hpp"
+#include "QAT_AccelCurve.hpp"
 
 
 	//------------------------------------------
@@ -40,9 +43,30 @@ enum QAD_EncoderMode : uint8_t {
 
 	QAD_EncoderMode_Exp          //Exponential mode - speed at which encoder is rotated results in smaller or larger value changes
 	                             //Best used when needing to scroll through a large number of values/settings
+	                             //The change in value is scaled by an acceleration curve (see QAT_AccelCurve.hpp and setAccelCurve())
 };
 
 
+//----------------
+//QAD_EncoderIndex
+//
+//Used with QAD_Encoder driver class to select how the encoder's index (Z) pulse is used. The index pulse is only available in extended mode
+enum QAD_EncoderIndex : uint8_t {
+	QAD_EncoderIndex_Disabled = 0,  //Index pulse not used
+	QAD_EncoderIndex_Latch,         //The position of each index pulse is latched (see getIndexPosition())
+	QAD_EncoderIndex_Home,          //The position is reset to 0 at the first index pulse after start() or armIndex(), for homing
+	QAD_EncoderIndex_Reset          //The position is reset to 0 at every index pulse, giving a position within a single revolution
+};
+
+
+//------------------------
+//QAD_Encoder_DefaultCurve
+//
+//Acceleration curve used in QAD_EncoderMode_Exp when no other curve is provided (defined in QAD_Encoder.cpp)
+//Single clicks below 10 clicks per second, rising as a square law to 32 times at 200 clicks per second
+extern const QAT_AccelCurve QAD_Encoder_DefaultCurve;
+
+
 //----------------------
 //QAD_Encoder_InitStruct
 //
@@ -61,6 +85,25 @@ typedef struct {
 	                             //Note that the selected timer must have rotary encoder mode support
 
 	QAD_EncoderMode   eMode;     //Encoder output data mode (QAD_EncoderMode_Linear or QAD_EncoderMode_Exp)
+	const QAT_AccelCurve* pAccelCurve; //Acceleration curve used in QAD_EncoderMode_Exp, indexed by getAccel() (counts per second)
+	                                   //Set to NULL to use the driver's default curve. The curve must remain valid while the driver exists
+
+	uint8_t           uFilter;   //Digital input filter for the quadrature and index inputs (0 to 15, the ICxF value from the reference manual)
+	                             //0 disables the filter. Higher values require an input to be stable for longer before a change is accepted,
+	                             //up to 8 samples at 1/32 of the timer clock for a value of 15
+
+	GPIO_TypeDef*     pIdx_GPIO; //GPIO port to be used for the encoder's index (Z) signal, which is connected to channel 3 of the Timer peripheral
+	uint16_t          uIdx_Pin;  //Pin number to be used for the encoder's index signal
+	uint8_t           uIdx_AF;   //Alternate function to be used to link GPIO pin to Timer peripheral
+	QAD_EncoderIndex  eIndex;    //Index pulse mode. Member of QAD_EncoderIndex. Set to QAD_EncoderIndex_Disabled if there is no index signal
+
+	bool              bExtended;     //Set to true to keep a 64bit position using the timer's update interrupt (see getPosition())
+	uint8_t           uIRQPriority;  //IRQ Priority for the update interrupts of the encoder timer and velocity timer (a value between 0 and 15)
+
+	QAD_Timer_Periph  eVelTimer;     //Timer peripheral to be used for velocity estimation (see getVelocity()). Set to QAD_TimerNone if not required
+	                                 //Must be able to use the encoder timer as an internal trigger (see QAD_TimerMgr::getITR())
+	uint32_t          uVelPrescaler; //Prescaler to be used for the velocity timer. This sets the resolution of edge timing
+	uint32_t          uVelPeriod;    //Velocity sample period, in velocity timer ticks (at most 65536 for a 16bit timer)
 
 } QAD_Encoder_InitStruct;
 
@@ -73,6 +116,23 @@ typedef struct {
 //QAD_Encoder
 //
 //Driver class for using timer peripheral in rotary encoder mode
+//
+//In extended mode, the timer counts over its full range and its update interrupt extends the count to a 64bit position, so the
+//position remains correct regardless of how often it is read. The counter is started at the middle of its range so that a stationary
+//encoder is not sitting on the wrap point. The position can be read by getPosition() from tasks and from interrupts of any priority
+//without locks, using the same method as QAS_Clock.
+//
+//Velocity is estimated with the M/T method, using a second timer. The encoder timer's channel 1 captures the count on each rising edge
+//of the quadrature channel 1 signal, and its trigger output passes the same event to channel 1 of the velocity timer, which captures the
+//time of the edge. At the end of each sample period, the velocity is the number of counts between the last edges of the previous and
+//current periods (M), divided by the exact time between those edges (T). This gives the resolution of edge timing at low speed and the
+//resolution of counting at high speed. If no edge occurs during a period, the velocity is limited to one edge over the time since the
+//last edge, so that it decays towards zero when the encoder stops
+//
+//The index pulse is captured on channel 3 of the encoder timer. Its position is worked out from the captured count, so is exact even if
+//the interrupt is serviced late. When the position is reset by the index pulse, only the base position is changed, so counts made between
+//the index pulse and its interrupt are kept. On Timers 1 and 8 the capture interrupt is separate from the update interrupt, so handler()
+//needs to be called from both interrupt request handler functions
 class QAD_Encoder {
 private:
 
@@ -108,6 +168,41 @@ private:
 
 	QAD_EncoderMode    m_eMode;           //Stores whether the encoder data output is in linear or exponential mode
 	                                      //See QAD_EncoderMode definition for further details
+	const QAT_AccelCurve* m_pAccelCurve;  //Acceleration curve used in exponential mode
+	int16_t            m_iAccelRem;       //Fraction of a click left over from the previous getValue() in exponential mode (1/1024ths of a click)
+
+	uint8_t            m_uFilter;         //Digital input filter value
+
+	GPIO_TypeDef*      m_pIdx_GPIO;       //GPIO port to be used for the encoder's index signal
+	uint16_t           m_uIdx_Pin;        //Pin number to be used for the encoder's index signal
+	uint8_t            m_uIdx_AF;         //Alternate function to be used to link GPIO pin to timer peripheral
+	QAD_EncoderIndex   m_eIndex;          //Index pulse mode
+
+	bool               m_bExtended;       //Stores whether extended position mode is used
+	uint8_t            m_uIRQPriority;    //IRQ Priority for the update interrupts
+	uint64_t           m_uRange;          //Number of counts in the timer's counter range (period + 1)
+	TIM_TypeDef*       m_pInstance;       //Encoder timer registers, cached for position reads
+
+	volatile int64_t   m_iBase[2];        //Position of counter value 0. Two copies are kept so that one can be read while the other is written
+	volatile int64_t   m_iIndex[2];       //Position of the most recent index pulse, kept in the same way as m_iBase
+	volatile uint32_t  m_uSeq;            //Incremented each time the base or index position changes. Bit 0 selects the current copies
+	volatile uint32_t  m_uIndexCount;     //Number of index pulses since start()
+	volatile bool      m_bIndexArmed;     //Set when the next index pulse is to reset the position, in QAD_EncoderIndex_Home mode
+	volatile bool      m_bHomed;          //Set once the position has been reset by an index pulse
+	int64_t            m_iPosOld;         //Position at the previous call to update(), when in extended mode
+
+	QAD_Timer_Periph   m_eVelTimer;       //Timer peripheral used for velocity estimation
+	uint32_t           m_uVelPrescaler;   //Prescaler for the velocity timer
+	uint32_t           m_uVelPeriod;      //Velocity sample period in velocity timer ticks
+	uint32_t           m_uVelFreq;        //Velocity timer tick frequency in Hz
+	TIM_TypeDef*       m_pVelInstance;    //Velocity timer registers
+	TIM_HandleTypeDef  m_sVelHandle;      //Handle used by HAL functions to access the velocity Timer peripheral
+
+	uint32_t           m_uVelWindow;      //Velocity timer time at the start of the current sample period (in ticks, wrapping at 32bits)
+	uint32_t           m_uEdgeTime;       //Time of the most recent captured edge
+	uint32_t           m_uEdgeCount;      //Encoder counter value at the most recent captured edge
+	bool               m_bEdgeValid;      //Set once an edge has been captured
+	volatile int32_t   m_iVelocity;       //Most recent velocity estimate in counts per second
 
 public:
 
@@ -131,7 +226,36 @@ public:
 		m_uValueNew(0),
 		m_iValue(0),
 		m_uAccel(0),
-		m_eMode(sInit.eMode) {};
+		m_eMode(sInit.eMode),
+		m_pAccelCurve(sInit.pAccelCurve ? sInit.pAccelCurve : &QAD_Encoder_DefaultCurve),
+		m_iAccelRem(0),
+		m_uFilter(sInit.uFilter & 0x0F),
+		m_pIdx_GPIO(sInit.pIdx_GPIO),
+		m_uIdx_Pin(sInit.uIdx_Pin),
+		m_uIdx_AF(sInit.uIdx_AF),
+		m_eIndex(sInit.eIndex),
+		m_bExtended(sInit.bExtended),
+		m_uIRQPriority(sInit.uIRQPriority),
+		m_uRange(0),
+		m_pInstance(NULL),
+		m_iBase{0, 0},
+		m_iIndex{0, 0},
+		m_uSeq(0),
+		m_uIndexCount(0),
+		m_bIndexArmed(false),
+		m_bHomed(false),
+		m_iPosOld(0),
+		m_eVelTimer(sInit.eVelTimer),
+		m_uVelPrescaler(sInit.uVelPrescaler),
+		m_uVelPeriod(sInit.uVelPeriod),
+		m_uVelFreq(0),
+		m_pVelInstance(NULL),
+		m_sVelHandle({0}),
+		m_uVelWindow(0),
+		m_uEdgeTime(0),
+		m_uEdgeCount(0),
+		m_bEdgeValid(false),
+		m_iVelocity(0) {};
 
   ~QAD_Encoder() {       //Destructor to make sure peripheral is mode inactive and deinitialized upon class destruction
 
@@ -169,6 +293,78 @@ public:
   void setMode(QAD_EncoderMode eMode);
   QAD_EncoderMode getMode(void);
 
+  void setAccelCurve(const QAT_AccelCurve* pCurve);
+
+
+  //-------------------------
+  //Position/Velocity Methods
+
+  //Returns the current position in counts (four counts per quadrature cycle), when in extended mode. Returns 0 if not in extended mode
+  //This method does not disable interrupts or use locks, and can be called from tasks or from interrupts of any priority. The retry loop
+  //only repeats if the encoder interrupt occurs part way through the read
+  int64_t getPosition(void) {
+  	uint32_t uSeq;
+  	uint32_t uSR;
+  	uint32_t uCount;
+  	int64_t  iBase;
+
+  	if ((!m_bExtended) || (!m_pInstance))
+  		return 0;
+
+  	do {
+  		uSeq   = m_uSeq;
+  		uSR    = m_pInstance->SR;
+  		uCount = m_pInstance->CNT;
+  		iBase  = m_iBase[uSeq & 1];
+  	} while ((uSeq != m_uSeq) || ((uSR ^ m_pInstance->SR) & TIM_SR_UIF));
+
+  	//If the counter has wrapped but the interrupt has not yet been serviced (for instance if called from a higher priority interrupt
+  	//handler), then the wrap is applied here in the same way as the interrupt will apply it
+  	if (uSR & TIM_SR_UIF)
+  		iBase += getWrap(uCount);
+
+  	return iBase + uCount;
+  }
+
+  //Returns the most recent velocity estimate in counts per second, with a positive value for the same direction as increasing position
+  //Updated once per velocity sample period. Returns 0 if velocity estimation is not used
+  //This is a single 32bit read, so can be called from tasks or from interrupts of any priority
+  int32_t getVelocity(void) {
+  	return m_iVelocity;
+  }
+
+  //Returns the position of the most recent index pulse, in the same way as getPosition(). Returns 0 if no index pulse has occurred
+  //In QAD_EncoderIndex_Home and QAD_EncoderIndex_Reset modes, this is 0 once the position has been reset by the index pulse
+  int64_t getIndexPosition(void) {
+  	uint32_t uSeq;
+  	int64_t  iIndex;
+  	do {
+  		uSeq   = m_uSeq;
+  		iIndex = m_iIndex[uSeq & 1];
+  	} while (uSeq != m_uSeq);
+  	return iIndex;
+  }
+
+  //Returns the number of index pulses since start()
+  uint32_t getIndexCount(void) {
+  	return m_uIndexCount;
+  }
+
+  //Returns true once the position has been reset by an index pulse
+  bool isHomed(void) {
+  	return m_bHomed;
+  }
+
+  void setPosition(int64_t iPosition);
+  void armIndex(void);
+
+
+  //-------------------
+  //IRQ Handler Methods
+
+  void handler(void);
+  void velocityHandler(void);
+
 private:
 
   //----------------------
@@ -177,12 +373,40 @@ private:
   QA_Result periphInit(void);
   void periphDeinit(DeinitMode eDeinitMode);
 
+  QA_Result claimResources(void);
+  void releaseResources(void);
+
+  QA_Result velocityInit(void);
+  void velocityDeinit(void);
+
 
   //------------
   //Tool Methods
 
   void clearData(void);
 
+  //Used to publish new base and index positions. Only to be called with interrupts disabled
+  void publish(int64_t iBase, int64_t iIndex) {
+  	uint32_t uSeq = m_uSeq + 1;
+  	m_iBase[uSeq & 1]  = iBase;
+  	m_iIndex[uSeq & 1] = iIndex;
+  	m_uSeq = uSeq;
+  }
+
+  IRQn_Type getCaptureIRQ(void);
+
+  //Returns the change in base position for a counter wrap, given a counter value read after the wrap
+  //A value in the lowest quarter of the range follows an overflow and a value in the highest quarter follows an underflow. A value in
+  //the middle of the range can only be read if the wrap was serviced very late, in which case the counter's direction bit is used
+  //uCount - The counter value
+  int64_t getWrap(uint32_t uCount) {
+  	if (uCount < (m_uRange / 4))
+  		return (int64_t)m_uRange;
+  	if (uCount >= ((m_uRange * 3) / 4))
+  		return -(int64_t)m_uRange;
+  	return (m_pInstance->CR1 & TIM_CR1_DIR) ? -(int64_t)m_uRange : (int64_t)m_uRange;
+  }
+
 };
 
 
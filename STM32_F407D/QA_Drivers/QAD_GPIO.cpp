@@ -38,10 +38,17 @@ QAD_GPIO_Output::QAD_GPIO_Output(GPIO_TypeDef* pGPIO, uint16_t uPin) :
 	m_eOutputMode(QAD_GPIO_OutputMode_PushPull),
 	m_ePullMode(QAD_GPIO_PullMode_NoPull),
 	m_eSpeed(QAD_GPIO_Speed_Low),
-	m_eState(QAD_GPIO_PinState_Off) {
+	m_eState(QAD_GPIO_PinState_Off),
+	m_eInitState(QA_NotInitialized) {
+
+	//Claim the GPIO Pin. The pin is left untouched if it is held by another driver (details of the conflict can be retrieved from
+	//QAD_ResourceMgr)
+	if (QAD_ResourceMgr::claimPins(m_pGPIO, m_uPin, "GPIO_Output"))
+		return;
+	m_eInitState = QA_Initialized;
 
 	//Initialize the GPIO Pin
-  periphInit();
+	periphInit();
 }
 
 
@@ -60,7 +67,14 @@ QAD_GPIO_Output::QAD_GPIO_Output(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_Ou
 	m_eOutputMode(eMode),
 	m_ePullMode(ePull),
 	m_eSpeed(eSpeed),
-	m_eState(QAD_GPIO_PinState_Off) {
+	m_eState(QAD_GPIO_PinState_Off),
+	m_eInitState(QA_NotInitialized) {
+
+	//Claim the GPIO Pin. The pin is left untouched if it is held by another driver (details of the conflict can be retrieved from
+	//QAD_ResourceMgr)
+	if (QAD_ResourceMgr::claimPins(m_pGPIO, m_uPin, "GPIO_Output"))
+		return;
+	m_eInitState = QA_Initialized;
 
 	//Initialize the GPIO Pin
 	periphInit();
@@ -70,11 +84,24 @@ QAD_GPIO_Output::QAD_GPIO_Output(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_Ou
 //QAD_GPIO_Output::~QAD_GPIO_Output
 //QAD_GPIO_Output Destructor
 //
-//Destructor used to deinitialize the GPIO pin when the driver class is destroyed
+//Destructor used to deinitialize and release the GPIO pin when the driver class is destroyed
 QAD_GPIO_Output::~QAD_GPIO_Output() {
+	if (!m_eInitState)
+		return;
 
-	//Deinitialize the GPIO Pin
+	//Deinitialize and release the GPIO Pin
   periphDeinit();
+  QAD_ResourceMgr::releasePins(m_pGPIO, m_uPin, "GPIO_Output");
+}
+
+
+//QAD_GPIO_Output::getInitState
+//QAD_GPIO_Output Initialization Method
+//
+//Returns QA_Initialized if the pin was claimed and initialized by the constructor, or QA_NotInitialized if the pin is held by another driver
+//Member of QA_InitState as defined in setup.hpp
+QA_InitState QAD_GPIO_Output::getInitState(void) {
+	return m_eInitState;
 }
 
 
@@ -82,8 +109,12 @@ QAD_GPIO_Output::~QAD_GPIO_Output() {
 //QAD_GPIO_Output Control Method
 //
 //Used to turn the GPIO pin on
+//Does nothing if the pin was not claimed, so that a pin held by another driver is not changed
 void QAD_GPIO_Output::on(void) {
-	HAL_GPIO_WritePin(m_pGPIO, m_uPin, GPIO_PIN_SET);
+	if (!m_eInitState)
+		return;
+
+	m_pGPIO->BSRR = m_uPin;
 	m_eState = QAD_GPIO_PinState_On;
 }
 
@@ -92,8 +123,12 @@ void QAD_GPIO_Output::on(void) {
 //QAD_GPIO_Output Control Method
 //
 //Used to turn the GPIO pin off
+//Does nothing if the pin was not claimed, so that a pin held by another driver is not changed
 void QAD_GPIO_Output::off(void) {
-	HAL_GPIO_WritePin(m_pGPIO, m_uPin, GPIO_PIN_RESET);
+	if (!m_eInitState)
+		return;
+
+	m_pGPIO->BSRR = (uint32_t)m_uPin << 16;
 	m_eState = QAD_GPIO_PinState_Off;
 }
 
@@ -102,16 +137,16 @@ void QAD_GPIO_Output::off(void) {
 //QAD_GPIO_Output Control Method
 //
 //Used to toggle the state of the GPIO pin (will turn off if currently on, or turn on if currently off)
+//The current state is read from the port's output register, so is correct even if the pin has been changed by other means
+//Does nothing if the pin was not claimed, so that a pin held by another driver is not changed
 void QAD_GPIO_Output::toggle(void) {
+	if (!m_eInitState)
+		return;
 
-	switch (m_eState) {
-	  case (QAD_GPIO_PinState_On):
-	  	off();
-	    break;
-	  case (QAD_GPIO_PinState_Off):
-	  	on();
-	    break;
-	}
+	if (m_pGPIO->ODR & m_uPin)
+		off();
+	else
+		on();
 }
 
 
@@ -214,7 +249,11 @@ QAD_GPIO_Speed QAD_GPIO_Output::getSpeed(void) {
 //
 //Used to initialize the GPIO Pin based on the currently selected settings
 //Specifically to be called by device class constructors and methods used for changing settings
+//Does nothing if the pin was not claimed
 void QAD_GPIO_Output::periphInit(void) {
+	if (!m_eInitState)
+		return;
+
 	GPIO_InitTypeDef GPIO_Init = {0};
 	GPIO_Init.Pin    = m_uPin;
 	GPIO_Init.Mode   = m_eOutputMode ? GPIO_MODE_OUTPUT_OD : GPIO_MODE_OUTPUT_PP;
@@ -230,6 +269,8 @@ void QAD_GPIO_Output::periphInit(void) {
 //Used to deinitialize the GPIO pin
 //Specifically to be called by device class destructor and methods used for changing settings
 void QAD_GPIO_Output::periphDeinit(void) {
+	if (!m_eInitState)
+		return;
 
 	HAL_GPIO_DeInit(m_pGPIO, m_uPin);
 }
@@ -258,7 +299,14 @@ void QAD_GPIO_Output::periphDeinit(void) {
 QAD_GPIO_Input::QAD_GPIO_Input(GPIO_TypeDef* pGPIO, uint16_t uPin) :
 		m_pGPIO(pGPIO),
 		m_uPin(uPin),
-		m_ePullMode(QAD_GPIO_PullMode_NoPull) {
+		m_ePullMode(QAD_GPIO_PullMode_NoPull),
+		m_eInitState(QA_NotInitialized) {
+
+	//Claim the GPIO Pin. The pin is left untouched if it is held by another driver (details of the conflict can be retrieved from
+	//QAD_ResourceMgr)
+	if (QAD_ResourceMgr::claimPins(m_pGPIO, m_uPin, "GPIO_Input"))
+		return;
+	m_eInitState = QA_Initialized;
 
 	//Initialize the GPIO pin
 	periphInit();
@@ -275,7 +323,14 @@ QAD_GPIO_Input::QAD_GPIO_Input(GPIO_TypeDef* pGPIO, uint16_t uPin) :
 QAD_GPIO_Input::QAD_GPIO_Input(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_PullMode ePull) :
 		m_pGPIO(pGPIO),
 		m_uPin(uPin),
-		m_ePullMode(ePull) {
+		m_ePullMode(ePull),
+		m_eInitState(QA_NotInitialized) {
+
+	//Claim the GPIO Pin. The pin is left untouched if it is held by another driver (details of the conflict can be retrieved from
+	//QAD_ResourceMgr)
+	if (QAD_ResourceMgr::claimPins(m_pGPIO, m_uPin, "GPIO_Input"))
+		return;
+	m_eInitState = QA_Initialized;
 
 	//Initialize the GPIO pin
 	periphInit();
@@ -284,10 +339,25 @@ QAD_GPIO_Input::QAD_GPIO_Input(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_Pull
 
 //QAD_GPIO_Input::~QAD_GPIO_Input
 //QAD_GPIO_Input Destructor
+//
+//Destructor used to deinitialize and release the GPIO pin when the driver class is destroyed
 QAD_GPIO_Input::~QAD_GPIO_Input() {
+	if (!m_eInitState)
+		return;
 
-	//Deinitialize the GPIO pin
+	//Deinitialize and release the GPIO pin
 	periphDeinit();
+	QAD_ResourceMgr::releasePins(m_pGPIO, m_uPin, "GPIO_Input");
+}
+
+
+//QAD_GPIO_Input::getInitState
+//QAD_GPIO_Input Initialization Method
+//
+//Returns QA_Initialized if the pin was claimed and initialized by the constructor, or QA_NotInitialized if the pin is held by another driver
+//Member of QA_InitState as defined in setup.hpp
+QA_InitState QAD_GPIO_Input::getInitState(void) {
+	return m_eInitState;
 }
 
 
@@ -338,7 +408,10 @@ QAD_GPIO_PullMode QAD_GPIO_Input::getPullMode(void) {
 //
 //Used to initialize the GPIO Pin based on the currently selected settings
 //Specifically to be called by device class constructors and methods used for changing settings
+//Does nothing if the pin was not claimed
 void QAD_GPIO_Input::periphInit(void) {
+	if (!m_eInitState)
+		return;
 
 	GPIO_InitTypeDef GPIO_Init = {0};
 	GPIO_Init.Pin    = m_uPin;
@@ -355,6 +428,8 @@ void QAD_GPIO_Input::periphInit(void) {
 //Used to deinitialize the GPIO Pin
 //Specifically to be called by device class destructor and methods used for changing settings
 void QAD_GPIO_Input::periphDeinit(void) {
+	if (!m_eInitState)
+		return;
 
 	HAL_GPIO_DeInit(m_pGPIO, m_uPin);
 }
@@ -22,6 +22,8 @@
 //Includes
 #include "setup.hpp"
 
+#include "QAD_ResourceMgr.hpp"
+
 
 	//------------------------------------------
 	//------------------------------------------
@@ -79,6 +81,11 @@ enum QAD_GPIO_Speed : uint32_t {
 //QAD_GPIO_Output
 //
 //Driver to allow use of a GPIO pin in output mode (when pin is not connected to a specific internal peripheral)
+//For pins that are known at compile time, QAD_Pin (see QAD_Pin.hpp) gives inline single-store access without any per-pin storage
+//
+//The pin is claimed from QAD_ResourceMgr by the constructor, and is only initialized if the claim is successful. getInitState() should be
+//checked after construction. If the pin is held by another driver, on(), off() and toggle() do nothing, so that the other driver's pin
+//is not changed. Where the cost of this check matters, QAD_Pin can be used instead
 class QAD_GPIO_Output {
 private:
 
@@ -91,6 +98,8 @@ private:
 
 	QAD_GPIO_PinState    m_eState;    //Stores whether the output pin is currently turned on or turned off. A member of the QAD_GPIO_PinState enum defined above
 
+	QA_InitState         m_eInitState;  //Stores whether the pin was claimed and initialized. Member of QA_InitState enum defined in setup.hpp
+
 public:
 
 	//--------------------------
@@ -105,6 +114,8 @@ public:
 	QAD_GPIO_Output(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_OutputMode eMode, QAD_GPIO_PullMode ePull, QAD_GPIO_Speed eSpeed);
 	~QAD_GPIO_Output();
 
+	QA_InitState getInitState(void);
+
 
 	//---------------
 	//Control Methods
@@ -144,6 +155,8 @@ private:
 //QAD_GPIO_Input
 //
 //Driver to allow use of a GPIO pin in input mode (when pin is not connected to a specific internal peripheral)
+//
+//The pin is claimed from QAD_ResourceMgr by the constructor, and is only initialized if the claim is successful (see getInitState())
 class QAD_GPIO_Input {
 protected:
 
@@ -152,6 +165,8 @@ protected:
 
 	QAD_GPIO_PullMode m_ePullMode;  //Stores if either Pull Up or Pull Down resistor is to be used. A member of the QAD_GPIO_PullMode enum defined above
 
+	QA_InitState      m_eInitState; //Stores whether the pin was claimed and initialized. Member of QA_InitState enum defined in setup.hpp
+
 public:
 
 	//-------------------------
@@ -166,6 +181,8 @@ public:
 	QAD_GPIO_Input(GPIO_TypeDef* pGPIO, uint16_t uPin, QAD_GPIO_PullMode ePull);
 	~QAD_GPIO_Input();
 
+	QA_InitState getInitState(void);
+
 	//---------------
 	//Control Methods
 
@@ -0,0 +1,492 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Parallel GPIO Bus Driver                                        */
+/*   Filename: QAD_GPIO_Bus.cpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_GPIO_Bus.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-----------------------------------
+  //-----------------------------------
+  //QAD_GPIO_Bus Initialization Methods
+
+//QAD_GPIO_Bus::init
+//QAD_GPIO_Bus Initialization Method
+//
+//Used to initialize the parallel bus driver
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_GPIO_Bus::init(void) {
+
+	//Return if driver is already initialized
+	if (m_eInitState)
+		return QA_OK;
+
+	//Check that a map has been given, and that every port index used by the map has a GPIO port
+	if (!m_pMap)
+		return QA_Fail;
+
+	bool bPorts = false;
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pMap->getMask(i)) {
+			if (!m_pPorts[i])
+				return QA_Fail;
+			bPorts = true;
+		} else {
+			m_pPorts[i] = NULL;
+		}
+	}
+	if (!bPorts)
+		return QA_Fail;
+
+	//If block writes are required, check that the selected timer is able to trigger DMA2 requests and is currently available
+	if (m_eTimer != QAD_TimerNone) {
+		if ((!QAD_TimerMgr::getAdvanced(m_eTimer)) || (m_uPeriod < 2))
+			return QA_Error_PeriphNotSupported;
+
+		if (QAD_TimerMgr::getState(m_eTimer))
+			return QA_Error_PeriphBusy;
+	}
+
+	//Claim Timer peripheral and GPIO pins (details of any conflict can be retrieved from QAD_ResourceMgr)
+	if (claimResources())
+		return QA_Error_PeriphBusy;
+
+	//Register Timer peripheral as now being in use
+	if (m_eTimer != QAD_TimerNone)
+		QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_GPIOBus);
+
+	//Initialize the GPIO pins, Timer peripheral and DMA streams
+	QA_Result eRes = periphInit();
+
+	//If initialization failed then deregister the Timer peripheral and release resources
+	if (eRes) {
+		if (m_eTimer != QAD_TimerNone)
+			QAD_TimerMgr::deregisterTimer(m_eTimer);
+		releaseResources();
+	}
+
+	//Return initialization result
+	return eRes;
+}
+
+
+//QAD_GPIO_Bus::deinit
+//QAD_GPIO_Bus Initialization Method
+//
+//Used to deinitialize the parallel bus driver
+void QAD_GPIO_Bus::deinit(void) {
+
+	//Return if driver is not currently initialized
+	if (!m_eInitState)
+		return;
+
+	//Deinitialize driver
+	periphDeinit(DeinitFull);
+
+	//Deregister Timer peripheral and release resources
+	if (m_eTimer != QAD_TimerNone)
+		QAD_TimerMgr::deregisterTimer(m_eTimer);
+	releaseResources();
+}
+
+
+  //----------------------------
+  //----------------------------
+  //QAD_GPIO_Bus Control Methods
+
+//QAD_GPIO_Bus::setDirection
+//QAD_GPIO_Bus Control Method
+//
+//Used to switch the bus between input and output. Only the mode register bits of the bus pins are changed, with one write per port
+//When switching to output, the pins drive the value most recently written with write() (or 0 if none has been written)
+//eDirection - New direction of the bus. Member of QAD_GPIO_Bus_Direction
+void QAD_GPIO_Bus::setDirection(QAD_GPIO_Bus_Direction eDirection) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	//Mode registers are shared with other pins of the ports, so are changed with interrupts disabled
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i]) {
+			uint32_t uMODER = m_pPorts[i]->MODER & ~m_uModeMask[i];
+			m_pPorts[i]->MODER = (eDirection) ? (uMODER | m_uModeOut[i]) : uMODER;
+		}
+	}
+
+	__set_PRIMASK(uPrimask);
+	m_eDirection = eDirection;
+}
+
+
+  //------------------------------
+  //------------------------------
+  //QAD_GPIO_Bus Block DMA Methods
+
+//QAD_GPIO_Bus::getBlockWords
+//QAD_GPIO_Bus Block DMA Method
+//
+//Returns the number of 32bit words of buffer needed by encodeBlock() and startBlock() for a block of bus values
+//uCount - Number of bus values in the block
+uint32_t QAD_GPIO_Bus::getBlockWords(uint16_t uCount) {
+	uint32_t uWords = 0;
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i])
+			uWords += uCount;
+	}
+	return uWords;
+}
+
+
+//QAD_GPIO_Bus::encodeBlock
+//QAD_GPIO_Bus Block DMA Method
+//
+//Used to convert a block of bus values into the BSRR register values to be written by startBlock()
+//The buffer holds uCount words for each port with pins of the bus, one port after another in order of port index
+//pValues - Array of uCount bus values
+//pWords  - Buffer of at least getBlockWords(uCount) words, to receive the BSRR register values
+//uCount  - Number of bus values in the block
+void QAD_GPIO_Bus::encodeBlock(const uint32_t* pValues, uint32_t* pWords, uint16_t uCount) {
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i]) {
+			m_pMap->encodeBlock(i, pValues, pWords, uCount);
+			pWords += uCount;
+		}
+	}
+}
+
+
+//QAD_GPIO_Bus::startBlock
+//QAD_GPIO_Bus Block DMA Method
+//
+//Used to start writing a block of bus values to the bus by DMA, one value per timer period
+//The bus must be an output, and the buffer must remain unchanged until getState() returns QA_Inactive. The timer is stopped once every
+//port's DMA stream has completed, leaving the bus at the last value of the block
+//pWords - Buffer of BSRR register values, as prepared by encodeBlock()
+//uCount - Number of bus values in the block (1 to 65535)
+//Returns QA_OK if the block write is started
+//        QA_Fail if the driver is not initialized, a block write is already active, the bus is an input or uCount is 0
+//        QA_Error_PeriphNotSupported if the driver was initialized without a timer for block writes
+QA_Result QAD_GPIO_Bus::startBlock(const uint32_t* pWords, uint16_t uCount) {
+	if ((!m_eInitState) || (m_eState) || (!m_eDirection) || (!uCount))
+		return QA_Fail;
+
+	if (m_eTimer == QAD_TimerNone)
+		return QA_Error_PeriphNotSupported;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	//Reset the counter, so the first capture/compare match is one count after the timer is started
+	pInstance->CNT = 0;
+	pInstance->EGR = TIM_EGR_UG;
+	pInstance->SR  = 0;
+
+	//Start DMA streams and enable DMA requests
+	uint32_t uDIER = 0;
+	uint8_t  uPending = 0;
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i]) {
+			m_pDMA[i]->start((uint32_t)pWords, uCount);
+			pWords += uCount;
+			uDIER  |= (TIM_DIER_CC1DE << i);
+			uPending++;
+		}
+	}
+	m_uPending = uPending;
+	m_eState   = QA_Active;
+
+	pInstance->DIER |= uDIER;
+
+	//Enable timer
+	pInstance->CR1 |= TIM_CR1_CEN;
+
+	return QA_OK;
+}
+
+
+//QAD_GPIO_Bus::stopBlock
+//QAD_GPIO_Bus Block DMA Method
+//
+//Used to abort a block write. The bus is left at the last value written
+void QAD_GPIO_Bus::stopBlock(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	pInstance->CR1  &= ~TIM_CR1_CEN;
+	pInstance->DIER &= ~(TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC3DE | TIM_DIER_CC4DE);
+
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pDMA[i])
+			m_pDMA[i]->stop();
+	}
+
+	m_uPending = 0;
+	m_eState   = QA_Inactive;
+}
+
+
+//QAD_GPIO_Bus::getState
+//QAD_GPIO_Bus Block DMA Method
+//
+//Returns whether a block write is currently active. Member of QA_ActiveState as defined in setup.hpp
+QA_ActiveState QAD_GPIO_Bus::getState(void) {
+	return m_eState;
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAD_GPIO_Bus IRQ Handler Methods
+
+//QAD_GPIO_Bus::handler
+//QAD_GPIO_Bus IRQ Handler Method
+//
+//Called by the DMA driver of each port when its part of a block write has completed. Once all of the ports have completed the timer is
+//stopped and the block write is marked as inactive
+//pData - Pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values)
+void QAD_GPIO_Bus::handler(void* pData) {
+	uint8_t uEvents = *(uint8_t*)pData;
+
+	if ((!m_eState) || (!(uEvents & QAD_DMA_Event_TransferComplete)))
+		return;
+
+	if (--m_uPending)
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+	pInstance->CR1  &= ~TIM_CR1_CEN;
+	pInstance->DIER &= ~(TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC3DE | TIM_DIER_CC4DE);
+
+	m_eState = QA_Inactive;
+}
+
+
+  //-------------------------------------------
+  //-------------------------------------------
+  //QAD_GPIO_Bus Private Initialization Methods
+
+//QAD_GPIO_Bus::periphInit
+//QAD_GPIO_Bus Private Initialization Method
+//
+//Used to initialize, if block writes are required, the timer peripheral clock, the timer peripheral itself and the DMA drivers, followed by
+//the GPIO pins
+//In the case of a failed initialization, a partial deinitialization will be performed
+//Returns QA_OK if successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_GPIO_Bus::periphInit(void) {
+
+	//Timer and DMA streams are only required for block writes
+	if (m_eTimer != QAD_TimerNone) {
+
+		//Enable Timer Clock
+		QAD_TimerMgr::enableClock(m_eTimer);
+
+		//Init Timer
+		m_sHandle.Instance               = QAD_TimerMgr::getInstance(m_eTimer); //Set instance for required Timer peripheral
+		m_sHandle.Init.Prescaler         = m_uPrescaler;                        //Set timer prescaler
+		m_sHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;                  //Set timer counter mode to count up
+		m_sHandle.Init.Period            = m_uPeriod - 1;                       //Set timer period to the time between bus values
+		m_sHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;              //Unused
+		m_sHandle.Init.RepetitionCounter = 0x0;                                 //
+		m_sHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;      //Period is fixed, so preload is not required
+
+		if (HAL_TIM_Base_Init(&m_sHandle) != HAL_OK) {
+			periphDeinit(DeinitPartial);
+			return QA_Fail;
+		}
+
+		//Create DMA drivers for GPIO ports. Each port uses its own capture/compare channel (which is left in frozen mode, so has no output),
+		//matching at a count of 1
+		QAD_DMA_Request eCC1 = (m_eTimer == QAD_Timer1) ? QAD_DMA_Req_TIM1_CH1 : QAD_DMA_Req_TIM8_CH1;
+
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+			if (m_pPorts[i]) {
+				(&m_sHandle.Instance->CCR1)[i] = 1;
+
+				QA_Result eRes = initDMA(m_pDMA[i], (QAD_DMA_Request)(eCC1 + i), (uint32_t)&m_pPorts[i]->BSRR);
+				if (eRes) {
+					periphDeinit(DeinitPartial);
+					return eRes;
+				}
+			}
+		}
+	}
+
+	//Init GPIOs, with outputs initially low. This is done once the timer and DMA drivers have been initialized, so that a partial
+	//deinitialization does not need to deinitialize the GPIOs
+	GPIO_InitTypeDef GPIO_Init = {0};
+	GPIO_Init.Mode  = (m_eDirection) ? (m_eOutputMode ? GPIO_MODE_OUTPUT_OD : GPIO_MODE_OUTPUT_PP) : GPIO_MODE_INPUT;
+	GPIO_Init.Pull  = m_ePull;
+	GPIO_Init.Speed = m_eSpeed;
+
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i]) {
+			uint16_t uMask = m_pMap->getMask(i);
+
+			m_pPorts[i]->BSRR = (uint32_t)uMask << 16;
+			GPIO_Init.Pin     = uMask;
+			HAL_GPIO_Init(m_pPorts[i], &GPIO_Init);
+
+			//Find the mode register bits of the pins, for use by setDirection()
+			m_uModeMask[i] = 0;
+			m_uModeOut[i]  = 0;
+			for (uint8_t j=0; j<QAT_BusMap_PortPins; j++) {
+				if (uMask & (1 << j)) {
+					m_uModeMask[i] |= (GPIO_MODER_MODER0 << (j * 2));
+					m_uModeOut[i]  |= (GPIO_MODER_MODER0_0 << (j * 2));
+				}
+			}
+		}
+	}
+
+	//Set Driver States
+	m_eInitState = QA_Initialized; //Set driver state as initialized
+	m_eState     = QA_Inactive;    //Set driver as currently inactive
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_GPIO_Bus::periphDeinit
+//QAD_GPIO_Bus Private Initialization Method
+//
+//Used to deinitialize the DMA drivers, the timer peripheral clock, the timer peripheral itself and the GPIO pins
+//A partial deinitialization only removes the DMA drivers and disables the timer clock, as these are the only steps taken before a failure
+//eDeinitMode - Set to DeinitPartial to perform a partial deinitialization (only to be used by periphInit() method
+//              in a case where peripheral initialization has failed
+//            - Set to DeinitFull to perform a full deinitialization in a case where the driver is fully initialized
+void QAD_GPIO_Bus::periphDeinit(QAD_GPIO_Bus::DeinitMode eDeinitMode) {
+
+	if (m_eTimer != QAD_TimerNone) {
+
+		//Remove DMA drivers (the DMA drivers deinitialize themselves upon destruction)
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++)
+			m_pDMA[i].reset();
+
+		//Deinitialize Timer peripheral if fully initialized. The timer is never started during initialization, so after a failure it only
+		//needs its clock disabling
+		if (eDeinitMode)
+			HAL_TIM_Base_DeInit(&m_sHandle);
+
+		//Disable Timer Clock
+		QAD_TimerMgr::disableClock(m_eTimer);
+	}
+
+	//Check if a full deinitialization is required, as the GPIOs are only initialized once the rest of periphInit() has succeeded
+	if (eDeinitMode) {
+
+		//Deinitialize GPIOs
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+			if (m_pPorts[i])
+				HAL_GPIO_DeInit(m_pPorts[i], m_pMap->getMask(i));
+		}
+	}
+
+	//Set Driver States
+	m_eState     = QA_Inactive;        //Set driver as currently inactive
+	m_eInitState = QA_NotInitialized;  //Set driver state as not initialized
+}
+
+
+//QAD_GPIO_Bus::claimResources
+//QAD_GPIO_Bus Private Initialization Method
+//
+//Used to claim the Timer peripheral (if block writes are required) and the GPIO pins of all used ports from QAD_ResourceMgr
+//The DMA streams are claimed separately by the QAD_DMA drivers
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_GPIO_Bus::claimResources(void) {
+	if ((m_eTimer != QAD_TimerNone) && (QAD_ResourceMgr::claimTimer(m_eTimer, "GPIO_Bus")))
+		return QA_Error_PeriphBusy;
+
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i]) {
+			if (QAD_ResourceMgr::claimPins(m_pPorts[i], m_pMap->getMask(i), "GPIO_Bus")) {
+
+				//Release any pins already claimed, along with the Timer peripheral
+				for (uint8_t j=0; j<i; j++) {
+					if (m_pPorts[j])
+						QAD_ResourceMgr::releasePins(m_pPorts[j], m_pMap->getMask(j), "GPIO_Bus");
+				}
+				if (m_eTimer != QAD_TimerNone)
+					QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "GPIO_Bus");
+				return QA_Error_PeriphBusy;
+			}
+		}
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_GPIO_Bus::releaseResources
+//QAD_GPIO_Bus Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_GPIO_Bus::releaseResources(void) {
+	for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+		if (m_pPorts[i])
+			QAD_ResourceMgr::releasePins(m_pPorts[i], m_pMap->getMask(i), "GPIO_Bus");
+	}
+	if (m_eTimer != QAD_TimerNone)
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "GPIO_Bus");
+}
+
+
+//QAD_GPIO_Bus::initDMA
+//QAD_GPIO_Bus Private Initialization Method
+//
+//Used to create and initialize a DMA driver transferring a block of 32bit words from memory to a port's BSRR register, with an interrupt
+//once the block has completed
+//pDMA        - Reference to the pointer to receive the DMA driver
+//eRequest    - DMA request to be serviced. Member of QAD_DMA_Request as defined in QAD_DMAMgr.hpp
+//uPeriphAddr - Address of the register to be written
+//Returns QA_OK if successful, or an error from the DMA driver if the DMA stream could not be initialized
+QA_Result QAD_GPIO_Bus::initDMA(std::unique_ptr<QAD_DMA>& pDMA, QAD_DMA_Request eRequest, uint32_t uPeriphAddr) {
+	QAD_DMA_InitStruct sDMAInit;
+	sDMAInit.eRequest     = eRequest;
+	sDMAInit.eStream      = QAD_DMA_StreamNone;
+	sDMAInit.eDirection   = QAD_DMA_MemToPeriph;
+	sDMAInit.eMode        = QAD_DMA_Normal;
+	sDMAInit.ePriority    = QAD_DMA_PriorityVeryHigh;
+	sDMAInit.uPeriphAddr  = uPeriphAddr;
+	sDMAInit.ePeriphWidth = QAD_DMA_Width32;
+	sDMAInit.bPeriphInc   = false;
+	sDMAInit.eMemWidth    = QAD_DMA_Width32;
+	sDMAInit.bMemInc      = true;
+	sDMAInit.eFIFO        = QAD_DMA_FIFODirect;
+	sDMAInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sDMAInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sDMAInit.uEvents      = QAD_DMA_Event_TransferComplete;
+	sDMAInit.uIRQPriority = m_uIRQPriority;
+
+	pDMA = std::make_unique<QAD_DMA>(sDMAInit);
+	QA_Result eRes = pDMA->init();
+	if (eRes) {
+		pDMA.reset();
+		return eRes;
+	}
+
+	pDMA->setHandlerClass(this);
+	return QA_OK;
+}
@@ -0,0 +1,247 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Parallel GPIO Bus Driver                                        */
+/*   Filename: QAD_GPIO_Bus.hpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_GPIO_BUS_HPP_
+#define __QAD_GPIO_BUS_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_GPIO.hpp"
+#include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_DMA.hpp"
+#include "QAT_BusMap.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//----------------------
+//QAD_GPIO_Bus_Direction
+//
+//Used to select whether the pins of a QAD_GPIO_Bus are driven as outputs or read as inputs
+enum QAD_GPIO_Bus_Direction : uint8_t {
+	QAD_GPIO_Bus_Input = 0,   //Pins are inputs
+	QAD_GPIO_Bus_Output       //Pins are outputs
+};
+
+
+//-----------------------
+//QAD_GPIO_Bus_InitStruct
+//
+//This structure is used to be able to create the QAD_GPIO_Bus driver class
+typedef struct {
+
+	const QAT_BusMap*      pMap;          //Pin mapping of the bus (see QAT_BusMap.hpp). Must remain valid for the life of the driver, and is normally
+	                                      //declared as a constexpr object so that its tables are built by the compiler
+	GPIO_TypeDef*          pPorts[QAT_BusMap_MaxPorts];  //GPIO port for each port index used by the map. Set to NULL for unused port indexes
+
+	QAD_GPIO_Bus_Direction eDirection;    //Initial direction of the bus. Member of QAD_GPIO_Bus_Direction
+	QAD_GPIO_OutputMode    eOutputMode;   //Push/pull or open drain mode used while the bus is an output. Member of QAD_GPIO_OutputMode as defined in QAD_GPIO.hpp
+	QAD_GPIO_PullMode      ePull;         //Pull-up/pull-down resistor setting. Member of QAD_GPIO_PullMode as defined in QAD_GPIO.hpp
+	QAD_GPIO_Speed         eSpeed;        //Pin speed. Member of QAD_GPIO_Speed as defined in QAD_GPIO.hpp
+
+	QAD_Timer_Periph       eTimer;        //Timer peripheral used to pace block writes by DMA. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	                                      //Must be Timer 1 or Timer 8, as only these have DMA requests on DMA2, which is able to write to GPIO ports
+	                                      //Set to QAD_TimerNone if block writes are not required
+	uint32_t               uPrescaler;    //Prescaler to be used for the selected timer
+	uint16_t               uPeriod;       //Timer counts per bus value of a block write (at least 2)
+	uint8_t                uIRQPriority;  //IRQ Priority for the DMA stream interrupts used to detect the end of a block write (a value between 0 and 15)
+
+} QAD_GPIO_Bus_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------
+//QAD_GPIO_Bus
+//
+//Driver class used to drive or read an N-bit parallel bus whose bits are connected to any pins of up to QAT_BusMap_MaxPorts GPIO ports
+//
+//The pin mapping is held in a QAT_BusMap, which converts a bus value into one BSRR register value per port using a small table per nibble.
+//write() therefore makes a single store per port, setting and resetting all of the bus pins on that port at once without changing any other
+//pins of the port, and read() needs one read of the input register per port. Pins on different ports change a few bus cycles apart.
+//
+//For bulk transfers, such as sending a block of data to a parallel display or generating a pattern, blocks of values can be written by DMA
+//at a fixed rate of timer clock / ((prescaler+1) * period). Each port is written by its own DMA stream, triggered by its own capture/compare
+//channel of the timer (which is left in frozen mode, so has no output), so there are no interrupts during a block. The values are first
+//converted into BSRR register values with encodeBlock(), in a buffer of getBlockWords() words. Each port's DMA write must finish before the
+//port's next request, so the period should be kept well above the number of ports times the length of a DMA transfer to a GPIO port.
+//
+//The bus can be switched between input and output at any time with setDirection(), such as for a bidirectional data bus
+class QAD_GPIO_Bus : public QAD_IRQHandler_CallbackClass {
+private:
+
+	//Deinitialization mode to be used by periphDeinit() method
+	enum DeinitMode : uint8_t {
+		DeinitPartial = 0,    //Only to be used for partial deinitialization upon initialization failure in periphInit() method
+		DeinitFull            //Used for full driver deinitialization when driver is in a fully initialized state
+	};
+
+	const QAT_BusMap*        m_pMap;                            //Pin mapping of the bus
+	GPIO_TypeDef*            m_pPorts[QAT_BusMap_MaxPorts];     //GPIO port for each port index (NULL for ports without pins of the bus)
+
+	QAD_GPIO_Bus_Direction   m_eDirection;                      //Current direction of the bus
+	QAD_GPIO_OutputMode      m_eOutputMode;                     //Push/pull or open drain mode
+	QAD_GPIO_PullMode        m_ePull;                           //Pull-up/pull-down resistor setting
+	QAD_GPIO_Speed           m_eSpeed;                          //Pin speed
+
+	QAD_Timer_Periph         m_eTimer;                          //Timer peripheral used to pace block writes (QAD_TimerNone if not used)
+	uint32_t                 m_uPrescaler;                      //Prescaler to be used for the selected timer
+	uint16_t                 m_uPeriod;                         //Timer counts per bus value of a block write
+	uint8_t                  m_uIRQPriority;                    //IRQ Priority for the DMA stream interrupts
+
+	TIM_HandleTypeDef        m_sHandle;                         //Handle used by HAL functions to access Timer peripheral (defined in stm32f4xx_hal_tim.h)
+
+	QA_InitState             m_eInitState;                      //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState           m_eState;                          //Stores whether a block write is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	uint32_t                 m_uModeMask[QAT_BusMap_MaxPorts];  //Mode register bits of the bus pins of each port
+	uint32_t                 m_uModeOut[QAT_BusMap_MaxPorts];   //Mode register value selecting output mode for the bus pins of each port
+
+	std::unique_ptr<QAD_DMA> m_pDMA[QAT_BusMap_MaxPorts];       //DMA drivers used to write the BSRR registers of each GPIO port
+	volatile uint8_t         m_uPending;                        //Number of DMA streams yet to complete the current block write
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_GPIO_Bus() = delete;                            //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_GPIO_Bus(QAD_GPIO_Bus_InitStruct& sInit) :      //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_pMap(sInit.pMap),
+		m_eDirection(sInit.eDirection),
+		m_eOutputMode(sInit.eOutputMode),
+		m_ePull(sInit.ePull),
+		m_eSpeed(sInit.eSpeed),
+		m_eTimer(sInit.eTimer),
+		m_uPrescaler(sInit.uPrescaler),
+		m_uPeriod(sInit.uPeriod),
+		m_uIRQPriority(sInit.uIRQPriority),
+		m_sHandle({0}),
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_uModeMask{},
+		m_uModeOut{},
+		m_uPending(0) {
+
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++)
+			m_pPorts[i] = sInit.pPorts[i];
+	}
+
+	~QAD_GPIO_Bus() {  //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
+
+		//Stop any block write currently active
+		if (m_eState)
+			stopBlock();
+
+		//Deinitialize driver if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_GPIO_Bus.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void setDirection(QAD_GPIO_Bus_Direction eDirection);
+
+	//Returns the current direction of the bus. Member of QAD_GPIO_Bus_Direction
+	QAD_GPIO_Bus_Direction getDirection(void) {
+		return m_eDirection;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Used to set the bus to a value, with a single store to the BSRR register of each port
+	//Must not be called while a block write is active
+	//uValue - Bus value. Bits above the width of the bus are ignored
+	void write(uint32_t uValue) {
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+			if (m_pPorts[i])
+				m_pPorts[i]->BSRR = m_pMap->encode(i, uValue);
+		}
+	}
+
+	//Returns the levels on the pins of the bus (from the input registers) as a bus value
+	uint32_t read(void) {
+		uint32_t uValue = 0;
+		for (uint8_t i=0; i<QAT_BusMap_MaxPorts; i++) {
+			if (m_pPorts[i])
+				uValue |= m_pMap->decode(i, (uint16_t)m_pPorts[i]->IDR);
+		}
+		return uValue;
+	}
+
+
+	//-----------------
+	//Block DMA Methods
+
+	uint32_t getBlockWords(uint16_t uCount);
+	void encodeBlock(const uint32_t* pValues, uint32_t* pWords, uint16_t uCount);
+
+	QA_Result startBlock(const uint32_t* pWords, uint16_t uCount);
+	void stopBlock(void);
+
+	QA_ActiveState getState(void);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+private:
+
+	//------------------------------
+	//Private Initialization Methods
+
+	QA_Result periphInit(void);
+	void periphDeinit(DeinitMode eDeinitMode);
+
+	QA_Result claimResources(void);
+	void releaseResources(void);
+
+	QA_Result initDMA(std::unique_ptr<QAD_DMA>& pDMA, QAD_DMA_Request eRequest, uint32_t uPeriphAddr);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_GPIO_BUS_HPP_ */
@@ -0,0 +1,476 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Input Capture Driver                                            */
+/*   Filename: QAD_InputCapture.cpp                                        */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_InputCapture.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //---------------------------------------
+  //---------------------------------------
+  //QAD_InputCapture Initialization Methods
+
+//QAD_InputCapture::init
+//QAD_InputCapture Initialization Method
+//
+//Used to initialize the input capture driver
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_InputCapture::init(void) {
+
+	//Check that the selected timer and channel can be used
+	if (getDMARequest(m_eTimer, m_eChannel) == QAD_DMA_Req_None)
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_eChannel >= QAD_TimerMgr::getChannels(m_eTimer)) || (!m_uSamples))
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_eMode == QAD_InputCaptureMode_PWMInput) &&
+			((m_eChannel > QAD_InputCapture_Channel_2) || (m_ePolarity == QAD_InputCapture_Both) || (m_uSamples > 32767)))
+		return QA_Error_PeriphNotSupported;
+
+	//Check if selected Timer peripheral is currently available
+	if (QAD_TimerMgr::getState(m_eTimer))
+		return QA_Error_PeriphBusy;
+
+	//Claim Timer peripheral and GPIO pin (details of any conflict can be retrieved from QAD_ResourceMgr)
+	if (claimResources())
+		return QA_Error_PeriphBusy;
+
+	//Register Timer peripheral as now being in use
+	QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_InputCapture);
+
+	//Initialize the Timer peripheral and DMA stream
+	QA_Result eRes = periphInit();
+
+	//If initialization failed then deregister the timer peripheral and release resources
+	if (eRes) {
+		QAD_TimerMgr::deregisterTimer(m_eTimer);
+		releaseResources();
+	}
+
+	//Return initialization result
+	return eRes;
+}
+
+
+//QAD_InputCapture::deinit
+//QAD_InputCapture Initialization Method
+//
+//Used to deinitialize the input capture driver
+void QAD_InputCapture::deinit(void) {
+
+	//Return if driver is not currently initialized
+	if (!m_eInitState)
+		return;
+
+	//Deinitialize driver
+	periphDeinit(DeinitFull);
+
+	//Deregister Timer peripheral and release resources
+	QAD_TimerMgr::deregisterTimer(m_eTimer);
+	releaseResources();
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAD_InputCapture Control Methods
+
+//QAD_InputCapture::start
+//QAD_InputCapture Control Method
+//
+//Used to start capturing. Any statistics from a previous run are cleared
+void QAD_InputCapture::start(void) {
+
+	//Check if driver is initialized and is currently not active
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	m_uReadIdx = 0;
+	m_uLast    = 0;
+	m_bPrimed  = false;
+	m_sStats   = {0};
+
+	//Start DMA stream
+	m_pDMA->start((uint32_t)m_pBuffer.get(), m_uLength);
+
+	//Enable capture channels. In PWM input mode both channel 1 and channel 2 are used
+	if (m_eMode == QAD_InputCaptureMode_PWMInput)
+		pInstance->CCER |= (TIM_CCER_CC1E | TIM_CCER_CC2E);
+	else
+		pInstance->CCER |= (TIM_CCER_CC1E << (m_eChannel * 4));
+
+	//Enable capture DMA request, reset counter and enable timer
+	pInstance->DIER |= (TIM_DIER_CC1DE << m_eChannel);
+	pInstance->CNT   = 0;
+	pInstance->CR1  |= TIM_CR1_CEN;
+
+	m_eState = QA_Active;
+}
+
+
+//QAD_InputCapture::stop
+//QAD_InputCapture Control Method
+//
+//Used to stop capturing. Captures already in the buffer can still be processed
+void QAD_InputCapture::stop(void) {
+
+	//Check if driver is initialized and is currently active
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	pInstance->CR1  &= ~TIM_CR1_CEN;
+	pInstance->DIER &= ~(TIM_DIER_CC1DE << m_eChannel);
+	pInstance->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E);
+
+	m_pDMA->stop();
+
+	m_eState = QA_Inactive;
+}
+
+
+//QAD_InputCapture::getState
+//QAD_InputCapture Control Method
+//
+//Returns whether the driver is currently active. Member of QA_ActiveState as defined in setup.hpp
+QA_ActiveState QAD_InputCapture::getState(void) {
+	return m_eState;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAD_InputCapture Data Methods
+
+//QAD_InputCapture::process
+//QAD_InputCapture Data Method
+//
+//Used to calculate statistics for all captures transferred into the buffer since process() was last called
+//The statistics can then be retrieved using getStats(). If no new captures were found the previous statistics are kept
+//In edge mode, periods are the differences between consecutive captures masked to the counter width, so counter wraparound between
+//two captures is handled as long as the period itself is shorter than the counter range
+//Returns the number of periods processed
+uint16_t QAD_InputCapture::process(void) {
+	if (!m_eInitState)
+		return 0;
+
+	//Find the position of the next buffer entry to be written by DMA
+	uint16_t uWriteIdx = m_uLength - m_pDMA->getRemaining();
+	if (uWriteIdx >= m_uLength)
+		uWriteIdx = 0;
+
+	//In PWM input mode each capture is two entries, so ignore a capture part way through being transferred
+	if (m_eMode == QAD_InputCaptureMode_PWMInput)
+		uWriteIdx &= ~1;
+
+	uint16_t uCount     = 0;
+	uint32_t uPeriodMin = 0xFFFFFFFF;
+	uint32_t uPeriodMax = 0;
+	uint64_t uPeriodSum = 0;
+	uint64_t uHighSum   = 0;
+
+	while (m_uReadIdx != uWriteIdx) {
+		uint32_t uPeriod;
+
+		if (m_eMode == QAD_InputCaptureMode_PWMInput) {
+
+			//The DMA burst transfers CCR1 followed by CCR2. The period is captured by the selected channel, and the pulse width by the other
+			uint32_t uCCR1 = m_pBuffer[m_uReadIdx];
+			uint32_t uCCR2 = m_pBuffer[m_uReadIdx + 1];
+			m_uReadIdx += 2;
+
+			uPeriod        = (m_eChannel == QAD_InputCapture_Channel_1) ? uCCR1 : uCCR2;
+			uint32_t uHigh = (m_eChannel == QAD_InputCapture_Channel_1) ? uCCR2 : uCCR1;
+
+			//The first capture is made before the counter has been reset by the input signal, so is discarded
+			if (!m_bPrimed) {
+				m_bPrimed = true;
+				if (m_uReadIdx >= m_uLength)
+					m_uReadIdx = 0;
+				continue;
+			}
+			uHighSum += uHigh;
+
+		} else {
+			uint32_t uCapture = m_pBuffer[m_uReadIdx++];
+
+			//The first capture has no previous capture to be compared against
+			if (!m_bPrimed) {
+				m_bPrimed = true;
+				m_uLast   = uCapture;
+				if (m_uReadIdx >= m_uLength)
+					m_uReadIdx = 0;
+				continue;
+			}
+			uPeriod = (uCapture - m_uLast) & m_uMask;
+			m_uLast = uCapture;
+		}
+
+		if (m_uReadIdx >= m_uLength)
+			m_uReadIdx = 0;
+
+		if (uPeriod < uPeriodMin)
+			uPeriodMin = uPeriod;
+		if (uPeriod > uPeriodMax)
+			uPeriodMax = uPeriod;
+		uPeriodSum += uPeriod;
+		uCount++;
+	}
+
+	//Update statistics
+	if ((uCount) && (uPeriodSum)) {
+		uint64_t uFrequency = ((uint64_t)getTickFrequency() * 1000 * uCount) / uPeriodSum;
+		if (m_ePolarity == QAD_InputCapture_Both)
+			uFrequency /= 2;
+
+		m_sStats.uSamples    = uCount;
+		m_sStats.uPeriodMin  = uPeriodMin;
+		m_sStats.uPeriodMax  = uPeriodMax;
+		m_sStats.uPeriodMean = (uint32_t)(uPeriodSum / uCount);
+		m_sStats.uHighMean   = (uint32_t)(uHighSum / uCount);
+		m_sStats.uFrequency  = (uFrequency > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)uFrequency;
+		m_sStats.uDuty       = (uHighSum >= uPeriodSum) ? 10000 : (uint16_t)((uHighSum * 10000) / uPeriodSum);
+	}
+
+	return uCount;
+}
+
+
+//QAD_InputCapture::getTickFrequency
+//QAD_InputCapture Data Method
+//
+//Returns the frequency in Hz of the timer counter, which is the resolution of captured periods
+uint32_t QAD_InputCapture::getTickFrequency(void) {
+	return QAD_TimerMgr::getClockSpeed(m_eTimer) / (m_uPrescaler + 1);
+}
+
+
+  //-----------------------------------------------
+  //-----------------------------------------------
+  //QAD_InputCapture Private Initialization Methods
+
+//QAD_InputCapture::periphInit
+//QAD_InputCapture Private Initialization Method
+//
+//Used to initialize the GPIO, timer peripheral clock, the timer peripheral and its capture channels, the DMA driver and the capture buffer
+//In the case of a failed initialization, a partial deinitialization will be performed
+//Returns QA_OK if successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_InputCapture::periphInit(void) {
+
+	//Init GPIO
+	GPIO_InitTypeDef GPIO_Init = {0};
+	GPIO_Init.Pin       = m_uPin;                //Set pin number
+	GPIO_Init.Mode      = GPIO_MODE_AF_PP;       //Set pin as Alternate Function in push/pull mode
+	GPIO_Init.Pull      = GPIO_NOPULL;           //Disable pull-up and pull-down resistors
+	GPIO_Init.Speed     = GPIO_SPEED_FREQ_HIGH;  //Unused due to pin being used as peripheral input
+	GPIO_Init.Alternate = m_uAF;                 //Set alternate function to suit required timer peripheral
+	HAL_GPIO_Init(m_pGPIO, &GPIO_Init);
+
+	//Enable Timer Clock
+	QAD_TimerMgr::enableClock(m_eTimer);
+
+	//Initialize Timer as a free-running counter over its full range
+	m_uMask = (QAD_TimerMgr::getType(m_eTimer) == QAD_Timer_32bit) ? 0xFFFFFFFF : 0xFFFF;
+
+	m_sHandle.Instance               = QAD_TimerMgr::getInstance(m_eTimer); //Set instance for required Timer peripheral
+	m_sHandle.Init.Prescaler         = m_uPrescaler;                        //Set timer prescaler
+	m_sHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;                  //Set timer counter mode to count up
+	m_sHandle.Init.Period            = m_uMask;                             //Set timer period to the full counter range
+	m_sHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;              //Unused
+	m_sHandle.Init.RepetitionCounter = 0x0;                                 //
+	m_sHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;      //Disable preload of the timer's auto-reload register
+
+	if (HAL_TIM_IC_Init(&m_sHandle) != HAL_OK) {
+		periphDeinit(DeinitPartial);
+		return QA_Fail;
+	}
+
+	//Configure capture channels
+	const uint32_t uHALChannel[4] = {TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4};
+	const uint32_t uHALPolarity[3] = {TIM_ICPOLARITY_RISING, TIM_ICPOLARITY_FALLING, TIM_ICPOLARITY_BOTHEDGE};
+
+	TIM_IC_InitTypeDef IC_Init = {0};
+	IC_Init.ICPolarity  = uHALPolarity[m_ePolarity];                        //Set capture edge
+	IC_Init.ICSelection = TIM_ICSELECTION_DIRECTTI;                         //Capture from the channel's own input
+	IC_Init.ICPrescaler = TIM_ICPSC_DIV1;                                   //Capture performed on every edge
+	IC_Init.ICFilter    = m_uFilter;                                        //Set input filter
+
+	if (HAL_TIM_IC_ConfigChannel(&m_sHandle, &IC_Init, uHALChannel[m_eChannel]) != HAL_OK) {
+		periphDeinit(DeinitPartial);
+		return QA_Fail;
+	}
+
+	if (m_eMode == QAD_InputCaptureMode_PWMInput) {
+
+		//Paired channel captures the opposite edge from the same input pin, giving the pulse width
+		QAD_InputCapture_Channel ePaired = (m_eChannel == QAD_InputCapture_Channel_1) ? QAD_InputCapture_Channel_2 : QAD_InputCapture_Channel_1;
+		IC_Init.ICPolarity  = (m_ePolarity == QAD_InputCapture_Rising) ? TIM_ICPOLARITY_FALLING : TIM_ICPOLARITY_RISING;
+		IC_Init.ICSelection = TIM_ICSELECTION_INDIRECTTI;
+		if (HAL_TIM_IC_ConfigChannel(&m_sHandle, &IC_Init, uHALChannel[ePaired]) != HAL_OK) {
+			periphDeinit(DeinitPartial);
+			return QA_Fail;
+		}
+
+		//Reset counter on each period edge
+		TIM_SlaveConfigTypeDef Slave_Init = {0};
+		Slave_Init.SlaveMode        = TIM_SLAVEMODE_RESET;
+		Slave_Init.InputTrigger     = (m_eChannel == QAD_InputCapture_Channel_1) ? TIM_TS_TI1FP1 : TIM_TS_TI2FP2;
+		Slave_Init.TriggerPolarity  = uHALPolarity[m_ePolarity];
+		Slave_Init.TriggerPrescaler = TIM_TRIGGERPRESCALER_DIV1;
+		Slave_Init.TriggerFilter    = m_uFilter;
+		if (HAL_TIM_SlaveConfigSynchro(&m_sHandle, &Slave_Init) != HAL_OK) {
+			periphDeinit(DeinitPartial);
+			return QA_Fail;
+		}
+
+		//Set up DMA burst so that each period capture transfers both CCR1 and CCR2 through the DMAR register
+		m_sHandle.Instance->DCR = TIM_DMABASE_CCR1 | TIM_DMABURSTLENGTH_2TRANSFERS;
+	}
+
+	//Create capture buffer
+	m_uLength = (m_eMode == QAD_InputCaptureMode_PWMInput) ? (m_uSamples * 2) : m_uSamples;
+	m_pBuffer = std::make_unique<uint32_t[]>(m_uLength);
+
+	//Create and initialize DMA driver
+	QAD_DMA_InitStruct sDMAInit;
+	sDMAInit.eRequest     = getDMARequest(m_eTimer, m_eChannel);
+	sDMAInit.eStream      = m_eDMAStream;
+	sDMAInit.eDirection   = QAD_DMA_PeriphToMem;
+	sDMAInit.eMode        = QAD_DMA_Circular;
+	sDMAInit.ePriority    = QAD_DMA_PriorityHigh;
+	sDMAInit.uPeriphAddr  = (m_eMode == QAD_InputCaptureMode_PWMInput) ? (uint32_t)&m_sHandle.Instance->DMAR :
+	                                                                     (uint32_t)(&m_sHandle.Instance->CCR1 + m_eChannel);
+	sDMAInit.ePeriphWidth = QAD_DMA_Width32;
+	sDMAInit.bPeriphInc   = false;
+	sDMAInit.eMemWidth    = QAD_DMA_Width32;
+	sDMAInit.bMemInc      = true;
+	sDMAInit.eFIFO        = QAD_DMA_FIFODirect;
+	sDMAInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sDMAInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sDMAInit.uEvents      = 0;
+	sDMAInit.uIRQPriority = 0;
+
+	m_pDMA = std::make_unique<QAD_DMA>(sDMAInit);
+	QA_Result eRes = m_pDMA->init();
+	if (eRes) {
+		periphDeinit(DeinitPartial);
+		return eRes;
+	}
+
+	//Set Driver States
+	m_eInitState = QA_Initialized; //Set driver state as initialized
+	m_eState     = QA_Inactive;    //Set driver as currently inactive
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_InputCapture::periphDeinit
+//QAD_InputCapture Private Initialization Method
+//
+//Used to deinitialize the DMA driver, the capture buffer, the timer peripheral clock, the peripheral itself and the GPIO
+//eDeinitMode - Set to DeinitPartial to perform a partial deinitialization (only to be used by periphInit() method
+//              in a case where peripheral initialization has failed
+//            - Set to DeinitFull to perform a full deinitialization in a case where the driver is fully initialized
+void QAD_InputCapture::periphDeinit(QAD_InputCapture::DeinitMode eDeinitMode) {
+
+	//Remove DMA driver and buffer (the DMA driver deinitializes itself upon destruction)
+	m_pDMA.reset();
+	m_pBuffer.reset();
+
+	//Deinitialize Timer peripheral. In the case of a partial deinitialization the timer may have been partly configured before the failure
+	HAL_TIM_IC_DeInit(&m_sHandle);
+
+	//Disable Timer Clock
+	QAD_TimerMgr::disableClock(m_eTimer);
+
+	//Deinit GPIO
+	HAL_GPIO_DeInit(m_pGPIO, m_uPin);
+
+	//Set States
+	m_eState     = QA_Inactive;        //Set driver as currently inactive
+	m_eInitState = QA_NotInitialized;  //Set driver state as not initialized
+}
+
+
+//QAD_InputCapture::claimResources
+//QAD_InputCapture Private Initialization Method
+//
+//Used to claim the Timer peripheral and the GPIO pin from QAD_ResourceMgr
+//The DMA stream is claimed separately by the QAD_DMA driver
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_InputCapture::claimResources(void) {
+	if (QAD_ResourceMgr::claimTimer(m_eTimer, "InputCapture"))
+		return QA_Error_PeriphBusy;
+
+	if (QAD_ResourceMgr::claimPins(m_pGPIO, m_uPin, "InputCapture")) {
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "InputCapture");
+		return QA_Error_PeriphBusy;
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_InputCapture::releaseResources
+//QAD_InputCapture Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_InputCapture::releaseResources(void) {
+	QAD_ResourceMgr::releasePins(m_pGPIO, m_uPin, "InputCapture");
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "InputCapture");
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAD_InputCapture Tool Methods
+
+//QAD_InputCapture::getDMARequest
+//QAD_InputCapture Tool Method
+//
+//Used to find the DMA request for a capture/compare channel of a Timer peripheral
+//eTimer   - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+//eChannel - Timer channel. Member of QAD_InputCapture_Channel
+//Returns the DMA request (member of QAD_DMA_Request as defined in QAD_DMAMgr.hpp), or QAD_DMA_Req_None if the channel has no DMA request
+QAD_DMA_Request QAD_InputCapture::getDMARequest(QAD_Timer_Periph eTimer, QAD_InputCapture_Channel eChannel) {
+	switch (eTimer) {
+	  case (QAD_Timer1):
+	  	return (QAD_DMA_Request)(QAD_DMA_Req_TIM1_CH1 + eChannel);
+	  case (QAD_Timer2):
+	  	return (QAD_DMA_Request)(QAD_DMA_Req_TIM2_CH1 + eChannel);
+	  case (QAD_Timer3):
+	  	return (QAD_DMA_Request)(QAD_DMA_Req_TIM3_CH1 + eChannel);
+	  case (QAD_Timer4):
+	  	return (eChannel == QAD_InputCapture_Channel_4) ? QAD_DMA_Req_None : (QAD_DMA_Request)(QAD_DMA_Req_TIM4_CH1 + eChannel);
+	  case (QAD_Timer5):
+	  	return (QAD_DMA_Request)(QAD_DMA_Req_TIM5_CH1 + eChannel);
+	  case (QAD_Timer8):
+	  	return (QAD_DMA_Request)(QAD_DMA_Req_TIM8_CH1 + eChannel);
+	  default:
+	  	return QAD_DMA_Req_None;
+	}
+}
@@ -0,0 +1,262 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Input Capture Driver                                            */
+/*   Filename: QAD_InputCapture.hpp                                        */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_INPUTCAPTURE_HPP_
+#define __QAD_INPUTCAPTURE_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_DMA.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------------------
+//QAD_InputCapture_Channel
+//
+//Enum used to select the timer channel to be used for input capture
+enum QAD_InputCapture_Channel : uint8_t {
+	QAD_InputCapture_Channel_1 = 0,
+	QAD_InputCapture_Channel_2,
+	QAD_InputCapture_Channel_3,
+	QAD_InputCapture_Channel_4
+};
+
+
+//---------------------
+//QAD_InputCaptureMode
+//
+//Used to select how the input signal is to be measured
+enum QAD_InputCaptureMode : uint8_t {
+	QAD_InputCaptureMode_Edge = 0,  //Edge mode - the free-running counter is captured on each selected edge, and periods are calculated from the
+	                                //differences between consecutive captures. Any channel can be used
+
+	QAD_InputCaptureMode_PWMInput   //PWM input mode - the counter is reset on each period edge, with the selected channel capturing the period and
+	                                //the paired channel capturing the pulse width from the same input pin. Only available on channels 1 and 2
+};
+
+
+//-------------------------
+//QAD_InputCapture_Polarity
+//
+//Used to select which edges of the input signal are to be captured
+//In PWM input mode this selects the edge at which each period starts, and the pulse width is measured to the opposite edge
+enum QAD_InputCapture_Polarity : uint8_t {
+	QAD_InputCapture_Rising = 0,    //Rising edges
+	QAD_InputCapture_Falling,       //Falling edges
+	QAD_InputCapture_Both           //Both edges (edge mode only). Periods calculated are half-periods of the input signal
+};
+
+
+//----------------------
+//QAD_InputCapture_Stats
+//
+//Statistics calculated from a single batch of captured periods by QAD_InputCapture::process()
+typedef struct {
+
+	uint16_t uSamples;      //Number of periods in the batch
+	uint32_t uPeriodMin;    //Shortest period in timer ticks
+	uint32_t uPeriodMax;    //Longest period in timer ticks
+	uint32_t uPeriodMean;   //Mean period in timer ticks
+	uint32_t uHighMean;     //Mean pulse width in timer ticks (PWM input mode only)
+	uint32_t uFrequency;    //Mean frequency of the input signal in millihertz
+	uint16_t uDuty;         //Mean duty cycle in hundredths of a percent (0 to 10000, PWM input mode only)
+
+} QAD_InputCapture_Stats;
+
+
+//---------------------------
+//QAD_InputCapture_InitStruct
+//
+//This structure is used to be able to create the QAD_InputCapture driver class
+typedef struct {
+
+	QAD_Timer_Periph          eTimer;      //Timer peripheral to be used. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	                                       //Must be a timer with DMA requests for the selected channel (Timers 1 to 5 and 8, excluding Timer 4 Channel 4)
+	QAD_InputCapture_Channel  eChannel;    //Timer channel to be used. Member of QAD_InputCapture_Channel
+	QAD_InputCaptureMode      eMode;       //Measurement mode. Member of QAD_InputCaptureMode
+	QAD_InputCapture_Polarity ePolarity;   //Edges to be captured. Member of QAD_InputCapture_Polarity
+
+	GPIO_TypeDef*             pGPIO;       //GPIO port to be used for the input signal
+	uint16_t                  uPin;        //Pin number to be used for the input signal
+	uint8_t                   uAF;         //Alternate function used to connect the GPIO pin to the timer peripheral
+
+	uint32_t                  uPrescaler;  //Prescaler to be used for the selected timer. Sets the capture resolution, and must be high enough that the
+	                                       //longest expected period fits within the counter (65536 ticks for 16bit timers)
+	uint8_t                   uFilter;     //Input filter (a value between 0 and 15, with 0 disabling the filter)
+
+	uint16_t                  uSamples;    //Number of captures held by the DMA buffer. process() needs to be called at least once in the time taken to fill
+	                                       //the buffer. In PWM input mode this can be at most 32767, as each capture takes two buffer entries
+	QAD_DMA_Stream            eDMAStream;  //DMA stream to be used. Set to QAD_DMA_StreamNone to have a suitable stream found by QAD_DMAMgr
+
+} QAD_InputCapture_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//----------------
+//QAD_InputCapture
+//
+//Driver class for measuring frequency, period and pulse width of an input signal using timer input capture
+//
+//Capture values are transferred by DMA into a circular buffer, so no interrupt is triggered per edge. process() is then used to calculate
+//statistics for all captures received since it was last called. In PWM input mode a DMA burst transfers both capture registers for each period,
+//so the period and pulse width of each sample always belong to the same cycle of the input signal
+class QAD_InputCapture {
+private:
+
+	//Deinitialization mode to be used by periphDeinit() method
+	enum DeinitMode : uint8_t {
+		DeinitPartial = 0,    //Only to be used for partial deinitialization upon initialization failure in periphInit() method
+		DeinitFull            //Used for full driver deinitialization when driver is in a fully initialized state
+	};
+
+	QAD_Timer_Periph           m_eTimer;        //Timer peripheral to be used
+	QAD_InputCapture_Channel   m_eChannel;      //Timer channel to be used
+	QAD_InputCaptureMode       m_eMode;         //Measurement mode
+	QAD_InputCapture_Polarity  m_ePolarity;     //Edges to be captured
+
+	GPIO_TypeDef*              m_pGPIO;         //GPIO port to be used for the input signal
+	uint16_t                   m_uPin;          //Pin number to be used for the input signal
+	uint8_t                    m_uAF;           //Alternate function used to connect the GPIO pin to the timer peripheral
+
+	uint32_t                   m_uPrescaler;    //Prescaler to be used for the selected timer
+	uint8_t                    m_uFilter;       //Input filter
+
+	TIM_HandleTypeDef          m_sHandle;       //Handle used by HAL functions to access Timer peripheral (defined in stm32f4xx_hal_tim.h)
+
+	QA_InitState               m_eInitState;    //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState             m_eState;        //Stores whether the driver is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAD_DMA_Stream             m_eDMAStream;    //DMA stream to be used
+	std::unique_ptr<QAD_DMA>   m_pDMA;          //DMA driver used to transfer capture values
+
+	uint16_t                   m_uSamples;      //Number of captures held by the buffer
+	uint16_t                   m_uLength;       //Length of the buffer in 32bit words
+	std::unique_ptr<uint32_t[]> m_pBuffer;      //Circular buffer written by DMA
+
+	uint32_t                   m_uMask;         //Counter mask (0xFFFF for 16bit timers, 0xFFFFFFFF for 32bit timers)
+	uint16_t                   m_uReadIdx;      //Buffer index of the next capture to be processed
+	uint32_t                   m_uLast;         //Previous capture value (edge mode)
+	bool                       m_bPrimed;       //Set once the first capture has been received, as it has no previous capture to be compared against
+
+	QAD_InputCapture_Stats     m_sStats;        //Statistics from the most recent batch
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_InputCapture() = delete;                            //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_InputCapture(QAD_InputCapture_InitStruct& sInit) :  //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eTimer(sInit.eTimer),
+		m_eChannel(sInit.eChannel),
+		m_eMode(sInit.eMode),
+		m_ePolarity(sInit.ePolarity),
+		m_pGPIO(sInit.pGPIO),
+		m_uPin(sInit.uPin),
+		m_uAF(sInit.uAF),
+		m_uPrescaler(sInit.uPrescaler),
+		m_uFilter(sInit.uFilter),
+		m_sHandle({0}),
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_eDMAStream(sInit.eDMAStream),
+		m_uSamples(sInit.uSamples),
+		m_uLength(0),
+		m_uMask(0xFFFF),
+		m_uReadIdx(0),
+		m_uLast(0),
+		m_bPrimed(false),
+		m_sStats({0}) {}
+
+	~QAD_InputCapture() {  //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
+
+		//Stop input capture driver if currently active
+		if (m_eState)
+			stop();
+
+		//Deinitialize input capture driver if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_InputCapture.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void start(void);
+	void stop(void);
+
+	QA_ActiveState getState(void);
+
+
+	//------------
+	//Data Methods
+
+	uint16_t process(void);
+
+	//Returns the statistics calculated by the most recent call to process() that found new captures
+	const QAD_InputCapture_Stats& getStats(void) const {
+		return m_sStats;
+	}
+
+	uint32_t getTickFrequency(void);
+
+private:
+
+	//------------------------------
+	//Private Initialization Methods
+
+	QA_Result periphInit(void);
+	void periphDeinit(DeinitMode eDeinitMode);
+
+	QA_Result claimResources(void);
+	void releaseResources(void);
+
+
+	//------------
+	//Tool Methods
+
+	static QAD_DMA_Request getDMARequest(QAD_Timer_Periph eTimer, QAD_InputCapture_Channel eChannel);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_INPUTCAPTURE_HPP_ */
@@ -35,10 +35,31 @@
 //Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
 QA_Result QAD_PWM::init(void) {
 
+	//Check that complementary outputs, dead-time and break input are only used with advanced-control timers,
+	//and that center-aligned mode is only used with timers that support it
+	bool bBridge = (m_uDeadTime) || (m_eBreak);
+	for (uint8_t i=0; i<QAD_TimerMgr::getChannels(m_eTimer); i++) {
+		if ((m_sChannels[i].eActive) && (m_sChannels[i].uPin_N)) {
+			if (i == QAD_PWM_Channel_4)
+				return QA_Error_PeriphNotSupported;
+			bBridge = true;
+		}
+	}
+
+	if ((bBridge) && (!QAD_TimerMgr::getAdvanced(m_eTimer)))
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_eAlign == QAD_PWM_AlignCenter) && (QAD_TimerMgr::getChannels(m_eTimer) < QAD_PWM_CHANNEL_COUNT))
+		return QA_Error_PeriphNotSupported;
+
 	//Check if selected Timer peripheral is currently available
   if (QAD_TimerMgr::getState(m_eTimer))
   	return QA_Error_PeriphBusy;
 
+  //Claim Timer peripheral and GPIO pins (details of any conflict can be retrieved from QAD_ResourceMgr)
+  if (claimResources())
+  	return QA_Error_PeriphBusy;
+
   //Register Timer peripheral as now being in use
   QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_PWM);
 
@@ -46,8 +67,10 @@ QA_Result QAD_PWM::init(void) {
   QA_Result eRes = periphInit();
 
   //If initialization failed then deregister the Timer peripheral
-  if (eRes)
+  if (eRes) {
   	QAD_TimerMgr::deregisterTimer(m_eTimer);
+  	releaseResources();
+  }
 
   //Return initialization result
   return eRes;
@@ -69,6 +92,7 @@ void QAD_PWM::deinit(void) {
 
   //Deregister Timer peripheral
   QAD_TimerMgr::deregisterTimer(m_eTimer);
+  releaseResources();
 }
 
 
@@ -85,9 +109,13 @@ void QAD_PWM::start(void) {
 	//Iterate through the number of channels supported by the specific timer peripheral
 	for (uint8_t i=0; i<QAD_TimerMgr::getChannels(m_eTimer); i++) {
 
-		//If channel is set to active then start PWM on that channel
-		if (m_sChannels[i].eActive)
+		//If channel is set to active then start PWM on that channel, along with its complementary output if used
+		if (m_sChannels[i].eActive) {
 			HAL_TIM_PWM_Start(&m_sHandle, m_uChannelSelect[i]);
+
+			if (m_sChannels[i].uPin_N)
+				HAL_TIMEx_PWMN_Start(&m_sHandle, m_uChannelSelect[i]);
+		}
 	}
 
 	//Set PWM driver state to active
@@ -104,9 +132,13 @@ void QAD_PWM::stop(void) {
 	//Iterate through the number of channels supported by the specific timer peripheral
 	for (uint8_t i=0; i<QAD_TimerMgr::getChannels(m_eTimer); i++) {
 
-		//If channel is currently active then stop PWM on that channel
-		if (m_sChannels[i].eActive)
+		//If channel is currently active then stop PWM on that channel, along with its complementary output if used
+		if (m_sChannels[i].eActive) {
 			HAL_TIM_PWM_Stop(&m_sHandle, m_uChannelSelect[i]);
+
+			if (m_sChannels[i].uPin_N)
+				HAL_TIMEx_PWMN_Stop(&m_sHandle, m_uChannelSelect[i]);
+		}
 	}
 
 	//Set PWM driver state to inactive
@@ -122,12 +154,249 @@ void QAD_PWM::stop(void) {
 //uVal     - The PWM value to set. This value should not be larger than the timer period set within the driver initialization structure
 void QAD_PWM::setPWMVal(QAD_PWM_Channel eChannel, uint16_t uVal) {
 
-	//Return if the selected channel is higher than the number of channels supported by the selected timer peripheral
-  if (eChannel >= QAD_TimerMgr::getChannels(m_eTimer))
+	//Return if the driver is not initialized, or the selected channel is higher than the number of channels supported by the selected timer peripheral
+  if (eChannel >= m_uChannelCount)
   	return;
 
   //Set new PWM value to compare register for selected channel of timer peripheral
-  __HAL_TIM_SET_COMPARE(&m_sHandle, m_uChannelSelect[eChannel], uVal);
+  m_pCCR[eChannel] = uVal;
+}
+
+
+//QAD_PWM::setPWMVals
+//QAD_PWM Control Method
+//
+//Sets the current PWM values for all active channels, so that all of the new values take effect at the same update event
+//Update events are held off while the compare registers are written, so that an update event part way through cannot cause
+//some channels to change a period before the others
+//pVals - Array of QAD_PWM_CHANNEL_COUNT PWM values, indexed by QAD_PWM_Channel. Values for inactive channels, or channels not supported by the
+//        selected timer peripheral, are ignored
+void QAD_PWM::setPWMVals(const uint16_t* pVals) {
+	if (!m_eInitState)
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	pInstance->CR1 |= TIM_CR1_UDIS;
+	for (uint8_t i=0; i<m_uChannelCount; i++) {
+		if (m_sChannels[i].eActive)
+			m_pCCR[i] = pVals[i];
+	}
+	pInstance->CR1 &= ~TIM_CR1_UDIS;
+}
+
+
+//QAD_PWM::beginUpdate
+//QAD_PWM Control Method
+//
+//Used to hold off update events, so that new compare values set by setPWMVal() are kept in the preload registers
+//This allows several channels to be updated, with all of the new values taking effect at the same update event once endUpdate() is called
+//Note that while update events are held off, DMA streaming is also paused, and the period of the timer cannot be changed
+void QAD_PWM::beginUpdate(void) {
+	if (!m_eInitState)
+		return;
+
+	m_sHandle.Instance->CR1 |= TIM_CR1_UDIS;
+}
+
+
+//QAD_PWM::endUpdate
+//QAD_PWM Control Method
+//
+//Used to allow update events again after a call to beginUpdate(). Compare values set since beginUpdate() was called take effect at the next update event
+void QAD_PWM::endUpdate(void) {
+	if (!m_eInitState)
+		return;
+
+	m_sHandle.Instance->CR1 &= ~TIM_CR1_UDIS;
+}
+
+
+  //---------------------
+  //---------------------
+  //QAD_PWM Break Methods
+
+//QAD_PWM::getBreak
+//QAD_PWM Break Method
+//
+//Used to check whether the outputs have been shut down by the break input
+//Returns true if a break has occurred and has not yet been cleared by clearBreak(), or false otherwise
+bool QAD_PWM::getBreak(void) {
+	if ((!m_eInitState) || (!m_eBreak))
+		return false;
+
+	if (m_sHandle.Instance->SR & TIM_SR_BIF)
+		return true;
+
+	return ((m_eState) && (!(m_sHandle.Instance->BDTR & TIM_BDTR_MOE)));
+}
+
+
+//QAD_PWM::clearBreak
+//QAD_PWM Break Method
+//
+//Used to re-enable the outputs after a break has occurred
+//The break input must no longer be active, as otherwise the outputs would immediately be shut down again
+//Returns QA_OK if the break was cleared, or QA_Fail if the break input is not used or is still active
+QA_Result QAD_PWM::clearBreak(void) {
+	if ((!m_eInitState) || (!m_eBreak))
+		return QA_Fail;
+
+	//Check whether break input is still active
+	GPIO_PinState eLevel = HAL_GPIO_ReadPin(m_pBreakGPIO, m_uBreakPin);
+	if (eLevel == ((m_eBreak == QAD_PWM_BreakActiveLow) ? GPIO_PIN_RESET : GPIO_PIN_SET))
+		return QA_Fail;
+
+	//Clear break flag and re-enable outputs if the driver is active
+	m_sHandle.Instance->SR = ~TIM_SR_BIF;
+	if (m_eState)
+		m_sHandle.Instance->BDTR |= TIM_BDTR_MOE;
+
+	return QA_OK;
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAD_PWM Streaming Methods
+
+//QAD_PWM::startStream
+//QAD_PWM Streaming Method
+//
+//Used to start streaming a buffer of compare values to the streamed channels, for use with timers with a 16bit counter
+//A new value is transferred on each update event, and takes effect from the following PWM period. When the stream is not looping,
+//the final value remains in the compare register once the stream has finished, so the buffer would normally end with a value
+//giving the required idle output level (such as 0 for a low output)
+//The buffer must remain valid until the stream has finished (see isStreaming()) or has been stopped
+//pData   - Pointer to the buffer of compare values. When multiple channels are streamed, the buffer contains one value per streamed channel
+//          for each PWM period, in channel order
+//          If bStreamPeriod is set, the values for each PWM period are instead the auto-reload value (period - 1), the repetition counter
+//          (only used by Timers 1 and 8, otherwise ignored), and then the compare values of every channel from channel 1 to the last
+//          streamed channel. Each auto-reload value takes effect at the same time as the compare values that follow it
+//uLength - Number of values in the buffer. Must be a multiple of the number of values per PWM period
+//Returns QA_OK if the stream is started
+//        QA_Fail if the driver is not initialized, or uLength is not valid
+//        QA_Error_PeriphNotSupported if streaming is not enabled, or the timer has a 32bit counter
+QA_Result QAD_PWM::startStream(const uint16_t* pData, uint16_t uLength) {
+	if (QAD_TimerMgr::getType(m_eTimer) != QAD_Timer_16bit)
+		return QA_Error_PeriphNotSupported;
+
+	return imp_startStream((uint32_t)pData, uLength);
+}
+
+
+//QAD_PWM::startStream
+//QAD_PWM Streaming Method
+//
+//Used to start streaming a buffer of compare values to the streamed channels, for use with timers with a 32bit counter (Timers 2 and 5)
+//See above version of startStream() for details
+QA_Result QAD_PWM::startStream(const uint32_t* pData, uint16_t uLength) {
+	if (QAD_TimerMgr::getType(m_eTimer) != QAD_Timer_32bit)
+		return QA_Error_PeriphNotSupported;
+
+	return imp_startStream((uint32_t)pData, uLength);
+}
+
+
+//QAD_PWM::stopStream
+//QAD_PWM Streaming Method
+//
+//Used to stop the current stream. The compare registers keep the last values transferred
+void QAD_PWM::stopStream(void) {
+	if ((!m_eInitState) || (!m_pDMA))
+		return;
+
+	m_sHandle.Instance->DIER &= ~TIM_DIER_UDE;
+	m_pDMA->stop();
+}
+
+
+//QAD_PWM::isStreaming
+//QAD_PWM Streaming Method
+//
+//Returns true if a stream is currently in progress, or false if the stream has finished or been stopped
+bool QAD_PWM::isStreaming(void) {
+	if ((!m_eInitState) || (!m_pDMA))
+		return false;
+
+	if (!m_pDMA->getState())
+		return false;
+
+	return (m_bStreamLoop || m_pDMA->getRemaining());
+}
+
+
+//QAD_PWM::getStreamRemaining
+//QAD_PWM Streaming Method
+//
+//Returns the number of values in the stream buffer that are yet to be transferred in the current pass through the buffer
+//The value at the start of the buffer is transferred when this equals the buffer length. As each value is transferred one update event
+//before it takes effect, the PWM period currently being output is the one two PWM periods behind the next value to be transferred
+uint16_t QAD_PWM::getStreamRemaining(void) {
+	if ((!m_eInitState) || (!m_pDMA))
+		return 0;
+
+	return m_pDMA->getRemaining();
+}
+
+
+//QAD_PWM::setStreamHandlerFunction
+//QAD_PWM Streaming Method
+//
+//Used to set a callback function to be called when one of the stream interrupt events selected by uStreamEvents occurs
+//This allows a looping stream buffer to be refilled while it is in use, such as refilling the first half of the buffer on the half transfer event
+//The callback is passed a pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values)
+//pHandler - The callback function. QAD_IRQHandler_CallbackFunction as defined in setup.hpp
+void QAD_PWM::setStreamHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler) {
+	if (m_pDMA)
+		m_pDMA->setHandlerFunction(pHandler);
+}
+
+
+//QAD_PWM::setStreamHandlerClass
+//QAD_PWM Streaming Method
+//
+//Used to set a callback class to be called when one of the stream interrupt events selected by uStreamEvents occurs
+//See setStreamHandlerFunction() for details
+//pHandler - Pointer to a class inheriting QAD_IRQHandler_CallbackClass as defined in setup.hpp
+void QAD_PWM::setStreamHandlerClass(QAD_IRQHandler_CallbackClass* pHandler) {
+	if (m_pDMA)
+		m_pDMA->setHandlerClass(pHandler);
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAD_PWM Private Streaming Methods
+
+//QAD_PWM::imp_startStream
+//QAD_PWM Private Streaming Method
+//
+//Used by startStream() methods to start the DMA transfer and enable the timer's update DMA request
+//uAddr   - Address of the buffer of compare values
+//uLength - Number of values in the buffer
+//Returns QA_OK if the stream is started, or an error if not (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_PWM::imp_startStream(uint32_t uAddr, uint16_t uLength) {
+	if (!m_eInitState)
+		return QA_Fail;
+
+	if (!m_pDMA)
+		return QA_Error_PeriphNotSupported;
+
+	if ((!uLength) || (uLength % m_uStreamCount))
+		return QA_Fail;
+
+	//Stop any previous stream. The update DMA request is disabled while the DMA stream is set up, so that a request
+	//left pending from a previous stream is not serviced with the new buffer
+	m_sHandle.Instance->DIER &= ~TIM_DIER_UDE;
+	m_pDMA->stop();
+
+	QA_Result eRes = m_pDMA->start(uAddr, uLength);
+	if (eRes)
+		return eRes;
+
+	m_sHandle.Instance->DIER |= TIM_DIER_UDE;
+	return QA_OK;
 }
 
 
@@ -153,26 +422,54 @@ QA_Result QAD_PWM::periphInit(void) {
 
 	//Iterate through specific GPIOs per channel and initialize each in turn
 	//Will only iterate through the number of channels supported by the specific timer peripheral
+	bool bBridge = (m_uDeadTime) || (m_eBreak);
 	for (uint8_t i=0; i<QAD_TimerMgr::getChannels(m_eTimer); i++) {
 
-		//If channel is set to be active then initialize GPIO pin
+		//If channel is set to be active then initialize GPIO pin, along with the complementary output pin if used
 		if (m_sChannels[i].eActive) {
 			GPIO_Init.Pin         = m_sChannels[i].uPin; //Set pin number
 			GPIO_Init.Alternate   = m_sChannels[i].uAF;  //Set alternate function to suit required timer peripheral
 			HAL_GPIO_Init(m_sChannels[i].pGPIO, &GPIO_Init);
+
+			if (m_sChannels[i].uPin_N) {
+				GPIO_Init.Pin       = m_sChannels[i].uPin_N;
+				HAL_GPIO_Init(m_sChannels[i].pGPIO_N, &GPIO_Init);
+				bBridge = true;
+			}
 		}
 	}
 
+	//Init break input GPIO, pulled to its inactive level
+	if (m_eBreak) {
+		GPIO_Init.Pin         = m_uBreakPin;
+		GPIO_Init.Mode        = GPIO_MODE_AF_PP;
+		GPIO_Init.Pull        = (m_eBreak == QAD_PWM_BreakActiveLow) ? GPIO_PULLUP : GPIO_PULLDOWN;
+		GPIO_Init.Alternate   = m_uBreakAF;
+		HAL_GPIO_Init(m_pBreakGPIO, &GPIO_Init);
+	}
+
 	//Enable Timer Clock
 	QAD_TimerMgr::enableClock(m_eTimer);
 
+	//Cache compare register address for use by setPWMVal() methods
+	m_pCCR = &QAD_TimerMgr::getInstance(m_eTimer)->CCR1;
+
 	//Init Timer PWM Mode
 	m_sHandle.Instance                     = QAD_TimerMgr::getInstance(m_eTimer);  //Set instance for required timer peripheral
 	m_sHandle.Init.Prescaler               = m_uPrescaler;                         //Set timer prescaler
 	m_sHandle.Init.Period                  = m_uPeriod;                            //Set timer counter period
-	m_sHandle.Init.CounterMode             = TIM_COUNTERMODE_UP;                   //Set counter mode to up
-	m_sHandle.Init.ClockDivision           = TIM_CLOCKDIVISION_DIV1;               //Unused
+	m_sHandle.Init.ClockDivision           = TIM_CLOCKDIVISION_DIV1;               //Dead-time clock is the timer clock
 	m_sHandle.Init.RepetitionCounter       = 0x0;                                  //
+
+	//Set counter mode. In center-aligned mode on advanced-control timers the repetition counter is used so that the update event
+	//(and therefore the loading of preloaded compare values) only occurs once per PWM period, at the counter underflow
+	if (m_eAlign == QAD_PWM_AlignCenter) {
+		m_sHandle.Init.CounterMode           = TIM_COUNTERMODE_CENTERALIGNED1;       //Set counter mode to center-aligned
+		if (QAD_TimerMgr::getAdvanced(m_eTimer))
+			m_sHandle.Init.RepetitionCounter   = 0x1;
+	} else {
+		m_sHandle.Init.CounterMode           = TIM_COUNTERMODE_UP;                   //Set counter mode to up
+	}
 	m_sHandle.Init.AutoReloadPreload       = TIM_AUTORELOAD_PRELOAD_ENABLE;        //Enable preload of the timer's auto-reload register
 
   //Initialize Timer in PWM mode, performing a partial deinitialization if the initialization fails
@@ -194,6 +491,13 @@ QA_Result QAD_PWM::periphInit(void) {
 			TIM_OC_Init.OCPolarity    = TIM_OCPOLARITY_HIGH;    //Set Output Compare Polarity to High
 			TIM_OC_Init.OCFastMode    = TIM_OCFAST_ENABLE;      //Enable Output Compare Fast Mode
 
+			//When driving a half-bridge, both outputs are set low when the outputs are disabled (such as by the break input)
+			if (bBridge) {
+				TIM_OC_Init.OCIdleState  = TIM_OCIDLESTATE_RESET;   //Set Output Compare Idle State to Reset
+				TIM_OC_Init.OCNIdleState = TIM_OCNIDLESTATE_RESET;  //Set complementary Output Compare Idle State to Reset
+				TIM_OC_Init.OCNPolarity  = TIM_OCNPOLARITY_HIGH;    //Set complementary Output Compare Polarity to High
+			}
+
 			//Configure PWM Channel, performing a full deinitialization if the configuration fails
 			if (HAL_TIM_PWM_ConfigChannel(&m_sHandle, &TIM_OC_Init, m_uChannelSelect[i]) != HAL_OK) {
 				periphDeinit(DeinitFull);
@@ -202,9 +506,37 @@ QA_Result QAD_PWM::periphInit(void) {
 		}
 	}
 
+	//Configure dead-time and break input of advanced-control timers
+	//Off-state selections are enabled so that outputs are driven to their idle (low) levels rather than being left floating when disabled
+	if (bBridge) {
+		TIM_BreakDeadTimeConfigTypeDef TIM_BDT_Init = {0};
+		TIM_BDT_Init.OffStateRunMode  = TIM_OSSR_ENABLE;
+		TIM_BDT_Init.OffStateIDLEMode = TIM_OSSI_ENABLE;
+		TIM_BDT_Init.LockLevel        = TIM_LOCKLEVEL_OFF;
+		TIM_BDT_Init.DeadTime         = getDeadTimeReg();
+		TIM_BDT_Init.BreakState       = m_eBreak ? TIM_BREAK_ENABLE : TIM_BREAK_DISABLE;
+		TIM_BDT_Init.BreakPolarity    = (m_eBreak == QAD_PWM_BreakActiveHigh) ? TIM_BREAKPOLARITY_HIGH : TIM_BREAKPOLARITY_LOW;
+		TIM_BDT_Init.AutomaticOutput  = TIM_AUTOMATICOUTPUT_DISABLE;  //Outputs stay disabled after a break until clearBreak() is called
+
+		if (HAL_TIMEx_ConfigBreakDeadTime(&m_sHandle, &TIM_BDT_Init) != HAL_OK) {
+			periphDeinit(DeinitFull);
+			return QA_Fail;
+		}
+	}
+
+	//Initialize streaming, if any channels are to be streamed
+	if (m_uStreamChannels) {
+		QA_Result eRes = streamInit();
+		if (eRes) {
+			periphDeinit(DeinitFull);
+			return eRes;
+		}
+	}
+
 	//Set Driver States
-	m_eInitState = QA_Initialized; //Set driver state as initialized
-	m_eState     = QA_Inactive;    //Set driver as currently inactive
+	m_uChannelCount = QAD_TimerMgr::getChannels(m_eTimer);
+	m_eInitState    = QA_Initialized; //Set driver state as initialized
+	m_eState        = QA_Inactive;    //Set driver as currently inactive
 
 	//Return
 	return QA_OK;
@@ -223,6 +555,12 @@ void QAD_PWM::periphDeinit(QAD_PWM::DeinitMode eDeinitMode) {
 	//Check if a full deinitialization is required
 	if (eDeinitMode) {
 
+		//Remove streaming DMA driver (the DMA driver deinitializes itself upon destruction)
+		if (m_pDMA) {
+			m_sHandle.Instance->DIER &= ~TIM_DIER_UDE;
+			m_pDMA.reset();
+		}
+
 		//Deinitialize Timer Peripheral
 		HAL_TIM_PWM_DeInit(&m_sHandle);
 
@@ -232,12 +570,189 @@ void QAD_PWM::periphDeinit(QAD_PWM::DeinitMode eDeinitMode) {
 	}
 
 	//Deinitialize GPIOs
+	GPIO_TypeDef* pGPIO[QAD_PWM_PIN_COUNT];
+	uint16_t      uPins[QAD_PWM_PIN_COUNT];
+	uint8_t       uCount = getPins(pGPIO, uPins);
+	for (uint8_t i=0; i<uCount; i++)
+		HAL_GPIO_DeInit(pGPIO[i], uPins[i]);
+
+	//Set Driver States
+	m_uChannelCount = 0;
+	m_eState        = QA_Inactive;        //Set driver as currently inactive
+	m_eInitState    = QA_NotInitialized;  //Set driver state as not initialized
+}
+
+
+//QAD_PWM::claimResources
+//QAD_PWM Private Initialization Method
+//
+//Used to claim the Timer peripheral and the GPIO pins of all active channels (including complementary outputs and the break input) from QAD_ResourceMgr
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_PWM::claimResources(void) {
+	if (QAD_ResourceMgr::claimTimer(m_eTimer, "PWM"))
+		return QA_Error_PeriphBusy;
+
+	GPIO_TypeDef* pGPIO[QAD_PWM_PIN_COUNT];
+	uint16_t      uPins[QAD_PWM_PIN_COUNT];
+	uint8_t       uCount = getPins(pGPIO, uPins);
+
+	for (uint8_t i=0; i<uCount; i++) {
+		if (QAD_ResourceMgr::claimPins(pGPIO[i], uPins[i], "PWM")) {
+
+			//Release any pins already claimed, along with the Timer peripheral
+			for (uint8_t j=0; j<i; j++)
+				QAD_ResourceMgr::releasePins(pGPIO[j], uPins[j], "PWM");
+			QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "PWM");
+			return QA_Error_PeriphBusy;
+		}
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_PWM::releaseResources
+//QAD_PWM Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_PWM::releaseResources(void) {
+	GPIO_TypeDef* pGPIO[QAD_PWM_PIN_COUNT];
+	uint16_t      uPins[QAD_PWM_PIN_COUNT];
+	uint8_t       uCount = getPins(pGPIO, uPins);
+
+	for (uint8_t i=0; i<uCount; i++)
+		QAD_ResourceMgr::releasePins(pGPIO[i], uPins[i], "PWM");
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "PWM");
+}
+
+
+//QAD_PWM::getPins
+//QAD_PWM Private Initialization Method
+//
+//Used to build a list of the GPIO pins used by the driver, being the pins of active channels, their complementary outputs and the break input
+//pGPIO - Array of at least QAD_PWM_PIN_COUNT entries to receive the GPIO ports
+//pPins - Array of at least QAD_PWM_PIN_COUNT entries to receive the pin numbers
+//Returns the number of pins in the list
+uint8_t QAD_PWM::getPins(GPIO_TypeDef** pGPIO, uint16_t* pPins) {
+	uint8_t uCount = 0;
+
 	for (uint8_t i=0; i<QAD_TimerMgr::getChannels(m_eTimer); i++) {
-		if (m_sChannels[i].eActive)
-			HAL_GPIO_DeInit(m_sChannels[i].pGPIO, m_sChannels[i].uPin);
+		if (m_sChannels[i].eActive) {
+			pGPIO[uCount]   = m_sChannels[i].pGPIO;
+			pPins[uCount++] = m_sChannels[i].uPin;
+
+			if (m_sChannels[i].uPin_N) {
+				pGPIO[uCount]   = m_sChannels[i].pGPIO_N;
+				pPins[uCount++] = m_sChannels[i].uPin_N;
+			}
+		}
 	}
 
-	//Set Driver States
-	m_eState     = QA_Inactive;        //Set driver as currently inactive
-	m_eInitState = QA_NotInitialized;  //Set driver state as not initialized
+	if (m_eBreak) {
+		pGPIO[uCount]   = m_pBreakGPIO;
+		pPins[uCount++] = m_uBreakPin;
+	}
+
+	return uCount;
+}
+
+
+//QAD_PWM::getDeadTimeReg
+//QAD_PWM Private Initialization Method
+//
+//Used to convert the dead-time in nanoseconds into the DTG value of the BDTR register
+//The dead-time is rounded up to the next value that can be represented, so that the dead-time is never shorter than requested
+//DTG ranges (in timer clock cycles) are:
+//  0xx - 0 to 127 in steps of 1
+//  10x - 128 to 254 in steps of 2
+//  110 - 256 to 504 in steps of 8
+//  111 - 512 to 1008 in steps of 16
+//Returns the DTG value, limited to the maximum dead-time of 1008 timer clock cycles
+uint8_t QAD_PWM::getDeadTimeReg(void) {
+	uint32_t uTicks = (uint32_t)((((uint64_t)m_uDeadTime * QAD_TimerMgr::getClockSpeed(m_eTimer)) + 999999999) / 1000000000);
+
+	if (uTicks <= 127)
+		return (uint8_t)uTicks;
+	if (uTicks <= 254)
+		return (uint8_t)(0x80 | (((uTicks + 1) / 2) - 64));
+	if (uTicks <= 504)
+		return (uint8_t)(0xC0 | (((uTicks + 7) / 8) - 32));
+	if (uTicks <= 1008)
+		return (uint8_t)(0xE0 | (((uTicks + 15) / 16) - 32));
+	return 0xFF;
+}
+
+
+//QAD_PWM::streamInit
+//QAD_PWM Private Initialization Method
+//
+//Used by periphInit() to set up the timer's DMA burst registers and the DMA driver used for streaming
+//Returns QA_OK if successful
+//        QA_Error_PeriphNotSupported if the timer has no update DMA request, or the streamed channels are not active and consecutive
+//        or an error from the DMA driver if the DMA stream could not be initialized
+QA_Result QAD_PWM::streamInit(void) {
+
+	//Find update DMA request of Timer peripheral
+	QAD_DMA_Request eRequest;
+	switch (m_eTimer) {
+	  case (QAD_Timer1): eRequest = QAD_DMA_Req_TIM1_UP; break;
+	  case (QAD_Timer2): eRequest = QAD_DMA_Req_TIM2_UP; break;
+	  case (QAD_Timer3): eRequest = QAD_DMA_Req_TIM3_UP; break;
+	  case (QAD_Timer4): eRequest = QAD_DMA_Req_TIM4_UP; break;
+	  case (QAD_Timer5): eRequest = QAD_DMA_Req_TIM5_UP; break;
+	  case (QAD_Timer8): eRequest = QAD_DMA_Req_TIM8_UP; break;
+	  default:
+	  	return QA_Error_PeriphNotSupported;
+	}
+
+	//Check that streamed channels are supported by the timer, are active and are consecutive
+	uint8_t uFirst = 0;
+	while (!(m_uStreamChannels & (1 << uFirst)))
+		uFirst++;
+
+	m_uStreamCount = 0;
+	while ((uFirst + m_uStreamCount) < QAD_TimerMgr::getChannels(m_eTimer)) {
+		if ((!(m_uStreamChannels & (1 << (uFirst + m_uStreamCount)))) || (!m_sChannels[uFirst + m_uStreamCount].eActive))
+			break;
+		m_uStreamCount++;
+	}
+
+	if ((!m_uStreamCount) || (m_uStreamChannels != (((1 << m_uStreamCount) - 1) << uFirst)))
+		return QA_Error_PeriphNotSupported;
+
+	//Set DMA burst to start at the compare register of the first streamed channel, with one transfer per streamed channel
+	//When streaming the period, the burst instead starts at the auto-reload register and runs through RCR and CCR1 to the last streamed channel
+	if (m_bStreamPeriod) {
+		m_uStreamCount         += uFirst + 2;
+		m_sHandle.Instance->DCR = TIM_DMABASE_ARR | ((uint32_t)(m_uStreamCount - 1) << TIM_DCR_DBL_Pos);
+	} else {
+		m_sHandle.Instance->DCR = (TIM_DMABASE_CCR1 + uFirst) | ((uint32_t)(m_uStreamCount - 1) << TIM_DCR_DBL_Pos);
+	}
+
+	//Create and initialize DMA driver
+	QAD_DMA_Width eWidth = (QAD_TimerMgr::getType(m_eTimer) == QAD_Timer_32bit) ? QAD_DMA_Width32 : QAD_DMA_Width16;
+
+	QAD_DMA_InitStruct sDMAInit;
+	sDMAInit.eRequest     = eRequest;
+	sDMAInit.eStream      = m_eDMAStream;
+	sDMAInit.eDirection   = QAD_DMA_MemToPeriph;
+	sDMAInit.eMode        = m_bStreamLoop ? QAD_DMA_Circular : QAD_DMA_Normal;
+	sDMAInit.ePriority    = QAD_DMA_PriorityHigh;
+	sDMAInit.uPeriphAddr  = (uint32_t)&m_sHandle.Instance->DMAR;
+	sDMAInit.ePeriphWidth = eWidth;
+	sDMAInit.bPeriphInc   = false;
+	sDMAInit.eMemWidth    = eWidth;
+	sDMAInit.bMemInc      = true;
+	sDMAInit.eFIFO        = QAD_DMA_FIFODirect;
+	sDMAInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sDMAInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sDMAInit.uEvents      = m_uStreamEvents;
+	sDMAInit.uIRQPriority = m_uStreamIRQPriority;
+
+	m_pDMA = std::make_unique<QAD_DMA>(sDMAInit);
+	QA_Result eRes = m_pDMA->init();
+	if (eRes)
+		m_pDMA.reset();
+
+	return eRes;
 }
@@ -22,7 +22,11 @@
 //Includes
 #include "setup.hpp"
 
+#include <memory>
+
 #include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_DMA.hpp"
 
 
 	//------------------------------------------
@@ -41,6 +45,13 @@
 #define QAD_PWM_CHANNEL_COUNT   4
 
 
+//-----------------
+//QAD_PWM_PIN_COUNT
+//
+//Used to define the maximum number of GPIO pins that can be used by the QAD_PWM driver (main and complementary outputs, and break input)
+#define QAD_PWM_PIN_COUNT       ((QAD_PWM_CHANNEL_COUNT * 2) + 1)
+
+
 //---------------
 //QAD_PWM_Channel
 //
@@ -54,6 +65,30 @@ enum QAD_PWM_Channel : uint8_t {
 };
 
 
+//-------------
+//QAD_PWM_Align
+//
+//Used to select the counter alignment of the PWM signals
+enum QAD_PWM_Align : uint8_t {
+	QAD_PWM_AlignEdge = 0,    //Edge-aligned. Counter counts up from 0 to the period, giving a PWM frequency of timer clock / ((prescaler+1) * (period+1))
+	QAD_PWM_AlignCenter       //Center-aligned. Counter counts up to the period and back down, giving symmetric pulses centered on the counter underflow
+	                          //and a PWM frequency of timer clock / ((prescaler+1) * period * 2). Not available on Timers 9 to 14
+};
+
+
+//-------------
+//QAD_PWM_Break
+//
+//Used to select whether the break input of an advanced-control timer (Timers 1 and 8) is used
+//When the break input becomes active, all outputs are forced to their inactive (low) state by hardware, without any software involvement,
+//and remain there until QAD_PWM::clearBreak() is called
+enum QAD_PWM_Break : uint8_t {
+	QAD_PWM_BreakDisabled = 0,  //Break input not used
+	QAD_PWM_BreakActiveLow,     //Break input is active when low. The pin's pull-up resistor is enabled
+	QAD_PWM_BreakActiveHigh     //Break input is active when high. The pin's pull-down resistor is enabled
+};
+
+
 //--------------------------
 //QAD_PWM_Channel_InitStruct
 //
@@ -65,7 +100,11 @@ typedef struct QAD_PWM_Channel_InitStruct {
 
 	GPIO_TypeDef*  pGPIO;    //GPIO port to be used by this PWM channel
 	uint16_t       uPin;     //Pin number to be used by this PWM channel
-	uint8_t        uAF;      //Alternate function used to connect the GPIO pin to the respective timer peripheral
+	uint8_t        uAF;      //Alternate function used to connect the GPIO pin(s) to the respective timer peripheral
+
+	GPIO_TypeDef*  pGPIO_N;  //GPIO port to be used by the complementary (CHxN) output of this PWM channel
+	uint16_t       uPin_N;   //Pin number to be used by the complementary output. Set to 0 if the complementary output is not used
+	                         //Complementary outputs are only available on channels 1 to 3 of Timers 1 and 8
 
 
 	//Assignment operator definition to allow easy copying of channel data from QAD_PWM_InitStruct to
@@ -75,6 +114,8 @@ typedef struct QAD_PWM_Channel_InitStruct {
 		pGPIO     = other.pGPIO;
 		uPin      = other.uPin;
 		uAF       = other.uAF;
+		pGPIO_N   = other.pGPIO_N;
+		uPin_N    = other.uPin_N;
 		return *this;
 	}
 
@@ -91,11 +132,32 @@ typedef struct {
 
 	uint32_t          uPrescaler;   //Prescaler to be used for the selected timer
 	uint32_t          uPeriod;      //Counter period to be used for the selected timer
+	                                //NOTE: uPrescaler and uPeriod can be calculated from a required PWM frequency or period using QAT_TimerSolver.hpp
 
 	QAD_PWM_Channel_InitStruct sChannels[QAD_PWM_CHANNEL_COUNT];  //Data for individual PWM channels
 	                                                              //Note that although four channels worth of init data can be supplied, the selected
 	                                                              //timer peripheral may support less than four channels
 
+	QAD_PWM_Align     eAlign;           //Counter alignment. Member of QAD_PWM_Align
+
+	uint16_t          uDeadTime;        //Dead-time inserted between a main output turning off and its complementary output turning on (and vice versa),
+	                                    //in nanoseconds. Only used by Timers 1 and 8, and limited to 1008 timer clock cycles (6us at 168MHz)
+
+	QAD_PWM_Break     eBreak;           //Break input mode. Member of QAD_PWM_Break. Only available on Timers 1 and 8
+	GPIO_TypeDef*     pBreakGPIO;       //GPIO port to be used by the break input
+	uint16_t          uBreakPin;        //Pin number to be used by the break input
+	uint8_t           uBreakAF;         //Alternate function used to connect the break input pin to the timer peripheral
+
+	uint8_t           uStreamChannels;  //Channels to be driven by DMA streaming (see QAD_PWM::startStream()), with bit 0 representing channel 1
+	                                    //Channels must be active and consecutive. Set to 0 to disable streaming
+	                                    //Streaming is only supported on timers with an update DMA request (Timers 1 to 8)
+	QAD_DMA_Stream    eDMAStream;       //DMA stream to be used for streaming. Set to QAD_DMA_StreamNone to have a suitable stream found by QAD_DMAMgr
+	bool              bStreamLoop;      //Set to true for the stream buffer to be repeated continuously (circular DMA), or false for it to be sent once
+	bool              bStreamPeriod;    //Set to true to also stream the period of each PWM period (see startStream()), for variable frequency output
+	uint8_t           uStreamEvents;    //DMA events that are to trigger the stream interrupt (see setStreamHandlerClass()). Made up of QAD_DMA_Event values
+	                                    //as defined in QAD_DMAMgr.hpp. Set to 0 to leave the stream interrupt disabled
+	uint8_t           uStreamIRQPriority; //IRQ Priority for the stream interrupt (a value between 0 and 15)
+
 } QAD_PWM_InitStruct;
 
 
@@ -108,6 +170,17 @@ typedef struct {
 //
 //Driver class used for generating PWM signals on between one and four channels
 //Note that the number of available channels is determined by the number of channels supported by the selected timer peripheral
+//
+//Streaming mode allows a buffer of compare values to be sent by DMA, with a new value loaded for each PWM period on the timer's update event.
+//This allows per-period duty sequences (such as WS2812 LED data or DShot ESC frames, see QAT_PWMEncode.hpp) to be generated without
+//CPU involvement per period. When more than one channel is streamed, the buffer holds one value per streamed channel for each period
+//(in channel order), which are transferred as a single DMA burst through the timer's DMAR register. If bStreamPeriod is set, each burst
+//starts at the auto-reload register instead, so that the length of each period can also be set (such as for stepper motor step pulses)
+//
+//On the advanced-control timers (Timers 1 and 8), complementary outputs with dead-time insertion and a break input are supported for driving
+//half-bridges. Compare values are always preloaded, so new values only take effect at the next update event. beginUpdate() and endUpdate()
+//can be used around a group of setPWMVal() calls so that all of the new values take effect at the same update event, or setPWMVals() can be used
+//to set all channels at once
 class QAD_PWM {
 private:
 
@@ -133,6 +206,26 @@ private:
 
   uint32_t           m_uChannelSelect[QAD_PWM_CHANNEL_COUNT];     //Array used to select TIM_Channel defines as defined in stm32f4xx_hal_tim.h
 
+  uint8_t            m_uChannelCount;  //Number of channels supported by the selected timer peripheral, cached from QAD_TimerMgr
+  volatile uint32_t* m_pCCR;           //Pointer to the CCR1 register of the timer peripheral. CCR2 to CCR4 follow CCR1 in memory
+
+  QAD_PWM_Align      m_eAlign;           //Counter alignment
+  uint16_t           m_uDeadTime;        //Dead-time in nanoseconds
+
+  QAD_PWM_Break      m_eBreak;           //Break input mode
+  GPIO_TypeDef*      m_pBreakGPIO;       //GPIO port to be used by the break input
+  uint16_t           m_uBreakPin;        //Pin number to be used by the break input
+  uint8_t            m_uBreakAF;         //Alternate function used to connect the break input pin to the timer peripheral
+
+  uint8_t            m_uStreamChannels;  //Channels driven by DMA streaming
+  QAD_DMA_Stream     m_eDMAStream;       //DMA stream to be used for streaming
+  bool               m_bStreamLoop;      //Whether the stream buffer is repeated continuously
+  bool               m_bStreamPeriod;    //Whether the auto-reload register is streamed along with the compare registers
+  uint8_t            m_uStreamEvents;    //DMA events that are to trigger the stream interrupt
+  uint8_t            m_uStreamIRQPriority; //IRQ Priority for the stream interrupt
+  uint8_t            m_uStreamCount;     //Number of values per PWM period in the stream buffer
+  std::unique_ptr<QAD_DMA> m_pDMA;       //DMA driver used for streaming
+
 public:
 
   //--------------------------
@@ -146,7 +239,22 @@ public:
 		m_eTimer(sInit.eTimer),
 		m_sHandle({0}),
 		m_uPrescaler(sInit.uPrescaler),
-		m_uPeriod(sInit.uPeriod) {
+		m_uPeriod(sInit.uPeriod),
+		m_uChannelCount(0),
+		m_pCCR(NULL),
+		m_eAlign(sInit.eAlign),
+		m_uDeadTime(sInit.uDeadTime),
+		m_eBreak(sInit.eBreak),
+		m_pBreakGPIO(sInit.pBreakGPIO),
+		m_uBreakPin(sInit.uBreakPin),
+		m_uBreakAF(sInit.uBreakAF),
+		m_uStreamChannels(sInit.uStreamChannels),
+		m_eDMAStream(sInit.eDMAStream),
+		m_bStreamLoop(sInit.bStreamLoop),
+		m_bStreamPeriod(sInit.bStreamPeriod),
+		m_uStreamEvents(sInit.uStreamEvents),
+		m_uStreamIRQPriority(sInit.uStreamIRQPriority),
+		m_uStreamCount(0) {
 
   	//Copy channel specific data from initialization structure to m_sChannels array in QAD_PWM class
   	for (uint8_t i=0; i<QAD_PWM_CHANNEL_COUNT; i++) {
@@ -188,6 +296,59 @@ public:
   void stop(void);
 
   void setPWMVal(QAD_PWM_Channel eChannel, uint16_t uVal);
+  void setPWMVals(const uint16_t* pVals);
+
+  //Sets the current PWM value for a specific channel by writing directly to the channel's compare register
+  //This is intended for use in time critical code such as control loop interrupts, so performs no checks. The driver must be initialized,
+  //and eChannel must be a channel supported by the selected timer peripheral
+  //eChannel - The PWM channel to set the value for. A member of QAD_PWM_Channel
+  //uVal     - The PWM value to set. This value should not be larger than the timer period set within the driver initialization structure
+  void setPWMValFast(QAD_PWM_Channel eChannel, uint32_t uVal) {
+  	m_pCCR[eChannel] = uVal;
+  }
+
+  //Returns the counter period set within the driver initialization structure. A PWM value of (period + 1) gives a constant high output
+  uint32_t getPeriod(void) {
+  	return m_uPeriod;
+  }
+
+  //Sets the counter period by writing directly to the timer's auto-reload register, taking effect from the next update event
+  //As with setPWMValFast() no checks are performed. getPeriod() still returns the period set within the driver initialization structure
+  //uPeriod - The new counter period (one less than the number of timer ticks per PWM period)
+  void setPeriodFast(uint32_t uPeriod) {
+  	m_sHandle.Instance->ARR = uPeriod;
+  }
+
+  //Forces an update event, restarting the counter and loading the period and compare values set by setPeriodFast() and setPWMValFast()
+  //straight away rather than at the end of the current PWM period. Must not be called while a stream is in progress, as the update
+  //event would also trigger a stream transfer
+  void generateUpdate(void) {
+  	m_sHandle.Instance->EGR = TIM_EGR_UG;
+  }
+
+  void beginUpdate(void);
+  void endUpdate(void);
+
+
+  //-------------
+  //Break Methods
+
+  bool getBreak(void);
+  QA_Result clearBreak(void);
+
+
+  //-----------------
+  //Streaming Methods
+
+  QA_Result startStream(const uint16_t* pData, uint16_t uLength);
+  QA_Result startStream(const uint32_t* pData, uint16_t uLength);
+  void stopStream(void);
+
+  bool isStreaming(void);
+  uint16_t getStreamRemaining(void);
+
+  void setStreamHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler);
+  void setStreamHandlerClass(QAD_IRQHandler_CallbackClass* pHandler);
 
 private:
 
@@ -197,6 +358,20 @@ private:
   QA_Result periphInit(void);
   void periphDeinit(DeinitMode eDeinitMode);
 
+  QA_Result claimResources(void);
+  void releaseResources(void);
+
+  QA_Result streamInit(void);
+
+  uint8_t getPins(GPIO_TypeDef** pGPIO, uint16_t* pPins);
+  uint8_t getDeadTimeReg(void);
+
+
+  //-------------------------
+  //Private Streaming Methods
+
+  QA_Result imp_startStream(uint32_t uAddr, uint16_t uLength);
+
 };
 
 
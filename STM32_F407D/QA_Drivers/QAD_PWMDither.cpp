@@ -0,0 +1,210 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Dithered High Resolution PWM Driver                             */
+/*   Filename: QAD_PWMDither.cpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_PWMDither.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //--------------------------
+  //--------------------------
+  //QAD_PWMDither Constructors
+
+//QAD_PWMDither::QAD_PWMDither
+//QAD_PWMDither Constructor
+//
+//Used to set up the initialization structure of the PWM driver, with a single active channel that is streamed from a circular buffer
+QAD_PWMDither::QAD_PWMDither(QAD_PWMDither_InitStruct& sInit) :
+	m_sPWMInit({}),
+	m_eChannel(sInit.eChannel),
+	m_uLength(sInit.uLength),
+	m_cModulator(sInit.eOrder, sInit.uPeriod + 1),
+	m_eInitState(QA_NotInitialized),
+	m_eState(QA_Inactive) {
+
+	m_sPWMInit.eTimer     = sInit.eTimer;
+	m_sPWMInit.uPrescaler = sInit.uPrescaler;
+	m_sPWMInit.uPeriod    = sInit.uPeriod;
+	m_sPWMInit.eAlign     = QAD_PWM_AlignEdge;
+	m_sPWMInit.eBreak     = QAD_PWM_BreakDisabled;
+
+	for (uint8_t i=0; i<QAD_PWM_CHANNEL_COUNT; i++)
+		m_sPWMInit.sChannels[i].eActive = QA_Inactive;
+
+	m_sPWMInit.sChannels[sInit.eChannel].eActive = QA_Active;
+	m_sPWMInit.sChannels[sInit.eChannel].pGPIO   = sInit.pGPIO;
+	m_sPWMInit.sChannels[sInit.eChannel].uPin    = sInit.uPin;
+	m_sPWMInit.sChannels[sInit.eChannel].uAF     = sInit.uAF;
+
+	m_sPWMInit.uStreamChannels    = (1 << sInit.eChannel);
+	m_sPWMInit.eDMAStream         = sInit.eDMAStream;
+	m_sPWMInit.bStreamLoop        = true;
+	m_sPWMInit.uStreamEvents      = QAD_DMA_Event_HalfTransfer | QAD_DMA_Event_TransferComplete;
+	m_sPWMInit.uStreamIRQPriority = sInit.uIRQPriority;
+}
+
+
+  //------------------------------------
+  //------------------------------------
+  //QAD_PWMDither Initialization Methods
+
+//QAD_PWMDither::init
+//QAD_PWMDither Initialization Method
+//
+//Used to initialize the driver. The Timer peripheral, GPIO pin and DMA stream are claimed by the underlying QAD_PWM driver
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+//        QA_Error_PeriphNotSupported if the timer is not a 16bit timer, the period is 0xFFFF, or the buffer length is not valid
+QA_Result QAD_PWMDither::init(void) {
+	if (m_eInitState)
+		return QA_Fail;
+
+	//Compare values are streamed as 16bit values, so 32bit timers are not supported. A period of 0xFFFF is also not supported, as the
+	//compare value giving 100% duty (0x10000) would wrap to 0% when written to the buffer
+	if (QAD_TimerMgr::getType(m_sPWMInit.eTimer) != QAD_Timer_16bit)
+		return QA_Error_PeriphNotSupported;
+	if (m_sPWMInit.uPeriod >= 0xFFFF)
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_uLength < 2) || (m_uLength & 1))
+		return QA_Error_PeriphNotSupported;
+
+	//Create and initialize PWM driver
+	m_pPWM = std::make_unique<QAD_PWM>(m_sPWMInit);
+	QA_Result eRes = m_pPWM->init();
+	if (eRes) {
+		m_pPWM.reset();
+		return eRes;
+	}
+	m_pPWM->setStreamHandlerClass(this);
+
+	//Create compare value buffer
+	m_pBuffer = std::make_unique<uint16_t[]>(m_uLength);
+
+	//Set driver states
+	m_eInitState = QA_Initialized;
+	m_eState     = QA_Inactive;
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_PWMDither::deinit
+//QAD_PWMDither Initialization Method
+//
+//Used to deinitialize the driver
+void QAD_PWMDither::deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	if (m_eState)
+		stop();
+
+	//Remove PWM driver (the PWM driver deinitializes itself upon destruction) and buffer
+	m_pPWM.reset();
+	m_pBuffer.reset();
+
+	m_eInitState = QA_NotInitialized;
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAD_PWMDither IRQ Handler Methods
+
+//QAD_PWMDither::handler
+//QAD_PWMDither IRQ Handler Method
+//
+//Called by the DMA stream interrupt of the PWM driver
+//Refills the half of the buffer that has just been transferred, while the DMA stream transfers the other half
+//pData - Pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values as defined in QAD_DMAMgr.hpp)
+void QAD_PWMDither::handler(void* pData) {
+	uint8_t  uEvents = *(uint8_t*)pData;
+	uint16_t uHalf   = m_uLength / 2;
+
+	if (uEvents & QAD_DMA_Event_HalfTransfer)
+		m_cModulator.fill(m_pBuffer.get(), uHalf);
+
+	if (uEvents & QAD_DMA_Event_TransferComplete)
+		m_cModulator.fill(m_pBuffer.get() + uHalf, uHalf);
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAD_PWMDither Control Methods
+
+//QAD_PWMDither::start
+//QAD_PWMDither Control Method
+//
+//Used to start PWM generation, using the duty most recently set by setDuty()
+void QAD_PWMDither::start(void) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	//Fill the complete buffer before the stream is started
+	m_cModulator.reset();
+	m_cModulator.fill(m_pBuffer.get(), m_uLength);
+
+	m_pPWM->start();
+	m_pPWM->startStream(m_pBuffer.get(), m_uLength);
+
+	m_eState = QA_Active;
+}
+
+
+//QAD_PWMDither::stop
+//QAD_PWMDither Control Method
+//
+//Used to stop PWM generation
+void QAD_PWMDither::stop(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	m_pPWM->stopStream();
+	m_pPWM->stop();
+
+	m_eState = QA_Inactive;
+}
+
+
+//QAD_PWMDither::setDuty
+//QAD_PWMDither Control Method
+//
+//Used to set the duty cycle. When active, the new duty takes effect once the half of the buffer currently being transferred has been sent
+//uDuty - The duty cycle, from 0 to QAT_SigmaDelta_Full (65536, being 100%)
+void QAD_PWMDither::setDuty(uint32_t uDuty) {
+
+	//The modulator's target is made up of two values, so interrupts are disabled while it is changed
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+	m_cModulator.setValue(uDuty);
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAD_PWMDither::getState
+//QAD_PWMDither Control Method
+//
+//Returns whether the driver is currently active. Member of QA_ActiveState as defined in setup.hpp
+QA_ActiveState QAD_PWMDither::getState(void) {
+	return m_eState;
+}
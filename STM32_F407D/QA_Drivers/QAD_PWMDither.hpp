@@ -0,0 +1,143 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Dithered High Resolution PWM Driver                             */
+/*   Filename: QAD_PWMDither.hpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_PWMDITHER_HPP_
+#define __QAD_PWMDITHER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_PWM.hpp"
+#include "QAT_SigmaDelta.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------------------
+//QAD_PWMDither_InitStruct
+//
+//This structure is used to be able to create the QAD_PWMDither driver class
+typedef struct {
+
+	QAD_Timer_Periph     eTimer;        //Timer peripheral to be used. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	                                    //Must be a 16bit timer with an update DMA request (Timers 1, 3, 4 or 8)
+
+	uint32_t             uPrescaler;    //Prescaler to be used for the selected timer
+	uint32_t             uPeriod;       //Counter period to be used for the selected timer. Must be less than 0xFFFF, so that the compare value
+	                                    //giving 100% duty (the period + 1) fits in the 16bit compare value buffer
+
+	QAD_PWM_Channel      eChannel;      //PWM channel to be used. Member of QAD_PWM_Channel as defined in QAD_PWM.hpp
+	GPIO_TypeDef*        pGPIO;         //GPIO port to be used by the PWM channel
+	uint16_t             uPin;          //Pin number to be used by the PWM channel
+	uint8_t              uAF;           //Alternate function used to connect the GPIO pin to the timer peripheral
+
+	QAT_SigmaDelta_Order eOrder;        //Sigma-delta modulator order. Member of QAT_SigmaDelta_Order as defined in QAT_SigmaDelta.hpp
+
+	uint16_t             uLength;       //Length of the compare value buffer. Must be even, as each half of the buffer is refilled while the other half is in use
+	                                    //A longer buffer reduces the interrupt rate, but increases the delay before a new duty takes effect
+	QAD_DMA_Stream       eDMAStream;    //DMA stream to be used. Set to QAD_DMA_StreamNone to have a suitable stream found by QAD_DMAMgr
+	uint8_t              uIRQPriority;  //IRQ Priority for the DMA stream interrupt used to refill the buffer (a value between 0 and 15)
+
+} QAD_PWMDither_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------
+//QAD_PWMDither
+//
+//Driver class for generating a single channel of high resolution PWM
+//
+//At high PWM frequencies the timer period is small, so the duty cycle resolution of QAD_PWM is only a few bits (840 steps at 100kHz on
+//an 84MHz timer). This driver uses a sigma-delta modulator (see QAT_SigmaDelta.hpp) to vary the compare value from period to period,
+//so that the average duty cycle has 16bit resolution. The compare values are streamed from a circular buffer by QAD_PWM, with each half
+//of the buffer being refilled by the modulator from the DMA half transfer and transfer complete interrupts
+class QAD_PWMDither : public QAD_IRQHandler_CallbackClass {
+private:
+
+	QAD_PWM_InitStruct          m_sPWMInit;    //Initialization structure for the PWM driver
+
+	QAD_PWM_Channel             m_eChannel;    //PWM channel to be used
+	uint16_t                    m_uLength;     //Length of the compare value buffer
+
+	std::unique_ptr<QAD_PWM>    m_pPWM;        //PWM driver used to generate the output
+	std::unique_ptr<uint16_t[]> m_pBuffer;     //Circular buffer of compare values
+
+	QAT_SigmaDelta              m_cModulator;  //Sigma-delta modulator
+
+	QA_InitState                m_eInitState;  //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState              m_eState;      //Stores whether the driver is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_PWMDither() = delete;                         //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_PWMDither(QAD_PWMDither_InitStruct& sInit);   //The class constructor to be used, which has a reference to an initialization structure passed to it
+
+	~QAD_PWMDither() {  //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
+
+		//Stop driver if currently active
+		if (m_eState)
+			stop();
+
+		//Deinitialize driver if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_PWMDither.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+	//---------------
+	//Control Methods
+
+	void start(void);
+	void stop(void);
+
+	void setDuty(uint32_t uDuty);
+
+	QA_ActiveState getState(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_PWMDITHER_HPP_ */
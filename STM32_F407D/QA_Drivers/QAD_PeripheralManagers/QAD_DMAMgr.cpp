@@ -0,0 +1,381 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: DMA Management Driver                                           */
+/*   Filename: QAD_DMAMgr.cpp                                              */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_DMAMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//----------------------
+//QAD_DMA_RequestMapping
+//
+//DMA request mapping table for the STM32F407, taken from the DMA1 and DMA2 request mapping tables in RM0090
+//Requests that share a stream/channel combination (for instance TIM2_UP and TIM2_CH3) each have their own entry
+const QAD_DMA_Mapping QAD_DMA_RequestMapping[] = {
+	//DMA1 Channel 0
+	{QAD_DMA_Req_SPI3_RX,       QAD_DMA1_Stream0, DMA_CHANNEL_0},
+	{QAD_DMA_Req_SPI3_RX,       QAD_DMA1_Stream2, DMA_CHANNEL_0},
+	{QAD_DMA_Req_SPI2_RX,       QAD_DMA1_Stream3, DMA_CHANNEL_0},
+	{QAD_DMA_Req_SPI2_TX,       QAD_DMA1_Stream4, DMA_CHANNEL_0},
+	{QAD_DMA_Req_SPI3_TX,       QAD_DMA1_Stream5, DMA_CHANNEL_0},
+	{QAD_DMA_Req_SPI3_TX,       QAD_DMA1_Stream7, DMA_CHANNEL_0},
+
+	//DMA1 Channel 1
+	{QAD_DMA_Req_I2C1_RX,       QAD_DMA1_Stream0, DMA_CHANNEL_1},
+	{QAD_DMA_Req_TIM7_UP,       QAD_DMA1_Stream2, DMA_CHANNEL_1},
+	{QAD_DMA_Req_TIM7_UP,       QAD_DMA1_Stream4, DMA_CHANNEL_1},
+	{QAD_DMA_Req_I2C1_RX,       QAD_DMA1_Stream5, DMA_CHANNEL_1},
+	{QAD_DMA_Req_I2C1_TX,       QAD_DMA1_Stream6, DMA_CHANNEL_1},
+	{QAD_DMA_Req_I2C1_TX,       QAD_DMA1_Stream7, DMA_CHANNEL_1},
+
+	//DMA1 Channel 2
+	{QAD_DMA_Req_TIM4_CH1,      QAD_DMA1_Stream0, DMA_CHANNEL_2},
+	{QAD_DMA_Req_I2S3_EXT_RX,   QAD_DMA1_Stream2, DMA_CHANNEL_2},
+	{QAD_DMA_Req_TIM4_CH2,      QAD_DMA1_Stream3, DMA_CHANNEL_2},
+	{QAD_DMA_Req_I2S2_EXT_TX,   QAD_DMA1_Stream4, DMA_CHANNEL_2},
+	{QAD_DMA_Req_I2S3_EXT_TX,   QAD_DMA1_Stream5, DMA_CHANNEL_2},
+	{QAD_DMA_Req_TIM4_UP,       QAD_DMA1_Stream6, DMA_CHANNEL_2},
+	{QAD_DMA_Req_TIM4_CH3,      QAD_DMA1_Stream7, DMA_CHANNEL_2},
+
+	//DMA1 Channel 3
+	{QAD_DMA_Req_I2S3_EXT_RX,   QAD_DMA1_Stream0, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_UP,       QAD_DMA1_Stream1, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_CH3,      QAD_DMA1_Stream1, DMA_CHANNEL_3},
+	{QAD_DMA_Req_I2C3_RX,       QAD_DMA1_Stream2, DMA_CHANNEL_3},
+	{QAD_DMA_Req_I2S2_EXT_RX,   QAD_DMA1_Stream3, DMA_CHANNEL_3},
+	{QAD_DMA_Req_I2C3_TX,       QAD_DMA1_Stream4, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_CH1,      QAD_DMA1_Stream5, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_CH2,      QAD_DMA1_Stream6, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_CH4,      QAD_DMA1_Stream6, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_UP,       QAD_DMA1_Stream7, DMA_CHANNEL_3},
+	{QAD_DMA_Req_TIM2_CH4,      QAD_DMA1_Stream7, DMA_CHANNEL_3},
+
+	//DMA1 Channel 4
+	{QAD_DMA_Req_UART5_RX,      QAD_DMA1_Stream0, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART3_RX,     QAD_DMA1_Stream1, DMA_CHANNEL_4},
+	{QAD_DMA_Req_UART4_RX,      QAD_DMA1_Stream2, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART3_TX,     QAD_DMA1_Stream3, DMA_CHANNEL_4},
+	{QAD_DMA_Req_UART4_TX,      QAD_DMA1_Stream4, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART2_RX,     QAD_DMA1_Stream5, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART2_TX,     QAD_DMA1_Stream6, DMA_CHANNEL_4},
+	{QAD_DMA_Req_UART5_TX,      QAD_DMA1_Stream7, DMA_CHANNEL_4},
+
+	//DMA1 Channel 5
+	{QAD_DMA_Req_TIM3_CH4,      QAD_DMA1_Stream2, DMA_CHANNEL_5},
+	{QAD_DMA_Req_TIM3_UP,       QAD_DMA1_Stream2, DMA_CHANNEL_5},
+	{QAD_DMA_Req_TIM3_CH1,      QAD_DMA1_Stream4, DMA_CHANNEL_5},
+	{QAD_DMA_Req_TIM3_TRIG,     QAD_DMA1_Stream4, DMA_CHANNEL_5},
+	{QAD_DMA_Req_TIM3_CH2,      QAD_DMA1_Stream5, DMA_CHANNEL_5},
+	{QAD_DMA_Req_TIM3_CH3,      QAD_DMA1_Stream7, DMA_CHANNEL_5},
+
+	//DMA1 Channel 6
+	{QAD_DMA_Req_TIM5_CH3,      QAD_DMA1_Stream0, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_UP,       QAD_DMA1_Stream0, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_CH4,      QAD_DMA1_Stream1, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_TRIG,     QAD_DMA1_Stream1, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_CH1,      QAD_DMA1_Stream2, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_CH4,      QAD_DMA1_Stream3, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_TRIG,     QAD_DMA1_Stream3, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_CH2,      QAD_DMA1_Stream4, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM5_UP,       QAD_DMA1_Stream6, DMA_CHANNEL_6},
+
+	//DMA1 Channel 7
+	{QAD_DMA_Req_TIM6_UP,       QAD_DMA1_Stream1, DMA_CHANNEL_7},
+	{QAD_DMA_Req_I2C2_RX,       QAD_DMA1_Stream2, DMA_CHANNEL_7},
+	{QAD_DMA_Req_I2C2_RX,       QAD_DMA1_Stream3, DMA_CHANNEL_7},
+	{QAD_DMA_Req_USART3_TX,     QAD_DMA1_Stream4, DMA_CHANNEL_7},
+	{QAD_DMA_Req_DAC1,          QAD_DMA1_Stream5, DMA_CHANNEL_7},
+	{QAD_DMA_Req_DAC2,          QAD_DMA1_Stream6, DMA_CHANNEL_7},
+	{QAD_DMA_Req_I2C2_TX,       QAD_DMA1_Stream7, DMA_CHANNEL_7},
+
+	//DMA2 Channel 0
+	{QAD_DMA_Req_ADC1,          QAD_DMA2_Stream0, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM8_CH1,      QAD_DMA2_Stream2, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM8_CH2,      QAD_DMA2_Stream2, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM8_CH3,      QAD_DMA2_Stream2, DMA_CHANNEL_0},
+	{QAD_DMA_Req_ADC1,          QAD_DMA2_Stream4, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM1_CH1,      QAD_DMA2_Stream6, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM1_CH2,      QAD_DMA2_Stream6, DMA_CHANNEL_0},
+	{QAD_DMA_Req_TIM1_CH3,      QAD_DMA2_Stream6, DMA_CHANNEL_0},
+
+	//DMA2 Channel 1
+	{QAD_DMA_Req_DCMI,          QAD_DMA2_Stream1, DMA_CHANNEL_1},
+	{QAD_DMA_Req_ADC2,          QAD_DMA2_Stream2, DMA_CHANNEL_1},
+	{QAD_DMA_Req_ADC2,          QAD_DMA2_Stream3, DMA_CHANNEL_1},
+	{QAD_DMA_Req_DCMI,          QAD_DMA2_Stream7, DMA_CHANNEL_1},
+
+	//DMA2 Channel 2
+	{QAD_DMA_Req_ADC3,          QAD_DMA2_Stream0, DMA_CHANNEL_2},
+	{QAD_DMA_Req_ADC3,          QAD_DMA2_Stream1, DMA_CHANNEL_2},
+
+	//DMA2 Channel 3
+	{QAD_DMA_Req_SPI1_RX,       QAD_DMA2_Stream0, DMA_CHANNEL_3},
+	{QAD_DMA_Req_SPI1_RX,       QAD_DMA2_Stream2, DMA_CHANNEL_3},
+	{QAD_DMA_Req_SPI1_TX,       QAD_DMA2_Stream3, DMA_CHANNEL_3},
+	{QAD_DMA_Req_SPI1_TX,       QAD_DMA2_Stream5, DMA_CHANNEL_3},
+
+	//DMA2 Channel 4
+	{QAD_DMA_Req_USART1_RX,     QAD_DMA2_Stream2, DMA_CHANNEL_4},
+	{QAD_DMA_Req_SDIO,          QAD_DMA2_Stream3, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART1_RX,     QAD_DMA2_Stream5, DMA_CHANNEL_4},
+	{QAD_DMA_Req_SDIO,          QAD_DMA2_Stream6, DMA_CHANNEL_4},
+	{QAD_DMA_Req_USART1_TX,     QAD_DMA2_Stream7, DMA_CHANNEL_4},
+
+	//DMA2 Channel 5
+	{QAD_DMA_Req_USART6_RX,     QAD_DMA2_Stream1, DMA_CHANNEL_5},
+	{QAD_DMA_Req_USART6_RX,     QAD_DMA2_Stream2, DMA_CHANNEL_5},
+	{QAD_DMA_Req_USART6_TX,     QAD_DMA2_Stream6, DMA_CHANNEL_5},
+	{QAD_DMA_Req_USART6_TX,     QAD_DMA2_Stream7, DMA_CHANNEL_5},
+
+	//DMA2 Channel 6
+	{QAD_DMA_Req_TIM1_TRIG,     QAD_DMA2_Stream0, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_CH1,      QAD_DMA2_Stream1, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_CH2,      QAD_DMA2_Stream2, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_CH1,      QAD_DMA2_Stream3, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_CH4,      QAD_DMA2_Stream4, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_TRIG,     QAD_DMA2_Stream4, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_COM,      QAD_DMA2_Stream4, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_UP,       QAD_DMA2_Stream5, DMA_CHANNEL_6},
+	{QAD_DMA_Req_TIM1_CH3,      QAD_DMA2_Stream6, DMA_CHANNEL_6},
+
+	//DMA2 Channel 7
+	{QAD_DMA_Req_TIM8_UP,       QAD_DMA2_Stream1, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_CH1,      QAD_DMA2_Stream2, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_CH2,      QAD_DMA2_Stream3, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_CH3,      QAD_DMA2_Stream4, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_CH4,      QAD_DMA2_Stream7, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_TRIG,     QAD_DMA2_Stream7, DMA_CHANNEL_7},
+	{QAD_DMA_Req_TIM8_COM,      QAD_DMA2_Stream7, DMA_CHANNEL_7},
+
+	//Memory to Memory (DMA2 only, channel selection is unused)
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream0, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream1, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream2, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream3, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream4, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream5, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream6, DMA_CHANNEL_0},
+	{QAD_DMA_Req_MemToMem,      QAD_DMA2_Stream7, DMA_CHANNEL_0}
+
+};
+
+const uint8_t QAD_DMA_RequestMappingCount = sizeof(QAD_DMA_RequestMapping) / sizeof(QAD_DMA_Mapping);
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+  //-----------------------
+  //-----------------------
+	//QAD_DMAMgr Constructors
+
+//QAD_DMAMgr::QAD_DMAMgr
+//QAD_DMAMgr Constructor
+//
+//Fills out details for the system's DMA streams
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAD_DMAMgr::QAD_DMAMgr() {
+
+	const uint8_t uFlagShifts[4] = {0, 6, 16, 22};  //Bit offsets of stream flags within LISR/HISR registers (streams 0 to 3, repeated for 4 to 7)
+
+	for (uint8_t i=0; i<QAD_DMA_StreamCount; i++) {
+		m_sStreams[i].eStream     = (QAD_DMA_Stream)i;
+		m_sStreams[i].eState      = QAD_DMA_Unused;
+		m_sStreams[i].pController = (i < QAD_DMA2_Stream0) ? DMA1 : DMA2;
+		m_sStreams[i].uFlagShift  = uFlagShifts[i & 0x03];
+		m_sStreams[i].uUsage      = 0;
+		m_sStreams[i].pHandler    = NULL;
+	}
+
+	//Set Instances
+	m_sStreams[QAD_DMA1_Stream0].pInstance = DMA1_Stream0;
+	m_sStreams[QAD_DMA1_Stream1].pInstance = DMA1_Stream1;
+	m_sStreams[QAD_DMA1_Stream2].pInstance = DMA1_Stream2;
+	m_sStreams[QAD_DMA1_Stream3].pInstance = DMA1_Stream3;
+	m_sStreams[QAD_DMA1_Stream4].pInstance = DMA1_Stream4;
+	m_sStreams[QAD_DMA1_Stream5].pInstance = DMA1_Stream5;
+	m_sStreams[QAD_DMA1_Stream6].pInstance = DMA1_Stream6;
+	m_sStreams[QAD_DMA1_Stream7].pInstance = DMA1_Stream7;
+	m_sStreams[QAD_DMA2_Stream0].pInstance = DMA2_Stream0;
+	m_sStreams[QAD_DMA2_Stream1].pInstance = DMA2_Stream1;
+	m_sStreams[QAD_DMA2_Stream2].pInstance = DMA2_Stream2;
+	m_sStreams[QAD_DMA2_Stream3].pInstance = DMA2_Stream3;
+	m_sStreams[QAD_DMA2_Stream4].pInstance = DMA2_Stream4;
+	m_sStreams[QAD_DMA2_Stream5].pInstance = DMA2_Stream5;
+	m_sStreams[QAD_DMA2_Stream6].pInstance = DMA2_Stream6;
+	m_sStreams[QAD_DMA2_Stream7].pInstance = DMA2_Stream7;
+
+	//Set IRQs
+	m_sStreams[QAD_DMA1_Stream0].eIRQ = DMA1_Stream0_IRQn;
+	m_sStreams[QAD_DMA1_Stream1].eIRQ = DMA1_Stream1_IRQn;
+	m_sStreams[QAD_DMA1_Stream2].eIRQ = DMA1_Stream2_IRQn;
+	m_sStreams[QAD_DMA1_Stream3].eIRQ = DMA1_Stream3_IRQn;
+	m_sStreams[QAD_DMA1_Stream4].eIRQ = DMA1_Stream4_IRQn;
+	m_sStreams[QAD_DMA1_Stream5].eIRQ = DMA1_Stream5_IRQn;
+	m_sStreams[QAD_DMA1_Stream6].eIRQ = DMA1_Stream6_IRQn;
+	m_sStreams[QAD_DMA1_Stream7].eIRQ = DMA1_Stream7_IRQn;
+	m_sStreams[QAD_DMA2_Stream0].eIRQ = DMA2_Stream0_IRQn;
+	m_sStreams[QAD_DMA2_Stream1].eIRQ = DMA2_Stream1_IRQn;
+	m_sStreams[QAD_DMA2_Stream2].eIRQ = DMA2_Stream2_IRQn;
+	m_sStreams[QAD_DMA2_Stream3].eIRQ = DMA2_Stream3_IRQn;
+	m_sStreams[QAD_DMA2_Stream4].eIRQ = DMA2_Stream4_IRQn;
+	m_sStreams[QAD_DMA2_Stream5].eIRQ = DMA2_Stream5_IRQn;
+	m_sStreams[QAD_DMA2_Stream6].eIRQ = DMA2_Stream6_IRQn;
+	m_sStreams[QAD_DMA2_Stream7].eIRQ = DMA2_Stream7_IRQn;
+
+	//Count the number of peripheral requests that can be serviced by each stream
+	//Memory to memory entries are not counted, as they are available on every DMA2 stream
+	for (uint8_t i=0; i<QAD_DMA_RequestMappingCount; i++) {
+		if (QAD_DMA_RequestMapping[i].eRequest != QAD_DMA_Req_MemToMem)
+			m_sStreams[QAD_DMA_RequestMapping[i].eStream].uUsage++;
+	}
+}
+
+
+  //-----------------------
+  //-----------------------
+  //QAD_DMAMgr Data Methods
+
+//QAD_DMAMgr::imp_getChannel
+//QAD_DMAMgr Data Method
+//
+//To be called from static method getChannel()
+//Used to retrieve the channel that must be selected on a DMA stream for it to service a peripheral request
+//eRequest - The peripheral request. Member of QAD_DMA_Request
+//eStream  - The DMA stream. Member of QAD_DMA_Stream
+//Returns a DMA_CHANNEL_x define from stm32f4xx_hal_dma.h, or QAD_DMA_ChannelInvalid if the stream cannot service the request
+uint32_t QAD_DMAMgr::imp_getChannel(QAD_DMA_Request eRequest, QAD_DMA_Stream eStream) {
+	for (uint8_t i=0; i<QAD_DMA_RequestMappingCount; i++) {
+		if ((QAD_DMA_RequestMapping[i].eRequest == eRequest) && (QAD_DMA_RequestMapping[i].eStream == eStream))
+			return QAD_DMA_RequestMapping[i].uChannel;
+	}
+	return QAD_DMA_ChannelInvalid;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAD_DMAMgr Management Methods
+
+//QAD_DMAMgr::imp_registerStream
+//QAD_DMAMgr Management Method
+//
+//To be called from static method registerStream()
+//Used to register a DMA stream as being used by a driver
+//eStream  - The DMA stream to be registered. Member of QAD_DMA_Stream
+//pHandler - The driver to which the stream's interrupts are to be routed
+//Returns QA_OK if registration is successful
+//        QA_Fail if eStream is not a valid stream
+//        QA_Error_PeriphBusy if the selected stream is already in use
+QA_Result QAD_DMAMgr::imp_registerStream(QAD_DMA_Stream eStream, QAD_IRQHandler_CallbackClass* pHandler) {
+	if (eStream >= QAD_DMA_StreamNone)
+		return QA_Fail;
+
+	if (m_sStreams[eStream].eState)
+		return QA_Error_PeriphBusy;
+
+	m_sStreams[eStream].eState   = QAD_DMA_InUse;
+	m_sStreams[eStream].pHandler = pHandler;
+	return QA_OK;
+}
+
+
+//QAD_DMAMgr::imp_deregisterStream
+//QAD_DMAMgr Management Method
+//
+//To be called from static method deregisterStream()
+//Used to deregister a DMA stream to mark it as no longer being used by a driver
+//eStream - The DMA stream to be deregistered. Member of QAD_DMA_Stream
+void QAD_DMAMgr::imp_deregisterStream(QAD_DMA_Stream eStream) {
+	if (eStream >= QAD_DMA_StreamNone)
+		return;
+
+	m_sStreams[eStream].eState   = QAD_DMA_Unused;
+	m_sStreams[eStream].pHandler = NULL;
+}
+
+
+//QAD_DMAMgr::imp_findStream
+//QAD_DMAMgr Management Method
+//
+//To be called from static method findStream()
+//Used to find an available DMA stream that can service a peripheral request
+//Of the available streams that can service the request, the one able to service the fewest other requests is returned
+//eRequest - The peripheral request. Member of QAD_DMA_Request
+//Returns QAD_DMA_StreamNone if no available stream is found, or another member of QAD_DMA_Stream for the available stream that has been found
+QAD_DMA_Stream QAD_DMAMgr::imp_findStream(QAD_DMA_Request eRequest) {
+	QAD_DMA_Stream eBest      = QAD_DMA_StreamNone;
+	uint8_t        uBestUsage = 0xFF;
+
+	for (uint8_t i=0; i<QAD_DMA_RequestMappingCount; i++) {
+		if (QAD_DMA_RequestMapping[i].eRequest != eRequest)
+			continue;
+
+		QAD_DMA_Data& sStream = m_sStreams[QAD_DMA_RequestMapping[i].eStream];
+		if ((!sStream.eState) && (sStream.uUsage < uBestUsage)) {
+			eBest      = sStream.eStream;
+			uBestUsage = sStream.uUsage;
+		}
+	}
+	return eBest;
+}
+
+
+  //------------------------------
+  //------------------------------
+  //QAD_DMAMgr IRQ Handler Methods
+
+//QAD_DMAMgr::imp_irqHandler
+//QAD_DMAMgr IRQ Handler Method
+//
+//To be called from static method irqHandler()
+//Reads and clears the stream's event flags, and then calls the handler() method of the driver that owns the stream
+//with a pointer to the event flags. Flags are cleared before the owner is called so that the owner is able to restart
+//the stream from within its handler
+//eStream - The DMA stream that has triggered the interrupt. Member of QAD_DMA_Stream
+void QAD_DMAMgr::imp_irqHandler(QAD_DMA_Stream eStream) {
+	uint8_t uFlags = getFlags(eStream);
+	clearFlags(eStream, uFlags);
+
+	if (m_sStreams[eStream].pHandler)
+		m_sStreams[eStream].pHandler->handler(&uFlags);
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAD_DMAMgr Status Methods
+
+//QAD_DMAMgr::imp_getStreamsActive
+//QAD_DMAMgr Status Method
+//
+//To be called by getStreamsActive() and getStreamsInactive()
+//Returns the number of DMA streams that are currently in-use (registered/active)
+uint8_t QAD_DMAMgr::imp_getStreamsActive(void) {
+	uint8_t uCount = 0;
+	for (uint8_t i=0; i<QAD_DMA_StreamCount; i++) {
+		if (m_sStreams[i].eState)
+			uCount++;
+	}
+	return uCount;
+}
@@ -0,0 +1,420 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: DMA Management Driver                                           */
+/*   Filename: QAD_DMAMgr.hpp                                              */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_DMAMGR_HPP_
+#define __QAD_DMAMGR_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//--------------
+//QAD_DMA_Stream
+//
+//Used to select which DMA stream is to be used, and index into stream array in DMA Manager
+//DMA1 streams are indexed 0 to 7, and DMA2 streams are indexed 8 to 15
+enum QAD_DMA_Stream : uint8_t {
+	QAD_DMA1_Stream0 = 0,
+	QAD_DMA1_Stream1,
+	QAD_DMA1_Stream2,
+	QAD_DMA1_Stream3,
+	QAD_DMA1_Stream4,
+	QAD_DMA1_Stream5,
+	QAD_DMA1_Stream6,
+	QAD_DMA1_Stream7,
+	QAD_DMA2_Stream0,
+	QAD_DMA2_Stream1,
+	QAD_DMA2_Stream2,
+	QAD_DMA2_Stream3,
+	QAD_DMA2_Stream4,
+	QAD_DMA2_Stream5,
+	QAD_DMA2_Stream6,
+	QAD_DMA2_Stream7,
+	QAD_DMA_StreamNone
+};
+
+
+//-------------------
+//QAD_DMA_StreamCount
+//
+//DMA Stream Count
+const uint8_t QAD_DMA_StreamCount = QAD_DMA_StreamNone;
+
+
+//---------------
+//QAD_DMA_Request
+//
+//Used to select the peripheral request that a DMA stream is to service
+//Each request can only be serviced by specific stream/channel combinations, as per the DMA request mapping tables in RM0090
+enum QAD_DMA_Request : uint8_t {
+	QAD_DMA_Req_SPI1_RX = 0,
+	QAD_DMA_Req_SPI1_TX,
+	QAD_DMA_Req_SPI2_RX,
+	QAD_DMA_Req_SPI2_TX,
+	QAD_DMA_Req_SPI3_RX,
+	QAD_DMA_Req_SPI3_TX,
+	QAD_DMA_Req_I2S2_EXT_RX,
+	QAD_DMA_Req_I2S2_EXT_TX,
+	QAD_DMA_Req_I2S3_EXT_RX,
+	QAD_DMA_Req_I2S3_EXT_TX,
+
+	QAD_DMA_Req_I2C1_RX,
+	QAD_DMA_Req_I2C1_TX,
+	QAD_DMA_Req_I2C2_RX,
+	QAD_DMA_Req_I2C2_TX,
+	QAD_DMA_Req_I2C3_RX,
+	QAD_DMA_Req_I2C3_TX,
+
+	QAD_DMA_Req_USART1_RX,
+	QAD_DMA_Req_USART1_TX,
+	QAD_DMA_Req_USART2_RX,
+	QAD_DMA_Req_USART2_TX,
+	QAD_DMA_Req_USART3_RX,
+	QAD_DMA_Req_USART3_TX,
+	QAD_DMA_Req_UART4_RX,
+	QAD_DMA_Req_UART4_TX,
+	QAD_DMA_Req_UART5_RX,
+	QAD_DMA_Req_UART5_TX,
+	QAD_DMA_Req_USART6_RX,
+	QAD_DMA_Req_USART6_TX,
+
+	QAD_DMA_Req_ADC1,
+	QAD_DMA_Req_ADC2,
+	QAD_DMA_Req_ADC3,
+	QAD_DMA_Req_DAC1,
+	QAD_DMA_Req_DAC2,
+	QAD_DMA_Req_DCMI,
+	QAD_DMA_Req_SDIO,
+
+	QAD_DMA_Req_TIM1_UP,
+	QAD_DMA_Req_TIM1_CH1,
+	QAD_DMA_Req_TIM1_CH2,
+	QAD_DMA_Req_TIM1_CH3,
+	QAD_DMA_Req_TIM1_CH4,
+	QAD_DMA_Req_TIM1_TRIG,
+	QAD_DMA_Req_TIM1_COM,
+
+	QAD_DMA_Req_TIM2_UP,
+	QAD_DMA_Req_TIM2_CH1,
+	QAD_DMA_Req_TIM2_CH2,
+	QAD_DMA_Req_TIM2_CH3,
+	QAD_DMA_Req_TIM2_CH4,
+
+	QAD_DMA_Req_TIM3_UP,
+	QAD_DMA_Req_TIM3_CH1,
+	QAD_DMA_Req_TIM3_CH2,
+	QAD_DMA_Req_TIM3_CH3,
+	QAD_DMA_Req_TIM3_CH4,
+	QAD_DMA_Req_TIM3_TRIG,
+
+	QAD_DMA_Req_TIM4_UP,
+	QAD_DMA_Req_TIM4_CH1,
+	QAD_DMA_Req_TIM4_CH2,
+	QAD_DMA_Req_TIM4_CH3,
+
+	QAD_DMA_Req_TIM5_UP,
+	QAD_DMA_Req_TIM5_CH1,
+	QAD_DMA_Req_TIM5_CH2,
+	QAD_DMA_Req_TIM5_CH3,
+	QAD_DMA_Req_TIM5_CH4,
+	QAD_DMA_Req_TIM5_TRIG,
+
+	QAD_DMA_Req_TIM6_UP,
+	QAD_DMA_Req_TIM7_UP,
+
+	QAD_DMA_Req_TIM8_UP,
+	QAD_DMA_Req_TIM8_CH1,
+	QAD_DMA_Req_TIM8_CH2,
+	QAD_DMA_Req_TIM8_CH3,
+	QAD_DMA_Req_TIM8_CH4,
+	QAD_DMA_Req_TIM8_TRIG,
+	QAD_DMA_Req_TIM8_COM,
+
+	QAD_DMA_Req_MemToMem,      //Memory to memory transfers. Only supported by DMA2 streams
+	QAD_DMA_Req_None
+};
+
+
+//-------------
+//QAD_DMA_State
+//
+//Used to store whether a particular DMA stream is in use or not
+enum QAD_DMA_State : uint8_t {
+	QAD_DMA_Unused = 0,
+	QAD_DMA_InUse
+};
+
+
+//-------------
+//QAD_DMA_Event
+//
+//Used to select which DMA stream events are to trigger an interrupt, and to report which events have occurred
+//Values match the layout of the per-stream flag bits in the DMA LISR/HISR registers once shifted down to bit 0
+enum QAD_DMA_Event : uint8_t {
+	QAD_DMA_Event_FIFOError        = 0x01,  //FIFO overrun/underrun error
+	QAD_DMA_Event_DirectModeError  = 0x04,  //Direct mode error
+	QAD_DMA_Event_TransferError    = 0x08,  //Transfer error
+	QAD_DMA_Event_HalfTransfer     = 0x10,  //Half transfer complete
+	QAD_DMA_Event_TransferComplete = 0x20,  //Transfer complete
+	QAD_DMA_Event_All              = 0x3D   //All of the above events
+};
+
+
+//----------------------
+//QAD_DMA_ChannelInvalid
+//
+//Returned by QAD_DMAMgr::getChannel() if a request cannot be serviced by the selected stream
+const uint32_t QAD_DMA_ChannelInvalid = 0xFFFFFFFF;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------
+//QAD_DMA_Data
+//
+//Structure used in array within QAD_DMAMgr class to hold information for DMA streams
+typedef struct {
+
+	QAD_DMA_Stream       eStream;      //Used to store which DMA stream is represented by the structure
+
+	QAD_DMA_State        eState;       //Stores whether the DMA stream is currently in use
+
+	DMA_TypeDef*         pController;  //Stores the DMA_TypeDef for the DMA controller the stream belongs to (defined in stm32f407xx.h)
+	DMA_Stream_TypeDef*  pInstance;    //Stores the DMA_Stream_TypeDef for the DMA stream (defined in stm32f407xx.h)
+
+	IRQn_Type            eIRQ;         //Stores the IRQ Handler enum for the DMA stream (defined in stm32f407xx.h)
+
+	uint8_t              uFlagShift;   //Bit offset of the stream's flags within the LISR/HISR and LIFCR/HIFCR registers
+	uint8_t              uUsage;       //Number of peripheral requests that can be serviced by the stream. Used by findStream() to keep versatile streams free
+
+	QAD_IRQHandler_CallbackClass* pHandler;  //Driver that currently owns the stream. The handler() method is called with a pointer to the
+	                                         //stream's event flags (a uint8_t made up of QAD_DMA_Event values) when the stream's IRQ is triggered
+
+} QAD_DMA_Data;
+
+
+//---------------
+//QAD_DMA_Mapping
+//
+//Structure used in the request mapping table within QAD_DMAMgr.cpp
+typedef struct {
+
+	QAD_DMA_Request      eRequest;     //Peripheral request
+	QAD_DMA_Stream       eStream;      //DMA stream that can service the request
+	uint32_t             uChannel;     //Channel to be selected on the stream to service the request. DMA_CHANNEL_x define from stm32f4xx_hal_dma.h
+
+} QAD_DMA_Mapping;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//----------
+//QAD_DMAMgr
+//
+//Singleton class
+//Used to allow management of DMA streams in order to make sure that a driver is prevented from accessing any DMA
+//streams that are already being used by another driver, to find streams that can service a particular peripheral
+//request, and to route stream interrupts to the driver that owns the stream
+class QAD_DMAMgr {
+private:
+
+	//DMA Stream Data
+	QAD_DMA_Data  m_sStreams[QAD_DMA_StreamCount];
+
+	//------------
+	//Constructors
+	QAD_DMAMgr();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAD_DMAMgr(const QAD_DMAMgr& other) = delete;
+	QAD_DMAMgr& operator=(const QAD_DMAMgr& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAD_DMAMgr& get(void) {
+		static QAD_DMAMgr instance;
+		return instance;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Used to retrieve the current state of a DMA stream
+	//eStream - The DMA stream to retrieve the state for. Member of QAD_DMA_Stream
+	//Returns member of QAD_DMA_State enum
+	static QAD_DMA_State getState(QAD_DMA_Stream eStream) {
+		if (eStream >= QAD_DMA_StreamNone)
+			return QAD_DMA_InUse;
+		return get().m_sStreams[eStream].eState;
+	}
+
+	//Used to retrieve an instance for a DMA stream
+	//eStream - The DMA stream to retrieve the instance for. Member of QAD_DMA_Stream
+	//Returns DMA_Stream_TypeDef, as defined in stm32f407xx.h
+	static DMA_Stream_TypeDef* getInstance(QAD_DMA_Stream eStream) {
+		if (eStream >= QAD_DMA_StreamNone)
+			return NULL;
+		return get().m_sStreams[eStream].pInstance;
+	}
+
+	//Used to retrieve an IRQ enum for a DMA stream
+	//eStream - The DMA stream to retrieve the IRQ enum for. Member of QAD_DMA_Stream
+	//Returns member of IRQn_Type enum, as defined in stm32f407xx.h
+	static IRQn_Type getIRQ(QAD_DMA_Stream eStream) {
+		if (eStream >= QAD_DMA_StreamNone)
+			return UsageFault_IRQn;
+		return get().m_sStreams[eStream].eIRQ;
+	}
+
+	//Used to retrieve the channel that must be selected on a DMA stream for it to service a peripheral request
+	//eRequest - The peripheral request. Member of QAD_DMA_Request
+	//eStream  - The DMA stream. Member of QAD_DMA_Stream
+	//Returns a DMA_CHANNEL_x define from stm32f4xx_hal_dma.h, or QAD_DMA_ChannelInvalid if the stream cannot service the request
+	static uint32_t getChannel(QAD_DMA_Request eRequest, QAD_DMA_Stream eStream) {
+		return get().imp_getChannel(eRequest, eStream);
+	}
+
+
+	//------------------
+	//Management Methods
+
+	//Used to register a DMA stream as being used by a driver
+	//eStream  - The DMA stream to be registered. Member of QAD_DMA_Stream
+	//pHandler - The driver to which the stream's interrupts are to be routed
+	//Returns QA_OK if registration is successful, or returns QA_Error_PeriphBusy if the selected stream is already in use
+	static QA_Result registerStream(QAD_DMA_Stream eStream, QAD_IRQHandler_CallbackClass* pHandler) {
+		return get().imp_registerStream(eStream, pHandler);
+	}
+
+	//Used to deregister a DMA stream to mark it as no longer being used by a driver
+	//eStream - The DMA stream to be deregistered. Member of QAD_DMA_Stream
+	static void deregisterStream(QAD_DMA_Stream eStream) {
+		get().imp_deregisterStream(eStream);
+	}
+
+	//Used to find an available DMA stream that can service a peripheral request
+	//Streams are selected on a best-fit basis, so that streams which can service many different requests are kept free for as long as possible
+	//eRequest - The peripheral request. Member of QAD_DMA_Request
+	//Returns QAD_DMA_StreamNone if no available stream is found, or another member of QAD_DMA_Stream for the available stream that has been found
+	static QAD_DMA_Stream findStream(QAD_DMA_Request eRequest) {
+		return get().imp_findStream(eRequest);
+	}
+
+
+	//------------
+	//Flag Methods
+
+	//Used to read the current event flags of a DMA stream
+	//eStream - The DMA stream. Member of QAD_DMA_Stream
+	//Returns the event flags, made up of QAD_DMA_Event values
+	static uint8_t getFlags(QAD_DMA_Stream eStream) {
+		QAD_DMA_Data& sStream = get().m_sStreams[eStream];
+		uint32_t uISR = (eStream & 0x04) ? sStream.pController->HISR : sStream.pController->LISR;  //Streams 4 to 7 of each controller use the high registers
+		return (uISR >> sStream.uFlagShift) & QAD_DMA_Event_All;
+	}
+
+	//Used to clear event flags of a DMA stream
+	//eStream - The DMA stream. Member of QAD_DMA_Stream
+	//uFlags  - The event flags to be cleared, made up of QAD_DMA_Event values
+	static void clearFlags(QAD_DMA_Stream eStream, uint8_t uFlags) {
+		QAD_DMA_Data& sStream = get().m_sStreams[eStream];
+		if (eStream & 0x04)
+			sStream.pController->HIFCR = (uint32_t)(uFlags & QAD_DMA_Event_All) << sStream.uFlagShift;
+		else
+			sStream.pController->LIFCR = (uint32_t)(uFlags & QAD_DMA_Event_All) << sStream.uFlagShift;
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to route a DMA stream interrupt to the driver that owns the stream
+	//This method is only to be called by the interrupt request handler functions in handlers.cpp
+	//eStream - The DMA stream that has triggered the interrupt. Member of QAD_DMA_Stream
+	static void irqHandler(QAD_DMA_Stream eStream) {
+		get().imp_irqHandler(eStream);
+	}
+
+
+	//--------------
+	//Status Methods
+
+	//Returns the number of DMA streams that are currently in-use (registered/active)
+	static uint8_t getStreamsActive(void) {
+		return get().imp_getStreamsActive();
+	}
+
+	//Returns the number of DMA streams that are currently not being used (deregistered/inactive)
+	static uint8_t getStreamsInactive(void) {
+		return QAD_DMA_StreamCount - get().imp_getStreamsActive();
+	}
+
+
+private:
+
+	//NOTE: See QAD_DMAMgr.cpp for details of the following methods
+
+	//------------
+	//Data Methods
+
+	uint32_t imp_getChannel(QAD_DMA_Request eRequest, QAD_DMA_Stream eStream);
+
+
+	//------------------
+	//Management Methods
+
+	QA_Result imp_registerStream(QAD_DMA_Stream eStream, QAD_IRQHandler_CallbackClass* pHandler);
+	void imp_deregisterStream(QAD_DMA_Stream eStream);
+
+	QAD_DMA_Stream imp_findStream(QAD_DMA_Request eRequest);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void imp_irqHandler(QAD_DMA_Stream eStream);
+
+
+	//--------------
+	//Status Methods
+
+	uint8_t imp_getStreamsActive(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_DMAMGR_HPP_ */
@@ -0,0 +1,446 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Resource Management Driver                                      */
+/*   Filename: QAD_ResourceMgr.cpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_ResourceMgr.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //----------------------------
+  //----------------------------
+	//QAD_ResourceMgr Constructors
+
+//QAD_ResourceMgr::QAD_ResourceMgr
+//QAD_ResourceMgr Constructor
+//
+//Marks all resources as being free
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAD_ResourceMgr::QAD_ResourceMgr() {
+
+	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++)
+		m_strTimers[i] = NULL;
+
+	for (uint8_t i=0; i<QAD_UART_PeriphCount; i++)
+		m_strUARTs[i] = NULL;
+
+	for (uint8_t i=0; i<QAD_Resource_PinCount; i++)
+		m_strPins[i] = NULL;
+
+	for (uint8_t i=0; i<QAD_Resource_DMAStreamCount; i++)
+		m_strDMAStreams[i] = NULL;
+
+	for (uint8_t i=0; i<QAD_Resource_IRQCount; i++) {
+		m_strIRQs[i]    = NULL;
+		m_uIRQClaims[i] = 0;
+		m_bIRQShared[i] = false;
+	}
+
+	for (uint8_t i=0; i<QAD_Resource_EXTILineCount; i++)
+		m_strEXTILines[i] = NULL;
+
+	m_sConflict.eType     = QAD_Resource_None;
+	m_sConflict.uIndex    = 0;
+	m_sConflict.strOwner  = NULL;
+	m_sConflict.strHolder = NULL;
+}
+
+
+  //----------------------------
+  //----------------------------
+  //QAD_ResourceMgr Tool Methods
+
+//QAD_ResourceMgr::getPortIndex
+//QAD_ResourceMgr Tool Method
+//
+//Used to convert a GPIO port into an index (GPIOA = 0, GPIOB = 1, etc)
+//pGPIO - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+//Returns the index of the port, or QAD_Resource_InvalidIndex if the port is not recognized
+uint8_t QAD_ResourceMgr::getPortIndex(GPIO_TypeDef* pGPIO) {
+	uint32_t uAddr = (uint32_t)pGPIO;
+	if ((uAddr < GPIOA_BASE) || (uAddr > GPIOI_BASE) || ((uAddr - GPIOA_BASE) % (GPIOB_BASE - GPIOA_BASE)))
+		return QAD_Resource_InvalidIndex;
+	return (uint8_t)((uAddr - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE));
+}
+
+
+//QAD_ResourceMgr::getPinIndex
+//QAD_ResourceMgr Tool Method
+//
+//Used to convert a GPIO port and single pin into a resource index for use with QAD_Resource_Pin claims
+//pGPIO - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+//uPin  - The GPIO pin. A single member of GPIO_pins_define as defined in stm32f4xx_hal_gpio.h
+//Returns the resource index of the pin, or QAD_Resource_InvalidIndex if the port or pin is not recognized
+uint8_t QAD_ResourceMgr::getPinIndex(GPIO_TypeDef* pGPIO, uint16_t uPin) {
+	uint8_t uPort = getPortIndex(pGPIO);
+	if ((uPort == QAD_Resource_InvalidIndex) || (!uPin) || (uPin & (uPin - 1)))
+		return QAD_Resource_InvalidIndex;
+
+	uint8_t uPinNum = 0;
+	while (!(uPin & 0x01)) {
+		uPin >>= 1;
+		uPinNum++;
+	}
+	return (uPort * 16) + uPinNum;
+}
+
+
+//QAD_ResourceMgr::formatConflict
+//QAD_ResourceMgr Tool Method
+//
+//Used to produce a readable description of a conflict
+//Descriptions take the form of "DMA2 Stream 3 requested by SPI1 is held by PWM"
+//sConflict - The conflict to be described
+//pStr      - Pointer to character array to be filled
+//uSize     - Size of character array in bytes
+void QAD_ResourceMgr::formatConflict(const QAD_Resource_Conflict& sConflict, char* pStr, uint16_t uSize) {
+	if ((!pStr) || (!uSize))
+		return;
+
+	const char* strOwner  = sConflict.strOwner  ? sConflict.strOwner  : "Unknown";
+	const char* strHolder = sConflict.strHolder ? sConflict.strHolder : "Unknown";
+
+	switch (sConflict.eType) {
+		case (QAD_Resource_Timer):
+			snprintf(pStr, uSize, "Timer %u requested by %s is held by %s", sConflict.uIndex + 1, strOwner, strHolder);
+			break;
+		case (QAD_Resource_UART):
+			snprintf(pStr, uSize, "UART %u requested by %s is held by %s", sConflict.uIndex + 1, strOwner, strHolder);
+			break;
+		case (QAD_Resource_Pin):
+			snprintf(pStr, uSize, "Pin P%c%u requested by %s is held by %s", 'A' + (sConflict.uIndex / 16), sConflict.uIndex % 16, strOwner, strHolder);
+			break;
+		case (QAD_Resource_DMAStream):
+			snprintf(pStr, uSize, "DMA%u Stream %u requested by %s is held by %s", (sConflict.uIndex / 8) + 1, sConflict.uIndex % 8, strOwner, strHolder);
+			break;
+		case (QAD_Resource_IRQ):
+			snprintf(pStr, uSize, "IRQ %u requested by %s is held by %s", sConflict.uIndex, strOwner, strHolder);
+			break;
+		case (QAD_Resource_EXTILine):
+			snprintf(pStr, uSize, "EXTI line %u requested by %s is held by %s", sConflict.uIndex, strOwner, strHolder);
+			break;
+		case (QAD_Resource_None):
+			snprintf(pStr, uSize, "No resource conflict");
+			break;
+	}
+}
+
+
+//QAD_ResourceMgr::isHolder
+//QAD_ResourceMgr Tool Method
+//
+//Used to check if a resource is held by the driver or system releasing it
+//Names are compared by content, as the same name may be stored at different addresses by different translation units
+//strHolder - Name of the driver or system holding the resource. NULL if the resource is free
+//strOwner  - Name of the driver or system releasing the resource
+//Returns true if the names match
+bool QAD_ResourceMgr::isHolder(const char* strHolder, const char* strOwner) {
+	if ((!strHolder) || (!strOwner))
+		return false;
+	return (strHolder == strOwner) || (!strcmp(strHolder, strOwner));
+}
+
+
+  //----------------------------
+  //----------------------------
+  //QAD_ResourceMgr Data Methods
+
+//QAD_ResourceMgr::imp_getHolder
+//QAD_ResourceMgr Data Method
+//
+//To be called from static method getHolder()
+//Used to retrieve the name of the current holder of a resource
+//eType  - The class of resource. Member of QAD_Resource_Type
+//uIndex - The index of the resource
+//Returns the owner name string, or NULL if the resource is currently free or the index is invalid
+const char* QAD_ResourceMgr::imp_getHolder(QAD_Resource_Type eType, uint8_t uIndex) {
+	uint8_t uCount;
+	const char** pTable = imp_getTable(eType, uCount);
+	if ((!pTable) || (uIndex >= uCount))
+		return NULL;
+	return pTable[uIndex];
+}
+
+
+//QAD_ResourceMgr::imp_getTable
+//QAD_ResourceMgr Data Method
+//
+//Used to retrieve the ownership table for a class of resource
+//eType  - The class of resource. Member of QAD_Resource_Type
+//uCount - Returns the number of entries in the table
+//Returns a pointer to the ownership table, or NULL if eType is not valid
+const char** QAD_ResourceMgr::imp_getTable(QAD_Resource_Type eType, uint8_t& uCount) {
+	switch (eType) {
+		case (QAD_Resource_Timer):
+			uCount = QAD_Timer_PeriphCount;
+			return m_strTimers;
+		case (QAD_Resource_UART):
+			uCount = QAD_UART_PeriphCount;
+			return m_strUARTs;
+		case (QAD_Resource_Pin):
+			uCount = QAD_Resource_PinCount;
+			return m_strPins;
+		case (QAD_Resource_DMAStream):
+			uCount = QAD_Resource_DMAStreamCount;
+			return m_strDMAStreams;
+		case (QAD_Resource_IRQ):
+			uCount = QAD_Resource_IRQCount;
+			return m_strIRQs;
+		case (QAD_Resource_EXTILine):
+			uCount = QAD_Resource_EXTILineCount;
+			return m_strEXTILines;
+		case (QAD_Resource_None):
+			break;
+	}
+	uCount = 0;
+	return NULL;
+}
+
+
+  //----------------------------------
+  //----------------------------------
+  //QAD_ResourceMgr Management Methods
+
+//QAD_ResourceMgr::imp_claim
+//QAD_ResourceMgr Management Method
+//
+//To be called from static methods claim(), claimTimer(), claimUART() and claimIRQ()
+//Used to claim a single resource
+//If the claim fails, the details of the conflict are stored and can be retrieved with getLastConflict()
+//sClaim - Details of the claim to be made
+//Returns QA_OK if the claim is successful
+//        QA_Fail if the resource class or index is not valid
+//        QA_Error_PeriphBusy if the resource is already held
+QA_Result QAD_ResourceMgr::imp_claim(const QAD_Resource_Claim& sClaim) {
+	uint8_t uCount;
+	const char** pTable = imp_getTable(sClaim.eType, uCount);
+	if ((!pTable) || (sClaim.uIndex >= uCount))
+		return QA_Fail;
+
+	if (!imp_checkClaim(sClaim, m_sConflict))
+		return QA_Error_PeriphBusy;
+
+	if (sClaim.eType == QAD_Resource_IRQ) {
+		if (!m_uIRQClaims[sClaim.uIndex])
+			pTable[sClaim.uIndex] = sClaim.strOwner;
+		m_uIRQClaims[sClaim.uIndex]++;
+		m_bIRQShared[sClaim.uIndex] = sClaim.bShared;
+		return QA_OK;
+	}
+
+	pTable[sClaim.uIndex] = sClaim.strOwner;
+	return QA_OK;
+}
+
+
+//QAD_ResourceMgr::imp_release
+//QAD_ResourceMgr Management Method
+//
+//To be called from static method release()
+//Used to release a single resource
+//The resource is left held if it is not held by strOwner, so that a driver which failed to claim a resource (or has already released it)
+//can not release it from the driver that now holds it.
+//Shared interrupt lines only record the name of the first claim, so any shared claim may release one of the claims held on the line.
+//The line is only marked as free once all shared claims have been released
+//eType    - The class of resource. Member of QAD_Resource_Type
+//uIndex   - The index of the resource
+//strOwner - Name of the driver or system releasing the resource
+void QAD_ResourceMgr::imp_release(QAD_Resource_Type eType, uint8_t uIndex, const char* strOwner) {
+	uint8_t uCount;
+	const char** pTable = imp_getTable(eType, uCount);
+	if ((!pTable) || (uIndex >= uCount))
+		return;
+
+	if ((eType == QAD_Resource_IRQ) && (m_bIRQShared[uIndex])) {
+		if (m_uIRQClaims[uIndex])
+			m_uIRQClaims[uIndex]--;
+		if (m_uIRQClaims[uIndex])
+			return;
+		m_bIRQShared[uIndex] = false;
+		pTable[uIndex]       = NULL;
+		return;
+	}
+
+	if (!isHolder(pTable[uIndex], strOwner))
+		return;
+
+	if (eType == QAD_Resource_IRQ)
+		m_uIRQClaims[uIndex] = 0;
+	pTable[uIndex] = NULL;
+}
+
+
+//QAD_ResourceMgr::imp_claimPins
+//QAD_ResourceMgr Management Method
+//
+//To be called from static method claimPins()
+//Used to claim one or more GPIO pins on a single port
+//Either all pins are claimed, or none are claimed if a conflict occurs
+//pGPIO    - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+//uPins    - Bitmask of pins to be claimed
+//strOwner - Name of the driver or system making the claim
+//Returns QA_OK if the claim is successful
+//        QA_Fail if the port is not recognized
+//        QA_Error_PeriphBusy if any of the pins are already held
+QA_Result QAD_ResourceMgr::imp_claimPins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner) {
+	uint8_t uPort = getPortIndex(pGPIO);
+	if (uPort == QAD_Resource_InvalidIndex)
+		return QA_Fail;
+
+	//Check all pins before claiming any, so a failed claim leaves no pins held
+	for (uint8_t i=0; i<16; i++) {
+		if ((uPins & (1 << i)) && (m_strPins[(uPort * 16) + i])) {
+			m_sConflict.eType     = QAD_Resource_Pin;
+			m_sConflict.uIndex    = (uPort * 16) + i;
+			m_sConflict.strOwner  = strOwner;
+			m_sConflict.strHolder = m_strPins[(uPort * 16) + i];
+			return QA_Error_PeriphBusy;
+		}
+	}
+
+	for (uint8_t i=0; i<16; i++) {
+		if (uPins & (1 << i))
+			m_strPins[(uPort * 16) + i] = strOwner;
+	}
+	return QA_OK;
+}
+
+
+//QAD_ResourceMgr::imp_releasePins
+//QAD_ResourceMgr Management Method
+//
+//To be called from static method releasePins()
+//Used to release one or more GPIO pins on a single port
+//Only the pins held by strOwner are released, any pins held by other drivers are left claimed
+//pGPIO    - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+//uPins    - Bitmask of pins to be released
+//strOwner - Name of the driver or system releasing the pins
+void QAD_ResourceMgr::imp_releasePins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner) {
+	uint8_t uPort = getPortIndex(pGPIO);
+	if (uPort == QAD_Resource_InvalidIndex)
+		return;
+
+	for (uint8_t i=0; i<16; i++) {
+		if ((uPins & (1 << i)) && (isHolder(m_strPins[(uPort * 16) + i], strOwner)))
+			m_strPins[(uPort * 16) + i] = NULL;
+	}
+}
+
+
+//QAD_ResourceMgr::imp_dryRun
+//QAD_ResourceMgr Management Method
+//
+//To be called from static method dryRun()
+//Used to check a complete set of claims for conflicts without claiming anything
+//Each claim is checked against the resources currently held, and then against every earlier claim in the array
+//pClaims   - Pointer to an array of QAD_Resource_Claim structures
+//uCount    - Number of claims in the array
+//pConflict - Pointer to a QAD_Resource_Conflict structure to be filled with details of the first conflict found. Can be NULL
+//Returns QA_OK if no conflicts are found
+//        QA_Fail if any claim has an invalid resource class or index
+//        QA_Error_PeriphBusy if a conflict is found
+QA_Result QAD_ResourceMgr::imp_dryRun(const QAD_Resource_Claim* pClaims, uint16_t uCount, QAD_Resource_Conflict* pConflict) {
+	QAD_Resource_Conflict sConflict;
+
+	for (uint16_t i=0; i<uCount; i++) {
+		uint8_t uTableCount;
+		if ((!imp_getTable(pClaims[i].eType, uTableCount)) || (pClaims[i].uIndex >= uTableCount))
+			return QA_Fail;
+
+		//Check against currently held resources
+		if (!imp_checkClaim(pClaims[i], sConflict)) {
+			if (pConflict)
+				*pConflict = sConflict;
+			return QA_Error_PeriphBusy;
+		}
+
+		//Check against earlier claims within the configuration
+		for (uint16_t j=0; j<i; j++) {
+			if ((pClaims[j].eType != pClaims[i].eType) || (pClaims[j].uIndex != pClaims[i].uIndex))
+				continue;
+			if ((pClaims[i].eType == QAD_Resource_IRQ) && (pClaims[i].bShared) && (pClaims[j].bShared))
+				continue;
+
+			if (pConflict) {
+				pConflict->eType     = pClaims[i].eType;
+				pConflict->uIndex    = pClaims[i].uIndex;
+				pConflict->strOwner  = pClaims[i].strOwner;
+				pConflict->strHolder = pClaims[j].strOwner;
+			}
+			return QA_Error_PeriphBusy;
+		}
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_ResourceMgr::imp_checkClaim
+//QAD_ResourceMgr Management Method
+//
+//Used to check whether a claim can be made against the currently held resources
+//sClaim    - Details of the claim to be checked. Resource class and index must already have been validated
+//sConflict - Filled with details of the conflict if the claim cannot be made
+//Returns true if the claim can be made, or false if a conflict exists
+bool QAD_ResourceMgr::imp_checkClaim(const QAD_Resource_Claim& sClaim, QAD_Resource_Conflict& sConflict) {
+	uint8_t uCount;
+	const char** pTable = imp_getTable(sClaim.eType, uCount);
+
+	if (!pTable[sClaim.uIndex])
+		return true;
+
+	//Shared interrupt lines can be claimed multiple times, as long as every claim is a shared claim
+	if ((sClaim.eType == QAD_Resource_IRQ) && (sClaim.bShared) && (m_bIRQShared[sClaim.uIndex]))
+		return true;
+
+	sConflict.eType     = sClaim.eType;
+	sConflict.uIndex    = sClaim.uIndex;
+	sConflict.strOwner  = sClaim.strOwner;
+	sConflict.strHolder = pTable[sClaim.uIndex];
+	return false;
+}
+
+
+  //------------------------------
+  //------------------------------
+  //QAD_ResourceMgr Status Methods
+
+//QAD_ResourceMgr::imp_getClaimed
+//QAD_ResourceMgr Status Method
+//
+//To be called from static method getClaimed()
+//eType - The class of resource. Member of QAD_Resource_Type
+//Returns the number of resources of the selected class that are currently held
+uint8_t QAD_ResourceMgr::imp_getClaimed(QAD_Resource_Type eType) {
+	uint8_t uCount;
+	const char** pTable = imp_getTable(eType, uCount);
+	if (!pTable)
+		return 0;
+
+	uint8_t uClaimed = 0;
+	for (uint8_t i=0; i<uCount; i++) {
+		if (pTable[i])
+			uClaimed++;
+	}
+	return uClaimed;
+}
@@ -0,0 +1,304 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Resource Management Driver                                      */
+/*   Filename: QAD_ResourceMgr.hpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_RESOURCEMGR_HPP_
+#define __QAD_RESOURCEMGR_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAD_TimerMgr.hpp"
+#include "QAD_UARTMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------
+//QAD_Resource_Type
+//
+//Used to select which class of system resource is being claimed, released or reported in a conflict
+enum QAD_Resource_Type : uint8_t {
+	QAD_Resource_Timer = 0,    //Timer peripheral. Index is a member of QAD_Timer_Periph
+	QAD_Resource_UART,         //UART peripheral. Index is a member of QAD_UART_Periph
+	QAD_Resource_Pin,          //GPIO pin. Index is (Port * 16) + Pin Number, see QAD_ResourceMgr::getPinIndex()
+	QAD_Resource_DMAStream,    //DMA stream. Index is (Controller * 8) + Stream, where DMA1 is controller 0 and DMA2 is controller 1
+	QAD_Resource_IRQ,          //NVIC interrupt line. Index is a member of IRQn_Type (only device interrupts, 0 and upwards, are tracked)
+	QAD_Resource_EXTILine,     //EXTI line. Index is the line number, which is the pin number for GPIO pins (a line can only be used by one port)
+	QAD_Resource_None
+};
+
+
+//------------------------
+//Resource Count Constants
+//
+//Used to size the ownership tables within QAD_ResourceMgr
+const uint8_t QAD_Resource_PortCount      = 9;                       //GPIO ports A to I, as defined in stm32f407xx.h
+const uint8_t QAD_Resource_PinCount       = QAD_Resource_PortCount * 16;
+const uint8_t QAD_Resource_DMAStreamCount = 16;                      //Two DMA controllers with eight streams each
+const uint8_t QAD_Resource_IRQCount       = FPU_IRQn + 1;            //Number of device interrupt lines defined in stm32f407xx.h
+const uint8_t QAD_Resource_EXTILineCount  = 23;                      //EXTI lines 0 to 15 for GPIO pins, and lines 16 to 22 for internal events
+
+const uint8_t QAD_Resource_InvalidIndex   = 0xFF;                    //Returned by index helper methods when a resource cannot be identified
+
+
+//------------------
+//QAD_Resource_Claim
+//
+//Structure used to describe a single resource claim
+//An array of these structures is used to describe a complete board configuration, which can be checked with QAD_ResourceMgr::dryRun()
+typedef struct {
+
+	QAD_Resource_Type eType;      //Class of resource being claimed. Member of QAD_Resource_Type
+	uint8_t           uIndex;     //Index of resource being claimed (see QAD_Resource_Type for how the index is formed for each resource class)
+	bool              bShared;    //Only used for QAD_Resource_IRQ. Set to true if the interrupt line may be shared with other shared claims
+	                              //(for instance TIM1_UP_TIM10_IRQn, which is used by both Timer 1 and Timer 10)
+
+	const char*       strOwner;   //Name of the driver or system making the claim. Used to produce a readable conflict report
+
+} QAD_Resource_Claim;
+
+
+//---------------------
+//QAD_Resource_Conflict
+//
+//Structure used to report the details of a resource conflict
+typedef struct {
+
+	QAD_Resource_Type eType;      //Class of resource that is in conflict. QAD_Resource_None if no conflict has occurred
+	uint8_t           uIndex;     //Index of resource that is in conflict
+
+	const char*       strOwner;   //Name of the driver or system that attempted to claim the resource
+	const char*       strHolder;  //Name of the driver or system that currently holds the resource
+
+} QAD_Resource_Conflict;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------------
+//QAD_ResourceMgr
+//
+//Singleton class
+//Used to track ownership of Timers, UARTs, GPIO pins, DMA streams, NVIC interrupt lines and EXTI lines together, so that conflicts
+//between drivers can be detected and reported at the point a driver is initialized, rather than being found as misbehaving hardware
+//later on.
+//
+//Drivers claim every resource they need within their init() method, and release them within deinit(). If any claim fails the driver
+//returns QA_Error_PeriphBusy, and the details of the conflict can be retrieved with getLastConflict() or getConflictString().
+//
+//QAD_TimerMgr and QAD_UARTMgr still handle clocks and per-peripheral data. QAD_ResourceMgr adds ownership information on top of them,
+//and makes no HAL calls itself, so that a board configuration can also be checked with dryRun() in a host-side build.
+class QAD_ResourceMgr {
+private:
+
+	//Ownership Tables
+	//A NULL entry indicates that the resource is currently free
+	const char*  m_strTimers[QAD_Timer_PeriphCount];
+	const char*  m_strUARTs[QAD_UART_PeriphCount];
+	const char*  m_strPins[QAD_Resource_PinCount];
+	const char*  m_strDMAStreams[QAD_Resource_DMAStreamCount];
+	const char*  m_strIRQs[QAD_Resource_IRQCount];
+	const char*  m_strEXTILines[QAD_Resource_EXTILineCount];
+
+	uint8_t      m_uIRQClaims[QAD_Resource_IRQCount];  //Number of claims currently held on each interrupt line
+	bool         m_bIRQShared[QAD_Resource_IRQCount];  //Whether current claims on each interrupt line are shared claims
+
+	QAD_Resource_Conflict m_sConflict;                 //Details of the most recent conflict
+
+	//------------
+	//Constructors
+	QAD_ResourceMgr();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAD_ResourceMgr(const QAD_ResourceMgr& other) = delete;
+	QAD_ResourceMgr& operator=(const QAD_ResourceMgr& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAD_ResourceMgr& get(void) {
+		static QAD_ResourceMgr instance;
+		return instance;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Used to retrieve the name of the current holder of a resource
+	//eType  - The class of resource. Member of QAD_Resource_Type
+	//uIndex - The index of the resource
+	//Returns the owner name string, or NULL if the resource is currently free
+	static const char* getHolder(QAD_Resource_Type eType, uint8_t uIndex) {
+		return get().imp_getHolder(eType, uIndex);
+	}
+
+	//Used to retrieve the details of the most recent conflict
+	//Returns a reference to a QAD_Resource_Conflict structure. eType will be QAD_Resource_None if no conflict has occurred
+	static const QAD_Resource_Conflict& getLastConflict(void) {
+		return get().m_sConflict;
+	}
+
+	//Used to produce a readable description of the most recent conflict, suitable for transmission via QAS_Serial
+	//pStr  - Pointer to character array to be filled
+	//uSize - Size of character array in bytes
+	static void getConflictString(char* pStr, uint16_t uSize) {
+		formatConflict(get().m_sConflict, pStr, uSize);
+	}
+
+
+	//------------
+	//Tool Methods
+
+	//NOTE: See QAD_ResourceMgr.cpp for details of the following methods
+
+	static uint8_t getPortIndex(GPIO_TypeDef* pGPIO);
+	static uint8_t getPinIndex(GPIO_TypeDef* pGPIO, uint16_t uPin);
+	static void formatConflict(const QAD_Resource_Conflict& sConflict, char* pStr, uint16_t uSize);
+	static bool isHolder(const char* strHolder, const char* strOwner);
+
+
+	//------------------
+	//Management Methods
+
+	//Used to claim a single resource
+	//sClaim - Details of the claim to be made
+	//Returns QA_OK if the claim is successful, or QA_Error_PeriphBusy if the resource is already held
+	static QA_Result claim(const QAD_Resource_Claim& sClaim) {
+		return get().imp_claim(sClaim);
+	}
+
+	//Used to release a single resource
+	//The resource is only released if it is held by strOwner, so a driver can not release a resource claimed by another driver
+	//eType    - The class of resource. Member of QAD_Resource_Type
+	//uIndex   - The index of the resource
+	//strOwner - Name of the driver or system releasing the resource. Must match the name used to claim it
+	static void release(QAD_Resource_Type eType, uint8_t uIndex, const char* strOwner) {
+		get().imp_release(eType, uIndex, strOwner);
+	}
+
+	//Used to claim a Timer peripheral
+	//eTimer   - The Timer peripheral to be claimed. Member of QAD_Timer_Periph
+	//strOwner - Name of the driver or system making the claim
+	//Returns QA_OK if the claim is successful, or QA_Error_PeriphBusy if the Timer is already held
+	static QA_Result claimTimer(QAD_Timer_Periph eTimer, const char* strOwner) {
+		return get().imp_claim({QAD_Resource_Timer, eTimer, false, strOwner});
+	}
+
+	//Used to claim a UART peripheral
+	//eUART    - The UART peripheral to be claimed. Member of QAD_UART_Periph
+	//strOwner - Name of the driver or system making the claim
+	//Returns QA_OK if the claim is successful, or QA_Error_PeriphBusy if the UART is already held
+	static QA_Result claimUART(QAD_UART_Periph eUART, const char* strOwner) {
+		return get().imp_claim({QAD_Resource_UART, eUART, false, strOwner});
+	}
+
+	//Used to claim an NVIC interrupt line
+	//eIRQ     - The interrupt line to be claimed. Member of IRQn_Type as defined in stm32f407xx.h
+	//bShared  - Set to true if the interrupt line can be shared with other shared claims
+	//strOwner - Name of the driver or system making the claim
+	//Returns QA_OK if the claim is successful, or QA_Error_PeriphBusy if the interrupt line is already held
+	static QA_Result claimIRQ(IRQn_Type eIRQ, bool bShared, const char* strOwner) {
+		return get().imp_claim({QAD_Resource_IRQ, (uint8_t)eIRQ, bShared, strOwner});
+	}
+
+	//Used to claim one or more GPIO pins on a single port
+	//Either all pins are claimed, or none are claimed if a conflict occurs
+	//pGPIO    - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+	//uPins    - Bitmask of pins to be claimed. Made from members of GPIO_pins_define as defined in stm32f4xx_hal_gpio.h
+	//strOwner - Name of the driver or system making the claim
+	//Returns QA_OK if the claim is successful, or QA_Error_PeriphBusy if any of the pins are already held
+	static QA_Result claimPins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner) {
+		return get().imp_claimPins(pGPIO, uPins, strOwner);
+	}
+
+	//Used to release one or more GPIO pins on a single port
+	//Only the pins held by strOwner are released, any pins held by other drivers are left claimed
+	//pGPIO    - The GPIO port. A member of GPIO_TypeDef as defined in stm32f407xx.h
+	//uPins    - Bitmask of pins to be released
+	//strOwner - Name of the driver or system releasing the pins. Must match the name used to claim them
+	static void releasePins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner) {
+		get().imp_releasePins(pGPIO, uPins, strOwner);
+	}
+
+	//Used to check a complete set of claims (such as a full board configuration) for conflicts without claiming anything
+	//Claims are checked against both the resources currently held, and against each other
+	//pClaims   - Pointer to an array of QAD_Resource_Claim structures
+	//uCount    - Number of claims in the array
+	//pConflict - Pointer to a QAD_Resource_Conflict structure to be filled with details of the first conflict found. Can be NULL
+	//Returns QA_OK if no conflicts are found, or QA_Error_PeriphBusy if a conflict is found
+	static QA_Result dryRun(const QAD_Resource_Claim* pClaims, uint16_t uCount, QAD_Resource_Conflict* pConflict) {
+		return get().imp_dryRun(pClaims, uCount, pConflict);
+	}
+
+
+	//--------------
+	//Status Methods
+
+	//Returns the number of resources of a particular class that are currently held
+	//eType - The class of resource. Member of QAD_Resource_Type
+	static uint8_t getClaimed(QAD_Resource_Type eType) {
+		return get().imp_getClaimed(eType);
+	}
+
+
+private:
+
+	//NOTE: See QAD_ResourceMgr.cpp for details of the following methods
+
+	//------------
+	//Data Methods
+
+	const char* imp_getHolder(QAD_Resource_Type eType, uint8_t uIndex);
+	const char** imp_getTable(QAD_Resource_Type eType, uint8_t& uCount);
+
+
+	//------------------
+	//Management Methods
+
+	QA_Result imp_claim(const QAD_Resource_Claim& sClaim);
+	void imp_release(QAD_Resource_Type eType, uint8_t uIndex, const char* strOwner);
+
+	QA_Result imp_claimPins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner);
+	void imp_releasePins(GPIO_TypeDef* pGPIO, uint16_t uPins, const char* strOwner);
+
+	QA_Result imp_dryRun(const QAD_Resource_Claim* pClaims, uint16_t uCount, QAD_Resource_Conflict* pConflict);
+	bool imp_checkClaim(const QAD_Resource_Claim& sClaim, QAD_Resource_Conflict& sConflict);
+
+
+	//--------------
+	//Status Methods
+
+	uint8_t imp_getClaimed(QAD_Resource_Type eType);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_RESOURCEMGR_HPP_ */
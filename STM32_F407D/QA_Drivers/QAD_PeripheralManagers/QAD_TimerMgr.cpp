@@ -17,6 +17,7 @@
 
 //Includes
 #include "QAD_TimerMgr.hpp"
+#include "QAD_Timer.hpp"
 
 
 	//------------------------------------------
@@ -38,6 +39,7 @@ QAD_TimerMgr::QAD_TimerMgr() {
   for (uint8_t i=0; i < QAD_Timer_PeriphCount; i++) {
   	m_sTimers[i].eState   = QAD_Timer_Unused;
   	m_sTimers[i].bEncoder = (i <= QAD_Timer5) || (i == QAD_Timer8);
+  	m_sTimers[i].pDriver  = NULL;
   }
 
   //Set Timer Periph ID
@@ -75,8 +77,8 @@ QAD_TimerMgr::QAD_TimerMgr() {
 	//Set types
 	m_sTimers[QAD_Timer1].eType  = QAD_Timer_16bit;
 	m_sTimers[QAD_Timer2].eType  = QAD_Timer_32bit;
-	m_sTimers[QAD_Timer3].eType  = QAD_Timer_32bit;
-	m_sTimers[QAD_Timer4].eType  = QAD_Timer_32bit;
+	m_sTimers[QAD_Timer3].eType  = QAD_Timer_16bit;
+	m_sTimers[QAD_Timer4].eType  = QAD_Timer_16bit;
 	m_sTimers[QAD_Timer5].eType  = QAD_Timer_32bit;
 	m_sTimers[QAD_Timer6].eType  = QAD_Timer_16bit;
 	m_sTimers[QAD_Timer7].eType  = QAD_Timer_16bit;
@@ -152,6 +154,63 @@ QAD_TimerMgr::QAD_TimerMgr() {
 	m_sTimers[QAD_Timer13].bADC = false;
 	m_sTimers[QAD_Timer14].bADC = false;
 
+	//Set Advanced
+	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++)
+		m_sTimers[i].bAdvanced = (i == QAD_Timer1) || (i == QAD_Timer8);
+
+	//Set Trigger Outputs and clear link states
+	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++) {
+		m_sTimers[i].bTRGO        = (i <= QAD_Timer8);
+		m_sTimers[i].bLinkSlave   = false;
+		m_sTimers[i].uLinkMasters = 0;
+		m_sTimers[i].uLinkTrigger = 0;
+
+		for (uint8_t j=0; j<QAD_Timer_ITRCount; j++)
+			m_sTimers[i].eITR[j] = QAD_TimerNone;
+	}
+
+	//Set Internal Trigger Connections (see Timer internal trigger connection tables in RM0090)
+	//Timers 6, 7, 10, 11, 13 and 14 have no slave mode controller, so have no internal trigger connections
+	m_sTimers[QAD_Timer1].eITR[0]  = QAD_Timer5;
+	m_sTimers[QAD_Timer1].eITR[1]  = QAD_Timer2;
+	m_sTimers[QAD_Timer1].eITR[2]  = QAD_Timer3;
+	m_sTimers[QAD_Timer1].eITR[3]  = QAD_Timer4;
+
+	m_sTimers[QAD_Timer2].eITR[0]  = QAD_Timer1;
+	m_sTimers[QAD_Timer2].eITR[1]  = QAD_Timer8;
+	m_sTimers[QAD_Timer2].eITR[2]  = QAD_Timer3;
+	m_sTimers[QAD_Timer2].eITR[3]  = QAD_Timer4;
+
+	m_sTimers[QAD_Timer3].eITR[0]  = QAD_Timer1;
+	m_sTimers[QAD_Timer3].eITR[1]  = QAD_Timer2;
+	m_sTimers[QAD_Timer3].eITR[2]  = QAD_Timer5;
+	m_sTimers[QAD_Timer3].eITR[3]  = QAD_Timer4;
+
+	m_sTimers[QAD_Timer4].eITR[0]  = QAD_Timer1;
+	m_sTimers[QAD_Timer4].eITR[1]  = QAD_Timer2;
+	m_sTimers[QAD_Timer4].eITR[2]  = QAD_Timer3;
+	m_sTimers[QAD_Timer4].eITR[3]  = QAD_Timer8;
+
+	m_sTimers[QAD_Timer5].eITR[0]  = QAD_Timer2;
+	m_sTimers[QAD_Timer5].eITR[1]  = QAD_Timer3;
+	m_sTimers[QAD_Timer5].eITR[2]  = QAD_Timer4;
+	m_sTimers[QAD_Timer5].eITR[3]  = QAD_Timer8;
+
+	m_sTimers[QAD_Timer8].eITR[0]  = QAD_Timer1;
+	m_sTimers[QAD_Timer8].eITR[1]  = QAD_Timer2;
+	m_sTimers[QAD_Timer8].eITR[2]  = QAD_Timer4;
+	m_sTimers[QAD_Timer8].eITR[3]  = QAD_Timer5;
+
+	m_sTimers[QAD_Timer9].eITR[0]  = QAD_Timer2;
+	m_sTimers[QAD_Timer9].eITR[1]  = QAD_Timer3;
+	m_sTimers[QAD_Timer9].eITR[2]  = QAD_Timer10;
+	m_sTimers[QAD_Timer9].eITR[3]  = QAD_Timer11;
+
+	m_sTimers[QAD_Timer12].eITR[0] = QAD_Timer4;
+	m_sTimers[QAD_Timer12].eITR[1] = QAD_Timer5;
+	m_sTimers[QAD_Timer12].eITR[2] = QAD_Timer13;
+	m_sTimers[QAD_Timer12].eITR[3] = QAD_Timer14;
+
 }
 
 
@@ -170,6 +229,10 @@ QAD_TimerMgr::QAD_TimerMgr() {
 //         QAD_Timer_InUse_Encoder - Specifies timer as being used in rotary encoder mode
 //         QAD_Timer_InUse_PWM     - Specifies timer as being used to generate PWM signals
 //         QAD_Timer_InUse_ADC     - Specifies timer as being used to trigger ADC conversions
+//         QAD_Timer_InUse_InputCapture - Specifies timer as being used to capture input signal edges
+//         QAD_Timer_InUse_SoftPWM - Specifies timer as being used to drive software PWM of GPIO pins by DMA
+//         QAD_Timer_InUse_GPIOBus - Specifies timer as being used to pace DMA writes to a parallel GPIO bus
+//         QAD_Timer_InUse_LogicCapture - Specifies timer as being used to pace or count GPIO samples of a logic capture
 //Returns QA_OK if registration is successful.
 //        QA_Fail if eState is set to QAD_Timer_Unused.
 //        QA_Error_PeriphBusy if selected Timer is already in use
@@ -202,15 +265,23 @@ void QAD_TimerMgr::imp_deregisterTimer(QAD_Timer_Periph eTimer) {
 //To be called from static method findTimer()
 //Used to find an available timer with the selected counter type (16bit or 32bit)
 //If a 16bit counter type is selected, a 32bit timer can be returned due to 32bit timers having 16bit support
+//The available timer with the lowest scarcity value (see imp_getScarcity()) is returned. QAD_Timer_Reserved is skipped, as it is kept for QAS_SoftTimer
 //eType - A member of QAD_Timer_Type to select if a 16bit or 32bit counter is required
 //Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 QAD_Timer_Periph QAD_TimerMgr::imp_findTimer(QAD_Timer_Type eType) {
+	QAD_Timer_Periph eBest    = QAD_TimerNone;
+	uint8_t          uBestVal = 0xFF;
 
 	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++) {
-		if ((eType <= m_sTimers[i].eType) && (!m_sTimers[i].eState))
-			return m_sTimers[i].eTimer;
+		if ((eType <= m_sTimers[i].eType) && (!m_sTimers[i].eState) && (i != QAD_Timer_Reserved)) {
+			uint8_t uVal = imp_getScarcity(m_sTimers[i].eTimer, eType);
+			if (uVal < uBestVal) {
+				eBest    = m_sTimers[i].eTimer;
+				uBestVal = uVal;
+			}
+		}
 	}
-	return QAD_TimerNone;
+	return eBest;
 }
 
 
@@ -219,14 +290,22 @@ QAD_Timer_Periph QAD_TimerMgr::imp_findTimer(QAD_Timer_Type eType) {
 //
 //To be called from static method findTimerEncoder()
 //Used to find an available timer with rotary encoder support
+//The available timer with the lowest scarcity value (see imp_getScarcity()) is returned
 //Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 QAD_Timer_Periph QAD_TimerMgr::imp_findTimerEncoder(void) {
+	QAD_Timer_Periph eBest    = QAD_TimerNone;
+	uint8_t          uBestVal = 0xFF;
 
 	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++) {
-		if ((!m_sTimers[i].eState) && (m_sTimers[i].bEncoder))
-			return m_sTimers[i].eTimer;
+		if ((!m_sTimers[i].eState) && (m_sTimers[i].bEncoder)) {
+			uint8_t uVal = imp_getScarcity(m_sTimers[i].eTimer, QAD_Timer_16bit);
+			if (uVal < uBestVal) {
+				eBest    = m_sTimers[i].eTimer;
+				uBestVal = uVal;
+			}
+		}
 	}
-	return QAD_TimerNone;
+	return eBest;
 }
 
 
@@ -235,14 +314,130 @@ QAD_Timer_Periph QAD_TimerMgr::imp_findTimerEncoder(void) {
 //
 //To be called from static method findTimerADC()
 //Used to find an available timer with ADC conversion triggering support
+//The available timer with the lowest scarcity value (see imp_getScarcity()) is returned
 //Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 QAD_Timer_Periph QAD_TimerMgr::imp_findTimerADC(void) {
+	QAD_Timer_Periph eBest    = QAD_TimerNone;
+	uint8_t          uBestVal = 0xFF;
 
 	for (uint8_t i=0; i<QAD_Timer_PeriphCount; i++) {
-		if ((!m_sTimers[i].eState) && (m_sTimers[i].bADC))
-			return m_sTimers[i].eTimer;
+		if ((!m_sTimers[i].eState) && (m_sTimers[i].bADC)) {
+			uint8_t uVal = imp_getScarcity(m_sTimers[i].eTimer, QAD_Timer_16bit);
+			if (uVal < uBestVal) {
+				eBest    = m_sTimers[i].eTimer;
+				uBestVal = uVal;
+			}
+		}
+	}
+	return eBest;
+}
+
+
+//QAD_TimerMgr::imp_getScarcity
+//QAD_TimerMgr Management Method
+//
+//Used by the find methods to rank available timers, so that the timer returned has the fewest capabilities beyond those requested
+//Capabilities are weighted by how scarce they are on the F407, with advanced-control timers being the scarcest
+//eTimer - The Timer peripheral to be ranked. Member of QAD_Timer_Periph
+//eType  - The counter type that has been requested. A 32bit counter only adds to the value if a 16bit counter was requested
+//Returns the scarcity value, where lower values indicate a better fit
+uint8_t QAD_TimerMgr::imp_getScarcity(QAD_Timer_Periph eTimer, QAD_Timer_Type eType) {
+	uint8_t uVal = m_sTimers[eTimer].uChannels;
+
+	if (m_sTimers[eTimer].bAdvanced)
+		uVal += 64;
+	if (m_sTimers[eTimer].eType > eType)
+		uVal += 32;
+	if (m_sTimers[eTimer].bEncoder)
+		uVal += 16;
+	if (m_sTimers[eTimer].bADC)
+		uVal += 8;
+
+	return uVal;
+}
+
+
+//QAD_TimerMgr::imp_registerLink
+//QAD_TimerMgr Management Method
+//
+//To be called from static method registerLink()
+//Used to register a master/slave link between two Timer peripherals
+//A slave can only be linked to a single master. A master can be linked to multiple slaves, but as it only has a single trigger output
+//all of its links need to use the same master mode
+//eMaster  - The master Timer peripheral. Member of QAD_Timer_Periph
+//eSlave   - The slave Timer peripheral. Member of QAD_Timer_Periph
+//uTrigger - The master mode to be used for the trigger output of the master
+//Returns QA_OK if registration is successful
+//        QA_Error_PeriphNotSupported if the slave has no internal trigger input connected to the master
+//        QA_Error_PeriphBusy if the slave is already linked, or the master is already linked with a different master mode
+QA_Result QAD_TimerMgr::imp_registerLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave, uint8_t uTrigger) {
+	if (imp_getITR(eSlave, eMaster) == QAD_Timer_ITRNone)
+		return QA_Error_PeriphNotSupported;
+
+	if (m_sTimers[eSlave].bLinkSlave)
+		return QA_Error_PeriphBusy;
+
+	if ((m_sTimers[eMaster].uLinkMasters) && (m_sTimers[eMaster].uLinkTrigger != uTrigger))
+		return QA_Error_PeriphBusy;
+
+	m_sTimers[eSlave].bLinkSlave    = true;
+	m_sTimers[eMaster].uLinkTrigger = uTrigger;
+	m_sTimers[eMaster].uLinkMasters++;
+	return QA_OK;
+}
+
+
+//QAD_TimerMgr::imp_deregisterLink
+//QAD_TimerMgr Management Method
+//
+//To be called from static method deregisterLink()
+//Used to deregister a master/slave link between two Timer peripherals
+//eMaster - The master Timer peripheral. Member of QAD_Timer_Periph
+//eSlave  - The slave Timer peripheral. Member of QAD_Timer_Periph
+void QAD_TimerMgr::imp_deregisterLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave) {
+	m_sTimers[eSlave].bLinkSlave = false;
+
+	if (m_sTimers[eMaster].uLinkMasters)
+		m_sTimers[eMaster].uLinkMasters--;
+}
+
+
+//QAD_TimerMgr::imp_getITR
+//QAD_TimerMgr Management Method
+//
+//To be called from static method getITR()
+//Used to find which internal trigger input of a slave Timer peripheral is connected to a master Timer peripheral
+//eSlave  - The slave Timer peripheral. Member of QAD_Timer_Periph
+//eMaster - The master Timer peripheral. Member of QAD_Timer_Periph
+//Returns the internal trigger input (0 to 3 for ITR0 to ITR3), or QAD_Timer_ITRNone if the two timers are not connected
+uint8_t QAD_TimerMgr::imp_getITR(QAD_Timer_Periph eSlave, QAD_Timer_Periph eMaster) {
+	if ((eSlave >= QAD_TimerNone) || (eMaster >= QAD_TimerNone))
+		return QAD_Timer_ITRNone;
+
+	for (uint8_t i=0; i<QAD_Timer_ITRCount; i++) {
+		if (m_sTimers[eSlave].eITR[i] == eMaster)
+			return i;
 	}
-	return QAD_TimerNone;
+	return QAD_Timer_ITRNone;
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAD_TimerMgr IRQ Handler Methods
+
+//QAD_TimerMgr::imp_irqHandler
+//QAD_TimerMgr IRQ Handler Method
+//
+//To be called from static method irqHandler()
+//Calls the handler() method of the Timer driver registered for the Timer peripheral. If no driver is registered, for instance when the
+//owning driver has been removed with the interrupt still pending, the interrupt flags are cleared so that the interrupt does not repeat
+//eTimer - The Timer peripheral that has triggered the interrupt. Member of QAD_Timer_Periph
+void QAD_TimerMgr::imp_irqHandler(QAD_Timer_Periph eTimer) {
+	if (m_sTimers[eTimer].pDriver)
+		m_sTimers[eTimer].pDriver->handler();
+	else
+		m_sTimers[eTimer].pInstance->SR = 0;
 }
 
 
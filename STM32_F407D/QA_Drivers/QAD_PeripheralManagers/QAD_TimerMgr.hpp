@@ -67,7 +67,11 @@ enum QAD_Timer_State : uint8_t {
 	QAD_Timer_InUse_IRQ,
 	QAD_Timer_InUse_Encoder,
 	QAD_Timer_InUse_PWM,
-	QAD_Timer_InUse_ADC
+	QAD_Timer_InUse_ADC,
+	QAD_Timer_InUse_InputCapture,
+	QAD_Timer_InUse_SoftPWM,
+	QAD_Timer_InUse_GPIOBus,
+	QAD_Timer_InUse_LogicCapture
 };
 
 
@@ -78,6 +82,32 @@ enum QAD_Timer_State : uint8_t {
 enum QAD_Timer_Type : uint8_t {QAD_Timer_16bit = 0, QAD_Timer_32bit};
 
 
+//------------------
+//QAD_Timer_ITRCount
+//
+//Number of internal trigger inputs (ITR0 to ITR3) of a Timer peripheral's slave mode controller
+const uint8_t QAD_Timer_ITRCount = 4;
+
+
+//-----------------
+//QAD_Timer_ITRNone
+//
+//Returned by QAD_TimerMgr::getITR() when no internal trigger connection exists between two Timer peripherals
+const uint8_t QAD_Timer_ITRNone = 0xFF;
+
+
+//------------------
+//QAD_Timer_Reserved
+//
+//Timer peripheral reserved for QAS_SoftTimer, which uses it when no timer is selected. findTimer() does not return the reserved timer,
+//so that systems having a timer found for them do not take it, although it can still be used by selecting it directly
+const QAD_Timer_Periph QAD_Timer_Reserved = QAD_Timer7;
+
+
+//Forward declaration of the Timer driver class (see QAD_Timer.hpp), to which update interrupts are routed by irqHandler()
+class QAD_Timer;
+
+
 	//------------------------------------------
 	//------------------------------------------
 	//------------------------------------------
@@ -99,11 +129,23 @@ typedef struct {
 
 	bool              bEncoder;      //Stores whether the Timer peripheral has support for rotary encoder mode
 	bool              bADC;          //Stores whether the Timer peripheral has support for triggering ADC conversions
+	bool              bAdvanced;     //Stores whether the Timer peripheral is an advanced-control timer (complementary outputs, dead-time, break input and repetition counter)
+	bool              bTRGO;         //Stores whether the Timer peripheral has a trigger output (TRGO) that can be selected by its master mode
+
+	QAD_Timer_Periph  eITR[QAD_Timer_ITRCount]; //Stores the master Timer peripheral connected to each internal trigger input (ITR0 to ITR3), or QAD_TimerNone
+	                                            //if the input is not connected to a Timer peripheral. For Timers 9 and 12, the connection from Timers 10, 11,
+	                                            //13 and 14 is the OC1REF output of the master rather than TRGO
+
+	bool              bLinkSlave;    //Stores whether the Timer peripheral is currently a slave in a master/slave link
+	uint8_t           uLinkMasters;  //Stores the number of master/slave links for which the Timer peripheral is currently the master
+	uint8_t           uLinkTrigger;  //Stores the master mode currently selected for the trigger output, when uLinkMasters is non-zero
 
 	TIM_TypeDef*      pInstance;     //Stores the TIM_TypeDef for the Timer peripheral (defined in stm32f407xx.h)
 
 	IRQn_Type         eIRQ_Update;   //Stores the IRQ Handler enum for the Timer peripheral (defined in stm32f407xx.h)
 
+	QAD_Timer*        pDriver;       //Timer driver that currently owns the update interrupt, to which irqHandler() routes the interrupt, or NULL
+
 } QAD_Timer_Data;
 
 
@@ -191,6 +233,35 @@ public:
 		return get().m_sTimers[eTimer].bADC;
 	}
 
+	//Used to retrieve whether a particular Timer peripheral is an advanced-control timer
+	//eTimer - The Timer peripheral to retrieve the advanced-control support for. Member of QAD_Timer_Periph
+	//Returns true if the timer is an advanced-control timer (Timer 1 or Timer 8), or false otherwise
+	static bool getAdvanced(QAD_Timer_Periph eTimer) {
+		return get().m_sTimers[eTimer].bAdvanced;
+	}
+
+	//Used to retrieve whether a particular Timer peripheral has a trigger output (TRGO)
+	//eTimer - The Timer peripheral to retrieve the trigger output support for. Member of QAD_Timer_Periph
+	//Returns true if the timer has a trigger output, or false if not supported
+	static bool getTRGO(QAD_Timer_Periph eTimer) {
+		return get().m_sTimers[eTimer].bTRGO;
+	}
+
+	//Used to find which internal trigger input of a slave Timer peripheral is connected to a master Timer peripheral
+	//eSlave  - The slave Timer peripheral. Member of QAD_Timer_Periph
+	//eMaster - The master Timer peripheral. Member of QAD_Timer_Periph
+	//Returns the internal trigger input (0 to 3 for ITR0 to ITR3), or QAD_Timer_ITRNone if the two timers are not connected
+	static uint8_t getITR(QAD_Timer_Periph eSlave, QAD_Timer_Periph eMaster) {
+		return get().imp_getITR(eSlave, eMaster);
+	}
+
+	//Used to retrieve the number of master/slave links for which a Timer peripheral is currently the master
+	//eTimer - The Timer peripheral to retrieve the link count for. Member of QAD_Timer_Periph
+	//Returns the number of links
+	static uint8_t getLinkMasters(QAD_Timer_Periph eTimer) {
+		return get().m_sTimers[eTimer].uLinkMasters;
+	}
+
 	//Used to retrieve an instance for a Timer peripheral
 	//eTimer - The Timer peripheral to retrieve the instance for. Member of QAD_Timer_Periph
 	//Returns TIM_TypeDef, as defined in stm32f407xx.h
@@ -222,8 +293,28 @@ public:
 		get().imp_deregisterTimer(eTimer);
 	}
 
+	//Used to register a master/slave link between two Timer peripherals
+	//A slave can only be linked to a single master, whereas a master can be linked to multiple slaves as long as they all use the same trigger output
+	//eMaster  - The master Timer peripheral. Member of QAD_Timer_Periph
+	//eSlave   - The slave Timer peripheral. Member of QAD_Timer_Periph
+	//uTrigger - The master mode to be used for the trigger output of the master
+	//Returns QA_OK if registration is successful, QA_Error_PeriphNotSupported if the timers are not connected,
+	//or QA_Error_PeriphBusy if the slave is already linked or the master is linked using a different trigger output
+	static QA_Result registerLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave, uint8_t uTrigger) {
+		return get().imp_registerLink(eMaster, eSlave, uTrigger);
+	}
+
+	//Used to deregister a master/slave link between two Timer peripherals
+	//eMaster - The master Timer peripheral. Member of QAD_Timer_Periph
+	//eSlave  - The slave Timer peripheral. Member of QAD_Timer_Periph
+	static void deregisterLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave) {
+		get().imp_deregisterLink(eMaster, eSlave);
+	}
+
 	//Used to find an available timer with the selected counter type (16bit or 32bit)
 	//If a 16bit counter type is selected, a 32bit timer can be returned due to 32bit timers having 16bit support
+	//Timers are selected on a best-fit basis, so that scarcer timers (advanced-control, 32bit, encoder and ADC capable timers)
+	//are only returned once no simpler timer is available. QAD_Timer_Reserved is never returned
 	//eType - A member of QAD_Timer_Type to select if a 16bit or 32bit counter is required
 	//Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 	static QAD_Timer_Periph findTimer(QAD_Timer_Type eType) {
@@ -231,18 +322,39 @@ public:
 	}
 
 	//Used to find an available timer that has rotary encoder support
+	//Timers are selected on a best-fit basis, as per findTimer()
 	//Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 	static QAD_Timer_Periph findTimerEncoder(void) {
 		return get().imp_findTimerEncoder();
 	}
 
 	//Used to find an available timer that has ADC triggering support
+	//Timers are selected on a best-fit basis, as per findTimer()
 	//Returns QAD_TimerNone if no available timer is found, or another member of QAD_Timer_Periph for the available timer that has been found
 	static QAD_Timer_Periph findTimerADC(void) {
 		return get().imp_findTimerADC();
 	}
 
 
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to register the Timer driver to which a Timer peripheral's update interrupt is to be routed by irqHandler()
+	//eTimer  - The Timer peripheral. Member of QAD_Timer_Periph
+	//pDriver - The Timer driver, or NULL to deregister the current driver
+	static void registerDriver(QAD_Timer_Periph eTimer, QAD_Timer* pDriver) {
+		get().m_sTimers[eTimer].pDriver = pDriver;
+	}
+
+	//To be called from the IRQ handler function of a Timer peripheral in handlers.cpp
+	//Calls the handler() method of the Timer driver that has registered the Timer peripheral, or clears the interrupt flags
+	//if no driver is registered so that the interrupt does not repeat
+	//eTimer - The Timer peripheral that has triggered the interrupt. Member of QAD_Timer_Periph
+	static void irqHandler(QAD_Timer_Periph eTimer) {
+		get().imp_irqHandler(eTimer);
+	}
+
+
 	//-------------
 	//Clock Methods
 
@@ -287,6 +399,19 @@ private:
   QAD_Timer_Periph imp_findTimerEncoder(void);
   QAD_Timer_Periph imp_findTimerADC(void);
 
+  uint8_t imp_getScarcity(QAD_Timer_Periph eTimer, QAD_Timer_Type eType);
+
+  QA_Result imp_registerLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave, uint8_t uTrigger);
+  void imp_deregisterLink(QAD_Timer_Periph eMaster, QAD_Timer_Periph eSlave);
+
+  uint8_t imp_getITR(QAD_Timer_Periph eSlave, QAD_Timer_Periph eMaster);
+
+
+  //-------------------
+  //IRQ Handler Methods
+
+  void imp_irqHandler(QAD_Timer_Periph eTimer);
+
 
   //-------------
   //Clock Methods
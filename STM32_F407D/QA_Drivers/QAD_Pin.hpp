@@ -0,0 +1,293 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Compile-Time GPIO Pin Driver                                    */
+/*   Filename: QAD_Pin.hpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_PIN_HPP_
+#define __QAD_PIN_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <initializer_list>
+
+#include "QAD_GPIO.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------
+//QAD_Pin_Port
+//
+//Used to select the GPIO port of a QAD_Pin or QAD_PinGroup. Values are the base addresses of the ports, as defined in stm32f407xx.h
+enum QAD_Pin_Port : uint32_t {
+	QAD_Pin_PortA = GPIOA_BASE,
+	QAD_Pin_PortB = GPIOB_BASE,
+	QAD_Pin_PortC = GPIOC_BASE,
+	QAD_Pin_PortD = GPIOD_BASE,
+	QAD_Pin_PortE = GPIOE_BASE,
+	QAD_Pin_PortF = GPIOF_BASE,
+	QAD_Pin_PortG = GPIOG_BASE,
+	QAD_Pin_PortH = GPIOH_BASE,
+	QAD_Pin_PortI = GPIOI_BASE
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------
+//QAD_Pin
+//
+//Compile-time driver for a single GPIO pin (when pin is not connected to a specific internal peripheral)
+//
+//The port and pin are template parameters, so the register address and pin mask are constants and every method is static and inline.
+//on(), off() and set() compile to a single store to the port's BSRR register, and toggle() to a read of ODR followed by a single BSRR
+//store (which, unlike writing ODR, cannot change other pins of the port if an interrupt writes to them in between). The class holds
+//no data, so pins are normally used as types:
+//
+//  typedef QAD_Pin<QAD_Pin_PortD, 12> LED_Green;
+//  LED_Green::initOutput();
+//  LED_Green::toggle();
+//
+//Unlike QAD_GPIO_Output the pin is not set up by a constructor, and its mode, pull and speed settings are not stored; initOutput() or
+//initInput() must be called once before use. QAD_GPIO_Output and QAD_GPIO_Input remain available for pins that are chosen at runtime
+//ePort - GPIO port. Member of QAD_Pin_Port
+//uPin  - Pin number within the port (0 to 15)
+template <QAD_Pin_Port ePort, uint8_t uPin>
+class QAD_Pin {
+private:
+
+	static_assert(uPin < 16, "QAD_Pin: Pin number must be between 0 and 15");
+
+public:
+
+	static constexpr QAD_Pin_Port ePinPort = ePort;                      //GPIO port of the pin
+	static constexpr uint16_t     uMask    = (uint16_t)(1 << uPin);      //Mask of the pin within its port (matches GPIO_pins_define)
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to set up the pin in output mode
+	//eMode  - Push/pull or open drain mode. A member of QAD_GPIO_OutputMode as defined in QAD_GPIO.hpp
+	//ePull  - Pull-up/pull-down resistor setting. A member of QAD_GPIO_PullMode as defined in QAD_GPIO.hpp
+	//eSpeed - Pin speed. A member of QAD_GPIO_Speed as defined in QAD_GPIO.hpp
+	static void initOutput(QAD_GPIO_OutputMode eMode = QAD_GPIO_OutputMode_PushPull, QAD_GPIO_PullMode ePull = QAD_GPIO_PullMode_NoPull,
+	                       QAD_GPIO_Speed eSpeed = QAD_GPIO_Speed_Low) {
+		GPIO_InitTypeDef GPIO_Init = {0};
+		GPIO_Init.Pin    = uMask;
+		GPIO_Init.Mode   = eMode ? GPIO_MODE_OUTPUT_OD : GPIO_MODE_OUTPUT_PP;
+		GPIO_Init.Pull   = ePull;
+		GPIO_Init.Speed  = eSpeed;
+		HAL_GPIO_Init(gpio(), &GPIO_Init);
+	}
+
+	//Used to set up the pin in input mode
+	//ePull - Pull-up/pull-down resistor setting. A member of QAD_GPIO_PullMode as defined in QAD_GPIO.hpp
+	static void initInput(QAD_GPIO_PullMode ePull = QAD_GPIO_PullMode_NoPull) {
+		GPIO_InitTypeDef GPIO_Init = {0};
+		GPIO_Init.Pin    = uMask;
+		GPIO_Init.Mode   = GPIO_MODE_INPUT;
+		GPIO_Init.Pull   = ePull;
+		GPIO_Init.Speed  = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(gpio(), &GPIO_Init);
+	}
+
+	//Used to return the pin to its reset state
+	static void deinit(void) {
+		HAL_GPIO_DeInit(gpio(), uMask);
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to turn the pin on
+	static void on(void) {
+		gpio()->BSRR = uMask;
+	}
+
+	//Used to turn the pin off
+	static void off(void) {
+		gpio()->BSRR = (uint32_t)uMask << 16;
+	}
+
+	//Used to turn the pin on or off
+	//bState - true to turn the pin on, or false to turn it off
+	static void set(bool bState) {
+		gpio()->BSRR = (bState) ? (uint32_t)uMask : ((uint32_t)uMask << 16);
+	}
+
+	//Used to toggle the state of the pin, based on the state of its output register
+	static void toggle(void) {
+		uint32_t uODR = gpio()->ODR;
+		gpio()->BSRR  = ((uODR & uMask) << 16) | (~uODR & uMask);
+	}
+
+	//Returns the state the pin is being driven to (from the output register). Returns a member of QAD_GPIO_PinState (defined in QAD_GPIO.hpp)
+	static QAD_GPIO_PinState getState(void) {
+		return (gpio()->ODR & uMask) ? QAD_GPIO_PinState_On : QAD_GPIO_PinState_Off;
+	}
+
+	//Returns the level on the pin (from the input register). Returns a member of QAD_GPIO_PinState (defined in QAD_GPIO.hpp)
+	static QAD_GPIO_PinState read(void) {
+		return (gpio()->IDR & uMask) ? QAD_GPIO_PinState_On : QAD_GPIO_PinState_Off;
+	}
+
+	//Returns a pointer to the GPIO port registers of the pin
+	static GPIO_TypeDef* gpio(void) {
+		return reinterpret_cast<GPIO_TypeDef*>(ePort);
+	}
+
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//--------------------
+//QAD_PinGroup Helpers
+//
+//constexpr functions used by QAD_PinGroup to combine the details of its pins at compile time
+
+//Returns the combined mask of a list of pin masks
+constexpr uint16_t QAD_PinGroup_Mask(std::initializer_list<uint16_t> lMasks) {
+	uint16_t uMask = 0;
+	for (uint16_t uPinMask : lMasks)
+		uMask |= uPinMask;
+	return uMask;
+}
+
+//Returns the first port in a list of ports
+constexpr QAD_Pin_Port QAD_PinGroup_First(std::initializer_list<QAD_Pin_Port> lPorts) {
+	return *lPorts.begin();
+}
+
+//Returns true if all ports in a list of ports are the same
+constexpr bool QAD_PinGroup_SamePort(std::initializer_list<QAD_Pin_Port> lPorts) {
+	for (QAD_Pin_Port ePort : lPorts) {
+		if (ePort != *lPorts.begin())
+			return false;
+	}
+	return true;
+}
+
+
+//------------
+//QAD_PinGroup
+//
+//Compile-time driver for a group of QAD_Pin pins on the same GPIO port, allowing all of the pins to be changed or read in a single
+//register access. Compilation fails if the pins are not all on the same port
+//
+//  typedef QAD_PinGroup<QAD_Pin<QAD_Pin_PortD, 12>, QAD_Pin<QAD_Pin_PortD, 13>, QAD_Pin<QAD_Pin_PortD, 14>> LEDs;
+//  LEDs::initOutput();
+//  LEDs::write(GPIO_PIN_12 | GPIO_PIN_14);   //Pins 12 and 14 on, pin 13 off, in one BSRR store
+//
+//Values passed to and returned from write() and read() use the pins' own bit positions within the port (as with GPIO_pins_define), and
+//bits for pins outside of the group are ignored
+//Pins - QAD_Pin types of the pins in the group
+template <typename... Pins>
+class QAD_PinGroup {
+private:
+
+	static_assert(sizeof...(Pins) > 0, "QAD_PinGroup: At least one pin must be given");
+
+	static_assert(QAD_PinGroup_SamePort({Pins::ePinPort...}), "QAD_PinGroup: All pins must be on the same GPIO port");
+
+public:
+
+	static constexpr QAD_Pin_Port ePinPort = QAD_PinGroup_First({Pins::ePinPort...});  //GPIO port of the pins
+	static constexpr uint16_t     uMask    = QAD_PinGroup_Mask({Pins::uMask...});      //Combined mask of the pins within their port
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to set up all of the pins in output mode. See QAD_Pin::initOutput() for details
+	static void initOutput(QAD_GPIO_OutputMode eMode = QAD_GPIO_OutputMode_PushPull, QAD_GPIO_PullMode ePull = QAD_GPIO_PullMode_NoPull,
+	                       QAD_GPIO_Speed eSpeed = QAD_GPIO_Speed_Low) {
+		GPIO_InitTypeDef GPIO_Init = {0};
+		GPIO_Init.Pin    = uMask;
+		GPIO_Init.Mode   = eMode ? GPIO_MODE_OUTPUT_OD : GPIO_MODE_OUTPUT_PP;
+		GPIO_Init.Pull   = ePull;
+		GPIO_Init.Speed  = eSpeed;
+		HAL_GPIO_Init(gpio(), &GPIO_Init);
+	}
+
+	//Used to set up all of the pins in input mode. See QAD_Pin::initInput() for details
+	static void initInput(QAD_GPIO_PullMode ePull = QAD_GPIO_PullMode_NoPull) {
+		GPIO_InitTypeDef GPIO_Init = {0};
+		GPIO_Init.Pin    = uMask;
+		GPIO_Init.Mode   = GPIO_MODE_INPUT;
+		GPIO_Init.Pull   = ePull;
+		GPIO_Init.Speed  = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(gpio(), &GPIO_Init);
+	}
+
+	//Used to return all of the pins to their reset state
+	static void deinit(void) {
+		HAL_GPIO_DeInit(gpio(), uMask);
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to turn all of the pins on
+	static void on(void) {
+		gpio()->BSRR = uMask;
+	}
+
+	//Used to turn all of the pins off
+	static void off(void) {
+		gpio()->BSRR = (uint32_t)uMask << 16;
+	}
+
+	//Used to toggle the state of all of the pins
+	static void toggle(void) {
+		uint32_t uODR = gpio()->ODR;
+		gpio()->BSRR  = ((uODR & uMask) << 16) | (~uODR & uMask);
+	}
+
+	//Used to set the state of all of the pins in a single store
+	//uValue - New pin states, with each pin at its own bit position within the port. Bits for pins outside of the group are ignored
+	static void write(uint16_t uValue) {
+		gpio()->BSRR = ((uint32_t)(~uValue & uMask) << 16) | (uValue & uMask);
+	}
+
+	//Returns the levels on the pins (from the input register), with each pin at its own bit position within the port
+	static uint16_t read(void) {
+		return (uint16_t)(gpio()->IDR & uMask);
+	}
+
+	//Returns a pointer to the GPIO port registers of the pins
+	static GPIO_TypeDef* gpio(void) {
+		return reinterpret_cast<GPIO_TypeDef*>(ePinPort);
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_PIN_HPP_ */
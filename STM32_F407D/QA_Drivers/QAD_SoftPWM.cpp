@@ -0,0 +1,369 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Software PWM Driver                                             */
+/*   Filename: QAD_SoftPWM.cpp                                             */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_SoftPWM.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //----------------------------------
+  //----------------------------------
+  //QAD_SoftPWM Initialization Methods
+
+//QAD_SoftPWM::init
+//QAD_SoftPWM Initialization Method
+//
+//Used to initialize the software PWM driver
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_SoftPWM::init(void) {
+
+	//Check that the selected timer is able to trigger DMA2 requests, and that the slot lengths fit within the timer's counter
+	if (!QAD_TimerMgr::getAdvanced(m_eTimer))
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_uTick < 2) || (((uint32_t)m_uTick << (m_cBCM.getBits() - 1)) > 65536))
+		return QA_Error_PeriphNotSupported;
+
+	bool bPorts = false;
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO)
+			bPorts = true;
+	}
+	if (!bPorts)
+		return QA_Fail;
+
+	//Check if selected Timer peripheral is currently available
+	if (QAD_TimerMgr::getState(m_eTimer))
+		return QA_Error_PeriphBusy;
+
+	//Claim Timer peripheral and GPIO pins (details of any conflict can be retrieved from QAD_ResourceMgr)
+	if (claimResources())
+		return QA_Error_PeriphBusy;
+
+	//Register Timer peripheral as now being in use
+	QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_SoftPWM);
+
+	//Initialize the Timer peripheral, GPIO pins and DMA streams
+	QA_Result eRes = periphInit();
+
+	//If initialization failed then deregister the Timer peripheral and release resources
+	if (eRes) {
+		QAD_TimerMgr::deregisterTimer(m_eTimer);
+		releaseResources();
+	}
+
+	//Return initialization result
+	return eRes;
+}
+
+
+//QAD_SoftPWM::deinit
+//QAD_SoftPWM Initialization Method
+//
+//Used to deinitialize the software PWM driver
+void QAD_SoftPWM::deinit(void) {
+
+	//Return if driver is not currently initialized
+	if (!m_eInitState)
+		return;
+
+	//Deinitialize driver
+	periphDeinit(DeinitFull);
+
+	//Deregister Timer peripheral and release resources
+	QAD_TimerMgr::deregisterTimer(m_eTimer);
+	releaseResources();
+}
+
+
+  //---------------------------
+  //---------------------------
+  //QAD_SoftPWM Control Methods
+
+//QAD_SoftPWM::start
+//QAD_SoftPWM Control Method
+//
+//Used to start the software PWM driver
+//
+//The auto-reload register is preloaded, so the value written by the update DMA request at the start of a slot takes effect at the start of
+//the following slot. Slot 0 and slot 1 lengths are therefore written before the timer is started, and the update DMA table starts at slot 2.
+//The capture/compare channels match at a count of 1, one count into each slot, so every GPIO write is delayed by the same amount and the
+//first write (slot 0) takes place once the counter has started
+void QAD_SoftPWM::start(void) {
+
+	//Check if driver is initialized and is currently not active
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+	uint8_t      uBits     = m_cBCM.getBits();
+
+	//Build table of auto-reload values, starting from slot 2
+	for (uint8_t i=0; i<uBits; i++)
+		m_uARR[i] = ((uint32_t)m_uTick << ((i + 2) % uBits)) - 1;
+
+	//Load slot 0 length into the active auto-reload register, followed by slot 1 length into the preload register
+	pInstance->CNT = 0;
+	pInstance->ARR = ((uint32_t)m_uTick << 0) - 1;
+	pInstance->EGR = TIM_EGR_UG;
+	pInstance->SR  = 0;
+	pInstance->ARR = ((uint32_t)m_uTick << (1 % uBits)) - 1;
+
+	//Start DMA streams and enable DMA requests
+	uint32_t uDIER = TIM_DIER_UDE;
+	m_pARRDMA->start((uint32_t)m_uARR, uBits);
+
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_pPortDMA[i]) {
+			m_pPortDMA[i]->start((uint32_t)m_cBCM.getTable(i), uBits);
+			uDIER |= (TIM_DIER_CC1DE << i);
+		}
+	}
+	pInstance->DIER |= uDIER;
+
+	//Enable timer
+	pInstance->CR1 |= TIM_CR1_CEN;
+
+	m_eState = QA_Active;
+}
+
+
+//QAD_SoftPWM::stop
+//QAD_SoftPWM Control Method
+//
+//Used to stop the software PWM driver. All pins are set low
+void QAD_SoftPWM::stop(void) {
+
+	//Check if driver is initialized and is currently active
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+
+	pInstance->CR1  &= ~TIM_CR1_CEN;
+	pInstance->DIER &= ~(TIM_DIER_UDE | TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC3DE);
+
+	m_pARRDMA->stop();
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_pPortDMA[i]) {
+			m_pPortDMA[i]->stop();
+			m_sPorts[i].pGPIO->BSRR = (uint32_t)m_sPorts[i].uPins << 16;
+		}
+	}
+
+	m_eState = QA_Inactive;
+}
+
+
+//QAD_SoftPWM::getState
+//QAD_SoftPWM Control Method
+//
+//Returns whether the driver is currently active. Member of QA_ActiveState as defined in setup.hpp
+QA_ActiveState QAD_SoftPWM::getState(void) {
+	return m_eState;
+}
+
+
+  //------------------------------------------
+  //------------------------------------------
+  //QAD_SoftPWM Private Initialization Methods
+
+//QAD_SoftPWM::periphInit
+//QAD_SoftPWM Private Initialization Method
+//
+//Used to initialize the GPIO pins, timer peripheral clock, the timer peripheral itself and the DMA drivers
+//In the case of a failed initialization, a partial deinitialization will be performed
+//Returns QA_OK if successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+QA_Result QAD_SoftPWM::periphInit(void) {
+
+	//Init GPIOs as outputs, initially low
+	GPIO_InitTypeDef GPIO_Init = {0};
+	GPIO_Init.Mode  = GPIO_MODE_OUTPUT_PP;   //Set pins to Output - Push/Pull mode
+	GPIO_Init.Pull  = GPIO_NOPULL;           //Disable pull-up and pull-down resistors
+	GPIO_Init.Speed = GPIO_SPEED_FREQ_LOW;   //Slot lengths are long compared to the pin's rise time, so the lowest speed is used to limit noise
+
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO) {
+			m_sPorts[i].pGPIO->BSRR = (uint32_t)m_sPorts[i].uPins << 16;
+			GPIO_Init.Pin = m_sPorts[i].uPins;
+			HAL_GPIO_Init(m_sPorts[i].pGPIO, &GPIO_Init);
+
+			m_cBCM.setPort(i, m_sPorts[i].uPins);
+		}
+	}
+
+	//Enable Timer Clock
+	QAD_TimerMgr::enableClock(m_eTimer);
+
+	//Init Timer
+	m_sHandle.Instance               = QAD_TimerMgr::getInstance(m_eTimer); //Set instance for required Timer peripheral
+	m_sHandle.Init.Prescaler         = m_uPrescaler;                        //Set timer prescaler
+	m_sHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;                  //Set timer counter mode to count up
+	m_sHandle.Init.Period            = m_uTick - 1;                         //Set timer period to the length of slot 0
+	m_sHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;              //Unused
+	m_sHandle.Init.RepetitionCounter = 0x0;                                 //
+	m_sHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;       //Enable preload of the timer's auto-reload register, so slot lengths change on update events
+
+	if (HAL_TIM_Base_Init(&m_sHandle) != HAL_OK) {
+		periphDeinit(DeinitPartial);
+		return QA_Fail;
+	}
+
+	//Create DMA driver for auto-reload values
+	QAD_DMA_Request eUpdate = (m_eTimer == QAD_Timer1) ? QAD_DMA_Req_TIM1_UP  : QAD_DMA_Req_TIM8_UP;
+	QAD_DMA_Request eCC1    = (m_eTimer == QAD_Timer1) ? QAD_DMA_Req_TIM1_CH1 : QAD_DMA_Req_TIM8_CH1;
+
+	QA_Result eRes = initDMA(m_pARRDMA, eUpdate, (uint32_t)&m_sHandle.Instance->ARR);
+	if (eRes) {
+		periphDeinit(DeinitPartial);
+		return eRes;
+	}
+
+	//Create DMA drivers for GPIO ports. Each port uses its own capture/compare channel (which is left in frozen mode, so has no output),
+	//matching at a count of 1
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO) {
+			(&m_sHandle.Instance->CCR1)[i] = 1;
+
+			eRes = initDMA(m_pPortDMA[i], (QAD_DMA_Request)(eCC1 + i), (uint32_t)&m_sPorts[i].pGPIO->BSRR);
+			if (eRes) {
+				periphDeinit(DeinitPartial);
+				return eRes;
+			}
+		}
+	}
+
+	//Set Driver States
+	m_eInitState = QA_Initialized; //Set driver state as initialized
+	m_eState     = QA_Inactive;    //Set driver as currently inactive
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_SoftPWM::periphDeinit
+//QAD_SoftPWM Private Initialization Method
+//
+//Used to deinitialize the DMA drivers, the timer peripheral clock, the timer peripheral itself and the GPIO pins
+//eDeinitMode - Set to DeinitPartial to perform a partial deinitialization (only to be used by periphInit() method
+//              in a case where peripheral initialization has failed
+//            - Set to DeinitFull to perform a full deinitialization in a case where the driver is fully initialized
+void QAD_SoftPWM::periphDeinit(QAD_SoftPWM::DeinitMode eDeinitMode) {
+
+	//Remove DMA drivers (the DMA drivers deinitialize themselves upon destruction)
+	m_pARRDMA.reset();
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++)
+		m_pPortDMA[i].reset();
+
+	//Deinitialize Timer peripheral and disable its clock
+	HAL_TIM_Base_DeInit(&m_sHandle);
+	QAD_TimerMgr::disableClock(m_eTimer);
+
+	//Deinitialize GPIOs
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO) {
+			HAL_GPIO_DeInit(m_sPorts[i].pGPIO, m_sPorts[i].uPins);
+			m_cBCM.setPort(i, 0);
+		}
+	}
+
+	//Set Driver States
+	m_eState     = QA_Inactive;        //Set driver as currently inactive
+	m_eInitState = QA_NotInitialized;  //Set driver state as not initialized
+}
+
+
+//QAD_SoftPWM::claimResources
+//QAD_SoftPWM Private Initialization Method
+//
+//Used to claim the Timer peripheral and the GPIO pins of all used ports from QAD_ResourceMgr
+//The DMA streams are claimed separately by the QAD_DMA drivers
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_SoftPWM::claimResources(void) {
+	if (QAD_ResourceMgr::claimTimer(m_eTimer, "SoftPWM"))
+		return QA_Error_PeriphBusy;
+
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO) {
+			if (QAD_ResourceMgr::claimPins(m_sPorts[i].pGPIO, m_sPorts[i].uPins, "SoftPWM")) {
+
+				//Release any pins already claimed, along with the Timer peripheral
+				for (uint8_t j=0; j<i; j++) {
+					if (m_sPorts[j].pGPIO)
+						QAD_ResourceMgr::releasePins(m_sPorts[j].pGPIO, m_sPorts[j].uPins, "SoftPWM");
+				}
+				QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "SoftPWM");
+				return QA_Error_PeriphBusy;
+			}
+		}
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_SoftPWM::releaseResources
+//QAD_SoftPWM Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_SoftPWM::releaseResources(void) {
+	for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++) {
+		if (m_sPorts[i].pGPIO)
+			QAD_ResourceMgr::releasePins(m_sPorts[i].pGPIO, m_sPorts[i].uPins, "SoftPWM");
+	}
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "SoftPWM");
+}
+
+
+//QAD_SoftPWM::initDMA
+//QAD_SoftPWM Private Initialization Method
+//
+//Used to create and initialize a DMA driver transferring a circular table of 32bit words from memory to a register
+//pDMA        - Reference to the pointer to receive the DMA driver
+//eRequest    - DMA request to be serviced. Member of QAD_DMA_Request as defined in QAD_DMAMgr.hpp
+//uPeriphAddr - Address of the register to be written
+//Returns QA_OK if successful, or an error from the DMA driver if the DMA stream could not be initialized
+QA_Result QAD_SoftPWM::initDMA(std::unique_ptr<QAD_DMA>& pDMA, QAD_DMA_Request eRequest, uint32_t uPeriphAddr) {
+	QAD_DMA_InitStruct sDMAInit;
+	sDMAInit.eRequest     = eRequest;
+	sDMAInit.eStream      = QAD_DMA_StreamNone;
+	sDMAInit.eDirection   = QAD_DMA_MemToPeriph;
+	sDMAInit.eMode        = QAD_DMA_Circular;
+	sDMAInit.ePriority    = QAD_DMA_PriorityVeryHigh;
+	sDMAInit.uPeriphAddr  = uPeriphAddr;
+	sDMAInit.ePeriphWidth = QAD_DMA_Width32;
+	sDMAInit.bPeriphInc   = false;
+	sDMAInit.eMemWidth    = QAD_DMA_Width32;
+	sDMAInit.bMemInc      = true;
+	sDMAInit.eFIFO        = QAD_DMA_FIFODirect;
+	sDMAInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sDMAInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sDMAInit.uEvents      = 0;
+	sDMAInit.uIRQPriority = 0;
+
+	pDMA = std::make_unique<QAD_DMA>(sDMAInit);
+	QA_Result eRes = pDMA->init();
+	if (eRes)
+		pDMA.reset();
+
+	return eRes;
+}
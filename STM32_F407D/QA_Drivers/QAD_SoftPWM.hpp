@@ -0,0 +1,209 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Software PWM Driver                                             */
+/*   Filename: QAD_SoftPWM.hpp                                             */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_SOFTPWM_HPP_
+#define __QAD_SOFTPWM_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_DMA.hpp"
+#include "QAT_BCM.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------------
+//QAD_SoftPWM_PortStruct
+//
+//This structure is used to select the GPIO pins of a single GPIO port to be driven by the QAD_SoftPWM driver
+typedef struct {
+
+	GPIO_TypeDef* pGPIO;   //GPIO port to be used. Set to NULL if the port is not used
+	uint16_t      uPins;   //Pins of the GPIO port to be used (a combination of GPIO_PIN_x values)
+
+} QAD_SoftPWM_PortStruct;
+
+
+//----------------------
+//QAD_SoftPWM_InitStruct
+//
+//This structure is used to be able to create the QAD_SoftPWM driver class
+typedef struct {
+
+	QAD_Timer_Periph       eTimer;      //Timer peripheral to be used. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	                                    //Must be Timer 1 or Timer 8, as only these have DMA requests on DMA2, which is able to write to GPIO ports
+
+	uint32_t               uPrescaler;  //Prescaler to be used for the selected timer
+	uint16_t               uTick;       //Length of the shortest slot (the least significant bit of the duty), in timer counts. Must be at least 2
+	                                    //The longest slot lasts uTick * 2^(uBits-1) timer counts, which must not be more than 65536
+	uint8_t                uBits;       //Duty resolution in bits (1 to QAT_BCM_MaxBits as defined in QAT_BCM.hpp)
+
+	QAD_SoftPWM_PortStruct sPorts[QAT_BCM_MaxPorts];  //GPIO ports and pins to be driven
+
+} QAD_SoftPWM_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-----------
+//QAD_SoftPWM
+//
+//Driver class for dimming large numbers of GPIO pins (up to 16 pins on each of up to three GPIO ports) using binary code modulation
+//
+//Each output cycle is split into uBits slots, with slot k lasting uTick * 2^k timer counts (see QAT_BCM.hpp). At the start of each slot,
+//a capture/compare DMA request of the timer writes the slot's value from a table into the BSRR register of each GPIO port, and an update
+//DMA request writes the length of a following slot into the timer's auto-reload register. The cycle frequency is
+//timer clock / ((prescaler+1) * uTick * (2^uBits - 1)).
+//
+//There are only uBits DMA transfers per port per cycle, and no interrupts. The tables are only changed by setDuty(), which takes the same
+//time regardless of the number of pins, so the CPU load does not depend on the number of channels.
+//
+//Channels are numbered (port index * 16) + pin number, where the port index is the index into sPorts of the initialization structure
+class QAD_SoftPWM {
+private:
+
+	//Deinitialization mode to be used by periphDeinit() method
+	enum DeinitMode : uint8_t {
+		DeinitPartial = 0,    //Only to be used for partial deinitialization upon initialization failure in periphInit() method
+		DeinitFull            //Used for full driver deinitialization when driver is in a fully initialized state
+	};
+
+	QAD_Timer_Periph         m_eTimer;                         //Timer peripheral to be used
+	uint32_t                 m_uPrescaler;                     //Prescaler to be used for the selected timer
+	uint16_t                 m_uTick;                          //Length of the shortest slot in timer counts
+
+	QAD_SoftPWM_PortStruct   m_sPorts[QAT_BCM_MaxPorts];       //GPIO ports and pins to be driven
+
+	TIM_HandleTypeDef        m_sHandle;                        //Handle used by HAL functions to access Timer peripheral (defined in stm32f4xx_hal_tim.h)
+
+	QA_InitState             m_eInitState;                     //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState           m_eState;                         //Stores whether the driver is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAT_BCM                  m_cBCM;                           //Bit-plane tables
+	uint32_t                 m_uARR[QAT_BCM_MaxBits];          //Auto-reload values written by the update DMA request
+
+	std::unique_ptr<QAD_DMA> m_pARRDMA;                        //DMA driver used to write auto-reload values
+	std::unique_ptr<QAD_DMA> m_pPortDMA[QAT_BCM_MaxPorts];     //DMA drivers used to write the BSRR registers of each GPIO port
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_SoftPWM() = delete;                             //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_SoftPWM(QAD_SoftPWM_InitStruct& sInit) :        //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eTimer(sInit.eTimer),
+		m_uPrescaler(sInit.uPrescaler),
+		m_uTick(sInit.uTick),
+		m_sHandle({0}),
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_cBCM(sInit.uBits) {
+
+		for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++)
+			m_sPorts[i] = sInit.sPorts[i];
+	}
+
+	~QAD_SoftPWM() {  //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
+
+		//Stop driver if currently active
+		if (m_eState)
+			stop();
+
+		//Deinitialize driver if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_SoftPWM.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void start(void);
+	void stop(void);
+
+	QA_ActiveState getState(void);
+
+
+	//------------
+	//Data Methods
+
+	//Used to set the duty of a channel. Can be called while the driver is active, and takes effect from the next slot
+	//uChannel - Channel number ((port index * 16) + pin number)
+	//uDuty    - Duty value, from 0 (always low) to getMaxDuty() (always high)
+	void setDuty(uint8_t uChannel, uint16_t uDuty) {
+		if ((uChannel >> 4) < QAT_BCM_MaxPorts)
+			m_cBCM.setDuty(uChannel >> 4, uChannel & 0x0F, uDuty);
+	}
+
+	//Used to retrieve the duty of a channel
+	//uChannel - Channel number ((port index * 16) + pin number)
+	uint16_t getDuty(uint8_t uChannel) {
+		if ((uChannel >> 4) >= QAT_BCM_MaxPorts)
+			return 0;
+		return m_cBCM.getDuty(uChannel >> 4, uChannel & 0x0F);
+	}
+
+	//Returns the largest duty value
+	uint16_t getMaxDuty(void) {
+		return m_cBCM.getMaxDuty();
+	}
+
+	//Returns the bit-plane tables, such as for rendering the waveform of a channel with QAT_BCM::render()
+	QAT_BCM& getTables(void) {
+		return m_cBCM;
+	}
+
+private:
+
+	//------------------------------
+	//Private Initialization Methods
+
+	QA_Result periphInit(void);
+	void periphDeinit(DeinitMode eDeinitMode);
+
+	QA_Result claimResources(void);
+	void releaseResources(void);
+
+	QA_Result initDMA(std::unique_ptr<QAD_DMA>& pDMA, QAD_DMA_Request eRequest, uint32_t uPeriphAddr);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_SOFTPWM_HPP_ */
@@ -39,15 +39,23 @@ QA_Result QAD_Timer::init(void) {
   if (QAD_TimerMgr::getState(m_eTimer))
   	return QA_Error_PeriphBusy;
 
+  //Claim Timer peripheral and Update IRQ (details of any conflict can be retrieved from QAD_ResourceMgr)
+  if (claimResources())
+  	return QA_Error_PeriphBusy;
+
   //Register Timer peripheral as now being in use
   QAD_TimerMgr::registerTimer(m_eTimer, QAD_Timer_InUse_IRQ);
 
   //Initialize Timer peripheral
   QA_Result eRes = periphInit();
 
-  //If initialization failed then deregister Timer peripheral
-  if (eRes)
+  //If initialization failed then deregister Timer peripheral and release resources, otherwise route the update interrupt to this driver
+  if (eRes) {
   	QAD_TimerMgr::deregisterTimer(m_eTimer);
+  	releaseResources();
+  } else {
+  	QAD_TimerMgr::registerDriver(m_eTimer, this);
+  }
 
   //Return initialization result
   return eRes;
@@ -67,8 +75,10 @@ void QAD_Timer::deinit(void) {
   //Deinitialize Timer driver
   periphDeinit(DeinitFull);
 
-  //Deregister Timer peripheral
+  //Deregister Timer peripheral and release resources
+  QAD_TimerMgr::registerDriver(m_eTimer, NULL);
   QAD_TimerMgr::deregisterTimer(m_eTimer);
+  releaseResources();
 }
 
 
@@ -79,7 +89,8 @@ void QAD_Timer::deinit(void) {
 //QAD_Timer::handler
 //QAD_Timer IRQ Handler Method
 //
-//This method is only to be called by the interrupt request handler function from handlers.cpp
+//This method is only to be called by the interrupt request handler function from handlers.cpp, either directly or through
+//QAD_TimerMgr::irqHandler()
 void QAD_Timer::handler(void) {
 
 	//Check if Update Interrupt has been triggered
@@ -90,12 +101,34 @@ void QAD_Timer::handler(void) {
   	  case (QAD_TimerContinuous):  //If is in continuous mode then do nothing
   	  	break;
   	  case (QAD_TimerMultiple):    //If is in multiple mode then increment counter value, and if counter target has been reached then disable driver
+
+  	  	//If the repetition counter is being used (only when no callback is set) then a single update event covers m_uRepeatChunk periods
+  	  	if (m_bRepeat) {
+  	  		m_uIRQCounterValue += m_uRepeatChunk;
+  	  		m_uRepeatChunk      = QAD_Timer_RepeatMax;
+  	  		if (m_uIRQCounterValue < m_uIRQCounterTarget) {
+
+  	  			//Set one-pulse mode during the final chunk so that the counter stops at its end
+  	  			if ((m_uIRQCounterTarget - m_uIRQCounterValue) <= QAD_Timer_RepeatMax)
+  	  				m_sHandle.Instance->CR1 |= TIM_CR1_OPM;
+
+  	  			__HAL_TIM_CLEAR_FLAG(&m_sHandle, TIM_FLAG_UPDATE);
+  	  			return;
+  	  		}
+  	  		stop();
+  	  		break;
+  	  	}
+
   	  	m_uIRQCounterValue++;
   	    if (m_uIRQCounterValue >= m_uIRQCounterTarget) {
   	    	stop();
+  	    } else if ((m_uIRQCounterTarget - m_uIRQCounterValue) == 1) {
+
+  	    	//Set one-pulse mode during the final period so that the counter stops at its end
+  	    	m_sHandle.Instance->CR1 |= TIM_CR1_OPM;
   	    }
   	    break;
-  	  case (QAD_TimerSingle):      //If is in single mode then disable driver
+  	  case (QAD_TimerSingle):      //If is in single mode then disable driver (the counter itself has already been stopped by one-pulse mode)
   	  	stop();
   	    break;
   	}
@@ -122,6 +155,7 @@ void QAD_Timer::handler(void) {
 //QAD_Timer Control Method
 //
 //Used to set the interrupt handler callback function to be called when the timer update interrupt is triggered
+//In QAD_TimerMultiple mode the callback is to be set before start(), as start() selects whether the repetition counter is used (see QAD_TimerMode)
 //pHandler - Pointer to callback function based on QAD_IRQHandler_CallbackFunction prototype defined in setup.hpp
 void QAD_Timer::setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler) {
   m_pHandlerFunction = pHandler;
@@ -132,6 +166,7 @@ void QAD_Timer::setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler) {
 //QAD_Timer Control Method
 //
 //Used to set the interrupt handler callback class to be called when the timer update interrupt is triggered
+//In QAD_TimerMultiple mode the callback is to be set before start(), as start() selects whether the repetition counter is used (see QAD_TimerMode)
 //pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp
 void QAD_Timer::setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler) {
   m_pHandlerClass = pHandler;
@@ -206,11 +241,16 @@ void QAD_Timer::start(void) {
   	//Reset counter value
   	m_uIRQCounterValue = 0;
 
+  	//Configure one-pulse mode and repetition counter for the current Timer Mode
+  	configureMode();
+
   	//Enable Timer Update interrupt
   	__HAL_TIM_ENABLE_IT(&m_sHandle, TIM_IT_UPDATE);
 
-  	//Enable Timer peripheral
-  	__HAL_TIM_ENABLE(&m_sHandle);
+  	//Enable Timer peripheral, unless it is linked as a slave in trigger mode (see QAD_TimerLink.hpp), in which case
+  	//the counter is enabled by the master's trigger output
+  	if ((m_sHandle.Instance->SMCR & TIM_SMCR_SMS) != TIM_SLAVEMODE_TRIGGER)
+  		__HAL_TIM_ENABLE(&m_sHandle);
 
   	//Set current driver state to active
   	m_eState = QA_Active;
@@ -310,3 +350,98 @@ void QAD_Timer::periphDeinit(QAD_Timer::DeinitMode eDeinitMode) {
 	m_eState     = QA_Inactive;       //Set driver as currently inactive
 	m_eInitState = QA_NotInitialized; //Set driver state as not initialized
 }
+
+
+//QAD_Timer::claimResources
+//QAD_Timer Private Initialization Method
+//
+//Used to claim the Timer peripheral and its Update IRQ from QAD_ResourceMgr
+//The Update IRQ is claimed as shared, as several Timer peripherals share an IRQ (for instance Timer 1 and Timer 10)
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_Timer::claimResources(void) {
+	if (QAD_ResourceMgr::claimTimer(m_eTimer, "Timer"))
+		return QA_Error_PeriphBusy;
+
+	if (QAD_ResourceMgr::claimIRQ(QAD_TimerMgr::getUpdateIRQ(m_eTimer), true, "Timer")) {
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Timer");
+		return QA_Error_PeriphBusy;
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_Timer::releaseResources
+//QAD_Timer Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_Timer::releaseResources(void) {
+	QAD_ResourceMgr::release(QAD_Resource_IRQ, QAD_TimerMgr::getUpdateIRQ(m_eTimer), "Timer");
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eTimer, "Timer");
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAD_Timer Private Control Methods
+
+//QAD_Timer::configureMode
+//QAD_Timer Private Control Method
+//
+//Used by start() to set up one-pulse mode and the repetition counter for the current Timer Mode
+//QAD_TimerSingle   - One-pulse mode is enabled, so the counter stops at the end of the first period
+//QAD_TimerMultiple - On Timers 1 and 8 with no callback set, the repetition counter is loaded so that the first update event covers the
+//                    remainder of the counter target after dividing into chunks of QAD_Timer_RepeatMax periods, with all following update
+//                    events covering a full chunk. One-pulse mode is enabled straight away if the whole target fits in the first update
+//                    event, otherwise it is enabled by handler() during the final chunk. With a callback set, or on other timers, an update
+//                    event is triggered every period so that the callback is called every period, and one-pulse mode is enabled straight
+//                    away only for a target of 1
+void QAD_Timer::configureMode(void) {
+	TIM_TypeDef* pInstance = m_sHandle.Instance;
+	bool bAdvanced = QAD_TimerMgr::getAdvanced(m_eTimer);
+
+	pInstance->CR1 &= ~TIM_CR1_OPM;
+	m_bRepeat       = false;
+	m_uRepeatChunk  = 0;
+
+	//Clear any repetition count left by a previous QAD_TimerMultiple run. The update generation loads the repetition counter
+	//immediately, rather than at the next update event
+	if (bAdvanced) {
+		pInstance->RCR = 0;
+		pInstance->EGR = TIM_EGR_UG;
+		__HAL_TIM_CLEAR_FLAG(&m_sHandle, TIM_FLAG_UPDATE);
+	}
+
+	switch (m_eMode) {
+	  case (QAD_TimerContinuous):
+	  	break;
+
+	  case (QAD_TimerMultiple):
+	  	if (!m_uIRQCounterTarget)
+	  		m_uIRQCounterTarget = 1;
+
+	  	if ((bAdvanced) && (!m_pHandlerFunction) && (!m_pHandlerClass)) {
+	  		m_bRepeat      = true;
+	  		m_uRepeatChunk = ((m_uIRQCounterTarget - 1) % QAD_Timer_RepeatMax) + 1;
+
+	  		//Load the first chunk into the repetition counter using an update generation
+	  		pInstance->RCR = m_uRepeatChunk - 1;
+	  		pInstance->EGR = TIM_EGR_UG;
+	  		__HAL_TIM_CLEAR_FLAG(&m_sHandle, TIM_FLAG_UPDATE);
+
+	  		//Preload a full chunk for all following update events, or stop after the first if it covers the whole target
+	  		if (m_uRepeatChunk < m_uIRQCounterTarget)
+	  			pInstance->RCR = QAD_Timer_RepeatMax - 1;
+	  		else
+	  			pInstance->CR1 |= TIM_CR1_OPM;
+
+	  	} else if (m_uIRQCounterTarget == 1) {
+	  		pInstance->CR1 |= TIM_CR1_OPM;
+	  	}
+	  	break;
+
+	  case (QAD_TimerSingle):
+	  	pInstance->CR1 |= TIM_CR1_OPM;
+	  	break;
+	}
+}
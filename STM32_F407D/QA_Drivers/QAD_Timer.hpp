@@ -23,6 +23,7 @@
 #include "setup.hpp"
 
 #include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
 
 
 	//------------------------------------------
@@ -34,6 +35,13 @@
 //QAD_TimerMode
 //
 //Used with QAD_Timer driver class to determine if update interrupt is to be triggered continuously, a set number of times of a single time.
+//
+//In QAD_TimerMultiple and QAD_TimerSingle modes the timer is stopped by hardware (one-pulse mode) at the end of the final period, rather
+//than by the update interrupt, so the stop point is not delayed by interrupt latency.
+//In QAD_TimerMultiple mode the callback is called at the end of every period on all timers. If no callback has been set when the timer
+//is started, Timers 1 and 8 instead use the hardware repetition counter, so that rather than an interrupt for every period, only a
+//single interrupt is triggered once the counter target has been reached (or one interrupt for every 256 periods, as the repetition
+//counter is 8bit).
 enum QAD_TimerMode : uint8_t {
 	QAD_TimerContinuous = 0,  //Update interrupt to be triggered continuously
 	QAD_TimerMultiple,        //Update interrupt to be triggered a set number of times (based on counter target value)
@@ -41,6 +49,13 @@ enum QAD_TimerMode : uint8_t {
 };
 
 
+//-------------------
+//QAD_Timer_RepeatMax
+//
+//Maximum number of periods per update event when using the repetition counter of Timers 1 and 8
+const uint16_t QAD_Timer_RepeatMax = 256;
+
+
 //--------------------
 //QAD_Timer_InitStruct
 //
@@ -53,6 +68,7 @@ typedef struct {
 
 	uint32_t         uPrescaler;       //Prescaler to be used for selected timer
 	uint32_t         uPeriod;          //Counter period to be used for selected timer
+	                                   //NOTE: uPrescaler and uPeriod can be calculated from a required frequency or period using QAT_TimerSolver.hpp
 
 	uint8_t          uIRQPriority;     //IRQ Priority for update interrupt (a value between 0 and 15)
 
@@ -106,6 +122,9 @@ private:
 	uint16_t          m_uIRQCounterTarget;  //Counter target value to be used when m_eMode is set to QAD_TimerMultiple
 	uint16_t          m_uIRQCounterValue;   //Current counter value to be used when m_eMode is set to QAD_TimerMultiple
 
+	bool              m_bRepeat;            //Set to true when the hardware repetition counter is being used for QAD_TimerMultiple mode
+	uint16_t          m_uRepeatChunk;       //Number of periods covered by the repetition counter in the current update event
+
 public:
 
 	//--------------------------
@@ -125,7 +144,9 @@ public:
 		m_pHandlerFunction(NULL),
 		m_pHandlerClass(NULL),
 		m_uIRQCounterTarget(sInit.uCounterTarget),
-		m_uIRQCounterValue(0) {}
+		m_uIRQCounterValue(0),
+		m_bRepeat(false),
+		m_uRepeatChunk(0) {}
 
 	~QAD_Timer() {         //Destructor to make sure peripheral is made inactive and deinitialized upon class destruction
 
@@ -180,6 +201,15 @@ private:
   QA_Result periphInit(void);
   void periphDeinit(DeinitMode eDeinitMode);
 
+  QA_Result claimResources(void);
+  void releaseResources(void);
+
+
+  //-----------------------
+  //Private Control Methods
+
+  void configureMode(void);
+
 };
 
 
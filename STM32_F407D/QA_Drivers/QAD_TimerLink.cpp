@@ -0,0 +1,174 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Timer Master/Slave Link Driver                                  */
+/*   Filename: QAD_TimerLink.cpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAD_TimerLink.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //------------------------------------
+  //------------------------------------
+  //QAD_TimerLink Initialization Methods
+
+//QAD_TimerLink::init
+//QAD_TimerLink Initialization Method
+//
+//Used to link the master and slave Timer peripherals
+//Both Timer peripherals must already be initialized by their own drivers
+//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+//        QA_Fail if the driver is already initialized, or either Timer peripheral is not currently in use by a driver
+//        QA_Error_PeriphNotSupported if the slave has no internal trigger input connected to the master, or the master cannot
+//                                    produce the selected trigger
+//        QA_Error_PeriphBusy if the slave is already linked, or the master is already linked using a different trigger
+QA_Result QAD_TimerLink::init(void) {
+	if (m_eInitState)
+		return QA_Fail;
+
+	//Check that both Timer peripherals have been initialized by their drivers, as otherwise their clocks are disabled
+	//and their registers would be reset when their drivers are initialized
+	if ((!QAD_TimerMgr::getState(m_eMaster)) || (!QAD_TimerMgr::getState(m_eSlave)))
+		return QA_Fail;
+
+	//Find internal trigger input of the slave that is connected to the master
+	m_uITR = QAD_TimerMgr::getITR(m_eSlave, m_eMaster);
+	if (m_uITR == QAD_Timer_ITRNone)
+		return QA_Error_PeriphNotSupported;
+
+	//Timers without a trigger output are connected to their slave through their OC1REF signal
+	if ((!QAD_TimerMgr::getTRGO(m_eMaster)) && (m_eTrigger != QAD_TimerLink_TriggerOC1Ref))
+		return QA_Error_PeriphNotSupported;
+
+	//Register link
+	QA_Result eRes = QAD_TimerMgr::registerLink(m_eMaster, m_eSlave, m_eTrigger);
+	if (eRes)
+		return eRes;
+
+	//Configure master mode of master Timer peripheral
+	if (QAD_TimerMgr::getTRGO(m_eMaster)) {
+		TIM_TypeDef* pMaster = QAD_TimerMgr::getInstance(m_eMaster);
+		pMaster->CR2 = (pMaster->CR2 & ~TIM_CR2_MMS) | ((uint32_t)m_eTrigger << TIM_CR2_MMS_Pos);
+	}
+
+	//Configure slave mode of slave Timer peripheral. The trigger input is selected before the slave mode is enabled
+	TIM_TypeDef* pSlave = QAD_TimerMgr::getInstance(m_eSlave);
+	pSlave->SMCR = (pSlave->SMCR & ~(TIM_SMCR_SMS | TIM_SMCR_TS)) | ((uint32_t)m_uITR << TIM_SMCR_TS_Pos);
+	pSlave->SMCR |= ((uint32_t)m_eMode << TIM_SMCR_SMS_Pos);
+
+	//Set driver state
+	m_eInitState = QA_Initialized;
+
+	//Return
+	return QA_OK;
+}
+
+
+//QAD_TimerLink::deinit
+//QAD_TimerLink Initialization Method
+//
+//Used to remove the link between the master and slave Timer peripherals
+//The slave mode of the slave is disabled, and the master mode of the master is returned to reset once it has no remaining links
+void QAD_TimerLink::deinit(void) {
+
+	//Return if driver is not currently initialized
+	if (!m_eInitState)
+		return;
+
+	//Disable slave mode of slave Timer peripheral, if it is still in use by its driver
+	if (QAD_TimerMgr::getState(m_eSlave)) {
+		TIM_TypeDef* pSlave = QAD_TimerMgr::getInstance(m_eSlave);
+		pSlave->SMCR &= ~(TIM_SMCR_SMS | TIM_SMCR_TS);
+	}
+
+	//Deregister link
+	QAD_TimerMgr::deregisterLink(m_eMaster, m_eSlave);
+
+	//Reset master mode of master Timer peripheral once it is no longer the master of any link
+	if ((QAD_TimerMgr::getTRGO(m_eMaster)) && (!QAD_TimerMgr::getLinkMasters(m_eMaster)) && (QAD_TimerMgr::getState(m_eMaster))) {
+		TIM_TypeDef* pMaster = QAD_TimerMgr::getInstance(m_eMaster);
+		pMaster->CR2 &= ~TIM_CR2_MMS;
+	}
+
+	//Set driver state
+	m_eInitState = QA_NotInitialized;
+}
+
+
+//QAD_TimerLink::getInitState
+//QAD_TimerLink Initialization Method
+//
+//Returns whether the link is currently initialized. Member of QA_InitState as defined in setup.hpp
+QA_InitState QAD_TimerLink::getInitState(void) {
+	return m_eInitState;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAD_TimerLink Control Methods
+
+//QAD_TimerLink::resetCounters
+//QAD_TimerLink Control Method
+//
+//Used to reset the counters of both the master and slave Timer peripherals to zero, so that in QAD_TimerLink_ModeTrigger
+//the outputs of both timers are phase-aligned once the master is started
+//Has no effect while the master is running
+void QAD_TimerLink::resetCounters(void) {
+	if (!m_eInitState)
+		return;
+
+	TIM_TypeDef* pMaster = QAD_TimerMgr::getInstance(m_eMaster);
+	if (pMaster->CR1 & TIM_CR1_CEN)
+		return;
+
+	pMaster->CNT = 0;
+	QAD_TimerMgr::getInstance(m_eSlave)->CNT = 0;
+}
+
+
+  //--------------------------
+  //--------------------------
+  //QAD_TimerLink Data Methods
+
+//QAD_TimerLink::getCount
+//QAD_TimerLink Data Method
+//
+//Used to read the combined counter value of a cascaded master and slave, in counts of the master's counter clock
+//The slave's trigger input takes a few timer clock cycles to register a master overflow, so just after an overflow the master counter
+//can already have wrapped while the slave still holds the old value. The master counter is therefore read a second time, and the read is
+//repeated if the master has wrapped since the first read. The slave counter is then read again, by which time the slave has registered
+//any overflow that happened before the first master read, and the read is repeated if the slave has counted
+//Returns the combined counter value, or 0 if the link is not initialized in QAD_TimerLink_ModeCascade
+uint64_t QAD_TimerLink::getCount(void) {
+	if ((!m_eInitState) || (m_eMode != QAD_TimerLink_ModeCascade))
+		return 0;
+
+	TIM_TypeDef* pMaster = QAD_TimerMgr::getInstance(m_eMaster);
+	TIM_TypeDef* pSlave  = QAD_TimerMgr::getInstance(m_eSlave);
+
+	uint32_t uHigh;
+	uint32_t uLow;
+	do {
+		uHigh = pSlave->CNT;
+		uLow  = pMaster->CNT;
+	} while ((pMaster->CNT < uLow) || (pSlave->CNT != uHigh));
+
+	return ((uint64_t)uHigh * ((uint64_t)pMaster->ARR + 1)) + uLow;
+}
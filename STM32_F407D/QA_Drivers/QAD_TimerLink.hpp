@@ -0,0 +1,162 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Drivers                                                       */
+/*   Role: Timer Master/Slave Link Driver                                  */
+/*   Filename: QAD_TimerLink.hpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAD_TIMERLINK_HPP_
+#define __QAD_TIMERLINK_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAD_TimerMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//---------------------
+//QAD_TimerLink_Trigger
+//
+//Used to select the event of the master Timer peripheral that drives its trigger output (TRGO)
+//Values match the MMS bits of the master's CR2 register
+enum QAD_TimerLink_Trigger : uint8_t {
+	QAD_TimerLink_TriggerReset = 0,     //Trigger output pulses when the master is reset by software (UG bit) or by its own slave mode controller
+	QAD_TimerLink_TriggerEnable,        //Trigger output follows the master's counter enable. Used for synchronized starts and gated mode
+	QAD_TimerLink_TriggerUpdate,        //Trigger output pulses on each update event of the master. Used for cascading timers
+	QAD_TimerLink_TriggerComparePulse,  //Trigger output pulses on each channel 1 capture/compare match
+	QAD_TimerLink_TriggerOC1Ref,        //Trigger output follows the OC1REF signal of the master
+	QAD_TimerLink_TriggerOC2Ref,        //Trigger output follows the OC2REF signal of the master
+	QAD_TimerLink_TriggerOC3Ref,        //Trigger output follows the OC3REF signal of the master
+	QAD_TimerLink_TriggerOC4Ref         //Trigger output follows the OC4REF signal of the master
+};
+
+
+//------------------
+//QAD_TimerLink_Mode
+//
+//Used to select how the slave Timer peripheral responds to the trigger output of the master
+//Values match the SMS bits of the slave's SMCR register
+enum QAD_TimerLink_Mode : uint8_t {
+	QAD_TimerLink_ModeReset   = 4,  //Slave counter is reset on each trigger
+	QAD_TimerLink_ModeGated   = 5,  //Slave counter only runs while the trigger is high
+	QAD_TimerLink_ModeTrigger = 6,  //Slave counter is started by the first trigger. Used for synchronized starts
+	QAD_TimerLink_ModeCascade = 7   //Slave counter is clocked by the trigger (external clock mode 1). Used for cascading timers
+};
+
+
+//------------------------
+//QAD_TimerLink_InitStruct
+//
+//This structure is used to be able to create the QAD_TimerLink driver class
+typedef struct {
+
+	QAD_Timer_Periph      eMaster;   //Master Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	QAD_Timer_Periph      eSlave;    //Slave Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	                                 //The slave must have an internal trigger input connected to the master (see QAD_TimerMgr::getITR())
+
+	QAD_TimerLink_Trigger eTrigger;  //Master event used to drive the trigger output. Member of QAD_TimerLink_Trigger
+	                                 //Must be QAD_TimerLink_TriggerOC1Ref when the master is Timer 10, 11, 13 or 14
+	QAD_TimerLink_Mode    eMode;     //Slave response to the trigger. Member of QAD_TimerLink_Mode
+
+} QAD_TimerLink_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------
+//QAD_TimerLink
+//
+//Driver class used to link two Timer peripherals as master and slave, using the internal trigger connections between them
+//
+//The master and slave Timer peripherals need to be initialized by their own drivers (QAD_Timer, QAD_PWM, etc) before the link is initialized,
+//as the drivers reset the Timer peripherals during their initialization. The link only configures the master mode of the master and the
+//slave mode of the slave.
+//
+//Common uses:
+// - Synchronized start: Master uses QAD_TimerLink_TriggerEnable and slaves use QAD_TimerLink_ModeTrigger. Slaves can then be started
+//   by their drivers without their counters running, and all will start counting on the same clock cycle once the master is started.
+//   Calling resetCounters() before starting the master aligns the phase of the PWM outputs of all linked timers
+// - Gated: Master uses QAD_TimerLink_TriggerEnable or an OCxRef trigger, and the slave uses QAD_TimerLink_ModeGated
+// - Cascade: Master uses QAD_TimerLink_TriggerUpdate and the slave uses QAD_TimerLink_ModeCascade, so that the slave counts master
+//   overflows. A 16bit master acts as a prescaler for a 32bit slave, and Timer 2 cascaded into Timer 5 forms a 64bit counter that can
+//   be read with getCount()
+class QAD_TimerLink {
+private:
+
+	QAD_Timer_Periph      m_eMaster;     //Master Timer peripheral
+	QAD_Timer_Periph      m_eSlave;      //Slave Timer peripheral
+	QAD_TimerLink_Trigger m_eTrigger;    //Master event used to drive the trigger output
+	QAD_TimerLink_Mode    m_eMode;       //Slave response to the trigger
+
+	uint8_t               m_uITR;        //Internal trigger input of the slave connected to the master
+
+	QA_InitState          m_eInitState;  //Stores whether the driver is currently initialized. Member of QA_InitState enum defined in setup.hpp
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAD_TimerLink() = delete;                         //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAD_TimerLink(QAD_TimerLink_InitStruct& sInit) :  //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eMaster(sInit.eMaster),
+		m_eSlave(sInit.eSlave),
+		m_eTrigger(sInit.eTrigger),
+		m_eMode(sInit.eMode),
+		m_uITR(QAD_Timer_ITRNone),
+		m_eInitState(QA_NotInitialized) {}
+
+	~QAD_TimerLink() {  //Destructor to make sure link is removed upon class destruction
+
+		//Deinitialize link if currently initialized
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAD_TimerLink.cpp for details of the following functions
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+	QA_InitState getInitState(void);
+
+
+	//---------------
+	//Control Methods
+
+	void resetCounters(void);
+
+
+	//------------
+	//Data Methods
+
+	uint64_t getCount(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAD_TIMERLINK_HPP_ */
@@ -37,11 +37,16 @@ QA_Result QAD_UART::init(void) {
 	if (QAD_UARTMgr::getState(m_eUART))
 		return QA_Error_PeriphBusy;
 
+  if (claimResources())
+  	return QA_Error_PeriphBusy;
+
   QAD_UARTMgr::registerUART(m_eUART);
   QA_Result eRes = periphInit();
 
-  if (eRes)
+  if (eRes) {
   	QAD_UARTMgr::deregisterUART(m_eUART);
+  	releaseResources();
+  }
   return eRes;
 }
 
@@ -56,6 +61,7 @@ void QAD_UART::deinit(void) {
 
   periphDeinit(DeinitFull);
   QAD_UARTMgr::deregisterUART(m_eUART);
+  releaseResources();
 }
 
 
@@ -264,3 +270,46 @@ void QAD_UART::periphDeinit(QAD_UART::DeinitMode eDeinitMode) {
 	m_eRXState   = QA_Inactive;       //Set receive state as inactive
 	m_eInitState = QA_NotInitialized; //Set driver state as not initialized
 }
+
+
+//QAD_UART::claimResources
+//QAD_UART Private Initialization Method
+//
+//Used to claim the UART peripheral, its IRQ, and the TX and RX GPIO pins from QAD_ResourceMgr
+//Returns QA_OK if all resources were claimed, or QA_Error_PeriphBusy if any resource is already held
+QA_Result QAD_UART::claimResources(void) {
+	if (QAD_ResourceMgr::claimUART(m_eUART, "UART"))
+		return QA_Error_PeriphBusy;
+
+	if (QAD_ResourceMgr::claimIRQ(QAD_UARTMgr::getIRQ(m_eUART), false, "UART")) {
+		QAD_ResourceMgr::release(QAD_Resource_UART, m_eUART, "UART");
+		return QA_Error_PeriphBusy;
+	}
+
+	if (QAD_ResourceMgr::claimPins(m_pTXGPIO, m_uTXPin, "UART")) {
+		QAD_ResourceMgr::release(QAD_Resource_IRQ, QAD_UARTMgr::getIRQ(m_eUART), "UART");
+		QAD_ResourceMgr::release(QAD_Resource_UART, m_eUART, "UART");
+		return QA_Error_PeriphBusy;
+	}
+
+	if (QAD_ResourceMgr::claimPins(m_pRXGPIO, m_uRXPin, "UART")) {
+		QAD_ResourceMgr::releasePins(m_pTXGPIO, m_uTXPin, "UART");
+		QAD_ResourceMgr::release(QAD_Resource_IRQ, QAD_UARTMgr::getIRQ(m_eUART), "UART");
+		QAD_ResourceMgr::release(QAD_Resource_UART, m_eUART, "UART");
+		return QA_Error_PeriphBusy;
+	}
+
+	return QA_OK;
+}
+
+
+//QAD_UART::releaseResources
+//QAD_UART Private Initialization Method
+//
+//Used to release resources claimed by claimResources()
+void QAD_UART::releaseResources(void) {
+	QAD_ResourceMgr::releasePins(m_pRXGPIO, m_uRXPin, "UART");
+	QAD_ResourceMgr::releasePins(m_pTXGPIO, m_uTXPin, "UART");
+	QAD_ResourceMgr::release(QAD_Resource_IRQ, QAD_UARTMgr::getIRQ(m_eUART), "UART");
+	QAD_ResourceMgr::release(QAD_Resource_UART, m_eUART, "UART");
+}
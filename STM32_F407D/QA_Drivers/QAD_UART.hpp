@@ -23,6 +23,7 @@
 #include "setup.hpp"
 
 #include "QAD_UARTMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
 
 
 	//------------------------------------------
@@ -163,6 +164,9 @@ private:
 	QA_Result periphInit(void);
   void periphDeinit(DeinitMode eDeinitMode);
 
+  QA_Result claimResources(void);
+  void releaseResources(void);
+
 };
 
 
@@ -0,0 +1,301 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Benchmarks                                             */
+/*   Role: QAS_Debounce Sample Cost Benchmark                              */
+/*   Filename: QAH_Debounce_Bench.cpp                                      */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Measures the cost of each sample taken by QAS_Debounce::handler() with 1 to 16 pins per port and 1 to 4 ports, to show that the
+//bit-parallel vertical counters make the cost of a port the same however many of its pins are debounced, and that each port adds the
+//same cost
+//
+//The debouncer is run from its timer's update interrupt on the register mock, with the input registers set and the interrupt raised by
+//the benchmark once per sample. Samples are timed in batches with the host's monotonic clock, less the cost of timing an empty batch,
+//and the mean cost per sample of each batch is reported as the mean, median, 99.9th percentile and largest time over all batches, with
+//the spread between the median and 99.9th percentile given as the jitter. The median is also given relative to the first run of each
+//set (a single pin, or a single port), and for more than one port the difference is given per added port.
+//Each configuration is run with three sets of inputs:
+//  Steady   - No pin changes level
+//  Glitch   - Pins are at random held at the other level for single samples, never on two samples in a row, so the counters of many pins
+//             are running but no change is accepted
+//  Changing - Each pin changes level on one sample in QAH_Debounce_ChangeOdds, so that some changes are accepted and queue an event.
+//             Each event adds a fixed cost, so these figures also depend on the number of events per sample, which is reported alongside
+//The event queue is emptied between batches, outside of the timing
+//
+//The times are for the host, and only the relative costs carry over to the board
+//
+//Returns 1 if the event queue overflowed, or the events read do not match the debounced levels
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAS_Debounce.hpp"
+
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------------------
+//Debounce Bench Definitions
+//
+//QAH_Debounce_Samples    - Number of samples timed in each run
+//QAH_Debounce_Batch      - Number of samples in each batch with steady and glitch inputs
+//QAH_Debounce_EventBatch - Number of samples in each batch with changing inputs. Kept small so that the events of a batch always fit in
+//                          the event queue
+//QAH_Debounce_ChangeOdds - Each pin of the changing inputs changes level on one sample in this many
+//QAH_Debounce_GPIO       - GPIO port used for each port index
+const uint32_t QAH_Debounce_Samples    = 1UL << 19;
+const uint16_t QAH_Debounce_Batch      = 256;
+const uint16_t QAH_Debounce_EventBatch = 16;
+const uint32_t QAH_Debounce_ChangeOdds = 32;
+static GPIO_TypeDef* const QAH_Debounce_GPIO[QAS_Debounce_MaxPorts] = {GPIOA, GPIOB, GPIOC, GPIOE};
+
+
+//------------------
+//QAH_Debounce_Input
+//
+//Inputs used for a run
+enum QAH_Debounce_Input : uint8_t {
+	QAH_Debounce_Steady = 0,
+	QAH_Debounce_Glitch,
+	QAH_Debounce_Changing
+};
+
+
+//Cost of timing an empty batch in nanoseconds, found by QAH_Debounce_Calibrate()
+static uint64_t QAH_Debounce_Empty = 0;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_Debounce_Now
+//Test Helper Function
+//
+//Returns the host's monotonic clock in nanoseconds
+static uint64_t QAH_Debounce_Now(void) {
+	struct timespec sTime;
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+	return ((uint64_t)sTime.tv_sec * 1000000000ULL) + sTime.tv_nsec;
+}
+
+
+//QAH_Debounce_Sample
+//Test Helper Function
+//
+//Raises the sample timer's update interrupt, as the timer would at the end of each sample period. The interrupt is routed through
+//QAD_TimerMgr::irqHandler(), as it is by TIM7_IRQHandler in handlers.cpp
+static inline void QAH_Debounce_Sample(void) {
+	TIM7->SR = TIM_SR_UIF;
+	QAD_TimerMgr::irqHandler(QAD_Timer7);
+}
+
+
+//QAH_Debounce_Setup
+//Test Helper Function
+//
+//Stops the debouncer, and sets the first uPorts ports to debounce their lowest uPins pins, with the remaining ports unused
+//uPorts - Number of ports
+//uPins  - Number of pins per port (1 to 16)
+static void QAH_Debounce_Setup(uint8_t uPorts, uint8_t uPins) {
+	QAS_Debounce::stop();
+	uint16_t uMask = (uint16_t)((1UL << uPins) - 1);
+	for (uint8_t p=0; p<QAS_Debounce_MaxPorts; p++) {
+		QAH_Debounce_GPIO[p]->IDR = 0;
+		if (p < uPorts)
+			QAS_Debounce::setPort(p, QAH_Debounce_GPIO[p], uMask, 0);
+		else
+			QAS_Debounce::setPort(p, NULL, 0, 0);
+	}
+	QAS_Debounce::start();
+}
+
+
+//QAH_Debounce_Calibrate
+//Test Helper Function
+//
+//Finds the median time taken to time an empty batch, which is taken off the time of each batch. The samples that follow are not timed,
+//and are only taken so that the host is running at full speed before the first run
+static void QAH_Debounce_Calibrate(void) {
+	uint32_t              uBatches = QAH_Debounce_Samples / QAH_Debounce_Batch;
+	std::vector<uint64_t> cTimes(uBatches);
+	for (uint32_t b=0; b<uBatches; b++) {
+		uint64_t uStart = QAH_Debounce_Now();
+		cTimes[b]       = QAH_Debounce_Now() - uStart;
+	}
+	std::sort(cTimes.begin(), cTimes.end());
+	QAH_Debounce_Empty = cTimes[cTimes.size() / 2];
+
+	QAH_Debounce_Setup(QAS_Debounce_MaxPorts, 16);
+	for (uint32_t s=0; s<(QAH_Debounce_Samples * 4); s++)
+		QAH_Debounce_Sample();
+}
+
+
+//QAH_Debounce_Report
+//Test Helper Function
+//
+//Prints the statistics of a set of sample times. The jitter is the spread from the median to the 99.9th percentile, as the largest times
+//also include the host being interrupted, which the board does not suffer from
+//strName    - Name of the run
+//cTimes     - Mean time of the samples of each batch in nanoseconds (sorted by this function)
+//dPerTick   - Mean number of events per sample
+//dReference - Median of the first run of the set, or 0.0 if this is the first run
+//uAdded     - Number of ports added since the first run of the set
+//Returns the median
+static double QAH_Debounce_Report(const char* strName, std::vector<double>& cTimes, double dPerTick, double dReference, uint8_t uAdded) {
+	std::sort(cTimes.begin(), cTimes.end());
+	double dMean = 0.0;
+	for (double dTime : cTimes)
+		dMean += dTime;
+	dMean /= cTimes.size();
+
+	double dMedian = cTimes[cTimes.size() / 2];
+	double dP999   = cTimes[(cTimes.size() * 999) / 1000];
+	double dMax    = cTimes.back();
+	printf("  %-26s %5.2f events/sample  mean %5.1fns  median %5.1fns  99.9%% %6.1fns  max %8.1fns  jitter %6.1fns", strName, dPerTick,
+	       dMean, dMedian, dP999, dMax, dP999 - dMedian);
+
+	if (dReference != 0.0)
+		printf("  %+5.1fns", dMedian - dReference);
+	if (uAdded)
+		printf(" (%+5.1fns per added port)", (dMedian - dReference) / uAdded);
+	printf("\n");
+	return dMedian;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_BenchSamples
+//Test Function
+//
+//Times QAH_Debounce_Samples samples with a number of ports and pins per port, and checks that the events read match the debounced levels
+//uPorts     - Number of ports
+//uPins      - Number of pins per port (1 to 16)
+//eInput     - Inputs to be used. Member of QAH_Debounce_Input
+//dReference - Median of the first run of the set, or 0.0 if this is the first run
+//uAdded     - Number of ports added since the first run of the set
+//Returns the median time per sample
+static double QAH_BenchSamples(uint8_t uPorts, uint8_t uPins, QAH_Debounce_Input eInput, double dReference, uint8_t uAdded) {
+	const char*           strInput[] = {"steady", "glitch", "changing"};
+	uint16_t              uBatch     = (eInput == QAH_Debounce_Changing) ? QAH_Debounce_EventBatch : QAH_Debounce_Batch;
+	uint32_t              uBatches   = QAH_Debounce_Samples / uBatch;
+	std::vector<uint16_t> cLevels(QAH_Debounce_Samples * uPorts);
+	std::vector<double>   cTimes(uBatches);
+	uint16_t              uMask      = (uint16_t)((1UL << uPins) - 1);
+	char                  strName[40];
+
+	//Input levels of each port at each sample, found before timing so that only the register writes are timed
+	srand((uPorts << 8) | uPins);
+	for (uint8_t p=0; p<uPorts; p++) {
+		uint16_t uLevel  = 0;
+		uint16_t uGlitch = 0;
+		for (uint32_t s=0; s<QAH_Debounce_Samples; s++) {
+			if (eInput == QAH_Debounce_Glitch) {
+				uGlitch = (uint16_t)rand() & uMask & ~uGlitch;
+			} else if (eInput == QAH_Debounce_Changing) {
+				for (uint8_t i=0; i<uPins; i++) {
+					if (!(rand() % QAH_Debounce_ChangeOdds))
+						uLevel ^= (1 << i);
+				}
+			}
+			cLevels[(s * uPorts) + p] = uLevel ^ uGlitch;
+		}
+	}
+
+	QAH_Debounce_Setup(uPorts, uPins);
+	uint32_t        uEvents = 0;
+	uint16_t        uState[QAS_Debounce_MaxPorts] = {0};
+	const uint16_t* pLevels = cLevels.data();
+
+	for (uint32_t b=0; b<uBatches; b++) {
+		uint64_t uStart = QAH_Debounce_Now();
+		for (uint16_t s=0; s<uBatch; s++) {
+			for (uint8_t p=0; p<uPorts; p++)
+				QAH_Debounce_GPIO[p]->IDR = *pLevels++;
+			QAH_Debounce_Sample();
+		}
+		uint64_t uTime = QAH_Debounce_Now() - uStart;
+		uTime          = (uTime > QAH_Debounce_Empty) ? (uTime - QAH_Debounce_Empty) : 0;
+		cTimes[b]      = (double)uTime / uBatch;
+
+		//Empty event queue, keeping the debounced levels from the events
+		QAS_Debounce_Event sEvent;
+		while (QAS_Debounce::getEvent(sEvent) == QA_OK) {
+			uState[sEvent.uInput >> 4] ^= (1 << (sEvent.uInput & 0x0F));
+			uEvents++;
+		}
+	}
+
+	snprintf(strName, sizeof(strName), "%u port%s, %2u pin%s, %s", uPorts, (uPorts > 1) ? "s" : " ", uPins, (uPins > 1) ? "s" : " ",
+	         strInput[eInput]);
+	double dMedian = QAH_Debounce_Report(strName, cTimes, (double)uEvents / QAH_Debounce_Samples, dReference, uAdded);
+
+	QAH_CHECK_EQ(QAS_Debounce::getOverflows(), 0);
+	for (uint8_t p=0; p<uPorts; p++)
+		QAH_CHECK_EQ(uState[p], QAS_Debounce::getInputs(p) & uMask);
+	if (eInput != QAH_Debounce_Changing)
+		QAH_CHECK_EQ(uEvents, 0);
+	return dMedian;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_Mock::reset();
+
+	QAS_Debounce_InitStruct sInit;
+	sInit.eTimer           = QAD_Timer7;
+	sInit.uSampleFrequency = 1000;
+	sInit.uIRQPriority     = 5;
+	QAH_CHECK_EQ(QAS_Debounce::init(sInit), QA_OK);
+	QAH_Debounce_Calibrate();
+
+	const uint8_t uPins[] = {1, 2, 4, 8, 12, 16};
+	QAH_TEST("Sample cost with 1 to 16 pins of a single port");
+	for (uint8_t e=QAH_Debounce_Steady; e<=QAH_Debounce_Changing; e++) {
+		double dReference = 0.0;
+		for (uint8_t i=0; i<sizeof(uPins); i++) {
+			double dMedian = QAH_BenchSamples(1, uPins[i], (QAH_Debounce_Input)e, dReference, 0);
+			if (!i)
+				dReference = dMedian;
+		}
+	}
+
+	QAH_TEST("Sample cost with 1 to 4 ports of 16 pins");
+	for (uint8_t e=QAH_Debounce_Steady; e<=QAH_Debounce_Changing; e++) {
+		double dReference = 0.0;
+		for (uint8_t p=1; p<=QAS_Debounce_MaxPorts; p++) {
+			double dMedian = QAH_BenchSamples(p, 16, (QAH_Debounce_Input)e, dReference, p - 1);
+			if (p == 1)
+				dReference = dMedian;
+		}
+	}
+
+	QAS_Debounce::deinit();
+	return QAH_RESULT();
+}
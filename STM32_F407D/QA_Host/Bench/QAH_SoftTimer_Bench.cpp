@@ -0,0 +1,265 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Benchmarks                                             */
+/*   Role: QAS_SoftTimer Tick Cost and Jitter Benchmark                    */
+/*   Filename: QAH_SoftTimer_Bench.cpp                                     */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Measures the cost of each tick of the QAS_SoftTimer timing wheel with up to 60000 active timers, and checks that every timer expires
+//on exactly the tick it was due
+//
+//The service is run from its timer's update interrupt on the register mock, with the interrupt raised by the benchmark once per tick.
+//Each tick is timed with the host's monotonic clock, and the cost is reported as the mean, median, 99.9th percentile and largest time
+//per tick, with the spread between the median and 99.9th percentile given as the jitter. Timers are periodic with random periods, or
+//single-shot and restarted from their callbacks with random delays of up to 2^20 ticks, so that timers are cascaded from every level of
+//the wheel.
+//A further run expires all timers on the same tick, as the worst case for a single tick.
+//
+//The times are for the host, and only the relative costs carry over to the board, where getTickCyclesMax() and getTickJitter() give
+//the same figures in CPU cycles (the mocked DWT cycle counter does not count, so they are not used here)
+//
+//Returns 1 if any timer expired on the wrong tick
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAS_SoftTimer.hpp"
+
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------------------
+//SoftTimer Bench Definitions
+//
+//QAH_SoftTimer_Ticks     - Number of ticks timed in each run
+//QAH_SoftTimer_MaxPeriod - Largest period of the periodic timers, in ticks
+//QAH_SoftTimer_MaxDelay  - Largest delay of the single-shot timers, in ticks
+const uint32_t QAH_SoftTimer_Ticks     = 200000;
+const uint32_t QAH_SoftTimer_MaxPeriod = 2000;
+const uint32_t QAH_SoftTimer_MaxDelay  = (1UL << 20);
+
+
+//-------------------
+//QAH_SoftTimer_Timer
+//
+//A timer under test, with the tick it is next due to expire on
+typedef struct {
+
+	QAS_SoftTimer_Entry cEntry;
+	uint32_t            uDue;
+	uint32_t            uPeriod;  //Period of a periodic timer, or 0 for a single-shot timer restarted from its callback
+
+} QAH_SoftTimer_Timer;
+
+
+//Totals kept by the callback
+static uint32_t QAH_SoftTimer_Expiries = 0;
+static uint32_t QAH_SoftTimer_Late     = 0;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_SoftTimer_Now
+//Test Helper Function
+//
+//Returns the host's monotonic clock in nanoseconds
+static uint64_t QAH_SoftTimer_Now(void) {
+	struct timespec sTime;
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+	return ((uint64_t)sTime.tv_sec * 1000000000ULL) + sTime.tv_nsec;
+}
+
+
+//QAH_SoftTimer_Callback
+//Test Helper Function
+//
+//Called when a timer expires. Checks that it expired on the tick it was due (the tick being processed is one less than getTick()),
+//and sets the tick it is next due, restarting single-shot timers with a new random delay
+//pData - The QAH_SoftTimer_Timer that expired
+static void QAH_SoftTimer_Callback(void* pData) {
+	QAH_SoftTimer_Timer* pTimer = (QAH_SoftTimer_Timer*)pData;
+	uint32_t             uTick  = QAS_SoftTimer::getTick() - 1;
+
+	QAH_SoftTimer_Expiries++;
+	if (uTick != pTimer->uDue)
+		QAH_SoftTimer_Late++;
+
+	if (pTimer->uPeriod) {
+		pTimer->uDue += pTimer->uPeriod;
+	} else {
+		uint32_t uDelay = 1 + (rand() % QAH_SoftTimer_MaxDelay);
+		pTimer->uDue = QAS_SoftTimer::getTick() + uDelay;
+		QAS_SoftTimer::start(pTimer->cEntry, uDelay, 0);
+	}
+}
+
+
+//QAH_SoftTimer_Tick
+//Test Helper Function
+//
+//Raises the wheel's timer update interrupt once, as the timer would at each tick
+//Returns the time taken by the interrupt in nanoseconds
+static uint64_t QAH_SoftTimer_Tick(void) {
+	uint64_t uStart = QAH_SoftTimer_Now();
+	TIM7->SR = TIM_SR_UIF;
+	QAS_SoftTimer::irqHandler();
+	TIM7->SR = 0;
+	return QAH_SoftTimer_Now() - uStart;
+}
+
+
+//QAH_SoftTimer_Report
+//Test Helper Function
+//
+//Prints the statistics of a set of tick times. The jitter is the spread from the median to the 99.9th percentile, as the largest times
+//also include the host being interrupted, which the board does not suffer from
+//strName  - Name of the run
+//cTimes   - Time of each tick in nanoseconds (sorted by this function)
+//dPerTick - Mean number of callbacks per tick
+static void QAH_SoftTimer_Report(const char* strName, std::vector<uint64_t>& cTimes, double dPerTick) {
+	std::sort(cTimes.begin(), cTimes.end());
+	double dMean = 0.0;
+	for (uint64_t uTime : cTimes)
+		dMean += uTime;
+	dMean /= cTimes.size();
+
+	unsigned long uMedian = cTimes[cTimes.size() / 2];
+	unsigned long uP999   = cTimes[(cTimes.size() * 999) / 1000];
+	unsigned long uMax    = cTimes.back();
+	printf("  %-24s %7.1f callbacks/tick  mean %6.0fns  median %6luns  99.9%% %7luns  max %7luns  jitter %7luns\n", strName, dPerTick,
+	       dMean, uMedian, uP999, uMax, uP999 - uMedian);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_BenchMixed
+//Test Function
+//
+//Times QAH_SoftTimer_Ticks ticks with a number of active timers, half periodic and half single-shot
+//uTimers - Number of timers
+static void QAH_BenchMixed(uint32_t uTimers) {
+	std::vector<QAH_SoftTimer_Timer> cTimers(uTimers);
+	std::vector<uint64_t>            cTimes(QAH_SoftTimer_Ticks);
+	char                             strName[32];
+
+	srand(uTimers);
+	for (uint32_t i=0; i<uTimers; i++) {
+		QAH_SoftTimer_Timer& sTimer = cTimers[i];
+		uint32_t uDelay  = (i & 1) ? (1 + (rand() % QAH_SoftTimer_MaxDelay)) : (1 + (rand() % QAH_SoftTimer_MaxPeriod));
+		sTimer.uPeriod   = (i & 1) ? 0 : uDelay;
+		sTimer.uDue      = QAS_SoftTimer::getTick() + uDelay;
+		sTimer.cEntry.setHandlerFunction(QAH_SoftTimer_Callback, &sTimer);
+		QAS_SoftTimer::start(sTimer.cEntry, uDelay, sTimer.uPeriod);
+	}
+
+	uint32_t uExpiries = QAH_SoftTimer_Expiries;
+	for (uint32_t t=0; t<QAH_SoftTimer_Ticks; t++)
+		cTimes[t] = QAH_SoftTimer_Tick();
+	uExpiries = QAH_SoftTimer_Expiries - uExpiries;
+
+	snprintf(strName, sizeof(strName), "%u timers", uTimers);
+	QAH_SoftTimer_Report(strName, cTimes, (double)uExpiries / QAH_SoftTimer_Ticks);
+	QAH_CHECK_EQ(QAS_SoftTimer::getActive(), uTimers);
+
+	for (uint32_t i=0; i<uTimers; i++)
+		QAS_SoftTimer::stop(cTimers[i].cEntry);
+}
+
+
+//QAH_BenchBurst
+//Test Function
+//
+//Times the single tick on which a number of single-shot timers all expire, started far enough ahead to be cascaded from level 2 of
+//the wheel, along with the start and stop cost of each timer
+//uTimers - Number of timers
+static void QAH_BenchBurst(uint32_t uTimers) {
+	std::vector<QAH_SoftTimer_Timer> cTimers(uTimers);
+	std::vector<uint64_t>            cTimes;
+	const uint32_t                   uDelay = 5000;
+	char                             strName[32];
+
+	//Start cost, with timers restarted from their callbacks given the same delay so they stay on one tick
+	uint64_t uStart = QAH_SoftTimer_Now();
+	for (uint32_t i=0; i<uTimers; i++) {
+		QAH_SoftTimer_Timer& sTimer = cTimers[i];
+		sTimer.uPeriod = uDelay;
+		sTimer.uDue    = QAS_SoftTimer::getTick() + uDelay;
+		sTimer.cEntry.setHandlerFunction(QAH_SoftTimer_Callback, &sTimer);
+		QAS_SoftTimer::start(sTimer.cEntry, uDelay, uDelay);
+	}
+	double dStart = (double)(QAH_SoftTimer_Now() - uStart) / uTimers;
+
+	uint32_t uExpiries = QAH_SoftTimer_Expiries;
+	for (uint32_t t=0; t<=(uDelay * 3); t++) {
+		uint64_t uTime = QAH_SoftTimer_Tick();
+		if (QAH_SoftTimer_Expiries != uExpiries)
+			cTimes.push_back(uTime);
+		uExpiries = QAH_SoftTimer_Expiries;
+	}
+
+	uStart = QAH_SoftTimer_Now();
+	for (uint32_t i=0; i<uTimers; i++)
+		QAS_SoftTimer::stop(cTimers[i].cEntry);
+	double dStop = (double)(QAH_SoftTimer_Now() - uStart) / uTimers;
+
+	snprintf(strName, sizeof(strName), "%u timers on one tick", uTimers);
+	QAH_SoftTimer_Report(strName, cTimes, uTimers);
+	printf("  %-24s start %.0fns, stop %.0fns, expiry %.0fns per timer\n", "", dStart, dStop, (double)cTimes.back() / uTimers);
+	QAH_CHECK_EQ(cTimes.size(), 3);
+	QAH_CHECK_EQ(QAS_SoftTimer::getActive(), 0);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_Mock::reset();
+
+	QAS_SoftTimer_InitStruct sInit;
+	sInit.eTimer         = QAD_Timer7;
+	sInit.uTickFrequency = 1000;
+	sInit.uIRQPriority   = 5;
+	sInit.eDispatch      = QAS_SoftTimer_DispatchIRQ;
+	QAH_CHECK_EQ(QAS_SoftTimer::init(sInit), QA_OK);
+
+	QAH_TEST("Tick cost with periodic and single-shot timers");
+	const uint32_t uCounts[] = {0, 100, 1000, 10000, 30000, 60000};
+	for (uint8_t i=0; i<(sizeof(uCounts) / sizeof(uint32_t)); i++)
+		QAH_BenchMixed(uCounts[i]);
+
+	QAH_TEST("Tick cost with all timers expiring together");
+	QAH_BenchBurst(1000);
+	QAH_BenchBurst(10000);
+	QAH_BenchBurst(60000);
+
+	printf("%u expiries, %u on the wrong tick\n", QAH_SoftTimer_Expiries, QAH_SoftTimer_Late);
+	QAH_CHECK_EQ(QAH_SoftTimer_Late, 0);
+
+	QAS_SoftTimer::deinit();
+	return QAH_RESULT();
+}
@@ -0,0 +1,185 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Mock                                                   */
+/*   Role: Host Replacement for CMSIS Compiler Intrinsics                  */
+/*   Filename: QAH_CMSIS.h                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//This header is force-included (gcc -include) into every file of the host build, ahead of the CMSIS and HAL headers
+//
+//It defines the include guard of cmsis_gcc.h so that the real header, which is made up of ARM inline assembly, is skipped, and provides
+//the compiler macros and the intrinsics used by the CMSIS core header, the HAL and the QA code in its place. Interrupts are modelled by
+//a PRIMASK variable only, as there are no interrupts in the host build, and the barriers become compiler and host memory barriers
+
+//Prevent Recursive Inclusion
+#ifndef __QAH_CMSIS_H_
+#define __QAH_CMSIS_H_
+
+//Includes
+#include <stdint.h>
+
+
+//Prevent the ARM version of cmsis_gcc.h from being included
+#define __CMSIS_GCC_H
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------------------
+//Compiler Specific Defines
+
+#define __ASM                         __asm
+#define __INLINE                      inline
+#define __STATIC_INLINE               static inline
+#define __STATIC_FORCEINLINE          __attribute__((always_inline)) static inline
+#define __NO_RETURN                   __attribute__((__noreturn__))
+#define __USED                        __attribute__((used))
+#define __WEAK                        __attribute__((weak))
+#define __PACKED                      __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT               struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                  __attribute__((aligned(x)))
+#define __RESTRICT                    __restrict
+
+#define __UNALIGNED_UINT32(x)                  (*(uint32_t*)(x))
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)(*(uint16_t*)(void*)(addr) = (val))
+#define __UNALIGNED_UINT16_READ(addr)          (*(const uint16_t*)(const void*)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)(*(uint32_t*)(void*)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (*(const uint32_t*)(const void*)(addr))
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------
+//Mocked PRIMASK
+//
+//Defined in QAH_Mock.cpp. Holds 1 while interrupts are disabled, so that tests can check that critical sections are balanced
+extern volatile uint32_t QAH_PRIMASK;
+
+#ifdef __cplusplus
+}
+#endif
+
+
+//----------------------
+//Core Register Access
+
+__STATIC_FORCEINLINE void __enable_irq(void) {
+	QAH_PRIMASK = 0;
+}
+
+__STATIC_FORCEINLINE void __disable_irq(void) {
+	QAH_PRIMASK = 1;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void) {
+	return QAH_PRIMASK;
+}
+
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t uPriMask) {
+	QAH_PRIMASK = uPriMask & 0x01;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void) {
+	return 0;
+}
+
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t uBasePri) {
+	(void)uBasePri;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void) {
+	return 0;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void) {
+	return 0;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void) {
+	return 0;
+}
+
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t uFPSCR) {
+	(void)uFPSCR;
+}
+
+
+//------------------
+//Barriers and Hints
+
+#define __COMPILER_BARRIER()          __asm volatile ("" ::: "memory")
+#define __NOP()                       __COMPILER_BARRIER()
+#define __WFI()                       __COMPILER_BARRIER()
+#define __WFE()                       __COMPILER_BARRIER()
+#define __SEV()                       __COMPILER_BARRIER()
+#define __BKPT(value)                 __builtin_trap()
+
+__STATIC_FORCEINLINE void __ISB(void) {
+	__sync_synchronize();
+}
+
+__STATIC_FORCEINLINE void __DSB(void) {
+	__sync_synchronize();
+}
+
+__STATIC_FORCEINLINE void __DMB(void) {
+	__sync_synchronize();
+}
+
+
+//----------------
+//Data Processing
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t uValue) {
+	return __builtin_bswap32(uValue);
+}
+
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t uValue) {
+	return ((uValue & 0x00FF00FFUL) << 8) | ((uValue >> 8) & 0x00FF00FFUL);
+}
+
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t iValue) {
+	return (int16_t)__builtin_bswap16((uint16_t)iValue);
+}
+
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t uOp1, uint32_t uOp2) {
+	uOp2 %= 32U;
+	return (uOp2) ? ((uOp1 >> uOp2) | (uOp1 << (32U - uOp2))) : uOp1;
+}
+
+//Matches the ARM instruction, which returns 32 for an input of 0 (__builtin_clz() is undefined for 0)
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t uValue) {
+	return (uValue) ? (uint8_t)__builtin_clz(uValue) : 32U;
+}
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t uValue) {
+	uint32_t uResult = 0;
+	for (uint8_t i=0; i<32; i++) {
+		uResult = (uResult << 1) | (uValue & 0x01);
+		uValue >>= 1;
+	}
+	return uResult;
+}
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAH_CMSIS_H_ */
@@ -0,0 +1,129 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Mock                                                   */
+/*   Role: Host Register Mock                                              */
+/*   Filename: QAH_Mock.cpp                                                */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAH_Mock.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//Mocked Register Blocks
+//
+//Each block is mapped at its real address. The peripheral block covers APB1, APB2 and AHB1 (including USB OTG HS), and the core block
+//covers ITM, DWT, the System Control Space (NVIC, SCB, SysTick, CoreDebug), TPI and DBGMCU
+typedef struct {
+
+	uintptr_t uBase;  //Base address of the block
+	size_t    uSize;  //Size of the block in bytes
+
+} QAH_Mock_Block;
+
+static const QAH_Mock_Block QAH_Mock_Blocks[] = {
+	{PERIPH_BASE,     0x00080000},
+	{AHB2PERIPH_BASE, 0x00061000},
+	{ITM_BASE,        0x00043000}
+};
+
+static const uint8_t QAH_Mock_BlockCount = sizeof(QAH_Mock_Blocks) / sizeof(QAH_Mock_Block);
+
+
+//Mocked PRIMASK, used by the intrinsics in QAH_CMSIS.h
+volatile uint32_t QAH_PRIMASK = 0;
+
+//Mocked HAL tick
+static uint32_t QAH_Mock_Tick = 0;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_Mock_Map
+//Host Mock Function
+//
+//Maps the register blocks. Runs as a high priority constructor, so that the blocks are mapped before any static objects are constructed
+__attribute__((constructor(101))) static void QAH_Mock_Map(void) {
+	for (uint8_t i=0; i<QAH_Mock_BlockCount; i++) {
+		void* pBlock = mmap((void*)QAH_Mock_Blocks[i].uBase, QAH_Mock_Blocks[i].uSize, PROT_READ | PROT_WRITE,
+				                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+		if (pBlock != (void*)QAH_Mock_Blocks[i].uBase) {
+			fprintf(stderr, "QAH_Mock: unable to map registers at 0x%08lX\n", (unsigned long)QAH_Mock_Blocks[i].uBase);
+			exit(2);
+		}
+	}
+}
+
+
+  //---------------------------
+  //---------------------------
+  //QAH_Mock Control Methods
+
+//QAH_Mock::reset
+//QAH_Mock Control Method
+//
+//The RCC configuration register is left selecting the PLL as the system clock, with the APB1 and APB2 dividers set by
+//SystemInitialize() in boot.cpp, so that HAL_RCC_GetPCLK1Freq() and HAL_RCC_GetPCLK2Freq() return the clocks used on the board
+void QAH_Mock::reset(void) {
+	for (uint8_t i=0; i<QAH_Mock_BlockCount; i++)
+		memset((void*)QAH_Mock_Blocks[i].uBase, 0, QAH_Mock_Blocks[i].uSize);
+
+	RCC->CFGR       = RCC_CFGR_SWS_PLL | RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2;
+	SystemCoreClock = 168000000;
+
+	QAH_PRIMASK   = 0;
+	QAH_Mock_Tick = 0;
+}
+
+
+//QAH_Mock::getTicks
+//QAH_Mock Control Method
+uint32_t QAH_Mock::getTicks(void) {
+	return QAH_Mock_Tick;
+}
+
+
+//QAH_Mock::isMocked
+//QAH_Mock Control Method
+bool QAH_Mock::isMocked(volatile void* pAddr) {
+	uintptr_t uAddr = (uintptr_t)pAddr;
+	for (uint8_t i=0; i<QAH_Mock_BlockCount; i++) {
+		if ((uAddr >= QAH_Mock_Blocks[i].uBase) && (uAddr < (QAH_Mock_Blocks[i].uBase + QAH_Mock_Blocks[i].uSize)))
+			return true;
+	}
+	return false;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//HAL_GetTick
+//HAL Override
+//
+//Replaces the weak HAL version, which returns a tick count incremented by the SysTick interrupt
+uint32_t HAL_GetTick(void) {
+	return QAH_Mock_Tick++;
+}
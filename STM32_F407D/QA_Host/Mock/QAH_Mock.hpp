@@ -0,0 +1,69 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Mock                                                   */
+/*   Role: Host Register Mock                                              */
+/*   Filename: QAH_Mock.hpp                                                */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAH_MOCK_HPP_
+#define __QAH_MOCK_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//--------
+//QAH_ADDR
+//
+//Used by host programs to convert a register or buffer address to the uint32_t passed to the drivers. Addresses fit within 32 bits as
+//the host build is not position independent (see below)
+#define QAH_ADDR(p)  ((uint32_t)(uintptr_t)(p))
+
+
+//--------
+//QAH_Mock
+//
+//Register mock used by the host build
+//
+//Ordinary memory is mapped at the real addresses of the peripheral and core register blocks before any other code runs, so the
+//unmodified device headers, HAL and QA drivers can be compiled for the host and read and write registers through the normal
+//peripheral pointers (GPIOA, DMA2_Stream0, DWT, etc). The registers behave as plain memory: they hold whatever was last written to them,
+//and flags are never set by hardware, so tests set status flags themselves and check the values written by the code under test.
+//
+//The host build is linked without position independence (-no-pie) so that static and heap addresses fit within 32 bits, as the drivers
+//pass buffer addresses to DMA streams as uint32_t values
+class QAH_Mock {
+public:
+
+	//Used to clear all mocked registers and the mocked PRIMASK, and to restart the mocked HAL tick
+	//The system and bus clocks are then set to those set up by SystemInitialize() (168MHz, with 84MHz APB1 and 168MHz APB2 timer clocks)
+	//Should be called at the start of each test, and before any driver is used, as the driver singletons (QAD_DMAMgr, QAD_TimerMgr,
+	//QAD_ResourceMgr, etc) are not reset, and QAD_TimerMgr reads the bus clocks when it is first used
+	static void reset(void);
+
+	//Returns the number of times HAL_GetTick() has been called since reset(). HAL_GetTick() advances by 1ms on each call, so HAL
+	//timeouts expire rather than waiting for flags that the mock never sets
+	static uint32_t getTicks(void);
+
+	//Returns true if the address is within one of the mocked register blocks
+	static bool isMocked(volatile void* pAddr);
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAH_MOCK_HPP_ */
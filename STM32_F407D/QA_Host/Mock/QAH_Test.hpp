@@ -0,0 +1,73 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Mock                                                   */
+/*   Role: Host Test Checks                                                */
+/*   Filename: QAH_Test.hpp                                                */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAH_TEST_HPP_
+#define __QAH_TEST_HPP_
+
+//Includes
+#include <stdio.h>
+#include <stdint.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//---------------
+//Test Counters
+//
+//Each test program is a single translation unit, so the counters are defined here
+static uint32_t QAH_TestChecks   = 0;
+static uint32_t QAH_TestFailures = 0;
+
+
+//---------------
+//Test Check Macros
+//
+//QAH_CHECK    - Checks that a condition is true
+//QAH_CHECK_EQ - Checks that two integer values are equal, printing both values if they are not
+//QAH_TEST     - Prints the name of a test group
+//QAH_RESULT   - Prints the totals, and gives the exit code of the test program (0 if all checks passed)
+#define QAH_CHECK(cond)                                                                                     \
+	do {                                                                                                      \
+		QAH_TestChecks++;                                                                                       \
+		if (!(cond)) {                                                                                          \
+			QAH_TestFailures++;                                                                                   \
+			printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);                                              \
+		}                                                                                                       \
+	} while (0)
+
+#define QAH_CHECK_EQ(actual, expected)                                                                      \
+	do {                                                                                                      \
+		long long iActual_   = (long long)(actual);                                                             \
+		long long iExpected_ = (long long)(expected);                                                           \
+		QAH_TestChecks++;                                                                                       \
+		if (iActual_ != iExpected_) {                                                                           \
+			QAH_TestFailures++;                                                                                   \
+			printf("  FAIL %s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, iActual_, iExpected_); \
+		}                                                                                                       \
+	} while (0)
+
+#define QAH_TEST(name)  printf("%s\n", name)
+
+#define QAH_RESULT()                                                                                        \
+	(printf("%u checks, %u failures\n", (unsigned)QAH_TestChecks, (unsigned)QAH_TestFailures), (QAH_TestFailures ? 1 : 0))
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAH_TEST_HPP_ */
@@ -0,0 +1,168 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAT_AccelCurve Floating Point Reference Check                   */
+/*   Filename: QAH_AccelCurve_Test.cpp                                     */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Checks QAT_AccelCurve::getGain() at every 16bit speed against a floating point reference, for a range of curve parameters
+//
+//Each gain is compared with two references. The first is straight line interpolation between exact points of the curve, which is what
+//the table is intended to hold, so the difference is only due to the fixed point table values and interpolation. The second is the exact
+//power curve, where the difference also includes the error of approximating the curve with straight line segments. Each is checked
+//against a bound found from the curve parameters, and the gain is checked to never fall as the speed rises
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAT_AccelCurve.hpp"
+
+#include <math.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------------
+//QAH_AccelCurve_Params
+//
+//Parameters of a curve under test
+typedef struct {
+
+	uint8_t  uMaxGain;
+	uint16_t uThreshold;
+	uint16_t uFull;
+	uint8_t  uPower;
+
+} QAH_AccelCurve_Params;
+
+
+//The table is built by the compiler, so its values can be checked at compile time
+constexpr QAT_AccelCurve QAH_AccelCurve_Constexpr(16, 100, 1700, 2);
+static_assert(QAH_AccelCurve_Constexpr.getGain(100) == QAT_AccelCurve_Unity, "gain at the threshold must be 1");
+static_assert(QAH_AccelCurve_Constexpr.getGain(1700) == (16 * QAT_AccelCurve_Unity), "gain at full speed must be the maximum gain");
+static_assert(QAH_AccelCurve_Constexpr[32] == (QAT_AccelCurve_Unity + ((15 * QAT_AccelCurve_Unity) / 4)), "gain at half way must be 1/4");
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_AccelCurve_Exact
+//Test Helper Function
+//
+//Returns the exact gain at a position t along the curve (0 to 1), in 8.8 fixed point units
+static double QAH_AccelCurve_Exact(const QAH_AccelCurve_Params& sParams, double dT) {
+	uint8_t uMaxGain = (sParams.uMaxGain) ? sParams.uMaxGain : 1;
+	return QAT_AccelCurve_Unity * (1.0 + ((uMaxGain - 1) * pow(dT, sParams.uPower)));
+}
+
+
+//QAH_AccelCurve_Check
+//Test Helper Function
+//
+//Compares the gain at every 16bit speed with the references, and checks that the gain never falls
+//The table values are rounded to within half a unit, and getGain() truncates the interpolated value, so the gain is within 1.5 units of
+//interpolation between exact points, plus the change across 1/256 of a segment where the position along the segment is truncated.
+//Straight line segments differ from the curve by up to h^2 / 8 times its second derivative, for segments of length h = 1/64
+static void QAH_AccelCurve_Check(const QAH_AccelCurve_Params& sParams) {
+	QAT_AccelCurve cCurve(sParams.uMaxGain, sParams.uThreshold, sParams.uFull, sParams.uPower);
+	uint8_t        uMaxGain = (sParams.uMaxGain) ? sParams.uMaxGain : 1;
+	uint16_t       uFull    = cCurve.getFull();
+	double         dSpan    = uFull - sParams.uThreshold;
+
+	//Bounds
+	double dSegment   = 1.0 / QAT_AccelCurve_Segments;
+	double dMaxDelta  = QAH_AccelCurve_Exact(sParams, 1.0) - QAH_AccelCurve_Exact(sParams, 1.0 - dSegment);
+	double dStep      = dMaxDelta / 256.0;
+	double dSecond    = QAT_AccelCurve_Unity * (uMaxGain - 1) * sParams.uPower * ((sParams.uPower > 1) ? (sParams.uPower - 1) : 0);
+	double dInterpMax = 1.5 + dStep;
+	double dCurveMax  = dInterpMax + ((dSegment * dSegment * dSecond) / 8.0);
+
+	double   dInterpError = 0.0;
+	double   dCurveError  = 0.0;
+	uint32_t uFalls       = 0;
+	uint16_t uLast        = 0;
+	for (uint32_t uSpeed=0; uSpeed<=0xFFFF; uSpeed++) {
+		uint16_t uGain = cCurve.getGain((uint16_t)uSpeed);
+
+		double dT = (uSpeed <= sParams.uThreshold) ? 0.0 : ((uSpeed >= uFull) ? 1.0 : ((uSpeed - sParams.uThreshold) / dSpan));
+		double dPoint = dT * QAT_AccelCurve_Segments;
+		double dIndex = fmin(floor(dPoint), QAT_AccelCurve_Segments - 1);
+		double dStart = QAH_AccelCurve_Exact(sParams, dIndex * dSegment);
+		double dEnd   = QAH_AccelCurve_Exact(sParams, (dIndex + 1.0) * dSegment);
+		double dInterp = dStart + ((dEnd - dStart) * (dPoint - dIndex));
+
+		dInterpError = fmax(dInterpError, fabs(uGain - dInterp));
+		dCurveError  = fmax(dCurveError, fabs(uGain - QAH_AccelCurve_Exact(sParams, dT)));
+		if (uGain < uLast)
+			uFalls++;
+		uLast = uGain;
+	}
+
+	printf("  Gain %3u, speeds %5u to %5u, power %u: largest error %.2f (bound %.2f) from segments, %.2f (bound %.2f) from curve\n",
+	       sParams.uMaxGain, sParams.uThreshold, uFull, sParams.uPower, dInterpError, dInterpMax, dCurveError, dCurveMax);
+	QAH_CHECK(dInterpError <= dInterpMax);
+	QAH_CHECK(dCurveError <= dCurveMax);
+	QAH_CHECK_EQ(uFalls, 0);
+	QAH_CHECK_EQ(cCurve.getGain(0), QAT_AccelCurve_Unity);
+	QAH_CHECK_EQ(cCurve.getGain(0xFFFF), uMaxGain * QAT_AccelCurve_Unity);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestCurves
+//Test Function
+//
+//Checks curves of each power from short spans (with only a few speeds in each segment) to the full 16bit span (with 1024 speeds in each
+//segment, more than the 256 steps of the position within a segment), including the lowest and highest gains and a full speed at or below
+//the threshold
+static void QAH_TestCurves(void) {
+	QAH_TEST("Gain at every speed");
+	const QAH_AccelCurve_Params sParams[] = {
+		{32,  40,    800,   2},  //QAD_Encoder_DefaultCurve
+		{8,   10,    200,   1},
+		{8,   10,    200,   2},
+		{8,   10,    200,   3},
+		{8,   10,    200,   4},
+		{1,   0,     1000,  2},
+		{0,   0,     1000,  2},
+		{2,   500,   501,   3},
+		{255, 0,     65535, 1},
+		{255, 0,     65535, 2},
+		{255, 0,     65535, 3},
+		{255, 0,     65535, 8},
+		{255, 20,    16404, 3},
+		{64,  1000,  4000,  2},
+		{12,  30000, 30000, 2},
+		{12,  65534, 65535, 3},
+	};
+
+	for (uint8_t i=0; i<(sizeof(sParams) / sizeof(QAH_AccelCurve_Params)); i++)
+		QAH_AccelCurve_Check(sParams[i]);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_TestCurves();
+	return QAH_RESULT();
+}
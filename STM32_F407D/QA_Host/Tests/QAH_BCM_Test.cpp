@@ -0,0 +1,218 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAT_BCM Table Checks                                            */
+/*   Filename: QAH_BCM_Test.cpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Checks the bit-plane tables built by QAT_BCM against the duty values of the pins
+//
+//Each check renders every assigned pin with render() and compares the result with getDuty(), and also applies the tables to a model of
+//the GPIO output data register, one BSRR write per slot held for 2^k ticks as QAD_SoftPWM does, counting the ticks each pin is high. The
+//model is independent of render(), so it also checks that no table entry both sets and resets a pin, and that pins not assigned to a port
+//are never written
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAT_BCM.hpp"
+
+#include <stdlib.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//--------------------
+//BCM Test Definitions
+//
+//QAH_BCM_Masks   - Pins assigned to each port in the tests
+//QAH_BCM_Unowned - Starting level of the output data register, used to check that unassigned pins are left alone
+const uint16_t QAH_BCM_Masks[QAT_BCM_MaxPorts] = {0xFFFF, 0xA5F0, 0x0001};
+const uint16_t QAH_BCM_Unowned                 = 0x5A5A;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_BCM_Apply
+//Test Helper Function
+//
+//Applies the table of a port to a model of its output data register for one cycle, counting the ticks each pin is high
+//A BSRR write with both the set and reset bit of a pin sets the pin (as on the STM32), which the table must never rely on
+//pTable - Table of BSRR values, one per slot
+//uBits  - Number of slots
+//pHigh  - Set to the number of ticks each of the 16 pins is high
+//Returns the output data register after the cycle
+static uint16_t QAH_BCM_Apply(const uint32_t* pTable, uint8_t uBits, uint16_t* pHigh) {
+	uint16_t uODR = QAH_BCM_Unowned;
+	for (uint8_t p=0; p<QAT_BCM_PortPins; p++)
+		pHigh[p] = 0;
+
+	for (uint8_t k=0; k<uBits; k++) {
+		uODR = (uODR & ~(uint16_t)(pTable[k] >> 16)) | (uint16_t)pTable[k];
+		for (uint8_t p=0; p<QAT_BCM_PortPins; p++) {
+			if (uODR & (1 << p))
+				pHigh[p] += (1 << k);
+		}
+	}
+	return uODR;
+}
+
+
+//QAH_BCM_Verify
+//Test Helper Function
+//
+//Checks every pin of every port against its duty value
+//Returns the number of errors found
+static uint32_t QAH_BCM_Verify(QAT_BCM& cBCM) {
+	static uint8_t uWave[1 << QAT_BCM_MaxBits];
+	uint16_t       uHigh[QAT_BCM_PortPins];
+	uint32_t       uErrors = 0;
+
+	for (uint8_t uPort=0; uPort<QAT_BCM_MaxPorts; uPort++) {
+		const uint32_t* pTable = cBCM.getTable(uPort);
+		uint16_t        uMask  = QAH_BCM_Masks[uPort];
+		uint16_t        uODR   = QAH_BCM_Apply(pTable, cBCM.getBits(), uHigh);
+
+		//Pins not assigned to the port are never written, and no entry both sets and resets a pin
+		if ((uODR & ~uMask) != (QAH_BCM_Unowned & ~uMask))
+			uErrors++;
+		for (uint8_t k=0; k<cBCM.getBits(); k++) {
+			if ((pTable[k] & ~((uint32_t)uMask * 0x10001)) || ((pTable[k] >> 16) & pTable[k] & 0xFFFF))
+				uErrors++;
+		}
+
+		for (uint8_t uPin=0; uPin<QAT_BCM_PortPins; uPin++) {
+			if (!(uMask & (1 << uPin)))
+				continue;
+			uint16_t uDuty = cBCM.getDuty(uPort, uPin);
+
+			//Rendered waveform, and the pin in the register model, are high for exactly the duty value
+			uint16_t uCount = 0;
+			uint16_t uRendered = cBCM.render(uPort, uPin, uWave);
+			for (uint16_t t=0; t<cBCM.getMaxDuty(); t++)
+				uCount += uWave[t];
+			if ((uRendered != uDuty) || (uCount != uDuty) || (uHigh[uPin] != uDuty))
+				uErrors++;
+
+			//Each pin is driven in every slot, as either set or reset
+			for (uint8_t k=0; k<cBCM.getBits(); k++) {
+				if (!(((pTable[k] >> uPin) ^ (pTable[k] >> (uPin + 16))) & 1))
+					uErrors++;
+			}
+		}
+	}
+	return uErrors;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestAllDuties
+//Test Function
+//
+//Sets every duty value in turn on one pin at each resolution, while its neighbours hold fixed values
+static void QAH_TestAllDuties(void) {
+	QAH_TEST("Every duty value");
+
+	for (uint8_t uBits=1; uBits<=QAT_BCM_MaxBits; uBits++) {
+		QAT_BCM cBCM(uBits);
+		for (uint8_t uPort=0; uPort<QAT_BCM_MaxPorts; uPort++)
+			cBCM.setPort(uPort, QAH_BCM_Masks[uPort]);
+		cBCM.setDuty(1, 4, cBCM.getMaxDuty());
+		cBCM.setDuty(1, 13, cBCM.getMaxDuty() / 3);
+
+		uint32_t uErrors = 0;
+		for (uint32_t uDuty=0; uDuty<=cBCM.getMaxDuty(); uDuty++) {
+			cBCM.setDuty(1, 5, (uint16_t)uDuty);
+			uErrors += QAH_BCM_Verify(cBCM);
+		}
+		QAH_CHECK_EQ(uErrors, 0);
+	}
+}
+
+
+//QAH_TestRandom
+//Test Function
+//
+//Applies random duty changes to random pins of all ports, including unassigned pins and values above the maximum, checking all pins after
+//each change
+static void QAH_TestRandom(void) {
+	QAH_TEST("Random duty changes");
+
+	for (uint8_t uBits=1; uBits<=QAT_BCM_MaxBits; uBits++) {
+		QAT_BCM cBCM(uBits);
+		for (uint8_t uPort=0; uPort<QAT_BCM_MaxPorts; uPort++)
+			cBCM.setPort(uPort, QAH_BCM_Masks[uPort]);
+		srand(uBits);
+
+		uint32_t uErrors = 0;
+		for (uint32_t i=0; i<2000; i++) {
+			uint8_t  uPort = rand() % QAT_BCM_MaxPorts;
+			uint8_t  uPin  = rand() % QAT_BCM_PortPins;
+			uint16_t uDuty = rand() % (cBCM.getMaxDuty() + 2);
+			cBCM.setDuty(uPort, uPin, uDuty);
+
+			//Values above the maximum are limited, and unassigned pins are ignored
+			uint16_t uExpected = (QAH_BCM_Masks[uPort] & (1 << uPin)) ? ((uDuty > cBCM.getMaxDuty()) ? cBCM.getMaxDuty() : uDuty) : 0;
+			if (cBCM.getDuty(uPort, uPin) != uExpected)
+				uErrors++;
+			uErrors += QAH_BCM_Verify(cBCM);
+		}
+		QAH_CHECK_EQ(uErrors, 0);
+	}
+
+	//Reassigning a port returns all of its pins to 0
+	QAT_BCM cBCM(8);
+	cBCM.setPort(0, 0x00FF);
+	cBCM.setDuty(0, 3, 200);
+	cBCM.setPort(0, 0x0FF0);
+	QAH_CHECK_EQ(cBCM.getDuty(0, 3), 0);
+	for (uint8_t k=0; k<8; k++)
+		QAH_CHECK_EQ(cBCM.getTable(0)[k], 0x0FF00000);
+}
+
+
+//QAH_TestResolution
+//Test Function
+//
+//Checks that resolutions outside the supported range are limited
+static void QAH_TestResolution(void) {
+	QAH_TEST("Resolution limits");
+
+	QAT_BCM cLow(0);
+	QAH_CHECK_EQ(cLow.getBits(), 1);
+	QAH_CHECK_EQ(cLow.getMaxDuty(), 1);
+
+	QAT_BCM cHigh(QAT_BCM_MaxBits + 4);
+	QAH_CHECK_EQ(cHigh.getBits(), QAT_BCM_MaxBits);
+	QAH_CHECK_EQ(cHigh.getMaxDuty(), (1 << QAT_BCM_MaxBits) - 1);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_TestAllDuties();
+	QAH_TestRandom();
+	QAH_TestResolution();
+	return QAH_RESULT();
+}
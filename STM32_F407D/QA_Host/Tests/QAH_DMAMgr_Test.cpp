@@ -0,0 +1,399 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAD_DMAMgr and QAD_DMA Tests                                    */
+/*   Filename: QAH_DMAMgr_Test.cpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Tests the request mapping, stream selection, flag handling and interrupt routing of QAD_DMAMgr, and the register values written by
+//QAD_DMA, against the mocked DMA registers. The flags are set by the tests, as the mock has no hardware to set them
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAD_DMAMgr.hpp"
+#include "QAD_DMA.hpp"
+#include "QAD_ResourceMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//--------------
+//QAH_DMAHandler
+//
+//Records the flags passed to the handler() method of the driver that owns a stream
+class QAH_DMAHandler : public QAD_IRQHandler_CallbackClass {
+public:
+
+	uint32_t uCalls;
+	uint8_t  uFlags;
+
+	QAH_DMAHandler() :
+		uCalls(0),
+		uFlags(0) {}
+
+	void handler(void* pData) {
+		uCalls++;
+		uFlags = *(uint8_t*)pData;
+	}
+};
+
+
+//QAH_DMAInit
+//Test Helper Function
+//
+//Returns an initialization structure for a peripheral to memory, byte wide, direct mode transfer with no events
+static QAD_DMA_InitStruct QAH_DMAInit(QAD_DMA_Request eRequest, QAD_DMA_Stream eStream) {
+	QAD_DMA_InitStruct sInit;
+	sInit.eRequest     = eRequest;
+	sInit.eStream      = eStream;
+	sInit.eDirection   = QAD_DMA_PeriphToMem;
+	sInit.eMode        = QAD_DMA_Normal;
+	sInit.ePriority    = QAD_DMA_PriorityLow;
+	sInit.uPeriphAddr  = QAH_ADDR(&USART1->DR);
+	sInit.ePeriphWidth = QAD_DMA_Width8;
+	sInit.bPeriphInc   = false;
+	sInit.eMemWidth    = QAD_DMA_Width8;
+	sInit.bMemInc      = true;
+	sInit.eFIFO        = QAD_DMA_FIFODirect;
+	sInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sInit.uEvents      = 0;
+	sInit.uIRQPriority = 5;
+	return sInit;
+}
+
+
+//QAH_DMAUsage
+//Test Helper Function
+//
+//Returns the number of peripheral requests that can be serviced by a stream, found through getChannel()
+static uint8_t QAH_DMAUsage(QAD_DMA_Stream eStream) {
+	uint8_t uUsage = 0;
+	for (uint8_t i=0; i<QAD_DMA_Req_MemToMem; i++) {
+		if (QAD_DMAMgr::getChannel((QAD_DMA_Request)i, eStream) != QAD_DMA_ChannelInvalid)
+			uUsage++;
+	}
+	return uUsage;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestMapping
+//Test Function
+//
+//Checks request to stream/channel mappings against RM0090, and the stream instances and IRQs
+static void QAH_TestMapping(void) {
+	QAH_TEST("Request mapping");
+	QAH_Mock::reset();
+
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_SPI3_RX, QAD_DMA1_Stream0),    DMA_CHANNEL_0);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_TIM2_UP, QAD_DMA1_Stream1),    DMA_CHANNEL_3);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_TIM2_CH3, QAD_DMA1_Stream1),   DMA_CHANNEL_3);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_USART2_RX, QAD_DMA1_Stream5),  DMA_CHANNEL_4);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_DAC1, QAD_DMA1_Stream5),       DMA_CHANNEL_7);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_ADC1, QAD_DMA2_Stream0),       DMA_CHANNEL_0);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_USART1_TX, QAD_DMA2_Stream7),  DMA_CHANNEL_4);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_USART6_TX, QAD_DMA2_Stream7),  DMA_CHANNEL_5);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_TIM8_COM, QAD_DMA2_Stream7),   DMA_CHANNEL_7);
+
+	//Requests that a stream cannot service
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_ADC1, QAD_DMA1_Stream0),       QAD_DMA_ChannelInvalid);
+	QAH_CHECK_EQ(QAD_DMAMgr::getChannel(QAD_DMA_Req_USART1_TX, QAD_DMA2_Stream6),  QAD_DMA_ChannelInvalid);
+
+	//Memory to memory transfers are only available on DMA2
+	for (uint8_t i=0; i<QAD_DMA_StreamCount; i++) {
+		bool bValid = (QAD_DMAMgr::getChannel(QAD_DMA_Req_MemToMem, (QAD_DMA_Stream)i) != QAD_DMA_ChannelInvalid);
+		QAH_CHECK(bValid == (i >= QAD_DMA2_Stream0));
+	}
+
+	//Instances and IRQs
+	QAH_CHECK(QAD_DMAMgr::getInstance(QAD_DMA1_Stream0) == DMA1_Stream0);
+	QAH_CHECK(QAD_DMAMgr::getInstance(QAD_DMA1_Stream7) == DMA1_Stream7);
+	QAH_CHECK(QAD_DMAMgr::getInstance(QAD_DMA2_Stream3) == DMA2_Stream3);
+	QAH_CHECK_EQ(QAD_DMAMgr::getIRQ(QAD_DMA1_Stream7), DMA1_Stream7_IRQn);
+	QAH_CHECK_EQ(QAD_DMAMgr::getIRQ(QAD_DMA2_Stream4), DMA2_Stream4_IRQn);
+}
+
+
+//QAH_TestFindStream
+//Test Function
+//
+//Checks that findStream() returns the free stream able to service the fewest other requests, and skips streams in use
+static void QAH_TestFindStream(void) {
+	QAH_TEST("Stream selection");
+	QAH_Mock::reset();
+	QAH_DMAHandler cHandler;
+
+	//For every request, the stream found must service the request and have the lowest usage of the candidate streams
+	for (uint8_t i=0; i<QAD_DMA_Req_MemToMem; i++) {
+		QAD_DMA_Request eRequest = (QAD_DMA_Request)i;
+		QAD_DMA_Stream  eStream  = QAD_DMAMgr::findStream(eRequest);
+		if (eStream == QAD_DMA_StreamNone)
+			continue;
+
+		QAH_CHECK(QAD_DMAMgr::getChannel(eRequest, eStream) != QAD_DMA_ChannelInvalid);
+		for (uint8_t j=0; j<QAD_DMA_StreamCount; j++) {
+			if (QAD_DMAMgr::getChannel(eRequest, (QAD_DMA_Stream)j) != QAD_DMA_ChannelInvalid)
+				QAH_CHECK(QAH_DMAUsage(eStream) <= QAH_DMAUsage((QAD_DMA_Stream)j));
+		}
+	}
+
+	//USART1_RX can use DMA2 Stream 2 or 5. Stream 5 services fewer requests, so is kept for USART1_RX before Stream 2
+	QAH_CHECK_EQ(QAD_DMAMgr::findStream(QAD_DMA_Req_USART1_RX), QAD_DMA2_Stream5);
+	QAH_CHECK_EQ(QAD_DMAMgr::registerStream(QAD_DMA2_Stream5, &cHandler), QA_OK);
+	QAH_CHECK_EQ(QAD_DMAMgr::findStream(QAD_DMA_Req_USART1_RX), QAD_DMA2_Stream2);
+	QAH_CHECK_EQ(QAD_DMAMgr::registerStream(QAD_DMA2_Stream2, &cHandler), QA_OK);
+	QAH_CHECK_EQ(QAD_DMAMgr::findStream(QAD_DMA_Req_USART1_RX), QAD_DMA_StreamNone);
+
+	//Register and deregister
+	QAH_CHECK_EQ(QAD_DMAMgr::getStreamsActive(), 2);
+	QAH_CHECK_EQ(QAD_DMAMgr::getStreamsInactive(), QAD_DMA_StreamCount - 2);
+	QAH_CHECK_EQ(QAD_DMAMgr::registerStream(QAD_DMA2_Stream5, &cHandler), QA_Error_PeriphBusy);
+	QAH_CHECK_EQ(QAD_DMAMgr::registerStream(QAD_DMA_StreamNone, &cHandler), QA_Fail);
+	QAH_CHECK_EQ(QAD_DMAMgr::getState(QAD_DMA2_Stream5), QAD_DMA_InUse);
+
+	QAD_DMAMgr::deregisterStream(QAD_DMA2_Stream5);
+	QAD_DMAMgr::deregisterStream(QAD_DMA2_Stream2);
+	QAH_CHECK_EQ(QAD_DMAMgr::getState(QAD_DMA2_Stream5), QAD_DMA_Unused);
+	QAH_CHECK_EQ(QAD_DMAMgr::getStreamsActive(), 0);
+	QAH_CHECK_EQ(QAD_DMAMgr::findStream(QAD_DMA_Req_USART1_RX), QAD_DMA2_Stream5);
+}
+
+
+//QAH_TestFlags
+//Test Function
+//
+//Checks that each stream's flags are read from and cleared in the correct register at the correct bit offset, and that irqHandler()
+//clears the flags before passing them to the owner of the stream
+static void QAH_TestFlags(void) {
+	QAH_TEST("Flags and interrupt routing");
+	const uint8_t uShifts[4] = {0, 6, 16, 22};
+
+	for (uint8_t i=0; i<QAD_DMA_StreamCount; i++) {
+		QAH_Mock::reset();
+		QAD_DMA_Stream eStream = (QAD_DMA_Stream)i;
+		DMA_TypeDef*   pDMA    = (i < QAD_DMA2_Stream0) ? DMA1 : DMA2;
+		bool           bHigh   = (i & 0x04);
+		uint8_t        uShift  = uShifts[i & 0x03];
+
+		//Set transfer complete and half transfer, plus the reserved bit 1 which must be masked out
+		uint32_t uISR = (uint32_t)(QAD_DMA_Event_TransferComplete | QAD_DMA_Event_HalfTransfer | 0x02) << uShift;
+		if (bHigh)
+			pDMA->HISR = uISR;
+		else
+			pDMA->LISR = uISR;
+		QAH_CHECK_EQ(QAD_DMAMgr::getFlags(eStream), QAD_DMA_Event_TransferComplete | QAD_DMA_Event_HalfTransfer);
+
+		//Flags in the other register must be ignored
+		if (bHigh)
+			pDMA->LISR = 0xFFFFFFFF;
+		else
+			pDMA->HISR = 0xFFFFFFFF;
+		QAH_CHECK_EQ(QAD_DMAMgr::getFlags(eStream), QAD_DMA_Event_TransferComplete | QAD_DMA_Event_HalfTransfer);
+
+		QAD_DMAMgr::clearFlags(eStream, QAD_DMA_Event_All);
+		QAH_CHECK_EQ(bHigh ? pDMA->HIFCR : pDMA->LIFCR, (uint32_t)QAD_DMA_Event_All << uShift);
+		QAH_CHECK_EQ(bHigh ? pDMA->LIFCR : pDMA->HIFCR, 0);
+
+		//Interrupt routing
+		QAH_DMAHandler cHandler;
+		QAD_DMAMgr::registerStream(eStream, &cHandler);
+		if (bHigh) {
+			pDMA->HISR  = (uint32_t)QAD_DMA_Event_TransferError << uShift;
+			pDMA->HIFCR = 0;
+		} else {
+			pDMA->LISR  = (uint32_t)QAD_DMA_Event_TransferError << uShift;
+			pDMA->LIFCR = 0;
+		}
+		QAD_DMAMgr::irqHandler(eStream);
+		QAH_CHECK_EQ(cHandler.uCalls, 1);
+		QAH_CHECK_EQ(cHandler.uFlags, QAD_DMA_Event_TransferError);
+		QAH_CHECK_EQ(bHigh ? pDMA->HIFCR : pDMA->LIFCR, (uint32_t)QAD_DMA_Event_TransferError << uShift);
+		QAD_DMAMgr::deregisterStream(eStream);
+
+		//A stream without an owner is still cleared
+		QAD_DMAMgr::irqHandler(eStream);
+		QAH_CHECK_EQ(cHandler.uCalls, 1);
+	}
+}
+
+
+//QAH_TestDriverInit
+//Test Function
+//
+//Checks the stream configuration written by QAD_DMA::init(), and that the stream, IRQ and stream registration are released by deinit()
+static void QAH_TestDriverInit(void) {
+	QAH_TEST("Driver initialization");
+	QAH_Mock::reset();
+
+	//Automatic stream selection, circular mode, half-word peripheral and word memory widths, high priority
+	QAD_DMA_InitStruct sInit = QAH_DMAInit(QAD_DMA_Req_USART1_RX, QAD_DMA_StreamNone);
+	sInit.eMode        = QAD_DMA_Circular;
+	sInit.ePriority    = QAD_DMA_PriorityHigh;
+	sInit.ePeriphWidth = QAD_DMA_Width16;
+	sInit.eMemWidth    = QAD_DMA_Width32;
+	sInit.uEvents      = QAD_DMA_Event_TransferComplete | QAD_DMA_Event_TransferError;
+
+	QAD_DMA* pDMA = new QAD_DMA(sInit);
+	QAH_CHECK_EQ(pDMA->getStream(), QAD_DMA_StreamNone);
+	QAH_CHECK_EQ(pDMA->init(), QA_OK);
+	QAH_CHECK_EQ(pDMA->getStream(), QAD_DMA2_Stream5);
+	QAH_CHECK_EQ(QAD_DMAMgr::getState(QAD_DMA2_Stream5), QAD_DMA_InUse);
+
+	uint32_t uCR = DMA2_Stream5->CR;
+	QAH_CHECK_EQ(uCR & DMA_SxCR_CHSEL, DMA_CHANNEL_4);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_DIR, DMA_PERIPH_TO_MEMORY);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_CIRC, DMA_SxCR_CIRC);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_PL, DMA_PRIORITY_HIGH);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_PSIZE, DMA_PDATAALIGN_HALFWORD);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_MSIZE, DMA_MDATAALIGN_WORD);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_MINC, DMA_SxCR_MINC);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_PINC, 0);
+	QAH_CHECK_EQ(uCR & DMA_SxCR_EN, 0);
+	QAH_CHECK_EQ(DMA2_Stream5->FCR & DMA_SxFCR_DMDIS, 0);
+
+	//Stream and IRQ claims, and NVIC enable
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_DMAStream, QAD_DMA2_Stream5) != NULL);
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_IRQ, DMA2_Stream5_IRQn) != NULL);
+	QAH_CHECK(NVIC->ISER[DMA2_Stream5_IRQn >> 5] & (1UL << (DMA2_Stream5_IRQn & 0x1F)));
+
+	//Claims are only released by their holder
+	QAD_ResourceMgr::release(QAD_Resource_DMAStream, QAD_DMA2_Stream5, "Other");
+	QAD_ResourceMgr::release(QAD_Resource_IRQ, DMA2_Stream5_IRQn, "Other");
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_DMAStream, QAD_DMA2_Stream5) != NULL);
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_IRQ, DMA2_Stream5_IRQn) != NULL);
+
+	//A second driver for the same request takes the remaining stream, and a third finds none
+	QAD_DMA* pDMA2 = new QAD_DMA(sInit);
+	QAH_CHECK_EQ(pDMA2->init(), QA_OK);
+	QAH_CHECK_EQ(pDMA2->getStream(), QAD_DMA2_Stream2);
+	QAD_DMA* pDMA3 = new QAD_DMA(sInit);
+	QAH_CHECK_EQ(pDMA3->init(), QA_Error_PeriphBusy);
+	delete pDMA3;
+	delete pDMA2;
+
+	//A stream that cannot service the request is rejected
+	QAD_DMA_InitStruct sBad = QAH_DMAInit(QAD_DMA_Req_USART1_RX, QAD_DMA1_Stream0);
+	QAD_DMA* pBad = new QAD_DMA(sBad);
+	QAH_CHECK_EQ(pBad->init(), QA_Error_PeriphNotSupported);
+	delete pBad;
+
+	//Deinitialization releases everything
+	delete pDMA;
+	QAH_CHECK_EQ(QAD_DMAMgr::getStreamsActive(), 0);
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_DMAStream, QAD_DMA2_Stream5) == NULL);
+	QAH_CHECK(QAD_ResourceMgr::getHolder(QAD_Resource_IRQ, DMA2_Stream5_IRQn) == NULL);
+	QAH_CHECK(NVIC->ICER[DMA2_Stream5_IRQn >> 5] & (1UL << (DMA2_Stream5_IRQn & 0x1F)));
+}
+
+
+//QAH_TestDriverTransfers
+//Test Function
+//
+//Checks the registers written when starting single and double buffer transfers, and memory to memory restrictions
+static void QAH_TestDriverTransfers(void) {
+	QAH_TEST("Driver transfers");
+	QAH_Mock::reset();
+	static uint8_t uBuffer0[64];
+	static uint8_t uBuffer1[64];
+
+	//Single buffer transfer with FIFO error interrupt
+	QAD_DMA_InitStruct sInit = QAH_DMAInit(QAD_DMA_Req_USART2_RX, QAD_DMA1_Stream5);
+	sInit.uPeriphAddr = QAH_ADDR(&USART2->DR);
+	sInit.uEvents     = QAD_DMA_Event_TransferComplete | QAD_DMA_Event_HalfTransfer | QAD_DMA_Event_FIFOError;
+	QAD_DMA cDMA(sInit);
+	QAH_CHECK_EQ(cDMA.start(QAH_ADDR(uBuffer0), 64), QA_Fail);
+	QAH_CHECK_EQ(cDMA.init(), QA_OK);
+	QAH_CHECK_EQ(cDMA.startDoubleBuffer(QAH_ADDR(uBuffer0), QAH_ADDR(uBuffer1), 64), QA_Error_PeriphNotSupported);
+
+	DMA1->HIFCR = 0;
+	QAH_CHECK_EQ(cDMA.start(QAH_ADDR(uBuffer0), 64), QA_OK);
+	QAH_CHECK_EQ(cDMA.getState(), QA_Active);
+	QAH_CHECK_EQ(DMA1_Stream5->NDTR, 64);
+	QAH_CHECK_EQ(DMA1_Stream5->PAR, QAH_ADDR(&USART2->DR));
+	QAH_CHECK_EQ(DMA1_Stream5->M0AR, QAH_ADDR(uBuffer0));
+	QAH_CHECK_EQ(DMA1_Stream5->CR & (DMA_SxCR_EN | DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DBM),
+	             DMA_SxCR_EN | DMA_SxCR_TCIE | DMA_SxCR_HTIE);
+	QAH_CHECK_EQ(DMA1_Stream5->FCR & DMA_SxFCR_FEIE, DMA_SxFCR_FEIE);
+	QAH_CHECK_EQ(DMA1->HIFCR, (uint32_t)QAD_DMA_Event_All << 6);
+	QAH_CHECK_EQ(cDMA.start(QAH_ADDR(uBuffer0), 64), QA_Fail);
+
+	//Transfer complete in normal mode makes the driver inactive
+	DMA1->HISR = (uint32_t)QAD_DMA_Event_TransferComplete << 6;
+	QAD_DMAMgr::irqHandler(QAD_DMA1_Stream5);
+	QAH_CHECK_EQ(cDMA.getState(), QA_Inactive);
+
+	cDMA.stop();
+	QAH_CHECK_EQ(DMA1_Stream5->CR & (DMA_SxCR_EN | DMA_SxCR_TCIE | DMA_SxCR_HTIE), 0);
+	QAH_CHECK_EQ(DMA1_Stream5->FCR & DMA_SxFCR_FEIE, 0);
+	cDMA.deinit();
+
+	//Double buffer transfer
+	sInit = QAH_DMAInit(QAD_DMA_Req_ADC1, QAD_DMA2_Stream0);
+	sInit.eMode = QAD_DMA_DoubleBuffer;
+	QAD_DMA cDouble(sInit);
+	QAH_CHECK_EQ(cDouble.init(), QA_OK);
+	QAH_CHECK_EQ(DMA2_Stream0->CR & DMA_SxCR_CIRC, DMA_SxCR_CIRC);
+	QAH_CHECK_EQ(cDouble.start(QAH_ADDR(uBuffer0), 64), QA_Error_PeriphNotSupported);
+	DMA2_Stream0->CR |= DMA_SxCR_CT;
+	QAH_CHECK_EQ(cDouble.startDoubleBuffer(QAH_ADDR(uBuffer0), QAH_ADDR(uBuffer1), 32), QA_OK);
+	QAH_CHECK_EQ(DMA2_Stream0->CR & (DMA_SxCR_DBM | DMA_SxCR_CT | DMA_SxCR_EN), DMA_SxCR_DBM | DMA_SxCR_EN);
+	QAH_CHECK_EQ(DMA2_Stream0->M0AR, QAH_ADDR(uBuffer0));
+	QAH_CHECK_EQ(DMA2_Stream0->M1AR, QAH_ADDR(uBuffer1));
+	QAH_CHECK_EQ(DMA2_Stream0->NDTR, 32);
+	cDouble.setBufferAddr(1, QAH_ADDR(uBuffer0));
+	QAH_CHECK_EQ(DMA2_Stream0->M1AR, QAH_ADDR(uBuffer0));
+	cDouble.stop();
+	cDouble.deinit();
+
+	//Memory to memory transfers require the memory to memory request, normal mode, the FIFO and a DMA2 stream
+	sInit = QAH_DMAInit(QAD_DMA_Req_MemToMem, QAD_DMA_StreamNone);
+	sInit.eDirection  = QAD_DMA_MemToMem;
+	sInit.uPeriphAddr = QAH_ADDR(uBuffer1);
+	sInit.bPeriphInc  = true;
+	QAD_DMA cDirect(sInit);
+	QAH_CHECK_EQ(cDirect.init(), QA_Error_PeriphNotSupported);
+
+	sInit.eStream = QAD_DMA_StreamNone;
+	sInit.eFIFO   = QAD_DMA_FIFOFull;
+	QAD_DMA cMemToMem(sInit);
+	QAH_CHECK_EQ(cMemToMem.init(), QA_OK);
+	QAH_CHECK(cMemToMem.getStream() >= QAD_DMA2_Stream0);
+	QAH_CHECK_EQ(QAD_DMAMgr::getInstance(cMemToMem.getStream())->CR & DMA_SxCR_DIR, DMA_MEMORY_TO_MEMORY);
+	QAH_CHECK_EQ(QAD_DMAMgr::getInstance(cMemToMem.getStream())->FCR & DMA_SxFCR_DMDIS, DMA_SxFCR_DMDIS);
+	cMemToMem.deinit();
+
+	QAH_CHECK_EQ(QAD_DMAMgr::getStreamsActive(), 0);
+	QAH_CHECK_EQ(QAH_PRIMASK, 0);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_TestMapping();
+	QAH_TestFindStream();
+	QAH_TestFlags();
+	QAH_TestDriverInit();
+	QAH_TestDriverTransfers();
+	return QAH_RESULT();
+}
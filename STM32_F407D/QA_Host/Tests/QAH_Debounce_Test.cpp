@@ -0,0 +1,365 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAS_Debounce Vertical Counter Checks                            */
+/*   Filename: QAH_Debounce_Test.cpp                                       */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Checks the bit-parallel vertical counters of QAS_Debounce against a simple per pin counter
+//
+//The debouncer is run from its timer's update interrupt against the mocked GPIO input registers. Each sample, the input registers are
+//set by the test and the interrupt is raised, and the debounced levels and queued events are compared with a reference model that keeps
+//an ordinary counter for each pin. Random bouncing inputs on all 64 pins check that the two agree at every sample, and further tests check
+//the exact debounce time, active low pins, changes of port settings, and event queue overflow
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAS_Debounce.hpp"
+
+#include <stdlib.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//--------------------------
+//Debounce Test Definitions
+//
+//QAH_Debounce_Ports - Number of ports under test
+//QAH_Debounce_GPIO  - GPIO port used for each port index
+const uint8_t QAH_Debounce_Ports = QAS_Debounce_MaxPorts;
+static GPIO_TypeDef* const QAH_Debounce_GPIO[QAH_Debounce_Ports] = {GPIOA, GPIOB, GPIOC, GPIOE};
+
+
+//-------------------
+//QAH_DebounceModel
+//
+//Reference debouncer, keeping a separate counter of consecutive differing samples for each pin
+class QAH_DebounceModel {
+public:
+
+	uint16_t uMask[QAH_Debounce_Ports];
+	uint16_t uInvert[QAH_Debounce_Ports];
+	uint16_t uState[QAH_Debounce_Ports];
+	uint8_t  uCount[QAH_Debounce_Ports][16];
+
+	//Sets the debounced levels of all pins to their current levels, as QAS_Debounce::start() does
+	void reset(void) {
+		for (uint8_t p=0; p<QAH_Debounce_Ports; p++) {
+			uState[p] = (QAH_Debounce_GPIO[p]->IDR ^ uInvert[p]) & uMask[p];
+			for (uint8_t i=0; i<16; i++)
+				uCount[p][i] = 0;
+		}
+	}
+
+	//Takes a sample of each port, adding an event to pEvents for each pin that changes, ports in order and lowest pin first
+	//Returns the number of events added
+	uint16_t sample(uint32_t uTick, QAS_Debounce_Event* pEvents) {
+		uint16_t uEvents = 0;
+		for (uint8_t p=0; p<QAH_Debounce_Ports; p++) {
+			uint16_t uLevel = (QAH_Debounce_GPIO[p]->IDR ^ uInvert[p]) & uMask[p];
+			for (uint8_t i=0; i<16; i++) {
+				uint16_t uBit = 1 << i;
+				if ((uLevel & uBit) == (uState[p] & uBit)) {
+					uCount[p][i] = 0;
+					continue;
+				}
+
+				if (++uCount[p][i] < QAS_Debounce_Samples)
+					continue;
+
+				uCount[p][i] = 0;
+				uState[p]   ^= uBit;
+				pEvents[uEvents].uTick  = uTick;
+				pEvents[uEvents].uInput = (uint8_t)((p << 4) | i);
+				pEvents[uEvents].eEdge  = (uState[p] & uBit) ? QAS_Debounce_Press : QAS_Debounce_Release;
+				uEvents++;
+			}
+		}
+		return uEvents;
+	}
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_Debounce_Sample
+//Test Helper Function
+//
+//Raises the sample timer's update interrupt, as the timer would at the end of each sample period. The interrupt is routed through
+//QAD_TimerMgr::irqHandler(), as it is by TIM7_IRQHandler in handlers.cpp, which clears the flag
+static void QAH_Debounce_Sample(void) {
+	TIM7->SR = TIM_SR_UIF;
+	QAD_TimerMgr::irqHandler(QAD_Timer7);
+}
+
+
+//QAH_Debounce_Setup
+//Test Helper Function
+//
+//Stops the debouncer, sets the input registers and the ports, and starts it again, setting up the model in the same way
+static void QAH_Debounce_Setup(QAH_DebounceModel& cModel, const uint16_t* pMasks, const uint16_t* pInvert, const uint16_t* pLevels) {
+	QAS_Debounce::stop();
+	for (uint8_t p=0; p<QAH_Debounce_Ports; p++) {
+		QAH_Debounce_GPIO[p]->IDR = pLevels[p];
+		QAS_Debounce::setPort(p, QAH_Debounce_GPIO[p], pMasks[p], pInvert[p]);
+		cModel.uMask[p]   = pMasks[p];
+		cModel.uInvert[p] = pInvert[p];
+	}
+	QAS_Debounce::start();
+	cModel.reset();
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestTiming
+//Test Function
+//
+//Checks that a change is accepted on exactly the QAS_Debounce_Samples-th matching sample, and that shorter pulses are ignored
+static void QAH_TestTiming(void) {
+	QAH_TEST("Debounce time");
+	const uint16_t uMasks[QAH_Debounce_Ports]  = {0x0001, 0, 0, 0};
+	const uint16_t uInvert[QAH_Debounce_Ports] = {0, 0, 0, 0};
+	const uint16_t uLevels[QAH_Debounce_Ports] = {0, 0, 0, 0};
+	QAH_DebounceModel  cModel;
+	QAS_Debounce_Event sEvent;
+
+	QAH_Debounce_Setup(cModel, uMasks, uInvert, uLevels);
+
+	//Pulses of 1 to QAS_Debounce_Samples-1 samples are ignored
+	for (uint8_t uLength=1; uLength<QAS_Debounce_Samples; uLength++) {
+		GPIOA->IDR = 1;
+		for (uint8_t i=0; i<uLength; i++)
+			QAH_Debounce_Sample();
+		GPIOA->IDR = 0;
+		QAH_Debounce_Sample();
+	}
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 0);
+	QAH_CHECK_EQ(QAS_Debounce::getPending(), 0);
+
+	//Change is accepted on the last sample of the debounce time
+	GPIOA->IDR = 1;
+	uint32_t uStart = QAS_Debounce::getTick();
+	for (uint8_t i=1; i<QAS_Debounce_Samples; i++)
+		QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 0);
+	QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 1);
+	QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_OK);
+	QAH_CHECK_EQ(sEvent.uTick, uStart + QAS_Debounce_Samples - 1);
+	QAH_CHECK_EQ(sEvent.uInput, 0);
+	QAH_CHECK_EQ(sEvent.eEdge, QAS_Debounce_Press);
+	QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_Fail);
+
+	//A bounce during the release restarts the count
+	GPIOA->IDR = 0;
+	QAH_Debounce_Sample();
+	QAH_Debounce_Sample();
+	GPIOA->IDR = 1;
+	QAH_Debounce_Sample();
+	GPIOA->IDR = 0;
+	for (uint8_t i=1; i<QAS_Debounce_Samples; i++)
+		QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 1);
+	QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 0);
+	QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_OK);
+	QAH_CHECK_EQ(sEvent.eEdge, QAS_Debounce_Release);
+}
+
+
+//QAH_TestPorts
+//Test Function
+//
+//Checks active low pins, that pins outside the mask are ignored, that pins already active when a port is set generate no event, and that
+//an unused port index reads as 0
+static void QAH_TestPorts(void) {
+	QAH_TEST("Port settings");
+	const uint16_t uMasks[QAH_Debounce_Ports]  = {0x00F0, 0xFFFF, 0, 0x8001};
+	const uint16_t uInvert[QAH_Debounce_Ports] = {0x0030, 0x0000, 0, 0x8000};
+	const uint16_t uLevels[QAH_Debounce_Ports] = {0x0F10, 0x1234, 0xFFFF, 0x0000};
+	QAH_DebounceModel  cModel;
+	QAS_Debounce_Event sEvent;
+
+	QAH_Debounce_Setup(cModel, uMasks, uInvert, uLevels);
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(0), 0x0020);
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(1), 0x1234);
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(2), 0);
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(3), 0x8000);
+
+	for (uint8_t i=0; i<(QAS_Debounce_Samples * 2); i++)
+		QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getPending(), 0);
+
+	//Releasing an active low pin (letting it rise), and changing pins outside the mask
+	GPIOE->IDR = 0x7FFE | 0x8000;
+	GPIOC->IDR = 0;
+	for (uint8_t i=0; i<QAS_Debounce_Samples; i++)
+		QAH_Debounce_Sample();
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(3), 0x0000);
+	QAH_CHECK_EQ(QAS_Debounce::getPending(), 1);
+	QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_OK);
+	QAH_CHECK_EQ(sEvent.uInput, (3 << 4) | 15);
+	QAH_CHECK_EQ(sEvent.eEdge, QAS_Debounce_Release);
+
+	QAH_CHECK_EQ(QAS_Debounce::setPort(QAS_Debounce_MaxPorts, GPIOA, 1, 0), QA_Fail);
+	QAH_CHECK_EQ(QAS_Debounce::getInputs(QAS_Debounce_MaxPorts), 0);
+}
+
+
+//QAH_TestRandom
+//Test Function
+//
+//Runs random bouncing inputs on all pins of all ports, comparing the debounced levels and events with the model after every sample.
+//Each pin changes level occasionally, then bounces for a random number of samples before settling, so both short and long runs occur
+static void QAH_TestRandom(void) {
+	QAH_TEST("Random bouncing inputs");
+	const uint16_t   uMasks[QAH_Debounce_Ports]  = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+	const uint16_t   uInvert[QAH_Debounce_Ports] = {0x0000, 0xFFFF, 0x00FF, 0x5A5A};
+	const uint16_t   uLevels[QAH_Debounce_Ports] = {0x0000, 0xFFFF, 0x1234, 0xA5A5};
+	const uint32_t   uSamples = 200000;
+	QAH_DebounceModel  cModel;
+	QAS_Debounce_Event sExpected[QAH_Debounce_Ports * 16];
+	QAS_Debounce_Event sEvent;
+	uint8_t            uBounce[QAH_Debounce_Ports][16] = {};
+	uint16_t           uTarget[QAH_Debounce_Ports];
+
+	QAH_Debounce_Setup(cModel, uMasks, uInvert, uLevels);
+	for (uint8_t p=0; p<QAH_Debounce_Ports; p++)
+		uTarget[p] = uLevels[p];
+	srand(3);
+
+	uint32_t uStateErrors = 0;
+	uint32_t uEventErrors = 0;
+	uint32_t uEvents      = 0;
+	for (uint32_t t=0; t<uSamples; t++) {
+
+		//Each pin occasionally starts a change, then bounces randomly for up to 12 samples before settling at its new level
+		for (uint8_t p=0; p<QAH_Debounce_Ports; p++) {
+			uint16_t uIDR = 0;
+			for (uint8_t i=0; i<16; i++) {
+				if ((!uBounce[p][i]) && (!(rand() % 200))) {
+					uTarget[p]   ^= (1 << i);
+					uBounce[p][i] = 1 + (rand() % 12);
+				}
+				bool bLevel = (uTarget[p] >> i) & 1;
+				if (uBounce[p][i]) {
+					uBounce[p][i]--;
+					if (rand() & 1)
+						bLevel = !bLevel;
+				}
+				uIDR |= (uint16_t)bLevel << i;
+			}
+			QAH_Debounce_GPIO[p]->IDR = uIDR;
+		}
+
+		uint32_t uTick = QAS_Debounce::getTick();
+		uint16_t uCount = cModel.sample(uTick, sExpected);
+		QAH_Debounce_Sample();
+
+		for (uint8_t p=0; p<QAH_Debounce_Ports; p++) {
+			if (QAS_Debounce::getInputs(p) != cModel.uState[p])
+				uStateErrors++;
+		}
+
+		//Events are read every sample, so the queue never overflows
+		for (uint16_t i=0; i<uCount; i++) {
+			if ((QAS_Debounce::getEvent(sEvent) != QA_OK) || (sEvent.uTick != sExpected[i].uTick) ||
+			    (sEvent.uInput != sExpected[i].uInput) || (sEvent.eEdge != sExpected[i].eEdge))
+				uEventErrors++;
+		}
+		if (QAS_Debounce::getPending())
+			uEventErrors++;
+		uEvents += uCount;
+	}
+
+	printf("  %u samples of %u pins, %u events\n", uSamples, QAH_Debounce_Ports * 16, uEvents);
+	QAH_CHECK_EQ(uStateErrors, 0);
+	QAH_CHECK_EQ(uEventErrors, 0);
+	QAH_CHECK_EQ(QAS_Debounce::getOverflows(), 0);
+	QAH_CHECK(uEvents > 10000);
+}
+
+
+//QAH_TestOverflow
+//Test Function
+//
+//Changes all 64 pins at once without reading the queue, so that the queue overflows. The excess events are counted, the queued events are
+//the oldest ones, and the debounced levels are still correct
+static void QAH_TestOverflow(void) {
+	QAH_TEST("Event queue overflow");
+	const uint16_t uMasks[QAH_Debounce_Ports]  = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+	const uint16_t uInvert[QAH_Debounce_Ports] = {0, 0, 0, 0};
+	const uint16_t uLevels[QAH_Debounce_Ports] = {0, 0, 0, 0};
+	QAH_DebounceModel  cModel;
+	QAS_Debounce_Event sEvent;
+
+	QAH_Debounce_Setup(cModel, uMasks, uInvert, uLevels);
+	for (uint8_t p=0; p<QAH_Debounce_Ports; p++)
+		QAH_Debounce_GPIO[p]->IDR = 0xFFFF;
+	for (uint8_t i=0; i<QAS_Debounce_Samples; i++)
+		QAH_Debounce_Sample();
+	for (uint8_t p=0; p<QAH_Debounce_Ports; p++)
+		QAH_Debounce_GPIO[p]->IDR = 0;
+	for (uint8_t i=0; i<QAS_Debounce_Samples; i++)
+		QAH_Debounce_Sample();
+
+	QAH_CHECK_EQ(QAS_Debounce::getPending(), QAS_Debounce_QueueSize);
+	QAH_CHECK_EQ(QAS_Debounce::getOverflows(), (QAH_Debounce_Ports * 16 * 2) - QAS_Debounce_QueueSize);
+	for (uint8_t p=0; p<QAH_Debounce_Ports; p++)
+		QAH_CHECK_EQ(QAS_Debounce::getInputs(p), 0);
+
+	for (uint16_t i=0; i<QAS_Debounce_QueueSize; i++) {
+		QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_OK);
+		QAH_CHECK_EQ(sEvent.uInput, i);
+		QAH_CHECK_EQ(sEvent.eEdge, QAS_Debounce_Press);
+	}
+	QAH_CHECK_EQ(QAS_Debounce::getEvent(sEvent), QA_Fail);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_Mock::reset();
+
+	QAS_Debounce_InitStruct sInit;
+	sInit.eTimer           = QAD_Timer7;
+	sInit.uSampleFrequency = 1000;
+	sInit.uIRQPriority     = 5;
+	QAH_CHECK_EQ(QAS_Debounce::init(sInit), QA_OK);
+
+	QAH_TestTiming();
+	QAH_TestPorts();
+	QAH_TestRandom();
+	QAH_TestOverflow();
+
+	QAS_Debounce::deinit();
+	QAH_CHECK_EQ(__get_PRIMASK(), 0);
+
+	//An interrupt left pending once the timer has been released is cleared rather than repeating
+	TIM7->SR = TIM_SR_UIF;
+	QAD_TimerMgr::irqHandler(QAD_Timer7);
+	QAH_CHECK_EQ(TIM7->SR, 0);
+	return QAH_RESULT();
+}
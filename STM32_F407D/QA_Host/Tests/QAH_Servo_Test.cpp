@@ -0,0 +1,495 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAS_Servo and QAT_PID Plant Simulation                          */
+/*   Filename: QAH_Servo_Test.cpp                                          */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Runs QAS_Servo, with its QAD_Encoder, QAD_PWM and QAD_Timer drivers, against a simulated brushed DC motor
+//
+//The motor is driven from the PWM compare registers written by the servo, and its shaft angle is written to the encoder timer's counter.
+//The control loop timer's update interrupt is raised at the loop rate, with the motor simulated in smaller steps in between. The tests
+//check the step response (overshoot and settling), velocity tracking, and recovery from a stall with the output saturated (integrator
+//windup), and also check QAT_PID directly at the limits of its inputs and gains.
+//
+//For tuning, run with the argument "trace" to print the position step response as CSV (time, target, position, velocity command,
+//velocity and output) instead of running the tests
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAS_Servo.hpp"
+
+#include <math.h>
+#include <string.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//---------------------
+//Simulation Definitions
+//
+//QAH_Servo_LoopFrequency - Control loop rate in Hz
+//QAH_Servo_SubSteps      - Number of motor simulation steps per control loop period
+//QAH_Servo_PWMPeriod     - PWM counter period, giving 20kHz PWM from the 84MHz Timer 3 clock
+//QAH_Servo_CPR           - Encoder counts per revolution (a 1000 line encoder in quadrature)
+//QAH_Servo_Supply        - Bridge supply voltage in volts
+//QAH_Servo_Resistance    - Motor winding resistance in ohms
+//QAH_Servo_Inductance    - Motor winding inductance in henries
+//QAH_Servo_Kt            - Motor torque constant in Nm/A, which is also the back EMF constant in V/(rad/s)
+//QAH_Servo_Inertia       - Rotor and load inertia in kg.m^2
+//QAH_Servo_Friction      - Viscous friction in Nm/(rad/s)
+//QAH_Servo_Coulomb       - Coulomb (dry) friction in Nm
+const uint32_t QAH_Servo_LoopFrequency = 10000;
+const uint32_t QAH_Servo_SubSteps      = 10;
+const uint32_t QAH_Servo_PWMPeriod     = 4199;
+const uint32_t QAH_Servo_CPR           = 4000;
+const double   QAH_Servo_Supply        = 12.0;
+const double   QAH_Servo_Resistance    = 2.0;
+const double   QAH_Servo_Inductance    = 0.001;
+const double   QAH_Servo_Kt            = 0.02;
+const double   QAH_Servo_Inertia       = 0.000004;
+const double   QAH_Servo_Friction      = 0.000002;
+const double   QAH_Servo_Coulomb       = 0.002;
+
+
+//---------------
+//QAH_Servo_Motor
+//
+//Brushed DC motor model, with winding inductance, back EMF, viscous and Coulomb friction, and an optional external load torque or lock
+typedef struct {
+
+	double dCurrent;    //Winding current in amps
+	double dSpeed;      //Shaft speed in rad/s
+	double dAngle;      //Shaft angle in radians
+	double dLoad;       //External load torque in Nm, opposing positive rotation
+	bool   bLocked;     //Set to hold the shaft stationary (a stall or hard stop)
+
+} QAH_Servo_Motor;
+
+
+//-----------------
+//QAH_Servo_Sample
+//
+//Values recorded at each control loop sample
+typedef struct {
+
+	int64_t iPosition;  //Measured position in counts
+	int32_t iVelocity;  //Measured velocity in counts per second
+	int32_t iCommand;   //Velocity command in counts per second
+	int32_t iOutput;    //Motor output in PWM counts
+
+} QAH_Servo_Sample;
+
+
+//Default Gains
+//
+//Velocity loop - Kp of 0.075 PWM counts per count/s, Ki of 15 PWM counts per count/s per second, and a feed-forward of 0.011 PWM counts
+//                per count/s, which is the output needed to balance the back EMF (full output at Supply / Kt rad/s)
+//Position loop - Kp of 160 counts/s per count, with a feed-forward gain of 1 for the profile velocity, limited to +/-300000 counts/s
+//                No integral term is needed, as the velocity loop's integral term removes any steady state position error
+static const QAT_PID_Gains QAH_Servo_VelocityGains = {4915, 100, 0, 721, -4200, 4200};
+static const QAT_PID_Gains QAH_Servo_PositionGains = {160 * QAT_PID_One, 0, 0, QAT_PID_One, -300000, 300000};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------
+//QAH_ServoRig
+//
+//Creates the encoder, PWM and servo against the register mock, and runs the control loop against the motor model
+class QAH_ServoRig {
+public:
+
+	QAH_Servo_Motor                 sMotor;
+	std::unique_ptr<QAD_Encoder>    pEncoder;
+	std::unique_ptr<QAD_PWM>        pPWM;
+	std::unique_ptr<QAS_Servo>      pServo;
+	uint32_t                        uCountMid;   //Counter value for position 0
+
+	QAH_ServoRig() :
+		sMotor{},
+		uCountMid(0) {}
+
+	//Initializes the drivers and starts the servo
+	//Returns QA_OK if all drivers were initialized
+	QA_Result init(const QAT_PID_Gains& sPositionGains, const QAT_PID_Gains& sVelocityGains) {
+		QAH_Mock::reset();
+
+		//Encoder on Timer 2 (32bit counter), channels on PA15 and PB3
+		QAD_Encoder_InitStruct sEncInit = {};
+		sEncInit.pCh1_GPIO    = GPIOA;
+		sEncInit.uCh1_Pin     = GPIO_PIN_15;
+		sEncInit.uCh1_AF      = GPIO_AF1_TIM2;
+		sEncInit.pCh2_GPIO    = GPIOB;
+		sEncInit.uCh2_Pin     = GPIO_PIN_3;
+		sEncInit.uCh2_AF      = GPIO_AF1_TIM2;
+		sEncInit.eTimer       = QAD_Timer2;
+		sEncInit.eMode        = QAD_EncoderMode_Linear;
+		sEncInit.eIndex       = QAD_EncoderIndex_Disabled;
+		sEncInit.bExtended    = true;
+		sEncInit.uIRQPriority = 1;
+		sEncInit.eVelTimer    = QAD_TimerNone;
+		pEncoder = std::make_unique<QAD_Encoder>(sEncInit);
+		if (pEncoder->init())
+			return QA_Fail;
+		pEncoder->start();
+		uCountMid = TIM2->CNT;
+		TIM2->SR  = 0;
+
+		//Sign-magnitude output on Timer 3 channels 1 and 2, on PB4 and PB5
+		QAD_PWM_InitStruct sPWMInit = {};
+		sPWMInit.eTimer     = QAD_Timer3;
+		sPWMInit.uPrescaler = 0;
+		sPWMInit.uPeriod    = QAH_Servo_PWMPeriod;
+		sPWMInit.eAlign     = QAD_PWM_AlignEdge;
+		sPWMInit.eBreak     = QAD_PWM_BreakDisabled;
+		sPWMInit.sChannels[0] = {QA_Active, GPIOB, GPIO_PIN_4, GPIO_AF2_TIM3, NULL, 0};
+		sPWMInit.sChannels[1] = {QA_Active, GPIOB, GPIO_PIN_5, GPIO_AF2_TIM3, NULL, 0};
+		pPWM = std::make_unique<QAD_PWM>(sPWMInit);
+		if (pPWM->init())
+			return QA_Fail;
+		pPWM->start();
+
+		//Servo loop on Timer 6
+		QAS_Servo_InitStruct sServoInit;
+		sServoInit.pEncoder         = pEncoder.get();
+		sServoInit.bEncoderVelocity = false;
+		sServoInit.pPWM             = pPWM.get();
+		sServoInit.eOutput          = QAS_Servo_OutputSignMag;
+		sServoInit.eChannelA        = QAD_PWM_Channel_1;
+		sServoInit.eChannelB        = QAD_PWM_Channel_2;
+		sServoInit.eTimer           = QAD_Timer6;
+		sServoInit.uLoopFrequency   = QAH_Servo_LoopFrequency;
+		sServoInit.uPositionDivider = 1;
+		sServoInit.uIRQPriority     = 2;
+		sServoInit.sPositionGains   = sPositionGains;
+		sServoInit.sVelocityGains   = sVelocityGains;
+		pServo = std::make_unique<QAS_Servo>(sServoInit);
+		if (pServo->init())
+			return QA_Fail;
+		pServo->start();
+		return QA_OK;
+	}
+
+	//Removes the drivers, in the reverse order of creation
+	void deinit(void) {
+		pServo.reset();
+		pPWM.reset();
+		pEncoder.reset();
+	}
+
+	//Runs the motor model and the control loop for a number of control loop periods
+	//pSamples - Array to be filled with the values at each sample. Can be NULL
+	void run(uint32_t uSamples, QAH_Servo_Sample* pSamples = NULL) {
+		const double dStep = 1.0 / (QAH_Servo_LoopFrequency * QAH_Servo_SubSteps);
+
+		for (uint32_t i=0; i<uSamples; i++) {
+
+			//Motor voltage from the compare values, which take effect from the next PWM period
+			double dDuty = ((double)TIM3->CCR1 - (double)TIM3->CCR2) / (QAH_Servo_PWMPeriod + 1);
+			double dVolt = dDuty * QAH_Servo_Supply;
+
+			for (uint32_t j=0; j<QAH_Servo_SubSteps; j++) {
+				sMotor.dCurrent += ((dVolt - (sMotor.dCurrent * QAH_Servo_Resistance) - (sMotor.dSpeed * QAH_Servo_Kt)) / QAH_Servo_Inductance) * dStep;
+
+				if (sMotor.bLocked) {
+					sMotor.dSpeed = 0.0;
+					continue;
+				}
+
+				double dTorque = (sMotor.dCurrent * QAH_Servo_Kt) - (sMotor.dSpeed * QAH_Servo_Friction) - sMotor.dLoad;
+				if (sMotor.dSpeed != 0.0) {
+					dTorque -= (sMotor.dSpeed > 0.0) ? QAH_Servo_Coulomb : -QAH_Servo_Coulomb;
+				} else if (fabs(dTorque) <= QAH_Servo_Coulomb) {
+					dTorque = 0.0;
+				} else {
+					dTorque -= (dTorque > 0.0) ? QAH_Servo_Coulomb : -QAH_Servo_Coulomb;
+				}
+
+				double dSpeed = sMotor.dSpeed + (dTorque / QAH_Servo_Inertia) * dStep;
+				if ((sMotor.dSpeed != 0.0) && ((dSpeed > 0.0) != (sMotor.dSpeed > 0.0)))
+					dSpeed = 0.0;  //Coulomb friction stops the shaft rather than reversing it
+				sMotor.dSpeed  = dSpeed;
+				sMotor.dAngle += sMotor.dSpeed * dStep;
+			}
+
+			//Encoder count from the shaft angle, and control loop interrupt
+			TIM2->CNT = uCountMid + (uint32_t)(int64_t)floor(sMotor.dAngle * QAH_Servo_CPR / (2.0 * M_PI));
+			TIM6->SR  = TIM_SR_UIF;
+			pServo->irqHandler();
+			TIM6->SR  = 0;
+
+			if (pSamples) {
+				pSamples[i].iPosition = pServo->getPosition();
+				pSamples[i].iVelocity = pServo->getVelocity();
+				pSamples[i].iCommand  = pServo->getVelocityCommand();
+				pSamples[i].iOutput   = pServo->getOutput();
+			}
+		}
+	}
+};
+
+
+//QAH_Servo_Overshoot
+//Test Helper Function
+//
+//Returns the largest distance past the target, in the direction of the step, as a fraction of the step size
+static double QAH_Servo_Overshoot(const QAH_Servo_Sample* pSamples, uint32_t uCount, int64_t iStart, int64_t iTarget) {
+	int64_t iPeak = 0;
+	for (uint32_t i=0; i<uCount; i++) {
+		int64_t iPast = (iTarget > iStart) ? (pSamples[i].iPosition - iTarget) : (iTarget - pSamples[i].iPosition);
+		if (iPast > iPeak)
+			iPeak = iPast;
+	}
+	return (double)iPeak / (double)llabs(iTarget - iStart);
+}
+
+
+//QAH_Servo_Settled
+//Test Helper Function
+//
+//Returns the index of the first sample after which the position stays within iBand counts of the target, or uCount if it does not settle
+static uint32_t QAH_Servo_Settled(const QAH_Servo_Sample* pSamples, uint32_t uCount, int64_t iTarget, int64_t iBand) {
+	uint32_t uSettled = uCount;
+	for (uint32_t i=uCount; i>0; i--) {
+		if (llabs(pSamples[i-1].iPosition - iTarget) > iBand)
+			break;
+		uSettled = i - 1;
+	}
+	return uSettled;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestStep
+//Test Function
+//
+//Checks the response to position steps of one revolution in each direction
+static void QAH_TestStep(void) {
+	QAH_TEST("Position step");
+	const uint32_t    uCount = QAH_Servo_LoopFrequency / 2;
+	QAH_Servo_Sample* pSamples = new QAH_Servo_Sample[uCount];
+	QAH_ServoRig      cRig;
+
+	QAH_CHECK_EQ(cRig.init(QAH_Servo_PositionGains, QAH_Servo_VelocityGains), QA_OK);
+	cRig.pServo->setMode(QAS_Servo_ModePosition);
+	cRig.run(100);
+	QAH_CHECK_EQ(cRig.pServo->getPosition(), 0);
+
+	int64_t iStart = 0;
+	int64_t iSteps[2] = {QAH_Servo_CPR, 0};
+	for (uint8_t s=0; s<2; s++) {
+		cRig.pServo->setPosition(iSteps[s]);
+		cRig.run(uCount, pSamples);
+
+		double   dOvershoot = QAH_Servo_Overshoot(pSamples, uCount, iStart, iSteps[s]);
+		uint32_t uSettled   = QAH_Servo_Settled(pSamples, uCount, iSteps[s], 2);
+		printf("  Step to %lld: overshoot %.2f%%, settled to +/-2 counts in %.1fms\n", (long long)iSteps[s], dOvershoot * 100.0,
+		       uSettled * 1000.0 / QAH_Servo_LoopFrequency);
+
+		QAH_CHECK(dOvershoot <= 0.02);
+		QAH_CHECK(uSettled < (QAH_Servo_LoopFrequency / 10));
+		QAH_CHECK(llabs(pSamples[uCount-1].iPosition - iSteps[s]) <= 1);
+		iStart = iSteps[s];
+	}
+
+	//The loop is stopped, and the output set to zero, when the mode is set to off
+	cRig.pServo->setMode(QAS_Servo_ModeOff);
+	QAH_CHECK_EQ(TIM3->CCR1, 0);
+	QAH_CHECK_EQ(TIM3->CCR2, 0);
+	QAH_CHECK_EQ(QAH_PRIMASK, 0);
+
+	cRig.deinit();
+	delete[] pSamples;
+}
+
+
+//QAH_TestVelocity
+//Test Function
+//
+//Checks that the measured velocity settles on the setpoint in velocity mode, in both directions and against a load
+static void QAH_TestVelocity(void) {
+	QAH_TEST("Velocity tracking");
+	const uint32_t    uCount = QAH_Servo_LoopFrequency / 4;
+	QAH_Servo_Sample* pSamples = new QAH_Servo_Sample[uCount];
+	QAH_ServoRig      cRig;
+
+	QAH_CHECK_EQ(cRig.init(QAH_Servo_PositionGains, QAH_Servo_VelocityGains), QA_OK);
+	cRig.pServo->setMode(QAS_Servo_ModeVelocity);
+
+	const int32_t iTargets[3] = {100000, -50000, 20000};
+	const double  dLoads[3]   = {0.0, 0.0, 0.02};
+	for (uint8_t t=0; t<3; t++) {
+		cRig.sMotor.dLoad = dLoads[t];
+		cRig.pServo->setVelocity(iTargets[t]);
+		cRig.run(uCount, pSamples);
+
+		//Average the last 1000 samples, as each velocity sample has a resolution of one count per sample period
+		int64_t iSum = 0;
+		for (uint32_t i=uCount-1000; i<uCount; i++)
+			iSum += pSamples[i].iVelocity;
+		int32_t iMean = (int32_t)(iSum / 1000);
+		printf("  Velocity %d counts/s, load %.3fNm: measured %d counts/s, output %d\n", iTargets[t], dLoads[t], iMean,
+		       pSamples[uCount-1].iOutput);
+
+		QAH_CHECK(abs(iMean - iTargets[t]) <= (abs(iTargets[t]) / 100));
+	}
+
+	cRig.deinit();
+	delete[] pSamples;
+}
+
+
+//QAH_TestWindup
+//Test Function
+//
+//Checks that the integrators do not wind up while the output is saturated. The shaft is held for half a second against a position step
+//(a stall or hard stop), so the output saturates. On release, the overshoot must be no worse than the overshoot of an ordinary step
+static void QAH_TestWindup(void) {
+	QAH_TEST("Integrator windup");
+	const uint32_t    uCount = QAH_Servo_LoopFrequency / 2;
+	QAH_Servo_Sample* pSamples = new QAH_Servo_Sample[uCount];
+	QAH_ServoRig      cRig;
+
+	QAH_CHECK_EQ(cRig.init(QAH_Servo_PositionGains, QAH_Servo_VelocityGains), QA_OK);
+	cRig.pServo->setMode(QAS_Servo_ModePosition);
+
+	//Held shaft. The output must saturate at the full PWM range
+	cRig.sMotor.bLocked = true;
+	cRig.pServo->setPosition(QAH_Servo_CPR);
+	cRig.run(uCount, pSamples);
+	QAH_CHECK_EQ(pSamples[uCount-1].iOutput, QAH_Servo_PWMPeriod + 1);
+	QAH_CHECK(cRig.pServo->isSaturated());
+	QAH_CHECK_EQ(TIM3->CCR1, QAH_Servo_PWMPeriod + 1);
+
+	//Release
+	cRig.sMotor.bLocked = false;
+	cRig.run(uCount, pSamples);
+
+	double   dOvershoot = QAH_Servo_Overshoot(pSamples, uCount, 0, QAH_Servo_CPR);
+	uint32_t uSettled   = QAH_Servo_Settled(pSamples, uCount, QAH_Servo_CPR, 2);
+	printf("  Released after 500ms stall: overshoot %.2f%%, settled to +/-2 counts in %.1fms\n", dOvershoot * 100.0,
+	       uSettled * 1000.0 / QAH_Servo_LoopFrequency);
+	QAH_CHECK(dOvershoot <= 0.02);
+	QAH_CHECK(uSettled < (QAH_Servo_LoopFrequency / 10));
+
+	//A velocity stall, with the load removed after the output has saturated
+	cRig.pServo->setMode(QAS_Servo_ModeVelocity);
+	cRig.sMotor.dLoad = 1.0;
+	cRig.pServo->setVelocity(100000);
+	cRig.run(uCount, pSamples);
+	QAH_CHECK(cRig.pServo->isSaturated());
+
+	cRig.sMotor.dLoad = 0.0;
+	cRig.run(uCount, pSamples);
+	int32_t iPeak = 0;
+	for (uint32_t i=0; i<uCount; i++) {
+		if (pSamples[i].iVelocity > iPeak)
+			iPeak = pSamples[i].iVelocity;
+	}
+	printf("  Velocity stall released: peak %d counts/s for a setpoint of 100000 counts/s\n", iPeak);
+	QAH_CHECK(iPeak <= 110000);
+
+	cRig.deinit();
+	delete[] pSamples;
+}
+
+
+//QAH_TestPIDLimits
+//Test Function
+//
+//Checks QAT_PID at the limits of its inputs and gains, where the 64bit terms are largest
+static void QAH_TestPIDLimits(void) {
+	QAH_TEST("PID limits");
+
+	//Largest gains and inputs. The output must be limited rather than overflowing to the wrong sign
+	QAT_PID_Gains sGains = {INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MIN, INT32_MAX};
+	QAT_PID cPID(sGains);
+	QAH_CHECK_EQ(cPID.update(INT32_MAX, 0, INT32_MAX), INT32_MAX);
+	QAH_CHECK_EQ(cPID.update(INT32_MIN, INT32_MIN, INT32_MIN), INT32_MIN);
+	QAH_CHECK_EQ(cPID.update(INT32_MAX, INT32_MAX, INT32_MAX), INT32_MAX);
+	QAH_CHECK(cPID.getIntegral() >= INT32_MIN);
+
+	//The measurement change is taken with wrapping arithmetic, so a measurement crossing INT32_MAX is a small change
+	QAT_PID_Gains sDeriv = {0, 0, QAT_PID_One, 0, -1000, 1000};
+	QAT_PID cDeriv(sDeriv);
+	cDeriv.update(0, INT32_MAX - 5, 0);
+	QAH_CHECK_EQ(cDeriv.update(0, (int32_t)((uint32_t)INT32_MAX + 5), 0), -10);
+
+	//The integral is held while the output is limited, so it recovers as soon as the error changes sign
+	QAT_PID_Gains sInt = {QAT_PID_One, QAT_PID_One, 0, 0, -100, 100};
+	QAT_PID cInt(sInt);
+	for (uint16_t i=0; i<1000; i++)
+		cInt.update(1000, 0, 0);
+	QAH_CHECK(cInt.isSaturated());
+	QAH_CHECK(cInt.getIntegral() <= 100);
+	QAH_CHECK(cInt.update(-10, 0, 0) < 100);
+
+	//Rounding to the nearest output value
+	QAT_PID_Gains sHalf = {QAT_PID_One / 2, 0, 0, 0, -100, 100};
+	QAT_PID cHalf(sHalf);
+	QAH_CHECK_EQ(cHalf.update(3, 0, 0), 2);
+	QAH_CHECK_EQ(cHalf.update(-3, 0, 0), -1);
+}
+
+
+//QAH_Trace
+//Tool Function
+//
+//Prints the position step response as CSV, for tuning
+static int QAH_Trace(void) {
+	const uint32_t    uCount = QAH_Servo_LoopFrequency / 2;
+	QAH_Servo_Sample* pSamples = new QAH_Servo_Sample[uCount];
+	QAH_ServoRig      cRig;
+
+	if (cRig.init(QAH_Servo_PositionGains, QAH_Servo_VelocityGains))
+		return 1;
+	cRig.pServo->setMode(QAS_Servo_ModePosition);
+	cRig.pServo->setPosition(QAH_Servo_CPR);
+	cRig.run(uCount, pSamples);
+
+	printf("time,target,position,command,velocity,output\n");
+	for (uint32_t i=0; i<uCount; i++) {
+		printf("%.4f,%u,%lld,%d,%d,%d\n", (double)i / QAH_Servo_LoopFrequency, QAH_Servo_CPR, (long long)pSamples[i].iPosition,
+		       pSamples[i].iCommand, pSamples[i].iVelocity, pSamples[i].iOutput);
+	}
+
+	cRig.deinit();
+	delete[] pSamples;
+	return 0;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(int argc, char* argv[]) {
+	if ((argc > 1) && (!strcmp(argv[1], "trace")))
+		return QAH_Trace();
+
+	QAH_TestStep();
+	QAH_TestVelocity();
+	QAH_TestWindup();
+	QAH_TestPIDLimits();
+	return QAH_RESULT();
+}
@@ -0,0 +1,316 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAT_SigmaDelta Duty and Noise Shaping Model                     */
+/*   Filename: QAH_SigmaDelta_Test.cpp                                     */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Models the output of QAT_SigmaDelta over many PWM periods, checking the claims made for it
+//
+//The average of the output sequence is compared with the target duty across the whole 16bit duty range for both orders, and the range of
+//output values is checked. The quantization noise (the difference between each output value and the target) is transformed with an FFT,
+//and the noise in the lowest part of the band is compared against the shaping expected from (1 - z^-1) and (1 - z^-1)^2, and against
+//white noise of the same power. Finally, the output is passed through a first order low pass filter standing in for an LED or RC output
+//filter, to compare the ripple and the DC error against undithered PWM
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAT_SigmaDelta.hpp"
+
+#include <math.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//--------------------------
+//Sigma-Delta Test Definitions
+//
+//QAH_SigmaDelta_Max      - Compare value for 100% duty (a 200kHz PWM from the 168MHz Timer 1 clock with a period of 839)
+//QAH_SigmaDelta_Periods  - Number of periods averaged for each duty. The first order modulator repeats within 65536 periods
+//QAH_SigmaDelta_FFTSize  - Number of periods transformed for the noise spectrum
+//QAH_SigmaDelta_Band     - Fraction of the band below which noise is measured (1/64 of the PWM frequency, an oversampling ratio of 32)
+//QAH_SigmaDelta_Filter   - Time constant of the output filter in PWM periods
+const uint32_t QAH_SigmaDelta_Max     = 840;
+const uint32_t QAH_SigmaDelta_Periods = 65536;
+const uint32_t QAH_SigmaDelta_FFTSize = 65536;
+const uint32_t QAH_SigmaDelta_Band    = 64;
+const double   QAH_SigmaDelta_Filter  = 32.0;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_SigmaDelta_Target
+//Test Helper Function
+//
+//Returns the exact target compare value for a duty
+static double QAH_SigmaDelta_Target(uint32_t uDuty) {
+	return ((double)uDuty * QAH_SigmaDelta_Max) / QAT_SigmaDelta_Full;
+}
+
+
+//QAH_SigmaDelta_FFT
+//Test Helper Function
+//
+//In place radix 2 FFT
+//pRe    - Real parts
+//pIm    - Imaginary parts
+//uCount - Number of points (a power of 2)
+static void QAH_SigmaDelta_FFT(double* pRe, double* pIm, uint32_t uCount) {
+	for (uint32_t i=1, j=0; i<uCount; i++) {
+		uint32_t uBit = uCount >> 1;
+		for (; j & uBit; uBit >>= 1)
+			j ^= uBit;
+		j ^= uBit;
+		if (i < j) {
+			double dTemp = pRe[i]; pRe[i] = pRe[j]; pRe[j] = dTemp;
+			dTemp        = pIm[i]; pIm[i] = pIm[j]; pIm[j] = dTemp;
+		}
+	}
+
+	for (uint32_t uLen=2; uLen<=uCount; uLen<<=1) {
+		double dAngle = (-2.0 * M_PI) / uLen;
+		for (uint32_t i=0; i<uCount; i+=uLen) {
+			for (uint32_t k=0; k<(uLen / 2); k++) {
+				double dWRe = cos(dAngle * k);
+				double dWIm = sin(dAngle * k);
+				uint32_t a  = i + k;
+				uint32_t b  = a + (uLen / 2);
+				double dRe  = (pRe[b] * dWRe) - (pIm[b] * dWIm);
+				double dIm  = (pRe[b] * dWIm) + (pIm[b] * dWRe);
+				pRe[b] = pRe[a] - dRe;
+				pIm[b] = pIm[a] - dIm;
+				pRe[a] += dRe;
+				pIm[a] += dIm;
+			}
+		}
+	}
+}
+
+
+//QAH_SigmaDelta_InBand
+//Test Helper Function
+//
+//Returns the fraction of the quantization noise power of a modulator that falls below 1/QAH_SigmaDelta_Band of the PWM frequency
+//The mean (the DC error, checked separately) is removed before the transform, and a Hann window is applied so that leakage from the
+//strong high frequency noise does not mask the low frequency noise
+static double QAH_SigmaDelta_InBand(QAT_SigmaDelta_Order eOrder, uint32_t uDuty) {
+	QAT_SigmaDelta cModulator(eOrder, QAH_SigmaDelta_Max);
+	double*        pRe = new double[QAH_SigmaDelta_FFTSize];
+	double*        pIm = new double[QAH_SigmaDelta_FFTSize];
+
+	cModulator.setValue(uDuty);
+	double dTarget = QAH_SigmaDelta_Target(uDuty);
+	double dMean   = 0.0;
+	for (uint32_t i=0; i<QAH_SigmaDelta_FFTSize; i++) {
+		pRe[i] = (double)cModulator.next() - dTarget;
+		dMean += pRe[i];
+	}
+	dMean /= QAH_SigmaDelta_FFTSize;
+
+	for (uint32_t i=0; i<QAH_SigmaDelta_FFTSize; i++) {
+		pRe[i] = (pRe[i] - dMean) * (0.5 - (0.5 * cos((2.0 * M_PI * i) / QAH_SigmaDelta_FFTSize)));
+		pIm[i] = 0.0;
+	}
+	QAH_SigmaDelta_FFT(pRe, pIm, QAH_SigmaDelta_FFTSize);
+
+	double dTotal = 0.0;
+	double dBand  = 0.0;
+	for (uint32_t k=1; k<(QAH_SigmaDelta_FFTSize / 2); k++) {
+		double dPower = (pRe[k] * pRe[k]) + (pIm[k] * pIm[k]);
+		dTotal += dPower;
+		if (k < (QAH_SigmaDelta_FFTSize / (2 * QAH_SigmaDelta_Band)))
+			dBand += dPower;
+	}
+
+	delete[] pRe;
+	delete[] pIm;
+	return (dTotal > 0.0) ? (dBand / dTotal) : 0.0;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestAverage
+//Test Function
+//
+//Checks the average output against the target across the duty range, and the range of output values, for each order
+static void QAH_TestAverage(void) {
+	QAH_TEST("Average duty");
+	const char* strOrders[] = {"First order", "Second order"};
+
+	for (uint8_t o=0; o<2; o++) {
+		QAT_SigmaDelta_Order eOrder = (o) ? QAT_SigmaDelta_Second : QAT_SigmaDelta_First;
+		double   dMaxError  = 0.0;
+		double   dEdgeError = 0.0;
+		uint32_t uBadRange  = 0;
+
+		for (uint32_t uDuty=0; uDuty<=QAT_SigmaDelta_Full; uDuty += ((uDuty < 1024) || (uDuty > 64512)) ? 1 : 251) {
+			QAT_SigmaDelta cModulator(eOrder, QAH_SigmaDelta_Max);
+			cModulator.setValue(uDuty);
+
+			double   dTarget = QAH_SigmaDelta_Target(uDuty);
+			uint32_t uInt    = (uint32_t)dTarget;
+			uint64_t uSum    = 0;
+			for (uint32_t i=0; i<QAH_SigmaDelta_Periods; i++) {
+				uint32_t uOut = cModulator.next();
+				uSum += uOut;
+
+				//First order outputs the two values either side of the target, second order may use one below and two above
+				uint32_t uLow  = (o) ? ((uInt) ? (uInt - 1) : 0) : uInt;
+				uint32_t uHigh = uInt + ((o) ? 2 : 1);
+				if ((uOut < uLow) || (uOut > uHigh) || (uOut > QAH_SigmaDelta_Max))
+					uBadRange++;
+			}
+
+			//Outside the clamped region at each end of the range, the average must match the target
+			double dError = fabs(((double)uSum / QAH_SigmaDelta_Periods) - dTarget);
+			if ((dTarget < 2.0) || (dTarget > (QAH_SigmaDelta_Max - 2.0))) {
+				if (dError > dEdgeError)
+					dEdgeError = dError;
+			} else if (dError > dMaxError) {
+				dMaxError = dError;
+			}
+		}
+
+		printf("  %s: largest average error %.7f counts, %.4f counts within 2 counts of 0%% or 100%%\n", strOrders[o], dMaxError, dEdgeError);
+		QAH_CHECK(dMaxError <= (4.0 / QAH_SigmaDelta_Periods));
+		QAH_CHECK(dEdgeError <= 0.5);
+		QAH_CHECK_EQ(uBadRange, 0);
+	}
+
+	//Ends of the range are exact
+	for (uint8_t o=0; o<2; o++) {
+		QAT_SigmaDelta cModulator((o) ? QAT_SigmaDelta_Second : QAT_SigmaDelta_First, QAH_SigmaDelta_Max);
+		cModulator.setValue(0);
+		QAH_CHECK_EQ(cModulator.next(), 0);
+		cModulator.setValue(QAT_SigmaDelta_Full);
+		QAH_CHECK_EQ(cModulator.next(), QAH_SigmaDelta_Max);
+		cModulator.setValue(QAT_SigmaDelta_Full + 1000);
+		QAH_CHECK_EQ(cModulator.next(), QAH_SigmaDelta_Max);
+	}
+}
+
+
+//QAH_TestNoiseShaping
+//Test Function
+//
+//Checks the share of the quantization noise below 1/64 of the PWM frequency, averaged over a set of duties
+//White noise would place 1/64 of its power in this band. Shaping by (1 - z^-1) gives a share of about wb^3 / 6pi, and (1 - z^-1)^2 about
+//wb^5 / 30pi, where wb is the band edge of pi/64 (the integrals of 4sin^2(w/2) and 16sin^4(w/2) over the band, as a share of their
+//integrals from 0 to pi).
+//The first order noise is tonal rather than spread, so its share is only checked against white noise, while the second order share must
+//be close to its expected value and well below first order
+static void QAH_TestNoiseShaping(void) {
+	QAH_TEST("Noise shaping");
+	const uint32_t uDuties[] = {311, 4099, 12345, 21000, 32771, 40000, 52429, 61237};
+	const uint8_t  uCount    = sizeof(uDuties) / sizeof(uint32_t);
+
+	double dWhite  = 1.0 / QAH_SigmaDelta_Band;
+	double dOmega  = M_PI / QAH_SigmaDelta_Band;
+	double dFirst  = pow(dOmega, 3.0) / (6.0 * M_PI);
+	double dSecond = pow(dOmega, 5.0) / (30.0 * M_PI);
+
+	double dSum[2] = {0.0, 0.0};
+	for (uint8_t i=0; i<uCount; i++) {
+		dSum[0] += QAH_SigmaDelta_InBand(QAT_SigmaDelta_First, uDuties[i]);
+		dSum[1] += QAH_SigmaDelta_InBand(QAT_SigmaDelta_Second, uDuties[i]);
+	}
+	double dMeasured[2] = {dSum[0] / uCount, dSum[1] / uCount};
+
+	printf("  In band share: white %.2e, first order %.2e (expected %.2e), second order %.2e (expected %.2e)\n", dWhite, dMeasured[0],
+	       dFirst, dMeasured[1], dSecond);
+	QAH_CHECK(dMeasured[0] < (dWhite / 4.0));
+	QAH_CHECK((dMeasured[1] > (dSecond / 3.0)) && (dMeasured[1] < (dSecond * 3.0)));
+	QAH_CHECK(dMeasured[1] < (dMeasured[0] / 100.0));
+}
+
+
+//QAH_TestFilter
+//Test Function
+//
+//Passes the output through a low pass filter of one or two poles, and measures the DC error and the peak to peak ripple once settled,
+//against PWM using only the integer part of the target. The worst case over a set of duties is reported for each.
+//Second order modulation has more noise power in total than first order, so behind a single pole (such as an LED viewed by eye, or a
+//simple RC filter) its ripple is higher. Its lower noise at low frequencies only gives less ripple behind a steeper filter
+static void QAH_TestFilter(uint8_t uPoles) {
+	printf("Filtered output, %u pole%s\n", uPoles, (uPoles > 1) ? "s" : "");
+	const char* strNames[] = {"Undithered", "First order", "Second order"};
+	const uint32_t uSettle = (uint32_t)(QAH_SigmaDelta_Filter * 20.0);
+	double dAlpha = 1.0 - exp(-1.0 / QAH_SigmaDelta_Filter);
+
+	double dDCError[3] = {0.0, 0.0, 0.0};
+	double dRipple[3]  = {0.0, 0.0, 0.0};
+	for (uint32_t uDuty=97; uDuty<QAT_SigmaDelta_Full; uDuty+=1009) {
+		double dTarget = QAH_SigmaDelta_Target(uDuty);
+
+		for (uint8_t m=0; m<3; m++) {
+			QAT_SigmaDelta cModulator((m == 2) ? QAT_SigmaDelta_Second : QAT_SigmaDelta_First, QAH_SigmaDelta_Max);
+			cModulator.setValue(uDuty);
+
+			double dMid  = dTarget;
+			double dOut  = dTarget;
+			double dLow  = 1e9;
+			double dHigh = -1e9;
+			double dSum  = 0.0;
+			for (uint32_t i=0; i<(uSettle + QAH_SigmaDelta_Periods); i++) {
+				double dIn = (m) ? (double)cModulator.next() : floor(dTarget);
+				if (uPoles > 1) {
+					dMid += (dIn - dMid) * dAlpha;
+					dIn   = dMid;
+				}
+				dOut += (dIn - dOut) * dAlpha;
+				if (i < uSettle)
+					continue;
+				dLow  = fmin(dLow, dOut);
+				dHigh = fmax(dHigh, dOut);
+				dSum += dOut;
+			}
+
+			dDCError[m] = fmax(dDCError[m], fabs((dSum / QAH_SigmaDelta_Periods) - dTarget));
+			dRipple[m]  = fmax(dRipple[m], dHigh - dLow);
+		}
+	}
+
+	for (uint8_t m=0; m<3; m++)
+		printf("  %s: DC error %.4f counts, ripple %.4f counts peak to peak\n", strNames[m], dDCError[m], dRipple[m]);
+
+	//Dithered output settles to the target, with ripple far below the one count steps of undithered PWM
+	QAH_CHECK(dDCError[0] > 0.5);
+	QAH_CHECK(dDCError[1] < 0.001);
+	QAH_CHECK(dDCError[2] < 0.001);
+	QAH_CHECK(dRipple[1] < 0.1);
+	QAH_CHECK(dRipple[2] < 0.1);
+	if (uPoles > 1)
+		QAH_CHECK(dRipple[2] < dRipple[1]);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_TestAverage();
+	QAH_TestNoiseShaping();
+	QAH_TestFilter(1);
+	QAH_TestFilter(2);
+	return QAH_RESULT();
+}
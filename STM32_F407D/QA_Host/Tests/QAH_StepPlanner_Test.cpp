@@ -0,0 +1,433 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tests                                                  */
+/*   Role: QAT_StepPlanner Profile Checks                                  */
+/*   Filename: QAH_StepPlanner_Test.cpp                                    */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Checks the step timing of QAT_StepPlanner against a floating point reference of the same motion
+//
+//The reference plans the junction speeds of a set of moves in the same way as the planner (a reverse pass and a forward pass over the
+//squared speeds), then finds the exact time at which each step is reached from the trapezoid or smoothstep speed curve of each move.
+//The time of every step produced by the planner (the sum of the intervals returned by next()) is compared with the reference, along with
+//the speed at the end of each move, so the checks cover the acceleration, cruise and deceleration of both profiles, short moves that do
+//not reach their requested speed, the junction speeds between moves, and reversals. A long run of random moves, added while steps are
+//being generated, checks that the motor always stops before reversing and finishes at exactly the requested position
+
+//Includes
+#include "QAH_Mock.hpp"
+#include "QAH_Test.hpp"
+
+#include "QAT_StepPlanner.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-----------------------
+//Step Planner Test Definitions
+//
+//QAH_StepPlanner_TickFrequency - Tick frequency of the planner, matching a 1MHz step timer
+//QAH_StepPlanner_MinTicks      - Shortest interval, giving a top speed of 100000 steps/s
+//QAH_StepPlanner_StepTolerance - Largest allowed difference between the time of a step from the start of its move and the reference, in
+//                                ticks. S-curve steps are solved to within a tick, and the fixed point speeds add a little more
+//QAH_StepPlanner_MaxSteps      - Largest number of steps in a test sequence
+const uint32_t QAH_StepPlanner_TickFrequency = 1000000;
+const uint32_t QAH_StepPlanner_MinTicks      = 10;
+const double   QAH_StepPlanner_StepTolerance = 4.0;
+const uint32_t QAH_StepPlanner_MaxSteps      = 100000;
+
+
+//-------------------
+//QAH_StepPlanner_Move
+//
+//Describes a move for the planner and the reference
+typedef struct {
+
+	int32_t         iSteps;    //Length of the move in steps, negative for the negative direction
+	uint32_t        uSpeed;    //Requested speed in steps/s
+	uint32_t        uAccel;    //Peak acceleration in steps/s^2
+	QAT_StepProfile eProfile;  //Acceleration profile
+
+} QAH_StepPlanner_Move;
+
+
+//--------------------
+//QAH_StepPlanner_Step
+//
+//Values recorded at each step produced by the planner
+typedef struct {
+
+	double   dTime;    //Time of the step in ticks from the start of the sequence
+	int32_t  iDir;     //Direction of the step (+1 or -1)
+	uint32_t uSpeed;   //Speed reported by getSpeed() before the step, which is the speed at the previous step, or the entry speed of the move
+	                   //for the first step of a move
+
+} QAH_StepPlanner_Step;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_StepPlanner_Accel2
+//Test Helper Function
+//
+//Returns the change in squared speed per step of a move, which is 2a for a trapezoid, and 4a/3 for an S-curve (whose average acceleration
+//over a speed change is 2/3 of its peak)
+static double QAH_StepPlanner_Accel2(const QAH_StepPlanner_Move& sMove) {
+	return (sMove.eProfile == QAT_StepProfile_SCurve) ? ((4.0 * sMove.uAccel) / 3.0) : (2.0 * sMove.uAccel);
+}
+
+
+//QAH_StepPlanner_Plan
+//Test Helper Function
+//
+//Finds the entry and exit speed of each move of a sequence
+//Moves in the same direction meet at no more than the lower of their requested speeds, reversals meet at rest, and the sequence starts and
+//ends at rest. Each speed is then limited so that every move can reach its exit speed from its entry speed
+static void QAH_StepPlanner_Plan(const QAH_StepPlanner_Move* pMoves, uint8_t uCount, double* pEntry, double* pExit) {
+	double dEntry2[QAT_StepPlanner_QueueSize + 1];
+
+	dEntry2[0]      = 0.0;
+	dEntry2[uCount] = 0.0;
+	for (uint8_t i=1; i<uCount; i++) {
+		bool bReverse = ((pMoves[i].iSteps > 0) != (pMoves[i-1].iSteps > 0));
+		double dNominal2 = fmin((double)pMoves[i].uSpeed * pMoves[i].uSpeed, (double)pMoves[i-1].uSpeed * pMoves[i-1].uSpeed);
+		dEntry2[i] = (bReverse) ? 0.0 : dNominal2;
+	}
+
+	for (uint8_t i=uCount; i>0; i--)
+		dEntry2[i-1] = fmin(dEntry2[i-1], dEntry2[i] + (QAH_StepPlanner_Accel2(pMoves[i-1]) * abs(pMoves[i-1].iSteps)));
+
+	for (uint8_t i=0; i<uCount; i++)
+		dEntry2[i+1] = fmin(dEntry2[i+1], dEntry2[i] + (QAH_StepPlanner_Accel2(pMoves[i]) * abs(pMoves[i].iSteps)));
+
+	for (uint8_t i=0; i<uCount; i++) {
+		pEntry[i] = sqrt(dEntry2[i]);
+		pExit[i]  = sqrt(dEntry2[i+1]);
+	}
+}
+
+
+//QAH_StepPlanner_ChangeTime
+//Test Helper Function
+//
+//Returns the time taken to cover a distance into a speed change from v0 to v1
+//Trapezoid speed changes have constant acceleration. S-curve speed changes follow v0 + (v1 - v0) * (3u^2 - 2u^3) over a time of
+//1.5 * |v1 - v0| / a, so the distance is v0 * T * u + (v1 - v0) * T * (u^3 - u^4/2), which is solved for u by bisection
+static double QAH_StepPlanner_ChangeTime(const QAH_StepPlanner_Move& sMove, double dV0, double dV1, double dDistance) {
+	if (sMove.eProfile == QAT_StepProfile_Trapezoid) {
+		double dA = (dV1 > dV0) ? (double)sMove.uAccel : -(double)sMove.uAccel;
+		double dV = sqrt(fmax((dV0 * dV0) + (2.0 * dA * dDistance), 0.0));
+		return (dV - dV0) / dA;
+	}
+
+	double dT    = (1.5 * fabs(dV1 - dV0)) / sMove.uAccel;
+	double dLow  = 0.0;
+	double dHigh = 1.0;
+	for (uint8_t i=0; i<64; i++) {
+		double dU = (dLow + dHigh) / 2.0;
+		double dX = (dV0 * dT * dU) + ((dV1 - dV0) * dT * ((dU * dU * dU) - ((dU * dU * dU * dU) / 2.0)));
+		if (dX < dDistance)
+			dLow = dU;
+		else
+			dHigh = dU;
+	}
+	return dT * ((dLow + dHigh) / 2.0);
+}
+
+
+//QAH_StepPlanner_Reference
+//Test Helper Function
+//
+//Finds the time of each step of a move, in ticks from the start of the move, from its entry and exit speeds
+//The top speed is the requested speed, or the speed at which the acceleration and deceleration meet if the move is too short to reach it
+//Returns the duration of the move in ticks
+static double QAH_StepPlanner_Reference(const QAH_StepPlanner_Move& sMove, double dEntry, double dExit, double* pTimes) {
+	uint32_t uSteps  = abs(sMove.iSteps);
+	double   dAccel2 = QAH_StepPlanner_Accel2(sMove);
+	double   dTop    = fmin((double)sMove.uSpeed, sqrt(((dAccel2 * uSteps) + (dEntry * dEntry) + (dExit * dExit)) / 2.0));
+	dTop = fmax(dTop, fmax(dEntry, dExit));
+
+	double dAccelEnd   = ((dTop * dTop) - (dEntry * dEntry)) / dAccel2;
+	double dDecelStart = fmax(uSteps - (((dTop * dTop) - (dExit * dExit)) / dAccel2), dAccelEnd);
+	double dAccelTime  = QAH_StepPlanner_ChangeTime(sMove, dEntry, dTop, dAccelEnd);
+	double dCruiseTime = (dDecelStart - dAccelEnd) / dTop;
+
+	for (uint32_t i=1; i<=uSteps; i++) {
+		double dTime;
+		if (i <= dAccelEnd)
+			dTime = QAH_StepPlanner_ChangeTime(sMove, dEntry, dTop, i);
+		else if (i <= dDecelStart)
+			dTime = dAccelTime + ((i - dAccelEnd) / dTop);
+		else
+			dTime = dAccelTime + dCruiseTime + QAH_StepPlanner_ChangeTime(sMove, dTop, dExit, i - dDecelStart);
+		pTimes[i-1] = dTime * QAH_StepPlanner_TickFrequency;
+	}
+	return pTimes[uSteps-1];
+}
+
+
+//QAH_StepPlanner_Run
+//Test Helper Function
+//
+//Runs the planner until it is idle, recording each step
+//Returns the number of steps, or QAH_StepPlanner_MaxSteps + 1 if the planner did not finish
+static uint32_t QAH_StepPlanner_Run(QAT_StepPlanner& cPlanner, QAH_StepPlanner_Step* pSteps) {
+	double   dTime  = 0.0;
+	uint32_t uCount = 0;
+	while (cPlanner.ready()) {
+		if (uCount >= QAH_StepPlanner_MaxSteps)
+			return QAH_StepPlanner_MaxSteps + 1;
+
+		pSteps[uCount].iDir   = (cPlanner.getDir()) ? 1 : -1;
+		pSteps[uCount].uSpeed = cPlanner.getSpeed();
+		dTime += cPlanner.next();
+
+		pSteps[uCount].dTime  = dTime;
+		uCount++;
+	}
+	return uCount;
+}
+
+
+//QAH_StepPlanner_Check
+//Test Helper Function
+//
+//Queues a sequence of moves, runs the planner, and compares each step and the speed at each junction against the reference
+//Step times are compared from the time of the last step of the previous move, so that the tolerance applies to each move. The difference in
+//the duration of the whole sequence is reported separately
+static void QAH_StepPlanner_Check(const char* strName, const QAH_StepPlanner_Move* pMoves, uint8_t uCount) {
+	QAT_StepPlanner       cPlanner(QAH_StepPlanner_TickFrequency, QAH_StepPlanner_MinTicks);
+	QAH_StepPlanner_Step* pSteps = new QAH_StepPlanner_Step[QAH_StepPlanner_MaxSteps];
+	double*               pTimes = new double[QAH_StepPlanner_MaxSteps];
+	double                dEntry[QAT_StepPlanner_QueueSize];
+	double                dExit[QAT_StepPlanner_QueueSize];
+
+	int64_t  iTarget = 0;
+	uint32_t uSteps  = 0;
+	for (uint8_t i=0; i<uCount; i++) {
+		cPlanner.setAccel(pMoves[i].uAccel, pMoves[i].eProfile);
+		QAH_CHECK_EQ(cPlanner.add(pMoves[i].iSteps, pMoves[i].uSpeed), QA_OK);
+		iTarget += pMoves[i].iSteps;
+		uSteps  += abs(pMoves[i].iSteps);
+	}
+	QAH_StepPlanner_Plan(pMoves, uCount, dEntry, dExit);
+
+	uint32_t uRun = QAH_StepPlanner_Run(cPlanner, pSteps);
+	QAH_CHECK_EQ(uRun, uSteps);
+	if (uRun != uSteps) {
+		delete[] pSteps;
+		delete[] pTimes;
+		return;
+	}
+
+	//Compare step times, directions and junction speeds
+	double   dStart    = 0.0;
+	double   dDuration = 0.0;
+	double   dMaxError = 0.0;
+	double   dMaxSpeed = 0.0;
+	int64_t  iPosition = 0;
+	uint32_t uStep     = 0;
+	uint32_t uWrongDir = 0;
+	for (uint8_t i=0; i<uCount; i++) {
+		uint32_t uMoveSteps = abs(pMoves[i].iSteps);
+		int32_t  iDir       = (pMoves[i].iSteps > 0) ? 1 : -1;
+		dDuration += QAH_StepPlanner_Reference(pMoves[i], dEntry[i], dExit[i], pTimes);
+
+		for (uint32_t j=0; j<uMoveSteps; j++) {
+			double dError = fabs(pSteps[uStep + j].dTime - (dStart + pTimes[j]));
+			if (dError > dMaxError)
+				dMaxError = dError;
+			if (pSteps[uStep + j].uSpeed > dMaxSpeed)
+				dMaxSpeed = pSteps[uStep + j].uSpeed;
+			if (pSteps[uStep + j].iDir != iDir)
+				uWrongDir++;
+			iPosition += pSteps[uStep + j].iDir;
+		}
+
+		//Entry speed of the move is the planned junction speed, to within the rounding of the squared speeds
+		QAH_CHECK(fabs(pSteps[uStep].uSpeed - dEntry[i]) <= (1.0 + (dEntry[i] * 0.0001)));
+		uStep  += uMoveSteps;
+		dStart  = pSteps[uStep - 1].dTime;
+	}
+
+	printf("  %s: %u steps in %.1fms (%+.1f ticks), top speed %.0f steps/s, largest step time error %.2f ticks\n", strName, uSteps,
+	       dStart / 1000.0, dStart - dDuration, dMaxSpeed, dMaxError);
+	QAH_CHECK(dMaxError <= QAH_StepPlanner_StepTolerance);
+	QAH_CHECK_EQ(uWrongDir, 0);
+	QAH_CHECK_EQ(iPosition, iTarget);
+	QAH_CHECK(cPlanner.isIdle());
+	QAH_CHECK_EQ(cPlanner.getSpeed(), 0);
+
+	delete[] pSteps;
+	delete[] pTimes;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_TestProfiles
+//Test Function
+//
+//Checks single moves of each profile, both long enough to cruise at the requested speed and too short to reach it, and single step moves
+static void QAH_TestProfiles(void) {
+	QAH_TEST("Single move profiles");
+
+	const QAH_StepPlanner_Move sTrapCruise[]  = {{20000, 10000, 20000, QAT_StepProfile_Trapezoid}};
+	const QAH_StepPlanner_Move sTrapShort[]   = {{1000, 50000, 20000, QAT_StepProfile_Trapezoid}};
+	const QAH_StepPlanner_Move sSCurveCruise[] = {{20000, 10000, 30000, QAT_StepProfile_SCurve}};
+	const QAH_StepPlanner_Move sSCurveShort[] = {{-1000, 50000, 30000, QAT_StepProfile_SCurve}};
+	const QAH_StepPlanner_Move sSingle[]      = {{1, 1000, 20000, QAT_StepProfile_Trapezoid}, {1, 1000, 30000, QAT_StepProfile_SCurve}};
+
+	QAH_StepPlanner_Check("Trapezoid, cruising", sTrapCruise, 1);
+	QAH_StepPlanner_Check("Trapezoid, triangular", sTrapShort, 1);
+	QAH_StepPlanner_Check("S-curve, cruising", sSCurveCruise, 1);
+	QAH_StepPlanner_Check("S-curve, short", sSCurveShort, 1);
+	QAH_StepPlanner_Check("Single steps", sSingle, 2);
+}
+
+
+//QAH_TestJunctions
+//Test Function
+//
+//Checks sequences of moves that run into each other, including a move too short to slow from the previous speed (limiting the junction
+//before it), reversals, and single step moves, for each profile and with the profiles mixed
+static void QAH_TestJunctions(void) {
+	QAH_TEST("Junction speeds");
+
+	QAH_StepPlanner_Move sMoves[8] = {
+		{4000,  8000,  0, QAT_StepProfile_Trapezoid},
+		{2000,  4000,  0, QAT_StepProfile_Trapezoid},
+		{6000,  12000, 0, QAT_StepProfile_Trapezoid},
+		{50,    12000, 0, QAT_StepProfile_Trapezoid},
+		{-3000, 6000,  0, QAT_StepProfile_Trapezoid},
+		{-1,    1000,  0, QAT_StepProfile_Trapezoid},
+		{777,   9000,  0, QAT_StepProfile_Trapezoid},
+		{-2,    5000,  0, QAT_StepProfile_Trapezoid}
+	};
+
+	for (uint8_t i=0; i<8; i++)
+		sMoves[i].uAccel = 24000;
+	QAH_StepPlanner_Check("Trapezoid sequence", sMoves, 8);
+
+	for (uint8_t i=0; i<8; i++)
+		sMoves[i].eProfile = QAT_StepProfile_SCurve;
+	QAH_StepPlanner_Check("S-curve sequence", sMoves, 8);
+
+	for (uint8_t i=0; i<8; i++) {
+		sMoves[i].eProfile = (i & 1) ? QAT_StepProfile_SCurve : QAT_StepProfile_Trapezoid;
+		sMoves[i].uAccel   = (i & 1) ? 36000 : 15000;
+	}
+	QAH_StepPlanner_Check("Mixed sequence", sMoves, 8);
+
+	//Junction into a slower move runs at the slower speed, and a reversal stops
+	QAT_StepPlanner       cPlanner(QAH_StepPlanner_TickFrequency, QAH_StepPlanner_MinTicks);
+	QAH_StepPlanner_Step* pSteps = new QAH_StepPlanner_Step[QAH_StepPlanner_MaxSteps];
+	cPlanner.setAccel(20000, QAT_StepProfile_Trapezoid);
+	cPlanner.add(5000, 8000);
+	cPlanner.add(5000, 4000);
+	cPlanner.add(-2000, 4000);
+	QAH_CHECK_EQ(QAH_StepPlanner_Run(cPlanner, pSteps), 12000);
+	QAH_CHECK_EQ(pSteps[5000].uSpeed, 4000);
+	QAH_CHECK_EQ(pSteps[10000].uSpeed, 0);
+	QAH_CHECK_EQ(pSteps[10000].iDir, -1);
+	delete[] pSteps;
+}
+
+
+//QAH_TestStreaming
+//Test Function
+//
+//Runs a long sequence of random moves, adding each one as soon as there is space in the queue, as QAS_Stepper does while it is running.
+//Checks that the motor is at rest at every reversal, that no interval is shorter than the minimum, and that the final position is exact
+static void QAH_TestStreaming(void) {
+	QAH_TEST("Streamed random moves");
+	const uint32_t uMoves = 2000;
+
+	QAT_StepPlanner cPlanner(QAH_StepPlanner_TickFrequency, QAH_StepPlanner_MinTicks);
+	srand(1);
+
+	int64_t  iTarget    = 0;
+	int64_t  iPosition  = 0;
+	uint32_t uAdded     = 0;
+	uint32_t uSteps     = 0;
+	uint32_t uReversals = 0;
+	uint32_t uMoving    = 0;
+	uint32_t uShort     = 0;
+	int32_t  iLastDir   = 0;
+	double   dTime      = 0.0;
+
+	while ((uAdded < uMoves) || (!cPlanner.isIdle())) {
+		while ((uAdded < uMoves) && (cPlanner.getFree())) {
+			int32_t  iSteps = 1 + (rand() % ((rand() & 1) ? 20 : 3000));
+			uint32_t uSpeed = 100 + (rand() % 60000);
+			cPlanner.setAccel(3000 * (1 + (rand() % 20)), (rand() & 1) ? QAT_StepProfile_SCurve : QAT_StepProfile_Trapezoid);
+			if (rand() & 1)
+				iSteps = -iSteps;
+			QAH_CHECK_EQ(cPlanner.add(iSteps, uSpeed), QA_OK);
+			iTarget += iSteps;
+			uAdded++;
+
+			//Only add more than one move at a time occasionally, so that the queue is often nearly empty
+			if (rand() % 4)
+				break;
+		}
+
+		if (!cPlanner.ready())
+			continue;
+
+		//The speed before the first step of a move is its entry speed, which must be zero when it reverses
+		int32_t  iDir   = (cPlanner.getDir()) ? 1 : -1;
+		uint32_t uSpeed = cPlanner.getSpeed();
+		uint32_t uTicks = cPlanner.next();
+		if ((iLastDir) && (iDir != iLastDir)) {
+			uReversals++;
+			if (uSpeed)
+				uMoving++;
+		}
+		if (uTicks < QAH_StepPlanner_MinTicks)
+			uShort++;
+
+		iPosition += iDir;
+		iLastDir   = iDir;
+		dTime     += uTicks;
+		uSteps++;
+	}
+
+	printf("  %u moves, %u steps, %u reversals in %.2fs\n", uMoves, uSteps, uReversals, dTime / QAH_StepPlanner_TickFrequency);
+	QAH_CHECK_EQ(uMoving, 0);
+	QAH_CHECK_EQ(uShort, 0);
+	QAH_CHECK_EQ(iPosition, iTarget);
+	QAH_CHECK_EQ(cPlanner.getSpeed(), 0);
+	QAH_CHECK(uReversals > 0);
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	QAH_TestProfiles();
+	QAH_TestJunctions();
+	QAH_TestStreaming();
+	return QAH_RESULT();
+}
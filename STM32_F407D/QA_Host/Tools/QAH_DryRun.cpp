@@ -0,0 +1,202 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tools                                                  */
+/*   Role: Board Configuration Dry Run                                     */
+/*   Filename: QAH_DryRun.cpp                                              */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Checks the board configuration set up by main.cpp for resource conflicts using QAD_ResourceMgr::dryRun(), without needing the board
+//
+//The configuration is described by QAH_DryRun_Board below. After the dry run, the systems are initialized against the register mock in
+//the same way as main.cpp, and the resources they actually claim are compared against the table, so that the table is reported as out
+//of date if a driver or main.cpp changes. When adding a system to main.cpp, add its claims to the table and its initialization to
+//QAH_DryRun_InitBoard()
+//
+//Returns 0 if the configuration has no conflicts and matches the claims made by the drivers, or 1 otherwise
+
+//Includes
+#include "QAH_Mock.hpp"
+
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_DMAMgr.hpp"
+#include "QAS_Clock.hpp"
+#include "QAS_LED.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-----------------
+//QAH_DryRun_Board
+//
+//Claims made by the systems initialized in main.cpp
+//QAS_Clock - Timer 5 through QAD_Timer, including its shared update interrupt
+//QAS_LED   - Timer 4 and the four User LED pins through QAD_PWM, and the Timer 4 update DMA stream and its interrupt through QAD_DMA
+static const QAD_Resource_Claim QAH_DryRun_Board[] = {
+	{QAD_Resource_Timer,     QAD_Timer5,          false, "Timer"},
+	{QAD_Resource_IRQ,       TIM5_IRQn,           true,  "Timer"},
+
+	{QAD_Resource_Timer,     QAD_Timer4,          false, "PWM"},
+	{QAD_Resource_Pin,       (3 * 16) + 12,       false, "PWM"},  //PD12 - Green LED
+	{QAD_Resource_Pin,       (3 * 16) + 13,       false, "PWM"},  //PD13 - Orange LED
+	{QAD_Resource_Pin,       (3 * 16) + 14,       false, "PWM"},  //PD14 - Red LED
+	{QAD_Resource_Pin,       (3 * 16) + 15,       false, "PWM"},  //PD15 - Blue LED
+	{QAD_Resource_DMAStream, QAD_DMA1_Stream6,    false, "DMA"},
+	{QAD_Resource_IRQ,       DMA1_Stream6_IRQn,   false, "DMA"}
+};
+
+static const uint16_t QAH_DryRun_BoardCount = sizeof(QAH_DryRun_Board) / sizeof(QAD_Resource_Claim);
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_DryRun_InitBoard
+//Tool Function
+//
+//Initializes the systems in the same way as main.cpp
+//Returns QA_OK if all systems were initialized, or the error returned by the first system that failed
+static QA_Result QAH_DryRun_InitBoard(void) {
+	QA_Result eRes;
+
+	QAS_Clock_InitStruct sClockInit;
+	sClockInit.eTimer       = QAD_Timer5;
+	sClockInit.uIRQPriority = 0;
+	eRes = QAS_Clock::init(sClockInit);
+	if (eRes)
+		return eRes;
+
+	QAS_LED_InitStruct sLEDInit;
+	sLEDInit.eDMAStream   = QAD_DMA_StreamNone;
+	sLEDInit.uIRQPriority = 14;
+	return QAS_LED::init(sLEDInit);
+}
+
+
+//QAH_DryRun_Name
+//Tool Function
+//
+//Used to produce a readable name for a resource, in the same form as QAD_ResourceMgr::formatConflict()
+static void QAH_DryRun_Name(const QAD_Resource_Claim& sClaim, char* pStr, uint16_t uSize) {
+	switch (sClaim.eType) {
+		case (QAD_Resource_Timer):
+			snprintf(pStr, uSize, "Timer %u", sClaim.uIndex + 1);
+			break;
+		case (QAD_Resource_UART):
+			snprintf(pStr, uSize, "UART %u", sClaim.uIndex + 1);
+			break;
+		case (QAD_Resource_Pin):
+			snprintf(pStr, uSize, "Pin P%c%u", 'A' + (sClaim.uIndex / 16), sClaim.uIndex % 16);
+			break;
+		case (QAD_Resource_DMAStream):
+			snprintf(pStr, uSize, "DMA%u Stream %u", (sClaim.uIndex / 8) + 1, sClaim.uIndex % 8);
+			break;
+		case (QAD_Resource_IRQ):
+			snprintf(pStr, uSize, "IRQ %u", sClaim.uIndex);
+			break;
+		default:
+			snprintf(pStr, uSize, "EXTI line %u", sClaim.uIndex);
+			break;
+	}
+}
+
+
+//QAH_DryRun_Count
+//Tool Function
+//
+//Returns the number of claims in the board configuration for a class of resource
+//Shared interrupt claims are counted once, as getClaimed() counts interrupt lines rather than claims
+static uint8_t QAH_DryRun_Count(QAD_Resource_Type eType) {
+	uint8_t uCount = 0;
+	for (uint16_t i=0; i<QAH_DryRun_BoardCount; i++) {
+		if (QAH_DryRun_Board[i].eType != eType)
+			continue;
+
+		bool bRepeat = false;
+		for (uint16_t j=0; j<i; j++) {
+			if ((QAH_DryRun_Board[j].eType == eType) && (QAH_DryRun_Board[j].uIndex == QAH_DryRun_Board[i].uIndex))
+				bRepeat = true;
+		}
+		if (!bRepeat)
+			uCount++;
+	}
+	return uCount;
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(void) {
+	const char* strTypes[] = {"Timer", "UART", "Pin", "DMA Stream", "IRQ", "EXTI Line"};
+	char        strConflict[96];
+	char        strName[24];
+
+	QAH_Mock::reset();
+
+	//Dry run of the board configuration
+	printf("Board configuration: %u claims\n", QAH_DryRun_BoardCount);
+	QAD_Resource_Conflict sConflict;
+	QA_Result eRes = QAD_ResourceMgr::dryRun(QAH_DryRun_Board, QAH_DryRun_BoardCount, &sConflict);
+	if (eRes == QA_Fail) {
+		printf("  Invalid claim in board configuration\n");
+		return 1;
+	}
+	if (eRes) {
+		QAD_ResourceMgr::formatConflict(sConflict, strConflict, sizeof(strConflict));
+		printf("  Conflict: %s\n", strConflict);
+		return 1;
+	}
+	printf("  No conflicts\n");
+
+	//Initialize the systems against the register mock, and compare their claims with the board configuration
+	printf("Driver claims\n");
+	eRes = QAH_DryRun_InitBoard();
+	if (eRes) {
+		QAD_ResourceMgr::getConflictString(strConflict, sizeof(strConflict));
+		printf("  Initialization failed (%u): %s\n", eRes, strConflict);
+		return 1;
+	}
+
+	bool bMatch = true;
+	for (uint16_t i=0; i<QAH_DryRun_BoardCount; i++) {
+		const char* strHolder = QAD_ResourceMgr::getHolder(QAH_DryRun_Board[i].eType, QAH_DryRun_Board[i].uIndex);
+		if ((!strHolder) || (strcmp(strHolder, QAH_DryRun_Board[i].strOwner))) {
+			QAH_DryRun_Name(QAH_DryRun_Board[i], strName, sizeof(strName));
+			printf("  %s is listed for %s but held by %s\n", strName, QAH_DryRun_Board[i].strOwner, strHolder ? strHolder : "nothing");
+			bMatch = false;
+		}
+	}
+
+	for (uint8_t i=0; i<QAD_Resource_None; i++) {
+		uint8_t uClaimed = QAD_ResourceMgr::getClaimed((QAD_Resource_Type)i);
+		uint8_t uListed  = QAH_DryRun_Count((QAD_Resource_Type)i);
+		if (uClaimed != uListed) {
+			printf("  %u %s claims made by the drivers, %u listed\n", uClaimed, strTypes[i], uListed);
+			bMatch = false;
+		}
+	}
+
+	if (!bMatch) {
+		printf("  Board configuration is out of date\n");
+		return 1;
+	}
+	printf("  Board configuration matches driver claims\n");
+	return 0;
+}
@@ -0,0 +1,244 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Host - Tools                                                  */
+/*   Role: Logic Capture Stream to VCD Converter                           */
+/*   Filename: QAH_LogicVCD.cpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Converts a capture streamed by QAS_LogicCapture::stream() into a Value Change Dump (VCD) file, for viewing in GTKWave, PulseView or
+//any other waveform viewer
+//
+//Usage: QAH_LogicVCD <stream file> [VCD file]
+//
+//The stream file holds the bytes received from the serial device, such as from "cat /dev/ttyACM0 > capture.bin". Any bytes before the
+//"QALC" header (such as other output from the board) are skipped. The stream format is described in QAS_LogicCapture.hpp. Each captured
+//pin becomes a wire named after its pin number, and a further wire named "trigger" is high for the trigger sample. The VCD file is written
+//to standard output if no file is given.
+//
+//Times are in picoseconds, so that the sample period is exact to within a picosecond at any sample rate. The tool only uses the standard
+//library, and does not use the drivers or the register mock
+//
+//Returns 0 if the stream was converted, or 1 if it could not be read or is not a complete, valid stream
+
+//Includes
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//-------------------------
+//Logic VCD Definitions
+//
+//QAH_LogicVCD_Version    - Stream format version understood by this tool (QAS_LogicCapture_Version)
+//QAH_LogicVCD_HeaderSize - Size of the stream header in bytes
+//QAH_LogicVCD_MaxRunSize - Largest number of bytes in the run length of a record (a 16bit value in 7bit groups)
+const uint8_t  QAH_LogicVCD_Version    = 1;
+const uint8_t  QAH_LogicVCD_HeaderSize = 16;
+const uint8_t  QAH_LogicVCD_MaxRunSize = 3;
+
+
+//------------------
+//QAH_LogicVCD_Capture
+//
+//Holds a decoded capture
+typedef struct {
+
+	uint8_t               uBits;         //Sample size in bits (8 or 16)
+	uint8_t               uFirstPin;     //Number of the first captured pin (0 or 8)
+	uint32_t              uSampleRate;   //Sample rate in Hz
+	uint16_t              uSamples;      //Number of samples
+	uint16_t              uTrigger;      //Index of the trigger sample
+	std::vector<uint16_t> cSamples;      //Expanded samples
+
+} QAH_LogicVCD_Capture;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+//QAH_LogicVCD_Decode
+//Tool Function
+//
+//Finds the header within the stream, and expands the run-length records into one value per sample
+//pData   - Bytes of the stream file
+//uLength - Number of bytes
+//sCapture - Set to the decoded capture
+//Returns NULL if the stream was decoded, or a description of the problem otherwise
+static const char* QAH_LogicVCD_Decode(const uint8_t* pData, size_t uLength, QAH_LogicVCD_Capture& sCapture) {
+
+	//Find header
+	size_t uPos = 0;
+	while (((uPos + QAH_LogicVCD_HeaderSize) <= uLength) && memcmp(&pData[uPos], "QALC", 4))
+		uPos++;
+	if ((uPos + QAH_LogicVCD_HeaderSize) > uLength)
+		return "no QALC header found";
+
+	const uint8_t* pHeader = &pData[uPos];
+	if (pHeader[4] != QAH_LogicVCD_Version)
+		return "unsupported stream version";
+	if (((pHeader[5] != 8) && (pHeader[5] != 16)) || ((pHeader[6] != 0) && (pHeader[6] != 8)) || ((pHeader[5] == 16) && pHeader[6]))
+		return "invalid sample size or first pin";
+
+	sCapture.uBits       = pHeader[5];
+	sCapture.uFirstPin   = pHeader[6];
+	sCapture.uSampleRate = (uint32_t)pHeader[8] | ((uint32_t)pHeader[9] << 8) | ((uint32_t)pHeader[10] << 16) | ((uint32_t)pHeader[11] << 24);
+	sCapture.uSamples    = (uint16_t)(pHeader[12] | (pHeader[13] << 8));
+	sCapture.uTrigger    = (uint16_t)(pHeader[14] | (pHeader[15] << 8));
+	sCapture.cSamples.clear();
+	if (!sCapture.uSampleRate)
+		return "sample rate of 0";
+	if (sCapture.uTrigger >= sCapture.uSamples)
+		return "trigger index outside the capture";
+	uPos += QAH_LogicVCD_HeaderSize;
+
+	//Expand records until the end record
+	uint8_t uValueSize = sCapture.uBits / 8;
+	while (true) {
+		if ((uPos + uValueSize) > uLength)
+			return "stream ends before the end record";
+		uint16_t uValue = pData[uPos];
+		if (uValueSize > 1)
+			uValue |= (uint16_t)(pData[uPos + 1] << 8);
+		uPos += uValueSize;
+
+		uint32_t uRun = 0;
+		for (uint8_t i=0; ; i++) {
+			if (uPos >= uLength)
+				return "stream ends before the end record";
+			if (i >= QAH_LogicVCD_MaxRunSize)
+				return "run length too long";
+			uint8_t uByte = pData[uPos++];
+			uRun |= (uint32_t)(uByte & 0x7F) << (7 * i);
+			if (!(uByte & 0x80))
+				break;
+		}
+
+		if (!uRun)
+			break;
+		if ((sCapture.cSamples.size() + uRun) > sCapture.uSamples)
+			return "records hold more samples than the header";
+		sCapture.cSamples.insert(sCapture.cSamples.end(), uRun, uValue);
+	}
+
+	if (sCapture.cSamples.size() != sCapture.uSamples)
+		return "records hold fewer samples than the header";
+	return NULL;
+}
+
+
+//QAH_LogicVCD_Write
+//Tool Function
+//
+//Writes a decoded capture as a VCD file, with a value change only where a pin changes
+//Identifiers are single printable characters, starting from '!' for the lowest captured pin, with the trigger wire after the pins
+//pFile    - File to write to
+//sCapture - Decoded capture
+static void QAH_LogicVCD_Write(FILE* pFile, const QAH_LogicVCD_Capture& sCapture) {
+	const char cTrigger = (char)('!' + sCapture.uBits);
+
+	fprintf(pFile, "$version QAS_LogicCapture stream version %u $end\n", QAH_LogicVCD_Version);
+	fprintf(pFile, "$comment %u samples at %u Hz, trigger at sample %u $end\n", sCapture.uSamples, sCapture.uSampleRate, sCapture.uTrigger);
+	fprintf(pFile, "$timescale 1 ps $end\n");
+	fprintf(pFile, "$scope module capture $end\n");
+	for (uint8_t i=0; i<sCapture.uBits; i++)
+		fprintf(pFile, "$var wire 1 %c pin%u $end\n", (char)('!' + i), sCapture.uFirstPin + i);
+	fprintf(pFile, "$var wire 1 %c trigger $end\n", cTrigger);
+	fprintf(pFile, "$upscope $end\n");
+	fprintf(pFile, "$enddefinitions $end\n");
+
+	//Initial values
+	uint16_t uLast = sCapture.cSamples[0];
+	fprintf(pFile, "#0\n$dumpvars\n");
+	for (uint8_t i=0; i<sCapture.uBits; i++)
+		fprintf(pFile, "%u%c\n", (uLast >> i) & 1, (char)('!' + i));
+	fprintf(pFile, "%u%c\n$end\n", (sCapture.uTrigger == 0) ? 1 : 0, cTrigger);
+
+	//Changes. Times are rounded to the nearest picosecond (the product fits in 64bits for any sample count and rate)
+	for (uint32_t uIdx=1; uIdx<=sCapture.uSamples; uIdx++) {
+		uint64_t uTime = (((uint64_t)uIdx * 1000000000000ULL) + (sCapture.uSampleRate / 2)) / sCapture.uSampleRate;
+		bool     bTrigger = (uIdx == sCapture.uTrigger) || (uIdx == (uint32_t)(sCapture.uTrigger + 1));
+
+		//Final timestamp marks the end of the last sample
+		if (uIdx == sCapture.uSamples) {
+			fprintf(pFile, "#%llu\n", (unsigned long long)uTime);
+			break;
+		}
+
+		uint16_t uValue   = sCapture.cSamples[uIdx];
+		uint16_t uChanged = uValue ^ uLast;
+		if ((!uChanged) && (!bTrigger))
+			continue;
+
+		fprintf(pFile, "#%llu\n", (unsigned long long)uTime);
+		for (uint8_t i=0; i<sCapture.uBits; i++) {
+			if (uChanged & (1 << i))
+				fprintf(pFile, "%u%c\n", (uValue >> i) & 1, (char)('!' + i));
+		}
+		if (bTrigger)
+			fprintf(pFile, "%u%c\n", (uIdx == sCapture.uTrigger) ? 1 : 0, cTrigger);
+		uLast = uValue;
+	}
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+int main(int argc, char* argv[]) {
+	if ((argc < 2) || (argc > 3)) {
+		fprintf(stderr, "Usage: %s <stream file> [VCD file]\n", argv[0]);
+		return 1;
+	}
+
+	//Read stream file
+	FILE* pIn = fopen(argv[1], "rb");
+	if (!pIn) {
+		fprintf(stderr, "Unable to open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<uint8_t> cData;
+	uint8_t uBuf[4096];
+	size_t  uRead;
+	while ((uRead = fread(uBuf, 1, sizeof(uBuf), pIn)) > 0)
+		cData.insert(cData.end(), uBuf, uBuf + uRead);
+	fclose(pIn);
+
+	QAH_LogicVCD_Capture sCapture;
+	const char* strError = QAH_LogicVCD_Decode(cData.data(), cData.size(), sCapture);
+	if (strError) {
+		fprintf(stderr, "%s: %s\n", argv[1], strError);
+		return 1;
+	}
+
+	//Write VCD file
+	FILE* pOut = (argc > 2) ? fopen(argv[2], "w") : stdout;
+	if (!pOut) {
+		fprintf(stderr, "Unable to create %s\n", argv[2]);
+		return 1;
+	}
+	QAH_LogicVCD_Write(pOut, sCapture);
+	if (pOut != stdout)
+		fclose(pOut);
+
+	fprintf(stderr, "%u samples of %u pins at %u Hz, trigger at sample %u\n", sCapture.uSamples, sCapture.uBits, sCapture.uSampleRate,
+	        sCapture.uTrigger);
+	return 0;
+}
@@ -0,0 +1,362 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Bench                                               */
+/*   Role: On-Target Cycle Benchmarks                                      */
+/*   Filename: QAS_Bench.cpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_Bench.hpp"
+#include "QAD_GPIO.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-------------------
+  //-------------------
+	//QAS_Bench_HALOutput
+
+//QAS_Bench_HALOutput::QAS_Bench_HALOutput
+//QAS_Bench_HALOutput Constructor
+//
+//The pin is not claimed or set up, and is to be held and set up as an output by another driver. The pin is turned off
+//pGPIO - The GPIO port of the pin. A member of GPIO_TypeDef as defined in stm32f407xx.h
+//uPin  - The pin. A member of GPIO_pins_define as defined in stm32f4xx_hal_gpio.h
+QAS_Bench_HALOutput::QAS_Bench_HALOutput(GPIO_TypeDef* pGPIO, uint16_t uPin) :
+	m_pGPIO(pGPIO),
+	m_uPin(uPin),
+	m_eState(QAD_GPIO_PinState_Off) {
+
+	off();
+}
+
+
+//QAS_Bench_HALOutput::on
+//QAS_Bench_HALOutput Control Method
+//
+//Used to turn the GPIO pin on
+__attribute__((noinline)) void QAS_Bench_HALOutput::on(void) {
+	HAL_GPIO_WritePin(m_pGPIO, m_uPin, GPIO_PIN_SET);
+	m_eState = QAD_GPIO_PinState_On;
+}
+
+
+//QAS_Bench_HALOutput::off
+//QAS_Bench_HALOutput Control Method
+//
+//Used to turn the GPIO pin off
+__attribute__((noinline)) void QAS_Bench_HALOutput::off(void) {
+	HAL_GPIO_WritePin(m_pGPIO, m_uPin, GPIO_PIN_RESET);
+	m_eState = QAD_GPIO_PinState_Off;
+}
+
+
+//QAS_Bench_HALOutput::toggle
+//QAS_Bench_HALOutput Control Method
+//
+//Used to toggle the state of the GPIO pin, based on the state stored by the last call to on() or off()
+__attribute__((noinline)) void QAS_Bench_HALOutput::toggle(void) {
+
+	switch (m_eState) {
+	  case (QAD_GPIO_PinState_On):
+	  	off();
+	    break;
+	  case (QAD_GPIO_PinState_Off):
+	  	on();
+	    break;
+	}
+}
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-------------------------
+  //-------------------------
+	//QAS_Bench Benchmark Methods
+
+//QAS_Bench::runPin
+//QAS_Bench Benchmark Method
+//
+//Times toggling and setting QAS_Bench_Pin using the compile-time QAD_Pin driver, the runtime QAD_GPIO_Output driver, and the HAL based
+//QAS_Bench_HALOutput baseline. All drivers use the pin with the same settings, so the results only differ by the cost of the driver methods
+//sResults - Set to the results of the benchmarks. See QAS_Bench_PinResults for details
+//Returns QA_OK if the benchmarks were run, or QA_Error_PeriphBusy if QAS_Bench_Pin is in use by another driver
+QA_Result QAS_Bench::runPin(QAS_Bench_PinResults& sResults) {
+	GPIO_TypeDef* pGPIO = QAS_Bench_Pin::gpio();
+
+	//Compile-time driver
+	if (QAD_ResourceMgr::claimPins(pGPIO, QAS_Bench_Pin::uMask, "Bench"))
+		return QA_Error_PeriphBusy;
+	QAS_Bench_Pin::initOutput(QAD_GPIO_OutputMode_PushPull, QAD_GPIO_PullMode_NoPull, QAD_GPIO_Speed_VeryHigh);
+
+	uint32_t uPrimask  = enterBench();
+	uint32_t uOverhead = measureOverhead();
+
+	uint32_t uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+		QAS_Bench_Pin::toggle();
+	}
+	sResults.sPinToggle = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		QAS_Bench_Pin::on();
+		QAS_Bench_Pin::off();
+		QAS_Bench_Pin::on();
+		QAS_Bench_Pin::off();
+		QAS_Bench_Pin::on();
+		QAS_Bench_Pin::off();
+		QAS_Bench_Pin::on();
+		QAS_Bench_Pin::off();
+	}
+	sResults.sPinSet = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	exitBench(uPrimask);
+	QAS_Bench_Pin::deinit();
+	QAD_ResourceMgr::releasePins(pGPIO, QAS_Bench_Pin::uMask, "Bench");
+
+	//Runtime driver. The driver claims the pin itself, and releases it when destroyed
+	QAD_GPIO_Output cOutput(pGPIO, QAS_Bench_Pin::uMask, QAD_GPIO_OutputMode_PushPull, QAD_GPIO_PullMode_NoPull, QAD_GPIO_Speed_VeryHigh);
+	if (!cOutput.getInitState())
+		return QA_Error_PeriphBusy;
+
+	uPrimask = enterBench();
+
+	uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+		cOutput.toggle();
+	}
+	sResults.sOutputToggle = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		cOutput.on();
+		cOutput.off();
+		cOutput.on();
+		cOutput.off();
+		cOutput.on();
+		cOutput.off();
+		cOutput.on();
+		cOutput.off();
+	}
+	sResults.sOutputSet = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	//HAL based baseline. The pin remains claimed and set up by the runtime driver
+	QAS_Bench_HALOutput cHAL(pGPIO, QAS_Bench_Pin::uMask);
+
+	uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+		cHAL.toggle();
+	}
+	sResults.sHALToggle = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+		cHAL.on();
+		cHAL.off();
+		cHAL.on();
+		cHAL.off();
+		cHAL.on();
+		cHAL.off();
+		cHAL.on();
+		cHAL.off();
+	}
+	sResults.sHALSet = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops * QAS_Bench_Unroll);
+
+	exitBench(uPrimask);
+	return QA_OK;
+}
+
+
+//QAS_Bench::runPWM
+//QAS_Bench Benchmark Method
+//
+//Times updating the compare values of 1 to 4 PWM channels, using each of the QAD_PWM value setting methods
+//A driver is created for each number of channels, with only those channels active, so that setPWMVals() only writes the active channels.
+//Each loop iteration is a single update of all active channels, and the update values change every iteration
+//sResults - Set to the results of the benchmarks. See QAS_Bench_PWMResults for details
+//Returns QA_OK if the benchmarks were run, or an error if a PWM driver could not be initialized (a member of QA_Result as defined in setup.hpp)
+QA_Result QAS_Bench::runPWM(QAS_Bench_PWMResults& sResults) {
+	typedef QAT_TimerFrequency<QAS_Bench_PWMTimer, QAS_Bench_PWMFrequency> PWMTiming;
+	uint16_t uVals[QAD_PWM_CHANNEL_COUNT];
+
+	for (uint8_t uChannels=1; uChannels<=QAD_PWM_CHANNEL_COUNT; uChannels++) {
+		QAD_PWM_InitStruct sPWMInit = {};
+		sPWMInit.eTimer     = QAS_Bench_PWMTimer;
+		sPWMInit.uPrescaler = PWMTiming::uPrescaler;
+		sPWMInit.uPeriod    = PWMTiming::uPeriod;
+		sPWMInit.eAlign     = QAD_PWM_AlignEdge;
+		sPWMInit.eBreak     = QAD_PWM_BreakDisabled;
+		for (uint8_t i=0; i<uChannels; i++) {
+			sPWMInit.sChannels[i].eActive = QA_Active;
+			sPWMInit.sChannels[i].pGPIO   = QAS_Bench_PWMGPIO;
+			sPWMInit.sChannels[i].uPin    = QAS_Bench_PWMPins[i];
+			sPWMInit.sChannels[i].uAF     = QAS_Bench_PWMAF;
+		}
+
+		QAD_PWM cPWM(sPWMInit);
+		QA_Result eRes = cPWM.init();
+		if (eRes)
+			return eRes;
+		cPWM.start();
+
+		uint32_t uPrimask  = enterBench();
+		uint32_t uOverhead = measureOverhead();
+		uint8_t  uIdx      = uChannels - 1;
+
+		uint32_t uStart = DWT->CYCCNT;
+		for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+			for (uint8_t j=0; j<uChannels; j++)
+				cPWM.setPWMVal((QAD_PWM_Channel)j, (uint16_t)(i + j));
+		}
+		sResults.sSetPWMVal[uIdx] = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops);
+
+		uStart = DWT->CYCCNT;
+		for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+			for (uint8_t j=0; j<uChannels; j++)
+				cPWM.setPWMValFast((QAD_PWM_Channel)j, i + j);
+		}
+		sResults.sSetPWMValFast[uIdx] = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops);
+
+		uStart = DWT->CYCCNT;
+		for (uint32_t i=0; i<QAS_Bench_Loops; i++) {
+			uVals[0] = (uint16_t)i;
+			uVals[1] = (uint16_t)(i + 1);
+			uVals[2] = (uint16_t)(i + 2);
+			uVals[3] = (uint16_t)(i + 3);
+			cPWM.setPWMVals(uVals);
+		}
+		sResults.sSetPWMVals[uIdx] = makeResult(DWT->CYCCNT - uStart, uOverhead, QAS_Bench_Loops);
+
+		exitBench(uPrimask);
+		cPWM.stop();
+	}
+
+	return QA_OK;
+}
+
+
+  //-----------------------
+  //-----------------------
+	//QAS_Bench Result Methods
+
+//QAS_Bench::getCyclesX100
+//QAS_Bench Result Method
+//
+//Returns the mean number of CPU cycles taken by each operation of a benchmark, in hundredths of a cycle
+//sResult - Result of the benchmark
+uint32_t QAS_Bench::getCyclesX100(const QAS_Bench_Result& sResult) {
+	if (!sResult.uOperations)
+		return 0;
+	return (uint32_t)(((uint64_t)sResult.uCycles * 100) / sResult.uOperations);
+}
+
+
+//QAS_Bench::getRate
+//QAS_Bench Result Method
+//
+//Returns the number of operations of a benchmark that can be performed per second at the current CPU clock speed
+//For toggle benchmarks this is the number of pin changes per second, which is twice the frequency of the resulting square wave
+//sResult - Result of the benchmark
+uint32_t QAS_Bench::getRate(const QAS_Bench_Result& sResult) {
+	if (!sResult.uCycles)
+		return 0;
+	return (uint32_t)(((uint64_t)SystemCoreClock * sResult.uOperations) / sResult.uCycles);
+}
+
+
+  //---------------------
+  //---------------------
+	//QAS_Bench Tool Methods
+
+//QAS_Bench::enterBench
+//QAS_Bench Tool Method
+//
+//Enables the DWT cycle counter and disables interrupts, so that interrupt handlers are not included in the timing
+//Returns the previous interrupt mask, to be passed to exitBench()
+uint32_t QAS_Bench::enterBench(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+	return uPrimask;
+}
+
+
+//QAS_Bench::exitBench
+//QAS_Bench Tool Method
+//
+//Restores interrupts to their state before enterBench() was called
+//uPrimask - Interrupt mask returned by enterBench()
+void QAS_Bench::exitBench(uint32_t uPrimask) {
+	if (!uPrimask)
+		__enable_irq();
+}
+
+
+//QAS_Bench::makeResult
+//QAS_Bench Tool Method
+//
+//Returns the result of a benchmark from the cycles taken by its loop
+//uCycles     - CPU cycles taken by the loop
+//uOverhead   - CPU cycles taken by an empty loop, as returned by measureOverhead()
+//uOperations - Number of operations performed by the loop
+QAS_Bench_Result QAS_Bench::makeResult(uint32_t uCycles, uint32_t uOverhead, uint32_t uOperations) {
+	QAS_Bench_Result sResult;
+	sResult.uCycles     = (uCycles > uOverhead) ? (uCycles - uOverhead) : 0;
+	sResult.uOperations = uOperations;
+	return sResult;
+}
+
+
+//QAS_Bench::measureOverhead
+//QAS_Bench Tool Method
+//
+//Returns the number of CPU cycles taken by a loop of QAS_Bench_Loops iterations with an empty body
+//The compiler barrier in the body generates no instructions, but prevents the loop from being removed
+uint32_t QAS_Bench::measureOverhead(void) {
+	uint32_t uStart = DWT->CYCCNT;
+	for (uint32_t i=0; i<QAS_Bench_Loops; i++)
+		__asm volatile ("" ::: "memory");
+	return DWT->CYCCNT - uStart;
+}
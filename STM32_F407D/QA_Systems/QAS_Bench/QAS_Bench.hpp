@@ -0,0 +1,196 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Bench                                               */
+/*   Role: On-Target Cycle Benchmarks                                      */
+/*   Filename: QAS_Bench.hpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_BENCH_HPP_
+#define __QAS_BENCH_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAD_Pin.hpp"
+#include "QAD_PWM.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//----------------------
+//Benchmark Definitions
+//
+//QAS_Bench_Loops  - Number of loop iterations timed by each benchmark
+//QAS_Bench_Unroll - Number of operations performed in each loop iteration. Operations are repeated within the loop so that the
+//                   cost of the loop itself is small, and the measured cost of an empty loop is then subtracted
+const uint32_t QAS_Bench_Loops  = 1000;
+const uint8_t  QAS_Bench_Unroll = 8;
+
+
+//-------------
+//QAS_Bench_Pin
+//
+//GPIO pin driven by the GPIO benchmarks. PE7 is not connected to anything on the Discovery board, and is available on header P1,
+//so the waveform can be viewed on an oscilloscope. The pin is claimed from QAD_ResourceMgr while the benchmarks run
+typedef QAD_Pin<QAD_Pin_PortE, 7> QAS_Bench_Pin;
+
+
+//--------------------------
+//PWM Benchmark Definitions
+//
+//Timer and pins driven by the PWM benchmarks. Timer 1 channels 1 to 4 are used on PE9, PE11, PE13 and PE14, which are not connected
+//to anything on the Discovery board. The timer and pins are claimed by the QAD_PWM driver while the benchmarks run
+//
+//QAS_Bench_PWMTimer     - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+//QAS_Bench_PWMFrequency - PWM frequency in Hz
+//QAS_Bench_PWMGPIO      - GPIO port of the channel pins
+//QAS_Bench_PWMPins      - Pin of each channel
+//QAS_Bench_PWMAF        - Alternate function connecting the pins to the timer
+const QAD_Timer_Periph QAS_Bench_PWMTimer                       = QAD_Timer1;
+const uint32_t         QAS_Bench_PWMFrequency                   = 20000;
+GPIO_TypeDef* const    QAS_Bench_PWMGPIO                        = GPIOE;
+const uint16_t         QAS_Bench_PWMPins[QAD_PWM_CHANNEL_COUNT] = {GPIO_PIN_9, GPIO_PIN_11, GPIO_PIN_13, GPIO_PIN_14};
+const uint8_t          QAS_Bench_PWMAF                          = GPIO_AF1_TIM1;
+
+
+//----------------
+//QAS_Bench_Result
+//
+//Result of a single benchmark
+typedef struct {
+
+	uint32_t uCycles;      //CPU cycles taken by all of the operations, less the cost of the loop
+	uint32_t uOperations;  //Number of operations timed
+
+} QAS_Bench_Result;
+
+
+//-------------------
+//QAS_Bench_PinResults
+//
+//Results of QAS_Bench::runPin()
+typedef struct {
+
+	QAS_Bench_Result sPinToggle;     //QAD_Pin::toggle()
+	QAS_Bench_Result sPinSet;        //QAD_Pin::on() and QAD_Pin::off(), alternately
+	QAS_Bench_Result sOutputToggle;  //QAD_GPIO_Output::toggle()
+	QAS_Bench_Result sOutputSet;     //QAD_GPIO_Output::on() and QAD_GPIO_Output::off(), alternately
+	QAS_Bench_Result sHALToggle;     //QAS_Bench_HALOutput::toggle(). Baseline of the HAL based driver
+	QAS_Bench_Result sHALSet;        //QAS_Bench_HALOutput::on() and QAS_Bench_HALOutput::off(), alternately. Baseline of the HAL based driver
+
+} QAS_Bench_PinResults;
+
+
+//-------------------
+//QAS_Bench_PWMResults
+//
+//Results of QAS_Bench::runPWM()
+//Each array holds the results for 1 to 4 active channels, indexed by the number of channels less one. Each operation is an update of
+//all of the active channels
+typedef struct {
+
+	QAS_Bench_Result sSetPWMVal[QAD_PWM_CHANNEL_COUNT];      //One QAD_PWM::setPWMVal() call per channel
+	QAS_Bench_Result sSetPWMValFast[QAD_PWM_CHANNEL_COUNT];  //One QAD_PWM::setPWMValFast() call per channel
+	QAS_Bench_Result sSetPWMVals[QAD_PWM_CHANNEL_COUNT];     //A single QAD_PWM::setPWMVals() call
+
+} QAS_Bench_PWMResults;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------------------
+//QAS_Bench_HALOutput
+//
+//Baseline for the GPIO benchmarks
+//A copy of the control methods of QAD_GPIO_Output as they were before the driver wrote to the port directly. on() and off() use
+//HAL_GPIO_WritePin(), and toggle() branches on the state stored by the last call to on() or off().
+//The methods are not inlined, so that each operation is a call as it is for QAD_GPIO_Output, which is built in its own translation unit
+class QAS_Bench_HALOutput {
+private:
+
+	GPIO_TypeDef*     m_pGPIO;
+	uint16_t          m_uPin;
+	QAD_GPIO_PinState m_eState;
+
+public:
+
+	QAS_Bench_HALOutput(GPIO_TypeDef* pGPIO, uint16_t uPin);
+
+	void on(void);
+	void off(void);
+	void toggle(void);
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------
+//QAS_Bench
+//
+//Static class
+//On-target benchmarks of driver operations, timed in CPU cycles using the DWT cycle counter
+//
+//Each benchmark performs a fixed number of operations with interrupts disabled, so that the timing does not include interrupt handlers.
+//The results are intended to be read with the debugger or sent over a serial device, and are only meaningful in an optimized (Release)
+//build, as the Debug build is not optimized and does not inline the compile-time drivers. Setting QA_BENCH_ENABLE in setup.hpp runs
+//the benchmarks from main() at startup.
+//
+//  QAS_Bench_PinResults sPin;
+//  QAS_Bench::runPin(sPin);
+//  uint32_t uToggleRate = QAS_Bench::getRate(sPin.sPinToggle);   //Pin changes per second
+//  uint32_t uHALRate    = QAS_Bench::getRate(sPin.sHALToggle);   //Pin changes per second of the HAL based baseline
+//
+//  QAS_Bench_PWMResults sPWM;
+//  QAS_Bench::runPWM(sPWM);
+//  uint32_t uUpdateRate = QAS_Bench::getRate(sPWM.sSetPWMVals[3]);  //Updates of all 4 channels per second
+class QAS_Bench {
+public:
+
+	//------------------
+	//Benchmark Methods
+
+	static QA_Result runPin(QAS_Bench_PinResults& sResults);
+	static QA_Result runPWM(QAS_Bench_PWMResults& sResults);
+
+
+	//-------------
+	//Result Methods
+
+	static uint32_t getCyclesX100(const QAS_Bench_Result& sResult);
+	static uint32_t getRate(const QAS_Bench_Result& sResult);
+
+
+private:
+
+	//------------
+	//Tool Methods
+
+	static uint32_t enterBench(void);
+	static void exitBench(uint32_t uPrimask);
+	static QAS_Bench_Result makeResult(uint32_t uCycles, uint32_t uOverhead, uint32_t uOperations);
+	static uint32_t measureOverhead(void);
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_BENCH_HPP_ */
@@ -0,0 +1,528 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Capture                                             */
+/*   Role: GPIO Logic Analyzer Capture                                     */
+/*   Filename: QAS_LogicCapture.cpp                                        */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_LogicCapture.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //---------------------------------------
+  //---------------------------------------
+  //QAS_LogicCapture Initialization Methods
+
+//QAS_LogicCapture::init
+//QAS_LogicCapture Initialization Method
+//
+//Used to initialize the logic capture system, setting up the sample and count timers, the links between them, and the DMA stream, and
+//allocating the sample buffer
+//Returns QA_OK if initialization successful
+//        QA_Fail if the GPIO port, capture length or sample rate is not valid, or the sample rate cannot be generated by the sample timer
+//                to within QAS_LogicCapture_TolerancePPM
+//        QA_Error_PeriphNotSupported if the sample timer is not Timer 1 or Timer 8, or the two timers do not have internal trigger connections
+//                                    to each other
+//        QA_Error_PeriphBusy if either timer is already in use
+//        Otherwise the error returned by the DMA driver or QAD_TimerLink
+QA_Result QAS_LogicCapture::init(void) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Check settings
+	if ((!m_pGPIO) || (m_uSamples < QAS_LogicCapture_MinSamples) || (!m_uSampleRate))
+		return QA_Fail;
+
+	if (m_uStreamChunk < 16)
+		m_uStreamChunk = 16;
+
+	//Check that the sample timer is able to trigger DMA2 requests, and that the two timers can be linked in both directions
+	if (!QAD_TimerMgr::getAdvanced(m_eSampleTimer))
+		return QA_Error_PeriphNotSupported;
+
+	if ((m_eCountTimer >= QAD_TimerNone) || (m_eCountTimer == m_eSampleTimer) ||
+			(QAD_TimerMgr::getITR(m_eCountTimer, m_eSampleTimer) == QAD_Timer_ITRNone) ||
+			(QAD_TimerMgr::getITR(m_eSampleTimer, m_eCountTimer) == QAD_Timer_ITRNone))
+		return QA_Error_PeriphNotSupported;
+
+	//Calculate prescaler and period of the sample timer for the required sample rate
+	QAT_TimerSolution sSolution = QAT_TimerSolver::solveFrequency(m_eSampleTimer, m_uSampleRate, QAS_LogicCapture_TolerancePPM);
+	if (!sSolution.bValid)
+		return QA_Fail;
+	m_uSampleRate = QAD_TimerMgr::getClockSpeed(m_eSampleTimer) / ((sSolution.uPrescaler + 1) * (sSolution.uPeriod + 1));
+
+	//Check that the Timer peripherals are available, and claim them (details of any conflict can be retrieved from QAD_ResourceMgr)
+	if ((QAD_TimerMgr::getState(m_eSampleTimer)) || (QAD_TimerMgr::getState(m_eCountTimer)))
+		return QA_Error_PeriphBusy;
+
+	if (QAD_ResourceMgr::claimTimer(m_eSampleTimer, "LogicCapture"))
+		return QA_Error_PeriphBusy;
+
+	if (QAD_ResourceMgr::claimTimer(m_eCountTimer, "LogicCapture")) {
+		QAD_ResourceMgr::release(QAD_Resource_Timer, m_eSampleTimer, "LogicCapture");
+		return QA_Error_PeriphBusy;
+	}
+
+	QAD_TimerMgr::registerTimer(m_eSampleTimer, QAD_Timer_InUse_LogicCapture);
+	QAD_TimerMgr::registerTimer(m_eCountTimer, QAD_Timer_InUse_LogicCapture);
+
+	//Init sample timer, which generates a DMA request on each update event
+	QAD_TimerMgr::enableClock(m_eSampleTimer);
+	m_sSampleHandle.Instance               = QAD_TimerMgr::getInstance(m_eSampleTimer);
+	m_sSampleHandle.Init.Prescaler         = sSolution.uPrescaler;
+	m_sSampleHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+	m_sSampleHandle.Init.Period            = sSolution.uPeriod;
+	m_sSampleHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+	m_sSampleHandle.Init.RepetitionCounter = 0x0;
+	m_sSampleHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+	//Init count timer, which counts the sample timer's update events. Its period is changed directly by the trigger, so preload is disabled
+	QAD_TimerMgr::enableClock(m_eCountTimer);
+	m_sCountHandle.Instance               = QAD_TimerMgr::getInstance(m_eCountTimer);
+	m_sCountHandle.Init.Prescaler         = 0;
+	m_sCountHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+	m_sCountHandle.Init.Period            = m_uSamples - 1;
+	m_sCountHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+	m_sCountHandle.Init.RepetitionCounter = 0x0;
+	m_sCountHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+	if ((HAL_TIM_Base_Init(&m_sSampleHandle) != HAL_OK) || (HAL_TIM_Base_Init(&m_sCountHandle) != HAL_OK)) {
+		release();
+		return QA_Fail;
+	}
+
+	//Allocate sample buffer
+	bool bWide = (m_ePins == QAS_LogicCapture_PinsAll);
+	m_pBuffer = std::make_unique<uint8_t[]>((bWide) ? (m_uSamples * 2) : m_uSamples);
+
+	//Create DMA driver reading the input register of the GPIO port. The high byte of the register is read directly when only pins 8 to 15
+	//are captured
+	uint32_t uIDR = (uint32_t)&m_pGPIO->IDR + ((m_ePins == QAS_LogicCapture_PinsHigh) ? 1 : 0);
+
+	QAD_DMA_InitStruct sDMAInit;
+	sDMAInit.eRequest     = (m_eSampleTimer == QAD_Timer1) ? QAD_DMA_Req_TIM1_UP : QAD_DMA_Req_TIM8_UP;
+	sDMAInit.eStream      = QAD_DMA_StreamNone;
+	sDMAInit.eDirection   = QAD_DMA_PeriphToMem;
+	sDMAInit.eMode        = QAD_DMA_Circular;
+	sDMAInit.ePriority    = QAD_DMA_PriorityVeryHigh;
+	sDMAInit.uPeriphAddr  = uIDR;
+	sDMAInit.ePeriphWidth = (bWide) ? QAD_DMA_Width16 : QAD_DMA_Width8;
+	sDMAInit.bPeriphInc   = false;
+	sDMAInit.eMemWidth    = (bWide) ? QAD_DMA_Width16 : QAD_DMA_Width8;
+	sDMAInit.bMemInc      = true;
+	sDMAInit.eFIFO        = QAD_DMA_FIFODirect;
+	sDMAInit.ePeriphBurst = QAD_DMA_BurstSingle;
+	sDMAInit.eMemBurst    = QAD_DMA_BurstSingle;
+	sDMAInit.uEvents      = 0;
+	sDMAInit.uIRQPriority = 0;
+
+	m_pDMA = std::make_unique<QAD_DMA>(sDMAInit);
+	QA_Result eRes = m_pDMA->init();
+	if (eRes) {
+		release();
+		return eRes;
+	}
+
+	//Link the timers. The sample timer is cascaded into the count timer, and gated by the count timer's counter enable
+	QAD_TimerLink_InitStruct sLinkInit;
+	sLinkInit.eMaster  = m_eSampleTimer;
+	sLinkInit.eSlave   = m_eCountTimer;
+	sLinkInit.eTrigger = QAD_TimerLink_TriggerUpdate;
+	sLinkInit.eMode    = QAD_TimerLink_ModeCascade;
+
+	m_pCountLink = std::make_unique<QAD_TimerLink>(sLinkInit);
+	eRes = m_pCountLink->init();
+	if (eRes) {
+		release();
+		return eRes;
+	}
+
+	sLinkInit.eMaster  = m_eCountTimer;
+	sLinkInit.eSlave   = m_eSampleTimer;
+	sLinkInit.eTrigger = QAD_TimerLink_TriggerEnable;
+	sLinkInit.eMode    = QAD_TimerLink_ModeGated;
+
+	m_pGateLink = std::make_unique<QAD_TimerLink>(sLinkInit);
+	eRes = m_pGateLink->init();
+	if (eRes) {
+		release();
+		return eRes;
+	}
+
+	m_eStatus    = QAS_LogicCapture_Idle;
+	m_eInitState = QA_Initialized;
+
+	return QA_OK;
+}
+
+
+//QAS_LogicCapture::deinit
+//QAS_LogicCapture Initialization Method
+//
+//Used to deinitialize the logic capture system, stopping any capture and releasing the timers, DMA stream and sample buffer
+void QAS_LogicCapture::deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	abort();
+
+	m_eInitState = QA_NotInitialized;
+	m_eStatus    = QAS_LogicCapture_Idle;
+	release();
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAS_LogicCapture Control Methods
+
+//QAS_LogicCapture::arm
+//QAS_LogicCapture Control Method
+//
+//Used to start a capture. Sampling starts straight away, and triggers are accepted once the buffer has been filled once
+//uPost - Number of samples to be captured from the trigger onwards, including the trigger sample. Limited to between 2 and the capture
+//        length. The remainder of the capture holds the samples before the trigger
+//Returns QA_OK if the capture is started
+//        QA_Fail if the system is not initialized, or a capture is already running or being streamed
+//        QA_Error_PeriphBusy if the external interrupt trigger cannot be enabled, as its EXTI line or interrupt line is held by another driver
+QA_Result QAS_LogicCapture::arm(uint16_t uPost) {
+	if ((!m_eInitState) || ((m_eStatus != QAS_LogicCapture_Idle) && (m_eStatus != QAS_LogicCapture_Complete)))
+		return QA_Fail;
+
+	//Enable the external interrupt trigger first, so that nothing has been started if its EXTI line or interrupt line cannot be claimed.
+	//Triggers are ignored until the buffer has been filled once
+	if (m_pTrigger) {
+		m_pTrigger->setHandlerClass(this);
+		if (m_pTrigger->enable())
+			return QA_Error_PeriphBusy;
+	}
+
+	m_uPost = (uPost < 2) ? 2 : ((uPost > m_uSamples) ? m_uSamples : uPost);
+
+	TIM_TypeDef* pSample = m_sSampleHandle.Instance;
+	TIM_TypeDef* pCount  = m_sCountHandle.Instance;
+
+	//Count timer wraps once per pass of the buffer, so its update flag shows when the buffer has been filled
+	pCount->CR1 &= ~(TIM_CR1_CEN | TIM_CR1_OPM);
+	pCount->CNT  = 0;
+	pCount->ARR  = m_uSamples - 1;
+	pCount->SR   = 0;
+
+	pSample->CR1  &= ~TIM_CR1_CEN;
+	pSample->DIER &= ~TIM_DIER_UDE;
+	pSample->CNT   = 0;
+	pSample->SR    = 0;
+
+	//Start DMA stream, and enable the sample timer, which does not count until the count timer opens its gate
+	m_pDMA->start((uint32_t)m_pBuffer.get(), m_uSamples);
+	pSample->DIER |= TIM_DIER_UDE;
+	pSample->CR1  |= TIM_CR1_CEN;
+
+	m_eStatus = QAS_LogicCapture_Filling;
+
+	//Start sampling
+	pCount->CR1 |= TIM_CR1_CEN;
+
+	return QA_OK;
+}
+
+
+//QAS_LogicCapture::trigger
+//QAS_LogicCapture Control Method
+//
+//Used to trigger a capture from software. Also called by handler() when the external interrupt trigger fires
+//The trigger is ignored unless the capture is armed and the buffer has been filled once. The count timer is restarted with a period of
+//the post-trigger length in one-pulse mode, so that it stops after the last post-trigger sample and closes the gate of the sample timer
+void QAS_LogicCapture::trigger(void) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	TIM_TypeDef* pCount = m_sCountHandle.Instance;
+	if (((m_eStatus == QAS_LogicCapture_Filling) || (m_eStatus == QAS_LogicCapture_Armed)) && (pCount->SR & TIM_SR_UIF)) {
+		pCount->CNT  = 0;
+		pCount->ARR  = m_uPost - 1;
+		pCount->CR1 |= TIM_CR1_OPM;
+		m_eStatus = QAS_LogicCapture_Triggered;
+	}
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_LogicCapture::abort
+//QAS_LogicCapture Control Method
+//
+//Used to stop a running capture, leaving the status as QAS_LogicCapture_Idle, or to stop the streaming of a capture, leaving the status
+//as QAS_LogicCapture_Complete
+void QAS_LogicCapture::abort(void) {
+	if (!m_eInitState)
+		return;
+
+	switch (m_eStatus) {
+		case (QAS_LogicCapture_Filling):
+		case (QAS_LogicCapture_Armed):
+		case (QAS_LogicCapture_Triggered):
+			m_sCountHandle.Instance->CR1 &= ~TIM_CR1_CEN;
+			finish();
+			m_eStatus = QAS_LogicCapture_Idle;
+			break;
+		case (QAS_LogicCapture_Streaming):
+			m_eStatus = QAS_LogicCapture_Complete;
+			break;
+		default:
+			break;
+	}
+}
+
+
+//QAS_LogicCapture::stream
+//QAS_LogicCapture Control Method
+//
+//Used to start streaming a completed capture to the serial device, in the run-length compressed format described in QAS_LogicCapture.hpp
+//The stream is sent by process(), and the status returns to QAS_LogicCapture_Complete once it has all been passed to the serial device
+//Returns QA_OK if streaming is started
+//        QA_Fail if there is no completed capture
+//        QA_Error_PeriphNotSupported if no serial device was given
+QA_Result QAS_LogicCapture::stream(void) {
+	if ((!m_eInitState) || (m_eStatus != QAS_LogicCapture_Complete))
+		return QA_Fail;
+
+	if (!m_pSerial)
+		return QA_Error_PeriphNotSupported;
+
+	m_uStreamIdx    = 0;
+	m_bStreamHeader = false;
+	m_eStatus       = QAS_LogicCapture_Streaming;
+
+	return QA_OK;
+}
+
+
+//QAS_LogicCapture::process
+//QAS_LogicCapture Control Method
+//
+//To be called regularly from the main loop
+//Updates the status of a running capture, finishes a capture once the count timer has stopped, and passes the next part of a stream to
+//the serial device each time its transmit buffer is empty
+//Returns the current status of the capture. Member of QAS_LogicCapture_Status
+QAS_LogicCapture_Status QAS_LogicCapture::process(void) {
+	if (!m_eInitState)
+		return m_eStatus;
+
+	switch (m_eStatus) {
+
+		//Trigger may be received from the interrupt between the status being checked and changed, so the change is made with interrupts disabled
+		case (QAS_LogicCapture_Filling): {
+			uint32_t uPrimask = __get_PRIMASK();
+			__disable_irq();
+			if ((m_eStatus == QAS_LogicCapture_Filling) && (m_sCountHandle.Instance->SR & TIM_SR_UIF))
+				m_eStatus = QAS_LogicCapture_Armed;
+			__set_PRIMASK(uPrimask);
+			break;
+		}
+
+		case (QAS_LogicCapture_Triggered):
+			if (!(m_sCountHandle.Instance->CR1 & TIM_CR1_CEN)) {
+				finish();
+				m_eStatus = QAS_LogicCapture_Complete;
+			}
+			break;
+
+		case (QAS_LogicCapture_Streaming): {
+			if (!m_pSerial->m_pTXFIFO->empty())
+				break;
+
+			uint8_t  uChunk[QAS_LogicCapture_MaxChunk];
+			uint16_t uLen = 0;
+
+			if (!m_bStreamHeader) {
+				uLen = encodeHeader(uChunk);
+				m_bStreamHeader = true;
+			}
+
+			//Each record takes at most 5 bytes (a 16bit sample and a run length of up to 3 bytes)
+			while ((m_uStreamIdx < m_uSamples) && ((uLen + 5) <= m_uStreamChunk)) {
+				uint16_t uValue = getSample(m_uStreamIdx);
+				uint16_t uRun   = 1;
+				while (((m_uStreamIdx + uRun) < m_uSamples) && (getSample(m_uStreamIdx + uRun) == uValue))
+					uRun++;
+
+				uLen += encodeRecord(&uChunk[uLen], uValue, uRun);
+				m_uStreamIdx += uRun;
+			}
+
+			if ((m_uStreamIdx >= m_uSamples) && ((uLen + 5) <= m_uStreamChunk)) {
+				uLen += encodeRecord(&uChunk[uLen], 0, 0);
+				m_eStatus = QAS_LogicCapture_Complete;
+			}
+
+			m_pSerial->txData(uChunk, uLen);
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	return m_eStatus;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAS_LogicCapture Data Methods
+
+//QAS_LogicCapture::getSample
+//QAS_LogicCapture Data Method
+//
+//Returns a sample of a completed capture, with bit 0 being the lowest captured pin (pin 0, or pin 8 when only pins 8 to 15 are captured)
+//Returns 0 if there is no completed capture
+//uIdx - Index of the sample, from 0 (the oldest sample) to getSamples()-1. The trigger sample is at getTriggerIndex()
+uint16_t QAS_LogicCapture::getSample(uint16_t uIdx) {
+	if (((m_eStatus != QAS_LogicCapture_Complete) && (m_eStatus != QAS_LogicCapture_Streaming)) || (uIdx >= m_uSamples))
+		return 0;
+
+	uint32_t uPos = (uint32_t)m_uStart + uIdx;
+	if (uPos >= m_uSamples)
+		uPos -= m_uSamples;
+
+	if (m_ePins == QAS_LogicCapture_PinsAll)
+		return reinterpret_cast<uint16_t*>(m_pBuffer.get())[uPos];
+	return m_pBuffer[uPos];
+}
+
+
+  //------------------------------------
+  //------------------------------------
+  //QAS_LogicCapture IRQ Handler Methods
+
+//QAS_LogicCapture::handler
+//QAS_LogicCapture IRQ Handler Method
+//
+//Called by the external interrupt driver used as the trigger
+//pData - Unused
+void QAS_LogicCapture::handler(void* pData) {
+	trigger();
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAS_LogicCapture Tool Methods
+
+//QAS_LogicCapture::finish
+//QAS_LogicCapture Tool Method
+//
+//Used to stop the sample timer and DMA stream once the count timer has stopped, and to find the position of the oldest sample from
+//the position of the DMA stream
+void QAS_LogicCapture::finish(void) {
+	TIM_TypeDef* pSample = m_sSampleHandle.Instance;
+	pSample->CR1  &= ~TIM_CR1_CEN;
+	pSample->DIER &= ~TIM_DIER_UDE;
+
+	//The next sample would have been written to the oldest sample's position
+	uint16_t uRemaining = m_pDMA->getRemaining();
+	m_pDMA->stop();
+	m_uStart = (uRemaining < m_uSamples) ? (m_uSamples - uRemaining) : 0;
+
+	m_sCountHandle.Instance->CR1 &= ~TIM_CR1_OPM;
+
+	if (m_pTrigger)
+		m_pTrigger->disable();
+}
+
+
+//QAS_LogicCapture::release
+//QAS_LogicCapture Tool Method
+//
+//Used to remove the timer links and DMA driver, deinitialize the timers and release them and the sample buffer
+//Used both by deinit() and to clean up after a failed initialization
+void QAS_LogicCapture::release(void) {
+
+	//Remove links and DMA driver (which deinitialize themselves upon destruction)
+	m_pGateLink.reset();
+	m_pCountLink.reset();
+	m_pDMA.reset();
+	m_pBuffer.reset();
+
+	//Deinitialize Timer peripherals and disable their clocks
+	HAL_TIM_Base_DeInit(&m_sSampleHandle);
+	HAL_TIM_Base_DeInit(&m_sCountHandle);
+	QAD_TimerMgr::disableClock(m_eSampleTimer);
+	QAD_TimerMgr::disableClock(m_eCountTimer);
+
+	//Deregister and release Timer peripherals
+	QAD_TimerMgr::deregisterTimer(m_eSampleTimer);
+	QAD_TimerMgr::deregisterTimer(m_eCountTimer);
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eSampleTimer, "LogicCapture");
+	QAD_ResourceMgr::release(QAD_Resource_Timer, m_eCountTimer, "LogicCapture");
+}
+
+
+//QAS_LogicCapture::encodeHeader
+//QAS_LogicCapture Tool Method
+//
+//Used to write the stream header
+//pOut - Buffer of at least 16 bytes to receive the header
+//Returns the number of bytes written
+uint16_t QAS_LogicCapture::encodeHeader(uint8_t* pOut) {
+	uint16_t uTrigger = getTriggerIndex();
+
+	pOut[0]  = 'Q';
+	pOut[1]  = 'A';
+	pOut[2]  = 'L';
+	pOut[3]  = 'C';
+	pOut[4]  = QAS_LogicCapture_Version;
+	pOut[5]  = (m_ePins == QAS_LogicCapture_PinsAll) ? 16 : 8;
+	pOut[6]  = (m_ePins == QAS_LogicCapture_PinsHigh) ? 8 : 0;
+	pOut[7]  = 0;
+	pOut[8]  = (uint8_t)m_uSampleRate;
+	pOut[9]  = (uint8_t)(m_uSampleRate >> 8);
+	pOut[10] = (uint8_t)(m_uSampleRate >> 16);
+	pOut[11] = (uint8_t)(m_uSampleRate >> 24);
+	pOut[12] = (uint8_t)m_uSamples;
+	pOut[13] = (uint8_t)(m_uSamples >> 8);
+	pOut[14] = (uint8_t)uTrigger;
+	pOut[15] = (uint8_t)(uTrigger >> 8);
+	return 16;
+}
+
+
+//QAS_LogicCapture::encodeRecord
+//QAS_LogicCapture Tool Method
+//
+//Used to write a run-length record
+//pOut   - Buffer of at least 5 bytes to receive the record
+//uValue - Sample value of the run
+//uRun   - Number of samples in the run (0 for the end record)
+//Returns the number of bytes written
+uint16_t QAS_LogicCapture::encodeRecord(uint8_t* pOut, uint16_t uValue, uint16_t uRun) {
+	uint16_t uLen = 0;
+
+	pOut[uLen++] = (uint8_t)uValue;
+	if (m_ePins == QAS_LogicCapture_PinsAll)
+		pOut[uLen++] = (uint8_t)(uValue >> 8);
+
+	do {
+		uint8_t uByte = uRun & 0x7F;
+		uRun >>= 7;
+		pOut[uLen++] = (uRun) ? (uByte | 0x80) : uByte;
+	} while (uRun);
+
+	return uLen;
+}
@@ -0,0 +1,274 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Capture                                             */
+/*   Role: GPIO Logic Analyzer Capture                                     */
+/*   Filename: QAS_LogicCapture.hpp                                        */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_LOGICCAPTURE_HPP_
+#define __QAS_LOGICCAPTURE_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_TimerMgr.hpp"
+#include "QAD_ResourceMgr.hpp"
+#include "QAD_TimerLink.hpp"
+#include "QAD_DMA.hpp"
+#include "QAD_EXTI.hpp"
+#include "QAS_Serial_Dev_Base.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-------------------------
+//Logic Capture Definitions
+//
+//QAS_LogicCapture_MinSamples   - Smallest capture length in samples
+//QAS_LogicCapture_MaxChunk     - Largest number of bytes passed to the serial device by each call to process() while streaming
+//QAS_LogicCapture_Version      - Version of the stream format written by stream()
+//QAS_LogicCapture_TolerancePPM - Largest error in the sample rate accepted by init(), in parts per million. This is looser than for the
+//                                control systems, as the actual sample rate is recorded in the stream header
+const uint16_t QAS_LogicCapture_MinSamples   = 16;
+const uint16_t QAS_LogicCapture_MaxChunk     = 64;
+const uint8_t  QAS_LogicCapture_Version      = 1;
+const uint32_t QAS_LogicCapture_TolerancePPM = 10000;
+
+
+//---------------------
+//QAS_LogicCapture_Pins
+//
+//Used to select which pins of the GPIO port are captured, which also sets the size of each sample
+enum QAS_LogicCapture_Pins : uint8_t {
+	QAS_LogicCapture_PinsLow = 0,    //Pins 0 to 7, with 8bit samples
+	QAS_LogicCapture_PinsHigh,       //Pins 8 to 15, with 8bit samples
+	QAS_LogicCapture_PinsAll         //Pins 0 to 15, with 16bit samples
+};
+
+
+//-----------------------
+//QAS_LogicCapture_Status
+//
+//Used to return the current status of a capture
+enum QAS_LogicCapture_Status : uint8_t {
+	QAS_LogicCapture_Idle = 0,       //No capture has been armed, or the capture was aborted
+	QAS_LogicCapture_Filling,        //Capture is running, but the buffer does not yet hold enough samples to accept a trigger
+	QAS_LogicCapture_Armed,          //Capture is running and waiting for a trigger
+	QAS_LogicCapture_Triggered,      //Trigger has been received, and post-trigger samples are being captured
+	QAS_LogicCapture_Complete,       //Capture is complete, and its samples can be read or streamed
+	QAS_LogicCapture_Streaming       //Capture is being streamed to the serial device
+};
+
+
+//---------------------------
+//QAS_LogicCapture_InitStruct
+//
+//This structure is used to create the QAS_LogicCapture system class
+typedef struct {
+
+	GPIO_TypeDef*          pGPIO;           //GPIO port to be captured. The pins are read as they have been set up by their own drivers
+	QAS_LogicCapture_Pins  ePins;           //Pins of the port to be captured. Member of QAS_LogicCapture_Pins
+
+	QAD_Timer_Periph       eSampleTimer;    //Timer peripheral used to pace the samples. Must be Timer 1 or Timer 8, as only these have DMA requests
+	                                        //on DMA2, which is able to read from GPIO ports
+	QAD_Timer_Periph       eCountTimer;     //Timer peripheral used to count the samples and end the capture. Must have internal trigger connections
+	                                        //to and from the sample timer (such as Timer 3 or Timer 4 with Timer 1, or Timer 4 or Timer 5 with Timer 8)
+	uint32_t               uSampleRate;     //Sample rate in Hz. The nearest rate available from the timer is used (see getSampleRate()), which must be
+	                                        //within QAS_LogicCapture_TolerancePPM of the requested rate
+	uint16_t               uSamples;        //Capture length in samples (at least QAS_LogicCapture_MinSamples). The buffer is allocated by init()
+
+	QAD_EXTI*              pTrigger;        //External interrupt driver used as the trigger, or NULL if only trigger() is to be used. The driver
+	                                        //must be created by the user, and its handler class is set by arm()
+
+	QAS_Serial_Dev_Base*   pSerial;         //Serial device used by stream(), or NULL if captures are not to be streamed
+	uint16_t               uStreamChunk;    //Number of bytes passed to the serial device each time its transmit buffer is empty while streaming.
+	                                        //Limited to QAS_LogicCapture_MaxChunk, and must be less than the size of the device's transmit buffer
+
+} QAS_LogicCapture_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//----------------
+//QAS_LogicCapture
+//
+//System class used as a simple logic analyzer, capturing 8 or 16 pins of a GPIO port at a fixed sample rate of up to several MHz, with
+//pre-trigger and post-trigger windows
+//
+//Each update event of the sample timer triggers a DMA read of the port's input register into a circular buffer, so sampling takes no CPU
+//time. Once armed, the buffer is filled continuously until a trigger is received, either from a QAD_EXTI external interrupt or from
+//trigger(). The capture then continues for the requested number of post-trigger samples and stops, leaving the pre-trigger samples
+//in the rest of the buffer. Triggers are ignored until the buffer has been filled once.
+//
+//The end of the capture is set by hardware rather than by an interrupt. The sample timer is cascaded into the count timer, which counts
+//the samples, and the sample timer is gated by the count timer's counter enable (see QAD_TimerLink). The trigger resets the count timer
+//and sets it to one-pulse mode with a period of the post-trigger length, so the count timer stops itself after exactly that many samples,
+//which closes the gate of the sample timer. The position of the trigger in the capture is therefore exact, apart from the latency of the
+//trigger interrupt, which delays the trigger by a small number of samples at high sample rates.
+//
+//process() is to be called regularly from the main loop. It finishes a capture once the count timer has stopped, and streams a completed
+//capture to the serial device once stream() has been called. Streamed captures are run-length compressed, so long periods without any
+//change take only a few bytes. The stream format (all values little endian) is:
+//
+//  Header  - 16 bytes: "QALC", version (1 byte), sample size in bits (1 byte, 8 or 16), number of the first captured pin (1 byte, 0 or 8),
+//            reserved (1 byte, 0), sample rate in Hz (4 bytes), number of samples (2 bytes), index of the trigger sample (2 bytes)
+//  Records - One per run of identical samples: the sample value (1 or 2 bytes) followed by the length of the run as an unsigned LEB128
+//            value (7 bits per byte, least significant first, with the top bit set on every byte except the last)
+//  End     - A record with a sample value of 0 and a run length of 0
+//
+//The records can be expanded into one sample per period of the sample rate for display. QA_Host/Tools/QAH_LogicVCD.cpp converts a
+//stream into a VCD file for a waveform viewer
+class QAS_LogicCapture : public QAD_IRQHandler_CallbackClass {
+private:
+
+	QA_InitState                     m_eInitState;    //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	volatile QAS_LogicCapture_Status m_eStatus;       //Current status of the capture. Member of QAS_LogicCapture_Status
+
+	GPIO_TypeDef*                    m_pGPIO;         //GPIO port to be captured
+	QAS_LogicCapture_Pins            m_ePins;         //Pins of the port to be captured
+	QAD_Timer_Periph                 m_eSampleTimer;  //Timer peripheral used to pace the samples
+	QAD_Timer_Periph                 m_eCountTimer;   //Timer peripheral used to count the samples
+	uint32_t                         m_uSampleRate;   //Requested sample rate in Hz (the actual rate once initialized)
+	uint16_t                         m_uSamples;      //Capture length in samples
+	QAD_EXTI*                        m_pTrigger;      //External interrupt driver used as the trigger
+	QAS_Serial_Dev_Base*             m_pSerial;       //Serial device used for streaming
+	uint16_t                         m_uStreamChunk;  //Bytes passed to the serial device at a time while streaming
+
+	TIM_HandleTypeDef                m_sSampleHandle; //Handle used by HAL functions to access the sample timer (defined in stm32f4xx_hal_tim.h)
+	TIM_HandleTypeDef                m_sCountHandle;  //Handle used by HAL functions to access the count timer (defined in stm32f4xx_hal_tim.h)
+
+	std::unique_ptr<uint8_t[]>       m_pBuffer;       //Sample buffer
+	std::unique_ptr<QAD_DMA>         m_pDMA;          //DMA driver reading the GPIO port into the sample buffer
+	std::unique_ptr<QAD_TimerLink>   m_pCountLink;    //Link cascading the sample timer into the count timer
+	std::unique_ptr<QAD_TimerLink>   m_pGateLink;     //Link gating the sample timer with the count timer's counter enable
+
+	uint16_t                         m_uPost;         //Number of post-trigger samples of the current capture
+	uint16_t                         m_uStart;        //Buffer index of the oldest sample of a completed capture
+
+	//Stream state
+	uint16_t                         m_uStreamIdx;    //Index of the next sample to be encoded
+	bool                             m_bStreamHeader; //Set once the header has been sent
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAS_LogicCapture() = delete;                               //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAS_LogicCapture(QAS_LogicCapture_InitStruct& sInit) :     //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eInitState(QA_NotInitialized),
+		m_eStatus(QAS_LogicCapture_Idle),
+		m_pGPIO(sInit.pGPIO),
+		m_ePins(sInit.ePins),
+		m_eSampleTimer(sInit.eSampleTimer),
+		m_eCountTimer(sInit.eCountTimer),
+		m_uSampleRate(sInit.uSampleRate),
+		m_uSamples(sInit.uSamples),
+		m_pTrigger(sInit.pTrigger),
+		m_pSerial(sInit.pSerial),
+		m_uStreamChunk((sInit.uStreamChunk > QAS_LogicCapture_MaxChunk) ? QAS_LogicCapture_MaxChunk : sInit.uStreamChunk),
+		m_sSampleHandle({0}),
+		m_sCountHandle({0}),
+		m_uPost(0),
+		m_uStart(0),
+		m_uStreamIdx(0),
+		m_bStreamHeader(false) {}
+
+	~QAS_LogicCapture() {     //Destructor to make sure the capture is stopped and the system deinitialized upon class destruction
+
+		//Deinitialize system if currently initialized (which also stops any capture)
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAS_LogicCapture.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	QA_Result arm(uint16_t uPost);
+	void trigger(void);
+	void abort(void);
+
+	QA_Result stream(void);
+	QAS_LogicCapture_Status process(void);
+
+	//Returns the current status of the capture. Member of QAS_LogicCapture_Status
+	QAS_LogicCapture_Status getStatus(void) {
+		return m_eStatus;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the sample rate in Hz
+	uint32_t getSampleRate(void) {
+		return m_uSampleRate;
+	}
+
+	//Returns the capture length in samples
+	uint16_t getSamples(void) {
+		return m_uSamples;
+	}
+
+	//Returns the index of the trigger sample within a completed capture (which is also the number of pre-trigger samples)
+	uint16_t getTriggerIndex(void) {
+		return m_uSamples - m_uPost;
+	}
+
+	uint16_t getSample(uint16_t uIdx);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_LogicCapture.cpp for details of the following methods
+
+	//-------------
+	//Tool Methods
+
+	void finish(void);
+	void release(void);
+	uint16_t encodeHeader(uint8_t* pOut);
+	uint16_t encodeRecord(uint8_t* pOut, uint16_t uValue, uint16_t uRun);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_LOGICCAPTURE_HPP_ */
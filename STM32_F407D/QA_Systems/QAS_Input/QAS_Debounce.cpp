@@ -0,0 +1,294 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Input                                               */
+/*   Role: Bit-Parallel Input Debouncer                                    */
+/*   Filename: QAS_Debounce.cpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_Debounce.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-------------------------
+  //-------------------------
+	//QAS_Debounce Constructors
+
+//QAS_Debounce::QAS_Debounce
+//QAS_Debounce Constructor
+//
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAS_Debounce::QAS_Debounce() :
+	m_eInitState(QA_NotInitialized),
+	m_eState(QA_Inactive),
+	m_sPorts{},
+	m_uTick(0),
+	m_sQueue{},
+	m_uHead(0),
+	m_uTail(0),
+	m_uOverflows(0) {}
+
+
+  //-----------------------------------
+  //-----------------------------------
+  //QAS_Debounce Initialization Methods
+
+//QAS_Debounce::imp_init
+//QAS_Debounce Initialization Method
+//
+//To be called from static method init()
+//Creates the Timer driver used to time samples. Sampling is started by start()
+//sInit - Initialization structure. See QAS_Debounce_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Fail if the sample frequency cannot be generated by the selected Timer peripheral to within QAS_Debounce_TolerancePPM
+//        QA_Error_PeriphBusy if no Timer peripheral is available
+QA_Result QAS_Debounce::imp_init(QAS_Debounce_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Find a Timer peripheral if one has not been selected
+	QAD_Timer_Periph eTimer = sInit.eTimer;
+	if (eTimer == QAD_TimerNone) {
+		eTimer = QAD_TimerMgr::findTimer(QAD_Timer_16bit);
+		if (eTimer == QAD_TimerNone)
+			return QA_Error_PeriphBusy;
+	}
+
+	//Calculate prescaler and period for the required sample frequency
+	QAT_TimerSolution sSolution = QAT_TimerSolver::solveFrequency(eTimer, sInit.uSampleFrequency, QAS_Debounce_TolerancePPM);
+	if (!sSolution.bValid)
+		return QA_Fail;
+
+	QAD_Timer_InitStruct sTimerInit;
+	sTimerInit.eTimer         = eTimer;
+	sTimerInit.eMode          = QAD_TimerContinuous;
+	sTimerInit.uPrescaler     = sSolution.uPrescaler;
+	sTimerInit.uPeriod        = sSolution.uPeriod;
+	sTimerInit.uIRQPriority   = sInit.uIRQPriority;
+	sTimerInit.uCounterTarget = 0;
+
+	m_pTimer = std::make_unique<QAD_Timer>(sTimerInit);
+	QA_Result eRes = m_pTimer->init();
+	if (eRes) {
+		m_pTimer.reset();
+		return eRes;
+	}
+
+	m_pTimer->setHandlerClass(this);
+	m_eState     = QA_Inactive;
+	m_eInitState = QA_Initialized;
+
+	return QA_OK;
+}
+
+
+//QAS_Debounce::imp_deinit
+//QAS_Debounce Initialization Method
+//
+//To be called from static method deinit()
+//Stops sampling and removes the Timer driver. The port settings are kept
+void QAS_Debounce::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	imp_stop();
+	m_eInitState = QA_NotInitialized;
+	m_pTimer.reset();
+}
+
+
+  //----------------------------
+  //----------------------------
+  //QAS_Debounce Control Methods
+
+//QAS_Debounce::imp_setPort
+//QAS_Debounce Control Method
+//
+//To be called from static method setPort()
+//The debounced levels of the port's pins are set to their current levels, so that inputs which are already active do not generate
+//press events. Interrupts are disabled while the port is changed, so this method can be used while the debouncer is active
+//uIdx       - Port index (0 to QAS_Debounce_MaxPorts-1)
+//pGPIO      - GPIO port, or NULL to stop debouncing the port index
+//uMask      - Pins of the port to be debounced
+//uActiveLow - Pins of the port that are active when low
+//Returns QA_OK if successful, or QA_Fail if the port index is not valid
+QA_Result QAS_Debounce::imp_setPort(uint8_t uIdx, GPIO_TypeDef* pGPIO, uint16_t uMask, uint16_t uActiveLow) {
+	if (uIdx >= QAS_Debounce_MaxPorts)
+		return QA_Fail;
+
+	Port& sPort = m_sPorts[uIdx];
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	sPort.pGPIO   = pGPIO;
+	sPort.uMask   = pGPIO ? uMask : 0;
+	sPort.uInvert = uActiveLow;
+	sPort.uState  = pGPIO ? ((pGPIO->IDR ^ sPort.uInvert) & sPort.uMask) : 0;
+	sPort.uCnt0   = 0;
+	sPort.uCnt1   = 0;
+
+	__set_PRIMASK(uPrimask);
+
+	return QA_OK;
+}
+
+
+//QAS_Debounce::imp_start
+//QAS_Debounce Control Method
+//
+//To be called from static method start()
+//Clears the sample count, event queue and overflow count, sets the debounced levels of all ports to their current levels, and starts the
+//sample timer. The first sample is taken one sample period after this method is called
+void QAS_Debounce::imp_start(void) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	for (uint8_t i=0; i<QAS_Debounce_MaxPorts; i++) {
+		Port& sPort = m_sPorts[i];
+		sPort.uState = sPort.pGPIO ? ((sPort.pGPIO->IDR ^ sPort.uInvert) & sPort.uMask) : 0;
+		sPort.uCnt0  = 0;
+		sPort.uCnt1  = 0;
+	}
+
+	m_uTick      = 0;
+	m_uHead      = 0;
+	m_uTail      = 0;
+	m_uOverflows = 0;
+
+	m_eState = QA_Active;
+	m_pTimer->start();
+}
+
+
+//QAS_Debounce::imp_stop
+//QAS_Debounce Control Method
+//
+//To be called from static method stop()
+void QAS_Debounce::imp_stop(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	m_pTimer->stop();
+	m_eState = QA_Inactive;
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAS_Debounce Data Methods
+
+//QAS_Debounce::imp_getEvent
+//QAS_Debounce Data Method
+//
+//To be called from static method getEvent()
+//The queue has a single writer (the timer interrupt, which only changes m_uHead) and a single reader (this method, which only changes
+//m_uTail), so no locking is needed. The memory barriers make sure that the event is not read before its head count is seen, and that
+//the slot is not released to the writer until the event has been copied
+//sEvent - Structure to receive the event
+//Returns QA_OK if an event was read, or QA_Fail if the queue is empty
+QA_Result QAS_Debounce::imp_getEvent(QAS_Debounce_Event& sEvent) {
+	uint32_t uTail = m_uTail;
+	if (m_uHead == uTail)
+		return QA_Fail;
+
+	__DMB();
+	sEvent = m_sQueue[uTail & (QAS_Debounce_QueueSize - 1)];
+	__DMB();
+
+	m_uTail = uTail + 1;
+	return QA_OK;
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAS_Debounce IRQ Handler Methods
+
+//QAS_Debounce::handler
+//QAS_Debounce IRQ Handler Method
+//
+//Called by the Timer driver when the update interrupt is triggered
+//Takes one sample of each port and advances the vertical counters of all of its pins. For each pin, the counter (uCnt1:uCnt0) is
+//cleared when the sample matches the debounced level, and otherwise counts 1, 2, 3, 0. A pin whose counter returns to 0 while its sample
+//still differs has held its new level for QAS_Debounce_Samples samples, so its debounced level is changed
+//pData - Unused
+void QAS_Debounce::handler(void* pData) {
+	uint32_t uTick = m_uTick;
+
+	for (uint8_t i=0; i<QAS_Debounce_MaxPorts; i++) {
+		Port& sPort = m_sPorts[i];
+		if (!sPort.pGPIO)
+			continue;
+
+		//Pins that differ from their debounced level
+		uint32_t uDelta = ((sPort.pGPIO->IDR ^ sPort.uInvert) & sPort.uMask) ^ sPort.uState;
+
+		//Advance vertical counters
+		uint32_t uCnt1 = (sPort.uCnt1 ^ sPort.uCnt0) & uDelta;
+		uint32_t uCnt0 = ~sPort.uCnt0 & uDelta;
+		sPort.uCnt0    = uCnt0;
+		sPort.uCnt1    = uCnt1;
+
+		//Pins whose counters have wrapped
+		uint32_t uChanged = uDelta & ~(uCnt0 | uCnt1);
+		if (uChanged) {
+			sPort.uState ^= uChanged;
+			queueEvents(i, uChanged, sPort.uState, uTick);
+		}
+	}
+
+	m_uTick = uTick + 1;
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAS_Debounce Tool Methods
+
+//QAS_Debounce::queueEvents
+//QAS_Debounce Tool Method
+//
+//Called by handler() to add an event to the queue for each pin of a port that has changed. The pins are found lowest first by counting
+//the trailing zeros of the changed pins, so the time taken depends only on the number of pins that have changed
+//uIdx     - Port index
+//uChanged - Pins of the port whose debounced levels have changed
+//uState   - New debounced levels of the port's pins
+//uTick    - Sample number
+void QAS_Debounce::queueEvents(uint8_t uIdx, uint32_t uChanged, uint32_t uState, uint32_t uTick) {
+	uint32_t uHead = m_uHead;
+
+	while (uChanged) {
+		uint32_t uPin = __CLZ(__RBIT(uChanged));
+		uChanged &= (uChanged - 1);
+
+		if ((uHead - m_uTail) >= QAS_Debounce_QueueSize) {
+			m_uOverflows++;
+			continue;
+		}
+
+		QAS_Debounce_Event& sEvent = m_sQueue[uHead & (QAS_Debounce_QueueSize - 1)];
+		sEvent.uTick  = uTick;
+		sEvent.uInput = (uint8_t)((uIdx << 4) | uPin);
+		sEvent.eEdge  = (uState & (1UL << uPin)) ? QAS_Debounce_Press : QAS_Debounce_Release;
+		uHead++;
+	}
+
+	//Publish events
+	__DMB();
+	m_uHead = uHead;
+}
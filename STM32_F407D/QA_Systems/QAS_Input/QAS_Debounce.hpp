@@ -0,0 +1,288 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Input                                               */
+/*   Role: Bit-Parallel Input Debouncer                                    */
+/*   Filename: QAS_Debounce.hpp                                            */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_DEBOUNCE_HPP_
+#define __QAS_DEBOUNCE_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_Timer.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//--------------------
+//Debounce Definitions
+//
+//QAS_Debounce_MaxPorts     - Maximum number of GPIO ports that can be debounced, giving up to 16 inputs per port
+//QAS_Debounce_QueueSize    - Number of entries in the event queue. Must be a power of 2
+//QAS_Debounce_Samples      - Number of consecutive samples that an input must hold a new level for before the change is accepted
+//QAS_Debounce_TolerancePPM - Largest error in the sample frequency accepted by init(), in parts per million
+const uint8_t  QAS_Debounce_MaxPorts     = 4;
+const uint16_t QAS_Debounce_QueueSize    = 64;
+const uint8_t  QAS_Debounce_Samples      = 4;
+const uint32_t QAS_Debounce_TolerancePPM = 10000;
+
+
+//-----------------
+//QAS_Debounce_Edge
+//
+//Used to give the type of a debounced input event
+enum QAS_Debounce_Edge : uint8_t {
+	QAS_Debounce_Release = 0,  //Input has changed to inactive
+	QAS_Debounce_Press         //Input has changed to active
+};
+
+
+//------------------
+//QAS_Debounce_Event
+//
+//This structure holds a single event from the event queue
+typedef struct {
+
+	uint32_t          uTick;    //Sample number at which the change was accepted, counting from 0 when the debouncer is started
+	uint8_t           uInput;   //Input number, being (port index * 16) + pin number
+	QAS_Debounce_Edge eEdge;    //Whether the input was pressed or released. Member of QAS_Debounce_Edge
+
+} QAS_Debounce_Event;
+
+
+//-----------------------
+//QAS_Debounce_InitStruct
+//
+//This structure is used to initialize the QAS_Debounce system
+typedef struct {
+
+	QAD_Timer_Periph eTimer;            //Timer peripheral used to time samples. Set to QAD_TimerNone to have a timer found by QAD_TimerMgr
+	                                    //NOTE: handlers.cpp routes the Timer 6 and Timer 7 interrupts through QAD_TimerMgr::irqHandler(). For
+	                                    //      other timers, the IRQ handler function in handlers.cpp will need to call QAS_Debounce::irqHandler()
+
+	uint32_t         uSampleFrequency;  //Sample frequency in Hz. The debounce time is QAS_Debounce_Samples sample periods, so 1000Hz gives 4ms
+	uint8_t          uIRQPriority;      //IRQ Priority for timer update interrupt (a value between 0 and 15)
+
+} QAS_Debounce_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------
+//QAS_Debounce
+//
+//Singleton class
+//Debounces up to 64 digital inputs, being any pins of up to QAS_Debounce_MaxPorts GPIO ports, and queues their press and release events
+//
+//Each sample reads the input register of each port once and debounces all 16 pins of the port together, using a 2bit vertical counter
+//per port. Rather than keeping a counter for each pin, bit n of two 16bit words holds the two bits of pin n's counter, so one set of
+//bitwise operations advances the counters of every pin at once. The counter of a pin counts the consecutive samples in which the pin
+//differs from its debounced level, and is cleared by any sample that matches it. When the counter wraps after QAS_Debounce_Samples
+//samples, the pin's debounced level changes. The whole update is around ten instructions per port, whatever the number of pins in use,
+//and events are only generated for pins that change.
+//
+//Events are placed in a lock-free queue by the timer interrupt, and are read by a task with getEvent(). If the queue is full then new
+//events are discarded and counted (see getOverflows()), although the debounced levels returned by getInputs() are always up to date.
+//
+//The pins are read as they have been set up by their own drivers (normally QAD_GPIO_Input with a pull-up or pull-down resistor)
+class QAS_Debounce : public QAD_IRQHandler_CallbackClass {
+private:
+
+	//Debounce state of a single GPIO port
+	typedef struct {
+
+		GPIO_TypeDef* pGPIO;    //GPIO port, or NULL if the port index is not used
+		uint32_t      uMask;    //Pins of the port to be debounced
+		uint32_t      uInvert;  //Pins of the port that are active low
+		uint32_t      uState;   //Debounced level of each pin, with 1 being active
+		uint32_t      uCnt0;    //Bit 0 of the vertical counter of each pin
+		uint32_t      uCnt1;    //Bit 1 of the vertical counter of each pin
+
+	} Port;
+
+	std::unique_ptr<QAD_Timer> m_pTimer;                                  //Timer driver used to time samples
+
+	QA_InitState               m_eInitState;                              //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState             m_eState;                                  //Stores whether the debouncer is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	Port                       m_sPorts[QAS_Debounce_MaxPorts];           //Debounce state of each port
+	volatile uint32_t          m_uTick;                                   //Number of samples taken since the debouncer was started
+
+	QAS_Debounce_Event         m_sQueue[QAS_Debounce_QueueSize];          //Event queue
+	volatile uint32_t          m_uHead;                                   //Number of events written to the queue, only changed by the timer interrupt
+	volatile uint32_t          m_uTail;                                   //Number of events read from the queue, only changed by getEvent()
+	volatile uint32_t          m_uOverflows;                              //Number of events discarded due to the queue being full
+
+	//------------
+	//Constructors
+	QAS_Debounce();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_Debounce(const QAS_Debounce& other) = delete;
+	QAS_Debounce& operator=(const QAS_Debounce& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_Debounce& get(void) {
+		static QAS_Debounce instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize the debouncer. The debouncer is not started until start() is called
+	//sInit - Initialization structure. See QAS_Debounce_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_Debounce_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to stop and deinitialize the debouncer
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the GPIO port and pins to be debounced for a port index
+	//uIdx       - Port index (0 to QAS_Debounce_MaxPorts-1)
+	//pGPIO      - GPIO port, or NULL to stop debouncing the port index
+	//uMask      - Pins of the port to be debounced, with bit 0 representing pin 0
+	//uActiveLow - Pins of the port that are active when low, such as buttons to ground with pull-up resistors
+	//Returns QA_OK if successful, or QA_Fail if the port index is not valid
+	static QA_Result setPort(uint8_t uIdx, GPIO_TypeDef* pGPIO, uint16_t uMask, uint16_t uActiveLow) {
+		return get().imp_setPort(uIdx, pGPIO, uMask, uActiveLow);
+	}
+
+	//Used to start sampling. The sample count and event queue are cleared
+	static void start(void) {
+		get().imp_start();
+	}
+
+	//Used to stop sampling. Events already queued can still be read
+	static void stop(void) {
+		get().imp_stop();
+	}
+
+	//Returns whether the debouncer is currently active. Member of QA_ActiveState as defined in setup.hpp
+	static QA_ActiveState getState(void) {
+		return get().m_eState;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the debounced levels of a port's pins, with 1 being active and bit 0 representing pin 0. Pins not being debounced are returned as 0
+	//uIdx - Port index (0 to QAS_Debounce_MaxPorts-1)
+	static uint16_t getInputs(uint8_t uIdx) {
+		if (uIdx >= QAS_Debounce_MaxPorts)
+			return 0;
+		return (uint16_t)get().m_sPorts[uIdx].uState;
+	}
+
+	//Returns the number of samples taken since the debouncer was started
+	static uint32_t getTick(void) {
+		return get().m_uTick;
+	}
+
+	//Returns the number of events waiting in the event queue
+	static uint16_t getPending(void) {
+		QAS_Debounce& sInstance = get();
+		return (uint16_t)(sInstance.m_uHead - sInstance.m_uTail);
+	}
+
+	//Returns the number of events discarded since the debouncer was started due to the event queue being full
+	static uint32_t getOverflows(void) {
+		return get().m_uOverflows;
+	}
+
+	//Used to read the oldest event from the event queue. Only one task may read events
+	//sEvent - Structure to receive the event
+	//Returns QA_OK if an event was read, or QA_Fail if the queue is empty
+	static QA_Result getEvent(QAS_Debounce_Event& sEvent) {
+		return get().imp_getEvent(sEvent);
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to pass the debouncer Timer peripheral's interrupt to the Timer driver
+	//This method is only to be called by the interrupt request handler function from handlers.cpp
+	static void irqHandler(void) {
+		QAS_Debounce& sInstance = get();
+		if (sInstance.m_eInitState)
+			sInstance.m_pTimer->handler();
+	}
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_Debounce.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_Debounce_InitStruct& sInit);
+	void imp_deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	QA_Result imp_setPort(uint8_t uIdx, GPIO_TypeDef* pGPIO, uint16_t uMask, uint16_t uActiveLow);
+	void imp_start(void);
+	void imp_stop(void);
+
+
+	//------------
+	//Data Methods
+
+	QA_Result imp_getEvent(QAS_Debounce_Event& sEvent);
+
+
+	//-------------
+	//Tool Methods
+
+	void queueEvents(uint8_t uIdx, uint32_t uChanged, uint32_t uState, uint32_t uTick);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_DEBOUNCE_HPP_ */
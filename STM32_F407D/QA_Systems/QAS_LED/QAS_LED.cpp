@@ -0,0 +1,300 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - LED                                                 */
+/*   Role: User LED Brightness and Effects                                 */
+/*   Filename: QAS_LED.cpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_LED.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//Gamma correction table, converting brightness levels into compare values. Built by the compiler and stored in flash
+static constexpr QAT_Gamma<QAS_LED_PWMPeriod> QAS_LED_Gamma;
+
+
+  //--------------------
+  //--------------------
+	//QAS_LED Constructors
+
+//QAS_LED::QAS_LED
+//QAS_LED Constructor
+//
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAS_LED::QAS_LED() :
+	m_eInitState(QA_NotInitialized),
+	m_pInstance(NULL),
+	m_sLEDs{},
+	m_uBuffer{} {}
+
+
+  //------------------------------
+  //------------------------------
+  //QAS_LED Initialization Methods
+
+//QAS_LED::imp_init
+//QAS_LED Initialization Method
+//
+//To be called from static method init()
+//Creates the PWM driver for Timer 4 with all four channels streamed from the circular buffer, and starts the LED outputs
+//sInit - Initialization structure. See QAS_LED_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Error_PeriphNotSupported if the timer clock is not a whole multiple of the PWM counter clock
+//        An error from the PWM driver if Timer 4, the LED pins or the DMA stream are not available
+QA_Result QAS_LED::imp_init(QAS_LED_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	uint32_t uClock = QAD_TimerMgr::getClockSpeed(QAD_Timer4);
+	if (uClock % (QAS_LED_PWMFrequency * QAS_LED_PWMPeriod))
+		return QA_Error_PeriphNotSupported;
+
+	//Set up PWM driver, with the LED pins connected to Timer 4 channels 1 to 4
+	QAD_PWM_InitStruct sPWMInit = {};
+	sPWMInit.eTimer     = QAD_Timer4;
+	sPWMInit.uPrescaler = (uClock / (QAS_LED_PWMFrequency * QAS_LED_PWMPeriod)) - 1;
+	sPWMInit.uPeriod    = QAS_LED_PWMPeriod - 1;
+	sPWMInit.eAlign     = QAD_PWM_AlignEdge;
+	sPWMInit.eBreak     = QAD_PWM_BreakDisabled;
+
+	GPIO_TypeDef* pGPIO[QAS_LED_Count] = {QAD_USERLED_GREEN_GPIO_PORT, QAD_USERLED_ORANGE_GPIO_PORT,
+	                                      QAD_USERLED_RED_GPIO_PORT, QAD_USERLED_BLUE_GPIO_PORT};
+	uint16_t      uPin[QAS_LED_Count]  = {QAD_USERLED_GREEN_GPIO_PIN, QAD_USERLED_ORANGE_GPIO_PIN,
+	                                      QAD_USERLED_RED_GPIO_PIN, QAD_USERLED_BLUE_GPIO_PIN};
+
+	for (uint8_t i=0; i<QAS_LED_Count; i++) {
+		sPWMInit.sChannels[i].eActive = QA_Active;
+		sPWMInit.sChannels[i].pGPIO   = pGPIO[i];
+		sPWMInit.sChannels[i].uPin    = uPin[i];
+		sPWMInit.sChannels[i].uAF     = GPIO_AF2_TIM4;
+	}
+
+	sPWMInit.uStreamChannels    = 0x0F;
+	sPWMInit.eDMAStream         = sInit.eDMAStream;
+	sPWMInit.bStreamLoop        = true;
+	sPWMInit.uStreamEvents      = QAD_DMA_Event_HalfTransfer | QAD_DMA_Event_TransferComplete;
+	sPWMInit.uStreamIRQPriority = sInit.uIRQPriority;
+
+	m_pPWM = std::make_unique<QAD_PWM>(sPWMInit);
+	QA_Result eRes = m_pPWM->init();
+	if (eRes) {
+		m_pPWM.reset();
+		return eRes;
+	}
+	m_pPWM->setStreamHandlerClass(this);
+
+	//Start with all LEDs off
+	for (uint8_t i=0; i<QAS_LED_Count; i++)
+		m_sLEDs[i] = {};
+	fill(m_uBuffer);
+	fill(m_uBuffer + (m_uBufferSize / 2));
+
+	m_pInstance  = QAD_TimerMgr::getInstance(QAD_Timer4);
+	m_eInitState = QA_Initialized;
+
+	//Start outputs
+	m_pPWM->start();
+	m_pPWM->startStream(m_uBuffer, m_uBufferSize);
+
+	return QA_OK;
+}
+
+
+//QAS_LED::imp_deinit
+//QAS_LED Initialization Method
+//
+//To be called from static method deinit()
+//Stops the LED outputs and removes the PWM driver
+void QAS_LED::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	m_pInstance  = NULL;
+	m_eInitState = QA_NotInitialized;
+
+	m_pPWM->stopStream();
+	m_pPWM->stop();
+	m_pPWM.reset();
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAS_LED Control Methods
+
+//QAS_LED::blink
+//QAS_LED Control Method
+//
+//Used to set an LED to continuously blink
+//eLED - The LED. Member of QAS_LED_ID
+//uOn  - Time in milliseconds that the LED is on for
+//uOff - Time in milliseconds that the LED is off for
+void QAS_LED::blink(QAS_LED_ID eLED, uint16_t uOn, uint16_t uOff) {
+	QAS_LED_Keyframe sFrames[2] = {{255, 0, uOn}, {0, 0, uOff}};
+	get().imp_setAnimation(eLED, sFrames, 2, true);
+}
+
+
+//QAS_LED::blinkCode
+//QAS_LED Control Method
+//
+//Used to set an LED to repeatedly show a number as a group of blinks followed by a pause, such as for showing an error code
+//eLED   - The LED. Member of QAS_LED_ID
+//uCode  - Number of blinks in each group (1 to QAS_LED_MaxKeyframes / 2). Larger values are limited to this range
+//uOn    - Time in milliseconds that the LED is on for in each blink
+//uOff   - Time in milliseconds that the LED is off for between blinks
+//uPause - Time in milliseconds that the LED is off for between groups of blinks
+void QAS_LED::blinkCode(QAS_LED_ID eLED, uint8_t uCode, uint16_t uOn, uint16_t uOff, uint16_t uPause) {
+	if (!uCode)
+		uCode = 1;
+	if (uCode > (QAS_LED_MaxKeyframes / 2))
+		uCode = QAS_LED_MaxKeyframes / 2;
+
+	QAS_LED_Keyframe sFrames[QAS_LED_MaxKeyframes];
+	for (uint8_t i=0; i<uCode; i++) {
+		sFrames[i * 2]       = {255, 0, uOn};
+		sFrames[(i * 2) + 1] = {0, 0, uOff};
+	}
+	sFrames[(uCode * 2) - 1].uHold = uPause;
+
+	get().imp_setAnimation(eLED, sFrames, uCode * 2, true);
+}
+
+
+//QAS_LED::imp_setAnimation
+//QAS_LED Control Method
+//
+//To be called from the static control methods
+//Copies an animation into the LED's animation state. The animation starts from the LED's current level at the next animation step
+//The state is shared with the DMA interrupt, so interrupts are disabled while it is replaced
+//eLED    - The LED. Member of QAS_LED_ID
+//pFrames - Array of keyframes
+//uCount  - Number of keyframes
+//bLoop   - Whether the animation repeats
+void QAS_LED::imp_setAnimation(QAS_LED_ID eLED, const QAS_LED_Keyframe* pFrames, uint8_t uCount, bool bLoop) {
+	if ((eLED >= QAS_LED_Count) || (!uCount))
+		return;
+
+	if (uCount > QAS_LED_MaxKeyframes)
+		uCount = QAS_LED_MaxKeyframes;
+
+	Animation& sLED = m_sLEDs[eLED];
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	for (uint8_t i=0; i<uCount; i++)
+		sLED.sFrames[i] = pFrames[i];
+
+	sLED.uCount = uCount;
+	sLED.uIndex = 0;
+	sLED.bLoop  = bLoop;
+	sLED.uStart = sLED.uLevel;
+	sLED.uTime  = 0;
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+  //---------------------------
+  //---------------------------
+  //QAS_LED IRQ Handler Methods
+
+//QAS_LED::handler
+//QAS_LED IRQ Handler Method
+//
+//Called by the DMA stream interrupt of the PWM driver
+//Advances the animations by one step, and refills the half of the buffer that has just been transferred
+//pData - Pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values as defined in QAD_DMAMgr.hpp)
+void QAS_LED::handler(void* pData) {
+	uint8_t uEvents = *(uint8_t*)pData;
+
+	if (uEvents & QAD_DMA_Event_HalfTransfer) {
+		for (uint8_t i=0; i<QAS_LED_Count; i++)
+			step(m_sLEDs[i]);
+		fill(m_uBuffer);
+	}
+
+	if (uEvents & QAD_DMA_Event_TransferComplete) {
+		for (uint8_t i=0; i<QAS_LED_Count; i++)
+			step(m_sLEDs[i]);
+		fill(m_uBuffer + (m_uBufferSize / 2));
+	}
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAS_LED Private Animation Methods
+
+//QAS_LED::step
+//QAS_LED Private Animation Method
+//
+//Used to advance the animation of an LED by QAS_LED_StepMS, updating the LED's level
+//When a keyframe has finished the next keyframe is started, or if the final keyframe of an animation that does not loop has finished,
+//the animation is ended with the LED remaining at the final level
+//sLED - Animation state of the LED
+void QAS_LED::step(Animation& sLED) {
+	if (!sLED.uCount)
+		return;
+
+	const QAS_LED_Keyframe& sFrame = sLED.sFrames[sLED.uIndex];
+	sLED.uTime += QAS_LED_StepMS;
+
+	//Ramp towards keyframe level
+	if (sLED.uTime < sFrame.uRamp) {
+		int32_t iDelta = (int32_t)sFrame.uLevel - (int32_t)sLED.uStart;
+		sLED.uLevel    = (uint8_t)((int32_t)sLED.uStart + ((iDelta * (int32_t)sLED.uTime) / (int32_t)sFrame.uRamp));
+		return;
+	}
+	sLED.uLevel = sFrame.uLevel;
+
+	//Move to next keyframe once the hold time has finished
+	uint32_t uLength = (uint32_t)sFrame.uRamp + sFrame.uHold;
+	if (sLED.uTime >= uLength) {
+		sLED.uTime -= uLength;
+		sLED.uStart = sFrame.uLevel;
+		sLED.uIndex++;
+
+		if (sLED.uIndex >= sLED.uCount) {
+			if (sLED.bLoop) {
+				sLED.uIndex = 0;
+			} else {
+				sLED.uCount = 0;
+				sLED.uTime  = 0;
+			}
+		}
+	}
+}
+
+
+//QAS_LED::fill
+//QAS_LED Private Animation Method
+//
+//Used to fill one half of the stream buffer with the gamma corrected compare values of the current LED levels
+//pBuffer - Pointer to the half of the buffer to be filled
+void QAS_LED::fill(uint16_t* pBuffer) {
+	uint16_t uVals[QAS_LED_Count];
+	for (uint8_t i=0; i<QAS_LED_Count; i++)
+		uVals[i] = QAS_LED_Gamma[m_sLEDs[i].uLevel];
+
+	for (uint16_t i=0; i<m_uStepPeriods; i++) {
+		for (uint8_t j=0; j<QAS_LED_Count; j++)
+			*pBuffer++ = uVals[j];
+	}
+}
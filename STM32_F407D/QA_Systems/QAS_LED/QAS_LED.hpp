@@ -0,0 +1,286 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - LED                                                 */
+/*   Role: User LED Brightness and Effects                                 */
+/*   Filename: QAS_LED.hpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_LED_HPP_
+#define __QAS_LED_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_PWM.hpp"
+#include "QAT_Gamma.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//----------------
+//LED Definitions
+//
+//QAS_LED_MaxKeyframes - Maximum number of keyframes in an animation
+//QAS_LED_StepMS       - Time in milliseconds between animation steps
+//QAS_LED_PWMFrequency - PWM frequency of the LED outputs in Hz
+//QAS_LED_PWMPeriod    - Number of timer counts in each PWM period, which is also the compare value for full brightness
+const uint8_t  QAS_LED_MaxKeyframes = 16;
+const uint16_t QAS_LED_StepMS       = 10;
+const uint32_t QAS_LED_PWMFrequency = 1000;
+const uint16_t QAS_LED_PWMPeriod    = 1000;
+
+
+//-----------
+//QAS_LED_ID
+//
+//Enum used to select one of the user LEDs
+//The LEDs are connected to pins D12 to D15 (see QAD_USERLED_**** definitions in setup.hpp), which are Timer 4 channels 1 to 4
+enum QAS_LED_ID : uint8_t {
+	QAS_LED_Green = 0,
+	QAS_LED_Orange,
+	QAS_LED_Red,
+	QAS_LED_Blue,
+	QAS_LED_Count
+};
+
+
+//----------------
+//QAS_LED_Keyframe
+//
+//This structure is used to describe one keyframe of an LED animation
+//The LED's brightness moves in a straight line from its current level to uLevel over uRamp milliseconds, and then remains at uLevel
+//for uHold milliseconds before the next keyframe starts. Times are rounded up to a multiple of QAS_LED_StepMS
+typedef struct {
+
+	uint8_t  uLevel;  //Brightness level (0 to 255). Levels are perceived brightness, and are gamma corrected by the system
+	uint16_t uRamp;   //Time in milliseconds taken to reach uLevel. Set to 0 to change level immediately
+	uint16_t uHold;   //Time in milliseconds to remain at uLevel
+
+} QAS_LED_Keyframe;
+
+
+//------------------
+//QAS_LED_InitStruct
+//
+//This structure is used to initialize the QAS_LED system
+typedef struct {
+
+	QAD_DMA_Stream eDMAStream;    //DMA stream to be used for Timer 4 update requests. Set to QAD_DMA_StreamNone to have a suitable stream
+	                              //found by QAD_DMAMgr
+	uint8_t        uIRQPriority;  //IRQ Priority for the DMA stream interrupt used to advance animations (a value between 0 and 15)
+
+} QAS_LED_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------
+//QAS_LED
+//
+//Singleton class
+//Brightness control and animations for the four user LEDs
+//
+//The LEDs are driven by Timer 4 through QAD_PWM. The compare values of all four channels are streamed by DMA from a circular buffer
+//holding two animation steps, with one step of QAS_LED_StepMS lasting a number of PWM periods. The DMA half transfer and transfer
+//complete interrupts advance the animations by one step and refill the half of the buffer that has just been sent, so that once an
+//animation has been set no processing is required from the main loop. Brightness levels are gamma corrected using QAT_Gamma.
+//
+//Animations are made up of keyframes (see QAS_LED_Keyframe), and can either run once (leaving the LED at the final level) or loop.
+//The methods used to set animations can be called from the main loop or from interrupts with a lower priority than the system's
+//DMA interrupt
+class QAS_LED : public QAD_IRQHandler_CallbackClass {
+private:
+
+	//Animation state of a single LED
+	typedef struct {
+		QAS_LED_Keyframe sFrames[QAS_LED_MaxKeyframes];  //Keyframes of the animation
+		uint8_t          uCount;                         //Number of keyframes. 0 if no animation is running
+		uint8_t          uIndex;                         //Index of the current keyframe
+		bool             bLoop;                          //Whether the animation repeats
+		uint8_t          uStart;                         //Level at the start of the current keyframe
+		uint8_t          uLevel;                         //Current level
+		uint32_t         uTime;                          //Time in milliseconds since the start of the current keyframe
+	} Animation;
+
+	//Number of PWM periods per animation step, and length of the stream buffer (two steps of four compare values per period)
+	static const uint16_t m_uStepPeriods = (QAS_LED_PWMFrequency * QAS_LED_StepMS) / 1000;
+	static const uint16_t m_uBufferSize  = m_uStepPeriods * QAS_LED_Count * 2;
+
+	std::unique_ptr<QAD_PWM> m_pPWM;                       //PWM driver used to drive the LEDs
+
+	QA_InitState             m_eInitState;                 //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+
+	TIM_TypeDef*             m_pInstance;                  //Timer registers, cached for use by fault()
+
+	Animation                m_sLEDs[QAS_LED_Count];       //Animation state of each LED
+	uint16_t                 m_uBuffer[m_uBufferSize];     //Circular buffer of compare values streamed to the timer
+
+	//------------
+	//Constructors
+	QAS_LED();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_LED(const QAS_LED& other) = delete;
+	QAS_LED& operator=(const QAS_LED& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_LED& get(void) {
+		static QAS_LED instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize the LED system and start the LED outputs, with all LEDs off
+	//sInit - Initialization structure. See QAS_LED_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_LED_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to stop and deinitialize the LED system. The LED pins are returned to their reset state
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the brightness of an LED, stopping any animation
+	//eLED   - The LED. Member of QAS_LED_ID
+	//uLevel - Brightness level (0 to 255)
+	static void setLevel(QAS_LED_ID eLED, uint8_t uLevel) {
+		QAS_LED_Keyframe sFrame = {uLevel, 0, 0};
+		get().imp_setAnimation(eLED, &sFrame, 1, false);
+	}
+
+	//Used to turn an LED fully on or off, stopping any animation
+	//eLED   - The LED. Member of QAS_LED_ID
+	//bState - true to turn the LED on, false to turn it off
+	static void set(QAS_LED_ID eLED, bool bState) {
+		setLevel(eLED, bState ? 255 : 0);
+	}
+
+	//Used to fade an LED from its current brightness to a new brightness
+	//eLED   - The LED. Member of QAS_LED_ID
+	//uLevel - Brightness level to fade to (0 to 255)
+	//uTime  - Time in milliseconds taken by the fade
+	static void fade(QAS_LED_ID eLED, uint8_t uLevel, uint16_t uTime) {
+		QAS_LED_Keyframe sFrame = {uLevel, uTime, 0};
+		get().imp_setAnimation(eLED, &sFrame, 1, false);
+	}
+
+	//Used to set an LED to continuously fade up and down
+	//eLED    - The LED. Member of QAS_LED_ID
+	//uPeriod - Time in milliseconds for one complete cycle
+	//uMin    - Lowest brightness level (0 to 255)
+	//uMax    - Highest brightness level (0 to 255)
+	static void breathe(QAS_LED_ID eLED, uint16_t uPeriod, uint8_t uMin = 0, uint8_t uMax = 255) {
+		QAS_LED_Keyframe sFrames[2] = {{uMax, (uint16_t)(uPeriod / 2), 0}, {uMin, (uint16_t)(uPeriod / 2), 0}};
+		get().imp_setAnimation(eLED, sFrames, 2, true);
+	}
+
+	//NOTE: See QAS_LED.cpp for details of the following methods
+	static void blink(QAS_LED_ID eLED, uint16_t uOn, uint16_t uOff);
+	static void blinkCode(QAS_LED_ID eLED, uint8_t uCode, uint16_t uOn, uint16_t uOff, uint16_t uPause);
+
+	//Used to set a custom animation on an LED. The keyframes are copied, so the array does not need to remain valid
+	//eLED    - The LED. Member of QAS_LED_ID
+	//pFrames - Array of keyframes. See QAS_LED_Keyframe for details
+	//uCount  - Number of keyframes (1 to QAS_LED_MaxKeyframes). Extra keyframes are ignored
+	//bLoop   - true for the animation to repeat, or false for it to run once
+	static void setAnimation(QAS_LED_ID eLED, const QAS_LED_Keyframe* pFrames, uint8_t uCount, bool bLoop) {
+		get().imp_setAnimation(eLED, pFrames, uCount, bLoop);
+	}
+
+	//Returns the current brightness level of an LED (0 to 255)
+	//eLED - The LED. Member of QAS_LED_ID
+	static uint8_t getLevel(QAS_LED_ID eLED) {
+		return get().m_sLEDs[eLED].uLevel;
+	}
+
+	//Returns true if an animation is running on an LED, or false if the LED is at a steady level
+	//eLED - The LED. Member of QAS_LED_ID
+	static bool isAnimating(QAS_LED_ID eLED) {
+		return (get().m_sLEDs[eLED].uCount != 0);
+	}
+
+	//Used to show a fault from an exception handler, with the red and orange LEDs on and the green and blue LEDs off
+	//This stops the animations by disabling the DMA request and writes the compare registers directly, so is safe to call with
+	//interrupts disabled or from a fault caused by the LED system itself. Does nothing if the system has not been initialized
+	static void fault(void) {
+		TIM_TypeDef* pInstance = get().m_pInstance;
+		if (!pInstance)
+			return;
+
+		pInstance->DIER &= ~TIM_DIER_UDE;
+		pInstance->CCR1  = 0;
+		pInstance->CCR2  = QAS_LED_PWMPeriod;
+		pInstance->CCR3  = QAS_LED_PWMPeriod;
+		pInstance->CCR4  = 0;
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_LED.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_LED_InitStruct& sInit);
+	void imp_deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void imp_setAnimation(QAS_LED_ID eLED, const QAS_LED_Keyframe* pFrames, uint8_t uCount, bool bLoop);
+
+
+	//-----------------
+	//Animation Methods
+
+	void step(Animation& sLED);
+	void fill(uint16_t* pBuffer);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_LED_HPP_ */
@@ -0,0 +1,239 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Multi-Encoder Sampler                                           */
+/*   Filename: QAS_EncoderSampler.cpp                                      */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_EncoderSampler.hpp"
+#include "QAS_Clock.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-------------------------------
+  //-------------------------------
+	//QAS_EncoderSampler Constructors
+
+//QAS_EncoderSampler::QAS_EncoderSampler
+//QAS_EncoderSampler Constructor
+//
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAS_EncoderSampler::QAS_EncoderSampler() :
+	m_eInitState(QA_NotInitialized),
+	m_eState(QA_Inactive),
+	m_pEncoders{},
+	m_sBuffer{},
+	m_uCount(0),
+	m_pHandlerFunction(NULL),
+	m_pHandlerClass(NULL) {}
+
+
+  //-----------------------------------------
+  //-----------------------------------------
+  //QAS_EncoderSampler Initialization Methods
+
+//QAS_EncoderSampler::imp_init
+//QAS_EncoderSampler Initialization Method
+//
+//To be called from static method init()
+//Creates the Timer driver used to time samples. Sampling is started by start()
+//sInit - Initialization structure. See QAS_EncoderSampler_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Fail if the sample frequency cannot be generated by the selected Timer peripheral to within QAS_EncoderSampler_TolerancePPM
+//        QA_Error_PeriphBusy if no Timer peripheral is available
+QA_Result QAS_EncoderSampler::imp_init(QAS_EncoderSampler_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Find a Timer peripheral if one has not been selected
+	QAD_Timer_Periph eTimer = sInit.eTimer;
+	if (eTimer == QAD_TimerNone) {
+		eTimer = QAD_TimerMgr::findTimer(QAD_Timer_16bit);
+		if (eTimer == QAD_TimerNone)
+			return QA_Error_PeriphBusy;
+	}
+
+	//Calculate prescaler and period for the required sample frequency
+	QAT_TimerSolution sSolution = QAT_TimerSolver::solveFrequency(eTimer, sInit.uSampleFrequency, QAS_EncoderSampler_TolerancePPM);
+	if (!sSolution.bValid)
+		return QA_Fail;
+
+	QAD_Timer_InitStruct sTimerInit;
+	sTimerInit.eTimer         = eTimer;
+	sTimerInit.eMode          = QAD_TimerContinuous;
+	sTimerInit.uPrescaler     = sSolution.uPrescaler;
+	sTimerInit.uPeriod        = sSolution.uPeriod;
+	sTimerInit.uIRQPriority   = sInit.uIRQPriority;
+	sTimerInit.uCounterTarget = 0;
+
+	m_pTimer = std::make_unique<QAD_Timer>(sTimerInit);
+	QA_Result eRes = m_pTimer->init();
+	if (eRes) {
+		m_pTimer.reset();
+		return eRes;
+	}
+
+	m_pTimer->setHandlerClass(this);
+	m_eState     = QA_Inactive;
+	m_eInitState = QA_Initialized;
+
+	return QA_OK;
+}
+
+
+//QAS_EncoderSampler::imp_deinit
+//QAS_EncoderSampler Initialization Method
+//
+//To be called from static method deinit()
+//Stops sampling and removes the Timer driver. The encoder drivers are not affected
+void QAS_EncoderSampler::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	imp_stop();
+	m_eInitState = QA_NotInitialized;
+	m_pTimer.reset();
+}
+
+
+  //----------------------------------
+  //----------------------------------
+  //QAS_EncoderSampler Control Methods
+
+//QAS_EncoderSampler::imp_setEncoder
+//QAS_EncoderSampler Control Method
+//
+//To be called from static method setEncoder()
+//The change takes effect from the next sample
+//uAxis    - Axis index (0 to QAS_EncoderSampler_MaxAxes-1)
+//pEncoder - Pointer to an encoder driver, or NULL to stop sampling the axis
+//Returns QA_OK if successful, or QA_Fail if the axis index is not valid
+QA_Result QAS_EncoderSampler::imp_setEncoder(uint8_t uAxis, QAD_Encoder* pEncoder) {
+	if (uAxis >= QAS_EncoderSampler_MaxAxes)
+		return QA_Fail;
+
+	m_pEncoders[uAxis] = pEncoder;
+	return QA_OK;
+}
+
+
+//QAS_EncoderSampler::imp_start
+//QAS_EncoderSampler Control Method
+//
+//To be called from static method start()
+//Clears the sample count and starts the sample timer. The first sample is taken one sample period after this method is called
+void QAS_EncoderSampler::imp_start(void) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	m_uCount = 0;
+	m_eState = QA_Active;
+	m_pTimer->start();
+}
+
+
+//QAS_EncoderSampler::imp_stop
+//QAS_EncoderSampler Control Method
+//
+//To be called from static method stop()
+void QAS_EncoderSampler::imp_stop(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	m_pTimer->stop();
+	m_eState = QA_Inactive;
+}
+
+
+  //-------------------------------
+  //-------------------------------
+  //QAS_EncoderSampler Data Methods
+
+//QAS_EncoderSampler::imp_getSnapshot
+//QAS_EncoderSampler Data Method
+//
+//To be called from static methods getSnapshot() and getLatest()
+//The snapshot is copied without disabling interrupts, and the sample count is checked again afterwards. The slot of a snapshot is only
+//rewritten while the sample count is at least QAS_EncoderSampler_BufferSize higher than its sequence number, so if the count is still
+//below this once the copy is complete then the copy cannot have been torn by the sampler interrupt
+//uSequence - Sequence number of the snapshot
+//sSnapshot - Structure to receive the snapshot
+//Returns QA_OK if successful, or QA_Fail if the snapshot has not yet been taken or has been overwritten
+QA_Result QAS_EncoderSampler::imp_getSnapshot(uint32_t uSequence, QAS_EncoderSampler_Snapshot& sSnapshot) {
+	//Check that the snapshot has been taken (uSequence is below the sample count, allowing for the count wrapping)
+	if ((uSequence - m_uCount) < 0x80000000)
+		return QA_Fail;
+
+	__DMB();
+	sSnapshot = m_sBuffer[uSequence % QAS_EncoderSampler_BufferSize];
+	__DMB();
+
+	if ((m_uCount - uSequence) >= QAS_EncoderSampler_BufferSize)
+		return QA_Fail;
+
+	return QA_OK;
+}
+
+
+  //--------------------------------------
+  //--------------------------------------
+  //QAS_EncoderSampler IRQ Handler Methods
+
+//QAS_EncoderSampler::handler
+//QAS_EncoderSampler IRQ Handler Method
+//
+//Called by the Timer driver when the update interrupt is triggered
+//Takes a snapshot of all axes into the next buffer slot, then calls the sample callbacks. Interrupts are disabled while the axes are
+//read so that an encoder interrupt cannot delay one axis relative to the others. Each encoder driver corrects for its own pending wrap
+//interrupt (see QAD_Encoder::getPosition()), so the readings are correct even though the encoder interrupts cannot run
+//pData - Unused
+void QAS_EncoderSampler::handler(void* pData) {
+	uint32_t uCount = m_uCount;
+	QAS_EncoderSampler_Snapshot& sSnapshot = m_sBuffer[uCount % QAS_EncoderSampler_BufferSize];
+
+	sSnapshot.uSequence = uCount;
+	sSnapshot.uAxes     = 0;
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	sSnapshot.uTime = QAS_Clock::nowTicks();
+	for (uint8_t i=0; i<QAS_EncoderSampler_MaxAxes; i++) {
+		QAD_Encoder* pEncoder = m_pEncoders[i];
+		if (pEncoder) {
+			sSnapshot.iPosition[i] = pEncoder->getPosition();
+			sSnapshot.iVelocity[i] = pEncoder->getVelocity();
+			sSnapshot.uAxes       |= (1 << i);
+		} else {
+			sSnapshot.iPosition[i] = 0;
+			sSnapshot.iVelocity[i] = 0;
+		}
+	}
+
+	__set_PRIMASK(uPrimask);
+
+	//Publish snapshot
+	__DMB();
+	m_uCount = uCount + 1;
+
+	//Call sample callbacks
+	if (m_pHandlerFunction)
+		m_pHandlerFunction(&sSnapshot);
+	if (m_pHandlerClass)
+		m_pHandlerClass->handler(&sSnapshot);
+}
@@ -0,0 +1,269 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Multi-Encoder Sampler                                           */
+/*   Filename: QAS_EncoderSampler.hpp                                      */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_ENCODERSAMPLER_HPP_
+#define __QAS_ENCODERSAMPLER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_Timer.hpp"
+#include "QAD_Encoder.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//--------------------
+//Sampler Definitions
+//
+//QAS_EncoderSampler_MaxAxes      - Maximum number of encoders that can be sampled
+//QAS_EncoderSampler_BufferSize   - Number of snapshots kept in the snapshot buffer
+//QAS_EncoderSampler_TolerancePPM - Largest error in the sample frequency accepted by init(), in parts per million. Kept small so
+//                                  that the snapshot sequence number can be used as a time base
+const uint8_t  QAS_EncoderSampler_MaxAxes      = 4;
+const uint8_t  QAS_EncoderSampler_BufferSize   = 16;
+const uint32_t QAS_EncoderSampler_TolerancePPM = 1000;
+
+
+//---------------------------
+//QAS_EncoderSampler_Snapshot
+//
+//This structure holds the readings of all encoders from a single sample
+typedef struct {
+
+	uint32_t uSequence;                                 //Sample number, counting from 0 when the sampler is started
+	uint64_t uTime;                                     //Time of the sample in QAS_Clock ticks (see QAS_Clock::nowTicks())
+	uint8_t  uAxes;                                     //Axes that were sampled, with bit 0 representing axis 0
+
+	int64_t  iPosition[QAS_EncoderSampler_MaxAxes];     //Position of each axis in counts (see QAD_Encoder::getPosition())
+	int32_t  iVelocity[QAS_EncoderSampler_MaxAxes];     //Velocity of each axis in counts per second (see QAD_Encoder::getVelocity())
+
+} QAS_EncoderSampler_Snapshot;
+
+
+//-----------------------------
+//QAS_EncoderSampler_InitStruct
+//
+//This structure is used to initialize the QAS_EncoderSampler system
+typedef struct {
+
+	QAD_Timer_Periph eTimer;            //Timer peripheral used to time samples. Set to QAD_TimerNone to have a timer found by QAD_TimerMgr
+	                                    //NOTE: handlers.cpp routes the Timer 6 and Timer 7 interrupts through QAD_TimerMgr::irqHandler(). For
+	                                    //      other timers, the IRQ handler function in handlers.cpp will need to call QAS_EncoderSampler::irqHandler()
+
+	uint32_t         uSampleFrequency;  //Sample frequency in Hz
+	uint8_t          uIRQPriority;      //IRQ Priority for timer update interrupt (a value between 0 and 15)
+
+} QAS_EncoderSampler_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------------
+//QAS_EncoderSampler
+//
+//Singleton class
+//Samples the position and velocity of several encoders (QAD_Encoder drivers in extended mode) at a fixed rate, for multi-axis control
+//
+//All axes are read from a single timer interrupt with other interrupts disabled, so the readings of a snapshot are taken within a few
+//hundred nanoseconds of each other and of the snapshot's timestamp. Snapshots are kept in a circular buffer, so a task can process every
+//sample even if it runs less often than the sample rate, as long as it keeps up with the buffer on average.
+//
+//Snapshots can be read without locks from tasks or from interrupts. A read is repeated if the snapshot was overwritten while it was
+//being copied, which can only happen if the reader falls a full buffer behind the sampler
+class QAS_EncoderSampler : public QAD_IRQHandler_CallbackClass {
+private:
+
+	std::unique_ptr<QAD_Timer> m_pTimer;                                       //Timer driver used to time samples
+
+	QA_InitState               m_eInitState;                                   //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState             m_eState;                                       //Stores whether the sampler is currently active. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAD_Encoder*               m_pEncoders[QAS_EncoderSampler_MaxAxes];        //Encoder driver of each axis, or NULL if the axis is not used
+
+	QAS_EncoderSampler_Snapshot m_sBuffer[QAS_EncoderSampler_BufferSize];      //Circular buffer of snapshots
+	volatile uint32_t          m_uCount;                                       //Number of snapshots taken since the sampler was started
+
+	QAD_IRQHandler_CallbackFunction m_pHandlerFunction;                        //Callback function to be called after each sample
+	QAD_IRQHandler_CallbackClass*   m_pHandlerClass;                           //Callback class to be called after each sample
+
+	//------------
+	//Constructors
+	QAS_EncoderSampler();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_EncoderSampler(const QAS_EncoderSampler& other) = delete;
+	QAS_EncoderSampler& operator=(const QAS_EncoderSampler& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_EncoderSampler& get(void) {
+		static QAS_EncoderSampler instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize the sampler. The sampler is not started until start() is called
+	//sInit - Initialization structure. See QAS_EncoderSampler_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_EncoderSampler_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to stop and deinitialize the sampler
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the encoder driver to be sampled for an axis
+	//uAxis    - Axis index (0 to QAS_EncoderSampler_MaxAxes-1)
+	//pEncoder - Pointer to an encoder driver in extended mode, or NULL to stop sampling the axis
+	//Returns QA_OK if successful, or QA_Fail if the axis index is not valid
+	static QA_Result setEncoder(uint8_t uAxis, QAD_Encoder* pEncoder) {
+		return get().imp_setEncoder(uAxis, pEncoder);
+	}
+
+	//Used to start sampling. The sample count and snapshot buffer are cleared
+	static void start(void) {
+		get().imp_start();
+	}
+
+	//Used to stop sampling. Snapshots already taken can still be read
+	static void stop(void) {
+		get().imp_stop();
+	}
+
+	//Returns whether the sampler is currently active. Member of QA_ActiveState as defined in setup.hpp
+	static QA_ActiveState getState(void) {
+		return get().m_eState;
+	}
+
+	//Used to set a callback function to be called from the timer interrupt after each sample, such as to run a control loop
+	//The callback is passed a pointer to the new QAS_EncoderSampler_Snapshot
+	//pHandler - Pointer to callback function based on QAD_IRQHandler_CallbackFunction prototype defined in setup.hpp, or NULL to remove
+	static void setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler) {
+		get().m_pHandlerFunction = pHandler;
+	}
+
+	//Used to set a callback class to be called from the timer interrupt after each sample
+	//The class's handler() method is passed a pointer to the new QAS_EncoderSampler_Snapshot
+	//pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp, or NULL to remove
+	static void setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler) {
+		get().m_pHandlerClass = pHandler;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the number of snapshots taken since the sampler was started. The most recent snapshot has a sequence number one less than this
+	static uint32_t getCount(void) {
+		return get().m_uCount;
+	}
+
+	//Used to read the most recent snapshot
+	//sSnapshot - Structure to receive the snapshot
+	//Returns QA_OK if successful, or QA_Fail if no snapshot has been taken
+	//The read only repeats if the reader is held up for most of a buffer's worth of samples part way through the copy
+	static QA_Result getLatest(QAS_EncoderSampler_Snapshot& sSnapshot) {
+		QAS_EncoderSampler& sInstance = get();
+		uint32_t uCount;
+
+		do {
+			uCount = sInstance.m_uCount;
+			if (!uCount)
+				return QA_Fail;
+		} while (sInstance.imp_getSnapshot(uCount - 1, sSnapshot));
+
+		return QA_OK;
+	}
+
+	//Used to read a snapshot by sequence number. The most recent (QAS_EncoderSampler_BufferSize - 1) snapshots are available
+	//uSequence - Sequence number of the snapshot
+	//sSnapshot - Structure to receive the snapshot
+	//Returns QA_OK if successful, or QA_Fail if the snapshot has not yet been taken or has been overwritten
+	static QA_Result getSnapshot(uint32_t uSequence, QAS_EncoderSampler_Snapshot& sSnapshot) {
+		return get().imp_getSnapshot(uSequence, sSnapshot);
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to pass the sampler Timer peripheral's interrupt to the Timer driver
+	//This method is only to be called by the interrupt request handler function from handlers.cpp
+	static void irqHandler(void) {
+		QAS_EncoderSampler& sInstance = get();
+		if (sInstance.m_eInitState)
+			sInstance.m_pTimer->handler();
+	}
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_EncoderSampler.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_EncoderSampler_InitStruct& sInit);
+	void imp_deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	QA_Result imp_setEncoder(uint8_t uAxis, QAD_Encoder* pEncoder);
+	void imp_start(void);
+	void imp_stop(void);
+
+
+	//------------
+	//Data Methods
+
+	QA_Result imp_getSnapshot(uint32_t uSequence, QAS_EncoderSampler_Snapshot& sSnapshot);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_ENCODERSAMPLER_HPP_ */
@@ -0,0 +1,330 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Closed Loop Motor Position/Velocity Controller                  */
+/*   Filename: QAS_Servo.cpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_Servo.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAS_Servo Initialization Methods
+
+//QAS_Servo::init
+//QAS_Servo Initialization Method
+//
+//Used to initialize the system, creating the Timer driver used to run the control loop. The control loop is started by start()
+//Returns QA_OK if initialization successful
+//        QA_Fail if the encoder or PWM driver is missing, or the loop frequency cannot be generated by the selected Timer peripheral to
+//                within QAS_Servo_TolerancePPM
+//        QA_Error_PeriphBusy if no Timer peripheral is available
+QA_Result QAS_Servo::init(void) {
+	if (m_eInitState)
+		return QA_OK;
+
+	if ((!m_pEncoder) || (!m_pPWM))
+		return QA_Fail;
+
+	//Find a Timer peripheral if one has not been selected
+	if (m_eTimer == QAD_TimerNone) {
+		m_eTimer = QAD_TimerMgr::findTimer(QAD_Timer_16bit);
+		if (m_eTimer == QAD_TimerNone)
+			return QA_Error_PeriphBusy;
+	}
+
+	//Calculate prescaler and period for the required loop frequency
+	QAT_TimerSolution sSolution = QAT_TimerSolver::solveFrequency(m_eTimer, m_uLoopFrequency, QAS_Servo_TolerancePPM);
+	if (!sSolution.bValid)
+		return QA_Fail;
+
+	QAD_Timer_InitStruct sTimerInit;
+	sTimerInit.eTimer         = m_eTimer;
+	sTimerInit.eMode          = QAD_TimerContinuous;
+	sTimerInit.uPrescaler     = sSolution.uPrescaler;
+	sTimerInit.uPeriod        = sSolution.uPeriod;
+	sTimerInit.uIRQPriority   = m_uIRQPriority;
+	sTimerInit.uCounterTarget = 0;
+
+	m_pTimer = std::make_unique<QAD_Timer>(sTimerInit);
+	QA_Result eRes = m_pTimer->init();
+	if (eRes) {
+		m_pTimer.reset();
+		return eRes;
+	}
+	m_pTimer->setHandlerClass(this);
+
+	//Limit the velocity loop output to the PWM range
+	m_iOutputFull = m_pPWM->getPeriod() + 1;
+	setVelocityGains(m_cVelocity.getGains());
+
+	m_eInitState = QA_Initialized;
+	return QA_OK;
+}
+
+
+//QAS_Servo::deinit
+//QAS_Servo Initialization Method
+//
+//Used to stop the control loop and remove the Timer driver. The encoder and PWM drivers are not deinitialized
+void QAS_Servo::deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	stop();
+	m_eInitState = QA_NotInitialized;
+	m_pTimer.reset();
+}
+
+
+  //-------------------------
+  //-------------------------
+  //QAS_Servo Control Methods
+
+//QAS_Servo::start
+//QAS_Servo Control Method
+//
+//Used to start the control loop
+//The position setpoint is set to the current position and the velocity setpoint to 0, and the loops are reset with their integral terms
+//cleared (as the motor output is zero while stopped), so the motor holds its current position (or is stopped in velocity mode) until a
+//new setpoint is given
+void QAS_Servo::start(void) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	m_iPosition        = m_pEncoder->getPosition();
+	m_iPositionTarget  = m_iPosition;
+	m_iVelocityTarget  = 0;
+	m_iVelocity        = 0;
+	m_iVelocityCommand = 0;
+	m_iOutput          = 0;
+	m_uDivider         = m_uPositionDivider - 1;
+	m_cPosition.reset();
+	m_cVelocity.reset();
+	writeOutput(0);
+
+	m_eState = QA_Active;
+	m_pTimer->start();
+}
+
+
+//QAS_Servo::stop
+//QAS_Servo Control Method
+//
+//Used to stop the control loop, setting the motor output to zero
+void QAS_Servo::stop(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	m_pTimer->stop();
+	m_eState           = QA_Inactive;
+	m_iVelocityCommand = 0;
+	m_iOutput          = 0;
+	writeOutput(0);
+}
+
+
+//QAS_Servo::setMode
+//QAS_Servo Control Method
+//
+//Used to change the control mode
+//When the mode changes the setpoints are set so that the motor holds its current position (in position mode) or is stopped (in velocity
+//mode). The change is bumpless: the integral term of the velocity loop is seeded with the current motor output, and that of the position
+//loop with the current velocity command, so a motor holding a load keeps its output rather than dropping to zero while the integral terms
+//build up again. In QAS_Servo_ModeOff the motor output is set to zero, so the loops start again from zero output when next enabled
+//eMode - The new mode. Member of QAS_Servo_Mode
+void QAS_Servo::setMode(QAS_Servo_Mode eMode) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	if (eMode != m_eMode) {
+		if (eMode == QAS_Servo_ModeOff) {
+			m_iVelocityCommand = 0;
+			m_iOutput          = 0;
+			if (m_eInitState)
+				writeOutput(0);
+		}
+
+		m_iPositionTarget = m_iPosition;
+		m_iVelocityTarget = 0;
+		m_uDivider        = m_uPositionDivider - 1;
+		m_cPosition.reset(m_iVelocityCommand);
+		m_cVelocity.reset(m_iOutput);
+		m_eMode           = eMode;
+	}
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_Servo::setPosition
+//QAS_Servo Control Method
+//
+//Used to set the position setpoint for position mode
+//For smooth moves the setpoint should follow a motion profile, being updated at least as often as the position loop runs, with iVelocity
+//set to the profile's current velocity. This is added to the position loop's output, so that the position loop only has to correct errors
+//iPosition - Position setpoint in encoder counts
+//iVelocity - Velocity feed-forward in counts per second
+void QAS_Servo::setPosition(int64_t iPosition, int32_t iVelocity) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_iPositionTarget = iPosition;
+	m_iVelocityTarget = iVelocity;
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_Servo::setVelocity
+//QAS_Servo Control Method
+//
+//Used to set the velocity setpoint for velocity mode
+//iVelocity - Velocity setpoint in counts per second
+void QAS_Servo::setVelocity(int32_t iVelocity) {
+	m_iVelocityTarget = iVelocity;
+}
+
+
+//QAS_Servo::setPositionGains
+//QAS_Servo Control Method
+//
+//Used to change the gains and velocity limits of the position loop. The integral term is kept, so gains can be tuned while running
+//sGains - Gains and output limits. See QAS_Servo_InitStruct and QAT_PID_Gains for details
+void QAS_Servo::setPositionGains(const QAT_PID_Gains& sGains) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_cPosition.setGains(sGains);
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_Servo::setVelocityGains
+//QAS_Servo Control Method
+//
+//Used to change the gains and output limits of the velocity loop. The integral term is kept, so gains can be tuned while running
+//Once initialized, the output limits are limited to +/- (PWM period + 1)
+//sGains - Gains and output limits. See QAS_Servo_InitStruct and QAT_PID_Gains for details
+void QAS_Servo::setVelocityGains(const QAT_PID_Gains& sGains) {
+	QAT_PID_Gains sLimited = sGains;
+	if (m_iOutputFull) {
+		if (sLimited.iOutMax > m_iOutputFull)
+			sLimited.iOutMax = m_iOutputFull;
+		if (sLimited.iOutMin < -m_iOutputFull)
+			sLimited.iOutMin = -m_iOutputFull;
+	}
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_cVelocity.setGains(sLimited);
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAS_Servo IRQ Handler Methods
+
+//QAS_Servo::handler
+//QAS_Servo IRQ Handler Method
+//
+//Called by the Timer driver when the update interrupt is triggered
+//Measures the position and velocity, runs the position loop (in position mode, once every uPositionDivider samples) and the velocity loop,
+//and writes the new motor output to the PWM compare registers
+//pData - Unused
+void QAS_Servo::handler(void* pData) {
+	int64_t iPosition = m_pEncoder->getPosition();
+	int32_t iVelocity = measureVelocity(iPosition);
+	m_iPosition       = iPosition;
+	m_iVelocity       = iVelocity;
+
+	QAS_Servo_Mode eMode = m_eMode;
+	if (eMode == QAS_Servo_ModeOff)
+		return;
+
+	//Position loop
+	if (eMode == QAS_Servo_ModePosition) {
+		if (++m_uDivider >= m_uPositionDivider) {
+			m_uDivider = 0;
+
+			int64_t iError = m_iPositionTarget - iPosition;
+			if (iError > QAT_PID_Limit)
+				iError = QAT_PID_Limit;
+			if (iError < -QAT_PID_Limit)
+				iError = -QAT_PID_Limit;
+
+			m_iVelocityCommand = m_cPosition.update((int32_t)iError, (int32_t)iPosition, m_iVelocityTarget);
+		}
+	} else {
+		m_iVelocityCommand = m_iVelocityTarget;
+	}
+
+	//Velocity loop
+	int64_t iError = (int64_t)m_iVelocityCommand - iVelocity;
+	m_iOutput      = m_cVelocity.update((iError > QAT_PID_Limit) ? QAT_PID_Limit : ((iError < -QAT_PID_Limit) ? -QAT_PID_Limit : (int32_t)iError),
+	                                    iVelocity, m_iVelocityCommand);
+	writeOutput(m_iOutput);
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAS_Servo Private Tool Methods
+
+//QAS_Servo::measureVelocity
+//QAS_Servo Private Tool Method
+//
+//Returns the velocity in counts per second, either from the encoder driver's estimate or from the change in position since the
+//previous sample (which has a resolution of one count per sample period)
+//iPosition - Position at the current sample
+int32_t QAS_Servo::measureVelocity(int64_t iPosition) {
+	if (m_bEncoderVelocity)
+		return m_pEncoder->getVelocity();
+
+	int64_t iVelocity = (iPosition - m_iPosition) * m_uLoopFrequency;
+	return (iVelocity > INT32_MAX) ? INT32_MAX : ((iVelocity < INT32_MIN) ? INT32_MIN : (int32_t)iVelocity);
+}
+
+
+//QAS_Servo::writeOutput
+//QAS_Servo Private Tool Method
+//
+//Used to write a motor output to the PWM compare registers, depending on the output mode
+//iOutput - Motor output in PWM counts, from -(PWM period + 1) for full reverse to (PWM period + 1) for full forward
+void QAS_Servo::writeOutput(int32_t iOutput) {
+	if (iOutput > m_iOutputFull)
+		iOutput = m_iOutputFull;
+	if (iOutput < -m_iOutputFull)
+		iOutput = -m_iOutputFull;
+
+	if (m_eOutput == QAS_Servo_OutputAntiphase) {
+		m_pPWM->setPWMValFast(m_eChannelA, (uint32_t)((m_iOutputFull + iOutput) / 2));
+	} else if (iOutput >= 0) {
+		m_pPWM->setPWMValFast(m_eChannelB, 0);
+		m_pPWM->setPWMValFast(m_eChannelA, (uint32_t)iOutput);
+	} else {
+		m_pPWM->setPWMValFast(m_eChannelA, 0);
+		m_pPWM->setPWMValFast(m_eChannelB, (uint32_t)-iOutput);
+	}
+}
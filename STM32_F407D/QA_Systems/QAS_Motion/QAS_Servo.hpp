@@ -0,0 +1,289 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Closed Loop Motor Position/Velocity Controller                  */
+/*   Filename: QAS_Servo.hpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_SERVO_HPP_
+#define __QAS_SERVO_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_Timer.hpp"
+#include "QAD_Encoder.hpp"
+#include "QAD_PWM.hpp"
+#include "QAT_PID.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------
+//Servo Definitions
+//
+//QAS_Servo_TolerancePPM - Largest error in the loop frequency accepted by init(), in parts per million. Kept small as the velocity
+//                         calculated from the change in position is scaled by the requested loop frequency
+const uint32_t QAS_Servo_TolerancePPM = 1000;
+
+
+//--------------
+//QAS_Servo_Mode
+//
+//Used to select the control mode of the QAS_Servo system
+enum QAS_Servo_Mode : uint8_t {
+	QAS_Servo_ModeOff = 0,      //Control loop is not run, and the motor output is set to zero
+	QAS_Servo_ModeVelocity,     //Velocity loop only. The motor is driven at the velocity set by setVelocity()
+	QAS_Servo_ModePosition      //Cascaded position and velocity loops. The motor is driven to the position set by setPosition()
+};
+
+
+//----------------
+//QAS_Servo_Output
+//
+//Used to select how the controller output drives the motor through the PWM driver
+enum QAS_Servo_Output : uint8_t {
+	QAS_Servo_OutputSignMag = 0,  //Sign-magnitude. Two PWM channels drive the two inputs of an H-bridge (such as IN1/IN2 of a DRV8833), with
+	                              //channel A driven for positive outputs and channel B driven for negative outputs, the other being held low
+	QAS_Servo_OutputAntiphase     //Locked antiphase. A single PWM channel drives both sides of an H-bridge (normally with its complementary
+	                              //output on Timer 1 or 8), with 50% duty for zero output, 100% duty for full positive and 0% for full negative
+};
+
+
+//--------------------
+//QAS_Servo_InitStruct
+//
+//This structure is used to create the QAS_Servo system class
+typedef struct {
+
+	QAD_Encoder*      pEncoder;         //Encoder driver measuring the motor's position. Must be initialized in extended mode (see QAD_Encoder.hpp)
+	bool              bEncoderVelocity; //Set to true to use the encoder driver's velocity estimate (QAD_Encoder::getVelocity()), or false to
+	                                    //calculate velocity from the change in position at each sample. The encoder's estimate has a much finer
+	                                    //resolution at low speeds, but needs the encoder's velocity timer to be set up
+
+	QAD_PWM*          pPWM;             //PWM driver driving the motor bridge. Must be initialized and started before start() is called
+	QAS_Servo_Output  eOutput;          //Output mode. Member of QAS_Servo_Output
+	QAD_PWM_Channel   eChannelA;        //PWM channel for positive output (or the single channel in QAS_Servo_OutputAntiphase mode)
+	QAD_PWM_Channel   eChannelB;        //PWM channel for negative output. Not used in QAS_Servo_OutputAntiphase mode
+
+	QAD_Timer_Periph  eTimer;           //Timer peripheral used to run the control loop. Set to QAD_TimerNone to have a timer found by QAD_TimerMgr
+	                                    //NOTE: handlers.cpp routes the Timer 6 and Timer 7 interrupts through QAD_TimerMgr::irqHandler(). For
+	                                    //      other timers, the IRQ handler function in handlers.cpp will need to call irqHandler()
+	uint32_t          uLoopFrequency;   //Velocity loop rate in Hz
+	uint8_t           uPositionDivider; //Number of velocity loop samples per position loop sample (0 or 1 to run both at the same rate)
+	uint8_t           uIRQPriority;     //IRQ Priority for the control loop timer interrupt (a value between 0 and 15)
+
+	QAT_PID_Gains     sPositionGains;   //Gains of the position loop, taking position error in counts and giving a velocity in counts per second
+	                                    //Its feed-forward input is the velocity set by setPosition(). Output limits are the velocity limits
+	QAT_PID_Gains     sVelocityGains;   //Gains of the velocity loop, taking velocity error in counts per second and giving a motor output
+	                                    //Its feed-forward input is the velocity setpoint, so iKff is the output per count per second needed to
+	                                    //overcome back EMF. Output limits are in PWM counts, and are limited to the PWM period
+
+} QAS_Servo_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------
+//QAS_Servo
+//
+//System class used to control the position or velocity of a brushed DC motor, using a QAD_Encoder driver for feedback and a QAD_PWM
+//driver to drive the motor's H-bridge
+//
+//The control loop runs from the update interrupt of its own timer, so runs at a fixed rate with the timing jitter of an interrupt
+//rather than of the main loop. In position mode a position PID loop gives a velocity setpoint, which is passed along with the position
+//setpoint's velocity (as feed-forward) to a velocity PID loop, which gives the motor output. The velocity loop can run faster than the
+//position loop (see uPositionDivider). Both loops use QAT_PID, so the loop uses only integer arithmetic, and has integrator anti-windup
+//and feed-forward on both loops.
+//
+//The motor output is written straight to the timer's compare registers (see QAD_PWM::setPWMValFast()), taking effect at the next PWM
+//period. Setpoints can be changed at any time from the main loop or lower priority interrupts.
+//
+//More than one QAS_Servo can be used, each with its own encoder, PWM channels and timer
+class QAS_Servo : public QAD_IRQHandler_CallbackClass {
+private:
+
+	QA_InitState               m_eInitState;       //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState             m_eState;           //Stores whether the control loop is currently running. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAD_Encoder*               m_pEncoder;         //Encoder driver
+	bool                       m_bEncoderVelocity; //Whether the encoder driver's velocity estimate is used
+	QAD_PWM*                   m_pPWM;             //PWM driver
+	QAS_Servo_Output           m_eOutput;          //Output mode
+	QAD_PWM_Channel            m_eChannelA;        //PWM channel for positive output
+	QAD_PWM_Channel            m_eChannelB;        //PWM channel for negative output
+	int32_t                    m_iOutputFull;      //Output value for full drive (the PWM period + 1)
+
+	QAD_Timer_Periph           m_eTimer;           //Timer peripheral used to run the control loop
+	uint32_t                   m_uLoopFrequency;   //Velocity loop rate in Hz
+	uint8_t                    m_uPositionDivider; //Velocity loop samples per position loop sample
+	uint8_t                    m_uIRQPriority;     //IRQ Priority for the control loop timer interrupt
+	std::unique_ptr<QAD_Timer> m_pTimer;           //Timer driver used to run the control loop
+
+	QAT_PID                    m_cPosition;        //Position loop
+	QAT_PID                    m_cVelocity;        //Velocity loop
+
+	volatile QAS_Servo_Mode    m_eMode;            //Current control mode
+	volatile int64_t           m_iPositionTarget;  //Position setpoint in counts
+	volatile int32_t           m_iVelocityTarget;  //Velocity setpoint in counts per second (position feed-forward in position mode)
+
+	int64_t                    m_iPosition;        //Position at the most recent sample
+	int32_t                    m_iVelocity;        //Velocity at the most recent sample
+	int32_t                    m_iVelocityCommand; //Velocity setpoint given to the velocity loop at the most recent sample
+	int32_t                    m_iOutput;          //Motor output at the most recent sample
+	uint8_t                    m_uDivider;         //Counts velocity loop samples between position loop samples
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAS_Servo() = delete;                        //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAS_Servo(QAS_Servo_InitStruct& sInit) :     //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_pEncoder(sInit.pEncoder),
+		m_bEncoderVelocity(sInit.bEncoderVelocity),
+		m_pPWM(sInit.pPWM),
+		m_eOutput(sInit.eOutput),
+		m_eChannelA(sInit.eChannelA),
+		m_eChannelB(sInit.eChannelB),
+		m_iOutputFull(0),
+		m_eTimer(sInit.eTimer),
+		m_uLoopFrequency(sInit.uLoopFrequency),
+		m_uPositionDivider(sInit.uPositionDivider ? sInit.uPositionDivider : 1),
+		m_uIRQPriority(sInit.uIRQPriority),
+		m_cPosition(sInit.sPositionGains),
+		m_cVelocity(sInit.sVelocityGains),
+		m_eMode(QAS_Servo_ModeOff),
+		m_iPositionTarget(0),
+		m_iVelocityTarget(0),
+		m_iPosition(0),
+		m_iVelocity(0),
+		m_iVelocityCommand(0),
+		m_iOutput(0),
+		m_uDivider(0) {}
+
+	~QAS_Servo() {       //Destructor to make sure the control loop is stopped and the system deinitialized upon class destruction
+
+		//Deinitialize system if currently initialized (which also stops the control loop)
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAS_Servo.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void start(void);
+	void stop(void);
+
+	QA_ActiveState getState(void) {
+		return m_eState;
+	}
+
+	void setMode(QAS_Servo_Mode eMode);
+
+	//Returns the current control mode. Member of QAS_Servo_Mode
+	QAS_Servo_Mode getMode(void) {
+		return m_eMode;
+	}
+
+	void setPosition(int64_t iPosition, int32_t iVelocity = 0);
+	void setVelocity(int32_t iVelocity);
+
+	void setPositionGains(const QAT_PID_Gains& sGains);
+	void setVelocityGains(const QAT_PID_Gains& sGains);
+
+
+	//------------
+	//Data Methods
+
+	//Returns the measured position in counts at the most recent control loop sample
+	int64_t getPosition(void) {
+		uint32_t uPrimask = __get_PRIMASK();
+		__disable_irq();
+		int64_t iPosition = m_iPosition;
+		__set_PRIMASK(uPrimask);
+		return iPosition;
+	}
+
+	//Returns the measured velocity in counts per second at the most recent control loop sample
+	int32_t getVelocity(void) {
+		return m_iVelocity;
+	}
+
+	//Returns the velocity setpoint given to the velocity loop at the most recent control loop sample, in counts per second
+	int32_t getVelocityCommand(void) {
+		return m_iVelocityCommand;
+	}
+
+	//Returns the motor output at the most recent control loop sample, in PWM counts (negative values are reverse drive)
+	int32_t getOutput(void) {
+		return m_iOutput;
+	}
+
+	//Returns true if the velocity loop output was limited at the most recent control loop sample
+	bool isSaturated(void) {
+		return m_cVelocity.isSaturated();
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to pass the control loop Timer peripheral's interrupt to the Timer driver
+	//This method is only to be called by the interrupt request handler function from handlers.cpp
+	void irqHandler(void) {
+		if (m_eInitState)
+			m_pTimer->handler();
+	}
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_Servo.cpp for details of the following methods
+
+	//-------------
+	//Tool Methods
+
+	int32_t measureVelocity(int64_t iPosition);
+	void writeOutput(int32_t iOutput);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_SERVO_HPP_ */
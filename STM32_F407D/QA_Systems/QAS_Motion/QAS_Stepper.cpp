@@ -0,0 +1,413 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Stepper Motor Step/Direction Generator                          */
+/*   Filename: QAS_Stepper.cpp                                             */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_Stepper.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //----------------------------------
+  //----------------------------------
+  //QAS_Stepper Initialization Methods
+
+//QAS_Stepper::init
+//QAS_Stepper Initialization Method
+//
+//Used to initialize the system, creating the PWM driver for the step output and the GPIO driver for the direction output
+//Step generation is started by start()
+//Returns QA_OK if initialization successful
+//        QA_Error_PeriphNotSupported if the timer is not a 32bit timer, or uTickFrequency does not divide the timer clock exactly
+//        An error from the PWM driver if the timer, step pin or DMA stream are not available
+//        QA_Error_PeriphBusy if the direction pin is already in use
+QA_Result QAS_Stepper::init(void) {
+	if (m_eInitState)
+		return QA_OK;
+
+	if (QAD_TimerMgr::getType(m_eTimer) != QAD_Timer_32bit)
+		return QA_Error_PeriphNotSupported;
+
+	uint32_t uClock = QAD_TimerMgr::getClockSpeed(m_eTimer);
+	if ((!m_uTickFrequency) || (m_uTickFrequency > uClock) || (uClock % m_uTickFrequency))
+		return QA_Error_PeriphNotSupported;
+
+	//Idle periods need to be long enough that a change of direction made during one is seen by the motor driver before the next step
+	m_uIdleTicks = m_uTickFrequency / QAS_Stepper_IdleRate;
+	if (m_uIdleTicks < (m_uPulseTicks * 2))
+		m_uIdleTicks = m_uPulseTicks * 2;
+
+	//Set up PWM driver, streaming the auto-reload register, repetition counter and compare registers up to the step output's channel
+	m_uStride = 3 + m_eChannel;
+
+	QAD_PWM_InitStruct sPWMInit = {};
+	sPWMInit.eTimer     = m_eTimer;
+	sPWMInit.uPrescaler = (uClock / m_uTickFrequency) - 1;
+	sPWMInit.uPeriod    = m_uIdleTicks - 1;
+	sPWMInit.eAlign     = QAD_PWM_AlignEdge;
+	sPWMInit.eBreak     = QAD_PWM_BreakDisabled;
+
+	sPWMInit.sChannels[m_eChannel].eActive = QA_Active;
+	sPWMInit.sChannels[m_eChannel].pGPIO   = m_pStepGPIO;
+	sPWMInit.sChannels[m_eChannel].uPin    = m_uStepPin;
+	sPWMInit.sChannels[m_eChannel].uAF     = m_uStepAF;
+
+	sPWMInit.uStreamChannels    = 1 << m_eChannel;
+	sPWMInit.eDMAStream         = m_eDMAStream;
+	sPWMInit.bStreamLoop        = true;
+	sPWMInit.bStreamPeriod      = true;
+	sPWMInit.uStreamEvents      = QAD_DMA_Event_HalfTransfer | QAD_DMA_Event_TransferComplete;
+	sPWMInit.uStreamIRQPriority = m_uIRQPriority;
+
+	m_pPWM = std::make_unique<QAD_PWM>(sPWMInit);
+	QA_Result eRes = m_pPWM->init();
+	if (eRes) {
+		m_pPWM.reset();
+		return eRes;
+	}
+	m_pPWM->setStreamHandlerClass(this);
+
+	//Set up direction output
+	m_pDir = std::make_unique<QAD_GPIO_Output>(m_pDirGPIO, m_uDirPin, QAD_GPIO_OutputMode_PushPull, QAD_GPIO_PullMode_NoPull, QAD_GPIO_Speed_Low);
+	if (!m_pDir->getInitState()) {
+		m_pDir.reset();
+		m_pPWM.reset();
+		return QA_Error_PeriphBusy;
+	}
+	setDir(m_bFillDir);
+
+	m_eInitState = QA_Initialized;
+	return QA_OK;
+}
+
+
+//QAS_Stepper::deinit
+//QAS_Stepper Initialization Method
+//
+//Used to stop step generation and remove the PWM and GPIO drivers
+void QAS_Stepper::deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	stop();
+	m_eInitState = QA_NotInitialized;
+	m_pPWM.reset();
+	m_pDir.reset();
+}
+
+
+  //---------------------------
+  //---------------------------
+  //QAS_Stepper Control Methods
+
+//QAS_Stepper::start
+//QAS_Stepper Control Method
+//
+//Used to start step generation. Any moves that have already been added are started straight away, and moves added later are started
+//as they are added
+void QAS_Stepper::start(void) {
+	if ((!m_eInitState) || (m_eState))
+		return;
+
+	//Load an idle period, so that the first stream transfer is made one idle period after the timer is started
+	m_pPWM->setPWMValFast(m_eChannel, 0);
+	m_pPWM->setPeriodFast(m_uIdleTicks - 1);
+	m_pPWM->generateUpdate();
+
+	//Fill both halves of the buffer. The direction output is free to change before the first half
+	m_bOpenStep  = false;
+	m_uTrailIdle = 2;
+	fill(0);
+	fill(1);
+
+	m_uActiveHalf = 0;
+	m_bFirstPass  = true;
+	m_iPrevTail   = 0;
+	setDir(m_bHalfDir[0]);
+
+	//Start stream before the timer, so that the first update request is not missed
+	m_eState = QA_Active;
+	m_pPWM->startStream(m_uBuffer, QAS_Stepper_HalfEntries * 2 * m_uStride);
+	m_pPWM->start();
+}
+
+
+//QAS_Stepper::stop
+//QAS_Stepper Control Method
+//
+//Used to stop step generation straight away, clearing any queued moves
+//The timer is stopped part way through the current step interval (or step pulse), so this is intended for aborting moves rather than for
+//normal use, where moves are run through to their end. The position is updated to include every step pulse that was started
+void QAS_Stepper::stop(void) {
+	if ((!m_eInitState) || (!m_eState))
+		return;
+
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	//Stop timer first, so that no further stream transfers are made while the position is found
+	m_pPWM->stop();
+	m_iPosition += streamSteps();
+	m_pPWM->stopStream();
+
+	m_eState        = QA_Inactive;
+	m_uHalfSteps[0] = 0;
+	m_uHalfSteps[1] = 0;
+	m_cPlanner.clear();
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_Stepper::move
+//QAS_Stepper Control Method
+//
+//Used to add a move to the end of the queue. See QAT_StepPlanner::add() for details of how queued moves are joined
+//iSteps - Length of the move in steps. Negative values move in the negative direction
+//uSpeed - Requested speed in steps/s. Limited to getMaxSpeed()
+//Returns QA_OK if the move was added (or iSteps is 0), or QA_Fail if the queue is full or uSpeed is 0
+QA_Result QAS_Stepper::move(int32_t iSteps, uint32_t uSpeed) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	QA_Result eRes = m_cPlanner.add(iSteps, uSpeed);
+
+	__set_PRIMASK(uPrimask);
+	return eRes;
+}
+
+
+//QAS_Stepper::setAccel
+//QAS_Stepper Control Method
+//
+//Used to set the acceleration and acceleration profile used for moves added after this call. Moves already added are not changed
+//uAccel   - Peak acceleration in steps/s^2
+//eProfile - Acceleration profile. Member of QAT_StepProfile
+void QAS_Stepper::setAccel(uint32_t uAccel, QAT_StepProfile eProfile) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_cPlanner.setAccel(uAccel, eProfile);
+
+	__set_PRIMASK(uPrimask);
+}
+
+
+//QAS_Stepper::setPosition
+//QAS_Stepper Control Method
+//
+//Used to set the current position, such as once the motor has been homed
+//iPosition - New position in steps
+//Returns QA_OK if the position was set, or QA_Fail if a move is in progress (see isBusy())
+QA_Result QAS_Stepper::setPosition(int64_t iPosition) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	QA_Result eRes = QA_Fail;
+	if ((m_cPlanner.isIdle()) && (!m_uHalfSteps[0]) && (!m_uHalfSteps[1])) {
+		m_iPosition = iPosition;
+		eRes        = QA_OK;
+	}
+
+	__set_PRIMASK(uPrimask);
+	return eRes;
+}
+
+
+//QAS_Stepper::isBusy
+//QAS_Stepper Control Method
+//
+//Returns true if moves are queued or being run, or false once the final step of the final move has been passed to the timer
+bool QAS_Stepper::isBusy(void) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	bool bBusy = (!m_cPlanner.isIdle()) || (m_uHalfSteps[0]) || (m_uHalfSteps[1]);
+
+	__set_PRIMASK(uPrimask);
+	return bBusy;
+}
+
+
+  //------------------------
+  //------------------------
+  //QAS_Stepper Data Methods
+
+//QAS_Stepper::getPosition
+//QAS_Stepper Data Method
+//
+//Returns the position in steps, including every step pulse that has been started by the timer
+int64_t QAS_Stepper::getPosition(void) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	int64_t iPosition = m_iPosition;
+	if (m_eState)
+		iPosition += streamSteps();
+
+	__set_PRIMASK(uPrimask);
+	return iPosition;
+}
+
+
+  //-------------------------------
+  //-------------------------------
+  //QAS_Stepper IRQ Handler Methods
+
+//QAS_Stepper::handler
+//QAS_Stepper IRQ Handler Method
+//
+//Called by the DMA stream interrupt of the PWM driver
+//For each half of the buffer that has been transferred, adds its steps to the position, saves the step held in its last period for
+//streamSteps(), sets the direction output for the other half (which is now being transferred), and refills it with the following steps
+//pData - Pointer to a uint8_t containing the events that triggered the interrupt (made up of QAD_DMA_Event values as defined in QAD_DMAMgr.hpp)
+void QAS_Stepper::handler(void* pData) {
+	uint8_t uEvents = *(uint8_t*)pData;
+	if (!m_eState)
+		return;
+
+	for (uint8_t uHalf=0; uHalf<2; uHalf++) {
+		if (!(uEvents & ((uHalf) ? QAD_DMA_Event_TransferComplete : QAD_DMA_Event_HalfTransfer)))
+			continue;
+
+		m_iPosition  += (m_bHalfDir[uHalf]) ? (int64_t)m_uHalfSteps[uHalf] : -(int64_t)m_uHalfSteps[uHalf];
+		m_iPrevTail   = m_iHalfTail[uHalf];
+		m_uActiveHalf = uHalf ^ 1;
+		m_bFirstPass  = false;
+		setDir(m_bHalfDir[uHalf ^ 1]);
+		fill(uHalf);
+	}
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAS_Stepper Private Tool Methods
+
+//QAS_Stepper::fill
+//QAS_Stepper Private Tool Method
+//
+//Used to fill one half of the buffer with the following steps from the planner
+//Each PWM period starts with the step pulse (if it holds a step) and lasts until the next step, so the interval given by the planner for
+//a step sets the length of the period before it, with the step itself placed at the start of the following period. While no step is
+//available idle periods are used. A half holds steps in only one direction, which is locked to the direction of the previous half if a
+//step carries over from it or if it did not end with two periods without a pulse. Once a step in the other direction is reached, the rest
+//of the half is filled with idle periods
+//uHalf - Half of the buffer to be filled (0 or 1)
+void QAS_Stepper::fill(uint8_t uHalf) {
+	uint32_t* pEntry = &m_uBuffer[uHalf * QAS_Stepper_HalfEntries * m_uStride];
+	uint8_t   uCCR   = 2 + m_eChannel;
+
+	bool    bDir     = m_bFillDir;
+	bool    bLocked  = (m_bOpenStep) || (m_uTrailIdle < 2);
+	bool    bBlocked = false;
+	uint8_t uSteps   = 0;
+	uint8_t uTrail   = 0;
+
+	for (uint16_t i=0; i<QAS_Stepper_HalfEntries; i++) {
+		if (m_bOpenStep) {
+			pEntry[uCCR] = m_uPulseTicks;
+			uSteps++;
+			uTrail = 0;
+		} else {
+			pEntry[uCCR] = 0;
+			uTrail++;
+		}
+
+		//Find length of period from the interval before the next step
+		uint32_t uTicks = m_uIdleTicks;
+		m_bOpenStep     = false;
+		if ((!bBlocked) && (m_cPlanner.ready())) {
+			bool bStepDir = m_cPlanner.getDir();
+			if (!bLocked) {
+				bDir    = bStepDir;
+				bLocked = true;
+			}
+
+			if (bStepDir == bDir) {
+				uTicks      = m_cPlanner.next();
+				m_bOpenStep = true;
+			} else {
+				bBlocked = true;
+			}
+		}
+
+		pEntry[0] = uTicks - 1;
+		pEntry   += m_uStride;
+	}
+
+	m_bHalfDir[uHalf]   = bDir;
+	m_uHalfSteps[uHalf] = uSteps;
+	m_iHalfTail[uHalf]  = (uTrail) ? 0 : ((bDir) ? 1 : -1);
+	m_bFillDir          = bDir;
+	m_uTrailIdle        = uTrail;
+}
+
+
+//QAS_Stepper::setDir
+//QAS_Stepper Private Tool Method
+//
+//Used to set the direction output
+//bDir - Direction (true for positive)
+void QAS_Stepper::setDir(bool bDir) {
+	if (bDir != m_bDirInvert)
+		m_pDir->on();
+	else
+		m_pDir->off();
+}
+
+
+//QAS_Stepper::streamSteps
+//QAS_Stepper Private Tool Method
+//
+//Returns the difference between the position up to the end of the most recently transferred half of the buffer (m_iPosition) and the
+//position including every step pulse that has been started
+//As each PWM period's values are transferred one update event before they take effect, the period being output is two periods behind
+//the next one to be transferred. This is normally within the half being transferred (steps from its start are added), but can be in the
+//last two periods of the previous half (steps that have been counted but not yet output are removed). As the previous half has already
+//been refilled by then, the step held in its last period is taken from m_iPrevTail rather than from the buffer. If the DMA interrupt is
+//pending the period can also be in the following half, which is handled in the same way as the half being transferred
+//Must be called with interrupts disabled
+int32_t QAS_Stepper::streamSteps(void) {
+	uint16_t uEntries = QAS_Stepper_HalfEntries * 2;
+	uint16_t uLength  = uEntries * m_uStride;
+	uint16_t uSent    = uLength - m_pPWM->getStreamRemaining();
+	uint16_t uStart   = m_uActiveHalf * QAS_Stepper_HalfEntries;
+
+	//Find period being output relative to the start of the half being transferred. A partly transferred period counts as transferred, as
+	//its update event has already taken place
+	uint16_t uNext    = ((uSent + m_uStride - 1) / m_uStride) % uEntries;
+	int32_t  iCurrent = (int32_t)((uNext + uEntries - uStart) % uEntries) - 2;
+
+	//In the previous half, only a step in its last period can still be to come, which is the case while the period before it is being output.
+	//Nothing has been counted before the first half has been transferred
+	if (iCurrent < 0) {
+		if ((iCurrent == -2) && (!m_bFirstPass))
+			return -m_iPrevTail;
+		return 0;
+	}
+
+	int32_t iSteps = 0;
+	for (int32_t i=0; i<=iCurrent; i++) {
+		uint16_t uEntry = (uint16_t)((uStart + i) % uEntries);
+		if (m_uBuffer[(uEntry * m_uStride) + 2 + m_eChannel])
+			iSteps += (m_bHalfDir[uEntry / QAS_Stepper_HalfEntries]) ? 1 : -1;
+	}
+	return iSteps;
+}
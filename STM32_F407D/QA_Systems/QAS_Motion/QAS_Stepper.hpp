@@ -0,0 +1,258 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Motion                                              */
+/*   Role: Stepper Motor Step/Direction Generator                          */
+/*   Filename: QAS_Stepper.hpp                                             */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_STEPPER_HPP_
+#define __QAS_STEPPER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_GPIO.hpp"
+#include "QAD_PWM.hpp"
+#include "QAT_StepPlanner.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-------------------
+//Stepper Definitions
+//
+//QAS_Stepper_HalfEntries - Number of PWM periods in each half of the stream buffer. Each period holds at most one step
+//QAS_Stepper_MaxStride   - Largest number of values per PWM period in the stream buffer (auto-reload, repetition counter and four compare values)
+//QAS_Stepper_IdleRate    - Rate in Hz of the PWM periods output while no step is due
+const uint16_t QAS_Stepper_HalfEntries = 64;
+const uint8_t  QAS_Stepper_MaxStride   = 6;
+const uint32_t QAS_Stepper_IdleRate    = 10000;
+
+
+//----------------------
+//QAS_Stepper_InitStruct
+//
+//This structure is used to create the QAS_Stepper system class
+typedef struct {
+
+	QAD_Timer_Periph    eTimer;          //Timer peripheral used to generate the step pulses. Must be a 32bit timer (Timer 2 or Timer 5)
+	QAD_PWM_Channel     eChannel;        //Timer channel that the step output is connected to
+	GPIO_TypeDef*       pStepGPIO;       //GPIO port of the step output
+	uint16_t            uStepPin;        //Pin number of the step output
+	uint8_t             uStepAF;         //Alternate function used to connect the step pin to the timer peripheral
+
+	GPIO_TypeDef*       pDirGPIO;        //GPIO port of the direction output
+	uint16_t            uDirPin;         //Pin number of the direction output
+	bool                bDirInvert;      //Set to true for the direction output to be low for positive moves, or false for it to be high
+
+	QAD_DMA_Stream      eDMAStream;      //DMA stream to be used for the timer's update requests. Set to QAD_DMA_StreamNone to have a suitable stream
+	                                     //found by QAD_DMAMgr
+	uint8_t             uIRQPriority;    //IRQ Priority for the DMA stream interrupt used to generate steps (a value between 0 and 15)
+
+	uint32_t            uTickFrequency;  //Timer counter frequency in Hz. Must divide the timer's clock exactly. Higher values give finer step timing
+	uint32_t            uPulseTicks;     //Length of each step pulse in timer ticks
+	uint32_t            uMinTicks;       //Shortest step interval in timer ticks, which sets the highest speed. Limited to at least twice uPulseTicks
+
+	uint32_t            uAccel;          //Peak acceleration in steps/s^2
+	QAT_StepProfile     eProfile;        //Acceleration profile. Member of QAT_StepProfile
+
+} QAS_Stepper_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-----------
+//QAS_Stepper
+//
+//System class used to drive a stepper motor driver through step and direction outputs, with queued moves planned by QAT_StepPlanner
+//
+//Step pulses are generated by a QAD_PWM driver streaming both the period and compare value of each PWM period (see QAD_PWM::startStream()),
+//so that each PWM period is the interval from one step to the next, starting with its step pulse. The stream buffer is circular and split
+//into two halves, each holding QAS_Stepper_HalfEntries periods. When the DMA half transfer or transfer complete interrupt shows that a half
+//has been sent, the step intervals for it are generated by the planner and written back into it while the other half is being output, so
+//step timing is set entirely by the timer and has no interrupt jitter. While no step is due the buffer holds idle periods with no pulse.
+//
+//The direction output is set once per half of the buffer, as the previous half finishes. A half can therefore only hold steps in one
+//direction, and a change of direction is only made once the previous half has ended with two periods without a pulse, so that the
+//direction output never changes while a pulse for the previous direction is being output or is due. As moves only reverse direction from
+//rest (see QAT_StepPlanner), this causes a short pause of up to one half of the buffer between them.
+//
+//Moves can be added with move() while the system is running, and will start within two halves of the buffer if no move is being run.
+//The interrupt must be able to generate a half of the buffer in less time than the steps held in the other half take to output, which
+//sets the lowest value of uMinTicks that can be used (S-curve moves take longer to generate than trapezoid moves).
+//
+//A 32bit timer is required so that the interval between two steps is never too long for the auto-reload register. More than one
+//QAS_Stepper can be used, each with its own timer and DMA stream
+class QAS_Stepper : public QAD_IRQHandler_CallbackClass {
+private:
+
+	QA_InitState                     m_eInitState;   //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QA_ActiveState                   m_eState;       //Stores whether step generation is currently running. Member of QA_ActiveState enum defined in setup.hpp
+
+	QAD_Timer_Periph                 m_eTimer;       //Timer peripheral used to generate the step pulses
+	QAD_PWM_Channel                  m_eChannel;     //Timer channel of the step output
+	GPIO_TypeDef*                    m_pStepGPIO;    //GPIO port of the step output
+	uint16_t                         m_uStepPin;     //Pin number of the step output
+	uint8_t                          m_uStepAF;      //Alternate function of the step output
+	GPIO_TypeDef*                    m_pDirGPIO;     //GPIO port of the direction output
+	uint16_t                         m_uDirPin;      //Pin number of the direction output
+	bool                             m_bDirInvert;   //Whether the direction output is inverted
+	QAD_DMA_Stream                   m_eDMAStream;   //DMA stream used for the timer's update requests
+	uint8_t                          m_uIRQPriority; //IRQ Priority for the DMA stream interrupt
+
+	uint32_t                         m_uTickFrequency; //Timer counter frequency in Hz
+	uint32_t                         m_uPulseTicks;  //Length of each step pulse in timer ticks
+	uint32_t                         m_uIdleTicks;   //Length of each idle period in timer ticks
+
+	std::unique_ptr<QAD_PWM>         m_pPWM;         //PWM driver generating the step pulses
+	std::unique_ptr<QAD_GPIO_Output> m_pDir;         //GPIO driver for the direction output
+	QAT_StepPlanner                  m_cPlanner;     //Motion planner giving the interval before each step
+
+	uint8_t                          m_uStride;      //Number of values per PWM period in the stream buffer
+	uint32_t                         m_uBuffer[QAS_Stepper_HalfEntries * 2 * QAS_Stepper_MaxStride];  //Stream buffer
+
+	//Buffer state
+	bool                             m_bHalfDir[2];   //Direction of the steps in each half of the buffer
+	uint8_t                          m_uHalfSteps[2]; //Number of steps in each half of the buffer
+	volatile uint8_t                 m_uActiveHalf;   //Half of the buffer currently being transferred
+	bool                             m_bFirstPass;    //Set until the first half of the buffer has been transferred after start()
+	bool                             m_bOpenStep;     //Set if the first period of the next half to be filled holds a step
+	bool                             m_bFillDir;      //Direction of the most recently filled half
+	uint8_t                          m_uTrailIdle;    //Number of periods without a pulse at the end of the most recently filled half
+	int8_t                           m_iHalfTail[2];  //Step held in the last period of each half of the buffer (1 or -1 for a step in the positive or negative
+	                                                  //direction, or 0 for none)
+	int8_t                           m_iPrevTail;     //Step held in the last period of the most recently transferred half, saved before that half is refilled
+
+	volatile int64_t                 m_iPosition;     //Position in steps, up to the end of the most recently transferred half of the buffer
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAS_Stepper() = delete;                          //Delete the default class constructor, as we need an initialization structure to be provided on class creation
+
+	QAS_Stepper(QAS_Stepper_InitStruct& sInit) :     //The class constructor to be used, which has a reference to an initialization structure passed to it
+		m_eInitState(QA_NotInitialized),
+		m_eState(QA_Inactive),
+		m_eTimer(sInit.eTimer),
+		m_eChannel(sInit.eChannel),
+		m_pStepGPIO(sInit.pStepGPIO),
+		m_uStepPin(sInit.uStepPin),
+		m_uStepAF(sInit.uStepAF),
+		m_pDirGPIO(sInit.pDirGPIO),
+		m_uDirPin(sInit.uDirPin),
+		m_bDirInvert(sInit.bDirInvert),
+		m_eDMAStream(sInit.eDMAStream),
+		m_uIRQPriority(sInit.uIRQPriority),
+		m_uTickFrequency(sInit.uTickFrequency),
+		m_uPulseTicks(sInit.uPulseTicks ? sInit.uPulseTicks : 1),
+		m_uIdleTicks(0),
+		m_cPlanner(sInit.uTickFrequency, (sInit.uMinTicks > (m_uPulseTicks * 2)) ? sInit.uMinTicks : (m_uPulseTicks * 2)),
+		m_uStride(0),
+		m_uBuffer{},
+		m_bHalfDir{true, true},
+		m_uHalfSteps{0, 0},
+		m_uActiveHalf(0),
+		m_bFirstPass(false),
+		m_bOpenStep(false),
+		m_bFillDir(true),
+		m_uTrailIdle(0),
+		m_iHalfTail{0, 0},
+		m_iPrevTail(0),
+		m_iPosition(0) {
+
+		m_cPlanner.setAccel(sInit.uAccel, sInit.eProfile);
+	}
+
+	~QAS_Stepper() {     //Destructor to make sure step generation is stopped and the system deinitialized upon class destruction
+
+		//Deinitialize system if currently initialized (which also stops step generation)
+		if (m_eInitState)
+			deinit();
+	}
+
+
+	//NOTE: See QAS_Stepper.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result init(void);
+	void deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void start(void);
+	void stop(void);
+
+	QA_ActiveState getState(void) {
+		return m_eState;
+	}
+
+	QA_Result move(int32_t iSteps, uint32_t uSpeed);
+	void setAccel(uint32_t uAccel, QAT_StepProfile eProfile);
+	QA_Result setPosition(int64_t iPosition);
+
+	bool isBusy(void);
+
+	//Returns the number of moves that can currently be added with move()
+	uint8_t getFree(void) {
+		return m_cPlanner.getFree();
+	}
+
+	//Returns the highest speed that can be requested with move() in steps/s
+	uint32_t getMaxSpeed(void) {
+		return m_cPlanner.getMaxSpeed();
+	}
+
+
+	//------------
+	//Data Methods
+
+	int64_t getPosition(void);
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_Stepper.cpp for details of the following methods
+
+	//-------------
+	//Tool Methods
+
+	void fill(uint8_t uHalf);
+	void setDir(bool bDir);
+	int32_t streamSteps(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_STEPPER_HPP_ */
@@ -0,0 +1,171 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Monotonic System Clock                                          */
+/*   Filename: QAS_Clock.cpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_Clock.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //----------------------
+  //----------------------
+	//QAS_Clock Constructors
+
+//QAS_Clock::QAS_Clock
+//QAS_Clock Constructor
+//
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+//The tick conversion values are set to 1 so that the now methods return safe (zero) values until the clock is initialized
+QAS_Clock::QAS_Clock() :
+	m_eInitState(QA_NotInitialized),
+	m_eTimer(QAD_TimerNone),
+	m_pInstance(NULL),
+	m_uHigh(0),
+	m_uFrequency(0),
+	m_uTicksPerUS(1),
+	m_uCyclesPerTick(1),
+	m_pCompareHandler(NULL) {}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAS_Clock Initialization Methods
+
+//QAS_Clock::imp_init
+//QAS_Clock Initialization Method
+//
+//To be called from static method init()
+//Creates the Timer driver used as the free-running counter, and starts the clock from zero
+//sInit - Initialization structure. See QAS_Clock_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Error_PeriphBusy if no 32bit Timer peripheral is available
+//        QA_Error_PeriphNotSupported if the selected Timer peripheral does not have a 32bit counter, or if its clock is not a whole
+//                                    number of MHz, or is not a whole divisor of the CPU clock
+QA_Result QAS_Clock::imp_init(QAS_Clock_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Find a Timer peripheral if one has not been selected
+	QAD_Timer_Periph eTimer = sInit.eTimer;
+	if (eTimer == QAD_TimerNone) {
+		eTimer = QAD_TimerMgr::findTimer(QAD_Timer_32bit);
+		if (eTimer == QAD_TimerNone)
+			return QA_Error_PeriphBusy;
+	}
+
+	//Check that the timer is suitable
+	if (QAD_TimerMgr::getType(eTimer) != QAD_Timer_32bit)
+		return QA_Error_PeriphNotSupported;
+
+	uint32_t uFrequency = QAD_TimerMgr::getClockSpeed(eTimer);
+	if ((uFrequency % 1000000) || (SystemCoreClock % uFrequency))
+		return QA_Error_PeriphNotSupported;
+
+	//Create Timer driver with no prescaler and the full 32bit period
+	QAD_Timer_InitStruct sTimerInit;
+	sTimerInit.eTimer         = eTimer;
+	sTimerInit.eMode          = QAD_TimerContinuous;
+	sTimerInit.uPrescaler     = 0;
+	sTimerInit.uPeriod        = 0xFFFFFFFF;
+	sTimerInit.uIRQPriority   = sInit.uIRQPriority;
+	sTimerInit.uCounterTarget = 0;
+
+	m_pTimer = std::make_unique<QAD_Timer>(sTimerInit);
+	QA_Result eRes = m_pTimer->init();
+	if (eRes) {
+		m_pTimer.reset();
+		return eRes;
+	}
+
+	m_eTimer         = eTimer;
+	m_pInstance      = QAD_TimerMgr::getInstance(eTimer);
+	m_uFrequency     = uFrequency;
+	m_uTicksPerUS    = uFrequency / 1000000;
+	m_uCyclesPerTick = SystemCoreClock / uFrequency;
+	m_uHigh          = 0;
+
+	//Reset counter, and clear the update flag set by the update event generated during timer initialization
+	m_pInstance->CNT = 0;
+	m_pInstance->SR  = ~TIM_SR_UIF;
+
+	m_eInitState = QA_Initialized;
+
+	//Start clock
+	m_pTimer->setHandlerClass(this);
+	m_pTimer->start();
+
+	return QA_OK;
+}
+
+
+//QAS_Clock::imp_deinit
+//QAS_Clock Initialization Method
+//
+//To be called from static method deinit()
+//Stops and removes the Timer driver
+//Once deinitialized the now methods will return zero, so the clock should only be deinitialized once nothing depends on it
+void QAS_Clock::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	m_pTimer->stop();
+	m_eInitState = QA_NotInitialized;
+	m_pTimer.reset();
+
+	m_pCompareHandler = NULL;
+	m_eTimer         = QAD_TimerNone;
+	m_pInstance      = NULL;
+	m_uHigh          = 0;
+	m_uFrequency     = 0;
+	m_uTicksPerUS    = 1;
+	m_uCyclesPerTick = 1;
+}
+
+
+//QAS_Clock::imp_getTimer
+//QAS_Clock Initialization Method
+//
+//To be called from static method getTimer()
+//Returns the Timer peripheral being used, or QAD_TimerNone if the clock is not initialized
+QAD_Timer_Periph QAS_Clock::imp_getTimer(void) {
+	return m_eTimer;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAS_Clock IRQ Handler Methods
+
+//QAS_Clock::handler
+//QAS_Clock IRQ Handler Method
+//
+//Called by the Timer driver when the counter wraps
+//The high word is incremented and the update flag cleared together with interrupts disabled, so that a higher priority interrupt
+//calling nowTicks() can never see the incremented high word with the flag still set, or the cleared flag with the old high word
+//pData - Unused
+void QAS_Clock::handler(void* pData) {
+	uint32_t uPrimask = __get_PRIMASK();
+	__disable_irq();
+
+	m_uHigh++;
+	m_pInstance->SR = ~TIM_SR_UIF;
+
+	__set_PRIMASK(uPrimask);
+}
@@ -0,0 +1,252 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Monotonic System Clock                                          */
+/*   Filename: QAS_Clock.hpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_CLOCK_HPP_
+#define __QAS_CLOCK_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_Timer.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//--------------------
+//QAS_Clock_InitStruct
+//
+//This structure is used to initialize the QAS_Clock system
+typedef struct {
+
+	QAD_Timer_Periph eTimer;        //Timer peripheral to be used. Must have a 32bit counter (Timer 2 or Timer 5)
+	                                //Set to QAD_TimerNone to have a 32bit timer found by QAD_TimerMgr
+	                                //NOTE: handlers.cpp calls QAS_Clock::irqHandler() from TIM5_IRQHandler. If a different timer is used,
+	                                //      the matching IRQ handler function will need to call QAS_Clock::irqHandler() instead
+
+	uint8_t          uIRQPriority;  //IRQ Priority for the timer interrupt (a value between 0 and 15)
+
+} QAS_Clock_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------
+//QAS_Clock
+//
+//Singleton class
+//Monotonic 64bit system clock, replacing HAL_GetTick() for timing that needs better than millisecond resolution or that must not wrap
+//
+//A 32bit Timer peripheral is run with no prescaler as a free-running counter at the timer input clock (84MHz for Timer 2 and Timer 5,
+//giving a resolution of just under 12ns). The timer's update interrupt extends the counter to 64bits by incrementing a high word each
+//time the counter wraps (every 51 seconds), which gives a range of several thousand years.
+//
+//The now methods do not disable interrupts and do not use locks. They can be called from any context, including interrupt handlers
+//with a higher priority than the clock's own interrupt, and take a constant time to complete
+class QAS_Clock : public QAD_IRQHandler_CallbackClass {
+private:
+
+	std::unique_ptr<QAD_Timer> m_pTimer;     //Timer driver used as the free-running counter
+
+	QA_InitState      m_eInitState;          //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+
+	QAD_Timer_Periph  m_eTimer;              //Timer peripheral being used
+	TIM_TypeDef*      m_pInstance;           //Timer registers, cached for direct counter access
+	volatile uint32_t m_uHigh;               //High 32bits of the 64bit tick count
+
+	uint32_t          m_uFrequency;          //Tick frequency in Hz (the timer's input clock frequency)
+	uint32_t          m_uTicksPerUS;         //Number of ticks per microsecond
+	uint32_t          m_uCyclesPerTick;      //Number of CPU cycles per tick
+
+	QAD_IRQHandler_CallbackClass* m_pCompareHandler;  //A pointer to the callback class to be called when the timer interrupt is triggered,
+	                                                  //allowing the timer's compare channels to be used by another system (see QAS_EventScheduler)
+
+	//------------
+	//Constructors
+	QAS_Clock();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_Clock(const QAS_Clock& other) = delete;
+	QAS_Clock& operator=(const QAS_Clock& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_Clock& get(void) {
+		static QAS_Clock instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize and start the system clock
+	//sInit - Initialization structure. See QAS_Clock_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_Clock_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to stop and deinitialize the system clock
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+	//Returns the Timer peripheral being used by the system clock, or QAD_TimerNone if not initialized
+	static QAD_Timer_Periph getTimer(void) {
+		return get().imp_getTimer();
+	}
+
+
+	//------------
+	//Time Methods
+
+	//Returns the number of clock ticks since the clock was started
+	//The retry loop only repeats if the clock interrupt occurs part way through the read, so it runs at most twice
+	static uint64_t nowTicks(void) {
+		QAS_Clock& sInstance = get();
+		uint32_t uHigh;
+		uint32_t uLow;
+		uint32_t uSR;
+
+		if (!sInstance.m_pInstance)
+			return 0;
+
+		do {
+			uHigh = sInstance.m_uHigh;
+			uLow  = sInstance.m_pInstance->CNT;
+			uSR   = sInstance.m_pInstance->SR;
+		} while (uHigh != sInstance.m_uHigh);
+
+		//If the counter has wrapped but the interrupt has not yet been serviced (for instance if called from a higher priority interrupt
+		//handler), then a low counter value was read after the wrap and the high word needs to be corrected
+		if ((uSR & TIM_SR_UIF) && (!(uLow & 0x80000000)))
+			uHigh++;
+
+		return ((uint64_t)uHigh << 32) | uLow;
+	}
+
+	//Returns the number of CPU cycles since the clock was started, with a resolution of one clock tick
+	static uint64_t nowCycles(void) {
+		return nowTicks() * get().m_uCyclesPerTick;
+	}
+
+	//Returns the number of microseconds since the clock was started
+	static uint64_t nowUS(void) {
+		return divide(nowTicks(), get().m_uTicksPerUS);
+	}
+
+	//Returns the number of milliseconds since the clock was started
+	static uint64_t nowMS(void) {
+		return divide(nowUS(), 1000);
+	}
+
+
+	//------------
+	//Tool Methods
+
+	//Returns the tick frequency in Hz
+	static uint32_t getFrequency(void) {
+		return get().m_uFrequency;
+	}
+
+	//Used to convert a number of clock ticks into microseconds
+	//uTicks - The number of ticks to be converted
+	static uint64_t ticksToUS(uint64_t uTicks) {
+		return divide(uTicks, get().m_uTicksPerUS);
+	}
+
+	//Used to convert a number of microseconds into clock ticks
+	//uUS - The number of microseconds to be converted
+	static uint64_t usToTicks(uint64_t uUS) {
+		return uUS * get().m_uTicksPerUS;
+	}
+
+	//Used to divide a 64bit value by a divisor of less than 65536, giving an exact result in a fixed number of steps
+	//This avoids the library 64bit division routine, whose execution time varies with the values being divided
+	//The division is performed as a long division using 16bit digits, so that each step is a single 32bit hardware division
+	//uValue   - The value to be divided
+	//uDivisor - The divisor (1 to 65535)
+	static uint64_t divide(uint64_t uValue, uint32_t uDivisor) {
+		uint64_t uQuotient  = 0;
+		uint32_t uRemainder = 0;
+
+		for (int8_t i=3; i>=0; i--) {
+			uint32_t uDigit = (uRemainder << 16) | (uint32_t)((uValue >> (i * 16)) & 0xFFFF);
+			uint32_t uQ     = uDigit / uDivisor;
+			uRemainder      = uDigit - (uQ * uDivisor);
+			uQuotient      |= (uint64_t)uQ << (i * 16);
+		}
+		return uQuotient;
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to pass the clock Timer peripheral's interrupt to the compare handler (if one has been set) and then to the Timer driver
+	//This method is only to be called by the interrupt request handler function from handlers.cpp
+	static void irqHandler(void) {
+		QAS_Clock& sInstance = get();
+		if (sInstance.m_eInitState) {
+			if (sInstance.m_pCompareHandler)
+				sInstance.m_pCompareHandler->handler(NULL);
+			sInstance.m_pTimer->handler();
+		}
+	}
+
+	//Used to set the callback class to be called for each clock timer interrupt, so that the timer's capture/compare channels
+	//can be used while the counter continues to run as the system clock. The callback is responsible for checking and clearing
+	//its own capture/compare flags
+	//pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp, or NULL to remove the callback
+	static void setCompareHandler(QAD_IRQHandler_CallbackClass* pHandler) {
+		get().m_pCompareHandler = pHandler;
+	}
+
+	void handler(void* pData);
+
+
+private:
+
+	//NOTE: See QAS_Clock.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_Clock_InitStruct& sInit);
+	void imp_deinit(void);
+	QAD_Timer_Periph imp_getTimer(void);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_CLOCK_HPP_ */
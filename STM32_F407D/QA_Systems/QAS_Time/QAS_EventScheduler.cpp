@@ -0,0 +1,483 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Compare Channel Event Scheduler                                 */
+/*   Filename: QAS_EventScheduler.cpp                                      */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_EventScheduler.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//Output compare modes used for compare channels (OCxM bits of the timer's CCMR registers)
+const uint32_t QAS_EventScheduler_ModeFrozen    = 0;  //Compare matches have no effect on the output
+const uint32_t QAS_EventScheduler_ModeForceLow  = 4;  //Output is forced low
+const uint32_t QAS_EventScheduler_ModeForceHigh = 5;  //Output is forced high
+
+
+  //-------------------------------
+  //-------------------------------
+	//QAS_EventScheduler Constructors
+
+//QAS_EventScheduler::QAS_EventScheduler
+//QAS_EventScheduler Constructor
+//
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAS_EventScheduler::QAS_EventScheduler() :
+	m_eInitState(QA_NotInitialized),
+	m_pInstance(NULL),
+	m_uCount(0),
+	m_uLate(0),
+	m_uLatencyMax(0) {
+
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		m_sPins[i].eActive = QA_Inactive;
+		m_sPins[i].pGPIO   = NULL;
+		m_sPins[i].uPin    = 0;
+		m_sPins[i].uAF     = 0;
+		m_bPinPending[i]   = false;
+	}
+}
+
+
+  //-----------------------------------------
+  //-----------------------------------------
+  //QAS_EventScheduler Initialization Methods
+
+//QAS_EventScheduler::imp_init
+//QAS_EventScheduler Initialization Method
+//
+//To be called from static method init()
+//Claims and initializes the GPIO pins of active compare channels, sets all compare channels to frozen output compare mode,
+//and registers the scheduler with QAS_Clock to receive the clock timer's interrupts
+//sInit - Initialization structure. See QAS_EventScheduler_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Fail if QAS_Clock has not been initialized
+//        QA_Error_PeriphBusy if any of the GPIO pins are already in use
+QA_Result QAS_EventScheduler::imp_init(QAS_EventScheduler_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Check that the clock is running
+	QAD_Timer_Periph eTimer = QAS_Clock::getTimer();
+	if (eTimer == QAD_TimerNone)
+		return QA_Fail;
+	m_pInstance = QAD_TimerMgr::getInstance(eTimer);
+
+	//Claim GPIO pins
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		m_sPins[i] = sInit.sPins[i];
+		if (m_sPins[i].eActive) {
+			if (QAD_ResourceMgr::claimPins(m_sPins[i].pGPIO, m_sPins[i].uPin, "EventScheduler")) {
+
+				//Release any pins already claimed
+				for (uint8_t j=0; j<i; j++) {
+					if (m_sPins[j].eActive)
+						QAD_ResourceMgr::releasePins(m_sPins[j].pGPIO, m_sPins[j].uPin, "EventScheduler");
+				}
+				return QA_Error_PeriphBusy;
+			}
+		}
+	}
+
+	//Init GPIOs
+	GPIO_InitTypeDef GPIO_Init = {0};
+	GPIO_Init.Mode  = GPIO_MODE_AF_PP;
+	GPIO_Init.Pull  = GPIO_NOPULL;
+	GPIO_Init.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		if (m_sPins[i].eActive) {
+			GPIO_Init.Pin       = m_sPins[i].uPin;
+			GPIO_Init.Alternate = m_sPins[i].uAF;
+			HAL_GPIO_Init(m_sPins[i].pGPIO, &GPIO_Init);
+		}
+	}
+
+	//Set all compare channels to frozen output compare mode with preload disabled, so that compare values take effect immediately
+	uint32_t uPrimask = enterCritical();
+	m_pInstance->DIER  &= ~(TIM_DIER_CC1IE | TIM_DIER_CC2IE | TIM_DIER_CC3IE | TIM_DIER_CC4IE);
+	m_pInstance->CCER  &= ~(TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC2E | TIM_CCER_CC2P |
+	                        TIM_CCER_CC3E | TIM_CCER_CC3P | TIM_CCER_CC4E | TIM_CCER_CC4P);
+	m_pInstance->CCMR1  = 0;
+	m_pInstance->CCMR2  = 0;
+	m_pInstance->SR     = ~(TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF);
+
+	//Enable outputs of active pin channels
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		m_bPinPending[i] = false;
+		if (m_sPins[i].eActive)
+			m_pInstance->CCER |= (TIM_CCER_CC2E << (i * 4));
+	}
+
+	m_uCount     = 0;
+	m_eInitState = QA_Initialized;
+	exitCritical(uPrimask);
+
+	clearStats();
+
+	//Register with QAS_Clock to receive timer interrupts
+	QAS_Clock::setCompareHandler(this);
+
+	return QA_OK;
+}
+
+
+//QAS_EventScheduler::imp_deinit
+//QAS_EventScheduler Initialization Method
+//
+//To be called from static method deinit()
+//Cancels all pending events, disables the compare channels, and deinitializes and releases the GPIO pins
+void QAS_EventScheduler::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	QAS_Clock::setCompareHandler(NULL);
+
+	uint32_t uPrimask = enterCritical();
+	m_pInstance->DIER &= ~(TIM_DIER_CC1IE | TIM_DIER_CC2IE | TIM_DIER_CC3IE | TIM_DIER_CC4IE);
+	m_pInstance->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E);
+	m_pInstance->CCMR1 = 0;
+	m_pInstance->CCMR2 = 0;
+	m_pInstance->SR    = ~(TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF);
+
+	//Cancel pending events
+	for (uint8_t i=0; i<m_uCount; i++)
+		m_pHeap[i]->m_uIndex = QAS_EventScheduler_NotPending;
+	m_uCount = 0;
+
+	m_eInitState = QA_NotInitialized;
+	exitCritical(uPrimask);
+
+	//Deinitialize and release GPIO pins
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		m_bPinPending[i] = false;
+		if (m_sPins[i].eActive) {
+			HAL_GPIO_DeInit(m_sPins[i].pGPIO, m_sPins[i].uPin);
+			QAD_ResourceMgr::releasePins(m_sPins[i].pGPIO, m_sPins[i].uPin, "EventScheduler");
+		}
+	}
+}
+
+
+  //--------------------------------------
+  //--------------------------------------
+  //QAS_EventScheduler IRQ Handler Methods
+
+//QAS_EventScheduler::handler
+//QAS_EventScheduler IRQ Handler Method
+//
+//Called by QAS_Clock::irqHandler() for each clock timer interrupt
+//Completes any pin events whose compare channel has matched, then calls the callbacks of all callback events that are due and
+//re-arms compare channel 1 with the next deadline
+//pData - Unused
+void QAS_EventScheduler::handler(void* pData) {
+	uint32_t uFlags = m_pInstance->SR & m_pInstance->DIER;
+
+	//Complete pin events
+	//The channel is returned to frozen mode so that the pin is not changed again when the 32bit counter next reaches the same value
+	for (uint8_t i=0; i<QAS_EventScheduler_PinCount; i++) {
+		uint32_t uFlag = (TIM_SR_CC2IF << i);
+		if (uFlags & uFlag) {
+			uint32_t uPrimask = enterCritical();
+			m_pInstance->SR = ~uFlag;
+			imp_setOutputMode((QAS_EventScheduler_Pin)i, QAS_EventScheduler_ModeFrozen);
+			m_pInstance->DIER &= ~(TIM_DIER_CC2IE << i);
+			m_bPinPending[i] = false;
+			exitCritical(uPrimask);
+		}
+	}
+
+	//Call due callback events
+	if (uFlags & TIM_SR_CC1IF) {
+		m_pInstance->SR = ~TIM_SR_CC1IF;
+
+		while (true) {
+
+			//Remove the earliest event from the heap if it is due
+			uint32_t   uPrimask = enterCritical();
+			uint64_t   uNow     = QAS_Clock::nowTicks();
+			QAS_Event* pEvent   = NULL;
+			if ((m_uCount) && (m_pHeap[0]->m_uDeadline <= uNow)) {
+				pEvent = m_pHeap[0];
+				imp_heapRemove(0);
+
+				uint64_t uLatency = uNow - pEvent->m_uDeadline;
+				if (uLatency > m_uLatencyMax)
+					m_uLatencyMax = (uLatency > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)uLatency;
+			}
+			exitCritical(uPrimask);
+
+			if (!pEvent)
+				break;
+
+			//Call the event's callbacks. Callbacks are free to reschedule the event
+			if (pEvent->m_pHandlerFunction)
+				pEvent->m_pHandlerFunction(pEvent->m_pData);
+			if (pEvent->m_pHandlerClass)
+				pEvent->m_pHandlerClass->handler(pEvent->m_pData);
+		}
+
+		//Re-arm compare channel 1 with the next deadline
+		uint32_t uPrimask = enterCritical();
+		imp_arm();
+		exitCritical(uPrimask);
+	}
+}
+
+
+  //----------------------------------
+  //----------------------------------
+  //QAS_EventScheduler Control Methods
+
+//QAS_EventScheduler::imp_schedule
+//QAS_EventScheduler Control Method
+//
+//To be called from static methods schedule(), scheduleIn() and scheduleTicks()
+//sEvent    - The event to be scheduled
+//uDeadline - Clock tick at which the event is due
+//Returns QA_OK if successful, or QA_Fail if the scheduler is not initialized or too many events are pending
+QA_Result QAS_EventScheduler::imp_schedule(QAS_Event& sEvent, uint64_t uDeadline) {
+	if (!m_eInitState)
+		return QA_Fail;
+
+	uint32_t uPrimask = enterCritical();
+
+	//Remove event from the heap if it is already pending
+	if (sEvent.isPending())
+		imp_heapRemove(sEvent.m_uIndex);
+
+	if (m_uCount >= QAS_EventScheduler_MaxEvents) {
+		exitCritical(uPrimask);
+		return QA_Fail;
+	}
+
+	//Add event to the heap
+	sEvent.m_uDeadline = uDeadline;
+	heapSet(m_uCount, &sEvent);
+	m_uCount++;
+	imp_heapUp(m_uCount - 1);
+
+	imp_arm();
+	exitCritical(uPrimask);
+
+	return QA_OK;
+}
+
+
+//QAS_EventScheduler::imp_cancel
+//QAS_EventScheduler Control Method
+//
+//To be called from static method cancel()
+//sEvent - The event to be cancelled
+void QAS_EventScheduler::imp_cancel(QAS_Event& sEvent) {
+	uint32_t uPrimask = enterCritical();
+	if (sEvent.isPending()) {
+		imp_heapRemove(sEvent.m_uIndex);
+		imp_arm();
+	}
+	exitCritical(uPrimask);
+}
+
+
+//QAS_EventScheduler::imp_schedulePin
+//QAS_EventScheduler Control Method
+//
+//To be called from static method schedulePin()
+//The compare channel is placed in frozen mode while its compare value is changed, so that the pin cannot change at an old compare value,
+//and the deadline is checked with interrupts disabled so that the channel is guaranteed to be armed before the deadline is reached
+//ePin      - The compare channel to be used. Member of QAS_EventScheduler_Pin
+//eAction   - The action to be performed on the pin. Member of QAS_EventScheduler_Action
+//uDeadline - Clock tick at which the pin is to change
+//Returns QA_OK if successful
+//        QA_Fail if the scheduler is not initialized, the channel is not active, or the deadline is out of range
+//        QA_Error_PeriphBusy if the channel already has a pin event pending
+QA_Result QAS_EventScheduler::imp_schedulePin(QAS_EventScheduler_Pin ePin, QAS_EventScheduler_Action eAction, uint64_t uDeadline) {
+	if ((!m_eInitState) || (ePin >= QAS_EventScheduler_PinCount) || (!m_sPins[ePin].eActive))
+		return QA_Fail;
+
+	uint32_t uPrimask = enterCritical();
+
+	if (m_bPinPending[ePin]) {
+		exitCritical(uPrimask);
+		return QA_Error_PeriphBusy;
+	}
+
+	//Check deadline is within range
+	uint64_t uNow = QAS_Clock::nowTicks();
+	if ((uDeadline < (uNow + QAS_EventScheduler_GuardTicks)) || ((uDeadline - uNow) > QAS_EventScheduler_PinRange)) {
+		exitCritical(uPrimask);
+		return QA_Fail;
+	}
+
+	//Arm compare channel
+	imp_setOutputMode(ePin, QAS_EventScheduler_ModeFrozen);
+	(&m_pInstance->CCR2)[ePin] = (uint32_t)uDeadline;
+	m_pInstance->SR = ~(TIM_SR_CC2IF << ePin);
+	imp_setOutputMode(ePin, eAction);
+	m_pInstance->DIER |= (TIM_DIER_CC2IE << ePin);
+	m_bPinPending[ePin] = true;
+
+	exitCritical(uPrimask);
+	return QA_OK;
+}
+
+
+//QAS_EventScheduler::imp_cancelPin
+//QAS_EventScheduler Control Method
+//
+//To be called from static method cancelPin()
+//ePin - The compare channel to be cancelled. Member of QAS_EventScheduler_Pin
+void QAS_EventScheduler::imp_cancelPin(QAS_EventScheduler_Pin ePin) {
+	if ((!m_eInitState) || (ePin >= QAS_EventScheduler_PinCount))
+		return;
+
+	uint32_t uPrimask = enterCritical();
+	imp_setOutputMode(ePin, QAS_EventScheduler_ModeFrozen);
+	m_pInstance->DIER &= ~(TIM_DIER_CC2IE << ePin);
+	m_pInstance->SR    = ~(TIM_SR_CC2IF << ePin);
+	m_bPinPending[ePin] = false;
+	exitCritical(uPrimask);
+}
+
+
+//QAS_EventScheduler::imp_setPin
+//QAS_EventScheduler Control Method
+//
+//To be called from static method setPin()
+//The channel is forced to the required level, and then returned to frozen mode which holds the level
+//ePin   - The compare channel to be set. Member of QAS_EventScheduler_Pin
+//bState - true to set the pin high, false to set the pin low
+void QAS_EventScheduler::imp_setPin(QAS_EventScheduler_Pin ePin, bool bState) {
+	if ((!m_eInitState) || (ePin >= QAS_EventScheduler_PinCount))
+		return;
+
+	imp_cancelPin(ePin);
+
+	uint32_t uPrimask = enterCritical();
+	imp_setOutputMode(ePin, bState ? QAS_EventScheduler_ModeForceHigh : QAS_EventScheduler_ModeForceLow);
+	imp_setOutputMode(ePin, QAS_EventScheduler_ModeFrozen);
+	exitCritical(uPrimask);
+}
+
+
+  //-------------------------------
+  //-------------------------------
+  //QAS_EventScheduler Tool Methods
+
+//QAS_EventScheduler::imp_arm
+//QAS_EventScheduler Tool Method
+//
+//Used to arm compare channel 1 with the deadline of the earliest pending event, or to disable its interrupt if no events are pending
+//If the deadline has already passed, the compare event is generated in software so that the event is still handled by the interrupt
+//Deadlines more than one 32bit counter period away cause early compare matches, which are ignored by handler() and re-armed
+//Must be called with interrupts disabled
+void QAS_EventScheduler::imp_arm(void) {
+	if (!m_uCount) {
+		m_pInstance->DIER &= ~TIM_DIER_CC1IE;
+		return;
+	}
+
+	uint64_t uDeadline = m_pHeap[0]->m_uDeadline;
+	m_pInstance->CCR1  = (uint32_t)uDeadline;
+	m_pInstance->SR    = ~TIM_SR_CC1IF;
+	m_pInstance->DIER |= TIM_DIER_CC1IE;
+
+	//If the counter has already passed the deadline then the compare match will have been missed
+	if (QAS_Clock::nowTicks() >= uDeadline) {
+		m_uLate++;
+		m_pInstance->EGR = TIM_EGR_CC1G;
+	}
+}
+
+
+//QAS_EventScheduler::imp_heapRemove
+//QAS_EventScheduler Tool Method
+//
+//Used to remove an event from the heap, replacing it with the last event in the heap
+//Must be called with interrupts disabled
+//uIndex - Position of the event to be removed
+void QAS_EventScheduler::imp_heapRemove(uint8_t uIndex) {
+	m_pHeap[uIndex]->m_uIndex = QAS_EventScheduler_NotPending;
+	m_uCount--;
+
+	if (uIndex < m_uCount) {
+		heapSet(uIndex, m_pHeap[m_uCount]);
+		if ((uIndex > 0) && (m_pHeap[uIndex]->m_uDeadline < m_pHeap[(uIndex - 1) / 2]->m_uDeadline))
+			imp_heapUp(uIndex);
+		else
+			imp_heapDown(uIndex);
+	}
+}
+
+
+//QAS_EventScheduler::imp_heapUp
+//QAS_EventScheduler Tool Method
+//
+//Used to move an event towards the top of the heap until its parent is due no later than it
+//uIndex - Position of the event to be moved
+void QAS_EventScheduler::imp_heapUp(uint8_t uIndex) {
+	QAS_Event* pEvent = m_pHeap[uIndex];
+
+	while (uIndex > 0) {
+		uint8_t uParent = (uIndex - 1) / 2;
+		if (m_pHeap[uParent]->m_uDeadline <= pEvent->m_uDeadline)
+			break;
+		heapSet(uIndex, m_pHeap[uParent]);
+		uIndex = uParent;
+	}
+	heapSet(uIndex, pEvent);
+}
+
+
+//QAS_EventScheduler::imp_heapDown
+//QAS_EventScheduler Tool Method
+//
+//Used to move an event towards the bottom of the heap until both of its children are due no earlier than it
+//uIndex - Position of the event to be moved
+void QAS_EventScheduler::imp_heapDown(uint8_t uIndex) {
+	QAS_Event* pEvent = m_pHeap[uIndex];
+
+	while (true) {
+		uint8_t uChild = (uIndex * 2) + 1;
+		if (uChild >= m_uCount)
+			break;
+		if (((uChild + 1) < m_uCount) && (m_pHeap[uChild + 1]->m_uDeadline < m_pHeap[uChild]->m_uDeadline))
+			uChild++;
+		if (pEvent->m_uDeadline <= m_pHeap[uChild]->m_uDeadline)
+			break;
+		heapSet(uIndex, m_pHeap[uChild]);
+		uIndex = uChild;
+	}
+	heapSet(uIndex, pEvent);
+}
+
+
+//QAS_EventScheduler::imp_setOutputMode
+//QAS_EventScheduler Tool Method
+//
+//Used to set the output compare mode of one of the pin compare channels
+//ePin  - The compare channel. Member of QAS_EventScheduler_Pin
+//uMode - Output compare mode (OCxM bits value)
+void QAS_EventScheduler::imp_setOutputMode(QAS_EventScheduler_Pin ePin, uint32_t uMode) {
+
+	//Channel 2 uses the upper half of CCMR1, channels 3 and 4 use the lower and upper halves of CCMR2
+	volatile uint32_t* pCCMR = (ePin == QAS_EventScheduler_Pin2) ? &m_pInstance->CCMR1 : &m_pInstance->CCMR2;
+	uint32_t uShift = (ePin == QAS_EventScheduler_Pin3) ? TIM_CCMR2_OC3M_Pos : TIM_CCMR1_OC2M_Pos;
+
+	*pCCMR = (*pCCMR & ~(0x7UL << uShift)) | (uMode << uShift);
+}
@@ -0,0 +1,399 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Compare Channel Event Scheduler                                 */
+/*   Filename: QAS_EventScheduler.hpp                                      */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_EVENTSCHEDULER_HPP_
+#define __QAS_EVENTSCHEDULER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAS_Clock.hpp"
+#include "QAD_ResourceMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//---------------------------
+//Event Scheduler Definitions
+//
+//QAS_EventScheduler_MaxEvents  - Maximum number of callback events that can be pending at once
+//QAS_EventScheduler_PinCount   - Number of compare channels available for pin events (channels 2 to 4 of the clock timer)
+//QAS_EventScheduler_GuardTicks - Minimum time in clock ticks between scheduling a pin event and its deadline (2us at 84MHz), so that the compare
+//                                channel is guaranteed to be fully armed before the counter reaches the deadline
+//QAS_EventScheduler_PinRange   - Maximum time in clock ticks between scheduling a pin event and its deadline (half of the 32bit counter range),
+//                                as pin events are performed by the compare hardware on the lower 32bits of the clock only
+const uint8_t  QAS_EventScheduler_MaxEvents  = 32;
+const uint8_t  QAS_EventScheduler_PinCount   = 3;
+const uint32_t QAS_EventScheduler_GuardTicks = 168;
+const uint32_t QAS_EventScheduler_PinRange   = 0x7FFFFFFF;
+const uint8_t  QAS_EventScheduler_NotPending = 0xFF;
+
+
+//----------------------
+//QAS_EventScheduler_Pin
+//
+//Used to select the compare channel (and therefore the pin) to be used for a pin event
+enum QAS_EventScheduler_Pin : uint8_t {
+	QAS_EventScheduler_Pin2 = 0,    //Clock timer channel 2 (PA1 with AF2 when Timer 5 is used)
+	QAS_EventScheduler_Pin3,        //Clock timer channel 3 (PA2 with AF2 when Timer 5 is used)
+	QAS_EventScheduler_Pin4         //Clock timer channel 4 (PA3 with AF2 when Timer 5 is used)
+};
+
+
+//--------------------------
+//QAS_EventScheduler_Action
+//
+//Used to select the action to be performed on a pin when a pin event's deadline is reached
+//Values match the output compare mode bits of the timer's CCMR registers
+enum QAS_EventScheduler_Action : uint8_t {
+	QAS_EventScheduler_SetHigh = 1, //Pin is set high
+	QAS_EventScheduler_SetLow  = 2, //Pin is set low
+	QAS_EventScheduler_Toggle  = 3  //Pin is toggled
+};
+
+
+//--------------------------------
+//QAS_EventScheduler_PinInitStruct
+//
+//This structure is used to store the GPIO pin to be used by an individual compare channel
+typedef struct {
+
+	QA_ActiveState eActive;  //Set to QA_Active for the compare channel to be available for pin events
+	GPIO_TypeDef*  pGPIO;    //GPIO port to be used by this compare channel
+	uint16_t       uPin;     //Pin number to be used by this compare channel
+	uint8_t        uAF;      //Alternate function used to connect the GPIO pin to the clock timer
+
+} QAS_EventScheduler_PinInitStruct;
+
+
+//-----------------------------
+//QAS_EventScheduler_InitStruct
+//
+//This structure is used to initialize the QAS_EventScheduler system
+typedef struct {
+
+	QAS_EventScheduler_PinInitStruct sPins[QAS_EventScheduler_PinCount];  //Pins for compare channels 2 to 4. Channel 1 is always used for callback events
+
+} QAS_EventScheduler_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------
+//QAS_Event
+//
+//A single callback event, to be scheduled using QAS_EventScheduler
+//Events are owned by the user code that schedules them, so no memory is allocated by the scheduler. An event must not be destroyed while pending
+class QAS_Event {
+	friend class QAS_EventScheduler;
+private:
+
+	uint64_t m_uDeadline;   //Clock tick at which the event is due
+	uint8_t  m_uIndex;      //Position of the event within the scheduler's heap, or QAS_EventScheduler_NotPending
+
+	QAD_IRQHandler_CallbackFunction m_pHandlerFunction;  //A pointer to the callback function to be called when the event is due
+	QAD_IRQHandler_CallbackClass*   m_pHandlerClass;     //A pointer to the callback class to be called when the event is due
+	void*                           m_pData;             //Data pointer passed to the callback when the event is due
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAS_Event() :
+		m_uDeadline(0),
+		m_uIndex(QAS_EventScheduler_NotPending),
+		m_pHandlerFunction(NULL),
+		m_pHandlerClass(NULL),
+		m_pData(NULL) {}
+
+	QAS_Event(const QAS_Event& other) = delete;
+	QAS_Event& operator=(const QAS_Event& other) = delete;
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the callback function to be called when the event is due
+	//pHandler - Pointer to callback function based on QAD_IRQHandler_CallbackFunction prototype defined in setup.hpp
+	//pData    - Data pointer to be passed to the callback function
+	void setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler, void* pData) {
+		m_pHandlerFunction = pHandler;
+		m_pData            = pData;
+	}
+
+	//Used to set the callback class to be called when the event is due
+	//pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp
+	//pData    - Data pointer to be passed to the callback class's handler() method
+	void setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler, void* pData) {
+		m_pHandlerClass = pHandler;
+		m_pData         = pData;
+	}
+
+	//Returns true if the event is currently scheduled and its callback has not yet been called
+	bool isPending(void) const {
+		return (m_uIndex != QAS_EventScheduler_NotPending);
+	}
+
+	//Returns the clock tick at which the event is (or was most recently) due
+	uint64_t getDeadline(void) const {
+		return m_uDeadline;
+	}
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------------
+//QAS_EventScheduler
+//
+//Singleton class
+//Schedules callbacks and pin changes at absolute deadlines, using the compare channels of the timer used by QAS_Clock
+//
+//Unlike QAD_TimerSingle mode, where the timing of a single-shot event is limited to a whole timer period plus the latency of the
+//update interrupt, events are timed directly against the free-running clock counter to a resolution of one clock tick.
+//
+//Callback events - Pending events are held in a min-heap ordered by deadline. Compare channel 1 is armed with the earliest deadline,
+//                  and is re-armed from within the interrupt each time events are called. If an event's deadline has already passed
+//                  when it becomes the earliest event, the compare interrupt is triggered in software so that its callback is still
+//                  called from the interrupt, as soon as possible
+//
+//Pin events      - Compare channels 2 to 4 drive their GPIO pins directly in hardware, so the pin changes on the exact clock tick of the
+//                  deadline, with no interrupt latency or jitter. Each channel can have one pin event pending at a time
+//
+//QAS_Clock must be initialized before this system is initialized
+class QAS_EventScheduler : public QAD_IRQHandler_CallbackClass {
+private:
+
+	QA_InitState  m_eInitState;   //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+
+	TIM_TypeDef*  m_pInstance;    //Clock timer registers
+
+	QAS_Event*    m_pHeap[QAS_EventScheduler_MaxEvents];  //Min-heap of pending callback events, ordered by deadline
+	uint8_t       m_uCount;                               //Number of pending callback events
+
+	QAS_EventScheduler_PinInitStruct m_sPins[QAS_EventScheduler_PinCount];  //Pins used by compare channels 2 to 4
+	volatile bool m_bPinPending[QAS_EventScheduler_PinCount];               //Stores whether each compare channel has a pin event pending
+
+	//Statistics
+	uint32_t      m_uLate;        //Number of callback events whose deadline had already passed when the compare channel was armed
+	uint32_t      m_uLatencyMax;  //Maximum number of clock ticks between an event's deadline and its callback being called
+
+	//------------
+	//Constructors
+	QAS_EventScheduler();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_EventScheduler(const QAS_EventScheduler& other) = delete;
+	QAS_EventScheduler& operator=(const QAS_EventScheduler& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_EventScheduler& get(void) {
+		static QAS_EventScheduler instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize the event scheduler, including the GPIO pins of any active compare channels
+	//sInit - Initialization structure. See QAS_EventScheduler_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_EventScheduler_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to deinitialize the event scheduler
+	//Pending callback events are cancelled without their callbacks being called, and pending pin events are cancelled
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to schedule a callback event at an absolute time. If the event is already pending it is rescheduled
+	//sEvent      - The event to be scheduled
+	//uDeadlineUS - Time at which the event is due, in microseconds as returned by QAS_Clock::nowUS()
+	//Returns QA_OK if successful, or QA_Fail if the scheduler is not initialized or too many events are pending
+	static QA_Result schedule(QAS_Event& sEvent, uint64_t uDeadlineUS) {
+		return get().imp_schedule(sEvent, QAS_Clock::usToTicks(uDeadlineUS));
+	}
+
+	//Used to schedule a callback event at a time relative to now. If the event is already pending it is rescheduled
+	//sEvent - The event to be scheduled
+	//uDelayUS - Delay until the event is due, in microseconds
+	//Returns QA_OK if successful, or QA_Fail if the scheduler is not initialized or too many events are pending
+	static QA_Result scheduleIn(QAS_Event& sEvent, uint64_t uDelayUS) {
+		return get().imp_schedule(sEvent, QAS_Clock::nowTicks() + QAS_Clock::usToTicks(uDelayUS));
+	}
+
+	//Used to schedule a callback event at an absolute clock tick, for timing finer than one microsecond
+	//sEvent         - The event to be scheduled
+	//uDeadlineTicks - Clock tick at which the event is due, as returned by QAS_Clock::nowTicks()
+	//Returns QA_OK if successful, or QA_Fail if the scheduler is not initialized or too many events are pending
+	static QA_Result scheduleTicks(QAS_Event& sEvent, uint64_t uDeadlineTicks) {
+		return get().imp_schedule(sEvent, uDeadlineTicks);
+	}
+
+	//Used to cancel a pending callback event. Cancelling an event that is not pending has no effect
+	//sEvent - The event to be cancelled
+	static void cancel(QAS_Event& sEvent) {
+		get().imp_cancel(sEvent);
+	}
+
+	//Used to schedule a pin event, which is performed in hardware by the compare channel at the exact clock tick of the deadline
+	//ePin           - The compare channel to be used. Member of QAS_EventScheduler_Pin
+	//eAction        - The action to be performed on the pin. Member of QAS_EventScheduler_Action
+	//uDeadlineTicks - Clock tick at which the pin is to change, as returned by QAS_Clock::nowTicks()
+	//                 Must be at least QAS_EventScheduler_GuardTicks and no more than QAS_EventScheduler_PinRange ticks in the future
+	//Returns QA_OK if successful
+	//        QA_Fail if the scheduler is not initialized, the channel is not active, or the deadline is out of range
+	//        QA_Error_PeriphBusy if the channel already has a pin event pending
+	static QA_Result schedulePin(QAS_EventScheduler_Pin ePin, QAS_EventScheduler_Action eAction, uint64_t uDeadlineTicks) {
+		return get().imp_schedulePin(ePin, eAction, uDeadlineTicks);
+	}
+
+	//Used to cancel a pending pin event. The pin is left at its current level
+	//ePin - The compare channel to be cancelled. Member of QAS_EventScheduler_Pin
+	static void cancelPin(QAS_EventScheduler_Pin ePin) {
+		get().imp_cancelPin(ePin);
+	}
+
+	//Used to immediately set the level of a pin, such as to set its initial level before scheduling pin events
+	//Any pin event pending on the channel is cancelled
+	//ePin   - The compare channel to be set. Member of QAS_EventScheduler_Pin
+	//bState - true to set the pin high, false to set the pin low
+	static void setPin(QAS_EventScheduler_Pin ePin, bool bState) {
+		get().imp_setPin(ePin, bState);
+	}
+
+	//Returns true if the selected compare channel has a pin event pending
+	//ePin - The compare channel to be checked. Member of QAS_EventScheduler_Pin
+	static bool isPinPending(QAS_EventScheduler_Pin ePin) {
+		return get().m_bPinPending[ePin];
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	void handler(void* pData);
+
+
+	//--------------
+	//Status Methods
+
+	//Returns the number of callback events currently pending
+	static uint8_t getPending(void) {
+		return get().m_uCount;
+	}
+
+	//Returns the number of callback events whose deadline had already passed by the time they became the earliest pending event
+	static uint32_t getLate(void) {
+		return get().m_uLate;
+	}
+
+	//Returns the maximum number of clock ticks between an event's deadline and its callback being called,
+	//since initialization or the last call to clearStats()
+	static uint32_t getLatencyMax(void) {
+		return get().m_uLatencyMax;
+	}
+
+	//Used to clear the late event count and latency statistics
+	static void clearStats(void) {
+		QAS_EventScheduler& sInstance = get();
+		sInstance.m_uLate       = 0;
+		sInstance.m_uLatencyMax = 0;
+	}
+
+
+private:
+
+	//NOTE: See QAS_EventScheduler.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_EventScheduler_InitStruct& sInit);
+	void imp_deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	QA_Result imp_schedule(QAS_Event& sEvent, uint64_t uDeadline);
+	void imp_cancel(QAS_Event& sEvent);
+
+	QA_Result imp_schedulePin(QAS_EventScheduler_Pin ePin, QAS_EventScheduler_Action eAction, uint64_t uDeadline);
+	void imp_cancelPin(QAS_EventScheduler_Pin ePin);
+	void imp_setPin(QAS_EventScheduler_Pin ePin, bool bState);
+
+
+	//------------
+	//Tool Methods
+
+	void imp_arm(void);
+
+	void imp_heapRemove(uint8_t uIndex);
+	void imp_heapUp(uint8_t uIndex);
+	void imp_heapDown(uint8_t uIndex);
+
+	//Used to place an event at a position within the heap, keeping the event's stored index up to date
+	void heapSet(uint8_t uIndex, QAS_Event* pEvent) {
+		m_pHeap[uIndex] = pEvent;
+		pEvent->m_uIndex = uIndex;
+	}
+
+	void imp_setOutputMode(QAS_EventScheduler_Pin ePin, uint32_t uMode);
+
+	//Used to disable interrupts around short heap operations, returning the previous interrupt mask state
+	static uint32_t enterCritical(void) {
+		uint32_t uPrimask = __get_PRIMASK();
+		__disable_irq();
+		return uPrimask;
+	}
+
+	//Used to restore the interrupt mask state saved by enterCritical()
+	static void exitCritical(uint32_t uPrimask) {
+		__set_PRIMASK(uPrimask);
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_EVENTSCHEDULER_HPP_ */
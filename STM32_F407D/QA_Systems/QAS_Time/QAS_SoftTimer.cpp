@@ -0,0 +1,373 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Software Timer Service                                          */
+/*   Filename: QAS_SoftTimer.cpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAS_SoftTimer.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //--------------------------
+  //--------------------------
+	//QAS_SoftTimer Constructors
+
+//QAS_SoftTimer::QAS_SoftTimer
+//QAS_SoftTimer Constructor
+//
+//Sets all wheel slots and the expired list as empty
+//As this is a private method in a singleton class, this method will be called the first time the class's get() method is called
+QAS_SoftTimer::QAS_SoftTimer() :
+	m_eInitState(QA_NotInitialized),
+	m_eDispatch(QAS_SoftTimer_DispatchIRQ),
+	m_uTick(0),
+	m_uActive(0) {
+
+	for (uint8_t i=0; i<QAS_SoftTimer_Levels; i++) {
+		for (uint8_t j=0; j<QAS_SoftTimer_Slots; j++)
+			listInit(&m_sWheel[i][j]);
+	}
+	listInit(&m_sExpired);
+
+	imp_clearStats();
+}
+
+
+  //------------------------------------
+  //------------------------------------
+  //QAS_SoftTimer Initialization Methods
+
+//QAS_SoftTimer::imp_init
+//QAS_SoftTimer Initialization Method
+//
+//To be called from static method init()
+//Creates and starts the Timer driver used to generate wheel ticks, and enables the DWT cycle counter used for statistics
+//sInit - Initialization structure. See QAS_SoftTimer_InitStruct for details
+//Returns QA_OK if initialization successful
+//        QA_Fail if the tick frequency cannot be generated by the selected Timer peripheral to within QAS_SoftTimer_TolerancePPM
+//        QA_Error_PeriphBusy if the Timer peripheral is already in use
+QA_Result QAS_SoftTimer::imp_init(QAS_SoftTimer_InitStruct& sInit) {
+	if (m_eInitState)
+		return QA_OK;
+
+	//Use the reserved Timer peripheral if one has not been selected
+	QAD_Timer_Periph eTimer = sInit.eTimer;
+	if (eTimer == QAD_TimerNone)
+		eTimer = QAD_Timer_Reserved;
+
+	//Calculate prescaler and period for the required tick frequency
+	QAT_TimerSolution sSolution = QAT_TimerSolver::solveFrequency(eTimer, sInit.uTickFrequency, QAS_SoftTimer_TolerancePPM);
+	if (!sSolution.bValid)
+		return QA_Fail;
+
+	QAD_Timer_InitStruct sTimerInit;
+	sTimerInit.eTimer         = eTimer;
+	sTimerInit.eMode          = QAD_TimerContinuous;
+	sTimerInit.uPrescaler     = sSolution.uPrescaler;
+	sTimerInit.uPeriod        = sSolution.uPeriod;
+	sTimerInit.uIRQPriority   = sInit.uIRQPriority;
+	sTimerInit.uCounterTarget = 0;
+
+	m_pTimer = std::make_unique<QAD_Timer>(sTimerInit);
+	QA_Result eRes = m_pTimer->init();
+	if (eRes) {
+		m_pTimer.reset();
+		return eRes;
+	}
+
+	//Enable DWT cycle counter for statistics
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+	imp_clearStats();
+
+	m_eDispatch  = sInit.eDispatch;
+	m_eInitState = QA_Initialized;
+
+	//Start generating ticks
+	m_pTimer->setHandlerClass(this);
+	m_pTimer->start();
+
+	return QA_OK;
+}
+
+
+//QAS_SoftTimer::imp_deinit
+//QAS_SoftTimer Initialization Method
+//
+//To be called from static method deinit()
+//Stops and removes the Timer driver, and stops all active software timers without calling their callbacks
+void QAS_SoftTimer::imp_deinit(void) {
+	if (!m_eInitState)
+		return;
+
+	m_pTimer->stop();
+	m_eInitState = QA_NotInitialized;
+	m_pTimer.reset();
+
+	//Stop all timers
+	for (uint8_t i=0; i<QAS_SoftTimer_Levels; i++) {
+		for (uint8_t j=0; j<QAS_SoftTimer_Slots; j++) {
+			while (m_sWheel[i][j].pNext != &m_sWheel[i][j])
+				listRemove(m_sWheel[i][j].pNext);
+		}
+	}
+	while (m_sExpired.pNext != &m_sExpired)
+		listRemove(m_sExpired.pNext);
+
+	m_uActive = 0;
+}
+
+
+  //---------------------------------
+  //---------------------------------
+  //QAS_SoftTimer IRQ Handler Methods
+
+//QAS_SoftTimer::handler
+//QAS_SoftTimer IRQ Handler Method
+//
+//Called by the Timer driver when the update interrupt is triggered
+//Advances the timing wheel by one tick, and if QAS_SoftTimer_DispatchIRQ is being used, calls the callbacks of all expired timers
+//pData - Unused
+void QAS_SoftTimer::handler(void* pData) {
+	uint32_t uEntry = DWT->CYCCNT;
+
+	//Update tick-to-tick interval statistics
+	if (m_uTickEntryLast) {
+		uint32_t uPeriod = uEntry - m_uTickEntryLast;
+		if (uPeriod < m_uTickPeriodMin)
+			m_uTickPeriodMin = uPeriod;
+		if (uPeriod > m_uTickPeriodMax)
+			m_uTickPeriodMax = uPeriod;
+	}
+	m_uTickEntryLast = uEntry;
+
+	//Advance the timing wheel
+	imp_advance();
+
+	//Call expired timer callbacks
+	if (m_eDispatch == QAS_SoftTimer_DispatchIRQ) {
+		while (imp_expire()) {}
+	}
+
+	//Update tick cost statistics
+	m_uTickCyclesLast = DWT->CYCCNT - uEntry;
+	if (m_uTickCyclesLast > m_uTickCyclesMax)
+		m_uTickCyclesMax = m_uTickCyclesLast;
+}
+
+
+  //-----------------------------
+  //-----------------------------
+  //QAS_SoftTimer Control Methods
+
+//QAS_SoftTimer::imp_start
+//QAS_SoftTimer Control Method
+//
+//To be called from static method start()
+//sEntry  - The software timer to be started
+//uTicks  - Number of ticks until the timer expires (a value of 0 is treated as 1)
+//uPeriod - Reload period in ticks for a periodic timer, or 0 for a single-shot timer
+void QAS_SoftTimer::imp_start(QAS_SoftTimer_Entry& sEntry, uint32_t uTicks, uint32_t uPeriod) {
+	if (!uTicks)
+		uTicks = 1;
+
+	uint32_t uPrimask = enterCritical();
+
+	if (sEntry.isActive())
+		listRemove(&sEntry);
+	else
+		m_uActive++;
+
+	sEntry.m_uExpiry = m_uTick + uTicks;
+	sEntry.m_uPeriod = uPeriod;
+	imp_insert(&sEntry);
+
+	exitCritical(uPrimask);
+}
+
+
+//QAS_SoftTimer::imp_stop
+//QAS_SoftTimer Control Method
+//
+//To be called from static method stop()
+//sEntry - The software timer to be stopped
+void QAS_SoftTimer::imp_stop(QAS_SoftTimer_Entry& sEntry) {
+	uint32_t uPrimask = enterCritical();
+
+	if (sEntry.isActive()) {
+		listRemove(&sEntry);
+		m_uActive--;
+	}
+
+	exitCritical(uPrimask);
+}
+
+
+//QAS_SoftTimer::imp_process
+//QAS_SoftTimer Control Method
+//
+//To be called from static method process()
+//Calls the callbacks of expired timers when QAS_SoftTimer_DispatchDeferred is being used
+//uMaxBatch - Maximum number of callbacks to be called. 0 processes all expired timers
+//Returns the number of callbacks that were called
+uint16_t QAS_SoftTimer::imp_process(uint16_t uMaxBatch) {
+	uint16_t uCount = 0;
+	while (((!uMaxBatch) || (uCount < uMaxBatch)) && (imp_expire()))
+		uCount++;
+	return uCount;
+}
+
+
+  //--------------------------
+  //--------------------------
+  //QAS_SoftTimer Tool Methods
+
+//QAS_SoftTimer::imp_clearStats
+//QAS_SoftTimer Tool Method
+//
+//To be called from static method clearStats()
+//Used to clear the tick interrupt cost and jitter statistics
+void QAS_SoftTimer::imp_clearStats(void) {
+	m_uTickCyclesLast = 0;
+	m_uTickCyclesMax  = 0;
+	m_uTickPeriodMin  = 0xFFFFFFFF;
+	m_uTickPeriodMax  = 0;
+	m_uTickEntryLast  = 0;
+}
+
+
+//QAS_SoftTimer::imp_insert
+//QAS_SoftTimer Tool Method
+//
+//Used to add a timer to the wheel slot that corresponds to its expiry tick
+//The level is selected by how far in the future the expiry is, so that the timer will be cascaded down to level 0 by the time it expires
+//Timers further in the future than the range of the wheel are placed in the furthest top level slot, and re-cascaded from there
+//Must be called with interrupts disabled, or from within the tick interrupt
+//pEntry - The timer to be added
+void QAS_SoftTimer::imp_insert(QAS_SoftTimer_Entry* pEntry) {
+	uint32_t uExpiry = pEntry->m_uExpiry;
+	uint32_t uDelta  = uExpiry - m_uTick;
+	QAS_SoftTimer_Link* pSlot;
+
+	if (uDelta < (1UL << QAS_SoftTimer_SlotBits)) {
+		pSlot = &m_sWheel[0][uExpiry & QAS_SoftTimer_SlotMask];
+	} else if (uDelta < (1UL << (QAS_SoftTimer_SlotBits * 2))) {
+		pSlot = &m_sWheel[1][(uExpiry >> QAS_SoftTimer_SlotBits) & QAS_SoftTimer_SlotMask];
+	} else if (uDelta < (1UL << (QAS_SoftTimer_SlotBits * 3))) {
+		pSlot = &m_sWheel[2][(uExpiry >> (QAS_SoftTimer_SlotBits * 2)) & QAS_SoftTimer_SlotMask];
+	} else {
+		if (uDelta > QAS_SoftTimer_MaxDelta)
+			uExpiry = m_uTick + QAS_SoftTimer_MaxDelta;
+		pSlot = &m_sWheel[3][(uExpiry >> (QAS_SoftTimer_SlotBits * 3)) & QAS_SoftTimer_SlotMask];
+	}
+
+	listAppend(pSlot, pEntry);
+}
+
+
+//QAS_SoftTimer::imp_cascade
+//QAS_SoftTimer Tool Method
+//
+//Used to move all timers in a slot of a higher wheel level back into the wheel, which places them in lower level slots
+//Each timer is cascaded at most once per level, so the cost is constant per timer over the timer's lifetime
+//uLevel - The wheel level (1 to 3)
+//uSlot  - The slot within the level
+void QAS_SoftTimer::imp_cascade(uint8_t uLevel, uint8_t uSlot) {
+	QAS_SoftTimer_Link sList;
+	listInit(&sList);
+	listSplice(&sList, &m_sWheel[uLevel][uSlot]);
+
+	while (sList.pNext != &sList) {
+		QAS_SoftTimer_Entry* pEntry = static_cast<QAS_SoftTimer_Entry*>(sList.pNext);
+		listRemove(pEntry);
+		imp_insert(pEntry);
+	}
+}
+
+
+//QAS_SoftTimer::imp_advance
+//QAS_SoftTimer Tool Method
+//
+//Used to process the current tick. Higher wheel levels are cascaded when the lower level wraps, and then the level 0 slot for the
+//current tick is moved onto the expired list as a single operation
+//Only to be called from within the tick interrupt
+void QAS_SoftTimer::imp_advance(void) {
+	uint32_t uTick = m_uTick;
+	uint8_t  uSlot = uTick & QAS_SoftTimer_SlotMask;
+
+	if (!uSlot) {
+		for (uint8_t i=1; i<QAS_SoftTimer_Levels; i++) {
+			uint8_t uLevelSlot = (uTick >> (QAS_SoftTimer_SlotBits * i)) & QAS_SoftTimer_SlotMask;
+			imp_cascade(i, uLevelSlot);
+			if (uLevelSlot)
+				break;
+		}
+	}
+
+	listSplice(&m_sExpired, &m_sWheel[0][uSlot]);
+	m_uTick = uTick + 1;
+}
+
+
+//QAS_SoftTimer::imp_expire
+//QAS_SoftTimer Tool Method
+//
+//Used to remove a single timer from the expired list and call its callback
+//Periodic timers are re-inserted into the wheel before the callback is called, so that the callback is able to stop or restart the timer
+//The list operations are performed with interrupts disabled, while the callback is called with interrupts in their previous state
+//Returns true if a timer was expired, or false if the expired list is empty
+bool QAS_SoftTimer::imp_expire(void) {
+	uint32_t uPrimask = enterCritical();
+
+	if (m_sExpired.pNext == &m_sExpired) {
+		exitCritical(uPrimask);
+		return false;
+	}
+
+	QAS_SoftTimer_Entry* pEntry = static_cast<QAS_SoftTimer_Entry*>(m_sExpired.pNext);
+	listRemove(pEntry);
+
+	if (pEntry->m_uPeriod) {
+		pEntry->m_uExpiry += pEntry->m_uPeriod;
+
+		//If the timer has fallen behind (for instance due to deferred processing), restart it from the current tick rather than
+		//expiring it repeatedly to catch up
+		if ((int32_t)(pEntry->m_uExpiry - m_uTick) < 0)
+			pEntry->m_uExpiry = m_uTick;
+		imp_insert(pEntry);
+	} else {
+		m_uActive--;
+	}
+
+	QAD_IRQHandler_CallbackFunction pHandlerFunction = pEntry->m_pHandlerFunction;
+	QAD_IRQHandler_CallbackClass*   pHandlerClass    = pEntry->m_pHandlerClass;
+	void*                           pData            = pEntry->m_pData;
+
+	exitCritical(uPrimask);
+
+	//If a handler callback function has been assigned then call it
+	if (pHandlerFunction)
+		pHandlerFunction(pData);
+
+	//If a handler callback class has been assigned then call it's handler() method
+	if (pHandlerClass)
+		pHandlerClass->handler(pData);
+
+	return true;
+}
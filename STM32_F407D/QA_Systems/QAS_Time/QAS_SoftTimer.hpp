@@ -0,0 +1,389 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Systems - Time                                                */
+/*   Role: Software Timer Service                                          */
+/*   Filename: QAS_SoftTimer.hpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAS_SOFTTIMER_HPP_
+#define __QAS_SOFTTIMER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include <memory>
+
+#include "QAD_Timer.hpp"
+#include "QAT_TimerSolver.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-------------------------
+//Timing Wheel Definitions
+//
+//The timing wheel has 4 levels of 64 slots. Level 0 has a resolution of 1 tick, and each subsequent level has a resolution
+//64 times coarser than the previous level, giving a total range of 2^24 ticks before timers need to be re-cascaded from the top level
+//
+//QAS_SoftTimer_TolerancePPM is the largest error in the tick frequency accepted by init(), in parts per million
+const uint8_t  QAS_SoftTimer_Levels       = 4;
+const uint8_t  QAS_SoftTimer_SlotBits     = 6;
+const uint8_t  QAS_SoftTimer_Slots        = (1 << QAS_SoftTimer_SlotBits);
+const uint8_t  QAS_SoftTimer_SlotMask     = (QAS_SoftTimer_Slots - 1);
+const uint32_t QAS_SoftTimer_MaxDelta     = (1UL << (QAS_SoftTimer_SlotBits * QAS_SoftTimer_Levels)) - 1;
+const uint32_t QAS_SoftTimer_TolerancePPM = 1000;
+
+
+//----------------------
+//QAS_SoftTimer_Dispatch
+//
+//Used to select where expiry callbacks are called from
+enum QAS_SoftTimer_Dispatch : uint8_t {
+	QAS_SoftTimer_DispatchIRQ = 0,  //Callbacks are called from within the timer update interrupt, immediately after the wheel has been advanced
+	QAS_SoftTimer_DispatchDeferred  //Expired timers are queued, and callbacks are called in batches by QAS_SoftTimer::process() from the main loop
+};
+
+
+//------------------------
+//QAS_SoftTimer_InitStruct
+//
+//This structure is used to initialize the QAS_SoftTimer system
+typedef struct {
+
+	QAD_Timer_Periph       eTimer;          //Timer peripheral used to drive the wheel. Set to QAD_TimerNone to use QAD_Timer_Reserved (Timer 7),
+	                                        //which is kept for QAS_SoftTimer by QAD_TimerMgr
+	                                        //NOTE: handlers.cpp routes the Timer 6 and Timer 7 interrupts through QAD_TimerMgr::irqHandler(). If a
+	                                        //      different timer is used, its IRQ handler function will need to call QAS_SoftTimer::irqHandler()
+
+	uint32_t               uTickFrequency;  //Frequency of wheel ticks in Hz. All software timer durations are given in ticks
+	uint8_t                uIRQPriority;    //IRQ Priority for timer update interrupt (a value between 0 and 15)
+
+	QAS_SoftTimer_Dispatch eDispatch;       //Where expiry callbacks are called from. Member of QAS_SoftTimer_Dispatch
+
+} QAS_SoftTimer_InitStruct;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------------
+//QAS_SoftTimer_Link
+//
+//Doubly linked list node used by the timing wheel. Each wheel slot has a sentinel link, and lists are circular so that
+//a software timer can be removed from whichever list it is in without needing to know which list that is
+struct QAS_SoftTimer_Link {
+	QAS_SoftTimer_Link* pNext;
+	QAS_SoftTimer_Link* pPrev;
+};
+
+
+//-------------------
+//QAS_SoftTimer_Entry
+//
+//A single software timer
+//Entries are owned by the code that uses them (as a static or as a class member), so the QAS_SoftTimer system never allocates memory
+//for them. An entry must not be destroyed while it is active
+class QAS_SoftTimer_Entry : private QAS_SoftTimer_Link {
+	friend class QAS_SoftTimer;
+private:
+
+	uint32_t m_uExpiry;   //Tick at which the timer expires
+	uint32_t m_uPeriod;   //Reload period in ticks for periodic timers, or 0 for a single-shot timer
+
+	QAD_IRQHandler_CallbackFunction m_pHandlerFunction;  //A pointer to the callback function to be called when the timer expires
+	QAD_IRQHandler_CallbackClass*   m_pHandlerClass;     //A pointer to the callback class to be called when the timer expires
+	void*                           m_pData;             //Data pointer passed to the callback when the timer expires
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAS_SoftTimer_Entry() :
+		m_uExpiry(0),
+		m_uPeriod(0),
+		m_pHandlerFunction(NULL),
+		m_pHandlerClass(NULL),
+		m_pData(NULL) {
+		pNext = NULL;
+		pPrev = NULL;
+	}
+
+	QAS_SoftTimer_Entry(const QAS_SoftTimer_Entry& other) = delete;
+	QAS_SoftTimer_Entry& operator=(const QAS_SoftTimer_Entry& other) = delete;
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the callback function to be called when the timer expires
+	//pHandler - Pointer to callback function based on QAD_IRQHandler_CallbackFunction prototype defined in setup.hpp
+	//pData    - Data pointer to be passed to the callback function
+	void setHandlerFunction(QAD_IRQHandler_CallbackFunction pHandler, void* pData) {
+		m_pHandlerFunction = pHandler;
+		m_pData            = pData;
+	}
+
+	//Used to set the callback class to be called when the timer expires
+	//pHandler - Pointer to callback class based on QAD_IRQHandler_CallbackClass defined in setup.hpp
+	//pData    - Data pointer to be passed to the callback class's handler() method
+	void setHandlerClass(QAD_IRQHandler_CallbackClass* pHandler, void* pData) {
+		m_pHandlerClass = pHandler;
+		m_pData         = pData;
+	}
+
+	//Returns true if the timer is currently running (including if it has expired but its callback has not yet been called)
+	bool isActive(void) const {
+		return (pNext != NULL);
+	}
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------------
+//QAS_SoftTimer
+//
+//Singleton class
+//Software timer service, allowing many thousands of software timers to be driven by a single hardware Timer peripheral
+//
+//Timers are held in a hierarchical timing wheel, so starting, stopping and expiring a timer are all constant time operations
+//no matter how many timers are active. Timers expiring on the same tick are moved to the expired list in a single operation,
+//and their callbacks are then called as a batch, either directly from the timer interrupt or from process() in the main loop.
+//
+//Per-tick interrupt cost and tick-to-tick jitter are measured using the DWT cycle counter, and can be read using the status methods
+class QAS_SoftTimer : public QAD_IRQHandler_CallbackClass {
+private:
+
+	std::unique_ptr<QAD_Timer> m_pTimer;   //Timer driver used to generate wheel ticks
+
+	QA_InitState           m_eInitState;   //Stores whether the system is currently initialized. Member of QA_InitState enum defined in setup.hpp
+	QAS_SoftTimer_Dispatch m_eDispatch;    //Where expiry callbacks are called from
+
+	volatile uint32_t      m_uTick;        //Next tick to be processed
+
+	QAS_SoftTimer_Link     m_sWheel[QAS_SoftTimer_Levels][QAS_SoftTimer_Slots];  //Sentinel links for each slot of each wheel level
+	QAS_SoftTimer_Link     m_sExpired;                                           //Sentinel link for the list of expired timers
+
+	uint16_t               m_uActive;      //Number of timers currently active
+
+	//Statistics
+	uint32_t               m_uTickCyclesLast;  //CPU cycles taken by the most recent tick interrupt
+	uint32_t               m_uTickCyclesMax;   //Maximum CPU cycles taken by a tick interrupt
+	uint32_t               m_uTickPeriodMin;   //Minimum CPU cycles between consecutive tick interrupts
+	uint32_t               m_uTickPeriodMax;   //Maximum CPU cycles between consecutive tick interrupts
+	uint32_t               m_uTickEntryLast;   //Cycle count at entry of the most recent tick interrupt
+
+	//------------
+	//Constructors
+	QAS_SoftTimer();
+
+public:
+
+	//------------------------------------------------------------------------------
+	//Delete copy constructor and assignment operator due to being a singleton class
+	QAS_SoftTimer(const QAS_SoftTimer& other) = delete;
+	QAS_SoftTimer& operator=(const QAS_SoftTimer& other) = delete;
+
+
+	//-----------------
+	//Singleton Methods
+	//
+	//Used to retrieve a reference to the singleton class
+	static QAS_SoftTimer& get(void) {
+		static QAS_SoftTimer instance;
+		return instance;
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to initialize the software timer service, and start the Timer peripheral used to drive the timing wheel
+	//sInit - Initialization structure. See QAS_SoftTimer_InitStruct for details
+	//Returns QA_OK if initialization successful, or an error if not successful (a member of QA_Result as defined in setup.hpp)
+	static QA_Result init(QAS_SoftTimer_InitStruct& sInit) {
+		return get().imp_init(sInit);
+	}
+
+	//Used to deinitialize the software timer service
+	//All active timers are stopped without their callbacks being called
+	static void deinit(void) {
+		get().imp_deinit();
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to start a software timer. If the timer is already active it is restarted
+	//sEntry  - The software timer to be started
+	//uTicks  - Number of ticks until the timer expires (a value of 0 is treated as 1)
+	//uPeriod - Reload period in ticks for a periodic timer, or 0 for a single-shot timer
+	static void start(QAS_SoftTimer_Entry& sEntry, uint32_t uTicks, uint32_t uPeriod) {
+		get().imp_start(sEntry, uTicks, uPeriod);
+	}
+
+	//Used to stop a software timer. Stopping an inactive timer has no effect
+	//sEntry - The software timer to be stopped
+	static void stop(QAS_SoftTimer_Entry& sEntry) {
+		get().imp_stop(sEntry);
+	}
+
+	//Used to call the callbacks of expired timers when QAS_SoftTimer_DispatchDeferred is being used
+	//uMaxBatch - Maximum number of callbacks to be called, allowing the time spent in a single call to be bounded. 0 processes all expired timers
+	//Returns the number of callbacks that were called
+	static uint16_t process(uint16_t uMaxBatch) {
+		return get().imp_process(uMaxBatch);
+	}
+
+	//Returns the current tick count
+	static uint32_t getTick(void) {
+		return get().m_uTick;
+	}
+
+
+	//-------------------
+	//IRQ Handler Methods
+
+	//Used to pass the driving Timer peripheral's interrupt to the Timer driver
+	//This method is only to be called by the interrupt request handler function from handlers.cpp
+	static void irqHandler(void) {
+		QAS_SoftTimer& sInstance = get();
+		if (sInstance.m_eInitState)
+			sInstance.m_pTimer->handler();
+	}
+
+	void handler(void* pData);
+
+
+	//--------------
+	//Status Methods
+
+	//Returns the number of software timers currently active
+	static uint16_t getActive(void) {
+		return get().m_uActive;
+	}
+
+	//Returns the number of CPU cycles taken by the most recent tick interrupt
+	static uint32_t getTickCyclesLast(void) {
+		return get().m_uTickCyclesLast;
+	}
+
+	//Returns the maximum number of CPU cycles taken by a tick interrupt since initialization or the last call to clearStats()
+	static uint32_t getTickCyclesMax(void) {
+		return get().m_uTickCyclesMax;
+	}
+
+	//Returns the tick-to-tick jitter, as the difference in CPU cycles between the longest and shortest interval between consecutive tick interrupts
+	static uint32_t getTickJitter(void) {
+		QAS_SoftTimer& sInstance = get();
+		if (sInstance.m_uTickPeriodMax < sInstance.m_uTickPeriodMin)
+			return 0;
+		return sInstance.m_uTickPeriodMax - sInstance.m_uTickPeriodMin;
+	}
+
+	//Used to clear the tick interrupt cost and jitter statistics
+	static void clearStats(void) {
+		get().imp_clearStats();
+	}
+
+
+private:
+
+	//NOTE: See QAS_SoftTimer.cpp for details of the following methods
+
+	//----------------------
+	//Initialization Methods
+
+	QA_Result imp_init(QAS_SoftTimer_InitStruct& sInit);
+	void imp_deinit(void);
+
+
+	//---------------
+	//Control Methods
+
+	void imp_start(QAS_SoftTimer_Entry& sEntry, uint32_t uTicks, uint32_t uPeriod);
+	void imp_stop(QAS_SoftTimer_Entry& sEntry);
+	uint16_t imp_process(uint16_t uMaxBatch);
+
+
+	//------------
+	//Tool Methods
+
+	void imp_clearStats(void);
+
+	void imp_insert(QAS_SoftTimer_Entry* pEntry);
+	void imp_cascade(uint8_t uLevel, uint8_t uSlot);
+	void imp_advance(void);
+	bool imp_expire(void);
+
+	//Used to initialize a list sentinel as an empty list
+	static void listInit(QAS_SoftTimer_Link* pHead) {
+		pHead->pNext = pHead;
+		pHead->pPrev = pHead;
+	}
+
+	//Used to add a link to the tail of a list
+	static void listAppend(QAS_SoftTimer_Link* pHead, QAS_SoftTimer_Link* pLink) {
+		pLink->pPrev        = pHead->pPrev;
+		pLink->pNext        = pHead;
+		pHead->pPrev->pNext = pLink;
+		pHead->pPrev        = pLink;
+	}
+
+	//Used to remove a link from whichever list it is in
+	static void listRemove(QAS_SoftTimer_Link* pLink) {
+		pLink->pPrev->pNext = pLink->pNext;
+		pLink->pNext->pPrev = pLink->pPrev;
+		pLink->pNext        = NULL;
+		pLink->pPrev        = NULL;
+	}
+
+	//Used to move the entire contents of one list onto the tail of another, leaving the source list empty
+	static void listSplice(QAS_SoftTimer_Link* pDest, QAS_SoftTimer_Link* pSrc) {
+		if (pSrc->pNext == pSrc)
+			return;
+		pSrc->pNext->pPrev  = pDest->pPrev;
+		pDest->pPrev->pNext = pSrc->pNext;
+		pSrc->pPrev->pNext  = pDest;
+		pDest->pPrev        = pSrc->pPrev;
+		listInit(pSrc);
+	}
+
+	//Used to disable interrupts around short list operations, returning the previous interrupt mask state
+	static uint32_t enterCritical(void) {
+		uint32_t uPrimask = __get_PRIMASK();
+		__disable_irq();
+		return uPrimask;
+	}
+
+	//Used to restore the interrupt mask state saved by enterCritical()
+	static void exitCritical(uint32_t uPrimask) {
+		__set_PRIMASK(uPrimask);
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAS_SOFTTIMER_HPP_ */
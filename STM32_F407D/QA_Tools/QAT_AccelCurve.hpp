@@ -0,0 +1,143 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Acceleration Curve Lookup Tables                                */
+/*   Filename: QAT_AccelCurve.hpp                                          */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_ACCELCURVE_HPP_
+#define __QAT_ACCELCURVE_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------------
+//Accel Curve Definitions
+//
+//QAT_AccelCurve_Segments - Number of straight line segments in a curve (the table holds one more point than this)
+//QAT_AccelCurve_Unity    - Gain value representing a gain of 1 (gains are 8.8 fixed point)
+const uint8_t  QAT_AccelCurve_Segments = 64;
+const uint16_t QAT_AccelCurve_Unity    = 256;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//--------------
+//QAT_AccelCurve
+//
+//Lookup table converting a speed into a gain, for speed dependent acceleration of user input such as rotary encoders
+//
+//Below a threshold speed the gain is 1, so slow movements give precise single steps. Between the threshold and the full speed the gain
+//rises from 1 to the maximum gain following a power curve (linear, quadratic, cubic, etc), and above the full speed it stays at the
+//maximum gain. The curve is stored as QAT_AccelCurve_Segments straight line segments spread evenly between the threshold and the full
+//speed, and getGain() interpolates between the two points either side of the speed, so a lookup takes the same short time at any speed.
+//
+//Gains are 8.8 fixed point (see QAT_AccelCurve_Unity), and the table is calculated using 16bit fixed point intermediate values in
+//64bit integers, so no floating point is used and no value can overflow for any combination of parameters.
+//
+//The table is built by the compiler, so when declared as a constexpr object it is placed in flash memory and costs no time at startup
+class QAT_AccelCurve {
+private:
+
+	uint16_t m_uTable[QAT_AccelCurve_Segments + 1];  //Gain at the start of each segment, plus the gain at the end of the final segment
+	uint16_t m_uThreshold;                           //Speed at the start of the first segment
+	uint16_t m_uFull;                                //Speed at the end of the final segment
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	//Used to calculate the table
+	//uMaxGain   - Gain at and above the full speed, as a whole number (1 to 255)
+	//uThreshold - Speed at and below which the gain is 1
+	//uFull      - Speed at which the maximum gain is reached. Must be higher than uThreshold (the gain steps straight to uMaxGain if not)
+	//uPower     - Power of the curve between the threshold and full speed (1 for linear, 2 for quadratic, 3 for cubic, etc)
+	//
+	//For a speed s between the threshold and full speed, with t = (s - uThreshold) / (uFull - uThreshold), the gain is
+	//1 + (uMaxGain - 1) * t^uPower. Point i of the table is at t = i / QAT_AccelCurve_Segments, held as a 16bit fraction, which is raised
+	//to the power by repeated 16bit fixed point multiplies
+	constexpr QAT_AccelCurve(uint8_t uMaxGain, uint16_t uThreshold, uint16_t uFull, uint8_t uPower) :
+		m_uTable{},
+		m_uThreshold(uThreshold),
+		m_uFull((uFull > uThreshold) ? uFull : (uint16_t)(uThreshold + 1)) {
+
+		if (!uMaxGain)
+			uMaxGain = 1;
+
+		uint64_t uRange = (uint64_t)(uMaxGain - 1) * QAT_AccelCurve_Unity;
+
+		for (uint16_t i=0; i<=QAT_AccelCurve_Segments; i++) {
+			uint64_t uT = ((uint64_t)i << 16) / QAT_AccelCurve_Segments;
+
+			//Raise to the power of the curve, rounding each multiply
+			uint64_t uCurve = 65536;
+			for (uint8_t j=0; j<uPower; j++)
+				uCurve = ((uCurve * uT) + 32768) >> 16;
+
+			m_uTable[i] = (uint16_t)(QAT_AccelCurve_Unity + (((uRange * uCurve) + 32768) >> 16));
+		}
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the gain for a speed, as an 8.8 fixed point value
+	//uSpeed - Speed in the units used when creating the curve
+	constexpr uint16_t getGain(uint16_t uSpeed) const {
+		if (uSpeed <= m_uThreshold)
+			return m_uTable[0];
+		if (uSpeed >= m_uFull)
+			return m_uTable[QAT_AccelCurve_Segments];
+
+		//Position along the curve in segments, with an 8bit fraction (at most 65535 * 64 * 256, so fits in 32bits)
+		uint32_t uPos   = ((uint32_t)(uSpeed - m_uThreshold) * QAT_AccelCurve_Segments * 256) / (uint32_t)(m_uFull - m_uThreshold);
+		uint32_t uIndex = uPos >> 8;
+
+		int32_t iStart = m_uTable[uIndex];
+		int32_t iDelta = (int32_t)m_uTable[uIndex + 1] - iStart;
+		return (uint16_t)(iStart + ((iDelta * (int32_t)(uPos & 0xFF)) / 256));
+	}
+
+	//Returns the gain at one of the points of the table, as an 8.8 fixed point value
+	//uIndex - Point index (0 to QAT_AccelCurve_Segments)
+	constexpr uint16_t operator[](uint8_t uIndex) const {
+		return m_uTable[uIndex];
+	}
+
+	//Returns the speed at the start of the first segment (the threshold speed)
+	constexpr uint16_t getThreshold(void) const {
+		return m_uThreshold;
+	}
+
+	//Returns the speed at the end of the final segment (the full speed)
+	constexpr uint16_t getFull(void) const {
+		return m_uFull;
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_ACCELCURVE_HPP_ */
@@ -0,0 +1,175 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Binary Code Modulation Tables                                   */
+/*   Filename: QAT_BCM.hpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_BCM_HPP_
+#define __QAT_BCM_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//---------------
+//BCM Definitions
+//
+//QAT_BCM_MaxBits  - Maximum duty resolution in bits (the number of bit-planes)
+//QAT_BCM_MaxPorts - Maximum number of GPIO ports
+//QAT_BCM_PortPins - Number of pins per GPIO port
+const uint8_t QAT_BCM_MaxBits  = 12;
+const uint8_t QAT_BCM_MaxPorts = 3;
+const uint8_t QAT_BCM_PortPins = 16;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------
+//QAT_BCM
+//
+//Used to build the bit-plane tables for binary code modulation (BCM) of GPIO pins, as used by QAD_SoftPWM
+//
+//With BCM, each output cycle is split into one slot per bit of the duty value, with slot k lasting 2^k ticks. During slot k, each pin
+//is high if bit k of its duty value is set. The average level of each pin over the cycle is therefore its duty / (2^bits - 1), with only
+//one GPIO write per slot regardless of the number of pins.
+//
+//The table for each GPIO port holds one BSRR register value per slot, setting the pins that are high in that slot and resetting the
+//pins that are low. Only the pins that have been assigned to the port are affected. When a duty value changes, only the bits that
+//have changed are updated, so the cost of setDuty() does not depend on the number of pins. Each table entry is updated with a single
+//32bit write, so the tables can be changed while they are being read by DMA
+class QAT_BCM {
+private:
+
+	uint8_t  m_uBits;                                      //Duty resolution in bits
+	uint16_t m_uMask[QAT_BCM_MaxPorts];                    //Pins assigned to each port
+	uint16_t m_uDuty[QAT_BCM_MaxPorts][QAT_BCM_PortPins];  //Duty value of each pin
+	uint32_t m_uWords[QAT_BCM_MaxPorts][QAT_BCM_MaxBits];  //BSRR register value of each slot for each port
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	//uBits - Duty resolution in bits (1 to QAT_BCM_MaxBits). Values outside this range are limited to the range
+	QAT_BCM(uint8_t uBits) :
+		m_uBits((uBits < 1) ? 1 : ((uBits > QAT_BCM_MaxBits) ? QAT_BCM_MaxBits : uBits)) {
+
+		for (uint8_t i=0; i<QAT_BCM_MaxPorts; i++)
+			setPort(i, 0);
+	}
+
+
+	//----------------------
+	//Initialization Methods
+
+	//Used to assign pins to a port. All of the pins of the port are set to a duty of 0
+	//uPort - Port index (0 to QAT_BCM_MaxPorts-1)
+	//uMask - Pins to be assigned to the port, with bit 0 representing pin 0
+	void setPort(uint8_t uPort, uint16_t uMask) {
+		m_uMask[uPort] = uMask;
+
+		for (uint8_t i=0; i<QAT_BCM_PortPins; i++)
+			m_uDuty[uPort][i] = 0;
+
+		for (uint8_t i=0; i<QAT_BCM_MaxBits; i++)
+			m_uWords[uPort][i] = (uint32_t)uMask << 16;
+	}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the duty of a pin
+	//uPort - Port index (0 to QAT_BCM_MaxPorts-1)
+	//uPin  - Pin number (0 to 15). Pins that have not been assigned to the port are ignored
+	//uDuty - Duty value, from 0 (always low) to getMaxDuty() (always high). Larger values are limited to getMaxDuty()
+	void setDuty(uint8_t uPort, uint8_t uPin, uint16_t uDuty) {
+		if (!(m_uMask[uPort] & (1 << uPin)))
+			return;
+
+		if (uDuty > getMaxDuty())
+			uDuty = getMaxDuty();
+
+		uint16_t uChanged = m_uDuty[uPort][uPin] ^ uDuty;
+		m_uDuty[uPort][uPin] = uDuty;
+
+		//Update only the slots whose bit has changed
+		for (uint8_t i=0; uChanged; i++, uChanged >>= 1) {
+			if (uChanged & 1) {
+				uint32_t uWord = m_uWords[uPort][i] & ~((1UL << uPin) | (1UL << (uPin + 16)));
+				m_uWords[uPort][i] = uWord | ((uDuty & (1 << i)) ? (1UL << uPin) : (1UL << (uPin + 16)));
+			}
+		}
+	}
+
+	//Used to retrieve the duty of a pin
+	//uPort - Port index (0 to QAT_BCM_MaxPorts-1)
+	//uPin  - Pin number (0 to 15)
+	uint16_t getDuty(uint8_t uPort, uint8_t uPin) {
+		return m_uDuty[uPort][uPin];
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the duty resolution in bits, which is also the number of slots per cycle
+	uint8_t getBits(void) {
+		return m_uBits;
+	}
+
+	//Returns the largest duty value (2^bits - 1), which is also the number of ticks per cycle
+	uint16_t getMaxDuty(void) {
+		return (1 << m_uBits) - 1;
+	}
+
+	//Returns the table of BSRR register values for a port, with one entry per slot
+	//uPort - Port index (0 to QAT_BCM_MaxPorts-1)
+	const uint32_t* getTable(uint8_t uPort) {
+		return m_uWords[uPort];
+	}
+
+	//Used to render the waveform of a single pin from the table of its port, one value per tick
+	//This is used to check the tables that are sent to the GPIO port against the duty values
+	//uPort - Port index (0 to QAT_BCM_MaxPorts-1)
+	//uPin  - Pin number (0 to 15)
+	//pOut  - Buffer of at least getMaxDuty() entries, to receive the level of the pin (0 or 1) for each tick of the cycle
+	//Returns the number of ticks set to 1 (which equals the pin's duty value if the table is correct)
+	uint16_t render(uint8_t uPort, uint8_t uPin, uint8_t* pOut) {
+		uint16_t uIdx  = 0;
+		uint16_t uHigh = 0;
+
+		for (uint8_t i=0; i<m_uBits; i++) {
+			uint8_t uLevel = (m_uWords[uPort][i] & (1UL << uPin)) ? 1 : 0;
+			for (uint16_t j=0; j<(1 << i); j++)
+				pOut[uIdx++] = uLevel;
+			uHigh += uLevel << i;
+		}
+		return uHigh;
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_BCM_HPP_ */
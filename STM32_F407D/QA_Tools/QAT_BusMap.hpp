@@ -0,0 +1,175 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Parallel Bus Pin Mapping Tables                                 */
+/*   Filename: QAT_BusMap.hpp                                              */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_BUSMAP_HPP_
+#define __QAT_BUSMAP_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-------------------
+//Bus Map Definitions
+//
+//QAT_BusMap_MaxBits   - Maximum width of a bus in bits
+//QAT_BusMap_MaxPorts  - Maximum number of GPIO ports that the pins of a bus can be spread across
+//QAT_BusMap_PortPins  - Number of pins per GPIO port
+//QAT_BusMap_NoPin     - Pin number used to leave a bit of the bus unconnected
+const uint8_t QAT_BusMap_MaxBits  = 32;
+const uint8_t QAT_BusMap_MaxPorts = 4;
+const uint8_t QAT_BusMap_PortPins = 16;
+const uint8_t QAT_BusMap_NoPin    = 0xFF;
+
+
+//--------------
+//QAT_BusMap_Pin
+//
+//Used to give the GPIO pin of a single bit of a bus
+typedef struct {
+
+	uint8_t uPort;   //Port index (0 to QAT_BusMap_MaxPorts-1). The GPIO port for each index is chosen by the user of the map (see QAD_GPIO_Bus)
+	uint8_t uPin;    //Pin number within the port (0 to 15), or QAT_BusMap_NoPin to leave the bit unconnected
+
+} QAT_BusMap_Pin;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//----------
+//QAT_BusMap
+//
+//Lookup tables used to convert between an N-bit bus value and the GPIO registers of the pins that the bits of the bus are connected to,
+//as used by QAD_GPIO_Bus
+//
+//The bits of the bus can be connected to any pins of up to QAT_BusMap_MaxPorts GPIO ports, in any order. For each port, the value is
+//split into 4bit nibbles and each nibble has a 16 entry table holding the BSRR register value for that nibble, setting the pins of bits
+//that are 1 and resetting the pins of bits that are 0. As each bit belongs to exactly one nibble, the BSRR value for a whole port is the
+//OR of one table entry per nibble, and can then be written with a single store, changing every pin of the bus on that port at once.
+//Reading works the same way in reverse, with one table per nibble of the port's input register giving the bus bits of its pins.
+//
+//The tables are built by the constructor, which is constexpr, so a map declared as a constexpr object is built by the compiler and
+//placed in flash memory:
+//
+//  constexpr QAT_BusMap_Pin sPins[8] = {{0, 0}, {0, 1}, {0, 2}, {0, 3}, {1, 8}, {1, 9}, {1, 10}, {1, 11}};
+//  constexpr QAT_BusMap     cMap(sPins, 8);
+//
+//A map can also be built at runtime in RAM when the pins are not known until then. Bits connected to a port index outside of the range,
+//to a pin number outside of 0 to 15, or to QAT_BusMap_NoPin are left unconnected
+class QAT_BusMap {
+private:
+
+	uint8_t  m_uBits;                                                  //Width of the bus in bits
+	uint8_t  m_uNibbles;                                               //Number of 4bit nibbles in the bus value
+	uint16_t m_uMask[QAT_BusMap_MaxPorts];                             //Pins of each port connected to the bus
+	uint32_t m_uWrite[QAT_BusMap_MaxPorts][QAT_BusMap_MaxBits / 4][16];  //BSRR register value of each nibble value, for each nibble of each port
+	uint32_t m_uRead[QAT_BusMap_MaxPorts][QAT_BusMap_PortPins / 4][16];  //Bus bits of each value of each nibble of each port's input register
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	//Used to build the tables
+	//pPins - Array of uBits entries giving the GPIO pin of each bit of the bus, starting from bit 0
+	//uBits - Width of the bus in bits (1 to QAT_BusMap_MaxBits). Values outside this range are limited to the range
+	constexpr QAT_BusMap(const QAT_BusMap_Pin* pPins, uint8_t uBits) :
+		m_uBits((uBits < 1) ? 1 : ((uBits > QAT_BusMap_MaxBits) ? QAT_BusMap_MaxBits : uBits)),
+		m_uNibbles(0),
+		m_uMask{},
+		m_uWrite{},
+		m_uRead{} {
+
+		m_uNibbles = (m_uBits + 3) / 4;
+
+		for (uint8_t uBit=0; uBit<m_uBits; uBit++) {
+			uint8_t uPort = pPins[uBit].uPort;
+			uint8_t uPin  = pPins[uBit].uPin;
+			if ((uPort >= QAT_BusMap_MaxPorts) || (uPin >= QAT_BusMap_PortPins))
+				continue;
+
+			m_uMask[uPort] |= (uint16_t)(1 << uPin);
+
+			//Add the pin to the write table of the bit's nibble, as a set for values with the bit at 1 and a reset for values with it at 0
+			for (uint8_t uVal=0; uVal<16; uVal++)
+				m_uWrite[uPort][uBit >> 2][uVal] |= (uVal & (1 << (uBit & 0x03))) ? (1UL << uPin) : (1UL << (uPin + 16));
+
+			//Add the bit to the read table of the pin's nibble, for values with the pin high
+			for (uint8_t uVal=0; uVal<16; uVal++) {
+				if (uVal & (1 << (uPin & 0x03)))
+					m_uRead[uPort][uPin >> 2][uVal] |= (1UL << uBit);
+			}
+		}
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the width of the bus in bits
+	constexpr uint8_t getBits(void) const {
+		return m_uBits;
+	}
+
+	//Returns the pins of a port that are connected to the bus, with bit 0 representing pin 0
+	//uPort - Port index (0 to QAT_BusMap_MaxPorts-1)
+	constexpr uint16_t getMask(uint8_t uPort) const {
+		return m_uMask[uPort];
+	}
+
+	//Returns the BSRR register value of a port for a bus value. Pins of the port that are not connected to the bus are not affected
+	//uPort  - Port index (0 to QAT_BusMap_MaxPorts-1)
+	//uValue - Bus value. Bits above the width of the bus are ignored
+	constexpr uint32_t encode(uint8_t uPort, uint32_t uValue) const {
+		uint32_t uWord = 0;
+		for (uint8_t i=0; i<m_uNibbles; i++, uValue >>= 4)
+			uWord |= m_uWrite[uPort][i][uValue & 0x0F];
+		return uWord;
+	}
+
+	//Returns the bus bits of a port's pins from the value of its input register. Bits of pins on other ports are returned as 0, so the
+	//bus value is the OR of the results for all ports
+	//uPort - Port index (0 to QAT_BusMap_MaxPorts-1)
+	//uIDR  - Value of the port's input register
+	constexpr uint32_t decode(uint8_t uPort, uint16_t uIDR) const {
+		return m_uRead[uPort][0][uIDR & 0x0F] | m_uRead[uPort][1][(uIDR >> 4) & 0x0F] |
+		       m_uRead[uPort][2][(uIDR >> 8) & 0x0F] | m_uRead[uPort][3][uIDR >> 12];
+	}
+
+	//Used to convert a block of bus values into BSRR register values for one port, such as for writing to the port by DMA
+	//uPort   - Port index (0 to QAT_BusMap_MaxPorts-1)
+	//pValues - Array of uCount bus values
+	//pWords  - Array of at least uCount entries, to receive the BSRR register value for each bus value
+	//uCount  - Number of values to convert
+	void encodeBlock(uint8_t uPort, const uint32_t* pValues, uint32_t* pWords, uint16_t uCount) const {
+		for (uint16_t i=0; i<uCount; i++)
+			pWords[i] = encode(uPort, pValues[i]);
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_BUSMAP_HPP_ */
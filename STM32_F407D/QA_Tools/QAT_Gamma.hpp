@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Gamma Correction Lookup Tables                                  */
+/*   Filename: QAT_Gamma.hpp                                               */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_GAMMA_HPP_
+#define __QAT_GAMMA_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------------
+//Gamma Definitions
+//
+//QAT_Gamma_Levels - Number of entries in a lookup table (one for each 8bit brightness level)
+const uint16_t QAT_Gamma_Levels = 256;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------
+//QAT_Gamma
+//
+//Lookup table converting an 8bit perceived brightness into a PWM compare value, for dimming LEDs
+//
+//The eye's response to light is far from linear, so a linear change in PWM duty appears to change brightness quickly at low duties and
+//hardly at all at high duties. The table follows the CIE 1931 lightness curve, which gives an even change in perceived brightness across
+//the full range of the 8bit input. The curve is cubic apart from a short linear section at the bottom, so the table is calculated with
+//integer arithmetic only.
+//
+//The table is built by the compiler, so when declared as a constexpr object it is placed in flash memory and costs no time at startup
+//uMax - Compare value giving full brightness (normally the timer's period + 1, so that full brightness is a constant high output)
+template <uint16_t uMax>
+class QAT_Gamma {
+private:
+
+	uint16_t m_uTable[QAT_Gamma_Levels];  //Compare value for each brightness level
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	//Used to calculate the table
+	//The lightness L of each level is (level * 100 / 255). Relative luminance is then L / 903.3 where L is 8 or less, or ((L + 16) / 116)^3
+	//above this. Both are scaled by 255 so that they can be calculated from the level directly
+	constexpr QAT_Gamma() : m_uTable{} {
+		for (uint16_t i=0; i<QAT_Gamma_Levels; i++) {
+			if ((i * 100) <= (8 * 255)) {
+				m_uTable[i] = (uint16_t)(((uint64_t)i * 1000 * uMax + ((255 * 9033) / 2)) / (255 * 9033));
+			} else {
+				uint64_t uNum = (i * 100) + (16 * 255);
+				uint64_t uDen = 116 * 255;
+				m_uTable[i] = (uint16_t)(((uNum * uNum * uNum * uMax) + ((uDen * uDen * uDen) / 2)) / (uDen * uDen * uDen));
+			}
+		}
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the compare value for a brightness level
+	//uLevel - Brightness level (0 to 255)
+	constexpr uint16_t operator[](uint8_t uLevel) const {
+		return m_uTable[uLevel];
+	}
+
+	//Returns the compare value giving full brightness
+	constexpr uint16_t getMax(void) const {
+		return uMax;
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_GAMMA_HPP_ */
@@ -0,0 +1,217 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Fixed Point PID Controller                                      */
+/*   Filename: QAT_PID.hpp                                                 */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_PID_HPP_
+#define __QAT_PID_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//---------------
+//PID Definitions
+//
+//QAT_PID_One   - Gain value representing a gain of 1 (gains are 16.16 fixed point)
+//QAT_PID_Limit - Largest magnitude of the error, measurement change and feed-forward inputs. Larger values are limited to this
+const int32_t QAT_PID_One   = 65536;
+const int32_t QAT_PID_Limit = 0x3FFFFFFF;
+
+
+//-------------
+//QAT_PID_Gains
+//
+//This structure holds the gains and output limits of a QAT_PID controller
+//Gains are 16.16 fixed point (QAT_PID_One is a gain of 1). The integral and derivative gains are per sample, so for gains Ki and Kd
+//in units of seconds, iKi is (Ki * T * 65536) and iKd is (Kd / T * 65536), where T is the sample period in seconds
+typedef struct {
+
+	int32_t iKp;       //Proportional gain
+	int32_t iKi;       //Integral gain per sample
+	int32_t iKd;       //Derivative gain per sample. The derivative is taken from the measurement, so setpoint changes do not cause a kick
+	int32_t iKff;      //Feed-forward gain, applied to the feed-forward input of update()
+
+	int32_t iOutMin;   //Lowest output value
+	int32_t iOutMax;   //Highest output value
+
+} QAT_PID_Gains;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------
+//QAT_PID
+//
+//Fixed point PID controller with feed-forward and integrator anti-windup, for use in control loop interrupts
+//
+//The output is the sum of the proportional, integral, derivative and feed-forward terms, limited to the output range. The integrator
+//is clamped to the output range, and is not advanced in a direction that would drive an already limited output further into its limit,
+//so that the controller recovers as soon as the error changes sign rather than first having to unwind a large integral.
+//
+//All terms are held as 16.16 fixed point values in 64bit integers. The inputs are limited to QAT_PID_Limit (2^30) and gains are 32bit,
+//so each term is less than 2^61 and the sum of the four terms cannot overflow. An update takes a few tens of cycles on the Cortex-M4,
+//with no floating point and no divides
+class QAT_PID {
+private:
+
+	QAT_PID_Gains m_sGains;      //Gains and output limits
+
+	int64_t       m_iIntegral;   //Integral term (16.16 fixed point)
+	int32_t       m_iLast;       //Measurement at the previous update
+	bool          m_bLast;       //Set once m_iLast holds a measurement
+	bool          m_bSaturated;  //Set if the output was limited at the previous update
+	int32_t       m_iOutput;     //Output of the previous update
+
+	//Limits a value to +/- QAT_PID_Limit
+	static int32_t limit(int64_t iVal) {
+		return (iVal > QAT_PID_Limit) ? QAT_PID_Limit : ((iVal < -QAT_PID_Limit) ? -QAT_PID_Limit : (int32_t)iVal);
+	}
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAT_PID() :
+		m_sGains{},
+		m_iIntegral(0),
+		m_iLast(0),
+		m_bLast(false),
+		m_bSaturated(false),
+		m_iOutput(0) {}
+
+	QAT_PID(const QAT_PID_Gains& sGains) :
+		m_sGains(sGains),
+		m_iIntegral(0),
+		m_iLast(0),
+		m_bLast(false),
+		m_bSaturated(false),
+		m_iOutput(0) {}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the gains and output limits. The integral term is kept, but limited to the new output range
+	//sGains - Gains and output limits. See QAT_PID_Gains for details
+	void setGains(const QAT_PID_Gains& sGains) {
+		m_sGains = sGains;
+		m_iIntegral = clampIntegral(m_iIntegral);
+	}
+
+	//Returns the current gains and output limits
+	const QAT_PID_Gains& getGains(void) const {
+		return m_sGains;
+	}
+
+	//Used to clear the integral and derivative history, such as before the controller is started
+	//iIntegral - Starting value of the integral term in output units, which can be used for a bumpless transfer from manual control
+	void reset(int32_t iIntegral = 0) {
+		m_iIntegral  = clampIntegral((int64_t)iIntegral * QAT_PID_One);
+		m_bLast      = false;
+		m_bSaturated = false;
+		m_iOutput    = 0;
+	}
+
+	//Used to run one sample of the controller
+	//iError       - Setpoint minus measurement
+	//iMeasured    - Measurement. Only the change from the previous update is used (for the derivative term), which is calculated with
+	//               wrapping arithmetic, so the measurement can be the low 32bits of a larger value such as a 64bit encoder position
+	//iFeedForward - Feed-forward input, multiplied by iKff and added to the output
+	//Returns the new output, between iOutMin and iOutMax
+	int32_t update(int32_t iError, int32_t iMeasured, int32_t iFeedForward = 0) {
+		int32_t iErr   = limit(iError);
+		int32_t iDelta = (m_bLast) ? limit((int32_t)((uint32_t)iMeasured - (uint32_t)m_iLast)) : 0;
+		m_iLast        = iMeasured;
+		m_bLast        = true;
+
+		//Proportional, derivative and feed-forward terms
+		int64_t iOut = ((int64_t)m_sGains.iKp * iErr) - ((int64_t)m_sGains.iKd * iDelta) +
+		               ((int64_t)m_sGains.iKff * limit(iFeedForward));
+
+		//Advance integral, unless this would drive a limited output further into its limit
+		int64_t iStep     = (int64_t)m_sGains.iKi * iErr;
+		int64_t iIntegral = clampIntegral(m_iIntegral + iStep);
+		int64_t iTotal    = iOut + iIntegral;
+
+		int64_t iMax = (int64_t)m_sGains.iOutMax * QAT_PID_One;
+		int64_t iMin = (int64_t)m_sGains.iOutMin * QAT_PID_One;
+		m_bSaturated = true;
+		if ((iTotal > iMax) && (iStep > 0)) {
+			iIntegral = m_iIntegral;
+			iTotal    = iOut + iIntegral;
+		} else if ((iTotal < iMin) && (iStep < 0)) {
+			iIntegral = m_iIntegral;
+			iTotal    = iOut + iIntegral;
+		}
+		m_iIntegral = iIntegral;
+
+		//Limit output, rounding to the nearest whole value
+		if (iTotal >= iMax) {
+			m_iOutput = m_sGains.iOutMax;
+		} else if (iTotal <= iMin) {
+			m_iOutput = m_sGains.iOutMin;
+		} else {
+			m_iOutput    = (int32_t)((iTotal + (QAT_PID_One / 2)) >> 16);
+			m_bSaturated = false;
+		}
+
+		return m_iOutput;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Returns the output of the previous update
+	int32_t getOutput(void) const {
+		return m_iOutput;
+	}
+
+	//Returns the integral term in output units
+	int32_t getIntegral(void) const {
+		return (int32_t)(m_iIntegral >> 16);
+	}
+
+	//Returns true if the output was limited at the previous update
+	bool isSaturated(void) const {
+		return m_bSaturated;
+	}
+
+
+private:
+
+	//Limits an integral value to the output range
+	int64_t clampIntegral(int64_t iIntegral) const {
+		int64_t iMax = (int64_t)m_sGains.iOutMax * QAT_PID_One;
+		int64_t iMin = (int64_t)m_sGains.iOutMin * QAT_PID_One;
+		return (iIntegral > iMax) ? iMax : ((iIntegral < iMin) ? iMin : iIntegral);
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_PID_HPP_ */
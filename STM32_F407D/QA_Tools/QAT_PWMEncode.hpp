@@ -0,0 +1,138 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: PWM Stream Encoders                                             */
+/*   Filename: QAT_PWMEncode.hpp                                           */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_PWMENCODE_HPP_
+#define __QAT_PWMENCODE_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//-----------------------
+//PWM Encoder Definitions
+//
+//QAT_PWMEncode_DShotBits - Number of bits in a DShot frame
+//QAT_PWMEncode_DShotMax  - Maximum DShot value (values 1 to 47 are commands, 48 to 2047 are throttle, and 0 is disarmed)
+const uint8_t  QAT_PWMEncode_DShotBits = 16;
+const uint16_t QAT_PWMEncode_DShotMax  = 2047;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//-------------
+//QAT_PWMEncode
+//
+//Used to encode data into buffers of compare values for QAD_PWM::startStream(), where each bit is sent as a single PWM period
+//with a short pulse for a 0 and a long pulse for a 1
+//
+//The PWM period is set by the QAD_PWM driver (800kHz for WS2812, or 150/300/600kHz for DShot150/300/600), and the pulse widths for
+//0 and 1 bits are found from the period using getPulse(). Typical pulse widths as fractions of the period are:
+// - WS2812:  0 = 1/3, 1 = 2/3
+// - DShot:   0 = 3/8, 1 = 3/4
+//
+//Encoded buffers end with a 0 value, so that the output is left low once the stream has finished.
+//The buffer type T should be uint16_t for 16bit timers, or uint32_t for 32bit timers (Timers 2 and 5)
+class QAT_PWMEncode {
+public:
+
+	//Used to calculate a pulse width as a fraction of the PWM period
+	//uPeriod - The period register value used by the QAD_PWM driver
+	//uNum    - Numerator of the fraction of the period
+	//uDen    - Denominator of the fraction of the period
+	//Returns the compare value giving the required pulse width
+	static constexpr uint32_t getPulse(uint32_t uPeriod, uint32_t uNum, uint32_t uDen) {
+		return (uint32_t)((((uint64_t)uPeriod + 1) * uNum + (uDen / 2)) / uDen);
+	}
+
+
+	//-------------
+	//WS2812 Method
+
+	//Used to encode data for WS2812 (and compatible) addressable LEDs
+	//Each byte is sent MSB first. WS2812 LEDs expect 3 bytes per LED in green, red, blue order
+	//pData  - Data to be encoded
+	//uBytes - Number of bytes to be encoded
+	//pOut   - Buffer to receive the compare values. Must have space for (uBytes * 8) + uReset values
+	//uZero  - Compare value for a 0 bit
+	//uOne   - Compare value for a 1 bit
+	//uReset - Number of periods to hold the output low after the data, which latches the data into the LEDs
+	//         (at least 40 periods at 800kHz, to give the 50us reset time)
+	//Returns the number of values written to pOut
+	template <typename T>
+	static uint16_t encodeWS2812(const uint8_t* pData, uint16_t uBytes, T* pOut, T uZero, T uOne, uint16_t uReset) {
+		uint16_t uIdx = 0;
+
+		for (uint16_t i=0; i<uBytes; i++) {
+			for (uint8_t uMask=0x80; uMask; uMask >>= 1)
+				pOut[uIdx++] = (pData[i] & uMask) ? uOne : uZero;
+		}
+
+		for (uint16_t i=0; i<uReset; i++)
+			pOut[uIdx++] = 0;
+
+		return uIdx;
+	}
+
+
+	//-------------
+	//DShot Methods
+
+	//Used to create a DShot frame
+	//uValue     - Throttle value or command (0 to 2047). Values larger than 2047 are limited to 2047
+	//bTelemetry - Set to true to request telemetry from the ESC
+	//Returns the 16bit frame, made up of the 11bit value, the telemetry request bit and a 4bit checksum
+	static uint16_t getDShotFrame(uint16_t uValue, bool bTelemetry) {
+		if (uValue > QAT_PWMEncode_DShotMax)
+			uValue = QAT_PWMEncode_DShotMax;
+
+		uint16_t uPacket = (uValue << 1) | (bTelemetry ? 1 : 0);
+		uint16_t uCRC    = (uPacket ^ (uPacket >> 4) ^ (uPacket >> 8)) & 0x0F;
+		return (uPacket << 4) | uCRC;
+	}
+
+	//Used to encode a DShot frame for an ESC
+	//uValue     - Throttle value or command (0 to 2047)
+	//bTelemetry - Set to true to request telemetry from the ESC
+	//pOut       - Buffer to receive the compare values. Must have space for QAT_PWMEncode_DShotBits + 1 values
+	//uZero      - Compare value for a 0 bit
+	//uOne       - Compare value for a 1 bit
+	//Returns the number of values written to pOut
+	template <typename T>
+	static uint16_t encodeDShot(uint16_t uValue, bool bTelemetry, T* pOut, T uZero, T uOne) {
+		uint16_t uFrame = getDShotFrame(uValue, bTelemetry);
+
+		for (uint8_t i=0; i<QAT_PWMEncode_DShotBits; i++)
+			pOut[i] = (uFrame & (0x8000 >> i)) ? uOne : uZero;
+
+		pOut[QAT_PWMEncode_DShotBits] = 0;
+		return QAT_PWMEncode_DShotBits + 1;
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_PWMENCODE_HPP_ */
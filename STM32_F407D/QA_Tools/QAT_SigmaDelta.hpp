@@ -0,0 +1,168 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Sigma-Delta Modulator                                           */
+/*   Filename: QAT_SigmaDelta.hpp                                          */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_SIGMADELTA_HPP_
+#define __QAT_SIGMADELTA_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//--------------------
+//QAT_SigmaDelta_Order
+//
+//Used to select the order of the sigma-delta modulator
+enum QAT_SigmaDelta_Order : uint8_t {
+	QAT_SigmaDelta_First = 1,   //First order. Output alternates between two adjacent values, with quantization noise shaped by (1 - z^-1)
+	QAT_SigmaDelta_Second       //Second order. Output uses up to four adjacent values, with quantization noise shaped by (1 - z^-1)^2, moving more
+	                            //of the noise to high frequencies where it is removed by the load or output filter. As the total noise is higher,
+	                            //this gives less ripple than first order only behind a filter of two or more poles
+};
+
+
+//-------------------
+//QAT_SigmaDelta_Full
+//
+//Value passed to QAT_SigmaDelta::setValue() for 100% duty
+const uint32_t QAT_SigmaDelta_Full = 65536;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//--------------
+//QAT_SigmaDelta
+//
+//Sigma-delta modulator used to dither PWM compare values across periods, so that the average duty cycle has 16bit resolution
+//regardless of the PWM period
+//
+//The target duty is split into an integer compare value and a 16bit fraction. The fraction is passed through the modulator, which
+//adds 0 or 1 (first order), or -1 to 2 (second order) to the integer compare value for each period, so that the average of the
+//output sequence equals the target. The quantization error of each period is fed back into the following periods, so that the
+//error is pushed to high frequencies rather than appearing as a low frequency ripple.
+//
+//All arithmetic is integer, and each output value takes a handful of cycles, so buffers can be refilled from DMA interrupts
+class QAT_SigmaDelta {
+private:
+
+	QAT_SigmaDelta_Order m_eOrder;   //Modulator order
+	uint32_t             m_uMax;     //Largest output value (the compare value giving 100% duty, which is the PWM period + 1)
+
+	volatile uint32_t    m_uInt;     //Integer part of the target compare value
+	volatile uint32_t    m_uFrac;    //Fractional part of the target compare value (16bit)
+
+	int32_t              m_iErr1;    //Quantization error of the previous output (16bit fixed point)
+	int32_t              m_iErr2;    //Quantization error of the output before that (16bit fixed point, second order only)
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAT_SigmaDelta() = delete;
+
+	//eOrder - Modulator order. Member of QAT_SigmaDelta_Order
+	//uMax   - The compare value giving 100% duty, which is the period register value of the PWM timer + 1
+	QAT_SigmaDelta(QAT_SigmaDelta_Order eOrder, uint32_t uMax) :
+		m_eOrder(eOrder),
+		m_uMax(uMax),
+		m_uInt(0),
+		m_uFrac(0),
+		m_iErr1(0),
+		m_iErr2(0) {}
+
+
+	//---------------
+	//Control Methods
+
+	//Used to set the target duty
+	//The integer and fractional parts are written separately, so if the modulator is being run from an interrupt, this
+	//should be called with that interrupt disabled (see QAD_PWMDither::setDuty())
+	//uDuty - Target duty, from 0 to QAT_SigmaDelta_Full (100%)
+	void setValue(uint32_t uDuty) {
+		if (uDuty > QAT_SigmaDelta_Full)
+			uDuty = QAT_SigmaDelta_Full;
+
+		uint64_t uTarget = (uint64_t)uDuty * m_uMax;
+		m_uInt  = (uint32_t)(uTarget >> 16);
+		m_uFrac = (uint32_t)(uTarget & 0xFFFF);
+	}
+
+	//Used to clear the modulator's error history
+	void reset(void) {
+		m_iErr1 = 0;
+		m_iErr2 = 0;
+	}
+
+
+	//------------
+	//Data Methods
+
+	//Used to calculate the next output value
+	//Returns the compare value to be used for the next PWM period
+	uint32_t next(void) {
+		int32_t iQ;
+
+		if (m_eOrder == QAT_SigmaDelta_First) {
+
+			//First order - the error is the accumulated fraction, and a carry out of the accumulator adds one to the output
+			int32_t iAcc = m_iErr1 + (int32_t)m_uFrac;
+			iQ      = iAcc >> 16;
+			m_iErr1 = iAcc & 0xFFFF;
+
+		} else {
+
+			//Second order - error feedback with a noise transfer function of (1 - z^-1)^2. The input is quantized by rounding to the nearest value
+			int32_t iV = (int32_t)m_uFrac + (2 * m_iErr1) - m_iErr2;
+			iQ      = (iV + 0x8000) >> 16;
+			m_iErr2 = m_iErr1;
+			m_iErr1 = iV - (iQ << 16);
+		}
+
+		//Limit the output to the range of the compare register. This only occurs for targets within a few counts of 0% or 100% duty
+		int32_t iOut = (int32_t)m_uInt + iQ;
+		if (iOut < 0)
+			return 0;
+		if ((uint32_t)iOut > m_uMax)
+			return m_uMax;
+		return (uint32_t)iOut;
+	}
+
+	//Used to fill a buffer with output values
+	//The largest output value (uMax as given to the constructor) must fit in T, as values are not limited to the range of T
+	//(QAD_PWMDither only allows periods below 0xFFFF for this reason)
+	//pBuf    - Buffer to be filled
+	//uLength - Number of values to be written
+	template <typename T>
+	void fill(T* pBuf, uint16_t uLength) {
+		for (uint16_t i=0; i<uLength; i++)
+			pBuf[i] = (T)next();
+	}
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_SIGMADELTA_HPP_ */
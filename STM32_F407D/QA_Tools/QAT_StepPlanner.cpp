@@ -0,0 +1,604 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Stepper Motor Motion Planner                                    */
+/*   Filename: QAT_StepPlanner.cpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Includes
+#include "QAT_StepPlanner.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+  //-------------------------------------------
+  //-------------------------------------------
+  //QAT_StepPlanner Constructors / Destructors
+
+//QAT_StepPlanner::QAT_StepPlanner
+//QAT_StepPlanner Constructor
+//
+//uTickFrequency - Frequency of the timer ticks that intervals are to be given in, in Hz (up to 168MHz)
+//uMinTicks      - Shortest interval to be generated, in ticks. The highest speed is limited to uTickFrequency / uMinTicks, and to 1MHz
+QAT_StepPlanner::QAT_StepPlanner(uint32_t uTickFrequency, uint32_t uMinTicks) :
+	m_uTickFrequency(uTickFrequency ? uTickFrequency : 1),
+	m_uMinTicks(uMinTicks ? uMinTicks : 1),
+	m_uMaxSpeed(0),
+	m_uAccel(1000),
+	m_eProfile(QAT_StepProfile_Trapezoid),
+	m_sQueue{},
+	m_uHead(0),
+	m_uCount(0),
+	m_bActive(false),
+	m_bDir(true),
+	m_eMoveProfile(QAT_StepProfile_Trapezoid),
+	m_uMoveAccel(1),
+	m_uSteps(0),
+	m_uStep(0),
+	m_uAccel2(1),
+	m_uEntry2(0),
+	m_uExit2(0),
+	m_uTop2(0),
+	m_uSpeed(0),
+	m_uLast2(0),
+	m_uLastSum(0),
+	m_uLastTicks(0),
+	m_uFraction(0),
+	m_uTopSpeed(0),
+	m_uAccelEnd(0),
+	m_uDecelStart(0),
+	m_bCruise(false),
+	m_uCruiseTicks(0),
+	m_sPhase{} {
+
+	//Speeds are held as 24.8 fixed point values, so are limited to 20bits
+	m_uMaxSpeed = m_uTickFrequency / m_uMinTicks;
+	if (m_uMaxSpeed > 1000000)
+		m_uMaxSpeed = 1000000;
+	if (!m_uMaxSpeed)
+		m_uMaxSpeed = 1;
+}
+
+
+  //--------------------------------
+  //--------------------------------
+  //QAT_StepPlanner Planning Methods
+
+//QAT_StepPlanner::setAccel
+//QAT_StepPlanner Planning Method
+//
+//Used to set the acceleration and acceleration profile for moves added after this call. Moves already queued are not changed
+//uAccel   - Peak acceleration in steps/s^2 (1 to QAT_StepPlanner_MaxAccel)
+//eProfile - Acceleration profile. Member of QAT_StepProfile
+void QAT_StepPlanner::setAccel(uint32_t uAccel, QAT_StepProfile eProfile) {
+	if (!uAccel)
+		uAccel = 1;
+	if (uAccel > QAT_StepPlanner_MaxAccel)
+		uAccel = QAT_StepPlanner_MaxAccel;
+
+	m_uAccel   = uAccel;
+	m_eProfile = eProfile;
+}
+
+
+//QAT_StepPlanner::add
+//QAT_StepPlanner Planning Method
+//
+//Used to add a move to the end of the queue, and replan the junction speeds of the queued moves
+//iSteps - Length of the move in steps, with negative values moving in the negative direction. A value of 0 adds no move
+//uSpeed - Requested speed in steps/s. This is limited to getMaxSpeed(), and for S-curve moves to the speed reached from rest
+//         over QAT_StepPlanner_MaxRamp steps
+//Returns QA_OK if the move is added
+//        QA_Fail if uSpeed is 0 or the queue is full
+QA_Result QAT_StepPlanner::add(int32_t iSteps, uint32_t uSpeed) {
+	if (!iSteps)
+		return QA_OK;
+
+	if ((!uSpeed) || (m_uCount >= QAT_StepPlanner_QueueSize))
+		return QA_Fail;
+
+	if (uSpeed > m_uMaxSpeed)
+		uSpeed = m_uMaxSpeed;
+
+	QAT_StepPlanner_Block& sBlock = m_sQueue[(m_uHead + m_uCount) % QAT_StepPlanner_QueueSize];
+	sBlock.uSteps    = (iSteps < 0) ? (0 - (uint32_t)iSteps) : (uint32_t)iSteps;
+	sBlock.bDir      = (iSteps > 0);
+	sBlock.eProfile  = m_eProfile;
+	sBlock.uAccel    = m_uAccel;
+	sBlock.uAccel2   = (m_eProfile == QAT_StepProfile_SCurve) ? (((uint64_t)m_uAccel * 4) / 3) : ((uint64_t)m_uAccel * 2);
+	sBlock.uNominal2 = (uint64_t)uSpeed * uSpeed;
+	sBlock.uEntry2   = 0;
+
+	if ((m_eProfile == QAT_StepProfile_SCurve) && (sBlock.uNominal2 > (sBlock.uAccel2 * QAT_StepPlanner_MaxRamp)))
+		sBlock.uNominal2 = sBlock.uAccel2 * QAT_StepPlanner_MaxRamp;
+
+	//The first move in the queue starts from rest, as the move being run (if any) is already heading for rest. Later moves can run
+	//into this move at up to the lower of the two requested speeds if they are in the same direction, or must stop if they reverse
+	if (!m_uCount) {
+		sBlock.uMaxEntry2 = 0;
+	} else {
+		QAT_StepPlanner_Block& sPrev = m_sQueue[(m_uHead + m_uCount - 1) % QAT_StepPlanner_QueueSize];
+		if (sPrev.bDir != sBlock.bDir)
+			sBlock.uMaxEntry2 = 0;
+		else
+			sBlock.uMaxEntry2 = (sPrev.uNominal2 < sBlock.uNominal2) ? sPrev.uNominal2 : sBlock.uNominal2;
+	}
+
+	m_uCount++;
+	plan();
+	return QA_OK;
+}
+
+
+//QAT_StepPlanner::clear
+//QAT_StepPlanner Planning Method
+//
+//Used to remove all queued moves and abandon the move being run, such as when the motor has been stopped without decelerating
+void QAT_StepPlanner::clear(void) {
+	m_uHead   = 0;
+	m_uCount    = 0;
+	m_bActive   = false;
+	m_uSpeed    = 0;
+	m_uFraction = 0;
+}
+
+
+  //---------------------------------------
+  //---------------------------------------
+  //QAT_StepPlanner Step Generation Methods
+
+//QAT_StepPlanner::ready
+//QAT_StepPlanner Step Generation Method
+//
+//Used to check whether a step is available, starting the next queued move if the previous move has finished
+//Returns true if a move is being run, in which case getDir() gives its direction and next() gives the interval before its next step
+bool QAT_StepPlanner::ready(void) {
+	if ((!m_bActive) && (m_uCount))
+		startMove();
+
+	return m_bActive;
+}
+
+
+//QAT_StepPlanner::next
+//QAT_StepPlanner Step Generation Method
+//
+//Used to generate the next step of the current move, starting the next queued move if needed
+//Returns the interval in ticks from the previous step (or from the start of the move, for its first step) to the new step, which is at
+//least the uMinTicks value passed to the constructor. Returns 0 if no move is being run and no moves are queued
+//Intervals are calculated to 1/65536 of a tick, with the fraction carried into the next interval, so that step times do not drift
+uint32_t QAT_StepPlanner::next(void) {
+	if (!ready())
+		return 0;
+
+	uint32_t uStep  = ++m_uStep;
+	uint64_t uTicks = ((m_eMoveProfile == QAT_StepProfile_SCurve) ? nextSCurve(uStep) : nextTrapezoid(uStep)) + m_uFraction;
+
+	if (uStep >= m_uSteps)
+		m_bActive = false;
+
+	//Carry the fraction of a tick into the next interval
+	m_uFraction = (uint32_t)(uTicks & 0xFFFF);
+	uTicks    >>= 16;
+
+	if (uTicks > 0xFFFFFFFF)
+		return 0xFFFFFFFF;
+	return (uTicks < m_uMinTicks) ? m_uMinTicks : (uint32_t)uTicks;
+}
+
+
+  //------------------------------------
+  //------------------------------------
+  //QAT_StepPlanner Private Tool Methods
+
+//QAT_StepPlanner::plan
+//QAT_StepPlanner Private Tool Method
+//
+//Used to calculate the entry speed of each queued move after the first, whose entry speed is fixed
+//The reverse pass limits each entry speed to the junction limit and to the speed from which the move can still slow to the entry speed of
+//the following move (with the final move ending at rest). The forward pass then limits each entry speed to the speed that the previous move
+//can reach from its own entry speed. As speeds are only ever raised by adding moves, the fixed entry speed of the first move always remains
+//reachable
+void QAT_StepPlanner::plan(void) {
+	if (m_uCount < 2)
+		return;
+
+	//Reverse pass
+	uint64_t uNext2 = 0;
+	for (uint8_t i=(m_uCount - 1); i>0; i--) {
+		QAT_StepPlanner_Block& sBlock = m_sQueue[(m_uHead + i) % QAT_StepPlanner_QueueSize];
+		uint64_t uReach2 = uNext2 + (sBlock.uAccel2 * sBlock.uSteps);
+
+		sBlock.uEntry2 = (uReach2 < sBlock.uMaxEntry2) ? uReach2 : sBlock.uMaxEntry2;
+		uNext2         = sBlock.uEntry2;
+	}
+
+	//Forward pass
+	for (uint8_t i=0; i<(m_uCount - 1); i++) {
+		QAT_StepPlanner_Block& sBlock = m_sQueue[(m_uHead + i) % QAT_StepPlanner_QueueSize];
+		QAT_StepPlanner_Block& sNext  = m_sQueue[(m_uHead + i + 1) % QAT_StepPlanner_QueueSize];
+		uint64_t uReach2 = sBlock.uEntry2 + (sBlock.uAccel2 * sBlock.uSteps);
+
+		if (sNext.uEntry2 > uReach2)
+			sNext.uEntry2 = uReach2;
+	}
+}
+
+
+//QAT_StepPlanner::startMove
+//QAT_StepPlanner Private Tool Method
+//
+//Used to take the first move from the queue and calculate its profile
+//The exit speed is the entry speed of the following move, or rest if there is none. If a move is added to an empty queue while this move
+//is being run, its entry speed is also rest, so the two always agree. The top speed is the requested speed, unless the move is too short to
+//reach it, in which case it is the speed at which the acceleration and deceleration meet
+void QAT_StepPlanner::startMove(void) {
+	QAT_StepPlanner_Block& sBlock = m_sQueue[m_uHead];
+	m_uHead = (m_uHead + 1) % QAT_StepPlanner_QueueSize;
+	m_uCount--;
+
+	m_bActive      = true;
+	m_bDir         = sBlock.bDir;
+	m_eMoveProfile = sBlock.eProfile;
+	m_uMoveAccel   = sBlock.uAccel;
+	m_uSteps       = sBlock.uSteps;
+	m_uStep        = 0;
+	m_uAccel2      = sBlock.uAccel2 ? sBlock.uAccel2 : 1;
+	m_uEntry2      = sBlock.uEntry2;
+	m_uExit2       = (m_uCount) ? m_sQueue[m_uHead].uEntry2 : 0;
+
+	m_uTop2 = sBlock.uNominal2;
+	uint64_t uMeet2 = ((m_uAccel2 * m_uSteps) + m_uEntry2 + m_uExit2) / 2;
+	if (m_uTop2 > uMeet2)
+		m_uTop2 = uMeet2;
+
+	m_uSpeed     = sqrt64(m_uEntry2 << 16);
+	m_uLast2     = m_uEntry2;
+	m_uLastSum   = 0;
+	m_uLastTicks = 0;
+
+	//Find top speed, making sure rounding cannot leave it below the entry or exit speed
+	uint32_t uExit = sqrt64(m_uExit2 << 16);
+	m_uTopSpeed    = sqrt64(m_uTop2 << 16);
+	if (m_uTopSpeed < m_uSpeed)
+		m_uTopSpeed = m_uSpeed;
+	if (m_uTopSpeed < uExit)
+		m_uTopSpeed = uExit;
+	if (!m_uTopSpeed)
+		m_uTopSpeed = 1;
+
+	//Find positions of the end of the acceleration and start of the deceleration. For S-curve moves these are measured from the speed
+	//changes themselves, and the acceleration is left as the current phase
+	uint64_t uEnd = (uint64_t)m_uSteps << 16;
+	uint64_t uDecel;
+	if (m_eMoveProfile == QAT_StepProfile_SCurve) {
+		m_uCruiseTicks = ((uint64_t)m_uTickFrequency << 24) / m_uTopSpeed;
+
+		startPhase(m_uTopSpeed, uExit, true);
+		uDecel = phaseDistance();
+		startPhase(m_uSpeed, m_uTopSpeed, false);
+		m_uAccelEnd = phaseDistance();
+		m_bCruise   = (m_uAccelEnd == 0);
+	} else {
+		m_uAccelEnd = ((m_uTop2 - m_uEntry2) << 16) / m_uAccel2;
+		uDecel      = ((m_uTop2 - m_uExit2) << 16) / m_uAccel2;
+	}
+
+	//Rounding can leave the speed changes slightly longer than the move, in which case the deceleration is shortened
+	if (m_uAccelEnd > uEnd)
+		m_uAccelEnd = uEnd;
+	m_uDecelStart = (uDecel < (uEnd - m_uAccelEnd)) ? (uEnd - uDecel) : m_uAccelEnd;
+}
+
+
+//QAT_StepPlanner::nextTrapezoid
+//QAT_StepPlanner Private Tool Method
+//
+//Used to find the interval before a step of a trapezoid move
+//The squared speed at the step is the lowest of the accelerating, cruising and decelerating speeds, and the interval is the step divided
+//by the average of the speeds at the previous step and this step. The square root and divide are skipped while cruising. A step that
+//contains the end of the acceleration or start of the deceleration is timed in parts either side of it, so that speeds reached part way
+//through a step (including single step moves) are still timed exactly
+//uStep - Step number within the move (1 for the first step)
+//Returns the interval as a number of ticks with a 16bit fraction
+uint64_t QAT_StepPlanner::nextTrapezoid(uint32_t uStep) {
+	uint64_t uSpeed2 = m_uEntry2 + (m_uAccel2 * uStep);
+	if (uSpeed2 > m_uTop2)
+		uSpeed2 = m_uTop2;
+	uint64_t uDecel2 = m_uExit2 + (m_uAccel2 * (m_uSteps - uStep));
+	if (uSpeed2 > uDecel2)
+		uSpeed2 = uDecel2;
+
+	uint32_t uPrev  = m_uSpeed;
+	uint32_t uSpeed = (uSpeed2 == m_uLast2) ? m_uSpeed : sqrt64(uSpeed2 << 16);
+	m_uSpeed        = uSpeed;
+	m_uLast2        = uSpeed2;
+
+	uint64_t uFrom = (uint64_t)(uStep - 1) << 16;
+	uint64_t uTo   = (uint64_t)uStep << 16;
+	bool bAccelEnd   = (m_uAccelEnd > uFrom) && (m_uAccelEnd < uTo);
+	bool bDecelStart = (m_uDecelStart > uFrom) && (m_uDecelStart < uTo) && (m_uDecelStart != m_uAccelEnd);
+
+	if (bAccelEnd || bDecelStart) {
+		uint64_t uTicks = 0;
+		if (bAccelEnd) {
+			uTicks += stepTicks(m_uAccelEnd - uFrom, uPrev + m_uTopSpeed);
+			uFrom   = m_uAccelEnd;
+			uPrev   = m_uTopSpeed;
+		}
+		if (bDecelStart) {
+			uTicks += stepTicks(m_uDecelStart - uFrom, uPrev + m_uTopSpeed);
+			uFrom   = m_uDecelStart;
+			uPrev   = m_uTopSpeed;
+		}
+
+		m_uLastSum   = 0;
+		m_uLastTicks = uTicks + stepTicks(uTo - uFrom, uPrev + uSpeed);
+		return m_uLastTicks;
+	}
+
+	uint32_t uSum = uPrev + uSpeed;
+	if ((uSum != m_uLastSum) || (!m_uLastTicks)) {
+		m_uLastSum   = uSum;
+		m_uLastTicks = stepTicks(65536, uSum);
+	}
+
+	return m_uLastTicks;
+}
+
+
+//QAT_StepPlanner::nextSCurve
+//QAT_StepPlanner Private Tool Method
+//
+//Used to find the interval before a step of an S-curve move
+//Steps in the acceleration and deceleration are timed from the start of their speed change by phaseSolve(), and steps between the two run
+//at the top speed. A step that passes the end of the acceleration or the start of the deceleration (which are at fractional positions)
+//is timed as the sum of the parts either side of it, and the deceleration only becomes the current phase once it is reached
+//uStep - Step number within the move (1 for the first step)
+//Returns the interval as a number of ticks with a 16bit fraction
+uint64_t QAT_StepPlanner::nextSCurve(uint32_t uStep) {
+	uint64_t uPosition = (uint64_t)uStep << 16;
+	uint64_t uFrom     = uPosition - 65536;
+	uint64_t uTicks    = 0;
+	uint64_t uTime;
+
+	if ((!m_bCruise) && (!m_sPhase.bDecel)) {
+
+		//Acceleration. The first step of a move from rest is guessed from the end of the speed change, as the position is flat at its start
+		if (uPosition <= m_uAccelEnd) {
+			uint64_t uGuess;
+			if (m_uLastTicks)
+				uGuess = m_sPhase.uNow + (m_uLastTicks >> 16);
+			else
+				uGuess = (m_sPhase.uStart) ? (((uint64_t)m_uTickFrequency << 8) / m_sPhase.uStart) : m_sPhase.uTime;
+
+			uTime = phaseSolve(uPosition, uGuess);
+			m_uLastTicks  = (uTime - m_sPhase.uNow) << 16;
+			m_sPhase.uNow = uTime;
+			return m_uLastTicks;
+		}
+
+		//Step passes the end of the acceleration
+		uTicks    = (m_sPhase.uTime - m_sPhase.uNow) << 16;
+		uFrom     = m_uAccelEnd;
+		m_bCruise = true;
+	}
+
+	if (m_bCruise) {
+
+		//Cruise
+		m_uSpeed = m_uTopSpeed;
+		if (uPosition <= m_uDecelStart) {
+			m_uLastTicks = (uTicks) ? (uTicks + cruiseTicks(uPosition - uFrom)) : m_uCruiseTicks;
+			return m_uLastTicks;
+		}
+
+		//Step passes the start of the deceleration
+		uTicks   += cruiseTicks(m_uDecelStart - uFrom);
+		m_bCruise = false;
+		startPhase(m_uTopSpeed, sqrt64(m_uExit2 << 16), true);
+	}
+
+	//Deceleration. The final step is placed at the end of the speed change, so that the move always ends at the exit speed
+	if (uStep >= m_uSteps) {
+		uTime    = m_sPhase.uTime;
+		m_uSpeed = m_sPhase.uStart - m_sPhase.uDelta;
+	} else {
+		uint64_t uGuess = m_sPhase.uNow + ((m_sPhase.uNow) ? (m_uLastTicks >> 16) : (cruiseTicks(uPosition - m_uDecelStart) >> 16));
+		uTime = phaseSolve(uPosition - m_uDecelStart, uGuess);
+	}
+
+	m_uLastTicks  = uTicks + ((uTime - m_sPhase.uNow) << 16);
+	m_sPhase.uNow = uTime;
+	return m_uLastTicks;
+}
+
+
+//QAT_StepPlanner::cruiseTicks
+//QAT_StepPlanner Private Tool Method
+//
+//Returns the time taken to cover a distance at the top speed of the current move
+//uDistance - Distance in steps with a 16bit fraction, of no more than one step
+//Returns the time as a number of ticks with a 16bit fraction
+uint64_t QAT_StepPlanner::cruiseTicks(uint64_t uDistance) const {
+	return ((uDistance * m_uTickFrequency) << 8) / m_uTopSpeed;
+}
+
+
+//QAT_StepPlanner::stepTicks
+//QAT_StepPlanner Private Tool Method
+//
+//Returns the time taken to cover a distance at constant acceleration, as a number of ticks with a 16bit fraction
+//uDistance - Distance (steps with a 16bit fraction, up to one step)
+//uSum      - Sum of the speeds at the start and end of the distance (24.8 fixed point steps/s)
+uint64_t QAT_StepPlanner::stepTicks(uint64_t uDistance, uint32_t uSum) const {
+	return ((uDistance * m_uTickFrequency) << 9) / (uSum ? uSum : 1);
+}
+
+
+//QAT_StepPlanner::startPhase
+//QAT_StepPlanner Private Tool Method
+//
+//Used to set up an S-curve speed change
+//The speed change takes 1.5 * change / a seconds, as the smoothstep curve has a peak gradient of 1.5 times its average. The distance
+//covered is the distance at the start speed plus half of the change in speed multiplied by the time (as the curve is symmetrical)
+//uStart - Start speed (24.8 fixed point steps/s)
+//uEnd   - End speed (24.8 fixed point steps/s)
+//bDecel - Set if the end speed is lower than the start speed
+void QAT_StepPlanner::startPhase(uint32_t uStart, uint32_t uEnd, bool bDecel) {
+	uint32_t uDelta = (bDecel) ? ((uStart > uEnd) ? (uStart - uEnd) : 0) : ((uEnd > uStart) ? (uEnd - uStart) : 0);
+	uint64_t uScale = (uint64_t)512 * m_uMoveAccel;
+
+	m_sPhase.uTime   = ((uint64_t)3 * uDelta * m_uTickFrequency) / uScale;
+	if (!m_sPhase.uTime)
+		m_sPhase.uTime = 1;
+	m_sPhase.uRecip  = ((uint64_t)1 << 62) / m_sPhase.uTime;
+	m_sPhase.uLinear = ((uint64_t)3 * uStart * uDelta) / (2 * m_uMoveAccel);
+	m_sPhase.uCurve  = ((uint64_t)3 * uDelta * uDelta) / (2 * m_uMoveAccel);
+	m_sPhase.uStart  = uStart;
+	m_sPhase.uDelta  = uDelta;
+	m_sPhase.bDecel  = bDecel;
+	m_sPhase.uNow    = 0;
+}
+
+
+//QAT_StepPlanner::phaseDistance
+//QAT_StepPlanner Private Tool Method
+//
+//Returns the distance covered by the current speed change (steps with a 16bit fraction)
+uint64_t QAT_StepPlanner::phaseDistance(void) const {
+	return (m_sPhase.bDecel) ? (m_sPhase.uLinear - (m_sPhase.uCurve / 2)) : (m_sPhase.uLinear + (m_sPhase.uCurve / 2));
+}
+
+
+//QAT_StepPlanner::phasePosition
+//QAT_StepPlanner Private Tool Method
+//
+//Used to find the position and speed at a time into the current speed change
+//With u as the fraction of the speed change time, the speed is v0 +/- dv * (3u^2 - 2u^3), so the position is v0 * T * u +/- dv * T * (u^3 - u^4/2).
+//u is held as a 1.31 fixed point value, and the powers of u are applied one multiply at a time to the distance rather than found first, so
+//that the position keeps its precision near the flat start of a speed change from rest
+//uTime  - Time from the start of the speed change, in ticks
+//uSpeed - Set to the speed at this time (24.8 fixed point steps/s)
+//Returns the position at this time (steps with a 16bit fraction)
+uint64_t QAT_StepPlanner::phasePosition(uint64_t uTime, uint32_t& uSpeed) const {
+	uint64_t uU = (uTime >= m_sPhase.uTime) ? ((uint64_t)1 << 31) : ((uTime * m_sPhase.uRecip) >> 31);
+	if (uU > ((uint64_t)1 << 31))
+		uU = (uint64_t)1 << 31;
+
+	uint64_t uCurve3 = mul31(mul31(mul31(m_sPhase.uCurve, uU), uU), uU);
+	uint64_t uCurve  = uCurve3 - (mul31(uCurve3, uU) / 2);
+	uint64_t uLinear = mul31(m_sPhase.uLinear, uU);
+
+	uint64_t uDelta2 = mul31(mul31(m_sPhase.uDelta, uU), uU);
+	uint32_t uChange = (uint32_t)((3 * uDelta2) - (2 * mul31(uDelta2, uU)));
+
+	if (m_sPhase.bDecel) {
+		uSpeed = m_sPhase.uStart - uChange;
+		return (uLinear > uCurve) ? (uLinear - uCurve) : 0;
+	}
+
+	uSpeed = m_sPhase.uStart + uChange;
+	return uLinear + uCurve;
+}
+
+
+//QAT_StepPlanner::phaseSolve
+//QAT_StepPlanner Private Tool Method
+//
+//Used to find the time at which the current speed change reaches a position, using Newton's method
+//The position is convex while accelerating and concave while decelerating, so once an iteration lands on the far side of the answer (for
+//acceleration) or the near side (for deceleration), each following iteration moves steadily towards it. The time is kept between the
+//previous step and the end of the speed change, and iteration stops once it moves by no more than one tick
+//uPosition - Position to be reached (steps with a 16bit fraction)
+//uGuess    - Starting estimate of the time in ticks
+//Returns the time in ticks from the start of the speed change
+uint64_t QAT_StepPlanner::phaseSolve(uint64_t uPosition, uint64_t uGuess) {
+	int64_t iLow  = (int64_t)m_sPhase.uNow + 1;
+	int64_t iHigh = (int64_t)m_sPhase.uTime;
+	if (iLow > iHigh)
+		iLow = iHigh;
+
+	int64_t iTime = (int64_t)uGuess;
+	if (iTime > iHigh)
+		iTime = iHigh;
+	if (iTime < iLow)
+		iTime = iLow;
+
+	uint32_t uSpeed = 0;
+	for (uint8_t i=0; i<32; i++) {
+		int64_t iError = (int64_t)uPosition - (int64_t)phasePosition((uint64_t)iTime, uSpeed);
+		int64_t iSpeed = (int64_t)(uSpeed ? uSpeed : 1) << 8;
+
+		//Errors of more than 2^18 steps are divided first, so the multiply cannot overflow
+		int64_t iNext;
+		if ((iError > ((int64_t)1 << 34)) || (iError < -((int64_t)1 << 34)))
+			iNext = iTime + ((iError / iSpeed) * m_uTickFrequency);
+		else
+			iNext = iTime + ((iError * m_uTickFrequency) / iSpeed);
+
+		if (iNext > iHigh)
+			iNext = iHigh;
+		if (iNext < iLow)
+			iNext = iLow;
+
+		int64_t iChange = iNext - iTime;
+		iTime           = iNext;
+		if ((iChange <= 1) && (iChange >= -1))
+			break;
+	}
+
+	phasePosition((uint64_t)iTime, uSpeed);
+	m_uSpeed = uSpeed;
+	return (uint64_t)iTime;
+}
+
+
+//QAT_StepPlanner::sqrt64
+//QAT_StepPlanner Private Tool Method
+//
+//Returns the integer square root of a 64bit value, found one bit at a time
+//uVal - Value to find the square root of
+uint32_t QAT_StepPlanner::sqrt64(uint64_t uVal) {
+	uint64_t uRoot = 0;
+	uint64_t uBit  = (uint64_t)1 << 62;
+
+	while (uBit > uVal)
+		uBit >>= 2;
+
+	while (uBit) {
+		if (uVal >= (uRoot + uBit)) {
+			uVal  -= uRoot + uBit;
+			uRoot  = (uRoot >> 1) + uBit;
+		} else {
+			uRoot >>= 1;
+		}
+		uBit >>= 2;
+	}
+
+	return (uint32_t)uRoot;
+}
+
+
+//QAT_StepPlanner::mul31
+//QAT_StepPlanner Private Tool Method
+//
+//Returns a value multiplied by a 1.31 fixed point fraction, split into two multiplies so that values of up to 2^48 cannot overflow
+//uVal      - Value to be multiplied
+//uFraction - Fraction (up to 1 << 31)
+uint64_t QAT_StepPlanner::mul31(uint64_t uVal, uint64_t uFraction) {
+	return ((uVal >> 31) * uFraction) + (((uVal & 0x7FFFFFFF) * uFraction) >> 31);
+}
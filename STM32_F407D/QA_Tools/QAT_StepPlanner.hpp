@@ -0,0 +1,249 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Stepper Motor Motion Planner                                    */
+/*   Filename: QAT_StepPlanner.hpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_STEPPLANNER_HPP_
+#define __QAT_STEPPLANNER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------------------
+//Step Planner Definitions
+//
+//QAT_StepPlanner_QueueSize - Number of moves that can be queued
+//QAT_StepPlanner_MaxAccel  - Highest acceleration in steps/s^2. Higher values are limited to this
+//QAT_StepPlanner_MaxRamp   - Longest S-curve acceleration or deceleration in steps. The speed of S-curve moves is limited so that
+//                            reaching it from rest takes no more than this many steps
+const uint8_t  QAT_StepPlanner_QueueSize = 16;
+const uint32_t QAT_StepPlanner_MaxAccel  = 0x00FFFFFF;
+const uint32_t QAT_StepPlanner_MaxRamp   = 0x00FFFFFF;
+
+
+//---------------
+//QAT_StepProfile
+//
+//Used to select the acceleration profile of moves
+enum QAT_StepProfile : uint8_t {
+	QAT_StepProfile_Trapezoid = 0,  //Constant acceleration. Speed changes linearly with time
+	QAT_StepProfile_SCurve          //Smoothed acceleration. Speed follows a smoothstep curve with time (3t^2 - 2t^3), so acceleration rises from
+	                                //and falls back to zero at the start and end of each speed change, with a peak of the set acceleration
+};
+
+
+//---------------------
+//QAT_StepPlanner_Block
+//
+//Holds a queued move within QAT_StepPlanner
+//Speeds are held as squared speeds in (steps/s)^2, as the squared speed changes by the same amount each step at constant acceleration
+typedef struct {
+
+	uint32_t        uSteps;      //Length of the move in steps
+	bool            bDir;        //Direction of the move (true for positive)
+	QAT_StepProfile eProfile;    //Acceleration profile
+	uint32_t        uAccel;      //Peak acceleration in steps/s^2
+
+	uint64_t        uAccel2;     //Change in squared speed per step when accelerating (2a for trapezoid moves, 4a/3 for S-curve moves, which have
+	                             //an average acceleration of 2/3 of the peak)
+	uint64_t        uNominal2;   //Squared requested speed
+	uint64_t        uMaxEntry2;  //Highest squared speed allowed at the junction with the previous move
+	uint64_t        uEntry2;     //Planned squared speed at the start of the move
+
+} QAT_StepPlanner_Block;
+
+
+//---------------------
+//QAT_StepPlanner_Phase
+//
+//Holds an S-curve speed change within QAT_StepPlanner
+//Positions are in steps with a 16bit fraction, speeds are in steps/s as 24.8 fixed point, and times are in timer ticks
+typedef struct {
+
+	uint64_t uTime;      //Duration of the speed change
+	uint64_t uRecip;     //2^62 / uTime, used to find the fraction of the speed change at a time without a divide
+	uint64_t uLinear;    //Distance that would be covered at the start speed over the whole speed change
+	uint64_t uCurve;     //Distance added (or removed, when slowing) by the speed change if it happened at the start
+	uint32_t uStart;     //Speed at the start of the speed change
+	uint32_t uDelta;     //Size of the speed change
+	bool     bDecel;     //Set if the speed change is a deceleration
+
+	uint64_t uNow;       //Time of the most recent step from the start of the speed change
+
+} QAT_StepPlanner_Phase;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------------
+//QAT_StepPlanner
+//
+//Motion planner and step timing generator for a stepper motor, producing the interval in timer ticks between each step and the next
+//
+//Moves are queued with add(), each with a length and a requested speed. Each move accelerates from its entry speed towards the requested
+//speed and decelerates to its exit speed, with the speed at each junction between moves chosen to be as high as possible while still
+//allowing every move (including the final one, which always ends at rest) to reach its exit speed. Moves in the same direction run into
+//each other at up to the lower of their two requested speeds, while moves that reverse direction meet at rest. The planner is rerun each
+//time a move is added, working back from the end of the queue and then forwards from the move currently being run (as is done in many
+//CNC and 3D printer firmwares). The entry speed of the first move in the queue is fixed, as the move ahead of it is already heading for it.
+//
+//Trapezoid moves find the speed at each step directly from the squared speed, which changes by 2a per step, taking the interval as the
+//step length divided by the average of the speeds at either end of the step (which is exact for constant acceleration). The speed at
+//each step is the lowest of the accelerating, cruising and decelerating speeds at that position, so short moves give a triangular profile
+//without needing a separate case. A step containing the end of the acceleration or the start of the deceleration is timed in two parts.
+//
+//S-curve moves follow a smoothstep speed curve with time for each speed change. The position is a polynomial of time, so the time of each
+//step is found by Newton's method from the time of the previous step, which normally needs one or two iterations. As step times are solved
+//from the position rather than summed from speeds, timing errors do not build up during long speed changes. The speed changes are placed
+//at their exact (fractional) positions within the move, so moves too short to contain a whole step of acceleration are still timed
+//correctly.
+//
+//All arithmetic is fixed point using 64bit integers with no floating point. Intervals are found to 1/65536 of a tick, with the fraction
+//carried from each interval into the next, so rounding does not build up over long moves. Cruising steps reuse the previous interval, so
+//their cost is very low, while trapezoid steps need a square root and S-curve steps need one divide per Newton iteration.
+//
+//The class has no hardware dependencies (see QAS_Stepper for the system class that drives a stepper motor driver), and is not thread
+//safe: add() and clear() must not be called while the step generation methods are being run from an interrupt
+class QAT_StepPlanner {
+private:
+
+	uint32_t              m_uTickFrequency;                     //Frequency of the timer ticks used for intervals, in Hz
+	uint32_t              m_uMinTicks;                          //Shortest interval to be generated
+	uint32_t              m_uMaxSpeed;                          //Highest speed in steps/s (m_uTickFrequency / m_uMinTicks)
+
+	uint32_t              m_uAccel;                             //Peak acceleration for new moves in steps/s^2
+	QAT_StepProfile       m_eProfile;                           //Acceleration profile for new moves
+
+	QAT_StepPlanner_Block m_sQueue[QAT_StepPlanner_QueueSize];  //Queued moves
+	uint8_t               m_uHead;                              //Index of the oldest queued move
+	uint8_t               m_uCount;                             //Number of queued moves
+
+	//Current move
+	bool                  m_bActive;      //Set while a move is being run
+	bool                  m_bDir;         //Direction of the current move
+	QAT_StepProfile       m_eMoveProfile; //Acceleration profile of the current move
+	uint32_t              m_uMoveAccel;   //Peak acceleration of the current move
+	uint32_t              m_uSteps;       //Length of the current move in steps
+	uint32_t              m_uStep;        //Number of steps generated so far in the current move
+
+	uint64_t              m_uAccel2;      //Change in squared speed per step of the current move
+	uint64_t              m_uEntry2;      //Squared entry speed of the current move
+	uint64_t              m_uExit2;       //Squared exit speed of the current move
+	uint64_t              m_uTop2;        //Squared top speed of the current move
+
+	uint32_t              m_uSpeed;       //Speed at the most recent step (24.8 fixed point steps/s)
+	uint64_t              m_uLast2;       //Squared speed at the most recent step (trapezoid moves)
+	uint32_t              m_uLastSum;     //Sum of the speeds either side of the most recent interval (trapezoid moves)
+	uint64_t              m_uLastTicks;   //Most recent interval (ticks with a 16bit fraction)
+	uint32_t              m_uFraction;    //Fraction of a tick carried into the next interval (16bit fraction), so rounding does not build up
+	uint32_t              m_uTopSpeed;    //Top speed of the current move (24.8 fixed point steps/s)
+
+	uint64_t              m_uAccelEnd;    //Position of the end of the acceleration of the current move (steps with a 16bit fraction)
+	uint64_t              m_uDecelStart;  //Position of the start of the deceleration of the current move (steps with a 16bit fraction)
+
+	bool                  m_bCruise;      //Set while the current move is between its acceleration and deceleration (S-curve moves)
+	uint64_t              m_uCruiseTicks; //Interval at the top speed (S-curve moves, ticks with a 16bit fraction)
+	QAT_StepPlanner_Phase m_sPhase;       //Current speed change (S-curve moves)
+
+public:
+
+	//--------------------------
+	//Constructors / Destructors
+
+	QAT_StepPlanner() = delete;                               //Delete the default class constructor, as the timing needs to be supplied
+
+	QAT_StepPlanner(uint32_t uTickFrequency, uint32_t uMinTicks);
+
+
+	//NOTE: See QAT_StepPlanner.cpp for details of the following methods
+
+	//----------------
+	//Planning Methods
+
+	void setAccel(uint32_t uAccel, QAT_StepProfile eProfile);
+	QA_Result add(int32_t iSteps, uint32_t uSpeed);
+	void clear(void);
+
+	//Returns the number of moves that can currently be added to the queue
+	uint8_t getFree(void) const {
+		return QAT_StepPlanner_QueueSize - m_uCount;
+	}
+
+	//Returns true if no move is being run and no moves are queued
+	bool isIdle(void) const {
+		return (!m_bActive) && (!m_uCount);
+	}
+
+	//Returns the highest speed that can be requested in steps/s. Higher speeds passed to add() are limited to this
+	uint32_t getMaxSpeed(void) const {
+		return m_uMaxSpeed;
+	}
+
+
+	//-----------------------
+	//Step Generation Methods
+
+	bool ready(void);
+
+	//Returns the direction of the current move (true for positive). Only valid once ready() has returned true
+	bool getDir(void) const {
+		return m_bDir;
+	}
+
+	uint32_t next(void);
+
+	//Returns the speed at the most recent step in steps/s, or 0 when no move is being run
+	uint32_t getSpeed(void) const {
+		return (m_bActive) ? (m_uSpeed >> 8) : 0;
+	}
+
+
+private:
+
+	//NOTE: See QAT_StepPlanner.cpp for details of the following methods
+
+	//-------------
+	//Tool Methods
+
+	void plan(void);
+	void startMove(void);
+	uint64_t nextTrapezoid(uint32_t uStep);
+	uint64_t nextSCurve(uint32_t uStep);
+	uint64_t stepTicks(uint64_t uDistance, uint32_t uSum) const;
+	uint64_t cruiseTicks(uint64_t uDistance) const;
+
+	void startPhase(uint32_t uStart, uint32_t uEnd, bool bDecel);
+	uint64_t phaseDistance(void) const;
+	uint64_t phasePosition(uint64_t uTime, uint32_t& uSpeed) const;
+	uint64_t phaseSolve(uint64_t uPosition, uint64_t uGuess);
+
+	static uint32_t sqrt64(uint64_t uVal);
+	static uint64_t mul31(uint64_t uVal, uint64_t uFraction);
+
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_STEPPLANNER_HPP_ */
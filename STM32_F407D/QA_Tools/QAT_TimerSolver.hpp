@@ -0,0 +1,266 @@
+/* ----------------------------------------------------------------------- */
+/*                                                                         */
+/*   Quartz Arc                                                            */
+/*                                                                         */
+/*   STM32 F407G Discovery                                                 */
+/*                                                                         */
+/*   System: Tools                                                         */
+/*   Role: Timer Prescaler/Period Solver                                   */
+/*   Filename: QAT_TimerSolver.hpp                                         */
+/*   Date: 18th October 2026                                               */
+/*   Created By: Benjamin Rosser                                           */
+/*                                                                         */
+/*   This code is covered by Creative Commons CC-BY-NC-SA license          */
+/*   (C) Copyright 2026 Benjamin Rosser                                    */
+/*                                                                         */
+/* ----------------------------------------------------------------------- */
+
+//Prevent Recursive Inclusion
+#ifndef __QAT_TIMERSOLVER_HPP_
+#define __QAT_TIMERSOLVER_HPP_
+
+//Includes
+#include "setup.hpp"
+
+#include "QAD_TimerMgr.hpp"
+
+
+	//------------------------------------------
+	//------------------------------------------
+  //------------------------------------------
+
+
+//------------------------
+//Timer Solver Definitions
+//
+//QAT_TimerSolver_APB1Clock   - Input clock of Timers 2 to 7 and 12 to 14 in Hz, as configured by SystemInitialize() in boot.cpp
+//QAT_TimerSolver_APB2Clock   - Input clock of Timers 1, 8, 9, 10 and 11 in Hz, as configured by SystemInitialize() in boot.cpp
+//                              These are only used by the compile-time solvers. If the clock tree in boot.cpp is changed these must be updated to match
+//QAT_TimerSolver_SearchLimit - Maximum number of prescaler values tried by a single solve. This bounds the time taken by the runtime solver,
+//                              and the number of steps taken by the compiler for the compile-time solvers
+const uint32_t QAT_TimerSolver_APB1Clock   = 84000000;
+const uint32_t QAT_TimerSolver_APB2Clock   = 168000000;
+const uint32_t QAT_TimerSolver_SearchLimit = 4096;
+
+
+//-----------------
+//QAT_TimerSolution
+//
+//Result of a prescaler/period solve
+//uPrescaler and uPeriod are register values, and can be copied directly into QAD_Timer_InitStruct or QAD_PWM_InitStruct
+typedef struct {
+
+	uint32_t uPrescaler;  //Prescaler register value (the timer clock is divided by uPrescaler+1)
+	uint32_t uPeriod;     //Period register value (the counter counts from 0 to uPeriod, giving uPeriod+1 steps of resolution)
+	uint32_t uErrorPPM;   //Error between the requested and achieved frequency, in parts per million
+	bool     bValid;      //true if uErrorPPM is within the requested tolerance
+
+} QAT_TimerSolution;
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//---------------
+//QAT_TimerSolver
+//
+//Used to calculate prescaler and period values for a timer from a target frequency or period
+//
+//The total division of the timer clock is split between the prescaler and the period. The smallest prescaler is always preferred,
+//as this gives the largest period and therefore the finest resolution (for PWM duty cycles, encoder-style counting, or compare timing).
+//Starting from the smallest prescaler able to reach the target, prescaler values are tried in turn, and the first one giving an error
+//within the tolerance is used. If no prescaler gives an error within tolerance, the solution with the least error is returned
+//with bValid set to false.
+//
+//All methods are constexpr so they can be used by the compile-time solvers QAT_TimerFrequency and QAT_TimerPeriod below,
+//as well as at runtime using the live clock speeds from QAD_TimerMgr
+class QAT_TimerSolver {
+public:
+
+	//--------------------
+	//Compile-time Methods
+
+	//Returns the input clock speed in Hz of a Timer peripheral, based on the QAT_TimerSolver_APBxClock definitions
+	//eTimer - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	static constexpr uint32_t clockSpeed(QAD_Timer_Periph eTimer) {
+		return ((eTimer == QAD_Timer1) || (eTimer == QAD_Timer8) || (eTimer == QAD_Timer9) ||
+		        (eTimer == QAD_Timer10) || (eTimer == QAD_Timer11)) ? QAT_TimerSolver_APB2Clock : QAT_TimerSolver_APB1Clock;
+	}
+
+	//Returns the counter width in bits of a Timer peripheral
+	//eTimer - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	static constexpr uint8_t counterBits(QAD_Timer_Periph eTimer) {
+		return ((eTimer == QAD_Timer2) || (eTimer == QAD_Timer5)) ? 32 : 16;
+	}
+
+
+	//-------------
+	//Solve Methods
+
+	//Used to solve for a target frequency
+	//uClock        - Timer input clock speed in Hz
+	//uFrequency    - Target update/PWM frequency in Hz
+	//uBits         - Counter width in bits (16 or 32)
+	//uTolerancePPM - Maximum acceptable frequency error in parts per million (0 requires an exact solution)
+	static constexpr QAT_TimerSolution solveFrequency(uint32_t uClock, uint32_t uFrequency, uint8_t uBits, uint32_t uTolerancePPM) {
+		return solveRatio(uClock, uFrequency, uBits, uTolerancePPM);
+	}
+
+	//Used to solve for a target period
+	//uClock        - Timer input clock speed in Hz
+	//uPeriodUS     - Target update/PWM period in microseconds
+	//uBits         - Counter width in bits (16 or 32)
+	//uTolerancePPM - Maximum acceptable period error in parts per million (0 requires an exact solution)
+	static constexpr QAT_TimerSolution solvePeriod(uint32_t uClock, uint32_t uPeriodUS, uint8_t uBits, uint32_t uTolerancePPM) {
+		return solveRatio((uint64_t)uClock * uPeriodUS, 1000000, uBits, uTolerancePPM);
+	}
+
+	//Used to solve for a target frequency using the live clock speed and counter width of a Timer peripheral from QAD_TimerMgr
+	//eTimer        - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	//uFrequency    - Target update/PWM frequency in Hz
+	//uTolerancePPM - Maximum acceptable frequency error in parts per million
+	static QAT_TimerSolution solveFrequency(QAD_Timer_Periph eTimer, uint32_t uFrequency, uint32_t uTolerancePPM) {
+		return solveRatio(QAD_TimerMgr::getClockSpeed(eTimer), uFrequency, liveBits(eTimer), uTolerancePPM);
+	}
+
+	//Used to solve for a target period using the live clock speed and counter width of a Timer peripheral from QAD_TimerMgr
+	//eTimer        - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+	//uPeriodUS     - Target update/PWM period in microseconds
+	//uTolerancePPM - Maximum acceptable period error in parts per million
+	static QAT_TimerSolution solvePeriod(QAD_Timer_Periph eTimer, uint32_t uPeriodUS, uint32_t uTolerancePPM) {
+		return solveRatio((uint64_t)QAD_TimerMgr::getClockSpeed(eTimer) * uPeriodUS, 1000000, liveBits(eTimer), uTolerancePPM);
+	}
+
+
+	//------------
+	//Tool Methods
+
+	//Used to find the prescaler/period pair whose product is closest to uNum/uDen, preferring the smallest prescaler within tolerance
+	//uNum          - Numerator of the total clock division required
+	//uDen          - Denominator of the total clock division required
+	//uBits         - Counter width in bits (16 or 32)
+	//uTolerancePPM - Maximum acceptable error in parts per million
+	static constexpr QAT_TimerSolution solveRatio(uint64_t uNum, uint64_t uDen, uint8_t uBits, uint32_t uTolerancePPM) {
+		QAT_TimerSolution sBest = {0, 0, 0xFFFFFFFF, false};
+
+		//A total division of less than 2 cannot be generated
+		if ((!uDen) || (uNum < (uDen * 2)))
+			return sBest;
+
+		uint64_t uMaxCount = (uBits >= 32) ? 0x100000000ULL : (1ULL << uBits);
+
+		//Largest acceptable difference between the achieved and required division, scaled by uDen
+		uint64_t uAllowed  = ((uNum / 1000000) * uTolerancePPM) + (((uNum % 1000000) * uTolerancePPM) / 1000000);
+
+		//Smallest prescaler able to reach the required division
+		uint64_t uPrescaler = (uNum + (uDen * uMaxCount) - 1) / (uDen * uMaxCount);
+		if (!uPrescaler)
+			uPrescaler = 1;
+
+		for (uint32_t i=0; (i < QAT_TimerSolver_SearchLimit) && (uPrescaler <= 65536); i++, uPrescaler++) {
+
+			//Nearest count for this prescaler
+			uint64_t uCount = ((uNum * 2) + (uDen * uPrescaler)) / (uDen * uPrescaler * 2);
+			if (uCount < 2)
+				break;
+			if (uCount > uMaxCount)
+				uCount = uMaxCount;
+
+			//Error in parts per million
+			uint64_t uAchieved = uPrescaler * uCount * uDen;
+			uint64_t uDiff     = (uAchieved > uNum) ? (uAchieved - uNum) : (uNum - uAchieved);
+			uint64_t uError    = (uDiff > 0xFFFFFFFFFFFULL) ? 0xFFFFFFFF : (((uDiff * 1000000) + (uNum / 2)) / uNum);
+			if (uError > 0xFFFFFFFF)
+				uError = 0xFFFFFFFF;
+
+			if ((uError < sBest.uErrorPPM) || (uDiff <= uAllowed)) {
+				sBest.uPrescaler = (uint32_t)(uPrescaler - 1);
+				sBest.uPeriod    = (uint32_t)(uCount - 1);
+				sBest.uErrorPPM  = (uint32_t)uError;
+			}
+
+			//First prescaler within tolerance gives the finest resolution
+			if (uDiff <= uAllowed) {
+				sBest.bValid = true;
+				return sBest;
+			}
+		}
+		return sBest;
+	}
+
+private:
+
+	//Returns the live counter width in bits of a Timer peripheral from QAD_TimerMgr
+	static uint8_t liveBits(QAD_Timer_Periph eTimer) {
+		return (QAD_TimerMgr::getType(eTimer) == QAD_Timer_32bit) ? 32 : 16;
+	}
+
+};
+
+
+	//------------------------------------------
+	//------------------------------------------
+	//------------------------------------------
+
+
+//------------------
+//QAT_TimerFrequency
+//
+//Compile-time solver for a target frequency on a specific Timer peripheral
+//Compilation fails if the frequency cannot be generated within the tolerance
+//
+//Example:
+//  typedef QAT_TimerFrequency<QAD_Timer4, 20000> PWMTiming;   //20kHz exactly
+//  sPWMInit.uPrescaler = PWMTiming::uPrescaler;
+//  sPWMInit.uPeriod    = PWMTiming::uPeriod;
+//
+//eTimer        - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+//uFrequency    - Target update/PWM frequency in Hz
+//uTolerancePPM - Maximum acceptable frequency error in parts per million (defaults to 0, requiring an exact solution)
+template <QAD_Timer_Periph eTimer, uint32_t uFrequency, uint32_t uTolerancePPM = 0>
+class QAT_TimerFrequency {
+private:
+
+	static constexpr QAT_TimerSolution sSolution =
+		QAT_TimerSolver::solveFrequency(QAT_TimerSolver::clockSpeed(eTimer), uFrequency, QAT_TimerSolver::counterBits(eTimer), uTolerancePPM);
+
+	static_assert(sSolution.bValid, "QAT_TimerFrequency: Frequency cannot be generated by this timer within the requested tolerance");
+
+public:
+
+	static constexpr uint32_t uPrescaler = sSolution.uPrescaler;   //Prescaler register value
+	static constexpr uint32_t uPeriod    = sSolution.uPeriod;      //Period register value
+	static constexpr uint32_t uErrorPPM  = sSolution.uErrorPPM;    //Frequency error in parts per million
+};
+
+
+//---------------
+//QAT_TimerPeriod
+//
+//Compile-time solver for a target period on a specific Timer peripheral
+//Compilation fails if the period cannot be generated within the tolerance
+//
+//eTimer        - Timer peripheral. Member of QAD_Timer_Periph as defined in QAD_TimerMgr.hpp
+//uPeriodUS     - Target update/PWM period in microseconds
+//uTolerancePPM - Maximum acceptable period error in parts per million (defaults to 0, requiring an exact solution)
+template <QAD_Timer_Periph eTimer, uint32_t uPeriodUS, uint32_t uTolerancePPM = 0>
+class QAT_TimerPeriod {
+private:
+
+	static constexpr QAT_TimerSolution sSolution =
+		QAT_TimerSolver::solvePeriod(QAT_TimerSolver::clockSpeed(eTimer), uPeriodUS, QAT_TimerSolver::counterBits(eTimer), uTolerancePPM);
+
+	static_assert(sSolution.bValid, "QAT_TimerPeriod: Period cannot be generated by this timer within the requested tolerance");
+
+public:
+
+	static constexpr uint32_t uPrescaler = sSolution.uPrescaler;   //Prescaler register value
+	static constexpr uint32_t uPeriod    = sSolution.uPeriod;      //Period register value
+	static constexpr uint32_t uErrorPPM  = sSolution.uErrorPPM;    //Period error in parts per million
+};
+
+
+//Prevent Recursive Inclusion
+#endif /* __QAT_TIMERSOLVER_HPP_ */